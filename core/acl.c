@@ -0,0 +1,313 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Enforcement of the Access Control Object (ID 2).
+ * The instances of the Access Control Object are compiled for each server into a hash table giving
+ * the rights of the server on an (object, instance) pair. The tables are built on the first check
+ * and dropped whenever the Access Control Object changes.
+ * An instance created by a server gets an instance of the Access Control Object owned by this server.
+ */
+
+#include "internals.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+#ifdef LWM2M_CLIENT_MODE
+
+#define PRV_RES_OBJECT_ID           0
+#define PRV_RES_OBJECT_INSTANCE_ID  1
+#define PRV_RES_ACL                 2
+#define PRV_RES_OWNER               3
+
+#define PRV_CACHE_MIN_CAPACITY      8
+
+// set in the used slots of the table
+#define PRV_ENTRY_USED      0x80
+
+#define PRV_KEY(O, I)       (((uint32_t)(O) << 16) | (uint32_t)(I))
+
+static uint32_t prv_hash(uint32_t key)
+{
+    key = ((key >> 16) ^ key) * 0x45D9F3B;
+    key = ((key >> 16) ^ key) * 0x45D9F3B;
+    return (key >> 16) ^ key;
+}
+
+static acl_entry_t * prv_slot(lwm2m_acl_cache_t * cacheP,
+                              uint32_t key)
+{
+    size_t position;
+
+    // the table is never more than half full: an empty slot is always reached
+    position = prv_hash(key) & cacheP->mask;
+    while ((cacheP->entries[position].rights & PRV_ENTRY_USED) != 0
+        && cacheP->entries[position].key != key)
+    {
+        position = (position + 1) & cacheP->mask;
+    }
+
+    return cacheP->entries + position;
+}
+
+static void prv_grant(lwm2m_acl_cache_t * cacheP,
+                      uint32_t key,
+                      uint8_t rights)
+{
+    acl_entry_t * entryP;
+
+    entryP = prv_slot(cacheP, key);
+    entryP->key = key;
+    entryP->rights |= rights | PRV_ENTRY_USED;
+}
+
+// Rights of the server with the short ID on the instance of the Access Control Object:
+// its own ACL entry, else all rights for the owner, else the default ACL entry.
+static void prv_compileInstance(lwm2m_acl_cache_t * cacheP,
+                                uint16_t shortID,
+                                uint16_t aclInstanceId,
+                                int size,
+                                lwm2m_data_t * dataP)
+{
+    int64_t objectId = -1;
+    int64_t instanceId = -1;
+    int64_t owner = -1;
+    int64_t value;
+    lwm2m_data_t * aclP = NULL;
+    uint8_t rights;
+    bool found;
+    int i;
+
+    for (i = 0 ; i < size ; i++)
+    {
+        switch (dataP[i].id)
+        {
+        case PRV_RES_OBJECT_ID:
+            if (1 != lwm2m_data_decode_int(dataP + i, &objectId)) objectId = -1;
+            break;
+        case PRV_RES_OBJECT_INSTANCE_ID:
+            if (1 != lwm2m_data_decode_int(dataP + i, &instanceId)) instanceId = -1;
+            break;
+        case PRV_RES_ACL:
+            if (dataP[i].type == LWM2M_TYPE_MULTIPLE_RESOURCE) aclP = dataP + i;
+            break;
+        case PRV_RES_OWNER:
+            if (1 != lwm2m_data_decode_int(dataP + i, &owner)) owner = -1;
+            break;
+        default:
+            break;
+        }
+    }
+    if (objectId < 0 || objectId > LWM2M_MAX_ID
+     || instanceId < 0 || instanceId > LWM2M_MAX_ID)
+    {
+        return;
+    }
+
+    // only the owner can modify the instance of the Access Control Object
+    prv_grant(cacheP, PRV_KEY(LWM2M_ACL_OBJECT_ID, aclInstanceId), owner == shortID ? ACL_RIGHT_ALL : ACL_RIGHT_READ);
+
+    rights = 0;
+    found = false;
+    if (aclP != NULL)
+    {
+        for (i = 0 ; i < (int)aclP->value.asChildren.count ; i++)
+        {
+            if (aclP->value.asChildren.array[i].id == shortID
+             && 1 == lwm2m_data_decode_int(aclP->value.asChildren.array + i, &value))
+            {
+                rights = (uint8_t)(value & ACL_RIGHT_ALL);
+                found = true;
+            }
+        }
+    }
+    if (!found)
+    {
+        if (owner == shortID)
+        {
+            rights = ACL_RIGHT_ALL;
+        }
+        else if (aclP != NULL)
+        {
+            for (i = 0 ; i < (int)aclP->value.asChildren.count ; i++)
+            {
+                if (aclP->value.asChildren.array[i].id == 0
+                 && 1 == lwm2m_data_decode_int(aclP->value.asChildren.array + i, &value))
+                {
+                    rights = (uint8_t)(value & ACL_RIGHT_ALL);
+                }
+            }
+        }
+    }
+
+    prv_grant(cacheP, PRV_KEY(objectId, instanceId), rights);
+}
+
+static lwm2m_acl_cache_t * prv_compile(lwm2m_object_t * aclObjectP,
+                                       uint16_t shortID)
+{
+    lwm2m_acl_cache_t * cacheP;
+    lwm2m_list_t * instanceP;
+    size_t capacity;
+    size_t count;
+
+    count = 0;
+    for (instanceP = aclObjectP->instanceList ; instanceP != NULL ; instanceP = instanceP->next)
+    {
+        count++;
+    }
+    // each instance fills two slots, for its target and for itself
+    capacity = PRV_CACHE_MIN_CAPACITY;
+    while (capacity < count * 4)
+    {
+        capacity *= 2;
+    }
+
+    cacheP = (lwm2m_acl_cache_t *)lwm2m_malloc(sizeof(lwm2m_acl_cache_t));
+    if (cacheP == NULL) return NULL;
+    cacheP->entries = (acl_entry_t *)lwm2m_malloc(capacity * sizeof(acl_entry_t));
+    if (cacheP->entries == NULL)
+    {
+        lwm2m_free(cacheP);
+        return NULL;
+    }
+    memset(cacheP->entries, 0, capacity * sizeof(acl_entry_t));
+    cacheP->mask = capacity - 1;
+
+    for (instanceP = aclObjectP->instanceList ; instanceP != NULL ; instanceP = instanceP->next)
+    {
+        lwm2m_data_t * dataP = NULL;
+        int size = 0;
+
+        if (COAP_205_CONTENT == aclObjectP->readFunc(instanceP->id, &size, &dataP, aclObjectP))
+        {
+            prv_compileInstance(cacheP, shortID, instanceP->id, size, dataP);
+        }
+        lwm2m_data_free(size, dataP);
+    }
+
+    return cacheP;
+}
+
+uint8_t acl_checkAccess(lwm2m_context_t * contextP,
+                        lwm2m_server_t * serverP,
+                        lwm2m_uri_t * uriP,
+                        uint8_t rights)
+{
+    lwm2m_object_t * aclObjectP;
+    lwm2m_object_t * targetP;
+    lwm2m_list_t * instanceP;
+    acl_entry_t * entryP;
+
+    // access control applies only with several servers
+    if (contextP->serverList == NULL || contextP->serverList->next == NULL) return COAP_NO_ERROR;
+    aclObjectP = object_find(contextP, LWM2M_ACL_OBJECT_ID);
+    if (aclObjectP == NULL || aclObjectP->readFunc == NULL) return COAP_NO_ERROR;
+
+    if (serverP->acl == NULL)
+    {
+        serverP->acl = prv_compile(aclObjectP, serverP->shortID);
+        if (serverP->acl == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    // the right to create is granted by the instance with the maximum ID
+    if (LWM2M_URI_IS_SET_INSTANCE(uriP) || rights == ACL_RIGHT_CREATE)
+    {
+        entryP = prv_slot(serverP->acl, PRV_KEY(uriP->objectId, LWM2M_URI_IS_SET_INSTANCE(uriP) ? uriP->instanceId : LWM2M_MAX_ID));
+        if ((entryP->rights & rights) != rights) return COAP_401_UNAUTHORIZED;
+
+        return COAP_NO_ERROR;
+    }
+
+    // an operation on an object needs the rights on all its instances
+    targetP = object_find(contextP, uriP->objectId);
+    if (targetP == NULL) return COAP_NO_ERROR;
+    for (instanceP = targetP->instanceList ; instanceP != NULL ; instanceP = instanceP->next)
+    {
+        entryP = prv_slot(serverP->acl, PRV_KEY(uriP->objectId, instanceP->id));
+        if ((entryP->rights & rights) != rights) return COAP_401_UNAUTHORIZED;
+    }
+
+    return COAP_NO_ERROR;
+}
+
+// Creates the instance of the Access Control Object of the object instance just created by the server,
+// the server being its owner.
+uint8_t acl_createInstance(lwm2m_context_t * contextP,
+                           lwm2m_server_t * serverP,
+                           lwm2m_uri_t * uriP)
+{
+    lwm2m_object_t * aclObjectP;
+    lwm2m_data_t * instanceP;
+    lwm2m_data_t * resourceP;
+    lwm2m_uri_t aclUri;
+    uint8_t result;
+
+    if (contextP->serverList == NULL || contextP->serverList->next == NULL) return COAP_NO_ERROR;
+    // the instances of the Access Control Object are controlled by their owner
+    if (uriP->objectId == LWM2M_ACL_OBJECT_ID) return COAP_NO_ERROR;
+    aclObjectP = object_find(contextP, LWM2M_ACL_OBJECT_ID);
+    if (aclObjectP == NULL || aclObjectP->readFunc == NULL || aclObjectP->createFunc == NULL) return COAP_NO_ERROR;
+
+    instanceP = lwm2m_data_new(1);
+    if (instanceP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+    resourceP = lwm2m_data_new(3);
+    if (resourceP == NULL)
+    {
+        lwm2m_data_free(1, instanceP);
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+    resourceP[0].id = PRV_RES_OBJECT_ID;
+    lwm2m_data_encode_int(uriP->objectId, resourceP);
+    resourceP[1].id = PRV_RES_OBJECT_INSTANCE_ID;
+    lwm2m_data_encode_int(uriP->instanceId, resourceP + 1);
+    resourceP[2].id = PRV_RES_OWNER;
+    lwm2m_data_encode_int(serverP->shortID, resourceP + 2);
+    lwm2m_data_include(resourceP, 3, instanceP);
+
+    memset(&aclUri, 0, sizeof(lwm2m_uri_t));
+    aclUri.objectId = LWM2M_ACL_OBJECT_ID;
+    aclUri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    result = object_createInstance(contextP, &aclUri, instanceP);
+    lwm2m_data_free(1, instanceP);
+
+    return result == COAP_201_CREATED ? COAP_NO_ERROR : result;
+}
+
+void acl_invalidate(lwm2m_context_t * contextP)
+{
+    lwm2m_server_t * serverP;
+
+    for (serverP = contextP->serverList ; serverP != NULL ; serverP = serverP->next)
+    {
+        acl_free(serverP);
+    }
+}
+
+void acl_free(lwm2m_server_t * serverP)
+{
+    if (serverP->acl != NULL)
+    {
+        lwm2m_free(serverP->acl->entries);
+        lwm2m_free(serverP->acl);
+        serverP->acl = NULL;
+    }
+}
+
+#endif
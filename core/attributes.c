@@ -0,0 +1,289 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Store of the attributes set by the servers with Write-Attributes, independent of the observations.
+ * Each server has an array of entries sorted by URI, an object being followed by its instances,
+ * each instance being followed by its resources.
+ */
+
+#include "internals.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+#ifdef LWM2M_CLIENT_MODE
+
+#define PRV_STORE_MIN_CAPACITY  4
+
+#define PRV_OBJECT_SHIFT    34
+#define PRV_INSTANCE_SHIFT  17
+
+// An unset instance or resource ID is stored as 0 to sort before the set ones
+static uint64_t prv_key(lwm2m_uri_t * uriP)
+{
+    uint64_t key;
+
+    key = (uint64_t)uriP->objectId << PRV_OBJECT_SHIFT;
+    if (LWM2M_URI_IS_SET_INSTANCE(uriP))
+    {
+        key |= ((uint64_t)uriP->instanceId + 1) << PRV_INSTANCE_SHIFT;
+        if (LWM2M_URI_IS_SET_RESOURCE(uriP))
+        {
+            key |= (uint64_t)uriP->resourceId + 1;
+        }
+    }
+
+    return key;
+}
+
+// Position of the entry with the key, or of the first entry with a greater key
+static size_t prv_search(lwm2m_attribute_store_t * storeP,
+                         uint64_t key)
+{
+    size_t low;
+    size_t high;
+
+    low = 0;
+    high = storeP->count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+
+        if (storeP->entries[middle].key < key)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+static lwm2m_attributes_t * prv_find(lwm2m_attribute_store_t * storeP,
+                                     uint64_t key)
+{
+    size_t position;
+
+    if (storeP == NULL) return NULL;
+
+    position = prv_search(storeP, key);
+    if (position < storeP->count && storeP->entries[position].key == key) return &storeP->entries[position].attributes;
+
+    return NULL;
+}
+
+static lwm2m_attributes_t * prv_insert(lwm2m_server_t * serverP,
+                                       uint64_t key)
+{
+    lwm2m_attribute_store_t * storeP;
+    size_t position;
+
+    if (serverP->attributes == NULL)
+    {
+        serverP->attributes = (lwm2m_attribute_store_t *)lwm2m_malloc(sizeof(lwm2m_attribute_store_t));
+        if (serverP->attributes == NULL) return NULL;
+        memset(serverP->attributes, 0, sizeof(lwm2m_attribute_store_t));
+    }
+    storeP = serverP->attributes;
+
+    if (storeP->count == storeP->capacity)
+    {
+        attribute_entry_t * entries;
+        size_t capacity;
+
+        capacity = storeP->capacity == 0 ? PRV_STORE_MIN_CAPACITY : storeP->capacity * 2;
+        entries = (attribute_entry_t *)lwm2m_malloc(capacity * sizeof(attribute_entry_t));
+        if (entries == NULL) return NULL;
+        if (storeP->count != 0) memcpy(entries, storeP->entries, storeP->count * sizeof(attribute_entry_t));
+        lwm2m_free(storeP->entries);
+        storeP->entries = entries;
+        storeP->capacity = capacity;
+    }
+
+    position = prv_search(storeP, key);
+    memmove(storeP->entries + position + 1, storeP->entries + position, (storeP->count - position) * sizeof(attribute_entry_t));
+    storeP->count++;
+    memset(storeP->entries + position, 0, sizeof(attribute_entry_t));
+    storeP->entries[position].key = key;
+
+    return &storeP->entries[position].attributes;
+}
+
+// Remove the entries with a key in [first, last[
+static void prv_removeRange(lwm2m_attribute_store_t * storeP,
+                            uint64_t first,
+                            uint64_t last)
+{
+    size_t start;
+    size_t end;
+
+    if (storeP == NULL) return;
+
+    start = prv_search(storeP, first);
+    end = prv_search(storeP, last);
+    if (start == end) return;
+
+    memmove(storeP->entries + start, storeP->entries + end, (storeP->count - end) * sizeof(attribute_entry_t));
+    storeP->count -= end - start;
+}
+
+// Merge the attributes of 'srcP' selected by 'mask' into 'dstP'
+static void prv_merge(lwm2m_attributes_t * dstP,
+                      lwm2m_attributes_t * srcP,
+                      uint8_t mask)
+{
+    uint8_t flags;
+
+    flags = srcP->toSet & mask;
+    if (flags & LWM2M_ATTR_FLAG_MIN_PERIOD) dstP->minPeriod = srcP->minPeriod;
+    if (flags & LWM2M_ATTR_FLAG_MAX_PERIOD) dstP->maxPeriod = srcP->maxPeriod;
+    if (flags & LWM2M_ATTR_FLAG_GREATER_THAN) dstP->greaterThan = srcP->greaterThan;
+    if (flags & LWM2M_ATTR_FLAG_LESS_THAN) dstP->lessThan = srcP->lessThan;
+    if (flags & LWM2M_ATTR_FLAG_STEP) dstP->step = srcP->step;
+    dstP->toSet |= flags;
+}
+
+lwm2m_attributes_t * attributes_find(lwm2m_server_t * serverP,
+                                     lwm2m_uri_t * uriP)
+{
+    if (serverP == NULL) return NULL;
+
+    return prv_find(serverP->attributes, prv_key(uriP));
+}
+
+bool attributes_resolve(lwm2m_server_t * serverP,
+                        lwm2m_uri_t * uriP,
+                        lwm2m_attributes_t * attrP)
+{
+    lwm2m_attribute_store_t * storeP;
+    lwm2m_attributes_t * paramP;
+    lwm2m_uri_t uri;
+
+    memset(attrP, 0, sizeof(lwm2m_attributes_t));
+    if (serverP == NULL) return false;
+    storeP = serverP->attributes;
+    if (storeP == NULL || storeP->count == 0) return false;
+
+    // the periods are inherited from the object and the object instance
+    memset(&uri, 0, sizeof(lwm2m_uri_t));
+    uri.objectId = uriP->objectId;
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    if (LWM2M_URI_IS_SET_INSTANCE(uriP))
+    {
+        paramP = prv_find(storeP, prv_key(&uri));
+        if (paramP != NULL) prv_merge(attrP, paramP, LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD);
+
+        if (LWM2M_URI_IS_SET_RESOURCE(uriP))
+        {
+            uri.instanceId = uriP->instanceId;
+            uri.flag |= LWM2M_URI_FLAG_INSTANCE_ID;
+            paramP = prv_find(storeP, prv_key(&uri));
+            if (paramP != NULL) prv_merge(attrP, paramP, LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD);
+        }
+    }
+
+    paramP = prv_find(storeP, prv_key(uriP));
+    if (paramP != NULL) prv_merge(attrP, paramP, 0xFF);
+
+    return attrP->toSet != 0;
+}
+
+uint8_t attributes_set(lwm2m_server_t * serverP,
+                       lwm2m_uri_t * uriP,
+                       lwm2m_attributes_t * attrP)
+{
+    lwm2m_attributes_t * paramP;
+    uint64_t key;
+
+    key = prv_key(uriP);
+    paramP = prv_find(serverP->attributes, key);
+
+    // Check rule “lt” value + 2*”stp” values < “gt” value
+    if ((((attrP->toSet | (paramP ? paramP->toSet : 0)) & ~attrP->toClear) & ATTR_FLAG_NUMERIC) == ATTR_FLAG_NUMERIC)
+    {
+        double gt;
+        double lt;
+        double stp;
+
+        gt = (attrP->toSet & LWM2M_ATTR_FLAG_GREATER_THAN) ? attrP->greaterThan : paramP->greaterThan;
+        lt = (attrP->toSet & LWM2M_ATTR_FLAG_LESS_THAN) ? attrP->lessThan : paramP->lessThan;
+        stp = (attrP->toSet & LWM2M_ATTR_FLAG_STEP) ? attrP->step : paramP->step;
+
+        if (lt + (2 * stp) >= gt) return COAP_400_BAD_REQUEST;
+    }
+
+    if (paramP == NULL)
+    {
+        if (attrP->toSet == 0) return COAP_204_CHANGED;
+
+        paramP = prv_insert(serverP, key);
+        if (paramP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    paramP->toSet &= ~attrP->toClear;
+    prv_merge(paramP, attrP, 0xFF);
+
+    LOG_ARG("Final toSet: %08X, minPeriod: %d, maxPeriod: %d, greaterThan: %f, lessThan: %f, step: %f",
+            paramP->toSet, paramP->minPeriod, paramP->maxPeriod, paramP->greaterThan, paramP->lessThan, paramP->step);
+
+    if (paramP->toSet == 0)
+    {
+        prv_removeRange(serverP->attributes, key, key + 1);
+    }
+
+    return COAP_204_CHANGED;
+}
+
+void attributes_remove(lwm2m_context_t * contextP,
+                       lwm2m_uri_t * uriP)
+{
+    lwm2m_server_t * serverP;
+    uint64_t first;
+    uint64_t last;
+
+    first = prv_key(uriP);
+    if (LWM2M_URI_IS_SET_INSTANCE(uriP))
+    {
+        last = first + ((uint64_t)1 << PRV_INSTANCE_SHIFT);
+    }
+    else
+    {
+        last = first + ((uint64_t)1 << PRV_OBJECT_SHIFT);
+    }
+
+    for (serverP = contextP->serverList ; serverP != NULL ; serverP = serverP->next)
+    {
+        prv_removeRange(serverP->attributes, first, last);
+    }
+}
+
+void attributes_free(lwm2m_server_t * serverP)
+{
+    if (serverP->attributes != NULL)
+    {
+        lwm2m_free(serverP->attributes->entries);
+        lwm2m_free(serverP->attributes);
+        serverP->attributes = NULL;
+    }
+}
+
+#endif
@@ -574,6 +574,201 @@ uint8_t bootstrap_handleDeleteAll(lwm2m_context_t * contextP,
 #endif
 
 #ifdef LWM2M_BOOTSTRAP_SERVER_MODE
+static lwm2m_uri_t * prv_getUri(bs_data_t * dataP)
+{
+    return dataP->isUri ? &dataP->uri : NULL;
+}
+
+static void prv_resultCallback(lwm2m_transaction_t * transacP,
+                               void * message);
+
+// Returns true if transacP can be sent along with the commands in flight to the same client.
+// completedP is a command being completed, to ignore.
+static bool prv_canSend(lwm2m_context_t * contextP,
+                        lwm2m_transaction_t * transacP,
+                        lwm2m_transaction_t * completedP)
+{
+    coap_packet_t * messageP = (coap_packet_t *)transacP->message;
+    lwm2m_transaction_t * targetP;
+    int inFlight;
+
+    inFlight = 0;
+    for (targetP = contextP->transactionList ; targetP != NULL ; targetP = targetP->next)
+    {
+        if (targetP == completedP
+         || targetP->callback != prv_resultCallback
+         || lwm2m_session_is_equal(targetP->peerH, transacP->peerH, contextP->userData) == false)
+        {
+            continue;
+        }
+
+        // deletes and writes are not reordered and Bootstrap-Finish waits for all the others
+        if (((coap_packet_t *)targetP->message)->code != messageP->code
+         || messageP->code == COAP_POST)
+        {
+            return false;
+        }
+        inFlight++;
+    }
+
+    return inFlight < LWM2M_BOOTSTRAP_WINDOW;
+}
+
+// Sends the waiting commands of a client which fit in its window, in order.
+static void prv_drain(lwm2m_context_t * contextP,
+                      void * sessionH,
+                      lwm2m_transaction_t * completedP)
+{
+    lwm2m_transaction_t ** queueP;
+
+    queueP = &contextP->bootstrapQueue;
+    while (*queueP != NULL)
+    {
+        lwm2m_transaction_t * transacP = *queueP;
+
+        if (lwm2m_session_is_equal(transacP->peerH, sessionH, contextP->userData) == false)
+        {
+            queueP = &transacP->next;
+            continue;
+        }
+        if (!prv_canSend(contextP, transacP, completedP)) return;
+
+        LOG_ARG("Sending waiting command %d", transacP->mID);
+        *queueP = transacP->next;
+        transacP->next = NULL;
+        contextP->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(contextP->transactionList, transacP);
+        (void)transaction_send(contextP, transacP);
+    }
+}
+
+static void prv_cancel(lwm2m_context_t * contextP,
+                       void * sessionH)
+{
+    lwm2m_transaction_t ** queueP;
+
+    queueP = &contextP->bootstrapQueue;
+    while (*queueP != NULL)
+    {
+        lwm2m_transaction_t * transacP = *queueP;
+
+        if (lwm2m_session_is_equal(transacP->peerH, sessionH, contextP->userData) == true)
+        {
+            bs_data_t * dataP = (bs_data_t *)transacP->userData;
+
+            LOG_ARG("Cancelling command %d", transacP->mID);
+            *queueP = transacP->next;
+            dataP->callback(transacP->peerH,
+                            COAP_503_SERVICE_UNAVAILABLE,
+                            prv_getUri(dataP),
+                            NULL,
+                            dataP->userData);
+            lwm2m_free(dataP);
+            transaction_free(transacP);
+        }
+        else
+        {
+            queueP = &transacP->next;
+        }
+    }
+}
+
+static void prv_resultCallback(lwm2m_transaction_t * transacP,
+                               void * message)
+{
+    bs_data_t * dataP = (bs_data_t *)transacP->userData;
+    lwm2m_context_t * contextP = dataP->contextP;
+    uint8_t status;
+
+    if (message == NULL)
+    {
+        status = COAP_503_SERVICE_UNAVAILABLE;
+    }
+    else
+    {
+        status = ((coap_packet_t *)message)->code;
+    }
+
+    dataP->callback(transacP->peerH,
+                    status,
+                    prv_getUri(dataP),
+                    NULL,
+                    dataP->userData);
+    lwm2m_free(dataP);
+    transacP->userData = NULL;
+
+    if (status == COAP_202_DELETED
+     || status == COAP_204_CHANGED)
+    {
+        prv_drain(contextP, transacP->peerH, transacP);
+    }
+    else
+    {
+        prv_cancel(contextP, transacP->peerH);
+    }
+}
+
+static int prv_sendCommand(lwm2m_context_t * contextP,
+                           lwm2m_transaction_t * transacP,
+                           bs_data_t * dataP)
+{
+    lwm2m_transaction_t * queuedP;
+    lwm2m_transaction_t ** queueP;
+
+    dataP->callback = contextP->bootstrapCallback;
+    dataP->userData = contextP->bootstrapUserData;
+    dataP->contextP = contextP;
+
+    transacP->callback = prv_resultCallback;
+    transacP->userData = (void *)dataP;
+
+    queuedP = contextP->bootstrapQueue;
+    while (queuedP != NULL
+        && lwm2m_session_is_equal(queuedP->peerH, transacP->peerH, contextP->userData) == false)
+    {
+        queuedP = queuedP->next;
+    }
+
+    if (queuedP == NULL
+     && prv_canSend(contextP, transacP, NULL))
+    {
+        contextP->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(contextP->transactionList, transacP);
+
+        return transaction_send(contextP, transacP);
+    }
+
+    // the payload belongs to the caller
+    if (transaction_serialize(transacP) != 0)
+    {
+        lwm2m_free(dataP);
+        transaction_free(transacP);
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    LOG_ARG("Command %d waits for its turn", transacP->mID);
+    queueP = &contextP->bootstrapQueue;
+    while (*queueP != NULL)
+    {
+        queueP = &((*queueP)->next);
+    }
+    transacP->next = NULL;
+    *queueP = transacP;
+
+    return COAP_NO_ERROR;
+}
+
+void bootstrap_free(lwm2m_context_t * contextP)
+{
+    while (contextP->bootstrapQueue != NULL)
+    {
+        lwm2m_transaction_t * transacP;
+
+        transacP = contextP->bootstrapQueue;
+        contextP->bootstrapQueue = transacP->next;
+        lwm2m_free(transacP->userData);
+        transaction_free(transacP);
+    }
+}
+
 uint8_t bootstrap_handleRequest(lwm2m_context_t * contextP,
                                 lwm2m_uri_t * uriP,
                                 void * fromSessionH,
@@ -603,6 +798,9 @@ uint8_t bootstrap_handleRequest(lwm2m_context_t * contextP,
     memcpy(name, message->uri_query->data + QUERY_NAME_LEN, message->uri_query->len - QUERY_NAME_LEN);
     name[message->uri_query->len - QUERY_NAME_LEN] = 0;
 
+    // the client starts over: drop the commands waiting from a previous request
+    prv_cancel(contextP, fromSessionH);
+
     result = contextP->bootstrapCallback(fromSessionH, COAP_NO_ERROR, NULL, name, contextP->bootstrapUserData);
 
     lwm2m_free(name);
@@ -619,42 +817,6 @@ void lwm2m_set_bootstrap_callback(lwm2m_context_t * contextP,
     contextP->bootstrapUserData = userData;
 }
 
-static void prv_resultCallback(lwm2m_transaction_t * transacP,
-                               void * message)
-{
-    bs_data_t * dataP = (bs_data_t *)transacP->userData;
-    lwm2m_uri_t * uriP;
-
-    if (dataP->isUri == true)
-    {
-        uriP = &dataP->uri;
-    }
-    else
-    {
-        uriP = NULL;
-    }
-
-    if (message == NULL)
-    {
-        dataP->callback(transacP->peerH,
-                        COAP_503_SERVICE_UNAVAILABLE,
-                        uriP,
-                        NULL,
-                        dataP->userData);
-    }
-    else
-    {
-        coap_packet_t * packet = (coap_packet_t *)message;
-
-        dataP->callback(transacP->peerH,
-                        packet->code,
-                        uriP,
-                        NULL,
-                        dataP->userData);
-    }
-    lwm2m_free(dataP);
-}
-
 int lwm2m_bootstrap_delete(lwm2m_context_t * contextP,
                            void * sessionH,
                            lwm2m_uri_t * uriP)
@@ -681,15 +843,8 @@ int lwm2m_bootstrap_delete(lwm2m_context_t * contextP,
         dataP->isUri = true;
         memcpy(&dataP->uri, uriP, sizeof(lwm2m_uri_t));
     }
-    dataP->callback = contextP->bootstrapCallback;
-    dataP->userData = contextP->bootstrapUserData;
-
-    transaction->callback = prv_resultCallback;
-    transaction->userData = (void *)dataP;
 
-    contextP->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(contextP->transactionList, transaction);
-
-    return transaction_send(contextP, transaction);
+    return prv_sendCommand(contextP, transaction, dataP);
 }
 
 int lwm2m_bootstrap_write(lwm2m_context_t * contextP,
@@ -724,15 +879,8 @@ int lwm2m_bootstrap_write(lwm2m_context_t * contextP,
     }
     dataP->isUri = true;
     memcpy(&dataP->uri, uriP, sizeof(lwm2m_uri_t));
-    dataP->callback = contextP->bootstrapCallback;
-    dataP->userData = contextP->bootstrapUserData;
-
-    transaction->callback = prv_resultCallback;
-    transaction->userData = (void *)dataP;
 
-    contextP->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(contextP->transactionList, transaction);
-
-    return transaction_send(contextP, transaction);
+    return prv_sendCommand(contextP, transaction, dataP);
 }
 
 int lwm2m_bootstrap_finish(lwm2m_context_t * contextP,
@@ -754,15 +902,8 @@ int lwm2m_bootstrap_finish(lwm2m_context_t * contextP,
         return COAP_500_INTERNAL_SERVER_ERROR;
     }
     dataP->isUri = false;
-    dataP->callback = contextP->bootstrapCallback;
-    dataP->userData = contextP->bootstrapUserData;
-
-    transaction->callback = prv_resultCallback;
-    transaction->userData = (void *)dataP;
-
-    contextP->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(contextP->transactionList, transaction);
 
-    return transaction_send(contextP, transaction);
+    return prv_sendCommand(contextP, transaction, dataP);
 }
 
 #endif
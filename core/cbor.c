@@ -0,0 +1,1202 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * CBOR (RFC 7049) content formats:
+ * - LWM2M_CONTENT_CBOR: a single resource value as a CBOR data item.
+ * - LWM2M_CONTENT_SENML_CBOR: SenML records (RFC 8428) using integer labels. Object links are
+ *   text strings "objectId:instanceId" under the "vlo" label.
+ *
+ * Strings and byte strings are not escaped or encoded so, when parsing borrowed values, they point
+ * directly into the payload.
+ */
+
+#include "internals.h"
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <float.h>
+
+
+#ifdef LWM2M_SUPPORT_CBOR
+
+#define PRV_CBOR_MAX_NESTING    8       // of the unknown items which are skipped
+#define PRV_CBOR_NAME_MAX_LEN   32      // base name and name, "/65535/65535/65535/65535" being 24 bytes long
+#define PRV_CBOR_OBJLNK_MAX_LEN 12      // "65535:65535"
+
+#define CBOR_TYPE_UNSIGNED      0x00
+#define CBOR_TYPE_NEGATIVE      0x20
+#define CBOR_TYPE_BYTES         0x40
+#define CBOR_TYPE_TEXT          0x60
+#define CBOR_TYPE_ARRAY         0x80
+#define CBOR_TYPE_MAP           0xA0
+#define CBOR_TYPE_TAG           0xC0
+#define CBOR_TYPE_SIMPLE        0xE0
+#define CBOR_TYPE_MASK          0xE0
+#define CBOR_INFO_MASK          0x1F
+
+#define CBOR_INFO_UINT8         24
+#define CBOR_INFO_UINT64        27
+#define CBOR_INFO_INDEFINITE    31
+
+#define CBOR_INFO_FALSE         20
+#define CBOR_INFO_TRUE          21
+#define CBOR_INFO_FLOAT16       25
+#define CBOR_INFO_FLOAT32       26
+#define CBOR_INFO_FLOAT64       27
+#define CBOR_BREAK              0xFF
+
+#define SENML_LABEL_BASE_VERSION    -1
+#define SENML_LABEL_BASE_NAME       -2
+#define SENML_LABEL_BASE_TIME       -3
+#define SENML_LABEL_BASE_UNIT       -4
+#define SENML_LABEL_BASE_VALUE      -5
+#define SENML_LABEL_BASE_SUM        -6
+#define SENML_LABEL_NAME            0
+#define SENML_LABEL_UNIT            1
+#define SENML_LABEL_VALUE           2
+#define SENML_LABEL_STRING_VALUE    3
+#define SENML_LABEL_BOOLEAN_VALUE   4
+#define SENML_LABEL_SUM             5
+#define SENML_LABEL_TIME            6
+#define SENML_LABEL_UPDATE_TIME     7
+#define SENML_LABEL_DATA_VALUE      8
+// text labels, mapped out of the range of the integer ones
+#define SENML_LABEL_OBJLNK_VALUE    0x10000
+#define SENML_LABEL_UNKNOWN         0x10001
+
+#define SENML_OBJLNK_LABEL          "vlo"
+#define SENML_OBJLNK_LABEL_LEN      3
+
+typedef struct
+{
+    uint8_t * buffer;
+    size_t    length;
+    size_t    index;
+} _reader_t;
+
+// An array or a map being read. count is the number of items, or of pairs for a map, left in a
+// definite length container.
+typedef struct
+{
+    bool     isIndefinite;
+    uint64_t count;
+} _container_t;
+
+typedef struct
+{
+    _reader_t      reader;
+    bool           isBorrowed;
+    uint16_t       uriIds[SENML_MAX_DEPTH];
+    int            uriDepth;
+    uint8_t *      baseName;
+    size_t         baseNameLen;
+    double         baseTime;
+    senml_tree_t   tree;
+} _parser_t;
+
+typedef struct
+{
+    utils_buffer_t * bufferP;
+    uint8_t *        baseName;      // written in the first record only
+    size_t           baseNameLen;
+} _writer_t;
+
+// Kept small so that it is inlined, most writes being a few bytes long.
+static inline int prv_append(utils_buffer_t * bufferP,
+                             const void * data,
+                             size_t length)
+{
+    if (bufferP->capacity - bufferP->length >= length)
+    {
+        memcpy(bufferP->data + bufferP->length, data, length);
+        bufferP->length += length;
+        return 0;
+    }
+
+    return utils_bufferAppend(bufferP, data, length);
+}
+
+static int prv_writeHead(utils_buffer_t * bufferP,
+                         uint8_t type,
+                         uint64_t value)
+{
+    uint8_t head[9];
+    size_t length;
+    size_t i;
+
+    if (value < CBOR_INFO_UINT8)
+    {
+        head[0] = type | (uint8_t)value;
+        length = 1;
+    }
+    else if (value <= 0xFF)
+    {
+        head[0] = type | CBOR_INFO_UINT8;
+        length = 2;
+    }
+    else if (value <= 0xFFFF)
+    {
+        head[0] = type | (CBOR_INFO_UINT8 + 1);
+        length = 3;
+    }
+    else if (value <= 0xFFFFFFFF)
+    {
+        head[0] = type | (CBOR_INFO_UINT8 + 2);
+        length = 5;
+    }
+    else
+    {
+        head[0] = type | CBOR_INFO_UINT64;
+        length = 9;
+    }
+    for (i = length - 1 ; i > 0 ; i--)
+    {
+        head[i] = (uint8_t)(value & 0xFF);
+        value >>= 8;
+    }
+
+    return prv_append(bufferP, head, length);
+}
+
+static int prv_writeInt(utils_buffer_t * bufferP,
+                        int64_t value)
+{
+    if (value >= 0)
+    {
+        return prv_writeHead(bufferP, CBOR_TYPE_UNSIGNED, (uint64_t)value);
+    }
+
+    return prv_writeHead(bufferP, CBOR_TYPE_NEGATIVE, (uint64_t)(-1 - value));
+}
+
+// Uses a single precision float when it holds the exact value.
+static int prv_writeFloat(utils_buffer_t * bufferP,
+                          double value)
+{
+    uint8_t data[9];
+    uint64_t bits;
+    size_t length;
+    size_t i;
+
+    // NaN compares as exact
+    if (!(value < -FLT_MAX || value > FLT_MAX)
+     && !((double)(float)value < value || (double)(float)value > value))
+    {
+        float single;
+        uint32_t singleBits;
+
+        single = (float)value;
+        memcpy(&singleBits, &single, sizeof(singleBits));
+        bits = singleBits;
+        data[0] = CBOR_TYPE_SIMPLE | CBOR_INFO_FLOAT32;
+        length = 5;
+    }
+    else
+    {
+        memcpy(&bits, &value, sizeof(bits));
+        data[0] = CBOR_TYPE_SIMPLE | CBOR_INFO_FLOAT64;
+        length = 9;
+    }
+    for (i = length - 1 ; i > 0 ; i--)
+    {
+        data[i] = (uint8_t)(bits & 0xFF);
+        bits >>= 8;
+    }
+
+    return prv_append(bufferP, data, length);
+}
+
+static int prv_writeString(utils_buffer_t * bufferP,
+                           uint8_t type,
+                           const uint8_t * data,
+                           size_t length)
+{
+    if (prv_writeHead(bufferP, type, length) != 0) return -1;
+    if (length == 0) return 0;
+
+    return prv_append(bufferP, data, length);
+}
+
+static int prv_writeObjLink(utils_buffer_t * bufferP,
+                            lwm2m_data_t * dataP)
+{
+    uint8_t string[PRV_CBOR_OBJLNK_MAX_LEN];
+    int length;
+    int res;
+
+    res = utils_intToText(dataP->value.asObjLink.objectId, string, sizeof(string));
+    if (res <= 0) return -1;
+    length = res;
+    string[length++] = ':';
+    res = utils_intToText(dataP->value.asObjLink.objectInstanceId, string + length, sizeof(string) - length);
+    if (res <= 0) return -1;
+    length += res;
+
+    return prv_writeString(bufferP, CBOR_TYPE_TEXT, string, length);
+}
+
+// Writes the value, preceded by its SenML label when withLabel is true.
+static int prv_writeValue(utils_buffer_t * bufferP,
+                          lwm2m_data_t * dataP,
+                          bool withLabel)
+{
+    uint8_t * buffer;
+    size_t length;
+
+    switch (dataP->type)
+    {
+    case LWM2M_TYPE_STRING:
+        if (withLabel && prv_writeInt(bufferP, SENML_LABEL_STRING_VALUE) != 0) return -1;
+        buffer = lwm2m_data_get_buffer(dataP, &length);
+        return prv_writeString(bufferP, CBOR_TYPE_TEXT, buffer, length);
+
+    case LWM2M_TYPE_OPAQUE:
+        if (withLabel && prv_writeInt(bufferP, SENML_LABEL_DATA_VALUE) != 0) return -1;
+        buffer = lwm2m_data_get_buffer(dataP, &length);
+        return prv_writeString(bufferP, CBOR_TYPE_BYTES, buffer, length);
+
+    case LWM2M_TYPE_INTEGER:
+        if (withLabel && prv_writeInt(bufferP, SENML_LABEL_VALUE) != 0) return -1;
+        return prv_writeInt(bufferP, dataP->value.asInteger);
+
+    case LWM2M_TYPE_FLOAT:
+        if (withLabel && prv_writeInt(bufferP, SENML_LABEL_VALUE) != 0) return -1;
+        return prv_writeFloat(bufferP, dataP->value.asFloat);
+
+    case LWM2M_TYPE_BOOLEAN:
+    {
+        uint8_t value;
+
+        if (withLabel && prv_writeInt(bufferP, SENML_LABEL_BOOLEAN_VALUE) != 0) return -1;
+        value = CBOR_TYPE_SIMPLE | (dataP->value.asBoolean ? CBOR_INFO_TRUE : CBOR_INFO_FALSE);
+        return prv_append(bufferP, &value, 1);
+    }
+
+    case LWM2M_TYPE_OBJECT_LINK:
+        if (withLabel
+         && prv_writeString(bufferP, CBOR_TYPE_TEXT, (const uint8_t *)SENML_OBJLNK_LABEL, SENML_OBJLNK_LABEL_LEN) != 0)
+        {
+            return -1;
+        }
+        return prv_writeObjLink(bufferP, dataP);
+
+    default:
+        return -1;
+    }
+}
+
+// Reads the head of the next item. valueP receives the argument: the value of an integer, the length
+// of a string, the number of items of an array or a map, or the bits of a float.
+static bool prv_readHead(_reader_t * readerP,
+                         uint8_t * typeP,
+                         uint8_t * infoP,
+                         uint64_t * valueP)
+{
+    uint8_t info;
+    size_t size;
+
+    if (readerP->index >= readerP->length) return false;
+
+    *typeP = readerP->buffer[readerP->index] & CBOR_TYPE_MASK;
+    info = readerP->buffer[readerP->index] & CBOR_INFO_MASK;
+    readerP->index++;
+    *infoP = info;
+    *valueP = 0;
+
+    if (info < CBOR_INFO_UINT8)
+    {
+        *valueP = info;
+        return true;
+    }
+    if (info == CBOR_INFO_INDEFINITE)
+    {
+        // a break is only valid in an indefinite length container, where it is checked first
+        return (*typeP == CBOR_TYPE_BYTES
+             || *typeP == CBOR_TYPE_TEXT
+             || *typeP == CBOR_TYPE_ARRAY
+             || *typeP == CBOR_TYPE_MAP);
+    }
+    if (info > CBOR_INFO_UINT64) return false;
+
+    size = (size_t)1 << (info - CBOR_INFO_UINT8);
+    if (readerP->length - readerP->index < size) return false;
+    while (size > 0)
+    {
+        *valueP = (*valueP << 8) | readerP->buffer[readerP->index];
+        readerP->index++;
+        size--;
+    }
+
+    return true;
+}
+
+static bool prv_skipItem(_reader_t * readerP,
+                         int nesting)
+{
+    uint8_t type;
+    uint8_t info;
+    uint64_t value;
+
+    if (nesting > PRV_CBOR_MAX_NESTING) return false;
+    if (!prv_readHead(readerP, &type, &info, &value)) return false;
+
+    switch (type)
+    {
+    case CBOR_TYPE_BYTES:
+    case CBOR_TYPE_TEXT:
+        if (info != CBOR_INFO_INDEFINITE)
+        {
+            if (value > readerP->length - readerP->index) return false;
+            readerP->index += (size_t)value;
+            return true;
+        }
+        // the chunks are skipped as the items of an array
+        // fall through
+    case CBOR_TYPE_ARRAY:
+    case CBOR_TYPE_MAP:
+        if (info == CBOR_INFO_INDEFINITE)
+        {
+            while (readerP->index < readerP->length
+                && readerP->buffer[readerP->index] != CBOR_BREAK)
+            {
+                if (!prv_skipItem(readerP, nesting + 1)) return false;
+            }
+            if (readerP->index == readerP->length) return false;
+            readerP->index++;
+            return true;
+        }
+        // each item takes at least one byte
+        if (value > readerP->length - readerP->index) return false;
+        if (type == CBOR_TYPE_MAP) value *= 2;
+        while (value > 0)
+        {
+            if (!prv_skipItem(readerP, nesting + 1)) return false;
+            value--;
+        }
+        return true;
+
+    case CBOR_TYPE_TAG:
+        return prv_skipItem(readerP, nesting + 1);
+
+    default:
+        return true;
+    }
+}
+
+static bool prv_openContainer(_reader_t * readerP,
+                              uint8_t type,
+                              _container_t * containerP)
+{
+    uint8_t itemType;
+    uint8_t info;
+
+    if (!prv_readHead(readerP, &itemType, &info, &containerP->count)) return false;
+    if (itemType != type) return false;
+    containerP->isIndefinite = (info == CBOR_INFO_INDEFINITE);
+
+    return true;
+}
+
+// Returns 1 if an item, or a pair for a map, follows in the container, 0 at its end or -1 on error.
+static int prv_nextItem(_reader_t * readerP,
+                        _container_t * containerP)
+{
+    if (containerP->isIndefinite)
+    {
+        if (readerP->index >= readerP->length) return -1;
+        if (readerP->buffer[readerP->index] != CBOR_BREAK) return 1;
+        readerP->index++;
+        return 0;
+    }
+
+    if (containerP->count == 0) return 0;
+    containerP->count--;
+
+    return 1;
+}
+
+static double prv_halfToDouble(uint16_t half)
+{
+    uint32_t exponent;
+    uint32_t mantissa;
+    uint32_t bits;
+    float value;
+
+    exponent = (half >> 10) & 0x1F;
+    mantissa = half & 0x3FF;
+    if (exponent == 0)
+    {
+        // zero or subnormal
+        value = (float)mantissa / 16777216.0f;
+        return (half & 0x8000) ? -(double)value : (double)value;
+    }
+
+    if (exponent == 0x1F)
+    {
+        exponent = 0xFF;
+    }
+    else
+    {
+        exponent += 127 - 15;
+    }
+    bits = ((uint32_t)(half & 0x8000) << 16) | (exponent << 23) | (mantissa << 13);
+    memcpy(&value, &bits, sizeof(value));
+
+    return (double)value;
+}
+
+// Reads a scalar item, ignoring its tags. The strings and byte strings point into the payload.
+static bool prv_readValue(_reader_t * readerP,
+                          lwm2m_data_t * valueP)
+{
+    uint8_t type;
+    uint8_t info;
+    uint64_t value;
+
+    do
+    {
+        if (!prv_readHead(readerP, &type, &info, &value)) return false;
+    } while (type == CBOR_TYPE_TAG);
+
+    switch (type)
+    {
+    case CBOR_TYPE_UNSIGNED:
+        if (value > INT64_MAX) return false;
+        lwm2m_data_encode_int((int64_t)value, valueP);
+        return true;
+
+    case CBOR_TYPE_NEGATIVE:
+        if (value > INT64_MAX) return false;
+        lwm2m_data_encode_int(-1 - (int64_t)value, valueP);
+        return true;
+
+    case CBOR_TYPE_BYTES:
+    case CBOR_TYPE_TEXT:
+        if (info == CBOR_INFO_INDEFINITE) return false;
+        if (value > readerP->length - readerP->index) return false;
+        valueP->type = (type == CBOR_TYPE_TEXT) ? LWM2M_TYPE_STRING : LWM2M_TYPE_OPAQUE;
+        valueP->value.asBuffer.length = (size_t)value;
+        valueP->value.asBuffer.buffer = (value == 0) ? NULL : readerP->buffer + readerP->index;
+        readerP->index += (size_t)value;
+        return true;
+
+    case CBOR_TYPE_SIMPLE:
+        switch (info)
+        {
+        case CBOR_INFO_FALSE:
+            lwm2m_data_encode_bool(false, valueP);
+            return true;
+
+        case CBOR_INFO_TRUE:
+            lwm2m_data_encode_bool(true, valueP);
+            return true;
+
+        case CBOR_INFO_FLOAT16:
+            lwm2m_data_encode_float(prv_halfToDouble((uint16_t)value), valueP);
+            return true;
+
+        case CBOR_INFO_FLOAT32:
+        {
+            uint32_t bits;
+            float single;
+
+            bits = (uint32_t)value;
+            memcpy(&single, &bits, sizeof(single));
+            lwm2m_data_encode_float((double)single, valueP);
+            return true;
+        }
+
+        case CBOR_INFO_FLOAT64:
+        {
+            double number;
+
+            memcpy(&number, &value, sizeof(number));
+            lwm2m_data_encode_float(number, valueP);
+            return true;
+        }
+
+        default:
+            return false;
+        }
+
+    default:
+        return false;
+    }
+}
+
+static bool prv_readText(_reader_t * readerP,
+                         uint8_t ** textP,
+                         size_t * lengthP)
+{
+    lwm2m_data_t value;
+
+    memset(&value, 0, sizeof(value));
+    if (!prv_readValue(readerP, &value)
+     || value.type != LWM2M_TYPE_STRING)
+    {
+        return false;
+    }
+    *textP = value.value.asBuffer.buffer;
+    *lengthP = value.value.asBuffer.length;
+
+    return true;
+}
+
+// Converts an "objectId:instanceId" string.
+static bool prv_convertObjLink(lwm2m_data_t * valueP)
+{
+    uint8_t * string;
+    size_t length;
+    size_t sep;
+    int64_t objectId;
+    int64_t instanceId;
+
+    if (valueP->type != LWM2M_TYPE_STRING) return false;
+    string = valueP->value.asBuffer.buffer;
+    length = valueP->value.asBuffer.length;
+
+    for (sep = 0 ; sep < length && string[sep] != ':' ; sep++);
+    if (sep == 0 || sep + 1 >= length) return false;
+
+    if (1 != utils_textToInt(string, sep, &objectId)
+     || 1 != utils_textToInt(string + sep + 1, length - sep - 1, &instanceId)
+     || objectId < 0 || objectId > LWM2M_MAX_ID
+     || instanceId < 0 || instanceId > LWM2M_MAX_ID)
+    {
+        return false;
+    }
+
+    memset(valueP, 0, sizeof(lwm2m_data_t));
+    lwm2m_data_encode_objlink((uint16_t)objectId, (uint16_t)instanceId, valueP);
+
+    return true;
+}
+
+// Sets the value read in the payload to the target, copying the strings unless isBorrowed is true.
+static bool prv_setValue(lwm2m_data_t * valueP,
+                         bool isBorrowed,
+                         lwm2m_data_t * targetP)
+{
+    if ((valueP->type == LWM2M_TYPE_STRING || valueP->type == LWM2M_TYPE_OPAQUE)
+     && !isBorrowed)
+    {
+        if (0 == data_copyBuffer(targetP, valueP->value.asBuffer.buffer, valueP->value.asBuffer.length)) return false;
+        targetP->type = valueP->type;
+        return true;
+    }
+
+    targetP->type = valueP->type;
+    targetP->value = valueP->value;
+    if (targetP->type == LWM2M_TYPE_STRING || targetP->type == LWM2M_TYPE_OPAQUE)
+    {
+        targetP->flags |= LWM2M_DATA_FLAG_BORROWED;
+    }
+
+    return true;
+}
+
+int cbor_parse(lwm2m_uri_t * uriP,
+               uint8_t * buffer,
+               size_t bufferLen,
+               bool isBorrowed,
+               lwm2m_data_t ** dataP)
+{
+    _reader_t reader;
+    lwm2m_data_t value;
+
+    LOG_ARG("bufferLen: %d, isBorrowed: %s", bufferLen, isBorrowed?"true":"false");
+    LOG_URI(uriP);
+    *dataP = NULL;
+
+    if (uriP == NULL || !LWM2M_URI_IS_SET_RESOURCE(uriP)) return 0;
+
+    reader.buffer = buffer;
+    reader.length = bufferLen;
+    reader.index = 0;
+    memset(&value, 0, sizeof(value));
+    if (!prv_readValue(&reader, &value)
+     || reader.index != bufferLen)
+    {
+        return 0;
+    }
+
+    *dataP = lwm2m_data_new(1);
+    if (*dataP == NULL) return 0;
+    (*dataP)->id = uriP->resourceId;
+    if (!prv_setValue(&value, isBorrowed, *dataP))
+    {
+        lwm2m_data_free(1, *dataP);
+        *dataP = NULL;
+        return 0;
+    }
+
+    return 1;
+}
+
+int cbor_serialize(int size,
+                   lwm2m_data_t * dataP,
+                   utils_buffer_t * bufferP)
+{
+    size_t start;
+
+    LOG_ARG("size: %d", size);
+    if (size != 1) return -1;
+
+    start = bufferP->length;
+    if (prv_writeValue(bufferP, dataP, false) != 0)
+    {
+        bufferP->length = start;
+        return -1;
+    }
+
+    return (int)(bufferP->length - start);
+}
+
+// Reads a map key. The integer labels are returned as is, the text ones are mapped.
+static bool prv_readLabel(_reader_t * readerP,
+                          int32_t * labelP)
+{
+    lwm2m_data_t key;
+
+    // the SenML labels are small integers held in the initial byte
+    if (readerP->index < readerP->length)
+    {
+        uint8_t initial;
+
+        initial = readerP->buffer[readerP->index];
+        if (initial < CBOR_TYPE_UNSIGNED + CBOR_INFO_UINT8)
+        {
+            readerP->index++;
+            *labelP = initial;
+            return true;
+        }
+        if (initial >= CBOR_TYPE_NEGATIVE && initial < CBOR_TYPE_NEGATIVE + CBOR_INFO_UINT8)
+        {
+            readerP->index++;
+            *labelP = -1 - (initial - CBOR_TYPE_NEGATIVE);
+            return true;
+        }
+    }
+
+    memset(&key, 0, sizeof(key));
+    if (!prv_readValue(readerP, &key)) return false;
+
+    switch (key.type)
+    {
+    case LWM2M_TYPE_INTEGER:
+        if (key.value.asInteger < INT16_MIN || key.value.asInteger > INT16_MAX)
+        {
+            *labelP = SENML_LABEL_UNKNOWN;
+        }
+        else
+        {
+            *labelP = (int32_t)key.value.asInteger;
+        }
+        return true;
+
+    case LWM2M_TYPE_STRING:
+        if (key.value.asBuffer.length == SENML_OBJLNK_LABEL_LEN
+         && 0 == memcmp(key.value.asBuffer.buffer, SENML_OBJLNK_LABEL, SENML_OBJLNK_LABEL_LEN))
+        {
+            *labelP = SENML_LABEL_OBJLNK_VALUE;
+            return true;
+        }
+        // labels ending with '_' must be understood
+        if (key.value.asBuffer.length > 0
+         && key.value.asBuffer.buffer[key.value.asBuffer.length - 1] == '_')
+        {
+            return false;
+        }
+        *labelP = SENML_LABEL_UNKNOWN;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+// Reads a SenML time, in seconds.
+static bool prv_readTime(_reader_t * readerP,
+                         double * timeP)
+{
+    lwm2m_data_t value;
+
+    memset(&value, 0, sizeof(lwm2m_data_t));
+    if (!prv_readValue(readerP, &value)) return false;
+
+    switch (value.type)
+    {
+    case LWM2M_TYPE_INTEGER:
+        *timeP = (double)value.value.asInteger;
+        return true;
+    case LWM2M_TYPE_FLOAT:
+        *timeP = value.value.asFloat;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Reads a record. Its name, relative to the request URI unless it starts with a '/', is returned in
+// ids and depthP and its value, if any, in valueP.
+static bool prv_readRecord(_parser_t * parserP,
+                           lwm2m_data_t * valueP,
+                           uint16_t * ids,
+                           int * depthP)
+{
+    _container_t map;
+    uint8_t * name;
+    size_t nameLen;
+    uint8_t fullName[PRV_CBOR_NAME_MAX_LEN];
+    size_t fullNameLen;
+    double time;
+    double updateTime;
+    int res;
+
+    memset(valueP, 0, sizeof(lwm2m_data_t));
+    name = NULL;
+    nameLen = 0;
+    time = 0;
+
+    if (!prv_openContainer(&parserP->reader, CBOR_TYPE_MAP, &map)) return false;
+    while ((res = prv_nextItem(&parserP->reader, &map)) == 1)
+    {
+        int32_t label;
+
+        if (!prv_readLabel(&parserP->reader, &label)) return false;
+        switch (label)
+        {
+        case SENML_LABEL_BASE_NAME:
+            if (!prv_readText(&parserP->reader, &parserP->baseName, &parserP->baseNameLen)) return false;
+            break;
+
+        case SENML_LABEL_NAME:
+            if (name != NULL) return false;
+            if (!prv_readText(&parserP->reader, &name, &nameLen)) return false;
+            break;
+
+        case SENML_LABEL_VALUE:
+        case SENML_LABEL_STRING_VALUE:
+        case SENML_LABEL_BOOLEAN_VALUE:
+        case SENML_LABEL_DATA_VALUE:
+        case SENML_LABEL_OBJLNK_VALUE:
+            if (valueP->type != LWM2M_TYPE_UNDEFINED) return false;
+            if (!prv_readValue(&parserP->reader, valueP)) return false;
+            switch (label)
+            {
+            case SENML_LABEL_VALUE:
+                if (valueP->type != LWM2M_TYPE_INTEGER && valueP->type != LWM2M_TYPE_FLOAT) return false;
+                break;
+            case SENML_LABEL_STRING_VALUE:
+                if (valueP->type != LWM2M_TYPE_STRING) return false;
+                break;
+            case SENML_LABEL_BOOLEAN_VALUE:
+                if (valueP->type != LWM2M_TYPE_BOOLEAN) return false;
+                break;
+            case SENML_LABEL_DATA_VALUE:
+                if (valueP->type != LWM2M_TYPE_OPAQUE) return false;
+                break;
+            default:
+                if (!prv_convertObjLink(valueP)) return false;
+                break;
+            }
+            break;
+
+        case SENML_LABEL_BASE_VALUE:
+        case SENML_LABEL_BASE_SUM:
+        case SENML_LABEL_SUM:
+            // would change the values
+            return false;
+
+        case SENML_LABEL_BASE_TIME:
+            if (!prv_readTime(&parserP->reader, &parserP->baseTime)) return false;
+            break;
+
+        case SENML_LABEL_TIME:
+            if (!prv_readTime(&parserP->reader, &time)) return false;
+            break;
+
+        case SENML_LABEL_UPDATE_TIME:
+            // only tells when the next value is expected
+            if (!prv_readTime(&parserP->reader, &updateTime)) return false;
+            break;
+
+        default:
+            if (!prv_skipItem(&parserP->reader, 0)) return false;
+            break;
+        }
+    }
+    if (res < 0) return false;
+
+    // lwm2m_data_t has no timestamp: only the current values, at time 0, are accepted
+    time += parserP->baseTime;
+    if (time < 0 || time > 0) return false;
+
+    // the name is the concatenation of the base name and the record name. It is absolute when
+    // starting with a '/', relative to the request URI otherwise.
+    fullNameLen = parserP->baseNameLen + nameLen;
+    if (fullNameLen > PRV_CBOR_NAME_MAX_LEN) return false;
+    if (parserP->baseNameLen > 0) memcpy(fullName, parserP->baseName, parserP->baseNameLen);
+    if (nameLen > 0) memcpy(fullName + parserP->baseNameLen, name, nameLen);
+
+    if (fullNameLen > 0 && fullName[0] == '/')
+    {
+        *depthP = 0;
+    }
+    else
+    {
+        memcpy(ids, parserP->uriIds, SENML_MAX_DEPTH * sizeof(uint16_t));
+        *depthP = parserP->uriDepth;
+    }
+    if (fullNameLen > 0
+     && !senml_parseName(fullName, fullNameLen, ids, depthP))
+    {
+        return false;
+    }
+
+    return true;
+}
+
+static bool prv_parseRecord(_parser_t * parserP)
+{
+    lwm2m_data_t value;
+    uint16_t ids[SENML_MAX_DEPTH];
+    int depth;
+    lwm2m_data_t * targetP;
+
+    if (!prv_readRecord(parserP, &value, ids, &depth)) return false;
+    if (value.type == LWM2M_TYPE_UNDEFINED) return false;
+
+    targetP = senml_addRecord(&parserP->tree, ids, depth);
+    if (targetP == NULL) return false;
+
+    return prv_setValue(&value, parserP->isBorrowed, targetP);
+}
+
+int senml_cbor_parse(lwm2m_uri_t * uriP,
+                     uint8_t * buffer,
+                     size_t bufferLen,
+                     bool isBorrowed,
+                     lwm2m_data_t ** dataP)
+{
+    _parser_t parser;
+    _container_t array;
+    int count;
+    int res;
+
+    LOG_ARG("bufferLen: %d, isBorrowed: %s", bufferLen, isBorrowed?"true":"false");
+    LOG_URI(uriP);
+    *dataP = NULL;
+
+    memset(&parser, 0, sizeof(_parser_t));
+    parser.reader.buffer = buffer;
+    parser.reader.length = bufferLen;
+    parser.isBorrowed = isBorrowed;
+    parser.uriDepth = senml_uriToIds(uriP, parser.uriIds);
+    senml_treeInit(&parser.tree);
+    count = 0;
+
+    if (!prv_openContainer(&parser.reader, CBOR_TYPE_ARRAY, &array)) goto error;
+    while ((res = prv_nextItem(&parser.reader, &array)) == 1)
+    {
+        if (!prv_parseRecord(&parser)) goto error;
+    }
+    if (res < 0 || parser.reader.index != bufferLen) goto error;
+
+    if (parser.tree.root.value.asChildren.count > 0)
+    {
+        count = senml_extractData(&parser.tree, uriP, dataP);
+        if (count <= 0) goto error;
+        senml_treeFree(&parser.tree);
+    }
+
+    LOG_ARG("Parsing successful. count: %d", count);
+    return count;
+
+error:
+    LOG("Parsing failed");
+    if (*dataP != NULL)
+    {
+        lwm2m_data_free(count, *dataP);
+        *dataP = NULL;
+    }
+    senml_treeFree(&parser.tree);
+    return -1;
+}
+
+// Reads the names of a Read-Composite request, records without values. Returns the number of URIs
+// or -1 on error.
+int senml_cbor_parseUris(uint8_t * buffer,
+                         size_t bufferLen,
+                         lwm2m_uri_t ** urisP)
+{
+    _parser_t parser;
+    _container_t array;
+    lwm2m_data_t value;
+    uint16_t ids[SENML_MAX_DEPTH];
+    int depth;
+    int count;
+    int res;
+
+    LOG_ARG("bufferLen: %d", bufferLen);
+    *urisP = NULL;
+
+    // first pass to size the array
+    memset(&parser, 0, sizeof(_parser_t));
+    parser.reader.buffer = buffer;
+    parser.reader.length = bufferLen;
+    count = 0;
+    if (!prv_openContainer(&parser.reader, CBOR_TYPE_ARRAY, &array)) return -1;
+    while ((res = prv_nextItem(&parser.reader, &array)) == 1)
+    {
+        if (!prv_skipItem(&parser.reader, 0)) return -1;
+        count++;
+    }
+    if (res < 0 || parser.reader.index != bufferLen || count == 0) return -1;
+
+    *urisP = (lwm2m_uri_t *)lwm2m_malloc(count * sizeof(lwm2m_uri_t));
+    if (*urisP == NULL) return -1;
+    memset(*urisP, 0, count * sizeof(lwm2m_uri_t));
+
+    parser.reader.index = 0;
+    count = 0;
+    prv_openContainer(&parser.reader, CBOR_TYPE_ARRAY, &array);
+    while (prv_nextItem(&parser.reader, &array) == 1)
+    {
+        lwm2m_uri_t * uriP = *urisP + count;
+
+        if (!prv_readRecord(&parser, &value, ids, &depth)) goto error;
+        // the URIs are of objects, object instances or resources
+        if (value.type != LWM2M_TYPE_UNDEFINED
+         || depth == 0
+         || depth > URI_DEPTH_RESOURCE + 1)
+        {
+            goto error;
+        }
+
+        uriP->objectId = ids[URI_DEPTH_OBJECT];
+        uriP->flag = LWM2M_URI_FLAG_OBJECT_ID;
+        if (depth > URI_DEPTH_OBJECT_INSTANCE)
+        {
+            uriP->instanceId = ids[URI_DEPTH_OBJECT_INSTANCE];
+            uriP->flag |= LWM2M_URI_FLAG_INSTANCE_ID;
+        }
+        if (depth > URI_DEPTH_RESOURCE)
+        {
+            uriP->resourceId = ids[URI_DEPTH_RESOURCE];
+            uriP->flag |= LWM2M_URI_FLAG_RESOURCE_ID;
+        }
+        count++;
+    }
+
+    return count;
+
+error:
+    lwm2m_free(*urisP);
+    *urisP = NULL;
+    return -1;
+}
+
+// Writes records without values naming the URIs, the payload of a Read-Composite request.
+int senml_cbor_serializeUris(int count,
+                             lwm2m_uri_t * urisP,
+                             utils_buffer_t * bufferP)
+{
+    uint8_t uriStr[URI_MAX_STRING_LEN];
+    size_t start;
+    int index;
+    int res;
+
+    LOG_ARG("count: %d", count);
+    start = bufferP->length;
+    if (prv_writeHead(bufferP, CBOR_TYPE_ARRAY, count) != 0) goto error;
+    for (index = 0 ; index < count ; index++)
+    {
+        res = uri_toString(urisP + index, uriStr, URI_MAX_STRING_LEN, NULL);
+        if (res <= 1) goto error;
+
+        if (prv_writeHead(bufferP, CBOR_TYPE_MAP, 1) != 0) goto error;
+        if (prv_writeInt(bufferP, SENML_LABEL_NAME) != 0) goto error;
+        // without the trailing '/'
+        if (prv_writeString(bufferP, CBOR_TYPE_TEXT, uriStr, res - 1) != 0) goto error;
+    }
+
+    return (int)(bufferP->length - start);
+
+error:
+    bufferP->length = start;
+    return -1;
+}
+
+static size_t prv_countRecords(lwm2m_data_t * dataP)
+{
+    size_t count;
+    size_t index;
+
+    switch (dataP->type)
+    {
+    case LWM2M_TYPE_OBJECT:
+    case LWM2M_TYPE_OBJECT_INSTANCE:
+    case LWM2M_TYPE_MULTIPLE_RESOURCE:
+        count = 0;
+        for (index = 0 ; index < dataP->value.asChildren.count ; index++)
+        {
+            count += prv_countRecords(dataP->value.asChildren.array + index);
+        }
+        return count;
+
+    default:
+        return 1;
+    }
+}
+
+static int prv_serializeData(_writer_t * writerP,
+                             lwm2m_data_t * dataP,
+                             uint8_t * parentNameStr,
+                             size_t parentNameLen)
+{
+    int res;
+
+    switch (dataP->type)
+    {
+    case LWM2M_TYPE_OBJECT:
+    case LWM2M_TYPE_OBJECT_INSTANCE:
+    case LWM2M_TYPE_MULTIPLE_RESOURCE:
+    {
+        uint8_t nameStr[URI_MAX_STRING_LEN];
+        size_t nameLen;
+        size_t index;
+
+        if (parentNameLen > 0)
+        {
+            if (URI_MAX_STRING_LEN < parentNameLen) return -1;
+            memcpy(nameStr, parentNameStr, parentNameLen);
+        }
+        nameLen = parentNameLen;
+        res = utils_intToText(dataP->id, nameStr + nameLen, URI_MAX_STRING_LEN - nameLen);
+        if (res <= 0) return -1;
+        nameLen += res;
+        if (nameLen >= URI_MAX_STRING_LEN) return -1;
+        nameStr[nameLen] = '/';
+        nameLen++;
+
+        for (index = 0 ; index < dataP->value.asChildren.count ; index++)
+        {
+            if (prv_serializeData(writerP, dataP->value.asChildren.array + index, nameStr, nameLen) != 0) return -1;
+        }
+    }
+    break;
+
+    default:
+    {
+        uint8_t idStr[LWM2M_STRING_ID_MAX_LEN];
+
+        res = utils_intToText(dataP->id, idStr, LWM2M_STRING_ID_MAX_LEN);
+        if (res <= 0) return -1;
+
+        if (prv_writeHead(writerP->bufferP, CBOR_TYPE_MAP, writerP->baseName != NULL ? 3 : 2) != 0) return -1;
+        if (writerP->baseName != NULL)
+        {
+            if (prv_writeInt(writerP->bufferP, SENML_LABEL_BASE_NAME) != 0) return -1;
+            if (prv_writeString(writerP->bufferP, CBOR_TYPE_TEXT, writerP->baseName, writerP->baseNameLen) != 0) return -1;
+            writerP->baseName = NULL;
+        }
+
+        if (prv_writeInt(writerP->bufferP, SENML_LABEL_NAME) != 0) return -1;
+        if (prv_writeHead(writerP->bufferP, CBOR_TYPE_TEXT, parentNameLen + res) != 0) return -1;
+        if (parentNameLen > 0
+         && prv_append(writerP->bufferP, parentNameStr, parentNameLen) != 0)
+        {
+            return -1;
+        }
+        if (prv_append(writerP->bufferP, idStr, res) != 0) return -1;
+
+        if (prv_writeValue(writerP->bufferP, dataP, true) != 0) return -1;
+    }
+    break;
+    }
+
+    return 0;
+}
+
+// Append the SenML records of the data to the buffer. Returns the number of bytes written or -1 on error.
+int senml_cbor_serialize(lwm2m_uri_t * uriP,
+                         int size,
+                         lwm2m_data_t * dataP,
+                         utils_buffer_t * bufferP)
+{
+    senml_part_t part;
+
+    part.uriP = uriP;
+    part.size = size;
+    part.dataP = dataP;
+
+    return senml_cbor_serializeParts(1, &part, bufferP);
+}
+
+// Same as senml_cbor_serialize() for the data read at several URIs. Each part sets the base name of
+// its records so they are written in a single pack.
+int senml_cbor_serializeParts(int count,
+                              senml_part_t * partsP,
+                              utils_buffer_t * bufferP)
+{
+    _writer_t writer;
+    uint8_t baseUriStr[URI_MAX_STRING_LEN];
+    int baseUriLen;
+    lwm2m_data_t * targetP;
+    size_t recordCount;
+    size_t start;
+    int num;
+    int part;
+    int index;
+
+    recordCount = 0;
+    for (part = 0 ; part < count ; part++)
+    {
+        num = senml_findBaseName(partsP[part].uriP, partsP[part].size, partsP[part].dataP, baseUriStr, &baseUriLen, &targetP);
+        if (num < 0) return -1;
+
+        for (index = 0 ; index < num ; index++)
+        {
+            recordCount += prv_countRecords(targetP + index);
+        }
+    }
+
+    writer.bufferP = bufferP;
+
+    start = bufferP->length;
+    if (prv_writeHead(bufferP, CBOR_TYPE_ARRAY, recordCount) != 0) goto error;
+    for (part = 0 ; part < count ; part++)
+    {
+        num = senml_findBaseName(partsP[part].uriP, partsP[part].size, partsP[part].dataP, baseUriStr, &baseUriLen, &targetP);
+        writer.baseName = baseUriStr;
+        writer.baseNameLen = baseUriLen;
+        for (index = 0 ; index < num ; index++)
+        {
+            if (prv_serializeData(&writer, targetP + index, NULL, 0) != 0) goto error;
+        }
+    }
+
+    return (int)(bufferP->length - start);
+
+error:
+    bufferP->length = start;
+    return -1;
+}
+
+#endif
@@ -0,0 +1,291 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Default store of the clients registered to the server.
+ * The clients are kept in a list sorted by internal ID with its index, and in a hash table by name so
+ * that a registration finds the previous one of the same endpoint without walking the whole list.
+ * The observations are only kept in the list of their client.
+ */
+
+#include "internals.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+#ifdef LWM2M_SERVER_MODE
+
+#define PRV_NAMES_MIN_CAPACITY  16
+
+typedef struct
+{
+    uint32_t         hash;
+    lwm2m_client_t * clientP;   // NULL in free slots
+} _name_entry_t;
+
+typedef struct
+{
+    lwm2m_client_store_t store;
+    lwm2m_client_t *     clientList;
+    lwm2m_list_index_t   clientIndex;   // clientList sorted by internal ID
+    _name_entry_t *      names;         // open addressing hash table, never more than half full
+    size_t               mask;          // capacity - 1, the capacity being a power of two
+    size_t               nameCount;
+} _memory_store_t;
+
+static size_t prv_nameSlot(_memory_store_t * memP,
+                           const char * name,
+                           size_t nameLength,
+                           uint32_t hash)
+{
+    size_t position;
+
+    position = hash & memP->mask;
+    while (memP->names[position].clientP != NULL
+        && (memP->names[position].hash != hash
+         || strncmp(memP->names[position].clientP->name, name, nameLength) != 0
+         || memP->names[position].clientP->name[nameLength] != 0))
+    {
+        position = (position + 1) & memP->mask;
+    }
+
+    return position;
+}
+
+static int prv_growNames(_memory_store_t * memP)
+{
+    _name_entry_t * names;
+    size_t oldCapacity;
+    size_t capacity;
+    size_t i;
+
+    oldCapacity = memP->names == NULL ? 0 : memP->mask + 1;
+    capacity = oldCapacity == 0 ? PRV_NAMES_MIN_CAPACITY : oldCapacity * 2;
+    names = (_name_entry_t *)lwm2m_malloc(capacity * sizeof(_name_entry_t));
+    if (names == NULL) return -1;
+    memset(names, 0, capacity * sizeof(_name_entry_t));
+
+    for (i = 0 ; i < oldCapacity ; i++)
+    {
+        size_t position;
+
+        if (memP->names[i].clientP == NULL) continue;
+        position = memP->names[i].hash & (capacity - 1);
+        while (names[position].clientP != NULL)
+        {
+            position = (position + 1) & (capacity - 1);
+        }
+        names[position] = memP->names[i];
+    }
+
+    if (memP->names != NULL) lwm2m_free(memP->names);
+    memP->names = names;
+    memP->mask = capacity - 1;
+
+    return 0;
+}
+
+static void prv_removeName(_memory_store_t * memP,
+                           lwm2m_client_t * clientP)
+{
+    size_t nameLength;
+    size_t position;
+    size_t next;
+
+    nameLength = strlen(clientP->name);
+    position = prv_nameSlot(memP, clientP->name, nameLength, utils_hash((uint8_t *)clientP->name, nameLength));
+    if (memP->names[position].clientP != clientP) return;
+
+    // move back the following entries of the cluster which could no longer be reached
+    next = (position + 1) & memP->mask;
+    while (memP->names[next].clientP != NULL)
+    {
+        size_t home;
+
+        home = memP->names[next].hash & memP->mask;
+        if (position <= next ? (home <= position || home > next) : (home <= position && home > next))
+        {
+            memP->names[position] = memP->names[next];
+            position = next;
+        }
+        next = (next + 1) & memP->mask;
+    }
+    memP->names[position].clientP = NULL;
+    memP->nameCount--;
+}
+
+static int prv_addClient(lwm2m_client_t * clientP,
+                         lwm2m_client_store_t * storeP)
+{
+    _memory_store_t * memP = (_memory_store_t *)storeP->userData;
+    size_t nameLength;
+    uint32_t hash;
+    size_t position;
+
+    if (memP->names == NULL || (memP->nameCount + 1) * 2 > memP->mask + 1)
+    {
+        if (prv_growNames(memP) != 0) return -1;
+    }
+    if (0 != LWM2M_INDEX_ADD(&memP->clientIndex, memP->clientList, clientP)) return -1;
+
+    nameLength = strlen(clientP->name);
+    hash = utils_hash((uint8_t *)clientP->name, nameLength);
+    position = prv_nameSlot(memP, clientP->name, nameLength, hash);
+    if (memP->names[position].clientP == NULL)
+    {
+        memP->nameCount++;
+    }
+    memP->names[position].hash = hash;
+    memP->names[position].clientP = clientP;
+
+    return 0;
+}
+
+static void prv_updateClient(lwm2m_client_t * clientP,
+                             lwm2m_client_store_t * storeP)
+{
+    // the store only holds pointers to the clients
+    (void)clientP;
+    (void)storeP;
+}
+
+static lwm2m_client_t * prv_findClient(uint16_t internalID,
+                                       lwm2m_client_store_t * storeP)
+{
+    _memory_store_t * memP = (_memory_store_t *)storeP->userData;
+
+    return (lwm2m_client_t *)LWM2M_INDEX_FIND(&memP->clientIndex, internalID);
+}
+
+static lwm2m_client_t * prv_findName(const char * name,
+                                     size_t nameLength,
+                                     lwm2m_client_store_t * storeP)
+{
+    _memory_store_t * memP = (_memory_store_t *)storeP->userData;
+
+    if (memP->nameCount == 0) return NULL;
+
+    return memP->names[prv_nameSlot(memP, name, nameLength, utils_hash((uint8_t *)name, nameLength))].clientP;
+}
+
+static lwm2m_client_t * prv_removeClient(uint16_t internalID,
+                                         lwm2m_client_store_t * storeP)
+{
+    _memory_store_t * memP = (_memory_store_t *)storeP->userData;
+    lwm2m_client_t * clientP;
+
+    clientP = (lwm2m_client_t *)LWM2M_INDEX_RM(&memP->clientIndex, memP->clientList, internalID);
+    if (clientP != NULL)
+    {
+        prv_removeName(memP, clientP);
+    }
+
+    return clientP;
+}
+
+static lwm2m_client_t * prv_nextClient(lwm2m_client_t * clientP,
+                                       lwm2m_client_store_t * storeP)
+{
+    _memory_store_t * memP = (_memory_store_t *)storeP->userData;
+
+    if (clientP == NULL) return memP->clientList;
+
+    return clientP->next;
+}
+
+static uint16_t prv_newId(lwm2m_client_store_t * storeP)
+{
+    _memory_store_t * memP = (_memory_store_t *)storeP->userData;
+
+    return LWM2M_INDEX_NEWID(&memP->clientIndex);
+}
+
+static int prv_addObservation(lwm2m_observation_t * observationP,
+                              lwm2m_client_store_t * storeP)
+{
+    // already in the list of its client
+    (void)observationP;
+    (void)storeP;
+
+    return 0;
+}
+
+static lwm2m_observation_t * prv_findObservation(lwm2m_client_t * clientP,
+                                                 uint16_t id,
+                                                 lwm2m_client_store_t * storeP)
+{
+    (void)storeP;
+
+    return (lwm2m_observation_t *)lwm2m_list_find((lwm2m_list_t *)clientP->observationList, id);
+}
+
+static void prv_removeObservation(lwm2m_observation_t * observationP,
+                                  lwm2m_client_store_t * storeP)
+{
+    (void)observationP;
+    (void)storeP;
+}
+
+static void prv_close(lwm2m_client_store_t * storeP)
+{
+    _memory_store_t * memP = (_memory_store_t *)storeP->userData;
+
+    lwm2m_index_clear(&memP->clientIndex);
+    if (memP->names != NULL) lwm2m_free(memP->names);
+    lwm2m_free(memP);
+}
+
+lwm2m_client_store_t * clientstore_new(void)
+{
+    _memory_store_t * memP;
+
+    memP = (_memory_store_t *)lwm2m_malloc(sizeof(_memory_store_t));
+    if (memP == NULL) return NULL;
+    memset(memP, 0, sizeof(_memory_store_t));
+
+    memP->store.addClientFunc = prv_addClient;
+    memP->store.updateClientFunc = prv_updateClient;
+    memP->store.findClientFunc = prv_findClient;
+    memP->store.findNameFunc = prv_findName;
+    memP->store.removeClientFunc = prv_removeClient;
+    memP->store.nextClientFunc = prv_nextClient;
+    memP->store.newIdFunc = prv_newId;
+    memP->store.addObservationFunc = prv_addObservation;
+    memP->store.findObservationFunc = prv_findObservation;
+    memP->store.removeObservationFunc = prv_removeObservation;
+    memP->store.closeFunc = prv_close;
+    memP->store.userData = memP;
+
+    return &memP->store;
+}
+
+int lwm2m_set_client_store(lwm2m_context_t * contextP,
+                           lwm2m_client_store_t * storeP)
+{
+    LOG("Entering");
+    if (contextP->clientStore != NULL)
+    {
+        if (contextP->clientStore->nextClientFunc(NULL, contextP->clientStore) != NULL) return COAP_412_PRECONDITION_FAILED;
+        contextP->clientStore->closeFunc(contextP->clientStore);
+    }
+    contextP->clientStore = storeP;
+
+    return COAP_NO_ERROR;
+}
+
+#endif
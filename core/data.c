@@ -31,10 +31,16 @@ static int prv_textSerialize(lwm2m_data_t * dataP,
     switch (dataP->type)
     {
     case LWM2M_TYPE_STRING:
-        *bufferP = (uint8_t *)lwm2m_malloc(dataP->value.asBuffer.length);
+    {
+        uint8_t * buffer;
+        size_t length;
+
+        buffer = lwm2m_data_get_buffer(dataP, &length);
+        *bufferP = (uint8_t *)lwm2m_malloc(length);
         if (*bufferP == NULL) return 0;
-        memcpy(*bufferP, dataP->value.asBuffer.buffer, dataP->value.asBuffer.length);
-        return (int)dataP->value.asBuffer.length;
+        memcpy(*bufferP, buffer, length);
+        return (int)length;
+    }
 
     case LWM2M_TYPE_INTEGER:
     {
@@ -53,9 +59,9 @@ static int prv_textSerialize(lwm2m_data_t * dataP,
 
     case LWM2M_TYPE_FLOAT:
     {
-        uint8_t floatString[_PRV_STR_LENGTH * 2];
+        uint8_t floatString[FLOAT_MAX_STRING_LEN];
 
-        res = utils_floatToText(dataP->value.asFloat, floatString, _PRV_STR_LENGTH * 2);
+        res = utils_floatToText(dataP->value.asFloat, floatString, FLOAT_MAX_STRING_LEN);
         if (res == 0) return -1;
 
         *bufferP = (uint8_t *)lwm2m_malloc(res);
@@ -100,12 +106,15 @@ static int prv_textSerialize(lwm2m_data_t * dataP,
 
     case LWM2M_TYPE_OPAQUE:
     {
+        uint8_t * buffer;
+        size_t bufferLen;
         size_t length;
 
-        length = utils_base64GetSize(dataP->value.asBuffer.length);
+        buffer = lwm2m_data_get_buffer(dataP, &bufferLen);
+        length = utils_base64GetSize(bufferLen);
         *bufferP = (uint8_t *)lwm2m_malloc(length);
         if (*bufferP == NULL) return 0;
-        length = utils_base64Encode(dataP->value.asBuffer.buffer, dataP->value.asBuffer.length, *bufferP, length);
+        length = utils_base64Encode(buffer, bufferLen, *bufferP, length);
         if (length == 0)
         {
             lwm2m_free(*bufferP);
@@ -121,19 +130,55 @@ static int prv_textSerialize(lwm2m_data_t * dataP,
     }
 }
 
+int data_copyBuffer(lwm2m_data_t * dataP,
+                    uint8_t * buffer,
+                    size_t bufferLen)
+{
+    uint8_t * copyP;
+
+    copyP = NULL;
+    if (bufferLen != 0)
+    {
+        copyP = (uint8_t *)lwm2m_malloc(bufferLen);
+        if (copyP == NULL)
+        {
+            return 0;
+        }
+        // buffer may be the inline value of dataP
+        memcpy(copyP, buffer, bufferLen);
+    }
+    dataP->flags &= ~(LWM2M_DATA_FLAG_BORROWED | LWM2M_DATA_FLAG_INLINE);
+    dataP->value.asBuffer.length = bufferLen;
+    dataP->value.asBuffer.buffer = copyP;
+
+    return 1;
+}
+
 static int prv_setBuffer(lwm2m_data_t * dataP,
                          uint8_t * buffer,
                          size_t bufferLen)
 {
-    dataP->value.asBuffer.buffer = (uint8_t *)lwm2m_malloc(bufferLen);
-    if (dataP->value.asBuffer.buffer == NULL)
+#ifndef LWM2M_DATA_NO_INLINE
+    if (bufferLen <= LWM2M_DATA_INLINE_SIZE)
     {
-        return 0;
+        // buffer may already be the inline value
+        memmove(dataP->value.asInline.buffer, buffer, bufferLen);
+        dataP->value.asInline.length = (uint8_t)bufferLen;
+        dataP->flags = (dataP->flags & ~LWM2M_DATA_FLAG_BORROWED) | LWM2M_DATA_FLAG_INLINE;
+        return 1;
     }
-    dataP->value.asBuffer.length = bufferLen;
-    memcpy(dataP->value.asBuffer.buffer, buffer, bufferLen);
+#endif
 
-    return 1;
+    return data_copyBuffer(dataP, buffer, bufferLen);
+}
+
+static void prv_setBorrowed(lwm2m_data_t * dataP,
+                            uint8_t * buffer,
+                            size_t bufferLen)
+{
+    dataP->flags = (dataP->flags & ~LWM2M_DATA_FLAG_INLINE) | LWM2M_DATA_FLAG_BORROWED;
+    dataP->value.asBuffer.length = bufferLen;
+    dataP->value.asBuffer.buffer = (bufferLen == 0) ? NULL : buffer;
 }
 
 lwm2m_data_t * lwm2m_data_new(int size)
@@ -168,12 +213,16 @@ void lwm2m_data_free(int size,
         case LWM2M_TYPE_MULTIPLE_RESOURCE:
         case LWM2M_TYPE_OBJECT_INSTANCE:
         case LWM2M_TYPE_OBJECT:
-            lwm2m_data_free(dataP[i].value.asChildren.count, dataP[i].value.asChildren.array);
+            if ((dataP[i].flags & LWM2M_DATA_FLAG_BORROWED) == 0)
+            {
+                lwm2m_data_free(dataP[i].value.asChildren.count, dataP[i].value.asChildren.array);
+            }
             break;
 
         case LWM2M_TYPE_STRING:
         case LWM2M_TYPE_OPAQUE:
-            if (dataP[i].value.asBuffer.buffer != NULL)
+            if ((dataP[i].flags & (LWM2M_DATA_FLAG_BORROWED | LWM2M_DATA_FLAG_INLINE)) == 0
+             && dataP[i].value.asBuffer.buffer != NULL)
             {
                 lwm2m_free(dataP[i].value.asBuffer.buffer);
             }
@@ -186,6 +235,20 @@ void lwm2m_data_free(int size,
     lwm2m_free(dataP);
 }
 
+uint8_t * lwm2m_data_get_buffer(const lwm2m_data_t * dataP,
+                                size_t * lengthP)
+{
+#ifndef LWM2M_DATA_NO_INLINE
+    if ((dataP->flags & LWM2M_DATA_FLAG_INLINE) != 0)
+    {
+        *lengthP = dataP->value.asInline.length;
+        return (uint8_t *)dataP->value.asInline.buffer;
+    }
+#endif
+    *lengthP = dataP->value.asBuffer.length;
+    return dataP->value.asBuffer.buffer;
+}
+
 void lwm2m_data_encode_string(const char * string,
                               lwm2m_data_t * dataP)
 {
@@ -204,9 +267,7 @@ void lwm2m_data_encode_string(const char * string,
 
     if (len == 0)
     {
-        dataP->value.asBuffer.length = 0;
-        dataP->value.asBuffer.buffer = NULL;
-        res = 1;
+        res = data_copyBuffer(dataP, NULL, 0);
     }
     else
     {
@@ -232,9 +293,7 @@ void lwm2m_data_encode_opaque(uint8_t * buffer,
     LOG_ARG("length: %d", length);
     if (length == 0)
     {
-        dataP->value.asBuffer.length = 0;
-        dataP->value.asBuffer.buffer = NULL;
-        res = 1;
+        res = data_copyBuffer(dataP, NULL, 0);
     }
     else
     {
@@ -264,6 +323,42 @@ void lwm2m_data_encode_nstring(const char * string,
     }
 }
 
+void lwm2m_data_encode_string_borrowed(const char * string,
+                                       lwm2m_data_t * dataP)
+{
+    size_t len;
+
+    LOG_ARG("\"%s\"", string);
+    if (string == NULL)
+    {
+        len = 0;
+    }
+    else
+    {
+        for (len = 0; string[len] != 0; len++);
+    }
+
+    lwm2m_data_encode_nstring_borrowed(string, len, dataP);
+}
+
+void lwm2m_data_encode_nstring_borrowed(const char * string,
+                                        size_t length,
+                                        lwm2m_data_t * dataP)
+{
+    LOG_ARG("length: %d, string: \"%s\"", length, string);
+    prv_setBorrowed(dataP, (uint8_t *)string, length);
+    dataP->type = LWM2M_TYPE_STRING;
+}
+
+void lwm2m_data_encode_opaque_borrowed(uint8_t * buffer,
+                                       size_t length,
+                                       lwm2m_data_t * dataP)
+{
+    LOG_ARG("length: %d", length);
+    prv_setBorrowed(dataP, buffer, length);
+    dataP->type = LWM2M_TYPE_OPAQUE;
+}
+
 void lwm2m_data_encode_int(int64_t value,
                            lwm2m_data_t * dataP)
 {
@@ -276,6 +371,8 @@ int lwm2m_data_decode_int(const lwm2m_data_t * dataP,
                           int64_t * valueP)
 {
     int result;
+    uint8_t * buffer;
+    size_t length;
 
     LOG("Entering");
     switch (dataP->type)
@@ -286,14 +383,16 @@ int lwm2m_data_decode_int(const lwm2m_data_t * dataP,
         break;
 
     case LWM2M_TYPE_STRING:
-        result = utils_textToInt(dataP->value.asBuffer.buffer, dataP->value.asBuffer.length, valueP);
+        buffer = lwm2m_data_get_buffer(dataP, &length);
+        result = utils_textToInt(buffer, length, valueP);
         break;
 
     case LWM2M_TYPE_OPAQUE:
-        switch (dataP->value.asBuffer.length)
+        buffer = lwm2m_data_get_buffer(dataP, &length);
+        switch (length)
         {
         case 1:
-            *valueP = (int8_t)dataP->value.asBuffer.buffer[0];
+            *valueP = (int8_t)buffer[0];
             result = 1;
             break;
 
@@ -301,7 +400,7 @@ int lwm2m_data_decode_int(const lwm2m_data_t * dataP,
         {
             int16_t value;
 
-            utils_copyValue(&value, dataP->value.asBuffer.buffer, dataP->value.asBuffer.length);
+            utils_copyValue(&value, buffer, length);
 
             *valueP = value;
             result = 1;
@@ -312,7 +411,7 @@ int lwm2m_data_decode_int(const lwm2m_data_t * dataP,
         {
             int32_t value;
 
-            utils_copyValue(&value, dataP->value.asBuffer.buffer, dataP->value.asBuffer.length);
+            utils_copyValue(&value, buffer, length);
 
             *valueP = value;
             result = 1;
@@ -320,7 +419,7 @@ int lwm2m_data_decode_int(const lwm2m_data_t * dataP,
         }
 
         case 8:
-            utils_copyValue(valueP, dataP->value.asBuffer.buffer, dataP->value.asBuffer.length);
+            utils_copyValue(valueP, buffer, length);
             result = 1;
             break;
 
@@ -349,6 +448,8 @@ int lwm2m_data_decode_float(const lwm2m_data_t * dataP,
                             double * valueP)
 {
     int result;
+    uint8_t * buffer;
+    size_t length;
 
     LOG("Entering");
     switch (dataP->type)
@@ -364,17 +465,19 @@ int lwm2m_data_decode_float(const lwm2m_data_t * dataP,
         break;
 
     case LWM2M_TYPE_STRING:
-        result = utils_textToFloat(dataP->value.asBuffer.buffer, dataP->value.asBuffer.length, valueP);
+        buffer = lwm2m_data_get_buffer(dataP, &length);
+        result = utils_textToFloat(buffer, length, valueP);
         break;
 
     case LWM2M_TYPE_OPAQUE:
-        switch (dataP->value.asBuffer.length)
+        buffer = lwm2m_data_get_buffer(dataP, &length);
+        switch (length)
         {
         case 4:
         {
             float temp;
 
-            utils_copyValue(&temp, dataP->value.asBuffer.buffer, dataP->value.asBuffer.length);
+            utils_copyValue(&temp, buffer, length);
 
             *valueP = temp;
             result = 1;
@@ -382,7 +485,7 @@ int lwm2m_data_decode_float(const lwm2m_data_t * dataP,
         break;
 
         case 8:
-            utils_copyValue(valueP, dataP->value.asBuffer.buffer, dataP->value.asBuffer.length);
+            utils_copyValue(valueP, buffer, length);
             result = 1;
             break;
 
@@ -412,6 +515,8 @@ int lwm2m_data_decode_bool(const lwm2m_data_t * dataP,
                            bool * valueP)
 {
     int result;
+    uint8_t * buffer;
+    size_t length;
 
     LOG("Entering");
     switch (dataP->type)
@@ -422,9 +527,10 @@ int lwm2m_data_decode_bool(const lwm2m_data_t * dataP,
         break;
 
     case LWM2M_TYPE_STRING:
-        if (dataP->value.asBuffer.length != 1) return 0;
+        buffer = lwm2m_data_get_buffer(dataP, &length);
+        if (length != 1) return 0;
 
-        switch (dataP->value.asBuffer.buffer[0])
+        switch (buffer[0])
         {
         case '0':
             *valueP = false;
@@ -441,9 +547,10 @@ int lwm2m_data_decode_bool(const lwm2m_data_t * dataP,
         break;
 
     case LWM2M_TYPE_OPAQUE:
-        if (dataP->value.asBuffer.length != 1) return 0;
+        buffer = lwm2m_data_get_buffer(dataP, &length);
+        if (length != 1) return 0;
 
-        switch (dataP->value.asBuffer.buffer[0])
+        switch (buffer[0])
         {
         case 0:
             *valueP = false;
@@ -503,6 +610,7 @@ void lwm2m_data_include(lwm2m_data_t * subDataP,
     default:
         return;
     }
+    dataP->flags &= ~(LWM2M_DATA_FLAG_BORROWED | LWM2M_DATA_FLAG_INLINE);
     dataP->value.asChildren.count = count;
     dataP->value.asChildren.array = subDataP;
 }
@@ -516,15 +624,38 @@ void lwm2m_data_encode_instances(lwm2m_data_t * subDataP,
     dataP->type = LWM2M_TYPE_MULTIPLE_RESOURCE;
 }
 
-int lwm2m_data_parse(lwm2m_uri_t * uriP,
+void lwm2m_data_encode_instances_borrowed(lwm2m_data_t * subDataP,
+                                          size_t count,
+                                          lwm2m_data_t * dataP)
+{
+    LOG_ARG("count: %d", count);
+    lwm2m_data_encode_instances(subDataP, count, dataP);
+    dataP->flags |= LWM2M_DATA_FLAG_BORROWED;
+}
+
+static int prv_setValue(lwm2m_data_t * dataP,
+                        uint8_t * buffer,
+                        size_t bufferLen,
+                        bool isBorrowed)
+{
+    // the values given to the objects are never inline
+    if (!isBorrowed) return data_copyBuffer(dataP, buffer, bufferLen);
+
+    prv_setBorrowed(dataP, buffer, bufferLen);
+
+    return 1;
+}
+
+static int prv_parse(lwm2m_uri_t * uriP,
                      uint8_t * buffer,
                      size_t bufferLen,
                      lwm2m_media_type_t format,
+                     bool isBorrowed,
                      lwm2m_data_t ** dataP)
 {
     int res;
 
-    LOG_ARG("format: %s, bufferLen: %d", STR_MEDIA_TYPE(format), bufferLen);
+    LOG_ARG("format: %s, bufferLen: %d, isBorrowed: %s", STR_MEDIA_TYPE(format), bufferLen, isBorrowed?"true":"false");
     LOG_URI(uriP);
     switch (format)
     {
@@ -534,7 +665,7 @@ int lwm2m_data_parse(lwm2m_uri_t * uriP,
         if (*dataP == NULL) return 0;
         (*dataP)->id = uriP->resourceId;
         (*dataP)->type = LWM2M_TYPE_STRING;
-        res = prv_setBuffer(*dataP, buffer, bufferLen);
+        res = prv_setValue(*dataP, buffer, bufferLen, isBorrowed);
         if (res == 0)
         {
             lwm2m_data_free(1, *dataP);
@@ -548,7 +679,7 @@ int lwm2m_data_parse(lwm2m_uri_t * uriP,
         if (*dataP == NULL) return 0;
         (*dataP)->id = uriP->resourceId;
         (*dataP)->type = LWM2M_TYPE_OPAQUE;
-        res = prv_setBuffer(*dataP, buffer, bufferLen);
+        res = prv_setValue(*dataP, buffer, bufferLen, isBorrowed);
         if (res == 0)
         {
             lwm2m_data_free(1, *dataP);
@@ -560,33 +691,56 @@ int lwm2m_data_parse(lwm2m_uri_t * uriP,
     case LWM2M_CONTENT_TLV_OLD:
 #endif
     case LWM2M_CONTENT_TLV:
-        return tlv_parse(buffer, bufferLen, dataP);
+        return tlv_parse(buffer, bufferLen, isBorrowed, dataP);
 
 #ifdef LWM2M_SUPPORT_JSON
 #ifdef LWM2M_OLD_CONTENT_FORMAT_SUPPORT
     case LWM2M_CONTENT_JSON_OLD:
 #endif
     case LWM2M_CONTENT_JSON:
+        // JSON values are unescaped or decoded so they are always copied
         return json_parse(uriP, buffer, bufferLen, dataP);
 #endif
 
+#ifdef LWM2M_SUPPORT_CBOR
+    case LWM2M_CONTENT_CBOR:
+        return cbor_parse(uriP, buffer, bufferLen, isBorrowed, dataP);
+
+    case LWM2M_CONTENT_SENML_CBOR:
+        return senml_cbor_parse(uriP, buffer, bufferLen, isBorrowed, dataP);
+#endif
+
     default:
         return 0;
     }
 }
 
-int lwm2m_data_serialize(lwm2m_uri_t * uriP,
-                         int size,
-                         lwm2m_data_t * dataP,
-                         lwm2m_media_type_t * formatP,
-                         uint8_t ** bufferP)
+int lwm2m_data_parse(lwm2m_uri_t * uriP,
+                     uint8_t * buffer,
+                     size_t bufferLen,
+                     lwm2m_media_type_t format,
+                     lwm2m_data_t ** dataP)
 {
-    LOG_URI(uriP);
-    LOG_ARG("size: %d, formatP: %s", size, STR_MEDIA_TYPE(*formatP));
+    return prv_parse(uriP, buffer, bufferLen, format, false, dataP);
+}
+
+int lwm2m_data_parse_borrowed(lwm2m_uri_t * uriP,
+                              uint8_t * buffer,
+                              size_t bufferLen,
+                              lwm2m_media_type_t format,
+                              lwm2m_data_t ** dataP)
+{
+    return prv_parse(uriP, buffer, bufferLen, format, true, dataP);
+}
 
-    // Check format
+static int prv_checkFormat(lwm2m_uri_t * uriP,
+                           int size,
+                           lwm2m_data_t * dataP,
+                           lwm2m_media_type_t * formatP)
+{
     if (*formatP == LWM2M_CONTENT_TEXT
-     || *formatP == LWM2M_CONTENT_OPAQUE)
+     || *formatP == LWM2M_CONTENT_OPAQUE
+     || *formatP == LWM2M_CONTENT_CBOR)
     {
         if (size != 1
          || (uriP != NULL && !LWM2M_URI_IS_SET_RESOURCE(uriP))
@@ -594,6 +748,13 @@ int lwm2m_data_serialize(lwm2m_uri_t * uriP,
          || dataP->type == LWM2M_TYPE_OBJECT_INSTANCE
          || dataP->type == LWM2M_TYPE_MULTIPLE_RESOURCE)
         {
+#ifdef LWM2M_SUPPORT_CBOR
+            if (*formatP == LWM2M_CONTENT_CBOR)
+            {
+                *formatP = LWM2M_CONTENT_SENML_CBOR;
+            }
+            else
+#endif
 #ifdef LWM2M_SUPPORT_JSON
             *formatP = LWM2M_CONTENT_JSON;
 #else
@@ -611,46 +772,218 @@ int lwm2m_data_serialize(lwm2m_uri_t * uriP,
 
     LOG_ARG("Final format: %s", STR_MEDIA_TYPE(*formatP));
 
+    return 0;
+}
+
+static bool prv_isResourceInstance(lwm2m_uri_t * uriP,
+                                   int size,
+                                   lwm2m_data_t * dataP)
+{
+    return (uriP != NULL && LWM2M_URI_IS_SET_RESOURCE(uriP)
+         && (size != 1 || dataP->id != uriP->resourceId));
+}
+
+int lwm2m_data_serialize(lwm2m_uri_t * uriP,
+                         int size,
+                         lwm2m_data_t * dataP,
+                         lwm2m_media_type_t * formatP,
+                         uint8_t ** bufferP)
+{
+    LOG_URI(uriP);
+    LOG_ARG("size: %d, formatP: %s", size, STR_MEDIA_TYPE(*formatP));
+
+    if (prv_checkFormat(uriP, size, dataP, formatP) != 0) return -1;
+
     switch (*formatP)
     {
     case LWM2M_CONTENT_TEXT:
         return prv_textSerialize(dataP, bufferP);
 
     case LWM2M_CONTENT_OPAQUE:
-        *bufferP = (uint8_t *)lwm2m_malloc(dataP->value.asBuffer.length);
+    {
+        uint8_t * buffer;
+        size_t length;
+
+        buffer = lwm2m_data_get_buffer(dataP, &length);
+        *bufferP = (uint8_t *)lwm2m_malloc(length);
         if (*bufferP == NULL) return -1;
-        memcpy(*bufferP, dataP->value.asBuffer.buffer, dataP->value.asBuffer.length);
-        return (int)dataP->value.asBuffer.length;
+        memcpy(*bufferP, buffer, length);
+        return (int)length;
+    }
 
     case LWM2M_CONTENT_TLV:
     case LWM2M_CONTENT_TLV_OLD:
-    {
-            bool isResourceInstance;
-
-            if (uriP != NULL && LWM2M_URI_IS_SET_RESOURCE(uriP)
-             && (size != 1 || dataP->id != uriP->resourceId))
-            {
-                isResourceInstance = true;
-            }
-            else
-            {
-                isResourceInstance = false;
-            }
-            return tlv_serialize(isResourceInstance, size, dataP, bufferP);
-        }
+        return tlv_serialize(prv_isResourceInstance(uriP, size, dataP), size, dataP, bufferP);
 
 #ifdef LWM2M_CLIENT_MODE
     case LWM2M_CONTENT_LINK:
-        return discover_serialize(NULL, uriP, NULL, size, dataP, bufferP);
+        return discover_serialize(uriP, NULL, size, dataP, bufferP);
 #endif
 #ifdef LWM2M_SUPPORT_JSON
     case LWM2M_CONTENT_JSON:
     case LWM2M_CONTENT_JSON_OLD:
         return json_serialize(uriP, size, dataP, bufferP);
 #endif
+#ifdef LWM2M_SUPPORT_CBOR
+    case LWM2M_CONTENT_CBOR:
+    case LWM2M_CONTENT_SENML_CBOR:
+    {
+        utils_buffer_t payload;
+        int res;
+
+        utils_bufferInit(&payload, NULL, 0);
+        if (*formatP == LWM2M_CONTENT_CBOR)
+        {
+            res = cbor_serialize(size, dataP, &payload);
+        }
+        else
+        {
+            res = senml_cbor_serialize(uriP, size, dataP, &payload);
+        }
+        if (res <= 0)
+        {
+            utils_bufferFree(&payload);
+            return -1;
+        }
+        // the buffer becomes the payload as is
+        *bufferP = payload.data;
+        return res;
+    }
+#endif
 
     default:
         return -1;
     }
 }
 
+
+int lwm2m_data_serialize_into(lwm2m_uri_t * uriP,
+                              int size,
+                              lwm2m_data_t * dataP,
+                              lwm2m_media_type_t * formatP,
+                              uint8_t * buffer,
+                              size_t bufferLen)
+{
+    uint8_t * tmpBuffer;
+    int length;
+
+    LOG_URI(uriP);
+    LOG_ARG("size: %d, formatP: %s, bufferLen: %d", size, STR_MEDIA_TYPE(*formatP), bufferLen);
+
+    if (prv_checkFormat(uriP, size, dataP, formatP) != 0) return -1;
+
+    switch (*formatP)
+    {
+    case LWM2M_CONTENT_TLV:
+    case LWM2M_CONTENT_TLV_OLD:
+    {
+        utils_buffer_t payload;
+
+        // written in place, fails instead of growing when bufferLen is too small
+        utils_bufferInit(&payload, buffer, bufferLen);
+        return tlv_serializeBuffer(prv_isResourceInstance(uriP, size, dataP), size, dataP, &payload);
+    }
+
+#ifdef LWM2M_SUPPORT_JSON
+    case LWM2M_CONTENT_JSON:
+    case LWM2M_CONTENT_JSON_OLD:
+    {
+        size_t totalLength;
+
+        length = json_serializeBlock(uriP, size, dataP, 0, buffer, bufferLen, &totalLength);
+        if (length < 0 || totalLength > bufferLen) return -1;
+        return length;
+    }
+#endif
+
+#ifdef LWM2M_SUPPORT_CBOR
+    case LWM2M_CONTENT_CBOR:
+    case LWM2M_CONTENT_SENML_CBOR:
+    {
+        utils_buffer_t payload;
+
+        // written in place, fails instead of growing when bufferLen is too small
+        utils_bufferInit(&payload, buffer, bufferLen);
+        if (*formatP == LWM2M_CONTENT_CBOR)
+        {
+            return cbor_serialize(size, dataP, &payload);
+        }
+        return senml_cbor_serialize(uriP, size, dataP, &payload);
+    }
+#endif
+
+#ifdef LWM2M_CLIENT_MODE
+    case LWM2M_CONTENT_LINK:
+    {
+        utils_buffer_t payload;
+
+        // written in place, fails instead of growing when bufferLen is too small
+        utils_bufferInit(&payload, buffer, bufferLen);
+        return discover_serializeBuffer(uriP, NULL, size, dataP, &payload);
+    }
+#endif
+
+    default:
+        break;
+    }
+
+    length = lwm2m_data_serialize(uriP, size, dataP, formatP, &tmpBuffer);
+    if (length <= 0) return length;
+
+    if ((size_t)length > bufferLen)
+    {
+        length = -1;
+    }
+    else
+    {
+        memcpy(buffer, tmpBuffer, length);
+    }
+    lwm2m_free(tmpBuffer);
+
+    return length;
+}
+
+int lwm2m_data_serialize_block(lwm2m_uri_t * uriP,
+                               int size,
+                               lwm2m_data_t * dataP,
+                               lwm2m_media_type_t * formatP,
+                               size_t offset,
+                               uint8_t * buffer,
+                               size_t bufferLen,
+                               size_t * lengthP)
+{
+    uint8_t * tmpBuffer;
+    int length;
+
+    LOG_URI(uriP);
+    LOG_ARG("size: %d, formatP: %s, offset: %d, bufferLen: %d", size, STR_MEDIA_TYPE(*formatP), offset, bufferLen);
+
+    if (prv_checkFormat(uriP, size, dataP, formatP) != 0) return -1;
+
+#ifdef LWM2M_SUPPORT_JSON
+    if (*formatP == LWM2M_CONTENT_JSON
+     || *formatP == LWM2M_CONTENT_JSON_OLD)
+    {
+        // only the requested chunk is written
+        return json_serializeBlock(uriP, size, dataP, offset, buffer, bufferLen, lengthP);
+    }
+#endif
+
+    length = lwm2m_data_serialize(uriP, size, dataP, formatP, &tmpBuffer);
+    if (length < 0) return -1;
+
+    *lengthP = (size_t)length;
+    if (offset >= (size_t)length)
+    {
+        length = 0;
+    }
+    else
+    {
+        length -= offset;
+        if ((size_t)length > bufferLen) length = bufferLen;
+        memcpy(buffer, tmpBuffer + offset, length);
+    }
+    lwm2m_free(tmpBuffer);
+
+    return length;
+}
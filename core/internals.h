@@ -99,9 +99,11 @@
 ((M) == LWM2M_CONTENT_TEXT ? "LWM2M_CONTENT_TEXT" :      \
 ((M) == LWM2M_CONTENT_LINK ? "LWM2M_CONTENT_LINK" :      \
 ((M) == LWM2M_CONTENT_OPAQUE ? "LWM2M_CONTENT_OPAQUE" :  \
+((M) == LWM2M_CONTENT_CBOR ? "LWM2M_CONTENT_CBOR" :      \
+((M) == LWM2M_CONTENT_SENML_CBOR ? "LWM2M_CONTENT_SENML_CBOR" : \
 ((M) == LWM2M_CONTENT_TLV ? "LWM2M_CONTENT_TLV" :        \
 ((M) == LWM2M_CONTENT_JSON ? "LWM2M_CONTENT_JSON" :      \
-"Unknown")))))
+"Unknown")))))))
 #define STR_STATE(S)                                \
 ((S) == STATE_INITIAL ? "STATE_INITIAL" :      \
 ((S) == STATE_BOOTSTRAP_REQUIRED ? "STATE_BOOTSTRAP_REQUIRED" :      \
@@ -118,9 +120,41 @@
 
 #define LWM2M_DEFAULT_LIFETIME  86400
 
-#ifdef LWM2M_SUPPORT_JSON
+// Server side queue of requests to clients in queue mode
+#ifndef LWM2M_QUEUE_MAX_SIZE
+#define LWM2M_QUEUE_MAX_SIZE    16      // maximum number of queued requests per client
+#endif
+#ifndef LWM2M_QUEUE_TTL
+#define LWM2M_QUEUE_TTL         LWM2M_DEFAULT_LIFETIME  // in seconds
+#endif
+#ifndef LWM2M_QUEUE_NSTART
+#define LWM2M_QUEUE_NSTART      1       // outstanding requests when draining, see RFC 7252 section 4.7
+#endif
+
+// Bootstrap Server side pipelining of the bootstrap commands
+#ifndef LWM2M_BOOTSTRAP_WINDOW
+#define LWM2M_BOOTSTRAP_WINDOW  4       // outstanding commands per client, 1 to send them one by one
+#endif
+
+// Client side persistent journal of the objects
+#ifndef LWM2M_JOURNAL_COMPACTION_MIN
+#define LWM2M_JOURNAL_COMPACTION_MIN    16  // obsolete records kept in the log before it is rewritten
+#endif
+
+// Server side persistent registration store
+#ifndef LWM2M_STORE_COMPACTION_MIN
+#define LWM2M_STORE_COMPACTION_MIN  64  // obsolete records kept in the log before it is rewritten
+#endif
+
+#if defined(LWM2M_SUPPORT_JSON) && defined(LWM2M_SUPPORT_CBOR)
+#define REG_LWM2M_RESOURCE_TYPE     ">;rt=\"oma.lwm2m\";ct=\"112 11543\","
+#define REG_LWM2M_RESOURCE_TYPE_LEN 32
+#elif defined(LWM2M_SUPPORT_JSON)
 #define REG_LWM2M_RESOURCE_TYPE     ">;rt=\"oma.lwm2m\";ct=11543,"
-#define REG_LWM2M_RESOURCE_TYPE_LEN 25
+#define REG_LWM2M_RESOURCE_TYPE_LEN 26
+#elif defined(LWM2M_SUPPORT_CBOR)
+#define REG_LWM2M_RESOURCE_TYPE     ">;rt=\"oma.lwm2m\";ct=112,"
+#define REG_LWM2M_RESOURCE_TYPE_LEN 24
 #else
 #define REG_LWM2M_RESOURCE_TYPE     ">;rt=\"oma.lwm2m\","
 #define REG_LWM2M_RESOURCE_TYPE_LEN 17
@@ -128,7 +162,6 @@
 #define REG_START           "<"
 #define REG_DEFAULT_PATH    "/"
 
-#define REG_OBJECT_MIN_LEN  5   // "</n>,"
 #define REG_PATH_END        ">,"
 #define REG_PATH_SEPARATOR  "/"
 
@@ -139,6 +172,8 @@
 #define URI_REGISTRATION_SEGMENT_LEN    2
 #define URI_BOOTSTRAP_SEGMENT           "bs"
 #define URI_BOOTSTRAP_SEGMENT_LEN       2
+#define URI_SEND_SEGMENT                "dp"
+#define URI_SEND_SEGMENT_LEN            2
 
 #define QUERY_STARTER       "?"
 #define QUERY_NAME          "ep="
@@ -174,6 +209,8 @@
 #define REG_ATTR_CONTENT_KEY_LEN    2
 #define REG_ATTR_CONTENT_JSON       "11543"   // Temporary value
 #define REG_ATTR_CONTENT_JSON_LEN   5
+#define REG_ATTR_CONTENT_SENML_CBOR     "112"
+#define REG_ATTR_CONTENT_SENML_CBOR_LEN 3
 
 #define ATTR_SERVER_ID_STR       "ep="
 #define ATTR_SERVER_ID_LEN       3
@@ -191,18 +228,19 @@
 #define ATTR_DIMENSION_LEN       4
 
 #define URI_MAX_STRING_LEN    18      // /65535/65535/65535
+#define FLOAT_MAX_STRING_LEN  25      // -0.00000 followed by 17 digits
 #define _PRV_64BIT_BUFFER_SIZE 8
 
 #define LINK_ITEM_START             "<"
 #define LINK_ITEM_START_SIZE        1
-#define LINK_ITEM_END               ">,"
-#define LINK_ITEM_END_SIZE          2
 #define LINK_ITEM_DIM_START         ">;dim="
 #define LINK_ITEM_DIM_START_SIZE    6
 #define LINK_ITEM_ATTR_END          ","
 #define LINK_ITEM_ATTR_END_SIZE     1
 #define LINK_URI_SEPARATOR          "/"
 #define LINK_URI_SEPARATOR_SIZE     1
+#define LINK_URI_END                ">"
+#define LINK_URI_END_SIZE           1
 #define LINK_ATTR_SEPARATOR         ";"
 #define LINK_ATTR_SEPARATOR_SIZE    1
 
@@ -211,6 +249,7 @@
 #define LWM2M_URI_FLAG_DM           (uint8_t)0x00
 #define LWM2M_URI_FLAG_DELETE_ALL   (uint8_t)0x10
 #define LWM2M_URI_FLAG_REGISTRATION (uint8_t)0x20
+#define LWM2M_URI_FLAG_SEND         (uint8_t)0x30
 #define LWM2M_URI_FLAG_BOOTSTRAP    (uint8_t)0x40
 
 #define LWM2M_URI_MASK_TYPE (uint8_t)0x70
@@ -232,6 +271,37 @@ typedef enum
     URI_DEPTH_RESOURCE_INSTANCE
 } uri_depth_t;
 
+// Output buffer growing as data is appended. The memory is allocated with lwm2m_malloc() and can be
+// handed over to the caller. When isStatic is true, the memory belongs to the caller and can not grow.
+typedef struct
+{
+    uint8_t * data;
+    size_t    length;
+    size_t    capacity;
+    bool      isStatic;
+} utils_buffer_t;
+
+#define SENML_MAX_DEPTH     4   // object, instance, resource and resource instance
+
+// Data tree built from the records of a JSON or SenML CBOR payload. The root children are the
+// objects. pathP holds the nodes of the last inserted record and capacity the size of the children
+// arrays on that path.
+typedef struct
+{
+    lwm2m_data_t   root;
+    lwm2m_data_t * pathP[SENML_MAX_DEPTH + 1];
+    size_t         capacity[SENML_MAX_DEPTH];
+    int            pathDepth;
+} senml_tree_t;
+
+// Values read at a URI. A composite payload holds the records of several of them.
+typedef struct
+{
+    lwm2m_uri_t *  uriP;
+    int            size;
+    lwm2m_data_t * dataP;
+} senml_part_t;
+
 #ifdef LWM2M_BOOTSTRAP_SERVER_MODE
 typedef struct
 {
@@ -239,6 +309,7 @@ typedef struct
     lwm2m_uri_t uri;
     lwm2m_bootstrap_callback_t callback;
     void *      userData;
+    lwm2m_context_t * contextP;
 } bs_data_t;
 #endif
 
@@ -248,17 +319,27 @@ int uri_getNumber(uint8_t * uriString, size_t uriLength);
 int uri_toString(lwm2m_uri_t * uriP, uint8_t * buffer, size_t bufferLen, uri_depth_t * depthP);
 
 // defined in objects.c
+lwm2m_object_t * object_find(lwm2m_context_t * contextP, uint16_t objectId);
+lwm2m_list_t * object_findInstance(lwm2m_object_t * objectP, uint16_t instanceId);
+uint16_t object_newInstanceId(lwm2m_object_t * objectP);
 uint8_t object_readData(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, int * sizeP, lwm2m_data_t ** dataP);
 uint8_t object_read(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_media_type_t * formatP, uint8_t ** bufferP, size_t * lengthP);
+uint8_t object_readBlock(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_media_type_t * formatP, size_t offset, size_t blockSize, uint8_t ** bufferP, size_t * lengthP, size_t * totalLengthP);
 uint8_t object_write(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_media_type_t format, uint8_t * buffer, size_t length);
 uint8_t object_create(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_media_type_t format, uint8_t * buffer, size_t length);
+#ifdef LWM2M_SUPPORT_CBOR
+uint8_t object_readComposite(lwm2m_context_t * contextP, int count, lwm2m_uri_t * urisP, lwm2m_media_type_t * formatP, uint8_t ** bufferP, size_t * lengthP);
+uint8_t object_writeComposite(lwm2m_context_t * contextP, lwm2m_server_t * serverP, lwm2m_media_type_t format, uint8_t * buffer, size_t length);
+#endif
 uint8_t object_execute(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, uint8_t * buffer, size_t length);
 uint8_t object_delete(lwm2m_context_t * contextP, lwm2m_uri_t * uriP);
 uint8_t object_discover(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_server_t * serverP, uint8_t ** bufferP, size_t * lengthP);
 uint8_t object_checkReadable(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_attributes_t * attrP);
 bool object_isInstanceNew(lwm2m_context_t * contextP, uint16_t objectId, uint16_t instanceId);
-int object_getRegisterPayloadBufferLength(lwm2m_context_t * contextP);
-int object_getRegisterPayload(lwm2m_context_t * contextP, uint8_t * buffer, size_t length);
+int object_getRegisterPayload(lwm2m_context_t * contextP, uint8_t ** bufferP);
+int object_getRegisterPayloadCache(lwm2m_context_t * contextP, uint8_t ** bufferP);
+void object_invalidateRegisterPayload(lwm2m_context_t * contextP);
+void object_freeRegisterPayload(lwm2m_context_t * contextP);
 int object_getServers(lwm2m_context_t * contextP, bool checkOnly);
 uint8_t object_createInstance(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_data_t * dataP);
 uint8_t object_writeInstance(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_data_t * dataP);
@@ -266,14 +347,94 @@ uint8_t object_writeInstance(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm
 // defined in transaction.c
 lwm2m_transaction_t * transaction_new(void * sessionH, coap_method_t method, char * altPath, lwm2m_uri_t * uriP, uint16_t mID, uint8_t token_len, uint8_t* token);
 int transaction_send(lwm2m_context_t * contextP, lwm2m_transaction_t * transacP);
+int transaction_serialize(lwm2m_transaction_t * transacP);
 void transaction_free(lwm2m_transaction_t * transacP);
 void transaction_remove(lwm2m_context_t * contextP, lwm2m_transaction_t * transacP);
 void transaction_remove_all(lwm2m_context_t * contextP, void * sessionH);
 bool transaction_handleResponse(lwm2m_context_t * contextP, void * fromSessionH, coap_packet_t * message, coap_packet_t * response);
 void transaction_step(lwm2m_context_t * contextP, time_t currentTime, time_t * timeoutP);
+void transaction_complete(lwm2m_transaction_t * transacP, void * message);
+
+#ifdef LWM2M_SERVER_MODE
+// defined in queue.c
+int queue_add(lwm2m_context_t * contextP, lwm2m_client_t * clientP, lwm2m_transaction_t * transacP);
+void queue_wake(lwm2m_context_t * contextP, lwm2m_client_t * clientP);
+void queue_step(lwm2m_context_t * contextP, lwm2m_client_t * clientP, time_t currentTime, time_t * timeoutP);
+void queue_free(lwm2m_client_t * clientP);
+#endif
+
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_OBJECT_JOURNAL)
+// defined in journal.c
+void journal_save(lwm2m_context_t * contextP, uint16_t objectId, uint16_t instanceId);
+void journal_commit(lwm2m_context_t * contextP);
+void journal_rollback(lwm2m_context_t * contextP);
+void journal_free(lwm2m_context_t * contextP);
+#endif
+
+#ifdef LWM2M_SERVER_MODE
+// defined in clientstore.c
+lwm2m_client_store_t * clientstore_new(void);
+#endif
+
+#if defined(LWM2M_SERVER_MODE) && defined(LWM2M_REGISTRATION_STORE)
+// defined in store.c
+lwm2m_client_store_t * store_open(lwm2m_context_t * contextP);
+#endif
 
 // defined in management.c
 uint8_t dm_handleRequest(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_server_t * serverP, coap_packet_t * message, coap_packet_t * response);
+#ifdef LWM2M_SUPPORT_CBOR
+uint8_t dm_handleCompositeRequest(lwm2m_context_t * contextP, lwm2m_server_t * serverP, coap_packet_t * message, coap_packet_t * response);
+#endif
+
+#ifdef LWM2M_CLIENT_MODE
+// defined in acl.c
+#define ACL_RIGHT_READ      0x01
+#define ACL_RIGHT_WRITE     0x02
+#define ACL_RIGHT_EXECUTE   0x04
+#define ACL_RIGHT_DELETE    0x08
+#define ACL_RIGHT_CREATE    0x10
+#define ACL_RIGHT_ALL       0x1F
+
+typedef struct
+{
+    uint32_t key;       // object ID << 16 | instance ID
+    uint8_t  rights;
+} acl_entry_t;
+
+typedef struct _lwm2m_acl_cache_
+{
+    acl_entry_t * entries;  // open addressing hash table
+    size_t        mask;     // capacity - 1, the capacity being a power of two
+} lwm2m_acl_cache_t;
+
+uint8_t acl_checkAccess(lwm2m_context_t * contextP, lwm2m_server_t * serverP, lwm2m_uri_t * uriP, uint8_t rights);
+uint8_t acl_createInstance(lwm2m_context_t * contextP, lwm2m_server_t * serverP, lwm2m_uri_t * uriP);
+void acl_invalidate(lwm2m_context_t * contextP);
+void acl_free(lwm2m_server_t * serverP);
+#endif
+
+#ifdef LWM2M_CLIENT_MODE
+// defined in attributes.c
+typedef struct
+{
+    uint64_t           key;     // object, instance and resource IDs
+    lwm2m_attributes_t attributes;
+} attribute_entry_t;
+
+typedef struct _lwm2m_attribute_store_
+{
+    attribute_entry_t * entries;    // sorted by key
+    size_t              count;
+    size_t              capacity;
+} lwm2m_attribute_store_t;
+
+lwm2m_attributes_t * attributes_find(lwm2m_server_t * serverP, lwm2m_uri_t * uriP);
+bool attributes_resolve(lwm2m_server_t * serverP, lwm2m_uri_t * uriP, lwm2m_attributes_t * attrP);
+uint8_t attributes_set(lwm2m_server_t * serverP, lwm2m_uri_t * uriP, lwm2m_attributes_t * attrP);
+void attributes_remove(lwm2m_context_t * contextP, lwm2m_uri_t * uriP);
+void attributes_free(lwm2m_server_t * serverP);
+#endif
 
 // defined in observe.c
 uint8_t observe_handleRequest(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_server_t * serverP, int size, lwm2m_data_t * dataP, coap_packet_t * message, coap_packet_t * response);
@@ -283,7 +444,9 @@ void observe_step(lwm2m_context_t * contextP, time_t currentTime, time_t * timeo
 void observe_clear(lwm2m_context_t * contextP, lwm2m_uri_t * uriP);
 bool observe_handleNotify(lwm2m_context_t * contextP, void * fromSessionH, coap_packet_t * message, coap_packet_t * response);
 void observe_remove(lwm2m_observation_t * observationP);
-lwm2m_observed_t * observe_findByUri(lwm2m_context_t * contextP, lwm2m_uri_t * uriP);
+#if defined(LWM2M_SERVER_MODE) && defined(LWM2M_REGISTRATION_STORE)
+int observe_restore(lwm2m_context_t * contextP, lwm2m_client_t * clientP, uint16_t id, lwm2m_uri_t * uriP, lwm2m_result_callback_t callback, void * userData);
+#endif
 
 // defined in registration.c
 uint8_t registration_handleRequest(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, void * fromSessionH, coap_packet_t * message, coap_packet_t * response);
@@ -292,6 +455,15 @@ void registration_freeClient(lwm2m_context_t * contextP, lwm2m_client_t * client
 uint8_t registration_start(lwm2m_context_t * contextP);
 void registration_step(lwm2m_context_t * contextP, time_t currentTime, time_t * timeoutP);
 lwm2m_status_t registration_getStatus(lwm2m_context_t * contextP);
+bool registration_isRegistered(lwm2m_server_t * serverP);
+#ifdef LWM2M_SERVER_MODE
+lwm2m_client_t * registration_restoreClient(lwm2m_context_t * contextP, uint16_t internalID, lwm2m_client_object_t * objects, size_t objectCount, uint8_t * name, size_t nameLength, uint8_t * msisdn, size_t msisdnLength, uint8_t * type, size_t typeLength, uint8_t * altPath, size_t altPathLength);
+#endif
+
+#ifdef LWM2M_SERVER_MODE
+// defined in send.c
+uint8_t send_handleRequest(lwm2m_context_t * contextP, void * fromSessionH, coap_packet_t * message);
+#endif
 
 // defined in packet.c
 uint8_t message_send(lwm2m_context_t * contextP, coap_packet_t * message, void * sessionH);
@@ -304,19 +476,56 @@ uint8_t bootstrap_handleFinish(lwm2m_context_t * context, void * fromSessionH);
 uint8_t bootstrap_handleRequest(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, void * fromSessionH, coap_packet_t * message, coap_packet_t * response);
 void bootstrap_start(lwm2m_context_t * contextP);
 lwm2m_status_t bootstrap_getStatus(lwm2m_context_t * contextP);
+void bootstrap_free(lwm2m_context_t * contextP);
+
+// defined in data.c
+// Copies the string or opaque value in a new buffer, never inline
+int data_copyBuffer(lwm2m_data_t * dataP, uint8_t * buffer, size_t bufferLen);
 
 // defined in tlv.c
-int tlv_parse(uint8_t * buffer, size_t bufferLen, lwm2m_data_t ** dataP);
+int tlv_parse(uint8_t * buffer, size_t bufferLen, bool isBorrowed, lwm2m_data_t ** dataP);
 int tlv_serialize(bool isResourceInstance, int size, lwm2m_data_t * dataP, uint8_t ** bufferP);
+int tlv_serializeBuffer(bool isResourceInstance, int size, lwm2m_data_t * dataP, utils_buffer_t * bufferP);
 
 // defined in json.c
 #ifdef LWM2M_SUPPORT_JSON
 int json_parse(lwm2m_uri_t * uriP, uint8_t * buffer, size_t bufferLen, lwm2m_data_t ** dataP);
 int json_serialize(lwm2m_uri_t * uriP, int size, lwm2m_data_t * tlvP, uint8_t ** bufferP);
+int json_serializeBlock(lwm2m_uri_t * uriP, int size, lwm2m_data_t * tlvP, size_t offset, uint8_t * buffer, size_t bufferLen, size_t * lengthP);
+#endif
+
+// defined in cbor.c
+#ifdef LWM2M_SUPPORT_CBOR
+int cbor_parse(lwm2m_uri_t * uriP, uint8_t * buffer, size_t bufferLen, bool isBorrowed, lwm2m_data_t ** dataP);
+int cbor_serialize(int size, lwm2m_data_t * dataP, utils_buffer_t * bufferP);
+int senml_cbor_parse(lwm2m_uri_t * uriP, uint8_t * buffer, size_t bufferLen, bool isBorrowed, lwm2m_data_t ** dataP);
+int senml_cbor_serialize(lwm2m_uri_t * uriP, int size, lwm2m_data_t * dataP, utils_buffer_t * bufferP);
+int senml_cbor_serializeParts(int count, senml_part_t * partsP, utils_buffer_t * bufferP);
+int senml_cbor_parseUris(uint8_t * buffer, size_t bufferLen, lwm2m_uri_t ** urisP);
+int senml_cbor_serializeUris(int count, lwm2m_uri_t * urisP, utils_buffer_t * bufferP);
 #endif
 
+// defined in senml.c
+#if defined(LWM2M_SUPPORT_JSON) || defined(LWM2M_SUPPORT_CBOR)
+void senml_treeInit(senml_tree_t * treeP);
+void senml_treeFree(senml_tree_t * treeP);
+int senml_uriToIds(lwm2m_uri_t * uriP, uint16_t * ids);
+bool senml_parseName(const uint8_t * name, size_t length, uint16_t * ids, int * depthP);
+lwm2m_data_t * senml_addRecord(senml_tree_t * treeP, uint16_t * ids, int depth);
+int senml_extractData(senml_tree_t * treeP, lwm2m_uri_t * uriP, lwm2m_data_t ** dataP);
+int senml_findBaseName(lwm2m_uri_t * uriP, int size, lwm2m_data_t * dataP, uint8_t * baseUriStr, int * baseUriLenP, lwm2m_data_t ** targetP);
+#endif
+
+// defined in link.c
+int link_writeUri(utils_buffer_t * bufferP, const uint8_t * parentUriStr, size_t parentUriLen, int32_t id);
+int link_writeIntAttribute(utils_buffer_t * bufferP, const char * name, size_t nameLen, int64_t value);
+int link_writeFloatAttribute(utils_buffer_t * bufferP, const char * name, size_t nameLen, double value);
+int link_writeDelimiter(utils_buffer_t * bufferP);
+int link_finish(utils_buffer_t * bufferP);
+
 // defined in discover.c
-int discover_serialize(lwm2m_context_t * contextP, lwm2m_uri_t * uriP, lwm2m_server_t * serverP, int size, lwm2m_data_t * dataP, uint8_t ** bufferP);
+int discover_serialize(lwm2m_uri_t * uriP, lwm2m_server_t * serverP, int size, lwm2m_data_t * dataP, uint8_t ** bufferP);
+int discover_serializeBuffer(lwm2m_uri_t * uriP, lwm2m_server_t * serverP, int size, lwm2m_data_t * dataP, utils_buffer_t * bufferP);
 
 // defined in block1.c
 uint8_t coap_block1_handler(lwm2m_block1_data_t ** block1Data, uint16_t mid, uint8_t * buffer, size_t length, uint16_t blockSize, uint32_t blockNum, bool blockMore, uint8_t ** outputBuffer, size_t * outputLength);
@@ -335,6 +544,11 @@ int utils_textToFloat(uint8_t * buffer, int length, double * dataP);
 void utils_copyValue(void * dst, const void * src, size_t len);
 size_t utils_base64GetSize(size_t dataLen);
 size_t utils_base64Encode(uint8_t * dataP, size_t dataLen, uint8_t * bufferP, size_t bufferLen);
+uint32_t utils_hash(const uint8_t * buffer, size_t length);
+void utils_bufferInit(utils_buffer_t * bufferP, uint8_t * data, size_t capacity);
+int utils_bufferReserve(utils_buffer_t * bufferP, size_t length);
+int utils_bufferAppend(utils_buffer_t * bufferP, const void * data, size_t length);
+void utils_bufferFree(utils_buffer_t * bufferP);
 #ifdef LWM2M_CLIENT_MODE
 lwm2m_server_t * utils_findServer(lwm2m_context_t * contextP, void * fromSessionH);
 lwm2m_server_t * utils_findBootstrapServer(lwm2m_context_t * contextP, void * fromSessionH);
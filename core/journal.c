@@ -0,0 +1,544 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Persistent journal of the objects of the client, enabled by LWM2M_OBJECT_JOURNAL.
+ * The objects given to lwm2m_restore_objects() have their changes written to an append-only log
+ * provided by the platform: once a write or a create succeeded, a record with the whole content of the
+ * instance as read by the object, and once a delete succeeded, a record with the IDs of the instance.
+ * Only the changed instance is written, without rewriting the other ones.
+ * The log is replayed by lwm2m_restore_objects() and rewritten with only the current instances once it
+ * grew to twice the size of the last rewrite.
+ * The changes made by a bootstrap are not written until it finishes: the whole journaled objects are then
+ * written in place of the log. When the bootstrap fails, the objects are restored from the log.
+ *
+ * Record:
+ *   type (1 byte) | payload length (4 bytes) | payload | hash of the preceding bytes (4 bytes)
+ * Instance record payload:
+ *   object ID (2) | instance ID (2) | resources of the instance in TLV
+ * Delete record payload:
+ *   object ID (2) | instance ID (2)
+ * Integers are big-endian. A truncated or corrupted record ends the replay. The log is checked as a
+ * whole before any instance is changed.
+ */
+
+#include "internals.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_OBJECT_JOURNAL)
+
+#define PRV_RECORD_INSTANCE 1
+#define PRV_RECORD_DELETE   2
+
+#define PRV_HEADER_SIZE     5
+#define PRV_HASH_SIZE       4
+#define PRV_IDS_SIZE        4
+
+typedef struct _lwm2m_journal_
+{
+    uint16_t * objectIds;       // IDs of the journaled objects
+    uint16_t   objectCount;
+    size_t     recordCount;     // number of records in the log
+    size_t     liveCount;       // number of current records at the last rewrite
+    bool       outdated;        // a write failed, the log must be rewritten
+    bool       deferred;        // a bootstrap changed the objects, the log is rewritten when it finishes
+} _journal_t;
+
+static void prv_setU16(uint8_t * buffer,
+                       uint16_t value)
+{
+    buffer[0] = (uint8_t)(value >> 8);
+    buffer[1] = (uint8_t)value;
+}
+
+static void prv_setU32(uint8_t * buffer,
+                       uint32_t value)
+{
+    buffer[0] = (uint8_t)(value >> 24);
+    buffer[1] = (uint8_t)(value >> 16);
+    buffer[2] = (uint8_t)(value >> 8);
+    buffer[3] = (uint8_t)value;
+}
+
+static uint16_t prv_getU16(uint8_t * buffer)
+{
+    return (uint16_t)((buffer[0] << 8) | buffer[1]);
+}
+
+static uint32_t prv_getU32(uint8_t * buffer)
+{
+    return ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) | ((uint32_t)buffer[2] << 8) | buffer[3];
+}
+
+static bool prv_isJournaled(_journal_t * journalP,
+                            uint16_t objectId)
+{
+    uint16_t i;
+
+    for (i = 0 ; i < journalP->objectCount ; i++)
+    {
+        if (journalP->objectIds[i] == objectId) return true;
+    }
+
+    return false;
+}
+
+// Appends a record of the instance: its content if it exists, a delete record otherwise
+static int prv_writeInstance(lwm2m_object_t * objectP,
+                             uint16_t instanceId,
+                             utils_buffer_t * bufferP)
+{
+    uint8_t header[PRV_HEADER_SIZE + PRV_IDS_SIZE];
+    uint8_t hash[PRV_HASH_SIZE];
+    size_t start;
+    size_t length;
+
+    start = bufferP->length;
+    memset(header, 0, sizeof(header));
+    header[0] = PRV_RECORD_DELETE;
+    prv_setU16(header + PRV_HEADER_SIZE, objectP->objID);
+    prv_setU16(header + PRV_HEADER_SIZE + 2, instanceId);
+    if (utils_bufferAppend(bufferP, header, sizeof(header)) != 0) return -1;
+
+    if (NULL != lwm2m_list_find(objectP->instanceList, instanceId))
+    {
+        lwm2m_data_t * dataP = NULL;
+        int size = 0;
+        int result;
+
+        if (objectP->readFunc(instanceId, &size, &dataP, objectP) != COAP_205_CONTENT)
+        {
+            lwm2m_data_free(size, dataP);
+            return -1;
+        }
+        result = tlv_serializeBuffer(false, size, dataP, bufferP);
+        lwm2m_data_free(size, dataP);
+        if (result < 0) return -1;
+        bufferP->data[start] = PRV_RECORD_INSTANCE;
+    }
+
+    length = bufferP->length - start - PRV_HEADER_SIZE;
+    prv_setU32(bufferP->data + start + 1, (uint32_t)length);
+    prv_setU32(hash, utils_hash(bufferP->data + start, PRV_HEADER_SIZE + length));
+
+    return utils_bufferAppend(bufferP, hash, PRV_HASH_SIZE);
+}
+
+// Appends a record of each current instance of the journaled objects
+static int prv_writeAll(lwm2m_context_t * contextP,
+                        utils_buffer_t * bufferP,
+                        size_t * countP)
+{
+    _journal_t * journalP = contextP->journalP;
+    uint16_t i;
+
+    *countP = 0;
+    for (i = 0 ; i < journalP->objectCount ; i++)
+    {
+        lwm2m_object_t * objectP;
+        lwm2m_list_t * instanceP;
+
+        objectP = object_find(contextP, journalP->objectIds[i]);
+        if (objectP == NULL) continue;
+        for (instanceP = objectP->instanceList ; instanceP != NULL ; instanceP = instanceP->next)
+        {
+            if (prv_writeInstance(objectP, instanceP->id, bufferP) != 0) return -1;
+            (*countP)++;
+        }
+    }
+
+    return 0;
+}
+
+// Writes the current instances of the journaled objects in place of the log
+static void prv_compact(lwm2m_context_t * contextP)
+{
+    _journal_t * journalP = contextP->journalP;
+    utils_buffer_t buffer;
+    size_t count;
+
+    LOG_ARG("%d records, %d at the last rewrite", (int)journalP->recordCount, (int)journalP->liveCount);
+    utils_bufferInit(&buffer, NULL, 0);
+    if (prv_writeAll(contextP, &buffer, &count) != 0)
+    {
+        utils_bufferFree(&buffer);
+        journalP->outdated = true;
+        return;
+    }
+
+    if (lwm2m_journal_replace(buffer.data, buffer.length, contextP->userData) == 0)
+    {
+        journalP->recordCount = count;
+        journalP->liveCount = count;
+        journalP->outdated = false;
+    }
+    else
+    {
+        journalP->outdated = true;
+    }
+    utils_bufferFree(&buffer);
+}
+
+// Deletes the instances of the journaled objects before the replay of the log
+static void prv_clear(lwm2m_context_t * contextP)
+{
+    _journal_t * journalP = contextP->journalP;
+    uint16_t i;
+
+    for (i = 0 ; i < journalP->objectCount ; i++)
+    {
+        lwm2m_object_t * objectP;
+
+        objectP = object_find(contextP, journalP->objectIds[i]);
+        if (objectP == NULL || objectP->deleteFunc == NULL) continue;
+        while (objectP->instanceList != NULL)
+        {
+            if (objectP->deleteFunc(objectP->instanceList->id, objectP) != COAP_202_DELETED) break;
+        }
+    }
+}
+
+// Returns the length of the valid records at the start of the log, without changing the objects.
+// The content of the instance records of the journaled objects is checked too.
+static size_t prv_validate(lwm2m_context_t * contextP,
+                           uint8_t * buffer,
+                           size_t length,
+                           size_t * countP)
+{
+    size_t offset;
+
+    *countP = 0;
+    offset = 0;
+    while (length - offset >= PRV_HEADER_SIZE + PRV_HASH_SIZE)
+    {
+        uint8_t * payload;
+        uint32_t payloadLength;
+
+        payloadLength = prv_getU32(buffer + offset + 1);
+        if (payloadLength > length - offset - PRV_HEADER_SIZE - PRV_HASH_SIZE
+         || utils_hash(buffer + offset, PRV_HEADER_SIZE + payloadLength) != prv_getU32(buffer + offset + PRV_HEADER_SIZE + payloadLength))
+        {
+            break;
+        }
+
+        payload = buffer + offset + PRV_HEADER_SIZE;
+        if (buffer[offset] == PRV_RECORD_INSTANCE || buffer[offset] == PRV_RECORD_DELETE)
+        {
+            if (payloadLength < PRV_IDS_SIZE) break;
+            if (buffer[offset] == PRV_RECORD_INSTANCE
+             && payloadLength > PRV_IDS_SIZE
+             && prv_isJournaled(contextP->journalP, prv_getU16(payload)))
+            {
+                lwm2m_data_t * dataP = NULL;
+                int size;
+
+                size = tlv_parse(payload + PRV_IDS_SIZE, payloadLength - PRV_IDS_SIZE, true, &dataP);
+                lwm2m_data_free(size, dataP);
+                if (size <= 0) break;
+            }
+        }
+
+        offset += PRV_HEADER_SIZE + payloadLength + PRV_HASH_SIZE;
+        (*countP)++;
+    }
+    if (offset != length)
+    {
+        LOG_ARG("Invalid record at offset %d", (int)offset);
+    }
+
+    return offset;
+}
+
+static int prv_readInstance(lwm2m_context_t * contextP,
+                            uint8_t type,
+                            uint8_t * payload,
+                            size_t length)
+{
+    lwm2m_object_t * objectP;
+    uint16_t instanceId;
+    lwm2m_data_t * dataP = NULL;
+    int size = 0;
+    uint8_t result;
+
+    if (length < PRV_IDS_SIZE) return -1;
+    objectP = object_find(contextP, prv_getU16(payload));
+    // records of objects no longer journaled are skipped
+    if (objectP == NULL || !prv_isJournaled(contextP->journalP, objectP->objID)) return 0;
+    instanceId = prv_getU16(payload + 2);
+
+    if (NULL != lwm2m_list_find(objectP->instanceList, instanceId))
+    {
+        if (objectP->deleteFunc == NULL
+         || objectP->deleteFunc(instanceId, objectP) != COAP_202_DELETED) return -1;
+    }
+    if (type == PRV_RECORD_DELETE) return 0;
+
+    if (objectP->createFunc == NULL) return -1;
+    if (length > PRV_IDS_SIZE)
+    {
+        size = tlv_parse(payload + PRV_IDS_SIZE, length - PRV_IDS_SIZE, false, &dataP);
+        if (size <= 0) return -1;
+    }
+    result = objectP->createFunc(instanceId, size, dataP, objectP);
+    lwm2m_data_free(size, dataP);
+
+    return result == COAP_201_CREATED ? 0 : -1;
+}
+
+// Applies records checked by prv_validate() to the objects
+static int prv_replay(lwm2m_context_t * contextP,
+                      uint8_t * buffer,
+                      size_t length)
+{
+    size_t offset;
+
+    offset = 0;
+    while (offset < length)
+    {
+        uint32_t payloadLength;
+
+        payloadLength = prv_getU32(buffer + offset + 1);
+        switch (buffer[offset])
+        {
+        case PRV_RECORD_INSTANCE:
+        case PRV_RECORD_DELETE:
+            if (prv_readInstance(contextP, buffer[offset], buffer + offset + PRV_HEADER_SIZE, payloadLength) != 0) return -1;
+            break;
+
+        default:
+            // unknown records are skipped
+            break;
+        }
+
+        offset += PRV_HEADER_SIZE + payloadLength + PRV_HASH_SIZE;
+    }
+
+    return 0;
+}
+
+// Replaces the instances of the journaled objects by the ones in the log
+// Returns 1 when the log is empty, the instances being left unchanged
+static int prv_load(lwm2m_context_t * contextP)
+{
+    _journal_t * journalP = contextP->journalP;
+    uint8_t * buffer;
+    size_t length;
+    size_t validLength;
+    size_t recordCount;
+    size_t count;
+    utils_buffer_t backup;
+    int result;
+    uint16_t i;
+
+    buffer = NULL;
+    length = 0;
+    if (lwm2m_journal_open(&buffer, &length, contextP->userData) != 0) return -1;
+
+    if (length == 0)
+    {
+        lwm2m_journal_close(buffer, length, contextP->userData);
+        return 1;
+    }
+
+    // the whole log is checked before the instances are deleted, and these are kept to be restored
+    // if an object fails to recreate one
+    validLength = prv_validate(contextP, buffer, length, &recordCount);
+    utils_bufferInit(&backup, NULL, 0);
+    if (prv_writeAll(contextP, &backup, &count) != 0)
+    {
+        utils_bufferFree(&backup);
+        lwm2m_journal_close(buffer, length, contextP->userData);
+        return -1;
+    }
+
+    prv_clear(contextP);
+    result = prv_replay(contextP, buffer, validLength);
+    lwm2m_journal_close(buffer, length, contextP->userData);
+    if (result != 0)
+    {
+        LOG("Failed to replay the log, restoring the previous instances");
+        prv_clear(contextP);
+        prv_replay(contextP, backup.data, backup.length);
+    }
+    utils_bufferFree(&backup);
+    object_invalidateRegisterPayload(contextP);
+    acl_invalidate(contextP);
+    if (result != 0) return -1;
+
+    journalP->recordCount = recordCount;
+    journalP->liveCount = 0;
+    for (i = 0 ; i < journalP->objectCount ; i++)
+    {
+        lwm2m_object_t * objectP;
+        lwm2m_list_t * instanceP;
+
+        objectP = object_find(contextP, journalP->objectIds[i]);
+        if (objectP == NULL) continue;
+        for (instanceP = objectP->instanceList ; instanceP != NULL ; instanceP = instanceP->next)
+        {
+            journalP->liveCount++;
+        }
+    }
+    LOG_ARG("%d current records out of %d", (int)journalP->liveCount, (int)journalP->recordCount);
+
+    // drop an invalid end of log, like a record partially written when the device stopped
+    if (validLength != length)
+    {
+        prv_compact(contextP);
+    }
+
+    return 0;
+}
+
+void journal_save(lwm2m_context_t * contextP,
+                  uint16_t objectId,
+                  uint16_t instanceId)
+{
+    _journal_t * journalP = contextP->journalP;
+    lwm2m_object_t * objectP;
+    utils_buffer_t buffer;
+    uint8_t data[256];
+    int result;
+
+    if (journalP == NULL || !prv_isJournaled(journalP, objectId)) return;
+    objectP = object_find(contextP, objectId);
+    if (objectP == NULL) return;
+
+    if (contextP->state == STATE_BOOTSTRAPPING)
+    {
+        journalP->deferred = true;
+        return;
+    }
+
+    LOG_ARG("/%d/%d", objectId, instanceId);
+    utils_bufferInit(&buffer, data, sizeof(data));
+    result = prv_writeInstance(objectP, instanceId, &buffer);
+    if (result != 0)
+    {
+        // larger than the stack buffer
+        utils_bufferInit(&buffer, NULL, 0);
+        result = prv_writeInstance(objectP, instanceId, &buffer);
+    }
+
+    // after a failed write, the log misses a change: it is rewritten as a whole
+    if (result != 0
+     || journalP->outdated
+     || lwm2m_journal_append(buffer.data, buffer.length, contextP->userData) != 0)
+    {
+        journalP->outdated = true;
+    }
+    else
+    {
+        journalP->recordCount++;
+    }
+    utils_bufferFree(&buffer);
+
+    if (journalP->outdated
+     || journalP->recordCount > 2 * journalP->liveCount + LWM2M_JOURNAL_COMPACTION_MIN)
+    {
+        prv_compact(contextP);
+    }
+}
+
+void journal_commit(lwm2m_context_t * contextP)
+{
+    if (contextP->journalP == NULL || !contextP->journalP->deferred) return;
+
+    LOG("Entering");
+    contextP->journalP->deferred = false;
+    prv_compact(contextP);
+}
+
+void journal_rollback(lwm2m_context_t * contextP)
+{
+    if (contextP->journalP == NULL || !contextP->journalP->deferred) return;
+
+    LOG("Entering");
+    contextP->journalP->deferred = false;
+    if (prv_load(contextP) != 0)
+    {
+        LOG("Failed to restore the journaled objects");
+    }
+}
+
+void journal_free(lwm2m_context_t * contextP)
+{
+    if (contextP->journalP == NULL) return;
+
+    lwm2m_free(contextP->journalP->objectIds);
+    lwm2m_free(contextP->journalP);
+    contextP->journalP = NULL;
+}
+
+int lwm2m_restore_objects(lwm2m_context_t * contextP,
+                          uint16_t numObject,
+                          const uint16_t objectIds[])
+{
+    _journal_t * journalP;
+    uint16_t i;
+
+    LOG_ARG("numObject: %d", numObject);
+    journal_free(contextP);
+    if (numObject == 0) return COAP_NO_ERROR;
+    for (i = 0 ; i < numObject ; i++)
+    {
+        lwm2m_object_t * objectP;
+
+        objectP = object_find(contextP, objectIds[i]);
+        if (objectP == NULL) return COAP_404_NOT_FOUND;
+        // the instances are read to be written and recreated on replay
+        if (objectP->readFunc == NULL
+         || objectP->createFunc == NULL
+         || objectP->deleteFunc == NULL) return COAP_405_METHOD_NOT_ALLOWED;
+    }
+
+    journalP = (_journal_t *)lwm2m_malloc(sizeof(_journal_t));
+    if (journalP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+    memset(journalP, 0, sizeof(_journal_t));
+    journalP->objectIds = (uint16_t *)lwm2m_malloc(numObject * sizeof(uint16_t));
+    if (journalP->objectIds == NULL)
+    {
+        lwm2m_free(journalP);
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+    memcpy(journalP->objectIds, objectIds, numObject * sizeof(uint16_t));
+    journalP->objectCount = numObject;
+    contextP->journalP = journalP;
+
+    switch (prv_load(contextP))
+    {
+    case 0:
+        break;
+
+    case 1:
+        // first start: the current instances are the initial content of the log
+        prv_compact(contextP);
+        if (!journalP->outdated) break;
+        // fall through
+
+    default:
+        journal_free(contextP);
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    return COAP_NO_ERROR;
+}
+
+#endif
@@ -25,30 +25,36 @@
 
 #ifdef LWM2M_SUPPORT_JSON
 
-#define PRV_JSON_BUFFER_SIZE 1024
+#define PRV_JSON_B64_CHUNK_SIZE 48     // opaque bytes base64 encoded at once, must be a multiple of 3
+#define PRV_JSON_NUMBER_MAX_LEN 64
+#define PRV_JSON_INITIAL_SIZE   512    // grows as needed
 
-#define JSON_MIN_ARRAY_LEN      21      // e":[{"n":"N","v":X}]}
-#define JSON_MIN_BASE_LEN        7      // n":"N",
-#define JSON_ITEM_MAX_SIZE      36      // with ten characters for value
-#define JSON_MIN_BX_LEN          5      // bt":1
+// Word at a time scan of the strings: true if one of the eight bytes of W is zero
+#define PRV_JSON_HAS_ZERO_BYTE(W)   (((W) - 0x0101010101010101ULL) & ~(W) & 0x8080808080808080ULL)
+#define PRV_JSON_QUOTES             0x2222222222222222ULL
+#define PRV_JSON_BACKSLASHES        0x5C5C5C5C5C5C5C5CULL
 
-#define JSON_FALSE_STRING  "false"
-#define JSON_TRUE_STRING   "true"
+#define JSON_FALSE_STRING       "false"
+#define JSON_FALSE_STRING_SIZE  5
+#define JSON_TRUE_STRING        "true"
+#define JSON_TRUE_STRING_SIZE   4
 
 #define JSON_RES_ITEM_URI           "{\"n\":\""
 #define JSON_RES_ITEM_URI_SIZE      6
-#define JSON_ITEM_BOOL_TRUE         "\",\"bv\":true},"
-#define JSON_ITEM_BOOL_TRUE_SIZE    13
-#define JSON_ITEM_BOOL_FALSE        "\",\"bv\":false},"
-#define JSON_ITEM_BOOL_FALSE_SIZE   14
+#define JSON_ITEM_BOOL_TRUE         "\",\"bv\":true}"
+#define JSON_ITEM_BOOL_TRUE_SIZE    12
+#define JSON_ITEM_BOOL_FALSE        "\",\"bv\":false}"
+#define JSON_ITEM_BOOL_FALSE_SIZE   13
 #define JSON_ITEM_NUM               "\",\"v\":"
 #define JSON_ITEM_NUM_SIZE          6
-#define JSON_ITEM_NUM_END           "},"
-#define JSON_ITEM_NUM_END_SIZE      2
+#define JSON_ITEM_NUM_END           "}"
+#define JSON_ITEM_NUM_END_SIZE      1
 #define JSON_ITEM_STRING_BEGIN      "\",\"sv\":\""
 #define JSON_ITEM_STRING_BEGIN_SIZE 8
-#define JSON_ITEM_STRING_END        "\"},"
-#define JSON_ITEM_STRING_END_SIZE   3
+#define JSON_ITEM_STRING_END        "\"}"
+#define JSON_ITEM_STRING_END_SIZE   2
+#define JSON_ITEM_SEPARATOR         ","
+#define JSON_ITEM_SEPARATOR_SIZE    1
 
 #define JSON_BN_HEADER_1        "{\"bn\":\""
 #define JSON_BN_HEADER_1_SIZE   7
@@ -60,41 +66,56 @@
 #define JSON_FOOTER_SIZE        2
 
 
-#define _GO_TO_NEXT_CHAR(I,B,L)         \
-    {                                   \
-        I++;                            \
-        I += prv_skipSpace(B+I, L-I);   \
-        if (I == L) goto error;         \
-    }
-
-typedef enum
-{
-    _STEP_START,
-    _STEP_TOKEN,
-    _STEP_ANY_SEPARATOR,
-    _STEP_SEPARATOR,
-    _STEP_QUOTED_VALUE,
-    _STEP_VALUE,
-    _STEP_DONE
-} _itemState;
+// The parser reads the payload in a single pass. The records are inserted in the data tree as soon as
+// they are complete.
 
 typedef enum
 {
     _TYPE_UNSET,
     _TYPE_FALSE,
     _TYPE_TRUE,
-    _TYPE_FLOAT,
+    _TYPE_NUMBER,
     _TYPE_STRING
 } _type;
 
+// A quoted string, without its quotes, or a bare value in the payload
+typedef struct
+{
+    uint8_t * start;
+    size_t    length;
+    bool      isEscaped;
+} _token_t;
+
+// The fields of a record may come in any order: the record is inserted in the tree once complete.
 typedef struct
 {
-    uint16_t    ids[4];
-    _type       type;
-    uint8_t *   value;
-    size_t      valueLen;
+    uint16_t ids[SENML_MAX_DEPTH];
+    int      depth;
+    _type    type;
+    _token_t value;
 } _record_t;
 
+typedef struct
+{
+    uint8_t *      buffer;
+    size_t         length;
+    size_t         index;
+    uint16_t       baseIds[SENML_MAX_DEPTH];
+    int            baseDepth;
+    senml_tree_t   tree;
+} _parser_t;
+
+// The serializer output. The document is written in a single pass. The bytes before offset are only
+// counted, as are the bytes not fitting in a static buffer, so that a single Block2 chunk can be built
+// while length gives the size of the whole document.
+typedef struct
+{
+    utils_buffer_t buffer;
+    size_t         offset;
+    size_t         length;
+    size_t         itemCount;
+} _writer_t;
+
 static int prv_isReserved(char sign)
 {
     if (sign == '['
@@ -124,317 +145,299 @@ static int prv_isWhiteSpace(uint8_t sign)
     return 0;
 }
 
-static size_t prv_skipSpace(uint8_t * buffer,
-                            size_t bufferLen)
+// Skips the white spaces and returns the next character, or 0 at the end of the payload.
+static uint8_t prv_peek(_parser_t * parserP)
 {
-    size_t i;
-
-    i = 0;
-    while ((i < bufferLen)
-        && prv_isWhiteSpace(buffer[i]))
+    while (parserP->index < parserP->length
+        && prv_isWhiteSpace(parserP->buffer[parserP->index]))
     {
-        i++;
+        parserP->index++;
     }
+    if (parserP->index == parserP->length) return 0;
 
-    return i;
+    return parserP->buffer[parserP->index];
 }
 
-static int prv_split(uint8_t * buffer,
-                     size_t bufferLen,
-                     int * tokenStartP,
-                     int * tokenLenP,
-                     int * valueStartP,
-                     int * valueLenP)
+// Consumes the next character if it is the expected one.
+static bool prv_skip(_parser_t * parserP,
+                     uint8_t sign)
 {
-    size_t index;
-    _itemState step;
-
-    index = 0;
-    step = _STEP_START;
+    if (prv_peek(parserP) != sign) return false;
+    parserP->index++;
 
-    index = prv_skipSpace(buffer + index, bufferLen - index);
-    if (index == bufferLen) return -1;
+    return true;
+}
 
-    while ((index < bufferLen)
-        && (buffer[index] != ','))
+// Returns the position of the first quote or backslash from index, or length if there is none.
+// The bytes are checked eight at a time while none of them can end the string.
+static size_t prv_findStringEnd(const uint8_t * buffer,
+                                size_t index,
+                                size_t length)
+{
+    while (index + sizeof(uint64_t) <= length)
     {
-        switch (step)
-        {
-        case _STEP_START:
-            if (buffer[index] != '"') return -1;
-            *tokenStartP = index+1;
-            step = _STEP_TOKEN;
-            break;
+        uint64_t word;
 
-        case _STEP_TOKEN:
-            if (buffer[index] == '"')
-            {
-                *tokenLenP = index - *tokenStartP;
-                step = _STEP_ANY_SEPARATOR;
-            }
+        memcpy(&word, buffer + index, sizeof(uint64_t));
+        if (PRV_JSON_HAS_ZERO_BYTE(word ^ PRV_JSON_QUOTES)
+         || PRV_JSON_HAS_ZERO_BYTE(word ^ PRV_JSON_BACKSLASHES))
+        {
             break;
+        }
+        index += sizeof(uint64_t);
+    }
+    while (index < length
+        && buffer[index] != '"'
+        && buffer[index] != '\\')
+    {
+        index++;
+    }
 
-        case _STEP_ANY_SEPARATOR:
-            if (buffer[index] != ':') return -1;
-            step = _STEP_SEPARATOR;
-            break;
+    return index;
+}
 
-        case _STEP_SEPARATOR:
-            if (buffer[index] == '"')
-            {
-                *valueStartP = index;
-                step = _STEP_QUOTED_VALUE;
-            } else if (!prv_isReserved(buffer[index]))
-            {
-                *valueStartP = index;
-                step = _STEP_VALUE;
-            } else
-            {
-                return -1;
-            }
-            break;
+// Reads a quoted string. The escape sequences are checked when the string is decoded.
+static bool prv_readString(_parser_t * parserP,
+                           _token_t * tokenP)
+{
+    size_t index;
 
-        case _STEP_QUOTED_VALUE:
-            if (buffer[index] == '"' && buffer[index-1] != '\\' )
-            {
-                *valueLenP = index - *valueStartP + 1;
-                step = _STEP_DONE;
-            }
-            break;
+    if (prv_peek(parserP) != '"') return false;
+    index = parserP->index + 1;
+    tokenP->start = parserP->buffer + index;
+    tokenP->isEscaped = false;
 
-        case _STEP_VALUE:
-            if (prv_isWhiteSpace(buffer[index]))
-            {
-                *valueLenP = index - *valueStartP;
-                step = _STEP_DONE;
-            }
-            break;
+    while (true)
+    {
+        index = prv_findStringEnd(parserP->buffer, index, parserP->length);
+        if (index >= parserP->length) return false;
+        if (parserP->buffer[index] == '"') break;
+        tokenP->isEscaped = true;
+        index += 2;
+    }
+    tokenP->length = parserP->buffer + index - tokenP->start;
+    parserP->index = index + 1;
 
-        case _STEP_DONE:
-        default:
-            return -1;
-        }
+    return true;
+}
 
-        index++;
-        if (step == _STEP_START
-         || step == _STEP_ANY_SEPARATOR
-         || step == _STEP_SEPARATOR
-         || step == _STEP_DONE)
-        {
-            index += prv_skipSpace(buffer + index, bufferLen - index);
-        }
-    }
+// Reads a number or a literal.
+static bool prv_readValue(_parser_t * parserP,
+                          _token_t * tokenP)
+{
+    size_t index;
 
-    if (step == _STEP_VALUE)
+    prv_peek(parserP);
+    index = parserP->index;
+    while (index < parserP->length
+        && !prv_isWhiteSpace(parserP->buffer[index])
+        && !prv_isReserved(parserP->buffer[index]))
     {
-        *valueLenP = index - *valueStartP;
-        step = _STEP_DONE;
+        index++;
     }
+    if (index == parserP->index) return false;
 
-    if (step != _STEP_DONE) return -1;
+    tokenP->start = parserP->buffer + parserP->index;
+    tokenP->length = index - parserP->index;
+    tokenP->isEscaped = false;
+    parserP->index = index;
 
-    return (int)index;
+    return true;
 }
 
-static int prv_countItems(uint8_t * buffer,
-                          size_t bufferLen)
+// Skips an array without decoding it.
+static bool prv_skipArray(_parser_t * parserP)
 {
-    int count;
-    size_t index;
-    int in;
+    int level;
 
-    count = 0;
-    index = 0;
-    in = 0;
+    if (prv_peek(parserP) != '[') return false;
 
-    while (index < bufferLen)
+    level = 0;
+    do
     {
-        if (in == 0)
-        {
-            if (buffer[index] != '{') return -1;
-            in = 1;
-            _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
-        }
-        else
+        _token_t token;
+
+        switch (prv_peek(parserP))
         {
-            if (buffer[index] == '{') return -1;
-            if (buffer[index] == '}')
-            {
-                in = 0;
-                count++;
-                _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
-                if (buffer[index] == ']')
-                {
-                    break;
-                }
-                if (buffer[index] != ',') return -1;
-                _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
-            }
-            else
-            {
-                _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
-            }
+        case 0:
+            return false;
+        case '"':
+            if (!prv_readString(parserP, &token)) return false;
+            continue;
+        case '[':
+        case '{':
+            level++;
+            break;
+        case ']':
+        case '}':
+            level--;
+            break;
+        default:
+            break;
         }
-    }
-    if (in == 1) return -1;
+        parserP->index++;
+    } while (level > 0);
 
-    return count;
-
-error:
-    return -1;
+    return true;
 }
 
-static int prv_parseItem(uint8_t * buffer,
-                         size_t bufferLen,
-                         _record_t * recordP)
+static int prv_readHex(const uint8_t * buffer,
+                       uint32_t * valueP)
 {
-    size_t index;
-
-    memset(recordP->ids, 0xFF, 4*sizeof(uint16_t));
-    recordP->type = _TYPE_UNSET;
-    recordP->value = NULL;
-    recordP->valueLen = 0;
+    int i;
 
-    index = 0;
-    do
+    *valueP = 0;
+    for (i = 0 ; i < 4 ; i++)
     {
-        int tokenStart;
-        int tokenLen;
-        int valueStart;
-        int valueLen;
-        int next;
+        uint8_t sign = buffer[i];
 
-        next = prv_split(buffer+index, bufferLen-index, &tokenStart, &tokenLen, &valueStart, &valueLen);
-        if (next < 0) return -1;
+        *valueP <<= 4;
+        if ('0' <= sign && sign <= '9') *valueP |= sign - '0';
+        else if ('a' <= sign && sign <= 'f') *valueP |= sign - 'a' + 10;
+        else if ('A' <= sign && sign <= 'F') *valueP |= sign - 'A' + 10;
+        else return -1;
+    }
 
-        switch (tokenLen)
-        {
-        case 1:
-        {
-            switch (buffer[index+tokenStart])
-            {
-            case 'n':
-            {
-                int i;
-                int j;
+    return 0;
+}
 
-                if (recordP->ids[0] != LWM2M_MAX_ID) return -1;
+// Decodes the escape sequences of the string into destP, which is at least as long as the string.
+// \uXXXX sequences, including surrogate pairs, are converted to UTF-8.
+// Returns the decoded length or -1 if an escape sequence is invalid.
+static int prv_unescape(const _token_t * tokenP,
+                        uint8_t * destP)
+{
+    size_t i;
+    size_t length;
 
-                // Check for " around URI
-                if (valueLen < 3
-                 || buffer[index+valueStart] != '"'
-                 || buffer[index+valueStart+valueLen-1] != '"')
-                {
-                    return -1;
-                }
-                // Ignore starting /
-                if (buffer[index + valueStart + 1] == '/')
-                {
-                    if (valueLen < 4)
-                    {
-                        return -1;
-                    }
-                    valueStart += 1;
-                    valueLen -= 1;
-                }
-                i = 0;
-                j = 0;
-                do {
-                    uint32_t readId;
-
-                    readId = 0;
-                    i++;
-                    while (i < valueLen-1 && buffer[index+valueStart+i] != '/')
-                    {
-                        if (buffer[index+valueStart+i] < '0'
-                         || buffer[index+valueStart+i] > '9')
-                        {
-                            return -1;
-                        }
-                        readId *= 10;
-                        readId += buffer[index+valueStart+i] - '0';
-                        if (readId > LWM2M_MAX_ID) return -1;
-                        i++;
-                    }
-                    recordP->ids[j] = readId;
-                    j++;
-                } while (i < valueLen-1 && j < 4 && buffer[index+valueStart+i] == '/');
-                if (i < valueLen-1 ) return -1;
-            }
-            break;
+    length = 0;
+    i = 0;
+    while (i < tokenP->length)
+    {
+        uint32_t codePoint;
 
-            case 'v':
-                if (recordP->type != _TYPE_UNSET) return -1;
-                recordP->type = _TYPE_FLOAT;
-                recordP->value = buffer + index + valueStart;
-                recordP->valueLen = valueLen;
-                break;
+        if (tokenP->start[i] != '\\')
+        {
+            destP[length++] = tokenP->start[i++];
+            continue;
+        }
 
-            case 't':
-                // TODO: support time
-                break;
+        if (i + 1 >= tokenP->length) return -1;
+        switch (tokenP->start[i + 1])
+        {
+        case '"':
+        case '\\':
+        case '/':
+            destP[length++] = tokenP->start[i + 1];
+            i += 2;
+            continue;
+        case 'b':
+            destP[length++] = '\b';
+            i += 2;
+            continue;
+        case 'f':
+            destP[length++] = '\f';
+            i += 2;
+            continue;
+        case 'n':
+            destP[length++] = '\n';
+            i += 2;
+            continue;
+        case 'r':
+            destP[length++] = '\r';
+            i += 2;
+            continue;
+        case 't':
+            destP[length++] = '\t';
+            i += 2;
+            continue;
+        case 'u':
+            break;
+        default:
+            return -1;
+        }
 
-            default:
+        if (i + 6 > tokenP->length
+         || prv_readHex(tokenP->start + i + 2, &codePoint) != 0)
+        {
+            return -1;
+        }
+        i += 6;
+        if (codePoint >= 0xD800 && codePoint <= 0xDFFF)
+        {
+            uint32_t low;
+
+            // a high surrogate followed by a low one
+            if (codePoint > 0xDBFF
+             || i + 6 > tokenP->length
+             || tokenP->start[i] != '\\'
+             || tokenP->start[i + 1] != 'u'
+             || prv_readHex(tokenP->start + i + 2, &low) != 0
+             || low < 0xDC00
+             || low > 0xDFFF)
+            {
                 return -1;
             }
+            i += 6;
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
         }
-        break;
 
-        case 2:
+        if (codePoint < 0x80)
         {
-            // "bv", "ov", or "sv"
-            if (buffer[index+tokenStart+1] != 'v') return -1;
-            switch (buffer[index+tokenStart])
-            {
-            case 'b':
-                if (recordP->type != _TYPE_UNSET) return -1;
-                if (0 == lwm2m_strncmp(JSON_TRUE_STRING, (char *)buffer + index + valueStart, valueLen))
-                {
-                    recordP->type = _TYPE_TRUE;
-                }
-                else if (0 == lwm2m_strncmp(JSON_FALSE_STRING, (char *)buffer + index + valueStart, valueLen))
-                {
-                    recordP->type = _TYPE_FALSE;
-                }
-                else
-                {
-                    return -1;
-                }
-                break;
+            destP[length++] = (uint8_t)codePoint;
+        }
+        else if (codePoint < 0x800)
+        {
+            destP[length++] = (uint8_t)(0xC0 | (codePoint >> 6));
+            destP[length++] = (uint8_t)(0x80 | (codePoint & 0x3F));
+        }
+        else if (codePoint < 0x10000)
+        {
+            destP[length++] = (uint8_t)(0xE0 | (codePoint >> 12));
+            destP[length++] = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+            destP[length++] = (uint8_t)(0x80 | (codePoint & 0x3F));
+        }
+        else
+        {
+            destP[length++] = (uint8_t)(0xF0 | (codePoint >> 18));
+            destP[length++] = (uint8_t)(0x80 | ((codePoint >> 12) & 0x3F));
+            destP[length++] = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+            destP[length++] = (uint8_t)(0x80 | (codePoint & 0x3F));
+        }
+    }
 
-            case 'o':
-                if (recordP->type != _TYPE_UNSET) return -1;
-                // TODO: support object link
-                break;
+    return (int)length;
+}
 
-            case 's':
-                if (recordP->type != _TYPE_UNSET) return -1;
-                // Check for " around value
-                if (valueLen < 2
-                 || buffer[index+valueStart] != '"'
-                 || buffer[index+valueStart+valueLen-1] != '"')
-                {
-                    return -1;
-                }
-                recordP->type = _TYPE_STRING;
-                recordP->value = buffer + index + valueStart + 1;
-                recordP->valueLen = valueLen - 2;
-                break;
+static bool prv_parseBaseName(_parser_t * parserP,
+                              _token_t * tokenP)
+{
+    lwm2m_uri_t uri;
+    int res;
 
-            default:
-                return -1;
-            }
-        }
-        break;
+    if (tokenP->isEscaped || tokenP->length == 0) return false;
 
-        default:
-            return -1;
-        }
+    if (tokenP->length == 1)
+    {
+        if (tokenP->start[0] != '/') return false;
+        parserP->baseDepth = 0;
+        return true;
+    }
 
-        index += next + 1;
-    } while (index < bufferLen);
+    res = lwm2m_stringToUri((char *)tokenP->start, tokenP->length, &uri);
+    if (res < 0 || res != (int)tokenP->length) return false;
+    parserP->baseDepth = senml_uriToIds(&uri, parserP->baseIds);
 
-    return 0;
+    return true;
+}
+
+// The name of a record is appended to the base name.
+static bool prv_parseName(_token_t * tokenP,
+                          _record_t * recordP)
+{
+    if (tokenP->isEscaped) return false;
+
+    return senml_parseName(tokenP->start, tokenP->length, recordP->ids, &recordP->depth);
 }
 
 static bool prv_convertValue(_record_t * recordP,
@@ -448,22 +451,24 @@ static bool prv_convertValue(_record_t * recordP,
     case _TYPE_TRUE:
         lwm2m_data_encode_bool(true, targetP);
         break;
-    case _TYPE_FLOAT:
+    case _TYPE_NUMBER:
     {
         size_t i;
 
         i = 0;
-        while (i < recordP->valueLen
-            && recordP->value[i] != '.')
+        while (i < recordP->value.length
+            && recordP->value.start[i] != '.'
+            && recordP->value.start[i] != 'e'
+            && recordP->value.start[i] != 'E')
         {
             i++;
         }
-        if (i == recordP->valueLen)
+        if (i == recordP->value.length)
         {
             int64_t value;
 
-            if ( 1 != utils_textToInt(recordP->value,
-                                      recordP->valueLen,
+            if ( 1 != utils_textToInt(recordP->value.start,
+                                      recordP->value.length,
                                       &value))
             {
                 return false;
@@ -475,8 +480,8 @@ static bool prv_convertValue(_record_t * recordP,
         {
             double value;
 
-            if ( 1 != utils_textToFloat(recordP->value,
-                                        recordP->valueLen,
+            if ( 1 != utils_textToFloat(recordP->value.start,
+                                        recordP->value.length,
                                         &value))
             {
                 return false;
@@ -488,7 +493,26 @@ static bool prv_convertValue(_record_t * recordP,
     break;
 
     case _TYPE_STRING:
-        lwm2m_data_encode_opaque(recordP->value, recordP->valueLen, targetP);
+        if (recordP->value.isEscaped)
+        {
+            uint8_t * valueP;
+            int length;
+
+            valueP = (uint8_t *)lwm2m_malloc(recordP->value.length);
+            if (valueP == NULL) return false;
+            length = prv_unescape(&recordP->value, valueP);
+            if (length < 0)
+            {
+                lwm2m_free(valueP);
+                return false;
+            }
+            targetP->value.asBuffer.buffer = valueP;
+            targetP->value.asBuffer.length = length;
+        }
+        else
+        {
+            if (0 == data_copyBuffer(targetP, recordP->value.start, recordP->value.length)) return false;
+        }
         targetP->type = LWM2M_TYPE_STRING;
         break;
 
@@ -500,254 +524,116 @@ static bool prv_convertValue(_record_t * recordP,
     return true;
 }
 
-static lwm2m_data_t * prv_findDataItem(lwm2m_data_t * listP,
-                                       int count,
-                                       uint16_t id)
-{
-    int i;
-
-    i = 0;
-    while (i < count)
-    {
-        if (listP[i].type != LWM2M_TYPE_UNDEFINED && listP[i].id == id)
-        {
-            return listP + i;
-        }
-        i++;
-    }
-
-    return NULL;
-}
-
-static uri_depth_t prv_decreaseLevel(uri_depth_t level)
-{
-    switch(level)
-    {
-    case URI_DEPTH_OBJECT:
-        return URI_DEPTH_OBJECT_INSTANCE;
-    case URI_DEPTH_OBJECT_INSTANCE:
-        return URI_DEPTH_RESOURCE;
-    case URI_DEPTH_RESOURCE:
-        return URI_DEPTH_RESOURCE_INSTANCE;
-    case URI_DEPTH_RESOURCE_INSTANCE:
-        return URI_DEPTH_RESOURCE_INSTANCE;
-    default:
-        return URI_DEPTH_RESOURCE;
-    }
-}
-
-static lwm2m_data_t * prv_extendData(lwm2m_data_t * parentP)
+static bool prv_parseRecord(_parser_t * parserP)
 {
-    lwm2m_data_t * newP;
-
-    newP = lwm2m_data_new(parentP->value.asChildren.count + 1);
-    if (newP == NULL) return NULL;
-    if (parentP->value.asChildren.array != NULL)
-    {
-        memcpy(newP, parentP->value.asChildren.array, parentP->value.asChildren.count * sizeof(lwm2m_data_t));
-        lwm2m_free(parentP->value.asChildren.array);     // do not use lwm2m_data_free() to keep pointed values
-    }
-    parentP->value.asChildren.array = newP;
-    parentP->value.asChildren.count += 1;
-
-    return newP + parentP->value.asChildren.count - 1;
-}
-
-static int prv_convertRecord(lwm2m_uri_t * uriP,
-                             _record_t * recordArray,
-                             int count,
-                             lwm2m_data_t ** dataP)
-{
-    int index;
-    int freeIndex;
-    lwm2m_data_t * rootP;
-    int size;
-    uri_depth_t rootLevel;
+    _record_t record;
+    bool nameFound;
+    lwm2m_data_t * targetP;
 
-    if (uriP == NULL)
-    {
-        size = count;
-        *dataP = lwm2m_data_new(count);
-        if (NULL == *dataP) return -1;
-        rootLevel = URI_DEPTH_OBJECT;
-        rootP = *dataP;
-    }
-    else
-    {
-        lwm2m_data_t * parentP;
-        size = 1;
-
-        *dataP = lwm2m_data_new(1);
-        if (NULL == *dataP) return -1;
-        (*dataP)->type = LWM2M_TYPE_OBJECT;
-        (*dataP)->id = uriP->objectId;
-        rootLevel = URI_DEPTH_OBJECT_INSTANCE;
-        parentP = *dataP;
-        if (LWM2M_URI_IS_SET_INSTANCE(uriP))
-        {
-            parentP->value.asChildren.count = 1;
-            parentP->value.asChildren.array = lwm2m_data_new(1);
-            if (NULL == parentP->value.asChildren.array) goto error;
-            parentP = parentP->value.asChildren.array;
-            parentP->type = LWM2M_TYPE_OBJECT_INSTANCE;
-            parentP->id = uriP->instanceId;
-            rootLevel = URI_DEPTH_RESOURCE;
-            if (LWM2M_URI_IS_SET_RESOURCE(uriP))
-            {
-                parentP->value.asChildren.count = 1;
-                parentP->value.asChildren.array = lwm2m_data_new(1);
-                if (NULL == parentP->value.asChildren.array) goto error;
-                parentP = parentP->value.asChildren.array;
-                parentP->type = LWM2M_TYPE_UNDEFINED;
-                parentP->id = uriP->resourceId;
-                rootLevel = URI_DEPTH_RESOURCE_INSTANCE;
-            }
-        }
-        parentP->value.asChildren.count = count;
-        parentP->value.asChildren.array = lwm2m_data_new(count);
-        if (NULL == parentP->value.asChildren.array) goto error;
-        rootP = parentP->value.asChildren.array;
-    }
+    memcpy(record.ids, parserP->baseIds, sizeof(record.ids));
+    record.depth = parserP->baseDepth;
+    record.type = _TYPE_UNSET;
+    nameFound = false;
 
-    freeIndex = 0;
-    for (index = 0 ; index < count ; index++)
+    if (!prv_skip(parserP, '{')) return false;
+    do
     {
-        lwm2m_data_t * targetP;
-        int resSegmentIndex;
-        int i;
+        _token_t key;
+        _token_t token;
 
-        // check URI depth
-        // resSegmentIndex is set to the resource segment position
-        switch(rootLevel)
-        {
-        case URI_DEPTH_OBJECT:
-            resSegmentIndex = 2;
-            break;
-        case URI_DEPTH_OBJECT_INSTANCE:
-            resSegmentIndex = 1;
-            break;
-        case URI_DEPTH_RESOURCE:
-            resSegmentIndex = 0;
-            break;
-        case URI_DEPTH_RESOURCE_INSTANCE:
-            resSegmentIndex = -1;
-            break;
-        default:
-            goto error;
-        }
-        for (i = 0 ; i <= resSegmentIndex ; i++)
+        if (!prv_readString(parserP, &key)
+         || key.isEscaped
+         || !prv_skip(parserP, ':'))
         {
-            if (recordArray[index].ids[i] == LWM2M_MAX_ID) goto error;
-        }
-        if (resSegmentIndex < 2)
-        {
-            if (recordArray[index].ids[resSegmentIndex + 2] != LWM2M_MAX_ID) goto error;
+            return false;
         }
 
-        targetP = prv_findDataItem(rootP, count, recordArray[index].ids[0]);
-        if (targetP == NULL)
-        {
-            targetP = rootP + freeIndex;
-            freeIndex++;
-            targetP->id = recordArray[index].ids[0];
-            targetP->type = utils_depthToDatatype(rootLevel);
-        }
-        if (recordArray[index].ids[1] != LWM2M_MAX_ID)
+        switch (key.length)
         {
-            lwm2m_data_t * parentP;
-            uri_depth_t level;
-
-            parentP = targetP;
-            level = prv_decreaseLevel(rootLevel);
-            for (i = 1 ; i <= resSegmentIndex ; i++)
-            {
-                targetP = prv_findDataItem(parentP->value.asChildren.array, parentP->value.asChildren.count, recordArray[index].ids[i]);
-                if (targetP == NULL)
-                {
-                    targetP = prv_extendData(parentP);
-                    if (targetP == NULL) goto error;
-                    targetP->id = recordArray[index].ids[i];
-                    targetP->type = utils_depthToDatatype(level);
-                }
-                level = prv_decreaseLevel(level);
-                parentP = targetP;
-            }
-            if (recordArray[index].ids[resSegmentIndex + 1] != LWM2M_MAX_ID)
+        case 1:
+            switch (key.start[0])
             {
-                targetP->type = LWM2M_TYPE_MULTIPLE_RESOURCE;
-                targetP = prv_extendData(targetP);
-                if (targetP == NULL) goto error;
-                targetP->id = recordArray[index].ids[resSegmentIndex + 1];
-                targetP->type = LWM2M_TYPE_UNDEFINED;
-            }
-        }
-
-        if (true != prv_convertValue(recordArray + index, targetP)) goto error;
-    }
-
-    return size;
-
-error:
-    lwm2m_data_free(size, *dataP);
-    *dataP = NULL;
-
-    return -1;
-}
-
-static int prv_dataStrip(int size,
-                         lwm2m_data_t * dataP,
-                         lwm2m_data_t ** resultP)
-{
-    int i;
-    int j;
-    int realSize;
+            case 'n':
+                if (nameFound) return false;
+                nameFound = true;
+                if (!prv_readString(parserP, &token)) return false;
+                if (!prv_parseName(&token, &record)) return false;
+                break;
 
-    realSize = 0;
-    for (i = 0 ; i < size ; i++)
-    {
-        if (dataP[i].type != LWM2M_TYPE_UNDEFINED)
-        {
-            realSize++;
-        }
-    }
+            case 'v':
+                if (record.type != _TYPE_UNSET) return false;
+                if (!prv_readValue(parserP, &record.value)) return false;
+                record.type = _TYPE_NUMBER;
+                break;
 
-    *resultP = lwm2m_data_new(realSize);
-    if (*resultP == NULL) return -1;
+            case 't':
+                // TODO: support time
+                if (!prv_readValue(parserP, &token)) return false;
+                break;
 
-    j = 0;
-    for (i = 0 ; i < size ; i++)
-    {
-        if (dataP[i].type != LWM2M_TYPE_UNDEFINED)
-        {
-            memcpy((*resultP) + j, dataP + i, sizeof(lwm2m_data_t));
+            default:
+                return false;
+            }
+            break;
 
-            if (dataP[i].type == LWM2M_TYPE_OBJECT
-             || dataP[i].type == LWM2M_TYPE_OBJECT_INSTANCE
-             || dataP[i].type == LWM2M_TYPE_MULTIPLE_RESOURCE)
+        case 2:
+            // "bv", "ov", or "sv"
+            if (key.start[1] != 'v') return false;
+            if (record.type != _TYPE_UNSET) return false;
+            switch (key.start[0])
             {
-                int childLen;
-
-                childLen = prv_dataStrip(dataP[i].value.asChildren.count, dataP[i].value.asChildren.array, &((*resultP)[j].value.asChildren.array));
-                if (childLen <= 0)
+            case 'b':
+                if (!prv_readValue(parserP, &token)) return false;
+                if (token.length == JSON_TRUE_STRING_SIZE
+                 && 0 == memcmp(JSON_TRUE_STRING, token.start, JSON_TRUE_STRING_SIZE))
+                {
+                    record.type = _TYPE_TRUE;
+                }
+                else if (token.length == JSON_FALSE_STRING_SIZE
+                      && 0 == memcmp(JSON_FALSE_STRING, token.start, JSON_FALSE_STRING_SIZE))
                 {
-                    // skip this one
-                    j--;
+                    record.type = _TYPE_FALSE;
                 }
                 else
                 {
-                    (*resultP)[j].value.asChildren.count = childLen;
+                    return false;
                 }
+                break;
+
+            case 's':
+                if (!prv_readString(parserP, &record.value)) return false;
+                record.type = _TYPE_STRING;
+                break;
+
+            case 'o':
+                // TODO: support object link
+            default:
+                return false;
             }
-            else
-            {
-                dataP[i].value.asBuffer.buffer = NULL;
-            }
+            break;
+
+        default:
+            return false;
+        }
+    } while (prv_skip(parserP, ','));
+
+    if (!prv_skip(parserP, '}')) return false;
+
+    targetP = senml_addRecord(&parserP->tree, record.ids, record.depth);
+    if (targetP == NULL) return false;
 
-            j++;
-        }
-    }
+    return prv_convertValue(&record, targetP);
+}
+
+static bool prv_parseRecords(_parser_t * parserP)
+{
+    if (!prv_skip(parserP, '[')) return false;
+    do
+    {
+        if (!prv_parseRecord(parserP)) return false;
+    } while (prv_skip(parserP, ','));
 
-    return realSize;
+    return prv_skip(parserP, ']');
 }
 
 int json_parse(lwm2m_uri_t * uriP,
@@ -755,261 +641,95 @@ int json_parse(lwm2m_uri_t * uriP,
                size_t bufferLen,
                lwm2m_data_t ** dataP)
 {
-    size_t index;
-    int count = 0;
+    _parser_t parser;
+    size_t recordsIndex;
     bool eFound = false;
     bool bnFound = false;
     bool btFound = false;
-    int bnStart;
-    int bnLen;
-    _record_t * recordArray;
-    lwm2m_data_t * parsedP;
+    bool isDeferred = false;
+    int count;
 
     LOG_ARG("bufferLen: %d, buffer: \"%s\"", bufferLen, (char *)buffer);
     LOG_URI(uriP);
     *dataP = NULL;
-    recordArray = NULL;
-    parsedP = NULL;
 
-    index = prv_skipSpace(buffer, bufferLen);
-    if (index == bufferLen) return -1;
+    memset(&parser, 0, sizeof(_parser_t));
+    parser.buffer = buffer;
+    parser.length = bufferLen;
+    senml_treeInit(&parser.tree);
+    parser.baseDepth = senml_uriToIds(uriP, parser.baseIds);
+    recordsIndex = 0;
+    count = 0;
 
-    if (buffer[index] != '{') return -1;
+    if (!prv_skip(&parser, '{')) goto error;
     do
     {
-        _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
-        if (buffer[index] != '"') goto error;
-        if (index++ >= bufferLen) goto error;
-        switch (buffer[index])
-        {
-        case 'e':
+        _token_t key;
+        _token_t token;
+
+        if (!prv_readString(&parser, &key)
+         || key.isEscaped
+         || !prv_skip(&parser, ':'))
         {
-            int recordIndex;
+            goto error;
+        }
 
-            if (bufferLen-index < JSON_MIN_ARRAY_LEN) goto error;
-            index++;
-            if (buffer[index] != '"') goto error;
+        if (key.length == 1 && key.start[0] == 'e')
+        {
             if (eFound == true) goto error;
             eFound = true;
-
-            _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
-            if (buffer[index] != ':') goto error;
-            _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
-            if (buffer[index] != '[') goto error;
-            _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
-            count = prv_countItems(buffer + index, bufferLen - index);
-            if (count <= 0) goto error;
-            recordArray = (_record_t*)lwm2m_malloc(count * sizeof(_record_t));
-            if (recordArray == NULL) goto error;
-            // at this point we are sure buffer[index] is '{' and all { and } are matching
-            recordIndex = 0;
-            while (recordIndex < count)
+            recordsIndex = parser.index;
+            if (!prv_parseRecords(&parser))
             {
-                int itemLen;
-
-                if (buffer[index] != '{') goto error;
-                itemLen = 0;
-                while (buffer[index + itemLen] != '}') itemLen++;
-                if (0 != prv_parseItem(buffer + index + 1, itemLen - 1, recordArray + recordIndex))
-                {
-                    goto error;
-                }
-                recordIndex++;
-                index += itemLen;
-                _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
-                switch (buffer[index])
-                {
-                case ',':
-                    _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
-                    break;
-                case ']':
-                    if (recordIndex == count) break;
-                    // else this is an error
-                default:
-                    goto error;
-                }
-            }
-            if (buffer[index] != ']') goto error;
-        }
-        break;
-
-        case 'b':
-            if (bufferLen-index < JSON_MIN_BX_LEN) goto error;
-            index++;
-            switch (buffer[index])
-            {
-            case 't':
-                index++;
-                if (buffer[index] != '"') goto error;
-                if (btFound == true) goto error;
-                btFound = true;
-
-                // TODO: handle timed values
-                // temp: skip this token
-                while(index < bufferLen && buffer[index] != ',' && buffer[index] != '}') index++;
-                if (index == bufferLen) goto error;
-                index--;
-                // end temp
-                break;
-            case 'n':
-                {
-                    int next;
-                    int tokenStart;
-                    int tokenLen;
-                    int itemLen;
-
-                    index++;
-                    if (buffer[index] != '"') goto error;
-                    if (bnFound == true) goto error;
-                    bnFound = true;
-                    index -= 3;
-                    itemLen = 0;
-                    while (buffer[index + itemLen] != '}'
-                        && buffer[index + itemLen] != ','
-                        && index + itemLen < bufferLen)
-                    {
-                        itemLen++;
-                    }
-                    if (index + itemLen == bufferLen) goto error;
-                    next = prv_split(buffer+index, itemLen, &tokenStart, &tokenLen, &bnStart, &bnLen);
-                    if (next < 0) goto error;
-                    bnStart += index;
-                    index += next - 1;
-                }
-                break;
-            default:
-                goto error;
+                // the records may be relative to a base name following them
+                if (bnFound == true) goto error;
+                senml_treeFree(&parser.tree);
+                parser.index = recordsIndex;
+                if (!prv_skipArray(&parser)) goto error;
+                isDeferred = true;
             }
-            break;
-
-        default:
-            goto error;
-        }
-
-        _GO_TO_NEXT_CHAR(index, buffer, bufferLen);
-    } while (buffer[index] == ',');
-
-    if (buffer[index] != '}') goto error;
-
-    if (eFound == true)
-    {
-        lwm2m_uri_t baseURI;
-        lwm2m_uri_t * baseUriP;
-        lwm2m_data_t * resultP;
-        int size;
-
-        memset(&baseURI, 0, sizeof(lwm2m_uri_t));
-        if (bnFound == false)
-        {
-            baseUriP = uriP;
         }
-        else
+        else if (key.length == 2 && key.start[0] == 'b' && key.start[1] == 'n')
         {
-            int res;
-
-            // we ignore the request URI and use the bn one.
-
-            // Check for " around URI
-            if (bnLen < 3
-             || buffer[bnStart] != '"'
-             || buffer[bnStart+bnLen-1] != '"')
-            {
-                goto error;
-            }
-            bnStart += 1;
-            bnLen -= 2;
-
-            if (bnLen == 1)
+            if (bnFound == true) goto error;
+            bnFound = true;
+            if (!prv_readString(&parser, &token)) goto error;
+            if (!prv_parseBaseName(&parser, &token)) goto error;
+            if (eFound == true)
             {
-                if (buffer[bnStart] != '/') goto error;
-                baseUriP = NULL;
-            }
-            else
-            {
-                res = lwm2m_stringToUri((char *)buffer + bnStart, bnLen, &baseURI);
-                if (res < 0 || res != bnLen) goto error;
-                baseUriP = &baseURI;
+                size_t index;
+
+                // the records were read relative to the request URI
+                index = parser.index;
+                senml_treeFree(&parser.tree);
+                parser.index = recordsIndex;
+                if (!prv_parseRecords(&parser)) goto error;
+                parser.index = index;
+                isDeferred = false;
             }
         }
-
-        count = prv_convertRecord(baseUriP, recordArray, count, &parsedP);
-        lwm2m_free(recordArray);
-        recordArray = NULL;
-
-        if (count > 0 && uriP != NULL)
+        else if (key.length == 2 && key.start[0] == 'b' && key.start[1] == 't')
         {
-            if (parsedP->type != LWM2M_TYPE_OBJECT || parsedP->id != uriP->objectId) goto error;
-            if (!LWM2M_URI_IS_SET_INSTANCE(uriP))
-            {
-                size = parsedP->value.asChildren.count;
-                resultP = parsedP->value.asChildren.array;
-            }
-            else
-            {
-                int i;
-
-                resultP = NULL;
-                // be permissive and allow full object JSON when requesting for a single instance
-                for (i = 0 ; i < (int)parsedP->value.asChildren.count && resultP == NULL; i++)
-                {
-                    lwm2m_data_t * targetP;
-
-                    targetP = parsedP->value.asChildren.array + i;
-                    if (targetP->id == uriP->instanceId)
-                    {
-                        resultP = targetP->value.asChildren.array;
-                        size = targetP->value.asChildren.count;
-                    }
-                }
-                if (resultP == NULL) goto error;
-                if (LWM2M_URI_IS_SET_RESOURCE(uriP))
-                {
-                    lwm2m_data_t * resP;
-
-                    resP = NULL;
-                    for (i = 0 ; i < size && resP == NULL; i++)
-                    {
-                        lwm2m_data_t * targetP;
-
-                        targetP = resultP + i;
-                        if (targetP->id == uriP->resourceId)
-                        {
-                            if (targetP->type == LWM2M_TYPE_MULTIPLE_RESOURCE)
-                            {
-                                resP = targetP->value.asChildren.array;
-                                size = targetP->value.asChildren.count;
-                            }
-                            else
-                            {
-                                size = prv_dataStrip(1, targetP, &resP);
-                                if (size <= 0) goto error;
-                                lwm2m_data_free(count, parsedP);
-                                parsedP = NULL;
-                            }
-                        }
-                    }
-                    if (resP == NULL) goto error;
-                    resultP = resP;
-                }
-            }
+            if (btFound == true) goto error;
+            btFound = true;
+            // TODO: handle timed values
+            if (!prv_readValue(&parser, &token)) goto error;
         }
         else
         {
-            resultP = parsedP;
-            size = count;
+            goto error;
         }
+    } while (prv_skip(&parser, ','));
 
-        if (parsedP != NULL)
-        {
-            lwm2m_data_t * tempP;
+    if (!prv_skip(&parser, '}')) goto error;
+    if (isDeferred == true) goto error;
 
-            size = prv_dataStrip(size, resultP, &tempP);
-            if (size <= 0) goto error;
-            lwm2m_data_free(count, parsedP);
-            resultP = tempP;
-        }
-        count = size;
-        *dataP = resultP;
+    count = 0;
+    if (eFound == true)
+    {
+        count = senml_extractData(&parser.tree, uriP, dataP);
+        if (count <= 0) goto error;
+        senml_treeFree(&parser.tree);
     }
 
     LOG_ARG("Parsing successful. count: %d", count);
@@ -1017,41 +737,152 @@ int json_parse(lwm2m_uri_t * uriP,
 
 error:
     LOG("Parsing failed");
-    if (parsedP != NULL)
+    if (*dataP != NULL)
+    {
+        lwm2m_data_free(count, *dataP);
+        *dataP = NULL;
+    }
+    senml_treeFree(&parser.tree);
+    return -1;
+}
+
+static int prv_writeWindow(_writer_t * writerP,
+                           const uint8_t * data,
+                           size_t length)
+{
+    size_t start;
+
+    start = writerP->length;
+    writerP->length += length;
+    if (writerP->length <= writerP->offset) return 0;
+
+    if (start < writerP->offset)
     {
-        lwm2m_data_free(count, parsedP);
-        parsedP = NULL;
+        data += writerP->offset - start;
+        length -= writerP->offset - start;
     }
-    if (recordArray != NULL)
+    if (writerP->buffer.isStatic
+     && writerP->buffer.capacity - writerP->buffer.length < length)
     {
-        lwm2m_free(recordArray);
+        length = writerP->buffer.capacity - writerP->buffer.length;
     }
-    return -1;
+
+    return utils_bufferAppend(&writerP->buffer, data, length);
 }
 
-static int prv_serializeValue(lwm2m_data_t * tlvP,
-                              uint8_t * buffer,
-                              size_t bufferLen)
+// Kept small so that it is inlined and the copies of the constant strings are too.
+static inline int prv_write(_writer_t * writerP,
+                            const void * data,
+                            size_t length)
 {
-    int res;
-    int head;
+    if (writerP->length >= writerP->offset
+     && writerP->buffer.capacity - writerP->buffer.length >= length)
+    {
+        memcpy(writerP->buffer.data + writerP->buffer.length, data, length);
+        writerP->buffer.length += length;
+        writerP->length += length;
+        return 0;
+    }
 
-    switch (tlvP->type)
+    return prv_writeWindow(writerP, (const uint8_t *)data, length);
+}
+
+static int prv_writeBase64(_writer_t * writerP,
+                           uint8_t * dataP,
+                           size_t dataLen)
+{
+    uint8_t chunk[(PRV_JSON_B64_CHUNK_SIZE / 3) * 4];
+    size_t index;
+
+    for (index = 0 ; index < dataLen ; index += PRV_JSON_B64_CHUNK_SIZE)
     {
-    case LWM2M_TYPE_STRING:
-        if (bufferLen < JSON_ITEM_STRING_BEGIN_SIZE) return -1;
-        memcpy(buffer, JSON_ITEM_STRING_BEGIN, JSON_ITEM_STRING_BEGIN_SIZE);
-        head = JSON_ITEM_STRING_BEGIN_SIZE;
+        size_t length;
+        size_t res;
 
-        if (bufferLen - head < tlvP->value.asBuffer.length) return -1;
-        memcpy(buffer + head, tlvP->value.asBuffer.buffer, tlvP->value.asBuffer.length);
-        head += tlvP->value.asBuffer.length;
+        length = dataLen - index;
+        if (length > PRV_JSON_B64_CHUNK_SIZE) length = PRV_JSON_B64_CHUNK_SIZE;
 
-        if (bufferLen - head < JSON_ITEM_STRING_END_SIZE) return -1;
-        memcpy(buffer + head, JSON_ITEM_STRING_END, JSON_ITEM_STRING_END_SIZE);
-        head += JSON_ITEM_STRING_END_SIZE;
+        res = utils_base64Encode(dataP + index, length, chunk, sizeof(chunk));
+        if (res == 0) return -1;
+        if (prv_write(writerP, chunk, res) != 0) return -1;
+    }
 
-        break;
+    return 0;
+}
+
+// Writes the string, escaping the quotes, the backslashes and the control characters.
+static int prv_writeString(_writer_t * writerP,
+                           uint8_t * dataP,
+                           size_t dataLen)
+{
+    size_t start;
+    size_t i;
+
+    start = 0;
+    for (i = 0 ; i < dataLen ; i++)
+    {
+        uint8_t escaped[6];
+        size_t escapedLen;
+
+        if (dataP[i] >= 0x20 && dataP[i] != '"' && dataP[i] != '\\') continue;
+
+        if (i > start && prv_write(writerP, dataP + start, i - start) != 0) return -1;
+        start = i + 1;
+
+        escaped[0] = '\\';
+        escapedLen = 2;
+        switch (dataP[i])
+        {
+        case '"':
+        case '\\':
+            escaped[1] = dataP[i];
+            break;
+        case '\b':
+            escaped[1] = 'b';
+            break;
+        case '\f':
+            escaped[1] = 'f';
+            break;
+        case '\n':
+            escaped[1] = 'n';
+            break;
+        case '\r':
+            escaped[1] = 'r';
+            break;
+        case '\t':
+            escaped[1] = 't';
+            break;
+        default:
+            escaped[1] = 'u';
+            escaped[2] = '0';
+            escaped[3] = '0';
+            escaped[4] = (uint8_t)('0' + (dataP[i] >> 4));
+            escaped[5] = "0123456789ABCDEF"[dataP[i] & 0x0F];
+            escapedLen = 6;
+            break;
+        }
+        if (prv_write(writerP, escaped, escapedLen) != 0) return -1;
+    }
+    if (i > start && prv_write(writerP, dataP + start, i - start) != 0) return -1;
+
+    return 0;
+}
+
+static int prv_serializeValue(_writer_t * writerP,
+                              lwm2m_data_t * tlvP)
+{
+    uint8_t numberStr[PRV_JSON_NUMBER_MAX_LEN];
+    uint8_t * buffer;
+    size_t length;
+    int res;
+
+    switch (tlvP->type)
+    {
+    case LWM2M_TYPE_STRING:
+        if (prv_write(writerP, JSON_ITEM_STRING_BEGIN, JSON_ITEM_STRING_BEGIN_SIZE) != 0) return -1;
+        buffer = lwm2m_data_get_buffer(tlvP, &length);
+        if (prv_writeString(writerP, buffer, length) != 0) return -1;
+        return prv_write(writerP, JSON_ITEM_STRING_END, JSON_ITEM_STRING_END_SIZE);
 
     case LWM2M_TYPE_INTEGER:
     {
@@ -1059,19 +890,13 @@ static int prv_serializeValue(lwm2m_data_t * tlvP,
 
         if (0 == lwm2m_data_decode_int(tlvP, &value)) return -1;
 
-        if (bufferLen < JSON_ITEM_NUM_SIZE) return -1;
-        memcpy(buffer, JSON_ITEM_NUM, JSON_ITEM_NUM_SIZE);
-        head = JSON_ITEM_NUM_SIZE;
-
-        res = utils_intToText(value, buffer + head, bufferLen - head);
+        res = utils_intToText(value, numberStr, sizeof(numberStr));
         if (res <= 0) return -1;
-        head += res;
 
-        if (bufferLen - head < JSON_ITEM_NUM_END_SIZE) return -1;
-        memcpy(buffer + head, JSON_ITEM_NUM_END, JSON_ITEM_NUM_END_SIZE);
-        head += JSON_ITEM_NUM_END_SIZE;
+        if (prv_write(writerP, JSON_ITEM_NUM, JSON_ITEM_NUM_SIZE) != 0) return -1;
+        if (prv_write(writerP, numberStr, res) != 0) return -1;
+        return prv_write(writerP, JSON_ITEM_NUM_END, JSON_ITEM_NUM_END_SIZE);
     }
-    break;
 
     case LWM2M_TYPE_FLOAT:
     {
@@ -1079,19 +904,13 @@ static int prv_serializeValue(lwm2m_data_t * tlvP,
 
         if (0 == lwm2m_data_decode_float(tlvP, &value)) return -1;
 
-        if (bufferLen < JSON_ITEM_NUM_SIZE) return -1;
-        memcpy(buffer, JSON_ITEM_NUM, JSON_ITEM_NUM_SIZE);
-        head = JSON_ITEM_NUM_SIZE;
-
-        res = utils_floatToText(value, buffer + head, bufferLen - head);
+        res = utils_floatToText(value, numberStr, sizeof(numberStr));
         if (res <= 0) return -1;
-        head += res;
 
-        if (bufferLen - head < JSON_ITEM_NUM_END_SIZE) return -1;
-        memcpy(buffer + head, JSON_ITEM_NUM_END, JSON_ITEM_NUM_END_SIZE);
-        head += JSON_ITEM_NUM_END_SIZE;
+        if (prv_write(writerP, JSON_ITEM_NUM, JSON_ITEM_NUM_SIZE) != 0) return -1;
+        if (prv_write(writerP, numberStr, res) != 0) return -1;
+        return prv_write(writerP, JSON_ITEM_NUM_END, JSON_ITEM_NUM_END_SIZE);
     }
-    break;
 
     case LWM2M_TYPE_BOOLEAN:
     {
@@ -1101,32 +920,16 @@ static int prv_serializeValue(lwm2m_data_t * tlvP,
 
         if (value == true)
         {
-            if (bufferLen < JSON_ITEM_BOOL_TRUE_SIZE) return -1;
-            memcpy(buffer, JSON_ITEM_BOOL_TRUE, JSON_ITEM_BOOL_TRUE_SIZE);
-            head = JSON_ITEM_BOOL_TRUE_SIZE;
-        }
-        else
-        {
-            if (bufferLen < JSON_ITEM_BOOL_FALSE_SIZE) return -1;
-            memcpy(buffer, JSON_ITEM_BOOL_FALSE, JSON_ITEM_BOOL_FALSE_SIZE);
-            head = JSON_ITEM_BOOL_FALSE_SIZE;
+            return prv_write(writerP, JSON_ITEM_BOOL_TRUE, JSON_ITEM_BOOL_TRUE_SIZE);
         }
+        return prv_write(writerP, JSON_ITEM_BOOL_FALSE, JSON_ITEM_BOOL_FALSE_SIZE);
     }
-    break;
 
     case LWM2M_TYPE_OPAQUE:
-        if (bufferLen < JSON_ITEM_STRING_BEGIN_SIZE) return -1;
-        memcpy(buffer, JSON_ITEM_STRING_BEGIN, JSON_ITEM_STRING_BEGIN_SIZE);
-        head = JSON_ITEM_STRING_BEGIN_SIZE;
-
-        res = utils_base64Encode(tlvP->value.asBuffer.buffer, tlvP->value.asBuffer.length, buffer+head, bufferLen - head);
-        if (res == 0) return -1;
-        head += res;
-
-        if (bufferLen - head < JSON_ITEM_STRING_END_SIZE) return -1;
-        memcpy(buffer + head, JSON_ITEM_STRING_END, JSON_ITEM_STRING_END_SIZE);
-        head += JSON_ITEM_STRING_END_SIZE;
-        break;
+        if (prv_write(writerP, JSON_ITEM_STRING_BEGIN, JSON_ITEM_STRING_BEGIN_SIZE) != 0) return -1;
+        buffer = lwm2m_data_get_buffer(tlvP, &length);
+        if (prv_writeBase64(writerP, buffer, length) != 0) return -1;
+        return prv_write(writerP, JSON_ITEM_STRING_END, JSON_ITEM_STRING_END_SIZE);
 
     case LWM2M_TYPE_OBJECT_LINK:
         // TODO: implement
@@ -1135,21 +938,15 @@ static int prv_serializeValue(lwm2m_data_t * tlvP,
     default:
         return -1;
     }
-
-    return head;
 }
 
-int prv_serializeData(lwm2m_data_t * tlvP,
-                      uint8_t * parentUriStr,
-                      size_t parentUriLen,
-                      uint8_t * buffer,
-                      size_t bufferLen)
+static int prv_serializeData(_writer_t * writerP,
+                             lwm2m_data_t * tlvP,
+                             uint8_t * parentUriStr,
+                             size_t parentUriLen)
 {
-    int head;
     int res;
 
-    head = 0;
-
     switch (tlvP->type)
     {
     case LWM2M_TYPE_OBJECT:
@@ -1164,273 +961,129 @@ int prv_serializeData(lwm2m_data_t * tlvP,
         {
             if (URI_MAX_STRING_LEN < parentUriLen) return -1;
             memcpy(uriStr, parentUriStr, parentUriLen);
-            uriLen = parentUriLen;
-        }
-        else
-        {
-            uriLen = 0;
         }
+        uriLen = parentUriLen;
         res = utils_intToText(tlvP->id, uriStr + uriLen, URI_MAX_STRING_LEN - uriLen);
         if (res <= 0) return -1;
         uriLen += res;
+        if (uriLen >= URI_MAX_STRING_LEN) return -1;
         uriStr[uriLen] = '/';
         uriLen++;
 
-        head = 0;
         for (index = 0 ; index < tlvP->value.asChildren.count; index++)
         {
-            res = prv_serializeData(tlvP->value.asChildren.array + index, uriStr, uriLen, buffer + head, bufferLen - head);
-            if (res < 0) return -1;
-            head += res;
+            if (prv_serializeData(writerP, tlvP->value.asChildren.array + index, uriStr, uriLen) != 0) return -1;
         }
     }
     break;
 
     default:
-        if (bufferLen < JSON_RES_ITEM_URI_SIZE) return -1;
-        memcpy(buffer, JSON_RES_ITEM_URI, JSON_RES_ITEM_URI_SIZE);
-        head = JSON_RES_ITEM_URI_SIZE;
-
-        if (parentUriLen > 0)
-        {
-            if (bufferLen - head < parentUriLen) return -1;
-            memcpy(buffer + head, parentUriStr, parentUriLen);
-            head += parentUriLen;
-        }
-
-        res = utils_intToText(tlvP->id, buffer + head, bufferLen - head);
-        if (res <= 0) return -1;
-        head += res;
-
-        res = prv_serializeValue(tlvP, buffer + head, bufferLen - head);
-        if (res < 0) return -1;
-        head += res;
-        break;
-    }
-
-    return head;
-}
-
-static int prv_findAndCheckData(lwm2m_uri_t * uriP,
-                                uri_depth_t level,
-                                size_t size,
-                                lwm2m_data_t * tlvP,
-                                lwm2m_data_t ** targetP)
-{
-    size_t index;
-    int result;
-
-    if (size == 0) return 0;
-
-    if (size > 1)
-    {
-        if (tlvP[0].type == LWM2M_TYPE_OBJECT || tlvP[0].type == LWM2M_TYPE_OBJECT_INSTANCE)
-        {
-            for (index = 0; index < size; index++)
-            {
-                if (tlvP[index].type != tlvP[0].type)
-                {
-                    *targetP = NULL;
-                    return -1;
-                }
-            }
-        }
-        else
-        {
-            for (index = 0; index < size; index++)
-            {
-                if (tlvP[index].type == LWM2M_TYPE_OBJECT || tlvP[index].type == LWM2M_TYPE_OBJECT_INSTANCE)
-                {
-                    *targetP = NULL;
-                    return -1;
-                }
-            }
-        }
-    }
-
-    *targetP = NULL;
-    result = -1;
-    switch (level)
     {
-    case URI_DEPTH_OBJECT:
-        if (tlvP[0].type == LWM2M_TYPE_OBJECT)
-        {
-            *targetP = tlvP;
-            result = (int)size;
-        }
-        break;
+        uint8_t idStr[LWM2M_STRING_ID_MAX_LEN];
 
-    case URI_DEPTH_OBJECT_INSTANCE:
-        switch (tlvP[0].type)
-        {
-        case LWM2M_TYPE_OBJECT:
-            for (index = 0; index < size; index++)
-            {
-                if (tlvP[index].id == uriP->objectId)
-                {
-                    return prv_findAndCheckData(uriP, level, tlvP[index].value.asChildren.count, tlvP[index].value.asChildren.array, targetP);
-                }
-            }
-            break;
-        case LWM2M_TYPE_OBJECT_INSTANCE:
-            *targetP = tlvP;
-            result = (int)size;
-            break;
-        default:
-            break;
-        }
-        break;
+        res = utils_intToText(tlvP->id, idStr, LWM2M_STRING_ID_MAX_LEN);
+        if (res <= 0) return -1;
 
-    case URI_DEPTH_RESOURCE:
-        switch (tlvP[0].type)
+        if (writerP->itemCount > 0
+         && prv_write(writerP, JSON_ITEM_SEPARATOR, JSON_ITEM_SEPARATOR_SIZE) != 0)
         {
-        case LWM2M_TYPE_OBJECT:
-            for (index = 0; index < size; index++)
-            {
-                if (tlvP[index].id == uriP->objectId)
-                {
-                    return prv_findAndCheckData(uriP, level, tlvP[index].value.asChildren.count, tlvP[index].value.asChildren.array, targetP);
-                }
-            }
-            break;
-        case LWM2M_TYPE_OBJECT_INSTANCE:
-            for (index = 0; index < size; index++)
-            {
-                if (tlvP[index].id == uriP->instanceId)
-                {
-                    return prv_findAndCheckData(uriP, level, tlvP[index].value.asChildren.count, tlvP[index].value.asChildren.array, targetP);
-                }
-            }
-            break;
-        default:
-            *targetP = tlvP;
-            result = (int)size;
-            break;
+            return -1;
         }
-        break;
+        writerP->itemCount++;
 
-    case URI_DEPTH_RESOURCE_INSTANCE:
-        switch (tlvP[0].type)
+        if (prv_write(writerP, JSON_RES_ITEM_URI, JSON_RES_ITEM_URI_SIZE) != 0) return -1;
+        if (parentUriLen > 0
+         && prv_write(writerP, parentUriStr, parentUriLen) != 0)
         {
-        case LWM2M_TYPE_OBJECT:
-            for (index = 0; index < size; index++)
-            {
-                if (tlvP[index].id == uriP->objectId)
-                {
-                    return prv_findAndCheckData(uriP, level, tlvP[index].value.asChildren.count, tlvP[index].value.asChildren.array, targetP);
-                }
-            }
-            break;
-        case LWM2M_TYPE_OBJECT_INSTANCE:
-            for (index = 0; index < size; index++)
-            {
-                if (tlvP[index].id == uriP->instanceId)
-                {
-                    return prv_findAndCheckData(uriP, level, tlvP[index].value.asChildren.count, tlvP[index].value.asChildren.array, targetP);
-                }
-            }
-            break;
-        case LWM2M_TYPE_MULTIPLE_RESOURCE:
-            for (index = 0; index < size; index++)
-            {
-                if (tlvP[index].id == uriP->resourceId)
-                {
-                    return prv_findAndCheckData(uriP, level, tlvP[index].value.asChildren.count, tlvP[index].value.asChildren.array, targetP);
-                }
-            }
-            break;
-        default:
-            *targetP = tlvP;
-            result = (int)size;
-            break;
+            return -1;
         }
-        break;
-
-    default:
-        break;
+        if (prv_write(writerP, idStr, res) != 0) return -1;
+        if (prv_serializeValue(writerP, tlvP) != 0) return -1;
+    }
+    break;
     }
 
-    return result;
+    return 0;
 }
 
-int json_serialize(lwm2m_uri_t * uriP,
-                   int size,
-                   lwm2m_data_t * tlvP,
-                   uint8_t ** bufferP)
+static int prv_serialize(_writer_t * writerP,
+                         lwm2m_uri_t * uriP,
+                         int size,
+                         lwm2m_data_t * tlvP)
 {
     int index;
-    size_t head;
-    uint8_t bufferJSON[PRV_JSON_BUFFER_SIZE];
     uint8_t baseUriStr[URI_MAX_STRING_LEN];
     int baseUriLen;
-    uri_depth_t rootLevel;
     int num;
     lwm2m_data_t * targetP;
 
-    LOG_ARG("size: %d", size);
-    LOG_URI(uriP);
-    if (size != 0 && tlvP == NULL) return -1;
-
-    baseUriLen = uri_toString(uriP, baseUriStr, URI_MAX_STRING_LEN, &rootLevel);
-    if (baseUriLen < 0) return -1;
-
-    num = prv_findAndCheckData(uriP, rootLevel, size, tlvP, &targetP);
+    num = senml_findBaseName(uriP, size, tlvP, baseUriStr, &baseUriLen, &targetP);
     if (num < 0) return -1;
 
-    while (num == 1
-        && (targetP->type == LWM2M_TYPE_OBJECT
-         || targetP->type == LWM2M_TYPE_OBJECT_INSTANCE
-         || targetP->type == LWM2M_TYPE_MULTIPLE_RESOURCE))
-    {
-        int res;
-
-        res = utils_intToText(targetP->id, baseUriStr + baseUriLen, URI_MAX_STRING_LEN - baseUriLen);
-        if (res <= 0) return 0;
-        baseUriLen += res;
-        if (baseUriLen >= URI_MAX_STRING_LEN -1) return 0;
-        num = targetP->value.asChildren.count;
-        targetP = targetP->value.asChildren.array;
-        baseUriStr[baseUriLen] = '/';
-        baseUriLen++;
-    }
-
     if (baseUriLen > 0)
     {
-        memcpy(bufferJSON, JSON_BN_HEADER_1, JSON_BN_HEADER_1_SIZE);
-        head = JSON_BN_HEADER_1_SIZE;
-        memcpy(bufferJSON + head, baseUriStr, baseUriLen);
-        head += baseUriLen;
-        memcpy(bufferJSON + head, JSON_BN_HEADER_2, JSON_BN_HEADER_2_SIZE);
-        head += JSON_BN_HEADER_2_SIZE;
+        if (prv_write(writerP, JSON_BN_HEADER_1, JSON_BN_HEADER_1_SIZE) != 0) return -1;
+        if (prv_write(writerP, baseUriStr, baseUriLen) != 0) return -1;
+        if (prv_write(writerP, JSON_BN_HEADER_2, JSON_BN_HEADER_2_SIZE) != 0) return -1;
     }
     else
     {
-        memcpy(bufferJSON, JSON_HEADER, JSON_HEADER_SIZE);
-        head = JSON_HEADER_SIZE;
+        if (prv_write(writerP, JSON_HEADER, JSON_HEADER_SIZE) != 0) return -1;
     }
 
-    for (index = 0 ; index < num && head < PRV_JSON_BUFFER_SIZE ; index++)
+    for (index = 0 ; index < num ; index++)
     {
-        int res;
+        if (prv_serializeData(writerP, targetP + index, NULL, 0) != 0) return -1;
+    }
+
+    return prv_write(writerP, JSON_FOOTER, JSON_FOOTER_SIZE);
+}
+
+int json_serialize(lwm2m_uri_t * uriP,
+                   int size,
+                   lwm2m_data_t * tlvP,
+                   uint8_t ** bufferP)
+{
+    _writer_t writer;
+
+    memset(&writer, 0, sizeof(_writer_t));
+    utils_bufferInit(&writer.buffer, NULL, 0);
 
-        res = prv_serializeData(targetP + index, NULL, 0, bufferJSON + head, PRV_JSON_BUFFER_SIZE - head);
-        if (res < 0) return 0;
-        head += res;
+    *bufferP = NULL;
+    if (utils_bufferReserve(&writer.buffer, PRV_JSON_INITIAL_SIZE) != 0
+     || prv_serialize(&writer, uriP, size, tlvP) != 0)
+    {
+        utils_bufferFree(&writer.buffer);
+        return -1;
     }
 
-    if (head + JSON_FOOTER_SIZE - 1 > PRV_JSON_BUFFER_SIZE) return 0;
+    // the buffer becomes the payload as is
+    *bufferP = writer.buffer.data;
+
+    return (int)writer.buffer.length;
+}
+
+int json_serializeBlock(lwm2m_uri_t * uriP,
+                        int size,
+                        lwm2m_data_t * tlvP,
+                        size_t offset,
+                        uint8_t * buffer,
+                        size_t bufferLen,
+                        size_t * lengthP)
+{
+    _writer_t writer;
+
+    LOG_ARG("offset: %d, bufferLen: %d", offset, bufferLen);
 
-    if (num > 0) head = head - 1;
+    memset(&writer, 0, sizeof(_writer_t));
+    utils_bufferInit(&writer.buffer, buffer, bufferLen);
+    writer.offset = offset;
 
-    memcpy(bufferJSON + head, JSON_FOOTER, JSON_FOOTER_SIZE);
-    head = head + JSON_FOOTER_SIZE;
+    if (prv_serialize(&writer, uriP, size, tlvP) != 0) return -1;
 
-    *bufferP = (uint8_t *)lwm2m_malloc(head);
-    if (*bufferP == NULL) return 0;
-    memcpy(*bufferP, bufferJSON, head);
+    *lengthP = writer.length;
 
-    return head;
+    return (int)writer.buffer.length;
 }
 
 #endif
-
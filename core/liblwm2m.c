@@ -69,6 +69,27 @@ lwm2m_context_t * lwm2m_init(void * userData)
         contextP->userData = userData;
         srand((int)lwm2m_gettime());
         contextP->nextMID = rand();
+#ifdef LWM2M_SERVER_MODE
+        contextP->clientStore = clientstore_new();
+        if (contextP->clientStore == NULL)
+        {
+            lwm2m_close(contextP);
+            return NULL;
+        }
+#ifdef LWM2M_REGISTRATION_STORE
+        {
+            lwm2m_client_store_t * storeP;
+
+            storeP = store_open(contextP);
+            if (storeP == NULL)
+            {
+                lwm2m_close(contextP);
+                return NULL;
+            }
+            contextP->clientStore = storeP;
+        }
+#endif
+#endif
     }
 
     return contextP;
@@ -99,6 +120,8 @@ static void prv_deleteServer(lwm2m_server_t * serverP, void *userData)
         lwm2m_free(serverP->location);
     }
     free_block1_buffer(serverP->block1Data);
+    attributes_free(serverP);
+    acl_free(serverP);
     lwm2m_free(serverP);
 }
 
@@ -141,15 +164,10 @@ static void prv_deleteObservedList(lwm2m_context_t * contextP)
     while (NULL != contextP->observedList)
     {
         lwm2m_observed_t * targetP;
-        lwm2m_watcher_t * watcherP;
 
         targetP = contextP->observedList;
         contextP->observedList = contextP->observedList->next;
 
-        for (watcherP = targetP->watcherList ; watcherP != NULL ; watcherP = watcherP->next)
-        {
-            if (watcherP->parameters != NULL) lwm2m_free(watcherP->parameters);
-        }
         LWM2M_LIST_FREE(targetP->watcherList);
 
         lwm2m_free(targetP);
@@ -187,21 +205,37 @@ void lwm2m_close(lwm2m_context_t * contextP)
     {
         lwm2m_free(contextP->altPath);
     }
+    object_freeRegisterPayload(contextP);
+    lwm2m_index_clear(&contextP->objectIndex);
+#ifdef LWM2M_OBJECT_JOURNAL
+    journal_free(contextP);
+#endif
 
 #endif
 
 #ifdef LWM2M_SERVER_MODE
-    while (NULL != contextP->clientList)
+    if (NULL != contextP->clientStore)
     {
         lwm2m_client_t * clientP;
 
-        clientP = contextP->clientList;
-        contextP->clientList = contextP->clientList->next;
+        // the clients are released from the store as a whole
+        clientP = contextP->clientStore->nextClientFunc(NULL, contextP->clientStore);
+        while (NULL != clientP)
+        {
+            lwm2m_client_t * nextP;
 
-        registration_freeClient(contextP, clientP);
+            nextP = contextP->clientStore->nextClientFunc(clientP, contextP->clientStore);
+            registration_freeClient(contextP, clientP);
+            clientP = nextP;
+        }
+        contextP->clientStore->closeFunc(contextP->clientStore);
     }
 #endif
 
+#ifdef LWM2M_BOOTSTRAP_SERVER_MODE
+    bootstrap_free(contextP);
+#endif
+
     prv_deleteTransactionList(contextP);
     lwm2m_free(contextP);
 }
@@ -314,7 +348,10 @@ int lwm2m_configure(lwm2m_context_t * contextP,
     for (i = 0; i < numObject; i++)
     {
         objectList[i]->next = NULL;
-        contextP->objectList = (lwm2m_object_t *)LWM2M_LIST_ADD(contextP->objectList, objectList[i]);
+        if (0 != LWM2M_INDEX_ADD(&contextP->objectIndex, contextP->objectList, objectList[i]))
+        {
+            return COAP_500_INTERNAL_SERVER_ERROR;
+        }
     }
 
     return COAP_NO_ERROR;
@@ -326,11 +363,16 @@ int lwm2m_add_object(lwm2m_context_t * contextP,
     lwm2m_object_t * targetP;
 
     LOG_ARG("ID: %d", objectP->objID);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, objectP->objID);
+    targetP = object_find(contextP, objectP->objID);
     if (targetP != NULL) return COAP_406_NOT_ACCEPTABLE;
     objectP->next = NULL;
 
-    contextP->objectList = (lwm2m_object_t *)LWM2M_LIST_ADD(contextP->objectList, objectP);
+    if (0 != LWM2M_INDEX_ADD(&contextP->objectIndex, contextP->objectList, objectP))
+    {
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+    object_invalidateRegisterPayload(contextP);
+    if (objectP->objID == LWM2M_ACL_OBJECT_ID) acl_invalidate(contextP);
 
     if (contextP->state == STATE_READY)
     {
@@ -346,9 +388,11 @@ int lwm2m_remove_object(lwm2m_context_t * contextP,
     lwm2m_object_t * targetP;
 
     LOG_ARG("ID: %d", id);
-    contextP->objectList = (lwm2m_object_t *)LWM2M_LIST_RM(contextP->objectList, id, &targetP);
+    targetP = (lwm2m_object_t *)LWM2M_INDEX_RM(&contextP->objectIndex, contextP->objectList, id);
 
     if (targetP == NULL) return COAP_404_NOT_FOUND;
+    object_invalidateRegisterPayload(contextP);
+    if (id == LWM2M_ACL_OBJECT_ID) acl_invalidate(contextP);
 
     if (contextP->state == STATE_READY)
     {
@@ -412,11 +456,17 @@ next_step:
         switch (bootstrap_getStatus(contextP))
         {
         case STATE_BS_FINISHED:
+#ifdef LWM2M_OBJECT_JOURNAL
+            journal_commit(contextP);
+#endif
             contextP->state = STATE_INITIAL;
             goto next_step;
             break;
 
         case STATE_BS_FAILED:
+#ifdef LWM2M_OBJECT_JOURNAL
+            journal_rollback(contextP);
+#endif
             return COAP_503_SERVICE_UNAVAILABLE;
 
         default:
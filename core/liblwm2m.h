@@ -68,6 +68,9 @@ extern "C" {
 #ifndef LWM2M_SUPPORT_JSON
 #define LWM2M_SUPPORT_JSON
 #endif
+#ifndef LWM2M_SUPPORT_CBOR
+#define LWM2M_SUPPORT_CBOR
+#endif
 #endif
 
 #if defined(LWM2M_BOOTSTRAP) && defined(LWM2M_BOOTSTRAP_SERVER_MODE)
@@ -136,6 +139,39 @@ uint8_t lwm2m_buffer_send(void * sessionH, uint8_t * buffer, size_t length, void
 // userData: parameter to lwm2m_init()
 bool lwm2m_session_is_equal(void * session1, void * session2, void * userData);
 
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_OBJECT_JOURNAL)
+// persistent journal of the objects given to lwm2m_restore_objects(), an append-only log read by this function
+// Return the content of the log in *bufferP and *lengthP, which may be memory mapped. An empty or missing log
+// is not an error. Returns 0 or -1 if the log can not be read.
+// userData: parameter to lwm2m_init()
+int lwm2m_journal_open(uint8_t ** bufferP, size_t * lengthP, void * userData);
+// Release the content returned by lwm2m_journal_open()
+void lwm2m_journal_close(uint8_t * buffer, size_t length, void * userData);
+// Append data at the end of the log. Returns 0 or -1 in case of error.
+int lwm2m_journal_append(uint8_t * buffer, size_t length, void * userData);
+// Replace atomically the whole content of the log. Returns 0 or -1 in case of error.
+int lwm2m_journal_replace(uint8_t * buffer, size_t length, void * userData);
+#endif
+
+#if defined(LWM2M_SERVER_MODE) && defined(LWM2M_REGISTRATION_STORE)
+// persistent registration store, an append-only log read at lwm2m_init()
+// Return the content of the log in *bufferP and *lengthP, which may be memory mapped. An empty or missing log
+// is not an error. Returns 0 or -1 if the log can not be read.
+// userData: parameter to lwm2m_init()
+int lwm2m_store_open(uint8_t ** bufferP, size_t * lengthP, void * userData);
+// Release the content returned by lwm2m_store_open()
+void lwm2m_store_close(uint8_t * buffer, size_t length, void * userData);
+// Append data at the end of the log. Returns 0 or -1 in case of error.
+int lwm2m_store_append(uint8_t * buffer, size_t length, void * userData);
+// Replace atomically the whole content of the log. Returns 0 or -1 in case of error.
+// buffer may be the content returned by lwm2m_store_open(), before lwm2m_store_close() is called.
+int lwm2m_store_replace(uint8_t * buffer, size_t length, void * userData);
+// Write the address of the peer of a session in buffer. Returns the number of bytes written, 0 in case of error.
+size_t lwm2m_session_save(void * sessionH, uint8_t * buffer, size_t length, void * userData);
+// Return a session handle to the peer address written by lwm2m_session_save() or NULL in case of error.
+void * lwm2m_session_restore(uint8_t * buffer, size_t length, void * userData);
+#endif
+
 /*
  * Error code
  */
@@ -157,6 +193,7 @@ bool lwm2m_session_is_equal(void * session1, void * session2, void * userData);
 #define COAP_408_REQ_ENTITY_INCOMPLETE  (uint8_t)0x88
 #define COAP_412_PRECONDITION_FAILED    (uint8_t)0x8C
 #define COAP_413_ENTITY_TOO_LARGE       (uint8_t)0x8D
+#define COAP_415_UNSUPPORTED_CONTENT_FORMAT (uint8_t)0x8F
 #define COAP_500_INTERNAL_SERVER_ERROR  (uint8_t)0xA0
 #define COAP_501_NOT_IMPLEMENTED        (uint8_t)0xA1
 #define COAP_503_SERVICE_UNAVAILABLE    (uint8_t)0xA3
@@ -237,6 +274,47 @@ void lwm2m_list_free(lwm2m_list_t * head);
 #define LWM2M_LIST_FIND(H,I) lwm2m_list_find((lwm2m_list_t *)H, I)
 #define LWM2M_LIST_FREE(H) lwm2m_list_free((lwm2m_list_t *)H)
 
+/*
+ * Index of the nodes of a list, for fast lookups in large lists.
+ * By default, the index is a sorted array of the nodes: O(log n) lookups and new IDs.
+ * When LWM2M_INDEX_DIRECT_MAP is defined, the index maps the IDs directly to the nodes
+ * using pages allocated on use: O(1) lookups for a higher memory usage.
+ * The index does not own the nodes. Once a list is indexed, nodes must only be
+ * added or removed through lwm2m_index_add() and lwm2m_index_remove() which keep
+ * the list and the index consistent.
+ * An index must be zeroed before its first use.
+ */
+
+typedef struct
+{
+#ifdef LWM2M_INDEX_DIRECT_MAP
+    struct _lwm2m_index_page_t ** pages;
+#else
+    lwm2m_list_t ** nodes;  // sorted by ID
+    size_t          capacity;
+#endif
+    size_t          count;
+} lwm2m_list_index_t;
+
+// defined in list.c
+// Index the existing list 'head'. Return 0 or -1 in case of memory allocation failure.
+int lwm2m_index_build(lwm2m_list_index_t * indexP, lwm2m_list_t * head);
+// Add 'node' to the index and to the list '*headP'. Return 0 or -1 if the ID is already used or memory allocation failed.
+int lwm2m_index_add(lwm2m_list_index_t * indexP, lwm2m_list_t ** headP, lwm2m_list_t * node);
+// Return the node with ID 'id' or NULL if not found
+lwm2m_list_t * lwm2m_index_find(lwm2m_list_index_t * indexP, uint16_t id);
+// Remove the node with ID 'id' from the index and from the list '*headP' and return it or NULL if not found
+lwm2m_list_t * lwm2m_index_remove(lwm2m_list_index_t * indexP, lwm2m_list_t ** headP, uint16_t id);
+// Return the lowest unused ID
+uint16_t lwm2m_index_newId(lwm2m_list_index_t * indexP);
+// Release the memory used by the index. The nodes are not freed.
+void lwm2m_index_clear(lwm2m_list_index_t * indexP);
+
+#define LWM2M_INDEX_ADD(X,H,N) lwm2m_index_add(X, (lwm2m_list_t **)&(H), (lwm2m_list_t *)(N))
+#define LWM2M_INDEX_RM(X,H,I) lwm2m_index_remove(X, (lwm2m_list_t **)&(H), I)
+#define LWM2M_INDEX_FIND(X,I) lwm2m_index_find(X, I)
+#define LWM2M_INDEX_NEWID(X) lwm2m_index_newId(X)
+
 /*
  * URI
  *
@@ -281,8 +359,25 @@ int lwm2m_stringToUri(const char * buffer, size_t buffer_len, lwm2m_uri_t * uriP
  * - LWM2M_TYPE_BOOLEAN: value.asBoolean
  *
  * LWM2M_TYPE_STRING is also used when the data is in text format.
+ *
+ * When flags has LWM2M_DATA_FLAG_BORROWED set, value.asBuffer points into memory owned by someone else
+ * (e.g. the received CoAP payload) and is not freed by lwm2m_data_free(). For a LWM2M_TYPE_MULTIPLE_RESOURCE
+ * set by lwm2m_data_encode_instances_borrowed(), lwm2m_data_free() frees neither value.asChildren.array
+ * nor the values it holds.
+ *
+ * IMPORTANT: lwm2m_data_encode_string(), lwm2m_data_encode_nstring() and lwm2m_data_encode_opaque()
+ * store values of up to LWM2M_DATA_INLINE_SIZE bytes (15 on 64-bit platforms, 7 on 32-bit ones) in
+ * value.asInline, and set LWM2M_DATA_FLAG_INLINE in flags. value.asBuffer is then not valid: read
+ * such values with lwm2m_data_get_buffer(). The values given to the callbacks of the objects by the
+ * core are never stored inline. A lwm2m_data_t can be copied with memcpy() or an assignment.
+ * Define LWM2M_DATA_NO_INLINE to store all the values in value.asBuffer.
  */
 
+#define LWM2M_DATA_INLINE_SIZE      (sizeof(size_t) + sizeof(uint8_t *) - 1)
+
+#define LWM2M_DATA_FLAG_BORROWED    0x01
+#define LWM2M_DATA_FLAG_INLINE      0x02
+
 typedef enum
 {
     LWM2M_TYPE_UNDEFINED = 0,
@@ -305,6 +400,7 @@ struct _lwm2m_data_t
 {
     lwm2m_data_type_t type;
     uint16_t    id;
+    uint8_t     flags;
     union
     {
         bool        asBoolean;
@@ -316,6 +412,11 @@ struct _lwm2m_data_t
             uint8_t * buffer;
         } asBuffer;
         struct
+        {
+            uint8_t   buffer[LWM2M_DATA_INLINE_SIZE];
+            uint8_t   length;
+        } asInline;
+        struct
         {
             size_t         count;
             lwm2m_data_t * array;
@@ -333,6 +434,8 @@ typedef enum
     LWM2M_CONTENT_TEXT      = 0,        // Also used as undefined
     LWM2M_CONTENT_LINK      = 40,
     LWM2M_CONTENT_OPAQUE    = 42,
+    LWM2M_CONTENT_CBOR      = 60,       // single resource value
+    LWM2M_CONTENT_SENML_CBOR = 112,
     LWM2M_CONTENT_TLV_OLD   = 1542,     // Keep old value for backward-compatibility
     LWM2M_CONTENT_TLV       = 11542,
     LWM2M_CONTENT_JSON_OLD  = 1543,     // Keep old value for backward-compatibility
@@ -341,12 +444,27 @@ typedef enum
 
 lwm2m_data_t * lwm2m_data_new(int size);
 int lwm2m_data_parse(lwm2m_uri_t * uriP, uint8_t * buffer, size_t bufferLen, lwm2m_media_type_t format, lwm2m_data_t ** dataP);
+// Same as lwm2m_data_parse() but TLV, text and opaque values point into buffer instead of being copied.
+// buffer must outlive the returned data.
+int lwm2m_data_parse_borrowed(lwm2m_uri_t * uriP, uint8_t * buffer, size_t bufferLen, lwm2m_media_type_t format, lwm2m_data_t ** dataP);
 int lwm2m_data_serialize(lwm2m_uri_t * uriP, int size, lwm2m_data_t * dataP, lwm2m_media_type_t * formatP, uint8_t ** bufferP);
+// Same as lwm2m_data_serialize() but writes into the caller's buffer, e.g. a CoAP payload area. Returns -1 if it does not fit.
+int lwm2m_data_serialize_into(lwm2m_uri_t * uriP, int size, lwm2m_data_t * dataP, lwm2m_media_type_t * formatP, uint8_t * buffer, size_t bufferLen);
+// Write the bytes of the serialized data starting at offset, e.g. a Block2 chunk, in buffer. lengthP receives the length
+// of the whole serialized data. Returns the number of bytes written in buffer or -1 in case of error.
+int lwm2m_data_serialize_block(lwm2m_uri_t * uriP, int size, lwm2m_data_t * dataP, lwm2m_media_type_t * formatP, size_t offset, uint8_t * buffer, size_t bufferLen, size_t * lengthP);
 void lwm2m_data_free(int size, lwm2m_data_t * dataP);
+// Returns the value of a LWM2M_TYPE_STRING or LWM2M_TYPE_OPAQUE data, stored inline or not, and its length in lengthP.
+uint8_t * lwm2m_data_get_buffer(const lwm2m_data_t * dataP, size_t * lengthP);
 
 void lwm2m_data_encode_string(const char * string, lwm2m_data_t * dataP);
 void lwm2m_data_encode_nstring(const char * string, size_t length, lwm2m_data_t * dataP);
 void lwm2m_data_encode_opaque(uint8_t * buffer, size_t length, lwm2m_data_t * dataP);
+// Same as the above but the value points to the caller's memory instead of being copied.
+// The memory must stay valid and unchanged until the data is freed.
+void lwm2m_data_encode_string_borrowed(const char * string, lwm2m_data_t * dataP);
+void lwm2m_data_encode_nstring_borrowed(const char * string, size_t length, lwm2m_data_t * dataP);
+void lwm2m_data_encode_opaque_borrowed(uint8_t * buffer, size_t length, lwm2m_data_t * dataP);
 void lwm2m_data_encode_int(int64_t value, lwm2m_data_t * dataP);
 int lwm2m_data_decode_int(const lwm2m_data_t * dataP, int64_t * valueP);
 void lwm2m_data_encode_float(double value, lwm2m_data_t * dataP);
@@ -355,6 +473,7 @@ void lwm2m_data_encode_bool(bool value, lwm2m_data_t * dataP);
 int lwm2m_data_decode_bool(const lwm2m_data_t * dataP, bool * valueP);
 void lwm2m_data_encode_objlink(uint16_t objectId, uint16_t objectInstanceId, lwm2m_data_t * dataP);
 void lwm2m_data_encode_instances(lwm2m_data_t * subDataP, size_t count, lwm2m_data_t * dataP);
+void lwm2m_data_encode_instances_borrowed(lwm2m_data_t * subDataP, size_t count, lwm2m_data_t * dataP);
 void lwm2m_data_include(lwm2m_data_t * subDataP, size_t count, lwm2m_data_t * dataP);
 
 
@@ -408,6 +527,7 @@ struct _lwm2m_object_t
     lwm2m_delete_callback_t   deleteFunc;
     lwm2m_discover_callback_t discoverFunc;
     void * userData;
+    lwm2m_list_index_t * instanceIndex;      // optional index of instanceList. If NULL, instanceList is walked.
 };
 
 /*
@@ -474,7 +594,12 @@ typedef struct _lwm2m_server_
     lwm2m_status_t          status;
     char *                  location;
     bool                    dirty;
+    bool                    sleeping;     // queue mode only: notifications are held back until the client wakes up
+    uint32_t                payloadVersion; // version of the object list last accepted by this server, 0 if none
+    uint32_t                sentVersion;    // version of the object list of the registration request in flight
     lwm2m_block1_data_t *   block1Data;   // buffer to handle block1 data, should be replace by a list to support several block1 transfer by server.
+    struct _lwm2m_attribute_store_ * attributes; // for internal use only: attributes set by this server with Write-Attributes
+    struct _lwm2m_acl_cache_ *       acl;        // for internal use only: rights of this server compiled from the Access Control Object
 } lwm2m_server_t;
 
 
@@ -504,6 +629,7 @@ typedef struct _lwm2m_observation_
     lwm2m_result_callback_t callback;
     void *                  userData;
     uint32_t                pendingTransactions;
+    struct _lwm2m_context_ * contextP;  // for internal use only: to update the client store
 } lwm2m_observation_t;
 
 /*
@@ -554,6 +680,8 @@ struct _lwm2m_transaction_
     uint8_t * buffer;
     lwm2m_transaction_callback_t callback;
     void * userData;
+    time_t queue_time;                  // date the transaction was queued for a client in queue mode
+    lwm2m_transaction_t * coalesced;    // queued duplicates completed along with this transaction
 };
 
 /*
@@ -562,13 +690,17 @@ struct _lwm2m_transaction_
  * Be careful not to mix lwm2m_client_object_t used to store list of objects of remote clients
  * and lwm2m_object_t describing objects exposed to remote servers.
  *
+ * The objects and object instances listed by a client are stored in an array sorted by object ID
+ * then instance ID. An object listed without any instance has a single entry with the instance ID
+ * LWM2M_MAX_ID.
+ * The name, the MSISDN and the object list are stored in the same allocation as the lwm2m_client_t
+ * when they fit. The type and the alternate path are shared by the clients and must not be modified.
  */
 
-typedef struct _lwm2m_client_object_
+typedef struct
 {
-    struct _lwm2m_client_object_ * next; // matches lwm2m_list_t::next
-    uint16_t                 id;         // matches lwm2m_list_t::id
-    lwm2m_list_t *           instanceList;
+    uint16_t objectId;
+    uint16_t instanceId;    // LWM2M_MAX_ID for an object listed without instance
 } lwm2m_client_object_t;
 
 typedef struct _lwm2m_client_
@@ -581,14 +713,66 @@ typedef struct _lwm2m_client_
     char *                  msisdn;
     char *                  altPath;
     bool                    supportJSON;
+    bool                    supportSenMLCBOR;
     uint32_t                lifetime;
     time_t                  endOfLife;
     void *                  sessionH;
-    lwm2m_client_object_t * objectList;
+    lwm2m_client_object_t * objects;        // sorted by object ID then instance ID
+    size_t                  objectCount;
+    size_t                  capacity;       // for internal use only: size of the storage following the structure
+    uint32_t                objectListHash; // hash of the last object list received from the client
     lwm2m_observation_t *   observationList;
     lwm2m_transaction_t *   queuedTransactionList;
+    bool                    queueDraining;  // the client woke up and its queued transactions are being sent
 } lwm2m_client_t;
 
+/*
+ * LWM2M Client store
+ *
+ * Storage of the clients registered to a server and of the observations they confirmed. The core
+ * allocates and frees the lwm2m_client_t and the lwm2m_observation_t: the store indexes them and may
+ * keep them elsewhere. The observations also stay in the observationList of their client.
+ * The default store is in memory, indexed by internal ID and by name. With LWM2M_REGISTRATION_STORE,
+ * the default store also writes its records to the log of the lwm2m_store_*() functions.
+ *
+ * addClientFunc is called with a complete client not yet in the store, updateClientFunc when the
+ * registration of a client in the store changed. The name of a client does not change.
+ * nextClientFunc returns the client following clientP or the first one when clientP is NULL.
+ * addObservationFunc is called each time the client confirms an observation, findObservationFunc
+ * with the IDs carried by the token of a notification.
+ * closeFunc releases the store, not the clients.
+ */
+
+typedef struct _lwm2m_client_store_t lwm2m_client_store_t;
+
+typedef int (*lwm2m_store_add_client_callback_t) (lwm2m_client_t * clientP, lwm2m_client_store_t * storeP);
+typedef void (*lwm2m_store_update_client_callback_t) (lwm2m_client_t * clientP, lwm2m_client_store_t * storeP);
+typedef lwm2m_client_t * (*lwm2m_store_find_client_callback_t) (uint16_t internalID, lwm2m_client_store_t * storeP);
+typedef lwm2m_client_t * (*lwm2m_store_find_name_callback_t) (const char * name, size_t nameLength, lwm2m_client_store_t * storeP);
+typedef lwm2m_client_t * (*lwm2m_store_remove_client_callback_t) (uint16_t internalID, lwm2m_client_store_t * storeP);
+typedef lwm2m_client_t * (*lwm2m_store_next_client_callback_t) (lwm2m_client_t * clientP, lwm2m_client_store_t * storeP);
+typedef uint16_t (*lwm2m_store_new_id_callback_t) (lwm2m_client_store_t * storeP);
+typedef int (*lwm2m_store_add_observation_callback_t) (lwm2m_observation_t * observationP, lwm2m_client_store_t * storeP);
+typedef lwm2m_observation_t * (*lwm2m_store_find_observation_callback_t) (lwm2m_client_t * clientP, uint16_t id, lwm2m_client_store_t * storeP);
+typedef void (*lwm2m_store_remove_observation_callback_t) (lwm2m_observation_t * observationP, lwm2m_client_store_t * storeP);
+typedef void (*lwm2m_store_close_callback_t) (lwm2m_client_store_t * storeP);
+
+struct _lwm2m_client_store_t
+{
+    lwm2m_store_add_client_callback_t         addClientFunc;
+    lwm2m_store_update_client_callback_t      updateClientFunc;
+    lwm2m_store_find_client_callback_t        findClientFunc;
+    lwm2m_store_find_name_callback_t          findNameFunc;
+    lwm2m_store_remove_client_callback_t      removeClientFunc;
+    lwm2m_store_next_client_callback_t        nextClientFunc;
+    lwm2m_store_new_id_callback_t             newIdFunc;
+    lwm2m_store_add_observation_callback_t    addObservationFunc;
+    lwm2m_store_find_observation_callback_t   findObservationFunc;
+    lwm2m_store_remove_observation_callback_t removeObservationFunc;
+    lwm2m_store_close_callback_t              closeFunc;
+    void * userData;
+};
+
 /*
  * LWM2M observed resources
  */
@@ -598,8 +782,8 @@ typedef struct _lwm2m_watcher_
 
     bool active;
     bool update;
+    bool pending;   // notification held back while the server is sleeping
     lwm2m_server_t * server;
-    lwm2m_attributes_t * parameters;
     lwm2m_media_type_t format;
     uint8_t token[8];
     size_t tokenLen;
@@ -649,7 +833,7 @@ typedef enum
 typedef int (*lwm2m_bootstrap_callback_t) (void * sessionH, uint8_t status, lwm2m_uri_t * uriP, char * name, void * userData);
 #endif
 
-typedef struct
+typedef struct _lwm2m_context_
 {
 #ifdef LWM2M_CLIENT_MODE
     lwm2m_client_state_t state;
@@ -659,16 +843,28 @@ typedef struct
     lwm2m_server_t *     bootstrapServerList;
     lwm2m_server_t *     serverList;
     lwm2m_object_t *     objectList;
+    lwm2m_list_index_t   objectIndex;               // objectList sorted by ID
     lwm2m_observed_t *   observedList;
+    uint8_t *            registrationPayload;       // cached object list sent to the servers
+    size_t               registrationPayloadLength;
+    bool                 registrationPayloadOutdated;
+    uint32_t             registrationPayloadVersion; // changed each time the content of the object list changes
+#ifdef LWM2M_OBJECT_JOURNAL
+    struct _lwm2m_journal_ * journalP;              // for internal use only: state of the objects journal
+#endif
 #endif
 #ifdef LWM2M_SERVER_MODE
-    lwm2m_client_t *        clientList;
+    lwm2m_client_store_t *  clientStore;
+    struct _lwm2m_shared_string_ * sharedStrings; // for internal use only: types and alternate paths of the clients
     lwm2m_result_callback_t monitorCallback;
     void *                  monitorUserData;
+    lwm2m_result_callback_t dataPushCallback;
+    void *                  dataPushUserData;
 #endif
 #ifdef LWM2M_BOOTSTRAP_SERVER_MODE
     lwm2m_bootstrap_callback_t bootstrapCallback;
     void *                     bootstrapUserData;
+    lwm2m_transaction_t *      bootstrapQueue;     // commands waiting for their turn in a client's window
 #endif
     uint16_t                nextMID;
     lwm2m_transaction_t *   transactionList;
@@ -694,13 +890,34 @@ void lwm2m_handle_packet(lwm2m_context_t * contextP, uint8_t * buffer, int lengt
 int lwm2m_configure(lwm2m_context_t * contextP, const char * endpointName, const char * msisdn, const char * altPath, uint16_t numObject, lwm2m_object_t * objectList[]);
 int lwm2m_add_object(lwm2m_context_t * contextP, lwm2m_object_t * objectP);
 int lwm2m_remove_object(lwm2m_context_t * contextP, uint16_t id);
+#ifdef LWM2M_OBJECT_JOURNAL
+// replace the instances of the objects with the IDs in objectIds by the ones saved in the journal of the
+// lwm2m_journal_*() functions, or save the current ones if the journal is empty. The changes made to these
+// instances by the servers and the ones notified by lwm2m_resource_value_changed() are then saved in the journal.
+// The objects must be configured and have read, create and delete callbacks. A failed bootstrap restores them.
+int lwm2m_restore_objects(lwm2m_context_t * contextP, uint16_t numObject, const uint16_t objectIds[]);
+#endif
 
 // send a registration update to the server specified by the server short identifier
 // or all if the ID is 0.
-// If withObjects is true, the registration update contains the object list.
+// If withObjects is true, the object list is rebuilt. In any case, the registration update contains
+// the object list only if it changed since the last registration or update sent to the server.
 int lwm2m_update_registration(lwm2m_context_t * contextP, uint16_t shortServerID, bool withObjects);
 
+// notify the library of a local change of a value. A change in the Access Control Object
+// (ID 2) also updates the access rights of the servers.
 void lwm2m_resource_value_changed(lwm2m_context_t * contextP, lwm2m_uri_t * uriP);
+
+// mark the client as sleeping or awake towards the server specified by the server short identifier
+// or all if the ID is 0. Only servers with a queue mode binding (UQ, SQ, UQS) are affected.
+// While sleeping, notifications are collected and they are sent in a single burst on wake up.
+int lwm2m_set_sleeping(lwm2m_context_t * contextP, uint16_t shortServerID, bool sleeping);
+
+#ifdef LWM2M_SUPPORT_CBOR
+// push the values at the count URIs of urisP to the server specified by the server short identifier
+// or all if the ID is 0, in a single SenML CBOR message. Missing URIs are left out.
+int lwm2m_send(lwm2m_context_t * contextP, uint16_t shortServerID, lwm2m_uri_t * urisP, int count);
+#endif
 #endif
 
 #ifdef LWM2M_SERVER_MODE
@@ -709,9 +926,17 @@ void lwm2m_resource_value_changed(lwm2m_context_t * contextP, lwm2m_uri_t * uriP
 // When a LWM2M client deregisters, the callback is called with status COAP_202_DELETED.
 // clientID is the internal ID of the LWM2M Client.
 // The callback's parameters uri, data, dataLength are always NULL.
-// The lwm2m_client_t is present in the lwm2m_context_t's clientList when the callback is called. On a deregistration, it deleted when the callback returns.
+// The lwm2m_client_t is present in the lwm2m_context_t's clientStore when the callback is called. On a deregistration, it deleted when the callback returns.
 void lwm2m_set_monitoring_callback(lwm2m_context_t * contextP, lwm2m_result_callback_t callback, void * userData);
 
+// Replace the store of the clients. No client must be registered. The previous store is closed and storeP
+// is closed by lwm2m_close().
+int lwm2m_set_client_store(lwm2m_context_t * contextP, lwm2m_client_store_t * storeP);
+
+// Data pushed by the clients with the Send operation.
+// The callback is called with a NULL uri, status COAP_204_CHANGED and the SenML payload which holds full URIs.
+void lwm2m_set_data_push_callback(lwm2m_context_t * contextP, lwm2m_result_callback_t callback, void * userData);
+
 // Device Management APIs
 int lwm2m_dm_read(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t * uriP, lwm2m_result_callback_t callback, void * userData);
 int lwm2m_dm_discover(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t * uriP, lwm2m_result_callback_t callback, void * userData);
@@ -720,10 +945,32 @@ int lwm2m_dm_write_attributes(lwm2m_context_t * contextP, uint16_t clientID, lwm
 int lwm2m_dm_execute(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t * uriP, lwm2m_media_type_t format, uint8_t * buffer, int length, lwm2m_result_callback_t callback, void * userData);
 int lwm2m_dm_create(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t * uriP, lwm2m_media_type_t format, uint8_t * buffer, int length, lwm2m_result_callback_t callback, void * userData);
 int lwm2m_dm_delete(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t * uriP, lwm2m_result_callback_t callback, void * userData);
+#ifdef LWM2M_SUPPORT_CBOR
+// Read-Composite and Write-Composite in SenML CBOR: the values at the count URIs of urisP are read in a
+// single request. The callback is called once with a NULL uriP.
+// A client checks that all the targets of a Write-Composite exist and are writable before writing any of them.
+// Values refused by an object are not rolled back: the instances written before it keep their new values.
+int lwm2m_dm_read_composite(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t * urisP, int count, lwm2m_result_callback_t callback, void * userData);
+int lwm2m_dm_write_composite(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_media_type_t format, uint8_t * buffer, int length, lwm2m_result_callback_t callback, void * userData);
+#endif
 
 // Information Reporting APIs
+// For a queue mode client, an observe request identical to one waiting for the client to wake up returns
+// COAP_412_PRECONDITION_FAILED if it has another callback or userData, and is ignored otherwise.
 int lwm2m_observe(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t * uriP, lwm2m_result_callback_t callback, void * userData);
 int lwm2m_observe_cancel(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_uri_t * uriP, lwm2m_result_callback_t callback, void * userData);
+
+#ifdef LWM2M_REGISTRATION_STORE
+// To be implemented by the platform: the observations are kept in the registration store with an identity
+// of their subscriber.
+// Write in buffer the identity of the subscriber given the callback and callbackData passed to lwm2m_observe().
+// Returns the number of bytes written or -1 if the observation must not be kept in the store.
+// userData: parameter to lwm2m_init()
+int lwm2m_observation_save(lwm2m_result_callback_t callback, void * callbackData, uint8_t * buffer, size_t length, void * userData);
+// Set the callback and its data of an observation restored with the identity written by lwm2m_observation_save().
+// Returns false to drop the observation.
+bool lwm2m_observation_restore(uint16_t clientID, lwm2m_uri_t * uriP, uint8_t * buffer, size_t length, lwm2m_result_callback_t * callbackP, void ** callbackDataP, void * userData);
+#endif
 #endif
 
 #ifdef LWM2M_BOOTSTRAP_SERVER_MODE
@@ -732,6 +979,10 @@ int lwm2m_observe_cancel(lwm2m_context_t * contextP, uint16_t clientID, lwm2m_ur
 void lwm2m_set_bootstrap_callback(lwm2m_context_t * contextP, lwm2m_bootstrap_callback_t callback, void * userData);
 
 // Boostrap Interface APIs
+// Commands to a client are sent in order, with up to LWM2M_BOOTSTRAP_WINDOW commands outstanding. Consecutive writes
+// or deletes are pipelined, other commands wait for the previous ones to complete. Bootstrap-Finish is sent alone.
+// If a command fails, the commands still waiting for this client are cancelled and their callbacks are called with
+// COAP_503_SERVICE_UNAVAILABLE.
 // if uriP is nil, a "Delete /" is sent to the client
 int lwm2m_bootstrap_delete(lwm2m_context_t * contextP, void * sessionH, lwm2m_uri_t * uriP);
 int lwm2m_bootstrap_write(lwm2m_context_t * contextP, void * sessionH, lwm2m_uri_t * uriP, lwm2m_media_type_t format, uint8_t * buffer, size_t length);
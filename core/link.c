@@ -0,0 +1,145 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * CoRE link format (RFC 6690) writer shared by the Discover responses and the registration payload.
+ * The links are appended in a single pass to a utils_buffer_t, growing as needed or bounded by the
+ * caller's buffer, each one followed by a delimiter which link_finish() removes after the last link.
+ * Large payloads are split in Block2 blocks by the CoAP layer.
+ */
+
+#include "internals.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+#define PRV_INT_MAX_STRING_LEN  20      // -9223372036854775808
+
+// Kept small so that it is inlined, most writes being a few bytes long.
+static inline int prv_append(utils_buffer_t * bufferP,
+                             const void * data,
+                             size_t length)
+{
+    if (bufferP->capacity - bufferP->length >= length)
+    {
+        memcpy(bufferP->data + bufferP->length, data, length);
+        bufferP->length += length;
+        return 0;
+    }
+
+    return utils_bufferAppend(bufferP, data, length);
+}
+
+// Written in place when there is room, the caller's buffer being possibly not growable
+static int prv_writeInt(utils_buffer_t * bufferP,
+                        int64_t value)
+{
+    uint8_t text[PRV_INT_MAX_STRING_LEN];
+    size_t res;
+
+    if (bufferP->capacity - bufferP->length >= PRV_INT_MAX_STRING_LEN)
+    {
+        res = utils_intToText(value, bufferP->data + bufferP->length, PRV_INT_MAX_STRING_LEN);
+        if (res == 0) return -1;
+        bufferP->length += res;
+        return 0;
+    }
+
+    res = utils_intToText(value, text, PRV_INT_MAX_STRING_LEN);
+    if (res == 0) return -1;
+
+    return utils_bufferAppend(bufferP, text, res);
+}
+
+static int prv_writeFloat(utils_buffer_t * bufferP,
+                          double value)
+{
+    uint8_t text[FLOAT_MAX_STRING_LEN];
+    size_t res;
+
+    if (bufferP->capacity - bufferP->length >= FLOAT_MAX_STRING_LEN)
+    {
+        res = utils_floatToText(value, bufferP->data + bufferP->length, FLOAT_MAX_STRING_LEN);
+        if (res == 0) return -1;
+        bufferP->length += res;
+        return 0;
+    }
+
+    res = utils_floatToText(value, text, FLOAT_MAX_STRING_LEN);
+    if (res == 0) return -1;
+
+    return utils_bufferAppend(bufferP, text, res);
+}
+
+int link_writeUri(utils_buffer_t * bufferP,
+                  const uint8_t * parentUriStr,
+                  size_t parentUriLen,
+                  int32_t id)
+{
+    if (prv_append(bufferP, LINK_ITEM_START, LINK_ITEM_START_SIZE) != 0) return -1;
+    if (parentUriLen > 0 && prv_append(bufferP, parentUriStr, parentUriLen) != 0) return -1;
+    if (id >= 0)
+    {
+        if (prv_append(bufferP, LINK_URI_SEPARATOR, LINK_URI_SEPARATOR_SIZE) != 0) return -1;
+        if (prv_writeInt(bufferP, id) != 0) return -1;
+    }
+
+    return prv_append(bufferP, LINK_URI_END, LINK_URI_END_SIZE);
+}
+
+int link_writeIntAttribute(utils_buffer_t * bufferP,
+                           const char * name,
+                           size_t nameLen,
+                           int64_t value)
+{
+    if (prv_append(bufferP, LINK_ATTR_SEPARATOR, LINK_ATTR_SEPARATOR_SIZE) != 0) return -1;
+    if (prv_append(bufferP, name, nameLen) != 0) return -1;
+
+    return prv_writeInt(bufferP, value);
+}
+
+int link_writeFloatAttribute(utils_buffer_t * bufferP,
+                             const char * name,
+                             size_t nameLen,
+                             double value)
+{
+    if (prv_append(bufferP, LINK_ATTR_SEPARATOR, LINK_ATTR_SEPARATOR_SIZE) != 0) return -1;
+    if (prv_append(bufferP, name, nameLen) != 0) return -1;
+
+    return prv_writeFloat(bufferP, value);
+}
+
+int link_writeDelimiter(utils_buffer_t * bufferP)
+{
+    return prv_append(bufferP, LINK_ITEM_ATTR_END, LINK_ITEM_ATTR_END_SIZE);
+}
+
+// Removes the delimiter after the last link and terminates the text with a NUL, not counted in
+// the returned length. Returns -1 if there is no room for it.
+int link_finish(utils_buffer_t * bufferP)
+{
+    if (bufferP->length > 0
+     && bufferP->data[bufferP->length - 1] == LINK_ITEM_ATTR_END[0])
+    {
+        bufferP->length--;
+    }
+    if (utils_bufferReserve(bufferP, 1) != 0) return -1;
+    bufferP->data[bufferP->length] = 0;
+
+    return (int)bufferP->length;
+}
@@ -123,3 +123,425 @@ void lwm2m_list_free(lwm2m_list_t * head)
         lwm2m_list_free(nextP);
     }
 }
+
+#ifndef LWM2M_INDEX_DIRECT_MAP
+
+/*
+ * Sorted array of node pointers: binary search for lookups, memmove() for insertions and removals.
+ */
+
+#define PRV_INDEX_MIN_CAPACITY 8
+
+// Position of the node with ID 'id' in the index, or of the first node with a greater ID
+static size_t prv_indexSearch(lwm2m_list_index_t * indexP,
+                              uint16_t id)
+{
+    size_t low;
+    size_t high;
+
+    low = 0;
+    high = indexP->count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+
+        if (indexP->nodes[middle]->id < id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+static int prv_indexReserve(lwm2m_list_index_t * indexP,
+                            size_t count)
+{
+    lwm2m_list_t ** nodes;
+    size_t capacity;
+
+    if (count <= indexP->capacity) return 0;
+
+    capacity = indexP->capacity == 0 ? PRV_INDEX_MIN_CAPACITY : indexP->capacity;
+    while (capacity < count) capacity *= 2;
+
+    nodes = (lwm2m_list_t **)lwm2m_malloc(capacity * sizeof(lwm2m_list_t *));
+    if (nodes == NULL) return -1;
+    if (indexP->count != 0) memcpy(nodes, indexP->nodes, indexP->count * sizeof(lwm2m_list_t *));
+    lwm2m_free(indexP->nodes);
+    indexP->nodes = nodes;
+    indexP->capacity = capacity;
+
+    return 0;
+}
+
+int lwm2m_index_build(lwm2m_list_index_t * indexP,
+                      lwm2m_list_t * head)
+{
+    lwm2m_list_t * nodeP;
+    size_t count;
+
+    count = 0;
+    for (nodeP = head ; nodeP != NULL ; nodeP = nodeP->next) count++;
+
+    indexP->count = 0;
+    if (prv_indexReserve(indexP, count) != 0) return -1;
+
+    for (nodeP = head ; nodeP != NULL ; nodeP = nodeP->next)
+    {
+        indexP->nodes[indexP->count] = nodeP;
+        indexP->count++;
+    }
+
+    return 0;
+}
+
+int lwm2m_index_add(lwm2m_list_index_t * indexP,
+                    lwm2m_list_t ** headP,
+                    lwm2m_list_t * node)
+{
+    size_t position;
+
+    position = prv_indexSearch(indexP, node->id);
+    if (position < indexP->count && indexP->nodes[position]->id == node->id) return -1;
+
+    if (prv_indexReserve(indexP, indexP->count + 1) != 0) return -1;
+
+    memmove(indexP->nodes + position + 1, indexP->nodes + position, (indexP->count - position) * sizeof(lwm2m_list_t *));
+    indexP->nodes[position] = node;
+    indexP->count++;
+
+    // keep the list linked in the same order
+    node->next = position + 1 < indexP->count ? indexP->nodes[position + 1] : NULL;
+    if (position == 0)
+    {
+        *headP = node;
+    }
+    else
+    {
+        indexP->nodes[position - 1]->next = node;
+    }
+
+    return 0;
+}
+
+lwm2m_list_t * lwm2m_index_find(lwm2m_list_index_t * indexP,
+                                uint16_t id)
+{
+    size_t position;
+
+    position = prv_indexSearch(indexP, id);
+    if (position < indexP->count && indexP->nodes[position]->id == id) return indexP->nodes[position];
+
+    return NULL;
+}
+
+lwm2m_list_t * lwm2m_index_remove(lwm2m_list_index_t * indexP,
+                                  lwm2m_list_t ** headP,
+                                  uint16_t id)
+{
+    lwm2m_list_t * nodeP;
+    size_t position;
+
+    position = prv_indexSearch(indexP, id);
+    if (position == indexP->count || indexP->nodes[position]->id != id) return NULL;
+
+    nodeP = indexP->nodes[position];
+    if (position == 0)
+    {
+        *headP = nodeP->next;
+    }
+    else
+    {
+        indexP->nodes[position - 1]->next = nodeP->next;
+    }
+
+    indexP->count--;
+    memmove(indexP->nodes + position, indexP->nodes + position + 1, (indexP->count - position) * sizeof(lwm2m_list_t *));
+
+    return nodeP;
+}
+
+uint16_t lwm2m_index_newId(lwm2m_list_index_t * indexP)
+{
+    size_t low;
+    size_t high;
+
+    // the IDs are unique and sorted: up to the first gap, the node at position i has ID i
+    low = 0;
+    high = indexP->count;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+
+        if (indexP->nodes[middle]->id == middle)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return (uint16_t)low;
+}
+
+void lwm2m_index_clear(lwm2m_list_index_t * indexP)
+{
+    lwm2m_free(indexP->nodes);
+    indexP->nodes = NULL;
+    indexP->count = 0;
+    indexP->capacity = 0;
+}
+
+#else
+
+/*
+ * Direct map of the 65536 possible IDs: 256 pages of 256 node pointers allocated on use,
+ * each with a bitmap of the IDs in use to find free IDs and neighbouring nodes 32 IDs at a time.
+ */
+
+#define PRV_PAGE_SHIFT  8
+#define PRV_PAGE_SIZE   (1 << PRV_PAGE_SHIFT)
+#define PRV_PAGE_COUNT  (0x10000 >> PRV_PAGE_SHIFT)
+#define PRV_WORD_COUNT  (PRV_PAGE_SIZE / 32)
+
+struct _lwm2m_index_page_t
+{
+    lwm2m_list_t * nodes[PRV_PAGE_SIZE];
+    uint32_t       used[PRV_WORD_COUNT];    // bit set when the ID is in use
+    uint16_t       count;
+};
+
+static int prv_lowestBit(uint32_t word)
+{
+    int bit;
+
+    bit = 0;
+    while ((word & 0x01) == 0)
+    {
+        word >>= 1;
+        bit++;
+    }
+
+    return bit;
+}
+
+static int prv_highestBit(uint32_t word)
+{
+    int bit;
+
+    bit = 31;
+    while ((word & 0x80000000) == 0)
+    {
+        word <<= 1;
+        bit--;
+    }
+
+    return bit;
+}
+
+// Return the node with the greatest ID lower than 'id' or NULL if none
+static lwm2m_list_t * prv_findPrevious(lwm2m_list_index_t * indexP,
+                                       uint16_t id)
+{
+    int page;
+    int word;
+    uint32_t mask;
+
+    page = id >> PRV_PAGE_SHIFT;
+    word = (id & (PRV_PAGE_SIZE - 1)) / 32;
+    mask = ((uint32_t)1 << (id % 32)) - 1;
+    while (page >= 0)
+    {
+        struct _lwm2m_index_page_t * pageP = indexP->pages[page];
+
+        if (pageP != NULL && pageP->count != 0)
+        {
+            while (word >= 0)
+            {
+                if ((pageP->used[word] & mask) != 0)
+                {
+                    return pageP->nodes[word * 32 + prv_highestBit(pageP->used[word] & mask)];
+                }
+                word--;
+                mask = 0xFFFFFFFF;
+            }
+        }
+        page--;
+        word = PRV_WORD_COUNT - 1;
+        mask = 0xFFFFFFFF;
+    }
+
+    return NULL;
+}
+
+static int prv_indexSet(lwm2m_list_index_t * indexP,
+                        lwm2m_list_t * node)
+{
+    struct _lwm2m_index_page_t * pageP;
+    int position;
+
+    if (indexP->pages == NULL)
+    {
+        indexP->pages = (struct _lwm2m_index_page_t **)lwm2m_malloc(PRV_PAGE_COUNT * sizeof(struct _lwm2m_index_page_t *));
+        if (indexP->pages == NULL) return -1;
+        memset(indexP->pages, 0, PRV_PAGE_COUNT * sizeof(struct _lwm2m_index_page_t *));
+    }
+
+    pageP = indexP->pages[node->id >> PRV_PAGE_SHIFT];
+    if (pageP == NULL)
+    {
+        pageP = (struct _lwm2m_index_page_t *)lwm2m_malloc(sizeof(struct _lwm2m_index_page_t));
+        if (pageP == NULL) return -1;
+        memset(pageP, 0, sizeof(struct _lwm2m_index_page_t));
+        indexP->pages[node->id >> PRV_PAGE_SHIFT] = pageP;
+    }
+
+    position = node->id & (PRV_PAGE_SIZE - 1);
+    if (pageP->nodes[position] != NULL) return -1;
+
+    pageP->nodes[position] = node;
+    pageP->used[position / 32] |= (uint32_t)1 << (position % 32);
+    pageP->count++;
+    indexP->count++;
+
+    return 0;
+}
+
+int lwm2m_index_build(lwm2m_list_index_t * indexP,
+                      lwm2m_list_t * head)
+{
+    lwm2m_list_t * nodeP;
+
+    for (nodeP = head ; nodeP != NULL ; nodeP = nodeP->next)
+    {
+        if (prv_indexSet(indexP, nodeP) != 0) return -1;
+    }
+
+    return 0;
+}
+
+int lwm2m_index_add(lwm2m_list_index_t * indexP,
+                    lwm2m_list_t ** headP,
+                    lwm2m_list_t * node)
+{
+    lwm2m_list_t * previousP;
+
+    if (prv_indexSet(indexP, node) != 0) return -1;
+
+    // keep the list linked in the same order
+    previousP = prv_findPrevious(indexP, node->id);
+    if (previousP == NULL)
+    {
+        node->next = *headP;
+        *headP = node;
+    }
+    else
+    {
+        node->next = previousP->next;
+        previousP->next = node;
+    }
+
+    return 0;
+}
+
+lwm2m_list_t * lwm2m_index_find(lwm2m_list_index_t * indexP,
+                                uint16_t id)
+{
+    struct _lwm2m_index_page_t * pageP;
+
+    if (indexP->pages == NULL) return NULL;
+
+    pageP = indexP->pages[id >> PRV_PAGE_SHIFT];
+    if (pageP == NULL) return NULL;
+
+    return pageP->nodes[id & (PRV_PAGE_SIZE - 1)];
+}
+
+lwm2m_list_t * lwm2m_index_remove(lwm2m_list_index_t * indexP,
+                                  lwm2m_list_t ** headP,
+                                  uint16_t id)
+{
+    struct _lwm2m_index_page_t * pageP;
+    lwm2m_list_t * nodeP;
+    lwm2m_list_t * previousP;
+    int position;
+
+    nodeP = lwm2m_index_find(indexP, id);
+    if (nodeP == NULL) return NULL;
+
+    previousP = prv_findPrevious(indexP, id);
+    if (previousP == NULL)
+    {
+        *headP = nodeP->next;
+    }
+    else
+    {
+        previousP->next = nodeP->next;
+    }
+
+    pageP = indexP->pages[id >> PRV_PAGE_SHIFT];
+    position = id & (PRV_PAGE_SIZE - 1);
+    pageP->nodes[position] = NULL;
+    pageP->used[position / 32] &= ~((uint32_t)1 << (position % 32));
+    pageP->count--;
+    indexP->count--;
+    if (pageP->count == 0)
+    {
+        lwm2m_free(pageP);
+        indexP->pages[id >> PRV_PAGE_SHIFT] = NULL;
+    }
+
+    return nodeP;
+}
+
+uint16_t lwm2m_index_newId(lwm2m_list_index_t * indexP)
+{
+    int page;
+
+    if (indexP->pages == NULL) return 0;
+
+    for (page = 0 ; page < PRV_PAGE_COUNT ; page++)
+    {
+        struct _lwm2m_index_page_t * pageP = indexP->pages[page];
+        int word;
+
+        if (pageP == NULL) return (uint16_t)(page << PRV_PAGE_SHIFT);
+        if (pageP->count == PRV_PAGE_SIZE) continue;
+
+        for (word = 0 ; word < PRV_WORD_COUNT ; word++)
+        {
+            if (pageP->used[word] != 0xFFFFFFFF)
+            {
+                return (uint16_t)((page << PRV_PAGE_SHIFT) + word * 32 + prv_lowestBit(~pageP->used[word]));
+            }
+        }
+    }
+
+    // all the IDs are used, like lwm2m_list_newId()
+    return 0;
+}
+
+void lwm2m_index_clear(lwm2m_list_index_t * indexP)
+{
+    if (indexP->pages != NULL)
+    {
+        int page;
+
+        for (page = 0 ; page < PRV_PAGE_COUNT ; page++)
+        {
+            lwm2m_free(indexP->pages[page]);
+        }
+        lwm2m_free(indexP->pages);
+    }
+    indexP->pages = NULL;
+    indexP->count = 0;
+}
+
+#endif
@@ -159,6 +159,32 @@ static int prv_readAttributes(multi_option_t * query,
     return 0;
 }
 
+// Access rights needed by the request, Observe, Discover and Write-Attributes needing the right to read
+static uint8_t prv_requiredRights(lwm2m_uri_t * uriP,
+                                  coap_packet_t * message)
+{
+    switch (message->code)
+    {
+    case COAP_GET:
+        return ACL_RIGHT_READ;
+
+    case COAP_POST:
+        if (!LWM2M_URI_IS_SET_INSTANCE(uriP)) return ACL_RIGHT_CREATE;
+        if (!LWM2M_URI_IS_SET_RESOURCE(uriP)) return ACL_RIGHT_WRITE;
+        return ACL_RIGHT_EXECUTE;
+
+    case COAP_PUT:
+        if (IS_OPTION(message, COAP_OPTION_URI_QUERY)) return ACL_RIGHT_READ;
+        return ACL_RIGHT_WRITE;
+
+    case COAP_DELETE:
+        return ACL_RIGHT_DELETE;
+
+    default:
+        return 0;
+    }
+}
+
 uint8_t dm_handleRequest(lwm2m_context_t * contextP,
                          lwm2m_uri_t * uriP,
                          lwm2m_server_t * serverP,
@@ -185,15 +211,16 @@ uint8_t dm_handleRequest(lwm2m_context_t * contextP,
         return COAP_404_NOT_FOUND;
     }
 
-    if (serverP->status != STATE_REGISTERED
-        && serverP->status != STATE_REG_UPDATE_NEEDED
-        && serverP->status != STATE_REG_FULL_UPDATE_NEEDED
-        && serverP->status != STATE_REG_UPDATE_PENDING)
+    if (!registration_isRegistered(serverP))
     {
         return COAP_IGNORE;
     }
 
-    // TODO: check ACL
+    result = acl_checkAccess(contextP, serverP, uriP, prv_requiredRights(uriP, message));
+    if (result != COAP_NO_ERROR)
+    {
+        return result;
+    }
 
     switch (message->code)
     {
@@ -246,12 +273,38 @@ uint8_t dm_handleRequest(lwm2m_context_t * contextP,
             }
             else
             {
+                uint32_t blockNum;
+                uint16_t blockSize;
+                uint32_t blockOffset;
+
                 if (IS_OPTION(message, COAP_OPTION_ACCEPT))
                 {
                     format = utils_convertMediaType(message->accept[0]);
                 }
 
-                result = object_read(contextP, uriP, &format, &buffer, &length);
+                if (coap_get_header_block2(message, &blockNum, NULL, &blockSize, &blockOffset))
+                {
+                    size_t totalLength = 0;
+
+                    // only the requested block is serialized
+                    blockSize = MIN(blockSize, REST_MAX_CHUNK_SIZE);
+                    result = object_readBlock(contextP, uriP, &format, blockOffset, blockSize, &buffer, &length, &totalLength);
+                    if (COAP_205_CONTENT == result)
+                    {
+                        if (blockOffset > 0 && blockOffset >= totalLength)
+                        {
+                            result = COAP_402_BAD_OPTION;
+                        }
+                        else
+                        {
+                            coap_set_header_block2(response, blockNum, blockOffset + length < totalLength, blockSize);
+                        }
+                    }
+                }
+                else
+                {
+                    result = object_read(contextP, uriP, &format, &buffer, &length);
+                }
             }
             if (COAP_205_CONTENT == result)
             {
@@ -282,6 +335,15 @@ uint8_t dm_handleRequest(lwm2m_context_t * contextP,
                         break;
                     }
 
+                    // without its access control, the instance could not be used by its creator
+                    result = acl_createInstance(contextP, serverP, uriP);
+                    if (result != COAP_NO_ERROR)
+                    {
+                        object_delete(contextP, uriP);
+                        break;
+                    }
+                    result = COAP_201_CREATED;
+
                     if (sprintf(location_path, "/%d/%d", uriP->objectId, uriP->instanceId) < 0)
                     {
                         result = COAP_500_INTERNAL_SERVER_ERROR;
@@ -354,12 +416,102 @@ uint8_t dm_handleRequest(lwm2m_context_t * contextP,
     return result;
 }
 
+#ifdef LWM2M_SUPPORT_CBOR
+// Read-Composite (FETCH) and Write-Composite (iPATCH) requests, targeting the root path. The URIs
+// are in the payload.
+uint8_t dm_handleCompositeRequest(lwm2m_context_t * contextP,
+                                  lwm2m_server_t * serverP,
+                                  coap_packet_t * message,
+                                  coap_packet_t * response)
+{
+    uint8_t result;
+    lwm2m_media_type_t format;
+
+    LOG_ARG("Code: %02X, server status: %s", message->code, STR_STATUS(serverP->status));
+
+    if (!registration_isRegistered(serverP))
+    {
+        return COAP_IGNORE;
+    }
+
+    if (!IS_OPTION(message, COAP_OPTION_CONTENT_TYPE)
+     || utils_convertMediaType(message->content_type) != LWM2M_CONTENT_SENML_CBOR)
+    {
+        return COAP_415_UNSUPPORTED_CONTENT_FORMAT;
+    }
+    format = LWM2M_CONTENT_SENML_CBOR;
+
+    switch (message->code)
+    {
+    case COAP_FETCH:
+        {
+            lwm2m_uri_t * urisP;
+            uint8_t * buffer = NULL;
+            size_t length = 0;
+            int count;
+            int i;
+
+            if (IS_OPTION(message, COAP_OPTION_ACCEPT))
+            {
+                format = utils_convertMediaType(message->accept[0]);
+            }
+
+            count = senml_cbor_parseUris(message->payload, message->payload_len, &urisP);
+            if (count <= 0) return COAP_400_BAD_REQUEST;
+
+            // the Security Object is left out of the response
+            result = COAP_NO_ERROR;
+            for (i = 0 ; i < count && result == COAP_NO_ERROR ; i++)
+            {
+                if (urisP[i].objectId != LWM2M_SECURITY_OBJECT_ID)
+                {
+                    result = acl_checkAccess(contextP, serverP, urisP + i, ACL_RIGHT_READ);
+                }
+            }
+            if (result != COAP_NO_ERROR)
+            {
+                lwm2m_free(urisP);
+                return result;
+            }
+
+            result = object_readComposite(contextP, count, urisP, &format, &buffer, &length);
+            lwm2m_free(urisP);
+            if (COAP_205_CONTENT == result)
+            {
+                coap_set_header_content_type(response, format);
+                coap_set_payload(response, buffer, length);
+                // lwm2m_handle_packet will free buffer
+            }
+        }
+        break;
+
+    case COAP_IPATCH:
+        result = object_writeComposite(contextP, serverP, format, message->payload, message->payload_len);
+        break;
+
+    default:
+        result = COAP_405_METHOD_NOT_ALLOWED;
+        break;
+    }
+
+    return result;
+}
+#endif
+
 #endif
 
 #ifdef LWM2M_SERVER_MODE
 
 #define ID_AS_STRING_MAX_LEN 8
 
+// The URI given to the result callback, NULL for composite operations
+static lwm2m_uri_t * prv_resultUri(dm_data_t * dataP)
+{
+    if ((dataP->uri.flag & LWM2M_URI_FLAG_OBJECT_ID) == 0) return NULL;
+
+    return &dataP->uri;
+}
+
 static void prv_resultCallback(lwm2m_transaction_t * transacP,
                                void * message)
 {
@@ -368,7 +520,7 @@ static void prv_resultCallback(lwm2m_transaction_t * transacP,
     if (message == NULL)
     {
         dataP->callback(dataP->clientID,
-                        &dataP->uri,
+                        prv_resultUri(dataP),
                         COAP_503_SERVICE_UNAVAILABLE,
                         LWM2M_CONTENT_TEXT, NULL, 0,
                         dataP->userData);
@@ -407,7 +559,7 @@ static void prv_resultCallback(lwm2m_transaction_t * transacP,
         }
 
         dataP->callback(dataP->clientID,
-                        &dataP->uri,
+                        prv_resultUri(dataP),
                         packet->code,
                         utils_convertMediaType(packet->content_type),
                         packet->payload,
@@ -431,21 +583,27 @@ static int prv_makeOperation(lwm2m_context_t * contextP,
     lwm2m_transaction_t * transaction;
     dm_data_t * dataP;
 
-    clientP = (lwm2m_client_t *)lwm2m_list_find((lwm2m_list_t *)contextP->clientList, clientID);
+    clientP = contextP->clientStore->findClientFunc(clientID, contextP->clientStore);
     if (clientP == NULL) return COAP_404_NOT_FOUND;
 
     transaction = transaction_new(clientP->sessionH, method, clientP->altPath, uriP, contextP->nextMID++, 4, NULL);
     if (transaction == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
 
-    if (method == COAP_GET)
+    if (method == COAP_GET || method == COAP_FETCH)
     {
         coap_set_header_accept(transaction->message, format);
     }
-    else if (buffer != NULL)
+    if (method != COAP_GET && buffer != NULL)
     {
         coap_set_header_content_type(transaction->message, format);
         // TODO: Take care of fragmentation
         coap_set_payload(transaction->message, buffer, length);
+        // the caller can release the buffer once the call returns, even if the client is queued
+        if (transaction_serialize(transaction) != 0)
+        {
+            transaction_free(transaction);
+            return COAP_500_INTERNAL_SERVER_ERROR;
+        }
     }
 
     if (callback != NULL)
@@ -456,7 +614,15 @@ static int prv_makeOperation(lwm2m_context_t * contextP,
             transaction_free(transaction);
             return COAP_500_INTERNAL_SERVER_ERROR;
         }
-        memcpy(&dataP->uri, uriP, sizeof(lwm2m_uri_t));
+        if (uriP != NULL)
+        {
+            memcpy(&dataP->uri, uriP, sizeof(lwm2m_uri_t));
+        }
+        else
+        {
+            // composite operations target the root path
+            memset(&dataP->uri, 0, sizeof(lwm2m_uri_t));
+        }
         dataP->clientID = clientP->internalID;
         dataP->callback = callback;
         dataP->userData = userData;
@@ -467,8 +633,15 @@ static int prv_makeOperation(lwm2m_context_t * contextP,
 
     if (clientP->binding == BINDING_UQ || clientP->binding == BINDING_SQ || clientP->binding == BINDING_UQS)
     {
-        clientP->queuedTransactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(clientP->queuedTransactionList, transaction);
-        return 0;
+        int result;
+
+        result = queue_add(contextP, clientP, transaction);
+        if (result != COAP_NO_ERROR)
+        {
+            if (transaction->userData != NULL) lwm2m_free(transaction->userData);
+            transaction_free(transaction);
+        }
+        return result;
     }
     else
     {
@@ -489,10 +662,14 @@ int lwm2m_dm_read(lwm2m_context_t * contextP,
     LOG_ARG("clientID: %d", clientID);
     LOG_URI(uriP);
 
-    clientP = (lwm2m_client_t *)lwm2m_list_find((lwm2m_list_t *)contextP->clientList, clientID);
+    clientP = contextP->clientStore->findClientFunc(clientID, contextP->clientStore);
     if (clientP == NULL) return COAP_404_NOT_FOUND;
 
-    if (clientP->supportJSON == true)
+    if (clientP->supportSenMLCBOR == true)
+    {
+        format = LWM2M_CONTENT_SENML_CBOR;
+    }
+    else if (clientP->supportJSON == true)
     {
         format = LWM2M_CONTENT_JSON;
     }
@@ -607,6 +784,60 @@ int lwm2m_dm_delete(lwm2m_context_t * contextP,
                               callback, userData);
 }
 
+#ifdef LWM2M_SUPPORT_CBOR
+int lwm2m_dm_read_composite(lwm2m_context_t * contextP,
+                            uint16_t clientID,
+                            lwm2m_uri_t * urisP,
+                            int count,
+                            lwm2m_result_callback_t callback,
+                            void * userData)
+{
+    utils_buffer_t payload;
+    int result;
+    int res;
+
+    LOG_ARG("clientID: %d, count: %d", clientID, count);
+    if (urisP == NULL || count <= 0) return COAP_400_BAD_REQUEST;
+
+    utils_bufferInit(&payload, NULL, 0);
+    res = senml_cbor_serializeUris(count, urisP, &payload);
+    if (res <= 0)
+    {
+        utils_bufferFree(&payload);
+        return COAP_400_BAD_REQUEST;
+    }
+
+    result = prv_makeOperation(contextP, clientID, NULL,
+                               COAP_FETCH,
+                               LWM2M_CONTENT_SENML_CBOR, payload.data, res,
+                               callback, userData);
+    utils_bufferFree(&payload);
+
+    return result;
+}
+
+int lwm2m_dm_write_composite(lwm2m_context_t * contextP,
+                             uint16_t clientID,
+                             lwm2m_media_type_t format,
+                             uint8_t * buffer,
+                             int length,
+                             lwm2m_result_callback_t callback,
+                             void * userData)
+{
+    LOG_ARG("clientID: %d, format: %s, length: %d", clientID, STR_MEDIA_TYPE(format), length);
+    if (format != LWM2M_CONTENT_SENML_CBOR
+     || length == 0)
+    {
+        return COAP_400_BAD_REQUEST;
+    }
+
+    return prv_makeOperation(contextP, clientID, NULL,
+                             COAP_IPATCH,
+                             format, buffer, length,
+                             callback, userData);
+}
+#endif
+
 int lwm2m_dm_write_attributes(lwm2m_context_t * contextP,
                               uint16_t clientID,
                               lwm2m_uri_t * uriP,
@@ -630,7 +861,7 @@ int lwm2m_dm_write_attributes(lwm2m_context_t * contextP,
     if (ATTR_FLAG_NUMERIC == (attrP->toSet & ATTR_FLAG_NUMERIC)
      && (attrP->lessThan + 2 * attrP->step >= attrP->greaterThan)) return COAP_400_BAD_REQUEST;
 
-    clientP = (lwm2m_client_t *)lwm2m_list_find((lwm2m_list_t *)contextP->clientList, clientID);
+    clientP = contextP->clientStore->findClientFunc(clientID, contextP->clientStore);
     if (clientP == NULL) return COAP_404_NOT_FOUND;
 
     transaction = transaction_new(clientP->sessionH, COAP_PUT, clientP->altPath, uriP, contextP->nextMID++, 4, NULL);
@@ -745,8 +976,15 @@ int lwm2m_dm_write_attributes(lwm2m_context_t * contextP,
 
     if (clientP->binding == BINDING_UQ || clientP->binding == BINDING_SQ || clientP->binding == BINDING_UQS)
     {
-        clientP->queuedTransactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(clientP->queuedTransactionList, transaction);
-        return 0;
+        int result;
+
+        result = queue_add(contextP, clientP, transaction);
+        if (result != COAP_NO_ERROR)
+        {
+            if (transaction->userData != NULL) lwm2m_free(transaction->userData);
+            transaction_free(transaction);
+        }
+        return result;
     }
     else
     {
@@ -767,7 +1005,7 @@ int lwm2m_dm_discover(lwm2m_context_t * contextP,
 
     LOG_ARG("clientID: %d", clientID);
     LOG_URI(uriP);
-    clientP = (lwm2m_client_t *)lwm2m_list_find((lwm2m_list_t *)contextP->clientList, clientID);
+    clientP = contextP->clientStore->findClientFunc(clientID, contextP->clientStore);
     if (clientP == NULL) return COAP_404_NOT_FOUND;
 
     transaction = transaction_new(clientP->sessionH, COAP_GET, clientP->altPath, uriP, contextP->nextMID++, 4, NULL);
@@ -794,8 +1032,15 @@ int lwm2m_dm_discover(lwm2m_context_t * contextP,
 
     if (clientP->binding == BINDING_UQ || clientP->binding == BINDING_SQ || clientP->binding == BINDING_UQS)
     {
-        clientP->queuedTransactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(clientP->queuedTransactionList, transaction);
-        return 0;
+        int result;
+
+        result = queue_add(contextP, clientP, transaction);
+        if (result != COAP_NO_ERROR)
+        {
+            if (transaction->userData != NULL) lwm2m_free(transaction->userData);
+            transaction_free(transaction);
+        }
+        return result;
     }
     else
     {
@@ -59,6 +59,39 @@
 #include <string.h>
 #include <stdio.h>
 
+#ifdef LWM2M_BORROW_PAYLOAD
+// the values given to the write and create callbacks point into the request payload
+#define PRV_DATA_PARSE lwm2m_data_parse_borrowed
+#else
+#define PRV_DATA_PARSE lwm2m_data_parse
+#endif
+
+lwm2m_object_t * object_find(lwm2m_context_t * contextP,
+                             uint16_t objectId)
+{
+    return (lwm2m_object_t *)lwm2m_index_find(&contextP->objectIndex, objectId);
+}
+
+lwm2m_list_t * object_findInstance(lwm2m_object_t * objectP,
+                                   uint16_t instanceId)
+{
+    if (objectP->instanceIndex != NULL)
+    {
+        return lwm2m_index_find(objectP->instanceIndex, instanceId);
+    }
+
+    return lwm2m_list_find(objectP->instanceList, instanceId);
+}
+
+uint16_t object_newInstanceId(lwm2m_object_t * objectP)
+{
+    if (objectP->instanceIndex != NULL)
+    {
+        return lwm2m_index_newId(objectP->instanceIndex);
+    }
+
+    return lwm2m_list_newId(objectP->instanceList);
+}
 
 uint8_t object_checkReadable(lwm2m_context_t * contextP,
                              lwm2m_uri_t * uriP,
@@ -70,13 +103,13 @@ uint8_t object_checkReadable(lwm2m_context_t * contextP,
     int size;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->readFunc) return COAP_405_METHOD_NOT_ALLOWED;
 
     if (!LWM2M_URI_IS_SET_INSTANCE(uriP)) return COAP_205_CONTENT;
 
-    if (NULL == LWM2M_LIST_FIND(targetP->instanceList, uriP->instanceId)) return COAP_404_NOT_FOUND;
+    if (NULL == object_findInstance(targetP, uriP->instanceId)) return COAP_404_NOT_FOUND;
 
     if (!LWM2M_URI_IS_SET_RESOURCE(uriP)) return COAP_205_CONTENT;
 
@@ -114,13 +147,13 @@ uint8_t object_readData(lwm2m_context_t * contextP,
     lwm2m_object_t * targetP;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->readFunc) return COAP_405_METHOD_NOT_ALLOWED;
 
     if (LWM2M_URI_IS_SET_INSTANCE(uriP))
     {
-        if (NULL == lwm2m_list_find(targetP->instanceList, uriP->instanceId)) return COAP_404_NOT_FOUND;
+        if (NULL == object_findInstance(targetP, uriP->instanceId)) return COAP_404_NOT_FOUND;
 
         // single instance read
         if (LWM2M_URI_IS_SET_RESOURCE(uriP))
@@ -207,6 +240,54 @@ uint8_t object_read(lwm2m_context_t * contextP,
     return result;
 }
 
+// Only the Block2 chunk at offset is serialized, in a buffer of blockSize bytes.
+uint8_t object_readBlock(lwm2m_context_t * contextP,
+                         lwm2m_uri_t * uriP,
+                         lwm2m_media_type_t * formatP,
+                         size_t offset,
+                         size_t blockSize,
+                         uint8_t ** bufferP,
+                         size_t * lengthP,
+                         size_t * totalLengthP)
+{
+    uint8_t result;
+    lwm2m_data_t * dataP = NULL;
+    int size = 0;
+    int res;
+
+    LOG_URI(uriP);
+    LOG_ARG("offset: %d, blockSize: %d", offset, blockSize);
+    result = object_readData(contextP, uriP, &size, &dataP);
+
+    if (result == COAP_205_CONTENT)
+    {
+        *bufferP = (uint8_t *)lwm2m_malloc(blockSize);
+        if (*bufferP == NULL)
+        {
+            result = COAP_500_INTERNAL_SERVER_ERROR;
+        }
+        else
+        {
+            res = lwm2m_data_serialize_block(uriP, size, dataP, formatP, offset, *bufferP, blockSize, totalLengthP);
+            if (res < 0)
+            {
+                lwm2m_free(*bufferP);
+                *bufferP = NULL;
+                result = COAP_500_INTERNAL_SERVER_ERROR;
+            }
+            else
+            {
+                *lengthP = (size_t)res;
+            }
+        }
+    }
+    lwm2m_data_free(size, dataP);
+
+    LOG_ARG("result: %u.%2u, length: %d", (result & 0xFF) >> 5, (result & 0x1F), *lengthP);
+
+    return result;
+}
+
 uint8_t object_write(lwm2m_context_t * contextP,
                      lwm2m_uri_t * uriP,
                      lwm2m_media_type_t format,
@@ -219,7 +300,7 @@ uint8_t object_write(lwm2m_context_t * contextP,
     int size = 0;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP)
     {
         result = COAP_404_NOT_FOUND;
@@ -230,7 +311,7 @@ uint8_t object_write(lwm2m_context_t * contextP,
     }
     else
     {
-        size = lwm2m_data_parse(uriP, buffer, length, format, &dataP);
+        size = PRV_DATA_PARSE(uriP, buffer, length, format, &dataP);
         if (size == 0)
         {
             result = COAP_406_NOT_ACCEPTABLE;
@@ -240,13 +321,205 @@ uint8_t object_write(lwm2m_context_t * contextP,
     {
         result = targetP->writeFunc(uriP->instanceId, size, dataP, targetP);
         lwm2m_data_free(size, dataP);
+        if (uriP->objectId == LWM2M_ACL_OBJECT_ID) acl_invalidate(contextP);
+#ifdef LWM2M_OBJECT_JOURNAL
+        if (result == COAP_204_CHANGED) journal_save(contextP, uriP->objectId, uriP->instanceId);
+#endif
+    }
+
+    LOG_ARG("result: %u.%2u", (result & 0xFF) >> 5, (result & 0x1F));
+
+    return result;
+}
+
+#ifdef LWM2M_SUPPORT_CBOR
+// Returns true if the URI targets a part of parentP
+static bool prv_isIncluded(lwm2m_uri_t * uriP,
+                           lwm2m_uri_t * parentP)
+{
+    if (uriP->objectId != parentP->objectId) return false;
+    if (!LWM2M_URI_IS_SET_INSTANCE(parentP)) return true;
+    if (!LWM2M_URI_IS_SET_INSTANCE(uriP) || uriP->instanceId != parentP->instanceId) return false;
+    if (!LWM2M_URI_IS_SET_RESOURCE(parentP)) return true;
+    return LWM2M_URI_IS_SET_RESOURCE(uriP) && uriP->resourceId == parentP->resourceId;
+}
+
+uint8_t object_readComposite(lwm2m_context_t * contextP,
+                             int count,
+                             lwm2m_uri_t * urisP,
+                             lwm2m_media_type_t * formatP,
+                             uint8_t ** bufferP,
+                             size_t * lengthP)
+{
+    uint8_t result;
+    senml_part_t * partsP;
+    utils_buffer_t payload;
+    int partCount;
+    int i;
+    int j;
+    int res;
+
+    LOG_ARG("count: %d", count);
+    if (*formatP != LWM2M_CONTENT_SENML_CBOR) return COAP_406_NOT_ACCEPTABLE;
+
+    partsP = (senml_part_t *)lwm2m_malloc(count * sizeof(senml_part_t));
+    if (partsP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+
+    result = COAP_205_CONTENT;
+    partCount = 0;
+    for (i = 0 ; i < count && result == COAP_205_CONTENT ; i++)
+    {
+        lwm2m_uri_t * uriP = urisP + i;
+        senml_part_t * partP = partsP + partCount;
+
+        // the values are already read with another URI
+        for (j = 0 ; j < count ; j++)
+        {
+            if (j != i
+             && prv_isIncluded(uriP, urisP + j)
+             && (!prv_isIncluded(urisP + j, uriP) || j < i))
+            {
+                break;
+            }
+        }
+        if (j < count) continue;
+
+        // the Security Object can not be read
+        if (uriP->objectId == LWM2M_SECURITY_OBJECT_ID) continue;
+
+        partP->uriP = uriP;
+        partP->size = 0;
+        partP->dataP = NULL;
+        result = object_readData(contextP, uriP, &partP->size, &partP->dataP);
+        if (result == COAP_205_CONTENT)
+        {
+            partCount++;
+        }
+        else
+        {
+            lwm2m_data_free(partP->size, partP->dataP);
+            // missing items are left out of the response
+            if (result == COAP_404_NOT_FOUND) result = COAP_205_CONTENT;
+        }
     }
 
+    if (result == COAP_205_CONTENT)
+    {
+        if (partCount == 0)
+        {
+            result = COAP_404_NOT_FOUND;
+        }
+        else
+        {
+            utils_bufferInit(&payload, NULL, 0);
+            res = senml_cbor_serializeParts(partCount, partsP, &payload);
+            if (res <= 0)
+            {
+                utils_bufferFree(&payload);
+                result = COAP_500_INTERNAL_SERVER_ERROR;
+            }
+            else
+            {
+                *bufferP = payload.data;
+                *lengthP = (size_t)res;
+            }
+        }
+    }
+
+    for (i = 0 ; i < partCount ; i++)
+    {
+        lwm2m_data_free(partsP[i].size, partsP[i].dataP);
+    }
+    lwm2m_free(partsP);
+
     LOG_ARG("result: %u.%2u", (result & 0xFF) >> 5, (result & 0x1F));
 
     return result;
 }
 
+// Every target instance must exist and be writable by serverP before any is written. The values are
+// then written instance by instance in the payload order, and a value refused by an object stops the
+// write, leaving the previous instances written.
+uint8_t object_writeComposite(lwm2m_context_t * contextP,
+                              lwm2m_server_t * serverP,
+                              lwm2m_media_type_t format,
+                              uint8_t * buffer,
+                              size_t length)
+{
+    uint8_t result;
+    lwm2m_object_t * targetP;
+    lwm2m_data_t * dataP = NULL;
+    lwm2m_data_t * instanceP;
+    lwm2m_uri_t uri;
+    int size;
+    int i;
+    size_t j;
+
+    LOG_ARG("length: %d", length);
+    if (format != LWM2M_CONTENT_SENML_CBOR) return COAP_415_UNSUPPORTED_CONTENT_FORMAT;
+
+    // without a target URI, the values are returned in object nodes
+    size = PRV_DATA_PARSE(NULL, buffer, length, format, &dataP);
+    if (size <= 0) return COAP_400_BAD_REQUEST;
+
+    // all the targets are checked before the first write
+    result = COAP_NO_ERROR;
+    for (i = 0 ; i < size && result == COAP_NO_ERROR ; i++)
+    {
+        if (dataP[i].id == LWM2M_SECURITY_OBJECT_ID)
+        {
+            result = COAP_401_UNAUTHORIZED;
+            break;
+        }
+        targetP = object_find(contextP, dataP[i].id);
+        if (NULL == targetP)
+        {
+            result = COAP_404_NOT_FOUND;
+            break;
+        }
+        if (NULL == targetP->writeFunc)
+        {
+            result = COAP_405_METHOD_NOT_ALLOWED;
+            break;
+        }
+        for (j = 0 ; j < dataP[i].value.asChildren.count && result == COAP_NO_ERROR ; j++)
+        {
+            instanceP = dataP[i].value.asChildren.array + j;
+            memset(&uri, 0, sizeof(lwm2m_uri_t));
+            uri.objectId = dataP[i].id;
+            uri.instanceId = instanceP->id;
+            uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+            result = acl_checkAccess(contextP, serverP, &uri, ACL_RIGHT_WRITE);
+            if (result == COAP_NO_ERROR
+             && NULL == object_findInstance(targetP, instanceP->id))
+            {
+                result = COAP_404_NOT_FOUND;
+            }
+        }
+    }
+
+    if (result == COAP_NO_ERROR) result = COAP_204_CHANGED;
+    for (i = 0 ; i < size && result == COAP_204_CHANGED ; i++)
+    {
+        targetP = object_find(contextP, dataP[i].id);
+        for (j = 0 ; j < dataP[i].value.asChildren.count && result == COAP_204_CHANGED ; j++)
+        {
+            instanceP = dataP[i].value.asChildren.array + j;
+            result = targetP->writeFunc(instanceP->id, (int)instanceP->value.asChildren.count, instanceP->value.asChildren.array, targetP);
+#ifdef LWM2M_OBJECT_JOURNAL
+            if (result == COAP_204_CHANGED) journal_save(contextP, dataP[i].id, instanceP->id);
+#endif
+        }
+        if (dataP[i].id == LWM2M_ACL_OBJECT_ID) acl_invalidate(contextP);
+    }
+    lwm2m_data_free(size, dataP);
+
+    LOG_ARG("result: %u.%2u", (result & 0xFF) >> 5, (result & 0x1F));
+
+    return result;
+}
+#endif
+
 uint8_t object_execute(lwm2m_context_t * contextP,
                        lwm2m_uri_t * uriP,
                        uint8_t * buffer,
@@ -255,10 +528,10 @@ uint8_t object_execute(lwm2m_context_t * contextP,
     lwm2m_object_t * targetP;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->executeFunc) return COAP_405_METHOD_NOT_ALLOWED;
-    if (NULL == lwm2m_list_find(targetP->instanceList, uriP->instanceId)) return COAP_404_NOT_FOUND;
+    if (NULL == object_findInstance(targetP, uriP->instanceId)) return COAP_404_NOT_FOUND;
 
     return targetP->executeFunc(uriP->instanceId, uriP->resourceId, buffer, length, targetP);
 }
@@ -281,11 +554,11 @@ uint8_t object_create(lwm2m_context_t * contextP,
         return COAP_400_BAD_REQUEST;
     }
 
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->createFunc) return COAP_405_METHOD_NOT_ALLOWED;
 
-    size = lwm2m_data_parse(uriP, buffer, length, format, &dataP);
+    size = PRV_DATA_PARSE(uriP, buffer, length, format, &dataP);
     if (size <= 0) return COAP_400_BAD_REQUEST;
 
     switch (dataP[0].type)
@@ -300,7 +573,7 @@ uint8_t object_create(lwm2m_context_t * contextP,
             result = COAP_400_BAD_REQUEST;
             goto exit;
         }
-        if (NULL != lwm2m_list_find(targetP->instanceList, dataP[0].id))
+        if (NULL != object_findInstance(targetP, dataP[0].id))
         {
             // Instance already exists
             result = COAP_406_NOT_ACCEPTABLE;
@@ -314,7 +587,7 @@ uint8_t object_create(lwm2m_context_t * contextP,
     default:
         if (!LWM2M_URI_IS_SET_INSTANCE(uriP))
         {
-            uriP->instanceId = lwm2m_list_newId(targetP->instanceList);
+            uriP->instanceId = object_newInstanceId(targetP);
             uriP->flag |= LWM2M_URI_FLAG_INSTANCE_ID;
         }
         result = targetP->createFunc(uriP->instanceId, size, dataP, targetP);
@@ -324,6 +597,15 @@ uint8_t object_create(lwm2m_context_t * contextP,
 exit:
     lwm2m_data_free(size, dataP);
 
+    if (result == COAP_201_CREATED)
+    {
+        object_invalidateRegisterPayload(contextP);
+        if (uriP->objectId == LWM2M_ACL_OBJECT_ID) acl_invalidate(contextP);
+#ifdef LWM2M_OBJECT_JOURNAL
+        journal_save(contextP, uriP->objectId, uriP->instanceId);
+#endif
+    }
+
     LOG_ARG("result: %u.%2u", (result & 0xFF) >> 5, (result & 0x1F));
 
     return result;
@@ -336,7 +618,7 @@ uint8_t object_delete(lwm2m_context_t * contextP,
     uint8_t result;
 
     LOG_URI(uriP);
-    objectP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    objectP = object_find(contextP, uriP->objectId);
     if (NULL == objectP) return COAP_404_NOT_FOUND;
     if (NULL == objectP->deleteFunc) return COAP_405_METHOD_NOT_ALLOWED;
 
@@ -348,6 +630,10 @@ uint8_t object_delete(lwm2m_context_t * contextP,
         if (result == COAP_202_DELETED)
         {
             observe_clear(contextP, uriP);
+            attributes_remove(contextP, uriP);
+#ifdef LWM2M_OBJECT_JOURNAL
+            journal_save(contextP, uriP->objectId, uriP->instanceId);
+#endif
         }
     }
     else
@@ -365,12 +651,20 @@ uint8_t object_delete(lwm2m_context_t * contextP,
             {
                 uriP->flag |= LWM2M_URI_FLAG_INSTANCE_ID;
                 observe_clear(contextP, uriP);
+                attributes_remove(contextP, uriP);
                 uriP->flag &= ~LWM2M_URI_FLAG_INSTANCE_ID;
+#ifdef LWM2M_OBJECT_JOURNAL
+                journal_save(contextP, uriP->objectId, uriP->instanceId);
+#endif
             }
             instanceP = objectP->instanceList;
         }
     }
 
+    // even a failed deletion of all instances may have removed some
+    object_invalidateRegisterPayload(contextP);
+    if (uriP->objectId == LWM2M_ACL_OBJECT_ID) acl_invalidate(contextP);
+
     LOG_ARG("result: %u.%2u", (result & 0xFF) >> 5, (result & 0x1F));
 
     return result;
@@ -388,13 +682,13 @@ uint8_t object_discover(lwm2m_context_t * contextP,
     int size = 0;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
     if (NULL == targetP->discoverFunc) return COAP_501_NOT_IMPLEMENTED;
 
     if (LWM2M_URI_IS_SET_INSTANCE(uriP))
     {
-        if (NULL == lwm2m_list_find(targetP->instanceList, uriP->instanceId)) return COAP_404_NOT_FOUND;
+        if (NULL == object_findInstance(targetP, uriP->instanceId)) return COAP_404_NOT_FOUND;
 
         // single instance read
         if (LWM2M_URI_IS_SET_RESOURCE(uriP))
@@ -444,7 +738,7 @@ uint8_t object_discover(lwm2m_context_t * contextP,
     {
         int len;
 
-        len = discover_serialize(contextP, uriP, serverP, size, dataP, bufferP);
+        len = discover_serialize(uriP, serverP, size, dataP, bufferP);
         if (len <= 0) result = COAP_500_INTERNAL_SERVER_ERROR;
         else *lengthP = len;
     }
@@ -462,10 +756,10 @@ bool object_isInstanceNew(lwm2m_context_t * contextP,
     lwm2m_object_t * targetP;
 
     LOG("Entering");
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, objectId);
+    targetP = object_find(contextP, objectId);
     if (targetP != NULL)
     {
-        if (NULL != lwm2m_list_find(targetP->instanceList, instanceId))
+        if (NULL != object_findInstance(targetP, instanceId))
         {
             return false;
         }
@@ -474,183 +768,129 @@ bool object_isInstanceNew(lwm2m_context_t * contextP,
     return true;
 }
 
-static int prv_getObjectTemplate(uint8_t * buffer,
-                                 size_t length,
-                                 uint16_t id)
-{
-    int index;
-    int result;
-
-    if (length < REG_OBJECT_MIN_LEN) return -1;
-
-    buffer[0] = '<';
-    buffer[1] = '/';
-    index = 2;
-
-    result = utils_intToText(id, buffer + index, length - index);
-    if (result == 0) return -1;
-    index += result;
-
-    if (length - index < REG_OBJECT_MIN_LEN - 3) return -1;
-    buffer[index] = '/';
-    index++;
-
-    return index;
-}
-
-int object_getRegisterPayloadBufferLength(lwm2m_context_t * contextP)
+int object_getRegisterPayload(lwm2m_context_t * contextP,
+                              uint8_t ** bufferP)
 {
-    size_t index;
-    int result;
+    utils_buffer_t payload;
     lwm2m_object_t * objectP;
-    char buffer[REG_OBJECT_MIN_LEN + 5];
+    const char * path;
+    int result;
 
     LOG("Entering");
-    index = strlen(REG_START);
+    utils_bufferInit(&payload, NULL, 0);
 
     if ((contextP->altPath != NULL)
      && (contextP->altPath[0] != 0))
     {
-        index += strlen(contextP->altPath);
+        path = contextP->altPath;
     }
     else
     {
-        index += strlen(REG_DEFAULT_PATH);
+        path = REG_DEFAULT_PATH;
+    }
+    if (utils_bufferAppend(&payload, REG_START, strlen(REG_START)) != 0
+     || utils_bufferAppend(&payload, path, strlen(path)) != 0
+     || utils_bufferAppend(&payload, REG_LWM2M_RESOURCE_TYPE, REG_LWM2M_RESOURCE_TYPE_LEN) != 0)
+    {
+        utils_bufferFree(&payload);
+        return -1;
     }
-
-    index += strlen(REG_LWM2M_RESOURCE_TYPE);
 
     for (objectP = contextP->objectList; objectP != NULL; objectP = objectP->next)
     {
-        size_t start;
-        size_t length;
+        uint8_t uriStr[URI_MAX_STRING_LEN];
+        size_t uriLen;
+        lwm2m_list_t * targetP;
 
         if (objectP->objID == LWM2M_SECURITY_OBJECT_ID) continue;
 
-        start = index;
-        result = prv_getObjectTemplate(buffer, sizeof(buffer), objectP->objID);
-        if (result < 0) return 0;
-        length = result;
-        index += length;
+        // "/id", shared by all the instances of the object
+        uriStr[0] = REG_PATH_SEPARATOR[0];
+        uriLen = 1 + utils_intToText(objectP->objID, uriStr + 1, URI_MAX_STRING_LEN - 1);
 
         if (objectP->instanceList == NULL)
         {
-            index -= 1;
-            index += strlen(REG_PATH_END);
+            if (link_writeUri(&payload, uriStr, uriLen, -1) != 0
+             || link_writeDelimiter(&payload) != 0)
+            {
+                utils_bufferFree(&payload);
+                return -1;
+            }
         }
-        else
+        for (targetP = objectP->instanceList ; targetP != NULL ; targetP = targetP->next)
         {
-            lwm2m_list_t * targetP;
-            for (targetP = objectP->instanceList ; targetP != NULL ; targetP = targetP->next)
+            if (link_writeUri(&payload, uriStr, uriLen, targetP->id) != 0
+             || link_writeDelimiter(&payload) != 0)
             {
-                if (index != start + length)
-                {
-                    index += length;
-                }
-
-                result = utils_intToText(targetP->id, buffer, sizeof(buffer));
-                if (result == 0) return 0;
-                index += result;
-
-                index += strlen(REG_PATH_END);
+                utils_bufferFree(&payload);
+                return -1;
             }
         }
     }
 
-    index += 1;  // account for trailing null
-
-    // Note that object_getRegisterPayload() has REG_PATH_END added after each
-    // object or instance, and then the trailing comma is replaced by null. The
-    // trailing nulls are not counted as part of the payload length, so this
-    // will return a size two bytes greater than what
-    // object_getRegisterPayload() returns.
+    result = link_finish(&payload);
+    if (result <= 0)
+    {
+        utils_bufferFree(&payload);
+        return -1;
+    }
+    *bufferP = payload.data;
 
-    return index;
+    return result;
 }
 
-int object_getRegisterPayload(lwm2m_context_t * contextP,
-                           uint8_t * buffer,
-                           size_t bufferLen)
+// Returns the registration payload, rebuilt only when the object list may have changed.
+// registrationPayloadVersion changes only if the rebuilt payload differs from the previous one.
+// The buffer belongs to the context and must not be freed.
+int object_getRegisterPayloadCache(lwm2m_context_t * contextP,
+                                   uint8_t ** bufferP)
 {
-    size_t index;
-    int result;
-    lwm2m_object_t * objectP;
-
-    LOG("Entering");
-    // index can not be greater than bufferLen
-    index = 0;
-
-    result = utils_stringCopy((char *)buffer, bufferLen, REG_START);
-    if (result < 0) return 0;
-    index += result;
+    uint8_t * buffer;
+    int length;
 
-    if ((contextP->altPath != NULL)
-     && (contextP->altPath[0] != 0))
+    if (contextP->registrationPayload == NULL
+     || contextP->registrationPayloadOutdated)
     {
-        result = utils_stringCopy((char *)buffer + index, bufferLen - index, contextP->altPath);
-    }
-    else
-    {
-        result = utils_stringCopy((char *)buffer + index, bufferLen - index, REG_DEFAULT_PATH);
-    }
-    if (result < 0) return 0;
-    index += result;
-
-    result = utils_stringCopy((char *)buffer + index, bufferLen - index, REG_LWM2M_RESOURCE_TYPE);
-    if (result < 0) return 0;
-    index += result;
-
-    for (objectP = contextP->objectList; objectP != NULL; objectP = objectP->next)
-    {
-        size_t start;
-        size_t length;
-
-        if (objectP->objID == LWM2M_SECURITY_OBJECT_ID) continue;
-
-        start = index;
-        result = prv_getObjectTemplate(buffer + index, bufferLen - index, objectP->objID);
-        if (result < 0) return 0;
-        length = result;
-        index += length;
-
-        if (objectP->instanceList == NULL)
+        LOG("Building registration payload");
+        length = object_getRegisterPayload(contextP, &buffer);
+        if (length <= 0) return 0;
+
+        contextP->registrationPayloadOutdated = false;
+        if (contextP->registrationPayload != NULL
+         && contextP->registrationPayloadLength == (size_t)length
+         && 0 == memcmp(contextP->registrationPayload, buffer, length))
         {
-            index--;
-            result = utils_stringCopy((char *)buffer + index, bufferLen - index, REG_PATH_END);
-            if (result < 0) return 0;
-            index += result;
+            lwm2m_free(buffer);
         }
         else
         {
-            lwm2m_list_t * targetP;
-            for (targetP = objectP->instanceList ; targetP != NULL ; targetP = targetP->next)
-            {
-                if (index != start + length)
-                {
-                    if (bufferLen - index <= length) return 0;
-                    memcpy(buffer + index, buffer + start, length);
-                    index += length;
-                }
-
-                result = utils_intToText(targetP->id, buffer + index, bufferLen - index);
-                if (result == 0) return 0;
-                index += result;
-
-                result = utils_stringCopy((char *)buffer + index, bufferLen - index, REG_PATH_END);
-                if (result < 0) return 0;
-                index += result;
-            }
+            if (contextP->registrationPayload != NULL) lwm2m_free(contextP->registrationPayload);
+            contextP->registrationPayload = buffer;
+            contextP->registrationPayloadLength = length;
+            // 0 is the version of a server which never accepted an object list
+            contextP->registrationPayloadVersion++;
+            if (contextP->registrationPayloadVersion == 0) contextP->registrationPayloadVersion = 1;
         }
     }
 
-    if (index > 0)
-    {
-        index = index - 1;  // remove trailing ','
-    }
+    *bufferP = contextP->registrationPayload;
+    return (int)contextP->registrationPayloadLength;
+}
 
-    buffer[index] = 0;
+// The cached payload is kept to tell if the rebuilt one changed
+void object_invalidateRegisterPayload(lwm2m_context_t * contextP)
+{
+    contextP->registrationPayloadOutdated = true;
+}
 
-    return index;
+void object_freeRegisterPayload(lwm2m_context_t * contextP)
+{
+    if (contextP->registrationPayload != NULL)
+    {
+        lwm2m_free(contextP->registrationPayload);
+        contextP->registrationPayload = NULL;
+        contextP->registrationPayloadLength = 0;
+    }
 }
 
 static lwm2m_list_t * prv_findServerInstance(lwm2m_object_t * objectP,
@@ -698,6 +938,8 @@ static int prv_getMandatoryInfo(lwm2m_object_t * objectP,
     lwm2m_data_t * dataP;
     int size;
     int64_t value;
+    uint8_t * buffer;
+    size_t length;
 
     size = 2;
     dataP = lwm2m_data_new(size);
@@ -719,7 +961,8 @@ static int prv_getMandatoryInfo(lwm2m_object_t * objectP,
     }
     targetP->lifetime = value;
 
-    targetP->binding = utils_stringToBinding(dataP[1].value.asBuffer.buffer, dataP[1].value.asBuffer.length);
+    buffer = lwm2m_data_get_buffer(dataP + 1, &length);
+    targetP->binding = utils_stringToBinding(buffer, length);
 
     lwm2m_data_free(size, dataP);
 
@@ -867,9 +1110,11 @@ uint8_t object_createInstance(lwm2m_context_t * contextP,
                                     lwm2m_data_t * dataP)
 {
     lwm2m_object_t * targetP;
+    uint16_t instanceId;
+    uint8_t result;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
 
     if (NULL == targetP->createFunc)
@@ -877,7 +1122,18 @@ uint8_t object_createInstance(lwm2m_context_t * contextP,
         return COAP_405_METHOD_NOT_ALLOWED;
     }
 
-    return targetP->createFunc(lwm2m_list_newId(targetP->instanceList), dataP->value.asChildren.count, dataP->value.asChildren.array, targetP);
+    instanceId = object_newInstanceId(targetP);
+    result = targetP->createFunc(instanceId, dataP->value.asChildren.count, dataP->value.asChildren.array, targetP);
+    if (result == COAP_201_CREATED)
+    {
+        object_invalidateRegisterPayload(contextP);
+        if (uriP->objectId == LWM2M_ACL_OBJECT_ID) acl_invalidate(contextP);
+#ifdef LWM2M_OBJECT_JOURNAL
+        journal_save(contextP, uriP->objectId, instanceId);
+#endif
+    }
+
+    return result;
 }
 
 uint8_t object_writeInstance(lwm2m_context_t * contextP,
@@ -885,17 +1141,24 @@ uint8_t object_writeInstance(lwm2m_context_t * contextP,
                             lwm2m_data_t * dataP)
 {
     lwm2m_object_t * targetP;
+    uint8_t result;
 
     LOG_URI(uriP);
-    targetP = (lwm2m_object_t *)LWM2M_LIST_FIND(contextP->objectList, uriP->objectId);
+    targetP = object_find(contextP, uriP->objectId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
 
     if (NULL == targetP->writeFunc)
     {
         return COAP_405_METHOD_NOT_ALLOWED;
     }
+    if (uriP->objectId == LWM2M_ACL_OBJECT_ID) acl_invalidate(contextP);
 
-    return targetP->writeFunc(dataP->id, dataP->value.asChildren.count, dataP->value.asChildren.array, targetP);
+    result = targetP->writeFunc(dataP->id, dataP->value.asChildren.count, dataP->value.asChildren.array, targetP);
+#ifdef LWM2M_OBJECT_JOURNAL
+    if (result == COAP_204_CHANGED) journal_save(contextP, uriP->objectId, dataP->id);
+#endif
+
+    return result;
 }
 
 #endif
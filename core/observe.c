@@ -269,7 +269,6 @@ void observe_cancel(lwm2m_context_t * contextP,
         }
         if (targetP != NULL)
         {
-            if (targetP->parameters != NULL) lwm2m_free(targetP->parameters);
             lwm2m_free(targetP);
             if (observedP->watcherList == NULL)
             {
@@ -296,14 +295,9 @@ void observe_clear(lwm2m_context_t * contextP,
                 || observedP->uri.instanceId == uriP->instanceId))
         {
             lwm2m_observed_t * nextP;
-            lwm2m_watcher_t * watcherP;
 
             nextP = observedP->next;
 
-            for (watcherP = observedP->watcherList; watcherP != NULL; watcherP = watcherP->next)
-            {
-                if (watcherP->parameters != NULL) lwm2m_free(watcherP->parameters);
-            }
             LWM2M_LIST_FREE(observedP->watcherList);
 
             prv_unlinkObserved(contextP, observedP);
@@ -324,7 +318,6 @@ uint8_t observe_setParameters(lwm2m_context_t * contextP,
                               lwm2m_attributes_t * attrP)
 {
     uint8_t result;
-    lwm2m_watcher_t * watcherP;
 
     LOG_URI(uriP);
     LOG_ARG("toSet: %08X, toClear: %08X, minPeriod: %d, maxPeriod: %d, greaterThan: %f, lessThan: %f, step: %f",
@@ -335,120 +328,26 @@ uint8_t observe_setParameters(lwm2m_context_t * contextP,
     result = object_checkReadable(contextP, uriP, attrP);
     if (COAP_205_CONTENT != result) return result;
 
-    watcherP = prv_getWatcher(contextP, uriP, serverP);
-    if (watcherP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
-
-    // Check rule “lt” value + 2*”stp” values < “gt” value
-    if ((((attrP->toSet | (watcherP->parameters?watcherP->parameters->toSet:0)) & ~attrP->toClear) & ATTR_FLAG_NUMERIC) == ATTR_FLAG_NUMERIC)
-    {
-        float gt;
-        float lt;
-        float stp;
-
-        if (0 != (attrP->toSet & LWM2M_ATTR_FLAG_GREATER_THAN))
-        {
-            gt = attrP->greaterThan;
-        }
-        else
-        {
-            gt = watcherP->parameters->greaterThan;
-        }
-        if (0 != (attrP->toSet & LWM2M_ATTR_FLAG_LESS_THAN))
-        {
-            lt = attrP->lessThan;
-        }
-        else
-        {
-            lt = watcherP->parameters->lessThan;
-        }
-        if (0 != (attrP->toSet & LWM2M_ATTR_FLAG_STEP))
-        {
-            stp = attrP->step;
-        }
-        else
-        {
-            stp = watcherP->parameters->step;
-        }
-
-        if (lt + (2 * stp) >= gt) return COAP_400_BAD_REQUEST;
-    }
-
-    if (watcherP->parameters == NULL)
-    {
-        if (attrP->toSet != 0)
-        {
-            watcherP->parameters = (lwm2m_attributes_t *)lwm2m_malloc(sizeof(lwm2m_attributes_t));
-            if (watcherP->parameters == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
-            memcpy(watcherP->parameters, attrP, sizeof(lwm2m_attributes_t));
-        }
-    }
-    else
-    {
-        watcherP->parameters->toSet &= ~attrP->toClear;
-        if (attrP->toSet & LWM2M_ATTR_FLAG_MIN_PERIOD)
-        {
-            watcherP->parameters->minPeriod = attrP->minPeriod;
-        }
-        if (attrP->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD)
-        {
-            watcherP->parameters->maxPeriod = attrP->maxPeriod;
-        }
-        if (attrP->toSet & LWM2M_ATTR_FLAG_GREATER_THAN)
-        {
-            watcherP->parameters->greaterThan = attrP->greaterThan;
-        }
-        if (attrP->toSet & LWM2M_ATTR_FLAG_LESS_THAN)
-        {
-            watcherP->parameters->lessThan = attrP->lessThan;
-        }
-        if (attrP->toSet & LWM2M_ATTR_FLAG_STEP)
-        {
-            watcherP->parameters->step = attrP->step;
-        }
-    }
-
-    LOG_ARG("Final toSet: %08X, minPeriod: %d, maxPeriod: %d, greaterThan: %f, lessThan: %f, step: %f",
-            watcherP->parameters->toSet, watcherP->parameters->minPeriod, watcherP->parameters->maxPeriod, watcherP->parameters->greaterThan, watcherP->parameters->lessThan, watcherP->parameters->step);
-
-    return COAP_204_CHANGED;
+    return attributes_set(serverP, uriP, attrP);
 }
 
-lwm2m_observed_t * observe_findByUri(lwm2m_context_t * contextP,
-                                     lwm2m_uri_t * uriP)
+void lwm2m_resource_value_changed(lwm2m_context_t * contextP,
+                                  lwm2m_uri_t * uriP)
 {
     lwm2m_observed_t * targetP;
 
     LOG_URI(uriP);
-    targetP = contextP->observedList;
-    while (targetP != NULL)
+    if (uriP->objectId == LWM2M_ACL_OBJECT_ID)
     {
-        if (targetP->uri.objectId == uriP->objectId)
-        {
-            if ((!LWM2M_URI_IS_SET_INSTANCE(uriP) && !LWM2M_URI_IS_SET_INSTANCE(&(targetP->uri)))
-             || (LWM2M_URI_IS_SET_INSTANCE(uriP) && LWM2M_URI_IS_SET_INSTANCE(&(targetP->uri)) && (uriP->instanceId == targetP->uri.instanceId)))
-             {
-                 if ((!LWM2M_URI_IS_SET_RESOURCE(uriP) && !LWM2M_URI_IS_SET_RESOURCE(&(targetP->uri)))
-                     || (LWM2M_URI_IS_SET_RESOURCE(uriP) && LWM2M_URI_IS_SET_RESOURCE(&(targetP->uri)) && (uriP->resourceId == targetP->uri.resourceId)))
-                 {
-                     LOG_ARG("Found one with%s observers.", targetP->watcherList ? "" : " no");
-                     LOG_URI(&(targetP->uri));
-                     return targetP;
-                 }
-             }
-        }
-        targetP = targetP->next;
+        acl_invalidate(contextP);
     }
+#ifdef LWM2M_OBJECT_JOURNAL
+    if (LWM2M_URI_IS_SET_INSTANCE(uriP))
+    {
+        journal_save(contextP, uriP->objectId, uriP->instanceId);
+    }
+#endif
 
-    LOG("Found nothing");
-    return NULL;
-}
-
-void lwm2m_resource_value_changed(lwm2m_context_t * contextP,
-                                  lwm2m_uri_t * uriP)
-{
-    lwm2m_observed_t * targetP;
-
-    LOG_URI(uriP);
     targetP = contextP->observedList;
     while (targetP != NULL)
     {
@@ -482,6 +381,98 @@ void lwm2m_resource_value_changed(lwm2m_context_t * contextP,
     }
 }
 
+static bool prv_isSleeping(lwm2m_server_t * serverP)
+{
+    if (serverP->sleeping == false) return false;
+
+    return (serverP->binding == BINDING_UQ
+         || serverP->binding == BINDING_SQ
+         || serverP->binding == BINDING_UQS);
+}
+
+int lwm2m_set_sleeping(lwm2m_context_t * contextP,
+                       uint16_t shortServerID,
+                       bool sleeping)
+{
+    lwm2m_server_t * targetP;
+    int result;
+
+    LOG_ARG("shortServerID: %d, sleeping: %s", shortServerID, sleeping ? "true" : "false");
+
+    result = COAP_404_NOT_FOUND;
+    for (targetP = contextP->serverList ; targetP != NULL ; targetP = targetP->next)
+    {
+        if (shortServerID == 0 || targetP->shortID == shortServerID)
+        {
+            targetP->sleeping = sleeping;
+            result = COAP_NO_ERROR;
+        }
+    }
+
+    return result;
+}
+
+// Send the notifications held back while their server was sleeping.
+// All of them are serialized and sent back-to-back to minimize the radio-on time.
+static void prv_flushPending(lwm2m_context_t * contextP)
+{
+    lwm2m_observed_t * targetP;
+
+    for (targetP = contextP->observedList ; targetP != NULL ; targetP = targetP->next)
+    {
+        lwm2m_watcher_t * watcherP;
+        uint8_t * buffer = NULL;
+        size_t length = 0;
+        lwm2m_media_type_t format = LWM2M_CONTENT_TEXT;
+        coap_packet_t message[1];
+
+        for (watcherP = targetP->watcherList ; watcherP != NULL ; watcherP = watcherP->next)
+        {
+            if (watcherP->pending == false
+             || watcherP->active == false
+             || prv_isSleeping(watcherP->server))
+            {
+                continue;
+            }
+
+            LOG("Sending pending notification");
+            LOG_URI(&(targetP->uri));
+
+            // watchers of the same URI share the payload when they use the same format
+            if (buffer != NULL && format != watcherP->format)
+            {
+                lwm2m_free(buffer);
+                buffer = NULL;
+            }
+            if (buffer == NULL)
+            {
+                format = watcherP->format;
+                if (COAP_205_CONTENT != object_read(contextP, &targetP->uri, &format, &buffer, &length))
+                {
+                    // the notification stays pending until the value can be read
+                    buffer = NULL;
+                    continue;
+                }
+                watcherP->format = format;
+            }
+
+            coap_init_message(message, COAP_TYPE_NON, COAP_205_CONTENT, 0);
+            coap_set_header_content_type(message, format);
+            coap_set_payload(message, buffer, length);
+            watcherP->lastMid = contextP->nextMID++;
+            message->mid = watcherP->lastMid;
+            coap_set_header_token(message, watcherP->token, watcherP->tokenLen);
+            coap_set_header_observe(message, watcherP->counter++);
+            if (COAP_NO_ERROR == message_send(contextP, message, watcherP->server->sessionH))
+            {
+                watcherP->pending = false;
+            }
+        }
+
+        if (buffer != NULL) lwm2m_free(buffer);
+    }
+}
+
 void observe_step(lwm2m_context_t * contextP,
                   time_t currentTime,
                   time_t * timeoutP)
@@ -489,6 +480,9 @@ void observe_step(lwm2m_context_t * contextP,
     lwm2m_observed_t * targetP;
 
     LOG("Entering");
+
+    prv_flushPending(contextP);
+
     for (targetP = contextP->observedList ; targetP != NULL ; targetP = targetP->next)
     {
         lwm2m_watcher_t * watcherP;
@@ -533,12 +527,16 @@ void observe_step(lwm2m_context_t * contextP,
             if (watcherP->active == true)
             {
                 bool notify = false;
+                lwm2m_attributes_t attributes;
+                lwm2m_attributes_t * paramP = NULL;
+
+                if (attributes_resolve(watcherP->server, &targetP->uri, &attributes)) paramP = &attributes;
 
                 if (watcherP->update == true)
                 {
                     // value changed, should we notify the server ?
 
-                    if (watcherP->parameters == NULL || watcherP->parameters->toSet == 0)
+                    if (paramP == NULL)
                     {
                         // no conditions
                         notify = true;
@@ -547,30 +545,30 @@ void observe_step(lwm2m_context_t * contextP,
                     }
 
                     if (notify == false
-                     && watcherP->parameters != NULL
-                     && (watcherP->parameters->toSet & ATTR_FLAG_NUMERIC) != 0)
+                     && paramP != NULL
+                     && (paramP->toSet & ATTR_FLAG_NUMERIC) != 0)
                     {
-                        if ((watcherP->parameters->toSet & LWM2M_ATTR_FLAG_LESS_THAN) != 0)
+                        if ((paramP->toSet & LWM2M_ATTR_FLAG_LESS_THAN) != 0)
                         {
                             LOG("Checking lower threshold");
                             // Did we cross the lower threshold ?
                             switch (dataP->type)
                             {
                             case LWM2M_TYPE_INTEGER:
-                                if ((integerValue <= watcherP->parameters->lessThan
-                                  && watcherP->lastValue.asInteger > watcherP->parameters->lessThan)
-                                 || (integerValue >= watcherP->parameters->lessThan
-                                  && watcherP->lastValue.asInteger < watcherP->parameters->lessThan))
+                                if ((integerValue <= paramP->lessThan
+                                  && watcherP->lastValue.asInteger > paramP->lessThan)
+                                 || (integerValue >= paramP->lessThan
+                                  && watcherP->lastValue.asInteger < paramP->lessThan))
                                 {
                                     LOG("Notify on lower threshold crossing");
                                     notify = true;
                                 }
                                 break;
                             case LWM2M_TYPE_FLOAT:
-                                if ((floatValue <= watcherP->parameters->lessThan
-                                  && watcherP->lastValue.asFloat > watcherP->parameters->lessThan)
-                                 || (floatValue >= watcherP->parameters->lessThan
-                                  && watcherP->lastValue.asFloat < watcherP->parameters->lessThan))
+                                if ((floatValue <= paramP->lessThan
+                                  && watcherP->lastValue.asFloat > paramP->lessThan)
+                                 || (floatValue >= paramP->lessThan
+                                  && watcherP->lastValue.asFloat < paramP->lessThan))
                                 {
                                     LOG("Notify on lower threshold crossing");
                                     notify = true;
@@ -580,27 +578,27 @@ void observe_step(lwm2m_context_t * contextP,
                                 break;
                             }
                         }
-                        if ((watcherP->parameters->toSet & LWM2M_ATTR_FLAG_GREATER_THAN) != 0)
+                        if ((paramP->toSet & LWM2M_ATTR_FLAG_GREATER_THAN) != 0)
                         {
                             LOG("Checking upper threshold");
                             // Did we cross the upper threshold ?
                             switch (dataP->type)
                             {
                             case LWM2M_TYPE_INTEGER:
-                                if ((integerValue <= watcherP->parameters->greaterThan
-                                  && watcherP->lastValue.asInteger > watcherP->parameters->greaterThan)
-                                 || (integerValue >= watcherP->parameters->greaterThan
-                                  && watcherP->lastValue.asInteger < watcherP->parameters->greaterThan))
+                                if ((integerValue <= paramP->greaterThan
+                                  && watcherP->lastValue.asInteger > paramP->greaterThan)
+                                 || (integerValue >= paramP->greaterThan
+                                  && watcherP->lastValue.asInteger < paramP->greaterThan))
                                 {
                                     LOG("Notify on lower upper crossing");
                                     notify = true;
                                 }
                                 break;
                             case LWM2M_TYPE_FLOAT:
-                                if ((floatValue <= watcherP->parameters->greaterThan
-                                  && watcherP->lastValue.asFloat > watcherP->parameters->greaterThan)
-                                 || (floatValue >= watcherP->parameters->greaterThan
-                                  && watcherP->lastValue.asFloat < watcherP->parameters->greaterThan))
+                                if ((floatValue <= paramP->greaterThan
+                                  && watcherP->lastValue.asFloat > paramP->greaterThan)
+                                 || (floatValue >= paramP->greaterThan
+                                  && watcherP->lastValue.asFloat < paramP->greaterThan))
                                 {
                                     LOG("Notify on lower upper crossing");
                                     notify = true;
@@ -610,7 +608,7 @@ void observe_step(lwm2m_context_t * contextP,
                                 break;
                             }
                         }
-                        if ((watcherP->parameters->toSet & LWM2M_ATTR_FLAG_STEP) != 0)
+                        if ((paramP->toSet & LWM2M_ATTR_FLAG_STEP) != 0)
                         {
                             LOG("Checking step");
 
@@ -621,8 +619,8 @@ void observe_step(lwm2m_context_t * contextP,
                                 int64_t diff;
 
                                 diff = integerValue - watcherP->lastValue.asInteger;
-                                if ((diff < 0 && (0 - diff) >= watcherP->parameters->step)
-                                 || (diff >= 0 && diff >= watcherP->parameters->step))
+                                if ((diff < 0 && (0 - diff) >= paramP->step)
+                                 || (diff >= 0 && diff >= paramP->step))
                                 {
                                     LOG("Notify on step condition");
                                     notify = true;
@@ -634,8 +632,8 @@ void observe_step(lwm2m_context_t * contextP,
                                 double diff;
 
                                 diff = floatValue - watcherP->lastValue.asFloat;
-                                if ((diff < 0 && (0 - diff) >= watcherP->parameters->step)
-                                 || (diff >= 0 && diff >= watcherP->parameters->step))
+                                if ((diff < 0 && (0 - diff) >= paramP->step)
+                                 || (diff >= 0 && diff >= paramP->step))
                                 {
                                     LOG("Notify on step condition");
                                     notify = true;
@@ -648,15 +646,15 @@ void observe_step(lwm2m_context_t * contextP,
                         }
                     }
 
-                    if (watcherP->parameters != NULL
-                     && (watcherP->parameters->toSet & LWM2M_ATTR_FLAG_MIN_PERIOD) != 0)
+                    if (paramP != NULL
+                     && (paramP->toSet & LWM2M_ATTR_FLAG_MIN_PERIOD) != 0)
                     {
-                        LOG_ARG("Checking minimal period (%d s)", watcherP->parameters->minPeriod);
+                        LOG_ARG("Checking minimal period (%d s)", paramP->minPeriod);
 
-                        if (watcherP->lastTime + watcherP->parameters->minPeriod > currentTime)
+                        if (watcherP->lastTime + paramP->minPeriod > currentTime)
                         {
                             // Minimum Period did not elapse yet
-                            interval = watcherP->lastTime + watcherP->parameters->minPeriod - currentTime;
+                            interval = watcherP->lastTime + paramP->minPeriod - currentTime;
                             if (*timeoutP > interval) *timeoutP = interval;
                             notify = false;
                         }
@@ -670,19 +668,27 @@ void observe_step(lwm2m_context_t * contextP,
 
                 // Is the Maximum Period reached ?
                 if (notify == false
-                 && watcherP->parameters != NULL
-                 && (watcherP->parameters->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) != 0)
+                 && paramP != NULL
+                 && (paramP->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) != 0)
                 {
-                    LOG_ARG("Checking maximal period (%d s)", watcherP->parameters->maxPeriod);
+                    LOG_ARG("Checking maximal period (%d s)", paramP->maxPeriod);
 
-                    if (watcherP->lastTime + watcherP->parameters->maxPeriod <= currentTime)
+                    if (watcherP->lastTime + paramP->maxPeriod <= currentTime)
                     {
                         LOG("Notify on maximal period");
                         notify = true;
                     }
                 }
 
-                if (notify == true)
+                if (notify == true && prv_isSleeping(watcherP->server))
+                {
+                    // hold the notification back, the current value will be sent on wake up
+                    LOG("Server is sleeping, notification is pending");
+                    watcherP->lastTime = currentTime;
+                    watcherP->update = false;
+                    watcherP->pending = true;
+                }
+                else if (notify == true)
                 {
                     if (buffer == NULL)
                     {
@@ -738,10 +744,10 @@ void observe_step(lwm2m_context_t * contextP,
                     }
                 }
 
-                if (watcherP->parameters != NULL && (watcherP->parameters->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) != 0)
+                if (paramP != NULL && (paramP->toSet & LWM2M_ATTR_FLAG_MAX_PERIOD) != 0)
                 {
                     // update timers
-                    interval = watcherP->lastTime + watcherP->parameters->maxPeriod - currentTime;
+                    interval = watcherP->lastTime + paramP->maxPeriod - currentTime;
                     if (*timeoutP > interval) *timeoutP = interval;
                 }
             }
@@ -794,9 +800,11 @@ static void prv_obsRequestCallback(lwm2m_transaction_t * transacP,
     coap_packet_t * packet = (coap_packet_t *)message;
     uint8_t code;
     uint32_t count;
+    bool confirmed;
 
     observationP->pendingTransactions--;
 
+    confirmed = false;
     switch (observationP->status)
     {
     case STATE_DEREG_PENDING:
@@ -806,6 +814,7 @@ static void prv_obsRequestCallback(lwm2m_transaction_t * transacP,
 
     case STATE_REG_PENDING:
         observationP->status = STATE_REGISTERED;
+        confirmed = true;
         break;
 
     default:
@@ -833,10 +842,15 @@ static void prv_obsRequestCallback(lwm2m_transaction_t * transacP,
                                code,
                                LWM2M_CONTENT_TEXT, NULL, 0,
                                observationP->userData);
+        observationP->contextP->clientStore->removeObservationFunc(observationP, observationP->contextP->clientStore);
         observe_remove(observationP);
     }
     else
     {
+        if (confirmed)
+        {
+            observationP->contextP->clientStore->addObservationFunc(observationP, observationP->contextP->clientStore);
+        }
         count = 0;
         coap_get_header_observe(message, &count);
         observationP->callback(observationP->clientP->internalID,
@@ -863,7 +877,7 @@ int lwm2m_observe(lwm2m_context_t * contextP,
 
     if (!LWM2M_URI_IS_SET_INSTANCE(uriP) && LWM2M_URI_IS_SET_RESOURCE(uriP)) return COAP_400_BAD_REQUEST;
 
-    clientP = (lwm2m_client_t *)lwm2m_list_find((lwm2m_list_t *)contextP->clientList, clientID);
+    clientP = contextP->clientStore->findClientFunc(clientID, contextP->clientStore);
     if (clientP == NULL) return COAP_404_NOT_FOUND;
 
     for (observationP = clientP->observationList; observationP != NULL; observationP = observationP->next)
@@ -886,9 +900,23 @@ int lwm2m_observe(lwm2m_context_t * contextP,
         observationP->id = lwm2m_list_newId((lwm2m_list_t *)clientP->observationList);
         memcpy(&observationP->uri, uriP, sizeof(lwm2m_uri_t));
         observationP->clientP = clientP;
+        observationP->contextP = contextP;
 
         observationP->clientP->observationList = (lwm2m_observation_t *)LWM2M_LIST_ADD(observationP->clientP->observationList, observationP);
     }
+    if (observationP->status == STATE_REG_PENDING
+     && observationP->pendingTransactions > 0
+     && (clientP->binding == BINDING_UQ || clientP->binding == BINDING_SQ || clientP->binding == BINDING_UQS))
+    {
+        // an identical observe request is already waiting for the client to wake up.
+        // Its caller keeps the observation: a different caller is refused.
+        if (observationP->callback == callback
+         && observationP->userData == userData)
+        {
+            return COAP_NO_ERROR;
+        }
+        return COAP_412_PRECONDITION_FAILED;
+    }
     observationP->status = STATE_REG_PENDING;
     observationP->callback = callback;
     observationP->userData = userData;
@@ -907,7 +935,11 @@ int lwm2m_observe(lwm2m_context_t * contextP,
     }
 
     coap_set_header_observe(transactionP->message, 0);
-    if (clientP->supportJSON == true)
+    if (clientP->supportSenMLCBOR == true)
+    {
+        coap_set_header_accept(transactionP->message, LWM2M_CONTENT_SENML_CBOR);
+    }
+    else if (clientP->supportJSON == true)
     {
         coap_set_header_accept(transactionP->message, LWM2M_CONTENT_JSON);
     }
@@ -923,8 +955,15 @@ int lwm2m_observe(lwm2m_context_t * contextP,
 
     if (clientP->binding == BINDING_UQ || clientP->binding == BINDING_SQ || clientP->binding == BINDING_UQS)
     {
-        clientP->queuedTransactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(clientP->queuedTransactionList, transactionP);
-        return 0;
+        int result;
+
+        result = queue_add(contextP, clientP, transactionP);
+        if (result != COAP_NO_ERROR)
+        {
+            observationP->pendingTransactions--;
+            transaction_free(transactionP);
+        }
+        return result;
     }
     else
     {
@@ -945,7 +984,7 @@ int lwm2m_observe_cancel(lwm2m_context_t * contextP,
     LOG_ARG("clientID: %d", clientID);
     LOG_URI(uriP);
 
-    clientP = (lwm2m_client_t *)lwm2m_list_find((lwm2m_list_t *)contextP->clientList, clientID);
+    clientP = contextP->clientStore->findClientFunc(clientID, contextP->clientStore);
     if (clientP == NULL) return COAP_404_NOT_FOUND;
 
     observationP = prv_findObservationByURI(clientP, uriP);
@@ -963,11 +1002,45 @@ int lwm2m_observe_cancel(lwm2m_context_t * contextP,
     observationP->callback = NULL;
     observationP->userData = NULL;
 
+    contextP->clientStore->removeObservationFunc(observationP, contextP->clientStore);
     observe_remove(observationP);
 
     return COAP_NO_ERROR;
 }
 
+#ifdef LWM2M_REGISTRATION_STORE
+// Creates the observation with the ID, or updates the one already using it, as confirmed by the client.
+// Used to restore the observations from the registration store.
+int observe_restore(lwm2m_context_t * contextP,
+                    lwm2m_client_t * clientP,
+                    uint16_t id,
+                    lwm2m_uri_t * uriP,
+                    lwm2m_result_callback_t callback,
+                    void * userData)
+{
+    lwm2m_observation_t * observationP;
+
+    observationP = (lwm2m_observation_t *)lwm2m_list_find((lwm2m_list_t *)clientP->observationList, id);
+    if (observationP == NULL)
+    {
+        observationP = (lwm2m_observation_t *)lwm2m_malloc(sizeof(lwm2m_observation_t));
+        if (observationP == NULL) return -1;
+        memset(observationP, 0, sizeof(lwm2m_observation_t));
+
+        observationP->id = id;
+        observationP->clientP = clientP;
+        clientP->observationList = (lwm2m_observation_t *)LWM2M_LIST_ADD(clientP->observationList, observationP);
+    }
+    observationP->contextP = contextP;
+    memcpy(&observationP->uri, uriP, sizeof(lwm2m_uri_t));
+    observationP->status = STATE_REGISTERED;
+    observationP->callback = callback;
+    observationP->userData = userData;
+
+    return 0;
+}
+#endif
+
 bool observe_handleNotify(lwm2m_context_t * contextP,
                            void * fromSessionH,
                            coap_packet_t * message,
@@ -990,10 +1063,10 @@ bool observe_handleNotify(lwm2m_context_t * contextP,
     clientID = (tokenP[0] << 8) | tokenP[1];
     obsID = (tokenP[2] << 8) | tokenP[3];
 
-    clientP = (lwm2m_client_t *)lwm2m_list_find((lwm2m_list_t *)contextP->clientList, clientID);
+    clientP = contextP->clientStore->findClientFunc(clientID, contextP->clientStore);
     if (clientP == NULL) return false;
 
-    observationP = (lwm2m_observation_t *)lwm2m_list_find((lwm2m_list_t *)clientP->observationList, obsID);
+    observationP = contextP->clientStore->findObservationFunc(clientP, obsID, contextP->clientStore);
     if (observationP == NULL || observationP->status == STATE_DEREG_PENDING)
     {
         coap_init_message(response, COAP_TYPE_RST, 0, message->mid);
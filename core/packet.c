@@ -146,8 +146,22 @@ static uint8_t handle_request(lwm2m_context_t * contextP,
     }
     break;
 
-#ifdef LWM2M_BOOTSTRAP
     case LWM2M_URI_FLAG_DELETE_ALL:
+#ifdef LWM2M_SUPPORT_CBOR
+        if (COAP_FETCH == message->code
+         || COAP_IPATCH == message->code)
+        {
+            lwm2m_server_t * serverP;
+
+            serverP = utils_findServer(contextP, fromSessionH);
+            if (serverP != NULL)
+            {
+                result = dm_handleCompositeRequest(contextP, serverP, message, response);
+            }
+            break;
+        }
+#endif
+#ifdef LWM2M_BOOTSTRAP
         if (COAP_DELETE != message->code)
         {
             result = COAP_400_BAD_REQUEST;
@@ -156,8 +170,10 @@ static uint8_t handle_request(lwm2m_context_t * contextP,
         {
             result = bootstrap_handleDeleteAll(contextP, fromSessionH);
         }
+#endif
         break;
 
+#ifdef LWM2M_BOOTSTRAP
     case LWM2M_URI_FLAG_BOOTSTRAP:
         if (message->code == COAP_POST)
         {
@@ -171,6 +187,10 @@ static uint8_t handle_request(lwm2m_context_t * contextP,
     case LWM2M_URI_FLAG_REGISTRATION:
         result = registration_handleRequest(contextP, uriP, fromSessionH, message, response);
         break;
+
+    case LWM2M_URI_FLAG_SEND:
+        result = send_handleRequest(contextP, fromSessionH, message);
+        break;
 #endif
 #ifdef LWM2M_BOOTSTRAP_SERVER_MODE
     case LWM2M_URI_FLAG_BOOTSTRAP:
@@ -213,7 +233,7 @@ void lwm2m_handle_packet(lwm2m_context_t * contextP,
         LOG_ARG("Parsed: ver %u, type %u, tkl %u, code %u.%.2u, mid %u, Content type: %d",
                 message->version, message->type, message->token_len, message->code >> 5, message->code & 0x1F, message->mid, message->content_type);
         LOG_ARG("Payload: %.*s", message->payload_len, message->payload);
-        if (message->code >= COAP_GET && message->code <= COAP_DELETE)
+        if (message->code >= COAP_GET && message->code <= COAP_IPATCH)
         {
             uint32_t block_num = 0;
             uint16_t block_size = REST_MAX_CHUNK_SIZE;
@@ -304,8 +324,13 @@ void lwm2m_handle_packet(lwm2m_context_t * contextP,
                 uint8_t *payload = response->payload;
                 if ( IS_OPTION(message, COAP_OPTION_BLOCK2) )
                 {
+                    if ( IS_OPTION(response, COAP_OPTION_BLOCK2) )
+                    {
+                        /* the request handler serialized the requested block only */
+                        LOG_ARG("Blockwise: block %u serialized by the handler", block_num);
+                    }
                     /* unchanged new_offset indicates that resource is unaware of blockwise transfer */
-                    if (new_offset==block_offset)
+                    else if (new_offset==block_offset)
                     {
                         LOG_ARG("Blockwise: unaware resource with payload length %u/%u", response->payload_len, block_size);
                         if (block_offset >= response->payload_len)
@@ -439,6 +464,11 @@ uint8_t message_send(lwm2m_context_t * contextP,
         }
         lwm2m_free(pktBuffer);
     }
+    else
+    {
+        // the options are freed by coap_serialize_message() otherwise
+        coap_free_header(message);
+    }
 
     return result;
 }
@@ -0,0 +1,329 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Server side queue of the requests sent to clients in queue mode (UQ, SQ, UQS bindings).
+ *
+ * Requests are held until the client sends a registration update. The queue:
+ *  - holds at most LWM2M_QUEUE_MAX_SIZE requests per client,
+ *  - drops requests older than LWM2M_QUEUE_TTL seconds,
+ *  - coalesces identical reads: the duplicates are not sent but completed along with the first one,
+ *  - supersedes a queued write on a resource by a newer one (last write wins),
+ *  - keeps the order of the requests on a same path: a read or a write is only merged with a queued
+ *    one when no other request on the path, or on a path containing it, was queued after it,
+ *  - drains with at most LWM2M_QUEUE_NSTART outstanding requests to the client.
+ */
+
+#include "internals.h"
+
+#ifdef LWM2M_SERVER_MODE
+
+static bool prv_isSamePath(multi_option_t * path1,
+                           multi_option_t * path2)
+{
+    while (path1 != NULL && path2 != NULL)
+    {
+        if (path1->len != path2->len) return false;
+        if (memcmp(path1->data, path2->data, path1->len) != 0) return false;
+
+        path1 = path1->next;
+        path2 = path2->next;
+    }
+
+    return (path1 == NULL && path2 == NULL);
+}
+
+// True if one of the paths contains the other one
+static bool prv_isOverlappingPath(multi_option_t * path1,
+                                  multi_option_t * path2)
+{
+    while (path1 != NULL && path2 != NULL)
+    {
+        if (path1->len != path2->len) return false;
+        if (memcmp(path1->data, path2->data, path1->len) != 0) return false;
+
+        path1 = path1->next;
+        path2 = path2->next;
+    }
+
+    return true;
+}
+
+// A block of a read or of a write is never merged: the blocks of another request differ
+static bool prv_isRead(coap_packet_t * messageP)
+{
+    return (messageP->code == COAP_GET
+         && !IS_OPTION(messageP, COAP_OPTION_OBSERVE)
+         && !IS_OPTION(messageP, COAP_OPTION_BLOCK1)
+         && !IS_OPTION(messageP, COAP_OPTION_BLOCK2));
+}
+
+static bool prv_isWrite(coap_packet_t * messageP)
+{
+    return (messageP->code == COAP_PUT
+         && messageP->payload_len != 0
+         && !IS_OPTION(messageP, COAP_OPTION_URI_QUERY)
+         && !IS_OPTION(messageP, COAP_OPTION_BLOCK1)
+         && !IS_OPTION(messageP, COAP_OPTION_BLOCK2));
+}
+
+static bool prv_isSameAccept(coap_packet_t * message1,
+                             coap_packet_t * message2)
+{
+    if (IS_OPTION(message1, COAP_OPTION_ACCEPT) != IS_OPTION(message2, COAP_OPTION_ACCEPT)) return false;
+    if (!IS_OPTION(message1, COAP_OPTION_ACCEPT)) return true;
+    if (message1->accept_num != message2->accept_num) return false;
+
+    return (memcmp(message1->accept, message2->accept, message1->accept_num * sizeof(uint16_t)) == 0);
+}
+
+static int prv_countInFlight(lwm2m_context_t * contextP,
+                             lwm2m_client_t * clientP)
+{
+    lwm2m_transaction_t * transacP;
+    int count;
+
+    count = 0;
+    for (transacP = contextP->transactionList ; transacP != NULL ; transacP = transacP->next)
+    {
+        if (lwm2m_session_is_equal(transacP->peerH, clientP->sessionH, contextP->userData) == true)
+        {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+static int prv_count(lwm2m_transaction_t * transacP)
+{
+    int count;
+
+    count = 0;
+    while (transacP != NULL)
+    {
+        count++;
+        transacP = transacP->next;
+    }
+
+    return count;
+}
+
+static void prv_drain(lwm2m_context_t * contextP,
+                      lwm2m_client_t * clientP)
+{
+    int inFlight;
+
+    inFlight = prv_countInFlight(contextP, clientP);
+    while (clientP->queuedTransactionList != NULL
+        && inFlight < LWM2M_QUEUE_NSTART)
+    {
+        lwm2m_transaction_t * transacP;
+
+        transacP = clientP->queuedTransactionList;
+        clientP->queuedTransactionList = transacP->next;
+        transacP->next = NULL;
+
+        LOG_ARG("Sending queued transaction %d", transacP->mID);
+        contextP->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(contextP->transactionList, transacP);
+        if (transaction_send(contextP, transacP) == 0)
+        {
+            inFlight++;
+        }
+    }
+
+    if (clientP->queuedTransactionList == NULL)
+    {
+        clientP->queueDraining = false;
+    }
+}
+
+int queue_add(lwm2m_context_t * contextP,
+              lwm2m_client_t * clientP,
+              lwm2m_transaction_t * transacP)
+{
+    coap_packet_t * messageP = (coap_packet_t *)transacP->message;
+    lwm2m_transaction_t * queuedP;
+    lwm2m_transaction_t * previousP;
+    lwm2m_transaction_t * mergeP;
+    lwm2m_transaction_t * mergePreviousP;
+
+    LOG_ARG("clientID: %d, mID: %d", clientP->internalID, transacP->mID);
+
+    // the options of a message serialized on creation were released: they are read back from its buffer
+    if (transacP->buffer != NULL
+     && coap_parse_message(messageP, transacP->buffer, transacP->buffer_len) != NO_ERROR)
+    {
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    transacP->queue_time = lwm2m_gettime();
+
+    // the last queued request this one can be merged with, if no other request on its path follows it
+    mergeP = NULL;
+    mergePreviousP = NULL;
+    previousP = NULL;
+    for (queuedP = clientP->queuedTransactionList ; queuedP != NULL ; queuedP = queuedP->next)
+    {
+        coap_packet_t * queuedMessageP = (coap_packet_t *)queuedP->message;
+
+        if (prv_isOverlappingPath(messageP->uri_path, queuedMessageP->uri_path))
+        {
+            if (prv_isSamePath(messageP->uri_path, queuedMessageP->uri_path)
+             && ((prv_isRead(messageP) && prv_isRead(queuedMessageP) && prv_isSameAccept(messageP, queuedMessageP))
+              || (prv_isWrite(messageP) && prv_isWrite(queuedMessageP))))
+            {
+                mergeP = queuedP;
+                mergePreviousP = previousP;
+            }
+            else if (!prv_isRead(messageP) || !prv_isRead(queuedMessageP))
+            {
+                // reads can be answered in any order, anything else must not be overtaken
+                mergeP = NULL;
+            }
+        }
+        previousP = queuedP;
+    }
+
+    if (mergeP != NULL)
+    {
+        if (prv_isRead(messageP))
+        {
+            // the queued read will answer this one too
+            LOG_ARG("Coalescing read with queued transaction %d", mergeP->mID);
+            transacP->next = mergeP->coalesced;
+            mergeP->coalesced = transacP;
+            return COAP_NO_ERROR;
+        }
+
+        // last write wins: this one takes the place of the queued write which is completed along with it
+        LOG_ARG("Superseding queued transaction %d", mergeP->mID);
+        transacP->next = mergeP->next;
+        if (mergePreviousP == NULL)
+        {
+            clientP->queuedTransactionList = transacP;
+        }
+        else
+        {
+            mergePreviousP->next = transacP;
+        }
+        mergeP->next = NULL;
+        transacP->coalesced = mergeP;
+        if (clientP->queueDraining == true)
+        {
+            prv_drain(contextP, clientP);
+        }
+        return COAP_NO_ERROR;
+    }
+
+    if (prv_count(clientP->queuedTransactionList) >= LWM2M_QUEUE_MAX_SIZE)
+    {
+        LOG("Queue is full");
+        return COAP_503_SERVICE_UNAVAILABLE;
+    }
+
+    transacP->next = NULL;
+    if (clientP->queuedTransactionList == NULL)
+    {
+        clientP->queuedTransactionList = transacP;
+    }
+    else
+    {
+        // keep the requests in issuing order
+        for (queuedP = clientP->queuedTransactionList ; queuedP->next != NULL ; queuedP = queuedP->next);
+        queuedP->next = transacP;
+    }
+
+    if (clientP->queueDraining == true)
+    {
+        prv_drain(contextP, clientP);
+    }
+
+    return COAP_NO_ERROR;
+}
+
+void queue_wake(lwm2m_context_t * contextP,
+                lwm2m_client_t * clientP)
+{
+    LOG_ARG("clientID: %d", clientP->internalID);
+
+    if (clientP->queuedTransactionList == NULL) return;
+
+    clientP->queueDraining = true;
+    prv_drain(contextP, clientP);
+}
+
+void queue_step(lwm2m_context_t * contextP,
+                lwm2m_client_t * clientP,
+                time_t currentTime,
+                time_t * timeoutP)
+{
+    lwm2m_transaction_t * transacP;
+    lwm2m_transaction_t * previousP;
+
+    previousP = NULL;
+    transacP = clientP->queuedTransactionList;
+    while (transacP != NULL)
+    {
+        lwm2m_transaction_t * nextP = transacP->next;
+
+        if (transacP->queue_time + LWM2M_QUEUE_TTL <= currentTime)
+        {
+            LOG_ARG("Queued transaction %d expired", transacP->mID);
+            if (previousP == NULL)
+            {
+                clientP->queuedTransactionList = nextP;
+            }
+            else
+            {
+                previousP->next = nextP;
+            }
+            transaction_complete(transacP, NULL);
+            transaction_free(transacP);
+        }
+        else
+        {
+            time_t interval;
+
+            interval = transacP->queue_time + LWM2M_QUEUE_TTL - currentTime;
+            if (*timeoutP > interval) *timeoutP = interval;
+            previousP = transacP;
+        }
+
+        transacP = nextP;
+    }
+
+    if (clientP->queueDraining == true)
+    {
+        prv_drain(contextP, clientP);
+    }
+}
+
+// The queued requests fail: their callbacks release their user data and the observations waiting for them.
+void queue_free(lwm2m_client_t * clientP)
+{
+    lwm2m_transaction_t * transacP;
+
+    while ((transacP = clientP->queuedTransactionList) != NULL)
+    {
+        clientP->queuedTransactionList = transacP->next;
+        transaction_complete(transacP, NULL);
+        transaction_free(transacP);
+    }
+}
+
+#endif
@@ -203,6 +203,7 @@ static void prv_handleRegistrationReply(lwm2m_transaction_t * transacP,
         if (packet != NULL && packet->code == COAP_201_CREATED)
         {
             targetP->status = STATE_REGISTERED;
+            targetP->payloadVersion = targetP->sentVersion;
             if (NULL != targetP->location)
             {
                 lwm2m_free(targetP->location);
@@ -229,32 +230,15 @@ static uint8_t prv_register(lwm2m_context_t * contextP,
     int payload_length;
     lwm2m_transaction_t * transaction;
 
-    payload_length = object_getRegisterPayloadBufferLength(contextP);
+    payload_length = object_getRegisterPayloadCache(contextP, &payload);
     if(payload_length == 0) return COAP_500_INTERNAL_SERVER_ERROR;
-    payload = lwm2m_malloc(payload_length);
-    if(!payload) return COAP_500_INTERNAL_SERVER_ERROR;
-    payload_length = object_getRegisterPayload(contextP, payload, payload_length);
-    if(payload_length == 0)
-    {
-        lwm2m_free(payload);
-        return COAP_500_INTERNAL_SERVER_ERROR;
-    }
 
     query_length = prv_getRegistrationQueryLength(contextP, server);
-    if(query_length == 0)
-    {
-        lwm2m_free(payload);
-        return COAP_500_INTERNAL_SERVER_ERROR;
-    }
+    if(query_length == 0) return COAP_500_INTERNAL_SERVER_ERROR;
     query = lwm2m_malloc(query_length);
-    if(!query)
-    {
-        lwm2m_free(payload);
-        return COAP_500_INTERNAL_SERVER_ERROR;
-    }
+    if(!query) return COAP_500_INTERNAL_SERVER_ERROR;
     if(prv_getRegistrationQuery(contextP, server, query, query_length) != query_length)
     {
-        lwm2m_free(payload);
         lwm2m_free(query);
         return COAP_500_INTERNAL_SERVER_ERROR;
     }
@@ -266,7 +250,6 @@ static uint8_t prv_register(lwm2m_context_t * contextP,
 
     if (NULL == server->sessionH)
     {
-        lwm2m_free(payload);
         lwm2m_free(query);
         return COAP_503_SERVICE_UNAVAILABLE;
     }
@@ -274,7 +257,6 @@ static uint8_t prv_register(lwm2m_context_t * contextP,
     transaction = transaction_new(server->sessionH, COAP_POST, NULL, NULL, contextP->nextMID++, 4, NULL);
     if (transaction == NULL)
     {
-        lwm2m_free(payload);
         lwm2m_free(query);
         return COAP_503_SERVICE_UNAVAILABLE;
     }
@@ -290,13 +272,12 @@ static uint8_t prv_register(lwm2m_context_t * contextP,
     contextP->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(contextP->transactionList, transaction);
     if (transaction_send(contextP, transaction) != 0)
     {
-        lwm2m_free(payload);
         lwm2m_free(query);
         return COAP_503_SERVICE_UNAVAILABLE;
     }
 
-    lwm2m_free(payload);
     lwm2m_free(query);
+    server->sentVersion = contextP->registrationPayloadVersion;
     server->status = STATE_REG_PENDING;
 
     return COAP_NO_ERROR;
@@ -318,6 +299,7 @@ static void prv_handleRegistrationUpdateReply(lwm2m_transaction_t * transacP,
         if (packet != NULL && packet->code == COAP_204_CHANGED)
         {
             targetP->status = STATE_REGISTERED;
+            targetP->payloadVersion = targetP->sentVersion;
             LOG("Registration update successful");
         }
         else
@@ -328,42 +310,26 @@ static void prv_handleRegistrationUpdateReply(lwm2m_transaction_t * transacP,
     }
 }
 
+// The object list is sent only if it changed since the last time this server accepted it.
 static int prv_updateRegistration(lwm2m_context_t * contextP,
-                                  lwm2m_server_t * server,
-                                  bool withObjects)
+                                  lwm2m_server_t * server)
 {
     lwm2m_transaction_t * transaction;
-    uint8_t * payload = NULL;
+    uint8_t * payload;
     int payload_length;
 
+    payload_length = object_getRegisterPayloadCache(contextP, &payload);
+    if (payload_length == 0) return COAP_500_INTERNAL_SERVER_ERROR;
+
     transaction = transaction_new(server->sessionH, COAP_POST, NULL, NULL, contextP->nextMID++, 4, NULL);
     if (transaction == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
 
     coap_set_header_uri_path(transaction->message, server->location);
 
-    if (withObjects == true)
+    if (server->payloadVersion != contextP->registrationPayloadVersion)
     {
-        payload_length = object_getRegisterPayloadBufferLength(contextP);
-        if(payload_length == 0)
-        {
-            transaction_free(transaction);
-            return COAP_500_INTERNAL_SERVER_ERROR;
-        }
-
-        payload = lwm2m_malloc(payload_length);
-        if(!payload)
-        {
-            transaction_free(transaction);
-            return COAP_500_INTERNAL_SERVER_ERROR;
-        }
-
-        payload_length = object_getRegisterPayload(contextP, payload, payload_length);
-        if(payload_length == 0)
-        {
-            transaction_free(transaction);
-            lwm2m_free(payload);
-            return COAP_500_INTERNAL_SERVER_ERROR;
-        }
+        LOG("Object list changed");
+        coap_set_header_content_type(transaction->message, LWM2M_CONTENT_LINK);
         coap_set_payload(transaction->message, payload, payload_length);
     }
 
@@ -374,13 +340,10 @@ static int prv_updateRegistration(lwm2m_context_t * contextP,
 
     if (transaction_send(contextP, transaction) == 0)
     {
+        server->sentVersion = contextP->registrationPayloadVersion;
         server->status = STATE_REG_UPDATE_PENDING;
     }
 
-    if (withObjects == true)
-    {
-        lwm2m_free(payload);
-    }
     return COAP_NO_ERROR;
 }
 
@@ -396,6 +359,12 @@ int lwm2m_update_registration(lwm2m_context_t * contextP,
 
     result = COAP_NO_ERROR;
 
+    if (withObjects == true)
+    {
+        // the application may have changed the instance lists directly
+        object_invalidateRegisterPayload(contextP);
+    }
+
     targetP = contextP->serverList;
     if (targetP == NULL)
     {
@@ -493,6 +462,15 @@ uint8_t registration_start(lwm2m_context_t * contextP)
 }
 
 
+// Returns true if the server accepts requests from and to the client
+bool registration_isRegistered(lwm2m_server_t * serverP)
+{
+    return (serverP->status == STATE_REGISTERED
+         || serverP->status == STATE_REG_UPDATE_NEEDED
+         || serverP->status == STATE_REG_FULL_UPDATE_NEEDED
+         || serverP->status == STATE_REG_UPDATE_PENDING);
+}
+
 /*
  * Returns STATE_REG_PENDING if at least one registration is still pending
  * Returns STATE_REGISTERED if no registration is pending and there is at least one server the client is registered to
@@ -589,124 +567,94 @@ void registration_deregister(lwm2m_context_t * contextP,
 #endif
 
 #ifdef LWM2M_SERVER_MODE
-static void prv_freeClientObjectList(lwm2m_client_object_t * objects)
+// Parameters of a registration or registration update, pointing into the URI query
+typedef struct
 {
-    while (objects != NULL)
-    {
-        lwm2m_client_object_t * objP;
-
-        while (objects->instanceList != NULL)
-        {
-            lwm2m_list_t * target;
-
-            target = objects->instanceList;
-            objects->instanceList = objects->instanceList->next;
-            lwm2m_free(target);
-        }
-
-        objP = objects;
-        objects = objects->next;
-        lwm2m_free(objP);
-    }
-}
+    uint8_t *       name;
+    size_t          nameLength;
+    uint8_t *       type;
+    size_t          typeLength;
+    uint8_t *       msisdn;
+    size_t          msisdnLength;
+    uint8_t *       version;
+    size_t          versionLength;
+    uint32_t        lifetime;
+    lwm2m_binding_t binding;
+} _parameters_t;
+
+// String shared by the clients, as the type and the alternate path are the same for many clients
+typedef struct _lwm2m_shared_string_
+{
+    struct _lwm2m_shared_string_ * next;
+    size_t                         refCount;
+    size_t                         length;
+    char                           value[];
+} _shared_string_t;
 
 static int prv_getParameters(multi_option_t * query,
-                             char ** nameP,
-                             char ** typeP,
-                             uint32_t * lifetimeP,
-                             char ** msisdnP,
-                             lwm2m_binding_t * bindingP,
-                             char ** versionP)
+                             _parameters_t * paramP)
 {
-    *nameP = NULL;
-    *typeP = NULL;
-    *lifetimeP = 0;
-    *msisdnP = NULL;
-    *bindingP = BINDING_UNKNOWN;
-    *versionP = NULL;
+    memset(paramP, 0, sizeof(_parameters_t));
+    paramP->binding = BINDING_UNKNOWN;
 
     while (query != NULL)
     {
         if (lwm2m_strncmp((char *)query->data, QUERY_NAME, QUERY_NAME_LEN) == 0)
         {
-            if (*nameP != NULL) goto error;
-            if (query->len == QUERY_NAME_LEN) goto error;
+            if (paramP->name != NULL) return -1;
+            if (query->len == QUERY_NAME_LEN) return -1;
 
-            *nameP = (char *)lwm2m_malloc(query->len - QUERY_NAME_LEN + 1);
-            if (*nameP != NULL)
-            {
-                memcpy(*nameP, query->data + QUERY_NAME_LEN, query->len - QUERY_NAME_LEN);
-                (*nameP)[query->len - QUERY_NAME_LEN] = 0;
-            }
+            paramP->name = query->data + QUERY_NAME_LEN;
+            paramP->nameLength = query->len - QUERY_NAME_LEN;
         }
         else if (lwm2m_strncmp((char *)query->data, QUERY_TYPE, QUERY_TYPE_LEN) == 0)
         {
-            if (*typeP != NULL) goto error;
-            if (query->len == QUERY_TYPE_LEN) goto error;
+            if (paramP->type != NULL) return -1;
+            if (query->len == QUERY_TYPE_LEN) return -1;
 
-            *typeP = (char *)lwm2m_malloc(query->len - QUERY_TYPE_LEN + 1);
-            if (*typeP != NULL)
-            {
-                memcpy(*typeP, query->data + QUERY_TYPE_LEN, query->len - QUERY_TYPE_LEN);
-                (*typeP)[query->len - QUERY_TYPE_LEN] = 0;
-            }
+            paramP->type = query->data + QUERY_TYPE_LEN;
+            paramP->typeLength = query->len - QUERY_TYPE_LEN;
         }
         else if (lwm2m_strncmp((char *)query->data, QUERY_SMS, QUERY_SMS_LEN) == 0)
         {
-            if (*msisdnP != NULL) goto error;
-            if (query->len == QUERY_SMS_LEN) goto error;
+            if (paramP->msisdn != NULL) return -1;
+            if (query->len == QUERY_SMS_LEN) return -1;
 
-            *msisdnP = (char *)lwm2m_malloc(query->len - QUERY_SMS_LEN + 1);
-            if (*msisdnP != NULL)
-            {
-                memcpy(*msisdnP, query->data + QUERY_SMS_LEN, query->len - QUERY_SMS_LEN);
-                (*msisdnP)[query->len - QUERY_SMS_LEN] = 0;
-            }
+            paramP->msisdn = query->data + QUERY_SMS_LEN;
+            paramP->msisdnLength = query->len - QUERY_SMS_LEN;
         }
         else if (lwm2m_strncmp((char *)query->data, QUERY_LIFETIME, QUERY_LIFETIME_LEN) == 0)
         {
             int i;
 
-            if (*lifetimeP != 0) goto error;
-            if (query->len == QUERY_LIFETIME_LEN) goto error;
+            if (paramP->lifetime != 0) return -1;
+            if (query->len == QUERY_LIFETIME_LEN) return -1;
 
             for (i = QUERY_LIFETIME_LEN ; i < query->len ; i++)
             {
-                if (query->data[i] < '0' || query->data[i] > '9') goto error;
-                *lifetimeP = (*lifetimeP * 10) + (query->data[i] - '0');
+                if (query->data[i] < '0' || query->data[i] > '9') return -1;
+                paramP->lifetime = (paramP->lifetime * 10) + (query->data[i] - '0');
             }
         }
         else if (lwm2m_strncmp((char *)query->data, QUERY_VERSION, QUERY_VERSION_LEN) == 0)
         {
-            if (*versionP != NULL) goto error;
-            if (query->len == QUERY_VERSION_LEN) goto error;
+            if (paramP->version != NULL) return -1;
+            if (query->len == QUERY_VERSION_LEN) return -1;
 
-            *versionP = (char *)lwm2m_malloc(query->len - QUERY_VERSION_LEN + 1);
-            if (*versionP != NULL)
-            {
-                memcpy(*versionP, query->data + QUERY_VERSION_LEN, query->len - QUERY_VERSION_LEN);
-                (*versionP)[query->len - QUERY_VERSION_LEN] = 0;
-            }
+            paramP->version = query->data + QUERY_VERSION_LEN;
+            paramP->versionLength = query->len - QUERY_VERSION_LEN;
         }
         else if (lwm2m_strncmp((char *)query->data, QUERY_BINDING, QUERY_BINDING_LEN) == 0)
         {
-            if (*bindingP != BINDING_UNKNOWN) goto error;
-            if (query->len == QUERY_BINDING_LEN) goto error;
+            if (paramP->binding != BINDING_UNKNOWN) return -1;
+            if (query->len == QUERY_BINDING_LEN) return -1;
 
-            *bindingP = utils_stringToBinding(query->data + QUERY_BINDING_LEN, query->len - QUERY_BINDING_LEN);
+            paramP->binding = utils_stringToBinding(query->data + QUERY_BINDING_LEN, query->len - QUERY_BINDING_LEN);
         }
         query = query->next;
     }
 
     return 0;
-
-error:
-    if (*nameP != NULL) lwm2m_free(*nameP);
-    if (*typeP != NULL) lwm2m_free(*typeP);
-    if (*msisdnP != NULL) lwm2m_free(*msisdnP);
-    if (*versionP != NULL) lwm2m_free(*versionP);
-
-    return -1;
 }
 
 static uint16_t prv_splitLinkAttribute(uint8_t * data,
@@ -754,17 +702,64 @@ static uint16_t prv_splitLinkAttribute(uint8_t * data,
     return end;
 }
 
+// Parses the content formats listed in a ct attribute, either a single value or a quoted list
+// separated by spaces. Unknown formats are ignored.
+static int prv_parseContentFormats(uint8_t * data,
+                                   uint16_t length,
+                                   bool * supportJSON,
+                                   bool * supportSenMLCBOR)
+{
+    uint16_t index;
+
+    if (length >= 2 && data[0] == '"' && data[length - 1] == '"')
+    {
+        data += 1;
+        length -= 2;
+    }
+
+    index = 0;
+    while (index < length)
+    {
+        uint16_t start;
+
+        while (index < length && data[index] == ' ') index++;
+        start = index;
+        while (index < length && data[index] != ' ')
+        {
+            if (data[index] < '0' || data[index] > '9') return 0;
+            index++;
+        }
+
+        if (index - start == REG_ATTR_CONTENT_JSON_LEN
+         && 0 == lwm2m_strncmp(REG_ATTR_CONTENT_JSON, (char*)data + start, REG_ATTR_CONTENT_JSON_LEN))
+        {
+            *supportJSON = true;
+        }
+        else if (index - start == REG_ATTR_CONTENT_SENML_CBOR_LEN
+              && 0 == lwm2m_strncmp(REG_ATTR_CONTENT_SENML_CBOR, (char*)data + start, REG_ATTR_CONTENT_SENML_CBOR_LEN))
+        {
+            *supportSenMLCBOR = true;
+        }
+    }
+
+    return 1;
+}
+
 static int prv_parseLinkAttributes(uint8_t * data,
                                    uint16_t length,
                                    bool * supportJSON,
-                                   char ** altPath)
+                                   bool * supportSenMLCBOR,
+                                   uint8_t ** altPathP,
+                                   size_t * altPathLengthP)
 {
     uint16_t index;
     uint16_t pathStart;
     uint16_t pathLength;
     bool isValid;
+    bool ctFound;
 
     isValid = false;
+    ctFound = false;
 
     // Expecting application/link-format (RFC6690)
     // leading space were removed before. Remove trailing spaces.
@@ -823,13 +818,9 @@ static int prv_parseLinkAttributes(uint8_t * data,
         else if (keyLength == REG_ATTR_CONTENT_KEY_LEN
               && 0 == lwm2m_strncmp(REG_ATTR_CONTENT_KEY, (char*)data + index + keyStart, keyLength))
         {
-            if (*supportJSON == true) return 0; // declared twice
-            if (valueLength == REG_ATTR_CONTENT_JSON_LEN
-             && 0 == lwm2m_strncmp(REG_ATTR_CONTENT_JSON, (char*)data + index + valueStart, valueLength))
-            {
-                *supportJSON = true;
-            }
-            else
+            if (ctFound == true) return 0; // declared twice
+            ctFound = true;
+            if (0 == prv_parseContentFormats(data + index + valueStart, valueLength, supportJSON, supportSenMLCBOR))
             {
                 return 0;
             }
@@ -843,10 +834,8 @@ static int prv_parseLinkAttributes(uint8_t * data,
 
     if (pathLength != 0)
     {
-        *altPath = (char *)lwm2m_malloc(pathLength + 1);
-        if (*altPath == NULL) return 0;
-        memcpy(*altPath, data + pathStart, pathLength);
-        (*altPath)[pathLength] = 0;
+        *altPathP = data + pathStart;
+        *altPathLengthP = pathLength;
     }
 
     return 1;
@@ -912,24 +901,56 @@ static int prv_getId(uint8_t * data,
     return 1;
 }
 
+static int prv_compareObjects(const void * first,
+                              const void * second)
+{
+    const lwm2m_client_object_t * firstP = (const lwm2m_client_object_t *)first;
+    const lwm2m_client_object_t * secondP = (const lwm2m_client_object_t *)second;
+
+    if (firstP->objectId != secondP->objectId) return (int)firstP->objectId - (int)secondP->objectId;
+    return (int)firstP->instanceId - (int)secondP->instanceId;
+}
+
+// Returns the sorted object list of the payload in a temporary array, or NULL if the payload
+// is invalid or lists no object.
 static lwm2m_client_object_t * prv_decodeRegisterPayload(uint8_t * payload,
                                                          uint16_t payloadLength,
+                                                         size_t * countP,
                                                          bool * supportJSON,
-                                                         char ** altPath)
+                                                         bool * supportSenMLCBOR,
+                                                         uint8_t ** altPathP,
+                                                         size_t * altPathLengthP)
 {
-    uint16_t index;
-    lwm2m_client_object_t * objList;
+    size_t index;       // reaches payloadLength + 1, which does not fit in 16 bits for the largest payload
+    lwm2m_client_object_t * objects;
+    size_t capacity;
+    size_t count;
+    size_t i;
     bool linkAttrFound;
+    bool sorted;
 
-    *altPath = NULL;
+    *countP = 0;
+    *altPathP = NULL;
+    *altPathLengthP = 0;
     *supportJSON = false;
-    objList = NULL;
+    *supportSenMLCBOR = false;
+
+    // there are at most as many links as delimiters plus one
+    capacity = 1;
+    for (index = 0 ; index < payloadLength ; index++)
+    {
+        if (payload[index] == REG_DELIMITER) capacity++;
+    }
+    objects = (lwm2m_client_object_t *)lwm2m_malloc(capacity * sizeof(lwm2m_client_object_t));
+    if (objects == NULL) return NULL;
+
+    count = 0;
     linkAttrFound = false;
+    sorted = true;
     index = 0;
-
     while (index <= payloadLength)
     {
-        uint16_t start;
+        size_t start;
         uint16_t length;
         int result;
         uint16_t id;
@@ -940,39 +961,19 @@ static lwm2m_client_object_t * prv_decodeRegisterPayload(uint8_t * payload,
 
         start = index;
         while (index < payloadLength && payload[index] != REG_DELIMITER) index++;
-        length = index - start;
+        length = (uint16_t)(index - start);
 
         result = prv_getId(payload + start, length, &id, &instance);
         if (result != 0)
         {
-            lwm2m_client_object_t * objectP;
-
-            objectP = (lwm2m_client_object_t *)lwm2m_list_find((lwm2m_list_t *)objList, id);
-            if (objectP == NULL)
-            {
-                objectP = (lwm2m_client_object_t *)lwm2m_malloc(sizeof(lwm2m_client_object_t));
-                memset(objectP, 0, sizeof(lwm2m_client_object_t));
-                if (objectP == NULL) goto error;
-                objectP->id = id;
-                objList = (lwm2m_client_object_t *)LWM2M_LIST_ADD(objList, objectP);
-            }
-            if (result == 2)
-            {
-                lwm2m_list_t * instanceP;
-
-                instanceP = lwm2m_list_find(objectP->instanceList, instance);
-                if (instanceP == NULL)
-                {
-                    instanceP = (lwm2m_list_t *)lwm2m_malloc(sizeof(lwm2m_list_t));
-                    memset(instanceP, 0, sizeof(lwm2m_list_t));
-                    instanceP->id = instance;
-                    objectP->instanceList = LWM2M_LIST_ADD(objectP->instanceList, instanceP);
-                }
-            }
+            objects[count].objectId = id;
+            objects[count].instanceId = (result == 2) ? instance : LWM2M_MAX_ID;
+            if (count > 0 && prv_compareObjects(objects + count - 1, objects + count) > 0) sorted = false;
+            count++;
         }
         else if (linkAttrFound == false)
         {
-            result = prv_parseLinkAttributes(payload + start, length, supportJSON, altPath);
+            result = prv_parseLinkAttributes(payload + start, length, supportJSON, supportSenMLCBOR, altPathP, altPathLengthP);
             if (result == 0) goto error;
 
             linkAttrFound = true;
@@ -982,43 +983,374 @@ static lwm2m_client_object_t * prv_decodeRegisterPayload(uint8_t * payload,
         index++;
     }
 
-    return objList;
+    // most clients send a sorted list
+    if (!sorted) qsort(objects, count, sizeof(lwm2m_client_object_t), prv_compareObjects);
 
-error:
-    if (*altPath != NULL)
+    // remove the duplicates and the objects also listed with instances, sorted after them
+    *countP = 0;
+    for (i = 0 ; i < count ; i++)
     {
-        lwm2m_free(*altPath);
-        *altPath = NULL;
+        if (*countP > 0 && objects[*countP - 1].objectId == objects[i].objectId)
+        {
+            if (objects[*countP - 1].instanceId == objects[i].instanceId) continue;
+            if (objects[i].instanceId == LWM2M_MAX_ID) continue;
+        }
+        objects[*countP] = objects[i];
+        (*countP)++;
     }
-    prv_freeClientObjectList(objList);
+    if (*countP == 0) goto error;
+
+    return objects;
+
+error:
+    *countP = 0;
+    lwm2m_free(objects);
 
     return NULL;
 }
 
-static lwm2m_client_t * prv_getClientByName(lwm2m_context_t * contextP,
-                                            char * name)
+// Position of the first entry not lower than (objectId, instanceId)
+static size_t prv_searchObject(lwm2m_client_t * clientP,
+                               uint16_t objectId,
+                               uint16_t instanceId)
+{
+    lwm2m_client_object_t target;
+    size_t low;
+    size_t high;
+
+    target.objectId = objectId;
+    target.instanceId = instanceId;
+    low = 0;
+    high = clientP->objectCount;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+
+        if (prv_compareObjects(clientP->objects + middle, &target) < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+// Returns true if the object, or the object instance, of the URI is listed by the client
+static bool prv_isListed(lwm2m_client_t * clientP,
+                         lwm2m_uri_t * uriP)
 {
-    lwm2m_client_t * targetP;
+    size_t position;
 
-    targetP = contextP->clientList;
-    while (targetP != NULL && strcmp(name, targetP->name) != 0)
+    if (LWM2M_URI_IS_SET_INSTANCE(uriP))
     {
-        targetP = targetP->next;
+        position = prv_searchObject(clientP, uriP->objectId, uriP->instanceId);
+        return position < clientP->objectCount
+            && clientP->objects[position].objectId == uriP->objectId
+            && clientP->objects[position].instanceId == uriP->instanceId;
+    }
+
+    position = prv_searchObject(clientP, uriP->objectId, 0);
+    return position < clientP->objectCount
+        && clientP->objects[position].objectId == uriP->objectId;
+}
+
+static char * prv_shareString(lwm2m_context_t * contextP,
+                              uint8_t * value,
+                              size_t length)
+{
+    _shared_string_t * stringP;
+
+    if (value == NULL) return NULL;
+
+    for (stringP = contextP->sharedStrings ; stringP != NULL ; stringP = stringP->next)
+    {
+        if (stringP->length == length && memcmp(stringP->value, value, length) == 0)
+        {
+            stringP->refCount++;
+            return stringP->value;
+        }
     }
 
-    return targetP;
+    stringP = (_shared_string_t *)lwm2m_malloc(sizeof(_shared_string_t) + length + 1);
+    if (stringP == NULL) return NULL;
+    stringP->refCount = 1;
+    stringP->length = length;
+    memcpy(stringP->value, value, length);
+    stringP->value[length] = 0;
+    stringP->next = contextP->sharedStrings;
+    contextP->sharedStrings = stringP;
+
+    return stringP->value;
+}
+
+static void prv_releaseString(lwm2m_context_t * contextP,
+                              char * value)
+{
+    _shared_string_t ** linkP;
+
+    if (value == NULL) return;
+
+    for (linkP = &contextP->sharedStrings ; *linkP != NULL ; linkP = &(*linkP)->next)
+    {
+        if ((*linkP)->value == value)
+        {
+            _shared_string_t * stringP = *linkP;
+
+            stringP->refCount--;
+            if (stringP->refCount == 0)
+            {
+                *linkP = stringP->next;
+                lwm2m_free(stringP);
+            }
+            return;
+        }
+    }
+}
+
+static size_t prv_recordSize(size_t count,
+                             size_t nameLength,
+                             uint8_t * msisdn,
+                             size_t msisdnLength)
+{
+    return count * sizeof(lwm2m_client_object_t) + nameLength + 1 + (msisdn != NULL ? msisdnLength + 1 : 0);
+}
+
+// Stores the object list, then the name and the MSISDN of the client. The storage following the
+// lwm2m_client_t is used when large enough, otherwise a separate one is allocated.
+static bool prv_setRecord(lwm2m_client_t * clientP,
+                          lwm2m_client_object_t * objects,
+                          size_t count,
+                          uint8_t * name,
+                          size_t nameLength,
+                          uint8_t * msisdn,
+                          size_t msisdnLength)
+{
+    uint8_t * inlineStorage;
+    uint8_t * storage;
+    size_t size;
+
+    inlineStorage = (uint8_t *)(clientP + 1);
+    size = prv_recordSize(count, nameLength, msisdn, msisdnLength);
+
+    // the current record may hold the name, the MSISDN or the objects: it is replaced at once
+    if (clientP->objects == NULL && size <= clientP->capacity)
+    {
+        storage = inlineStorage;
+    }
+    else
+    {
+        storage = (uint8_t *)lwm2m_malloc(size);
+        if (storage == NULL) return false;
+    }
+
+    memcpy(storage, objects, count * sizeof(lwm2m_client_object_t));
+    memcpy(storage + count * sizeof(lwm2m_client_object_t), name, nameLength);
+    storage[count * sizeof(lwm2m_client_object_t) + nameLength] = 0;
+    if (msisdn != NULL)
+    {
+        memcpy(storage + count * sizeof(lwm2m_client_object_t) + nameLength + 1, msisdn, msisdnLength);
+        storage[size - 1] = 0;
+    }
+
+    if (storage != inlineStorage)
+    {
+        if (size <= clientP->capacity)
+        {
+            memcpy(inlineStorage, storage, size);
+            lwm2m_free(storage);
+            storage = inlineStorage;
+        }
+        if (clientP->objects != NULL && (uint8_t *)clientP->objects != inlineStorage)
+        {
+            lwm2m_free(clientP->objects);
+        }
+    }
+
+    clientP->objects = (lwm2m_client_object_t *)storage;
+    clientP->objectCount = count;
+    clientP->name = (char *)storage + count * sizeof(lwm2m_client_object_t);
+    clientP->msisdn = (msisdn != NULL) ? clientP->name + nameLength + 1 : NULL;
+
+    return true;
+}
+
+// Reads the object link found at *indexP in the sorted object list of a registration update, moving
+// *indexP to the next link. Returns 1 for an object link, 2 for a link to skip, 0 at the end of the
+// payload and -1 if the list must be decoded instead: it is not sorted, or has invalid links.
+static int prv_nextObjectLink(uint8_t * payload,
+                              uint16_t payloadLength,
+                              size_t * indexP,
+                              bool * linkAttrFoundP,
+                              lwm2m_client_object_t * previousP,
+                              lwm2m_client_object_t * objectP)
+{
+    while (*indexP <= payloadLength)
+    {
+        size_t start;
+        uint16_t length;
+        int result;
+        uint16_t id;
+        uint16_t instance;
+
+        while (*indexP < payloadLength && payload[*indexP] == ' ') (*indexP)++;
+        if (*indexP == payloadLength) return 0;
+
+        start = *indexP;
+        while (*indexP < payloadLength && payload[*indexP] != REG_DELIMITER) (*indexP)++;
+        length = (uint16_t)(*indexP - start);
+        (*indexP)++;
+
+        result = prv_getId(payload + start, length, &id, &instance);
+        if (result == 0)
+        {
+            bool supportJSON;
+            bool supportSenMLCBOR;
+            uint8_t * altPath;
+            size_t altPathLength;
+
+            // the link attributes are only used by the registration
+            if (*linkAttrFoundP
+             || 0 == prv_parseLinkAttributes(payload + start, length, &supportJSON, &supportSenMLCBOR, &altPath, &altPathLength))
+            {
+                return -1;
+            }
+            *linkAttrFoundP = true;
+            continue;
+        }
+
+        objectP->objectId = id;
+        objectP->instanceId = (result == 2) ? instance : LWM2M_MAX_ID;
+        if (previousP != NULL)
+        {
+            // an object also listed with instances is dropped as by prv_decodeRegisterPayload()
+            if (previousP->objectId == id && objectP->instanceId == LWM2M_MAX_ID) return 2;
+            if (prv_compareObjects(previousP, objectP) >= 0) return -1;
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+// Applies the object list of a registration update to the record of the client. A first pass
+// compares the list with the current one, which is only rewritten if they differ, in place when
+// the record storage is large enough.
+// Returns 1 if the list was applied, 0 if it must be decoded with prv_decodeRegisterPayload()
+// and -1 on allocation failure. The record is left unchanged unless 1 is returned.
+static int prv_mergeRegisterPayload(lwm2m_client_t * clientP,
+                                    uint8_t * payload,
+                                    uint16_t payloadLength,
+                                    bool * removedP)
+{
+    lwm2m_client_object_t object;
+    lwm2m_client_object_t previous;
+    uint8_t * inlineStorage;
+    uint8_t * storage;
+    size_t tailLength;
+    size_t available;
+    size_t size;
+    size_t index;
+    size_t count;
+    size_t kept;
+    size_t position;
+    bool linkAttrFound;
+    int result;
+
+    *removedP = false;
+
+    // count the objects, and the ones already listed
+    count = 0;
+    kept = 0;
+    position = 0;
+    index = 0;
+    linkAttrFound = false;
+    while (0 != (result = prv_nextObjectLink(payload, payloadLength, &index, &linkAttrFound, count > 0 ? &previous : NULL, &object)))
+    {
+        if (result < 0) return 0;
+        if (result == 2) continue;
+
+        while (position < clientP->objectCount && prv_compareObjects(clientP->objects + position, &object) < 0) position++;
+        if (position < clientP->objectCount && prv_compareObjects(clientP->objects + position, &object) == 0)
+        {
+            kept++;
+            position++;
+        }
+        previous = object;
+        count++;
+    }
+    if (count == 0) return 0;
+    if (kept == count && kept == clientP->objectCount) return 1;
+    *removedP = kept < clientP->objectCount;
+
+    // the name and the MSISDN follow the objects
+    tailLength = strlen(clientP->name) + 1;
+    if (clientP->msisdn != NULL) tailLength += strlen(clientP->msisdn) + 1;
+
+    inlineStorage = (uint8_t *)(clientP + 1);
+    if ((uint8_t *)clientP->objects == inlineStorage)
+    {
+        available = clientP->capacity;
+    }
+    else
+    {
+        available = clientP->objectCount * sizeof(lwm2m_client_object_t) + tailLength;
+    }
+
+    size = count * sizeof(lwm2m_client_object_t) + tailLength;
+    if (size <= available)
+    {
+        // the objects are written over the current ones, once the name and the MSISDN moved
+        storage = (uint8_t *)clientP->objects;
+        memmove(storage + count * sizeof(lwm2m_client_object_t), clientP->name, tailLength);
+    }
+    else
+    {
+        if ((uint8_t *)clientP->objects != inlineStorage && size <= clientP->capacity)
+        {
+            storage = inlineStorage;
+        }
+        else
+        {
+            storage = (uint8_t *)lwm2m_malloc(size);
+            if (storage == NULL) return -1;
+        }
+        memcpy(storage + count * sizeof(lwm2m_client_object_t), clientP->name, tailLength);
+        if ((uint8_t *)clientP->objects != inlineStorage) lwm2m_free(clientP->objects);
+    }
+    clientP->name = (char *)storage + count * sizeof(lwm2m_client_object_t);
+    if (clientP->msisdn != NULL) clientP->msisdn = clientP->name + strlen(clientP->name) + 1;
+    clientP->objects = (lwm2m_client_object_t *)storage;
+    clientP->objectCount = count;
+
+    count = 0;
+    index = 0;
+    linkAttrFound = false;
+    while (0 != (result = prv_nextObjectLink(payload, payloadLength, &index, &linkAttrFound, count > 0 ? clientP->objects + count - 1 : NULL, &object)))
+    {
+        if (result == 2) continue;
+        clientP->objects[count] = object;
+        count++;
+    }
+
+    return 1;
 }
 
 void registration_freeClient(lwm2m_context_t * contextP,
                              lwm2m_client_t * clientP)
 {
     LOG("Entering");
-    if (clientP->name != NULL) lwm2m_free(clientP->name);
-    if (clientP->type != NULL) lwm2m_free(clientP->type);
-    if (clientP->msisdn != NULL) lwm2m_free(clientP->msisdn);
-    if (clientP->altPath != NULL) lwm2m_free(clientP->altPath);
-    prv_freeClientObjectList(clientP->objectList);
+    prv_releaseString(contextP, clientP->type);
+    prv_releaseString(contextP, clientP->altPath);
+    if (clientP->objects != NULL && clientP->objects != (lwm2m_client_object_t *)(clientP + 1))
+    {
+        lwm2m_free(clientP->objects);
+    }
     transaction_remove_all(contextP, clientP->sessionH);
+    queue_free(clientP);
     while(clientP->observationList != NULL)
     {
         observe_remove(clientP->observationList);
@@ -1026,6 +1358,65 @@ void registration_freeClient(lwm2m_context_t * contextP,
     lwm2m_free(clientP);
 }
 
+// Creates the client with the internal ID, or updates the one already using it. The other fields of
+// the returned client are left to the caller.
+lwm2m_client_t * registration_restoreClient(lwm2m_context_t * contextP,
+                                            uint16_t internalID,
+                                            lwm2m_client_object_t * objects,
+                                            size_t objectCount,
+                                            uint8_t * name,
+                                            size_t nameLength,
+                                            uint8_t * msisdn,
+                                            size_t msisdnLength,
+                                            uint8_t * type,
+                                            size_t typeLength,
+                                            uint8_t * altPath,
+                                            size_t altPathLength)
+{
+    lwm2m_client_t * clientP;
+    bool isNew;
+    size_t capacity;
+    char * typeP;
+    char * altPathP;
+
+    clientP = contextP->clientStore->findClientFunc(internalID, contextP->clientStore);
+    isNew = clientP == NULL;
+    if (isNew)
+    {
+        capacity = prv_recordSize(objectCount, nameLength, msisdn, msisdnLength);
+        clientP = (lwm2m_client_t *)lwm2m_malloc(sizeof(lwm2m_client_t) + capacity);
+        if (clientP == NULL) return NULL;
+        memset(clientP, 0, sizeof(lwm2m_client_t));
+        clientP->capacity = capacity;
+        clientP->internalID = internalID;
+    }
+
+    // an existing client keeps its record until the new one is built
+    typeP = prv_shareString(contextP, type, typeLength);
+    altPathP = prv_shareString(contextP, altPath, altPathLength);
+    if ((type != NULL && typeP == NULL)
+     || (altPath != NULL && altPathP == NULL)
+     || !prv_setRecord(clientP, objects, objectCount, name, nameLength, msisdn, msisdnLength))
+    {
+        prv_releaseString(contextP, typeP);
+        prv_releaseString(contextP, altPathP);
+        if (isNew) registration_freeClient(contextP, clientP);
+        return NULL;
+    }
+    prv_releaseString(contextP, clientP->type);
+    clientP->type = typeP;
+    prv_releaseString(contextP, clientP->altPath);
+    clientP->altPath = altPathP;
+
+    if (isNew && 0 != contextP->clientStore->addClientFunc(clientP, contextP->clientStore))
+    {
+        registration_freeClient(contextP, clientP);
+        return NULL;
+    }
+
+    return clientP;
+}
+
 static int prv_getLocationString(uint16_t id,
                                  char location[MAX_LOCATION_LENGTH])
 {
@@ -1065,20 +1456,24 @@ uint8_t registration_handleRequest(lwm2m_context_t * contextP,
     {
     case COAP_POST:
     {
-        char * name = NULL;
-        char * type = NULL;
-        uint32_t lifetime;
-        char * msisdn;
-        char * altPath;
-        char * version;
-        lwm2m_binding_t binding;
+        _parameters_t params;
         lwm2m_client_object_t * objects;
+        size_t objectCount;
+        uint8_t * altPath;
+        size_t altPathLength;
+        char * typeP;
+        char * altPathP;
         bool supportJSON;
+        bool supportSenMLCBOR;
         lwm2m_client_t * clientP;
         char location[MAX_LOCATION_LENGTH];
-        lwm2m_transaction_t *transaction;
+        uint32_t objectListHash;
+        bool objectsChanged;
+        bool objectsRemoved;
+        bool stateChanged;
+        bool inStore;
 
-        if (0 != prv_getParameters(message->uri_query, &name, &type, &lifetime, &msisdn, &binding, &version))
+        if (0 != prv_getParameters(message->uri_query, &params))
         {
             return COAP_400_BAD_REQUEST;
         }
@@ -1088,110 +1483,102 @@ uint8_t registration_handleRequest(lwm2m_context_t * contextP,
             return COAP_400_BAD_REQUEST;
         }
 
-        objects = prv_decodeRegisterPayload(message->payload, message->payload_len, &supportJSON, &altPath);
-
         switch (uriP->flag & LWM2M_URI_MASK_ID)
         {
         case 0:
             // Register operation
             // Version is mandatory
-            if (version == NULL)
-            {
-                if (name != NULL) lwm2m_free(name);
-                if (msisdn != NULL) lwm2m_free(msisdn);
-                return COAP_400_BAD_REQUEST;
-            }
+            if (params.version == NULL) return COAP_400_BAD_REQUEST;
             // Endpoint client name is mandatory
-            if (name == NULL)
-            {
-                lwm2m_free(version);
-                if (msisdn != NULL) lwm2m_free(msisdn);
-                return COAP_400_BAD_REQUEST;
-            }
+            if (params.name == NULL) return COAP_400_BAD_REQUEST;
             // Object list is mandatory
-            if (objects == NULL)
-            {
-                lwm2m_free(version);
-                lwm2m_free(name);
-                if (msisdn != NULL) lwm2m_free(msisdn);
-                return COAP_400_BAD_REQUEST;
-            }
+            objects = prv_decodeRegisterPayload(message->payload, message->payload_len, &objectCount, &supportJSON, &supportSenMLCBOR, &altPath, &altPathLength);
+            if (objects == NULL) return COAP_400_BAD_REQUEST;
             // version must be 1.0
-            if (strlen(version) != LWM2M_VERSION_LEN
-                || lwm2m_strncmp(version, LWM2M_VERSION, LWM2M_VERSION_LEN))
+            if (params.versionLength != LWM2M_VERSION_LEN
+                || lwm2m_strncmp((char *)params.version, LWM2M_VERSION, LWM2M_VERSION_LEN))
             {
-                lwm2m_free(version);
-                lwm2m_free(name);
-                if (msisdn != NULL) lwm2m_free(msisdn);
+                lwm2m_free(objects);
                 return COAP_412_PRECONDITION_FAILED;
             }
-            lwm2m_free(version);
 
-            if (lifetime == 0)
+            if (params.lifetime == 0)
             {
-                lifetime = LWM2M_DEFAULT_LIFETIME;
+                params.lifetime = LWM2M_DEFAULT_LIFETIME;
             }
 
-            clientP = prv_getClientByName(contextP, name);
-            if (clientP != NULL)
+            clientP = contextP->clientStore->findNameFunc((char *)params.name, params.nameLength, contextP->clientStore);
+            inStore = clientP != NULL;
+            if (clientP == NULL)
             {
-                // we reset this registration
-                lwm2m_free(clientP->name);
-                if (clientP->msisdn != NULL) lwm2m_free(clientP->msisdn);
-                if (clientP->altPath != NULL) lwm2m_free(clientP->altPath);
-                prv_freeClientObjectList(clientP->objectList);
-                clientP->objectList = NULL;
-
-                lwm2m_observation_t *observationP = clientP->observationList;
-                while (observationP != NULL)
-                {
-                    lwm2m_observation_t *nextP = observationP->next;
-                    lwm2m_observe(contextP,
-                                  clientP->internalID,
-                                  &observationP->uri,
-                                  observationP->callback,
-                                  observationP->userData);
+                size_t capacity;
 
-                    observationP = nextP;
-                }
-            }
-            else
-            {
-                clientP = (lwm2m_client_t *)lwm2m_malloc(sizeof(lwm2m_client_t));
+                // the object list, the name and the MSISDN are stored after the structure
+                capacity = prv_recordSize(objectCount, params.nameLength, params.msisdn, params.msisdnLength);
+                clientP = (lwm2m_client_t *)lwm2m_malloc(sizeof(lwm2m_client_t) + capacity);
                 if (clientP == NULL)
                 {
-                    lwm2m_free(name);
-                    lwm2m_free(altPath);
-                    if (msisdn != NULL) lwm2m_free(msisdn);
-                    prv_freeClientObjectList(objects);
+                    lwm2m_free(objects);
                     return COAP_500_INTERNAL_SERVER_ERROR;
                 }
                 memset(clientP, 0, sizeof(lwm2m_client_t));
-                clientP->internalID = lwm2m_list_newId((lwm2m_list_t *)contextP->clientList);
-                contextP->clientList = (lwm2m_client_t *)LWM2M_LIST_ADD(contextP->clientList, clientP);
+                clientP->capacity = capacity;
+                clientP->internalID = contextP->clientStore->newIdFunc(contextP->clientStore);
+            }
+
+            // a registered client keeps its registration until the new one is built
+            typeP = prv_shareString(contextP, params.type, params.typeLength);
+            altPathP = prv_shareString(contextP, altPath, altPathLength);
+            if ((params.type != NULL && typeP == NULL)
+             || (altPath != NULL && altPathP == NULL)
+             || prv_getLocationString(clientP->internalID, location) == 0
+             || coap_set_header_location_path(response, location) == 0
+             || !prv_setRecord(clientP, objects, objectCount, params.name, params.nameLength, params.msisdn, params.msisdnLength))
+            {
+                lwm2m_free(objects);
+                coap_free_header(response);
+                prv_releaseString(contextP, typeP);
+                prv_releaseString(contextP, altPathP);
+                if (!inStore) registration_freeClient(contextP, clientP);
+                return COAP_500_INTERNAL_SERVER_ERROR;
             }
-            clientP->name = name;
-            clientP->type = type;
-            clientP->binding = binding;
-            clientP->msisdn = msisdn;
-            clientP->altPath = altPath;
+            // we reset this registration
+            prv_releaseString(contextP, clientP->type);
+            clientP->type = typeP;
+            prv_releaseString(contextP, clientP->altPath);
+            clientP->altPath = altPathP;
+            lwm2m_free(objects);
+            clientP->binding = params.binding;
             clientP->supportJSON = supportJSON;
-            clientP->lifetime = lifetime;
-            clientP->endOfLife = tv_sec + lifetime;
-            clientP->objectList = objects;
+            clientP->supportSenMLCBOR = supportSenMLCBOR;
+            clientP->lifetime = params.lifetime;
+            clientP->endOfLife = tv_sec + params.lifetime;
+            clientP->objectListHash = utils_hash(message->payload, message->payload_len);
             clientP->sessionH = fromSessionH;
 
-            if (prv_getLocationString(clientP->internalID, location) == 0)
+            if (inStore)
             {
-                registration_freeClient(contextP, clientP);
-                return COAP_500_INTERNAL_SERVER_ERROR;
+                lwm2m_observation_t * observationP;
+
+                observationP = clientP->observationList;
+                while (observationP != NULL)
+                {
+                    lwm2m_observation_t * nextP = observationP->next;
+                    lwm2m_observe(contextP,
+                                  clientP->internalID,
+                                  &observationP->uri,
+                                  observationP->callback,
+                                  observationP->userData);
+
+                    observationP = nextP;
+                }
+                contextP->clientStore->updateClientFunc(clientP, contextP->clientStore);
             }
-            if (coap_set_header_location_path(response, location) == 0)
+            else if (0 != contextP->clientStore->addClientFunc(clientP, contextP->clientStore))
             {
                 registration_freeClient(contextP, clientP);
                 return COAP_500_INTERNAL_SERVER_ERROR;
             }
-
             if (contextP->monitorCallback != NULL)
             {
                 contextP->monitorCallback(clientP->internalID, NULL, COAP_201_CREATED, LWM2M_CONTENT_TEXT, NULL, 0, contextP->monitorUserData);
@@ -1200,34 +1587,79 @@ uint8_t registration_handleRequest(lwm2m_context_t * contextP,
             break;
 
         case LWM2M_URI_FLAG_OBJECT_ID:
-            clientP = (lwm2m_client_t *)lwm2m_list_find((lwm2m_list_t *)contextP->clientList, uriP->objectId);
+            clientP = contextP->clientStore->findClientFunc(uriP->objectId, contextP->clientStore);
             if (clientP == NULL) return COAP_404_NOT_FOUND;
 
             // Endpoint client name MUST NOT be present
-            if (name != NULL)
+            if (params.name != NULL) return COAP_400_BAD_REQUEST;
+
+            objects = NULL;
+            objectCount = 0;
+            objectsRemoved = false;
+            objectListHash = utils_hash(message->payload, message->payload_len);
+            objectsChanged = message->payload_len != 0 && clientP->objectListHash != objectListHash;
+            if (objectsChanged)
             {
-                lwm2m_free(name);
-                if (msisdn != NULL) lwm2m_free(msisdn);
-                return COAP_400_BAD_REQUEST;
+                int merged;
+
+                // a new MSISDN rebuilds the whole record anyway
+                merged = 0;
+                if (params.msisdn == NULL)
+                {
+                    merged = prv_mergeRegisterPayload(clientP, message->payload, message->payload_len, &objectsRemoved);
+                    if (merged < 0) return COAP_500_INTERNAL_SERVER_ERROR;
+                }
+                if (merged == 0)
+                {
+                    objects = prv_decodeRegisterPayload(message->payload, message->payload_len, &objectCount, &supportJSON, &supportSenMLCBOR, &altPath, &altPathLength);
+                    if (objects == NULL) return COAP_400_BAD_REQUEST;
+                    objectsRemoved = true;
+                }
             }
 
-            if (binding != BINDING_UNKNOWN)
+            // a registration update only extending the lifetime is not passed to the store
+            stateChanged = objectsChanged
+                        || params.msisdn != NULL
+                        || (params.binding != BINDING_UNKNOWN && params.binding != clientP->binding)
+                        || (params.lifetime != 0 && params.lifetime != clientP->lifetime)
+                        || clientP->sessionH != fromSessionH;
+            if (objects != NULL || params.msisdn != NULL)
             {
-                clientP->binding = binding;
+                bool stored;
+
+                if (params.msisdn == NULL && clientP->msisdn != NULL)
+                {
+                    params.msisdn = (uint8_t *)clientP->msisdn;
+                    params.msisdnLength = strlen(clientP->msisdn);
+                }
+                if (objects != NULL)
+                {
+                    stored = prv_setRecord(clientP, objects, objectCount, (uint8_t *)clientP->name, strlen(clientP->name), params.msisdn, params.msisdnLength);
+                    lwm2m_free(objects);
+                }
+                else
+                {
+                    stored = prv_setRecord(clientP, clientP->objects, clientP->objectCount, (uint8_t *)clientP->name, strlen(clientP->name), params.msisdn, params.msisdnLength);
+                }
+                if (!stored) return COAP_500_INTERNAL_SERVER_ERROR;
             }
-            if (msisdn != NULL)
+
+            if (params.binding != BINDING_UNKNOWN)
             {
-                if (clientP->msisdn != NULL) lwm2m_free(clientP->msisdn);
-                clientP->msisdn = msisdn;
+                clientP->binding = params.binding;
             }
-            if (lifetime != 0)
+            if (params.lifetime != 0)
             {
-                clientP->lifetime = lifetime;
+                clientP->lifetime = params.lifetime;
             }
             // client IP address, port or MSISDN may have changed
             clientP->sessionH = fromSessionH;
 
-            if (objects != NULL)
+            if (objectsChanged)
+            {
+                clientP->objectListHash = objectListHash;
+            }
+            if (objectsRemoved)
             {
                 lwm2m_observation_t * observationP;
 
@@ -1235,55 +1667,33 @@ uint8_t registration_handleRequest(lwm2m_context_t * contextP,
                 observationP = clientP->observationList;
                 while (observationP != NULL)
                 {
-                    lwm2m_client_object_t * objP;
                     lwm2m_observation_t * nextP;
 
                     nextP = observationP->next;
-
-                    objP = (lwm2m_client_object_t *)lwm2m_list_find((lwm2m_list_t *)objects, observationP->uri.objectId);
-                    if (objP == NULL)
+                    if (!prv_isListed(clientP, &observationP->uri))
                     {
                         observationP->callback(clientP->internalID,
                                                &observationP->uri,
                                                COAP_202_DELETED,
                                                LWM2M_CONTENT_TEXT, NULL, 0,
                                                observationP->userData);
+                        contextP->clientStore->removeObservationFunc(observationP, contextP->clientStore);
                         observe_remove(observationP);
                     }
-                    else
-                    {
-                        if ((observationP->uri.flag & LWM2M_URI_FLAG_INSTANCE_ID) != 0)
-                        {
-                            if (lwm2m_list_find((lwm2m_list_t *)objP->instanceList, observationP->uri.instanceId) == NULL)
-                            {
-                                observationP->callback(clientP->internalID,
-                                                       &observationP->uri,
-                                                       COAP_202_DELETED,
-                                                       LWM2M_CONTENT_TEXT, NULL, 0,
-                                                       observationP->userData);
-                                observe_remove(observationP);
-                            }
-                        }
-                    }
 
                     observationP = nextP;
                 }
-
-                prv_freeClientObjectList(clientP->objectList);
-                clientP->objectList = objects;
             }
 
             clientP->endOfLife = tv_sec + clientP->lifetime;
-
-            // Send queued transactions
-            while ((transaction = clientP->queuedTransactionList) != NULL)
+            if (stateChanged)
             {
-                clientP->queuedTransactionList = (lwm2m_transaction_t *)LWM2M_LIST_RM(clientP->queuedTransactionList, transaction->mID, NULL);
-                transaction->next = NULL;
-                contextP->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(contextP->transactionList, transaction);
-                transaction_send(contextP, transaction);
+                contextP->clientStore->updateClientFunc(clientP, contextP->clientStore);
             }
 
+            // Send queued transactions
+            queue_wake(contextP, clientP);
+
             if (contextP->monitorCallback != NULL)
             {
                 contextP->monitorCallback(clientP->internalID, NULL, COAP_204_CHANGED, LWM2M_CONTENT_TEXT, NULL, 0, contextP->monitorUserData);
@@ -1303,13 +1713,13 @@ uint8_t registration_handleRequest(lwm2m_context_t * contextP,
 
         if ((uriP->flag & LWM2M_URI_MASK_ID) != LWM2M_URI_FLAG_OBJECT_ID) return COAP_400_BAD_REQUEST;
 
-        clientP = (lwm2m_client_t *)LWM2M_LIST_FIND(contextP->clientList, uriP->objectId);
+        clientP = contextP->clientStore->findClientFunc(uriP->objectId, contextP->clientStore);
         if (clientP == NULL) return COAP_400_BAD_REQUEST;
         if (contextP->monitorCallback != NULL)
         {
             contextP->monitorCallback(clientP->internalID, NULL, COAP_202_DELETED, LWM2M_CONTENT_TEXT, NULL, 0, contextP->monitorUserData);
         }
-        contextP->clientList = (lwm2m_client_t *)LWM2M_LIST_RM(contextP->clientList, clientP->internalID, NULL);
+        contextP->clientStore->removeClientFunc(clientP->internalID, contextP->clientStore);
         registration_freeClient(contextP, clientP);
         result = COAP_202_DELETED;
     }
@@ -1367,7 +1777,7 @@ void registration_step(lwm2m_context_t * contextP,
             if (0 >= interval)
             {
                 LOG("Updating registration");
-                prv_updateRegistration(contextP, targetP, false);
+                prv_updateRegistration(contextP, targetP);
             }
             else if (interval < *timeoutP)
             {
@@ -1377,11 +1787,11 @@ void registration_step(lwm2m_context_t * contextP,
         break;
 
         case STATE_REG_UPDATE_NEEDED:
-            prv_updateRegistration(contextP, targetP, false);
+            prv_updateRegistration(contextP, targetP);
             break;
 
         case STATE_REG_FULL_UPDATE_NEEDED:
-            prv_updateRegistration(contextP, targetP, true);
+            prv_updateRegistration(contextP, targetP);
             break;
 
         case STATE_REG_FAILED:
@@ -1404,10 +1814,10 @@ void registration_step(lwm2m_context_t * contextP,
 
     LOG("Entering");
     // monitor clients lifetime
-    clientP = contextP->clientList;
+    clientP = contextP->clientStore->nextClientFunc(NULL, contextP->clientStore);
     while (clientP != NULL)
     {
-        lwm2m_client_t * nextP = clientP->next;
+        lwm2m_client_t * nextP = contextP->clientStore->nextClientFunc(clientP, contextP->clientStore);
 
         if (clientP->endOfLife <= currentTime)
         {
@@ -1415,7 +1825,7 @@ void registration_step(lwm2m_context_t * contextP,
             {
                 contextP->monitorCallback(clientP->internalID, NULL, COAP_202_DELETED, LWM2M_CONTENT_TEXT, NULL, 0, contextP->monitorUserData);
             }
-            contextP->clientList = (lwm2m_client_t *)LWM2M_LIST_RM(contextP->clientList, clientP->internalID, NULL);
+            contextP->clientStore->removeClientFunc(clientP->internalID, contextP->clientStore);
             registration_freeClient(contextP, clientP);
         }
         else
@@ -1428,6 +1838,8 @@ void registration_step(lwm2m_context_t * contextP,
             {
                 *timeoutP = interval;
             }
+
+            queue_step(contextP, clientP, currentTime, timeoutP);
         }
         clientP = nextP;
     }
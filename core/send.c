@@ -0,0 +1,144 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Send operation: the client pushes the values of several URIs to a server in a single
+ * SenML CBOR pack POSTed on /dp, without any observation state on either side.
+ */
+
+#include "internals.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+#if defined(LWM2M_CLIENT_MODE) && defined(LWM2M_SUPPORT_CBOR)
+
+static uint8_t prv_sendToServer(lwm2m_context_t * contextP,
+                                lwm2m_server_t * serverP,
+                                uint8_t * buffer,
+                                size_t length)
+{
+    lwm2m_transaction_t * transaction;
+
+    transaction = transaction_new(serverP->sessionH, COAP_POST, NULL, NULL, contextP->nextMID++, 4, NULL);
+    if (transaction == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+
+    coap_set_header_uri_path(transaction->message, "/"URI_SEND_SEGMENT);
+    coap_set_header_content_type(transaction->message, LWM2M_CONTENT_SENML_CBOR);
+    coap_set_payload(transaction->message, buffer, length);
+    // the payload is shared by the servers and released once all are sent
+    if (transaction_serialize(transaction) != 0)
+    {
+        transaction_free(transaction);
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    contextP->transactionList = (lwm2m_transaction_t *)LWM2M_LIST_ADD(contextP->transactionList, transaction);
+
+    return transaction_send(contextP, transaction);
+}
+
+int lwm2m_send(lwm2m_context_t * contextP,
+               uint16_t shortServerID,
+               lwm2m_uri_t * urisP,
+               int count)
+{
+    lwm2m_server_t * targetP;
+    lwm2m_media_type_t format;
+    uint8_t * buffer = NULL;
+    size_t length = 0;
+    uint8_t result;
+    bool found;
+
+    LOG_ARG("shortServerID: %d, count: %d", shortServerID, count);
+    if (urisP == NULL || count <= 0) return COAP_400_BAD_REQUEST;
+
+    found = false;
+    for (targetP = contextP->serverList ; targetP != NULL ; targetP = targetP->next)
+    {
+        if ((shortServerID == 0 || targetP->shortID == shortServerID)
+         && registration_isRegistered(targetP))
+        {
+            found = true;
+            break;
+        }
+    }
+    if (!found) return COAP_404_NOT_FOUND;
+
+    // the values are read once for all the servers
+    format = LWM2M_CONTENT_SENML_CBOR;
+    result = object_readComposite(contextP, count, urisP, &format, &buffer, &length);
+    if (result != COAP_205_CONTENT) return result;
+
+    result = COAP_NO_ERROR;
+    for ( ; targetP != NULL && result == COAP_NO_ERROR ; targetP = targetP->next)
+    {
+        if ((shortServerID == 0 || targetP->shortID == shortServerID)
+         && registration_isRegistered(targetP))
+        {
+            result = prv_sendToServer(contextP, targetP, buffer, length);
+        }
+    }
+    lwm2m_free(buffer);
+
+    return result;
+}
+
+#endif
+
+#ifdef LWM2M_SERVER_MODE
+
+uint8_t send_handleRequest(lwm2m_context_t * contextP,
+                           void * fromSessionH,
+                           coap_packet_t * message)
+{
+    lwm2m_client_t * clientP;
+    lwm2m_media_type_t format;
+
+    LOG("Entering");
+    if (message->code != COAP_POST) return COAP_405_METHOD_NOT_ALLOWED;
+
+    for (clientP = contextP->clientStore->nextClientFunc(NULL, contextP->clientStore) ; clientP != NULL ; clientP = contextP->clientStore->nextClientFunc(clientP, contextP->clientStore))
+    {
+        if (lwm2m_session_is_equal(clientP->sessionH, fromSessionH, contextP->userData)) break;
+    }
+    if (clientP == NULL) return COAP_400_BAD_REQUEST;
+
+    if (!IS_OPTION(message, COAP_OPTION_CONTENT_TYPE)) return COAP_415_UNSUPPORTED_CONTENT_FORMAT;
+    format = utils_convertMediaType(message->content_type);
+    if (format != LWM2M_CONTENT_SENML_CBOR) return COAP_415_UNSUPPORTED_CONTENT_FORMAT;
+    if (message->payload_len == 0) return COAP_400_BAD_REQUEST;
+
+    if (contextP->dataPushCallback != NULL)
+    {
+        contextP->dataPushCallback(clientP->internalID, NULL, COAP_204_CHANGED, format, message->payload, message->payload_len, contextP->dataPushUserData);
+    }
+
+    return COAP_204_CHANGED;
+}
+
+void lwm2m_set_data_push_callback(lwm2m_context_t * contextP,
+                                  lwm2m_result_callback_t callback,
+                                  void * userData)
+{
+    LOG("Entering");
+    contextP->dataPushCallback = callback;
+    contextP->dataPushUserData = userData;
+}
+
+#endif
@@ -0,0 +1,440 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Conversion between lwm2m_data_t trees and the flat lists of named records used by the JSON and
+ * SenML CBOR formats.
+ *
+ * When parsing, the records are inserted in the tree as they are read, under a root node whose
+ * children are the objects. The nodes on the path of the last inserted record are kept along with
+ * the capacity of their children arrays, so that consecutive records sharing a prefix, as
+ * serializers output them, are inserted without searching the tree.
+ */
+
+#include "internals.h"
+
+#if defined(LWM2M_SUPPORT_JSON) || defined(LWM2M_SUPPORT_CBOR)
+
+void senml_treeInit(senml_tree_t * treeP)
+{
+    memset(treeP, 0, sizeof(senml_tree_t));
+    treeP->pathP[0] = &treeP->root;
+}
+
+void senml_treeFree(senml_tree_t * treeP)
+{
+    lwm2m_data_free(treeP->root.value.asChildren.count, treeP->root.value.asChildren.array);
+    senml_treeInit(treeP);
+}
+
+int senml_uriToIds(lwm2m_uri_t * uriP,
+                   uint16_t * ids)
+{
+    int depth;
+
+    depth = 0;
+    if (uriP == NULL) return depth;
+
+    ids[depth++] = uriP->objectId;
+    if (LWM2M_URI_IS_SET_INSTANCE(uriP))
+    {
+        ids[depth++] = uriP->instanceId;
+        if (LWM2M_URI_IS_SET_RESOURCE(uriP))
+        {
+            ids[depth++] = uriP->resourceId;
+        }
+    }
+
+    return depth;
+}
+
+bool senml_parseName(const uint8_t * name,
+                     size_t length,
+                     uint16_t * ids,
+                     int * depthP)
+{
+    size_t i;
+
+    i = 0;
+    // Ignore starting /
+    if (i < length && name[i] == '/') i++;
+    while (true)
+    {
+        uint32_t readId;
+        size_t start;
+
+        readId = 0;
+        start = i;
+        while (i < length && name[i] != '/')
+        {
+            if (name[i] < '0'
+             || name[i] > '9')
+            {
+                return false;
+            }
+            readId *= 10;
+            readId += name[i] - '0';
+            if (readId >= LWM2M_MAX_ID) return false;
+            i++;
+        }
+        if (i == start || *depthP == SENML_MAX_DEPTH) return false;
+        ids[*depthP] = (uint16_t)readId;
+        *depthP += 1;
+
+        if (i == length) break;
+        // skip the /
+        i++;
+    }
+
+    return true;
+}
+
+// Searches from the end as the records of a same node usually follow each other.
+static lwm2m_data_t * prv_findDataItem(lwm2m_data_t * listP,
+                                       size_t count,
+                                       uint16_t id)
+{
+    while (count > 0)
+    {
+        count--;
+        if (listP[count].id == id) return listP + count;
+    }
+
+    return NULL;
+}
+
+// Appends a child to the node. Its children array grows geometrically.
+static lwm2m_data_t * prv_extendData(lwm2m_data_t * parentP,
+                                     size_t * capacityP)
+{
+    if (parentP->value.asChildren.count == *capacityP)
+    {
+        lwm2m_data_t * newP;
+        size_t capacity;
+
+        capacity = (*capacityP == 0) ? 1 : *capacityP * 2;
+        newP = lwm2m_data_new(capacity);
+        if (newP == NULL) return NULL;
+        if (parentP->value.asChildren.array != NULL)
+        {
+            memcpy(newP, parentP->value.asChildren.array, parentP->value.asChildren.count * sizeof(lwm2m_data_t));
+            lwm2m_free(parentP->value.asChildren.array);     // do not use lwm2m_data_free() to keep pointed values
+        }
+        parentP->value.asChildren.array = newP;
+        *capacityP = capacity;
+    }
+    parentP->value.asChildren.count += 1;
+
+    return parentP->value.asChildren.array + parentP->value.asChildren.count - 1;
+}
+
+lwm2m_data_t * senml_addRecord(senml_tree_t * treeP,
+                               uint16_t * ids,
+                               int depth)
+{
+    int level;
+
+    // values are held by resources or resource instances
+    if (depth < URI_DEPTH_RESOURCE + 1) return NULL;
+
+    for (level = 0 ; level < depth ; level++)
+    {
+        lwm2m_data_t * parentP;
+        lwm2m_data_t * childP;
+        lwm2m_data_type_t type;
+
+        if (level == depth - 1)
+        {
+            // the value sets the type
+            type = LWM2M_TYPE_UNDEFINED;
+        }
+        else if (level == URI_DEPTH_RESOURCE)
+        {
+            type = LWM2M_TYPE_MULTIPLE_RESOURCE;
+        }
+        else
+        {
+            type = utils_depthToDatatype((uri_depth_t)level);
+        }
+
+        if (level < treeP->pathDepth
+         && treeP->pathP[level + 1]->id == ids[level])
+        {
+            childP = treeP->pathP[level + 1];
+        }
+        else
+        {
+            parentP = treeP->pathP[level];
+            childP = prv_findDataItem(parentP->value.asChildren.array, parentP->value.asChildren.count, ids[level]);
+            if (childP == NULL)
+            {
+                childP = prv_extendData(parentP, treeP->capacity + level);
+                if (childP == NULL) return NULL;
+                childP->id = ids[level];
+                childP->type = type;
+            }
+            treeP->pathP[level + 1] = childP;
+            if (level + 1 < SENML_MAX_DEPTH)
+            {
+                treeP->capacity[level + 1] = childP->value.asChildren.count;
+            }
+            treeP->pathDepth = level + 1;
+        }
+
+        // a value set twice or a resource being both single and multiple
+        if (childP->type != type) return NULL;
+    }
+
+    return treeP->pathP[depth];
+}
+
+int senml_extractData(senml_tree_t * treeP,
+                      lwm2m_uri_t * uriP,
+                      lwm2m_data_t ** dataP)
+{
+    uint16_t ids[SENML_MAX_DEPTH];
+    lwm2m_data_t * parentP;
+    int depth;
+    int level;
+    int count;
+
+    depth = senml_uriToIds(uriP, ids);
+    parentP = &treeP->root;
+    for (level = 0 ; level < depth ; level++)
+    {
+        parentP = prv_findDataItem(parentP->value.asChildren.array, parentP->value.asChildren.count, ids[level]);
+        if (parentP == NULL) return -1;
+
+        if (level == URI_DEPTH_RESOURCE
+         && parentP->type != LWM2M_TYPE_MULTIPLE_RESOURCE)
+        {
+            // a single resource is returned by itself
+            *dataP = lwm2m_data_new(1);
+            if (*dataP == NULL) return -1;
+            memcpy(*dataP, parentP, sizeof(lwm2m_data_t));
+            // its value now belongs to the copy
+            parentP->type = LWM2M_TYPE_UNDEFINED;
+            return 1;
+        }
+    }
+
+    *dataP = parentP->value.asChildren.array;
+    count = (int)parentP->value.asChildren.count;
+    parentP->value.asChildren.array = NULL;
+    parentP->value.asChildren.count = 0;
+
+    return count;
+}
+
+static int prv_findAndCheckData(lwm2m_uri_t * uriP,
+                                uri_depth_t level,
+                                size_t size,
+                                lwm2m_data_t * tlvP,
+                                lwm2m_data_t ** targetP)
+{
+    size_t index;
+    int result;
+
+    if (size == 0) return 0;
+
+    if (size > 1)
+    {
+        if (tlvP[0].type == LWM2M_TYPE_OBJECT || tlvP[0].type == LWM2M_TYPE_OBJECT_INSTANCE)
+        {
+            for (index = 0; index < size; index++)
+            {
+                if (tlvP[index].type != tlvP[0].type)
+                {
+                    *targetP = NULL;
+                    return -1;
+                }
+            }
+        }
+        else
+        {
+            for (index = 0; index < size; index++)
+            {
+                if (tlvP[index].type == LWM2M_TYPE_OBJECT || tlvP[index].type == LWM2M_TYPE_OBJECT_INSTANCE)
+                {
+                    *targetP = NULL;
+                    return -1;
+                }
+            }
+        }
+    }
+
+    *targetP = NULL;
+    result = -1;
+    switch (level)
+    {
+    case URI_DEPTH_OBJECT:
+        if (tlvP[0].type == LWM2M_TYPE_OBJECT)
+        {
+            *targetP = tlvP;
+            result = (int)size;
+        }
+        break;
+
+    case URI_DEPTH_OBJECT_INSTANCE:
+        switch (tlvP[0].type)
+        {
+        case LWM2M_TYPE_OBJECT:
+            for (index = 0; index < size; index++)
+            {
+                if (tlvP[index].id == uriP->objectId)
+                {
+                    return prv_findAndCheckData(uriP, level, tlvP[index].value.asChildren.count, tlvP[index].value.asChildren.array, targetP);
+                }
+            }
+            break;
+        case LWM2M_TYPE_OBJECT_INSTANCE:
+            *targetP = tlvP;
+            result = (int)size;
+            break;
+        default:
+            break;
+        }
+        break;
+
+    case URI_DEPTH_RESOURCE:
+        switch (tlvP[0].type)
+        {
+        case LWM2M_TYPE_OBJECT:
+            for (index = 0; index < size; index++)
+            {
+                if (tlvP[index].id == uriP->objectId)
+                {
+                    return prv_findAndCheckData(uriP, level, tlvP[index].value.asChildren.count, tlvP[index].value.asChildren.array, targetP);
+                }
+            }
+            break;
+        case LWM2M_TYPE_OBJECT_INSTANCE:
+            for (index = 0; index < size; index++)
+            {
+                if (tlvP[index].id == uriP->instanceId)
+                {
+                    return prv_findAndCheckData(uriP, level, tlvP[index].value.asChildren.count, tlvP[index].value.asChildren.array, targetP);
+                }
+            }
+            break;
+        default:
+            *targetP = tlvP;
+            result = (int)size;
+            break;
+        }
+        break;
+
+    case URI_DEPTH_RESOURCE_INSTANCE:
+        switch (tlvP[0].type)
+        {
+        case LWM2M_TYPE_OBJECT:
+            for (index = 0; index < size; index++)
+            {
+                if (tlvP[index].id == uriP->objectId)
+                {
+                    return prv_findAndCheckData(uriP, level, tlvP[index].value.asChildren.count, tlvP[index].value.asChildren.array, targetP);
+                }
+            }
+            break;
+        case LWM2M_TYPE_OBJECT_INSTANCE:
+            for (index = 0; index < size; index++)
+            {
+                if (tlvP[index].id == uriP->instanceId)
+                {
+                    return prv_findAndCheckData(uriP, level, tlvP[index].value.asChildren.count, tlvP[index].value.asChildren.array, targetP);
+                }
+            }
+            break;
+        case LWM2M_TYPE_MULTIPLE_RESOURCE:
+            for (index = 0; index < size; index++)
+            {
+                if (tlvP[index].id == uriP->resourceId)
+                {
+                    return prv_findAndCheckData(uriP, level, tlvP[index].value.asChildren.count, tlvP[index].value.asChildren.array, targetP);
+                }
+            }
+            break;
+        default:
+            *targetP = tlvP;
+            result = (int)size;
+            break;
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return result;
+}
+
+int senml_findBaseName(lwm2m_uri_t * uriP,
+                       int size,
+                       lwm2m_data_t * dataP,
+                       uint8_t * baseUriStr,
+                       int * baseUriLenP,
+                       lwm2m_data_t ** targetP)
+{
+    uri_depth_t rootLevel;
+    int baseUriLen;
+    int num;
+
+    LOG_ARG("size: %d", size);
+    LOG_URI(uriP);
+    if (size != 0 && dataP == NULL) return -1;
+
+    baseUriLen = uri_toString(uriP, baseUriStr, URI_MAX_STRING_LEN, &rootLevel);
+    if (baseUriLen < 0) return -1;
+
+    num = prv_findAndCheckData(uriP, rootLevel, size, dataP, targetP);
+    if (num < 0) return -1;
+
+    if (rootLevel == URI_DEPTH_RESOURCE_INSTANCE
+     && num == 1
+     && (*targetP)->id == uriP->resourceId
+     && (*targetP)->type != LWM2M_TYPE_MULTIPLE_RESOURCE)
+    {
+        // a single resource value: the record is named after the resource
+        do
+        {
+            baseUriLen--;
+        } while (baseUriStr[baseUriLen - 1] != '/');
+    }
+
+    while (num == 1
+        && ((*targetP)->type == LWM2M_TYPE_OBJECT
+         || (*targetP)->type == LWM2M_TYPE_OBJECT_INSTANCE
+         || (*targetP)->type == LWM2M_TYPE_MULTIPLE_RESOURCE))
+    {
+        int res;
+
+        res = utils_intToText((*targetP)->id, baseUriStr + baseUriLen, URI_MAX_STRING_LEN - baseUriLen);
+        if (res <= 0) return -1;
+        baseUriLen += res;
+        if (baseUriLen >= URI_MAX_STRING_LEN -1) return -1;
+        num = (*targetP)->value.asChildren.count;
+        *targetP = (*targetP)->value.asChildren.array;
+        baseUriStr[baseUriLen] = '/';
+        baseUriLen++;
+    }
+
+    *baseUriLenP = baseUriLen;
+
+    return num;
+}
+
+#endif
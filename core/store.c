@@ -0,0 +1,820 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Persistent registration store of the server, the default client store with LWM2M_REGISTRATION_STORE.
+ * It keeps the clients in the in-memory store and writes the registrations to an append-only log
+ * provided by the platform: a record with the
+ * whole state of a client when it registers or when a registration update changes it, and a record
+ * with its internal ID when it deregisters or expires. The observations confirmed by the clients are
+ * written the same way, along with an identity of their subscriber given by the platform. As the
+ * internal IDs of the clients and of the observations are kept, the tokens of the notifications sent
+ * by the clients still match once restored.
+ * The log is replayed by lwm2m_init() and rewritten with only the current records once it grew to
+ * twice the size of the last rewrite.
+ *
+ * Record:
+ *   type (1 byte) | payload length (4 bytes) | payload | hash of the preceding bytes (4 bytes)
+ * Client record payload:
+ *   internal ID (2) | lifetime (4) | object list hash (4) | binding (1) | flags (1) |
+ *   object count (4) | object ID (2), instance ID (2) for each object |
+ *   name, MSISDN, type and alternate path, each as length (2) and bytes, present according to the flags |
+ *   session address as length (2) and bytes
+ * Delete record payload:
+ *   internal ID (2)
+ * Observation record payload:
+ *   client internal ID (2) | observation ID (2) | URI flag (1) | object ID (2) | instance ID (2) |
+ *   resource ID (2) | subscriber identity as length (2) and bytes
+ * Observation delete record payload:
+ *   client internal ID (2) | observation ID (2)
+ * Integers are big-endian. A truncated or corrupted record ends the replay and is cut from the log
+ * with what follows it. A record which cannot be restored, like on a memory allocation failure, is
+ * skipped: the log is then only rewritten after a failed write, so that the next start restores it.
+ */
+
+#include "internals.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+
+#if defined(LWM2M_SERVER_MODE) && defined(LWM2M_REGISTRATION_STORE)
+
+#define PRV_RECORD_CLIENT   1
+#define PRV_RECORD_DELETE   2
+#define PRV_RECORD_OBSERVATION          3
+#define PRV_RECORD_OBSERVATION_DELETE   4
+
+#define PRV_HEADER_SIZE     5
+#define PRV_HASH_SIZE       4
+
+#define PRV_FLAG_JSON           0x01
+#define PRV_FLAG_SENML_CBOR     0x02
+#define PRV_FLAG_MSISDN         0x04
+#define PRV_FLAG_TYPE           0x08
+#define PRV_FLAG_ALT_PATH       0x10
+
+#define PRV_MAX_SESSION_SIZE    128
+#define PRV_MAX_IDENTITY_SIZE   64
+
+typedef struct
+{
+    lwm2m_client_store_t   store;
+    lwm2m_client_store_t * innerP;      // store holding the clients
+    lwm2m_context_t *      contextP;
+    size_t                 recordCount; // number of records in the log
+    size_t                 liveCount;   // number of current records at the last rewrite
+    bool                   outdated;    // a write failed, the log must be rewritten
+    bool                   incomplete;  // a record could not be restored, the log is kept as it is
+} _file_store_t;
+
+// Position in a record payload being decoded
+typedef struct
+{
+    uint8_t * data;
+    size_t    length;
+    size_t    offset;
+} _reader_t;
+
+static void prv_setU16(uint8_t * buffer,
+                       uint16_t value)
+{
+    buffer[0] = (uint8_t)(value >> 8);
+    buffer[1] = (uint8_t)value;
+}
+
+static void prv_setU32(uint8_t * buffer,
+                       uint32_t value)
+{
+    buffer[0] = (uint8_t)(value >> 24);
+    buffer[1] = (uint8_t)(value >> 16);
+    buffer[2] = (uint8_t)(value >> 8);
+    buffer[3] = (uint8_t)value;
+}
+
+static uint32_t prv_getU32(uint8_t * buffer)
+{
+    return ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) | ((uint32_t)buffer[2] << 8) | buffer[3];
+}
+
+static int prv_appendU16(utils_buffer_t * bufferP,
+                         uint16_t value)
+{
+    uint8_t data[2];
+
+    prv_setU16(data, value);
+    return utils_bufferAppend(bufferP, data, 2);
+}
+
+static int prv_appendU32(utils_buffer_t * bufferP,
+                         uint32_t value)
+{
+    uint8_t data[4];
+
+    prv_setU32(data, value);
+    return utils_bufferAppend(bufferP, data, 4);
+}
+
+static int prv_appendString(utils_buffer_t * bufferP,
+                            const uint8_t * value,
+                            size_t length)
+{
+    if (length > 0xFFFF) return -1;
+    if (prv_appendU16(bufferP, (uint16_t)length) != 0) return -1;
+    return utils_bufferAppend(bufferP, value, length);
+}
+
+static bool prv_readU8(_reader_t * readerP,
+                       uint8_t * valueP)
+{
+    if (readerP->length - readerP->offset < 1) return false;
+    *valueP = readerP->data[readerP->offset];
+    readerP->offset += 1;
+    return true;
+}
+
+static bool prv_readU16(_reader_t * readerP,
+                        uint16_t * valueP)
+{
+    if (readerP->length - readerP->offset < 2) return false;
+    *valueP = (uint16_t)((readerP->data[readerP->offset] << 8) | readerP->data[readerP->offset + 1]);
+    readerP->offset += 2;
+    return true;
+}
+
+static bool prv_readU32(_reader_t * readerP,
+                        uint32_t * valueP)
+{
+    if (readerP->length - readerP->offset < 4) return false;
+    *valueP = prv_getU32(readerP->data + readerP->offset);
+    readerP->offset += 4;
+    return true;
+}
+
+// The string is not copied: *valueP points into the record
+static bool prv_readString(_reader_t * readerP,
+                           uint8_t ** valueP,
+                           size_t * lengthP)
+{
+    uint16_t length;
+
+    if (!prv_readU16(readerP, &length)) return false;
+    if (readerP->length - readerP->offset < length) return false;
+    *valueP = readerP->data + readerP->offset;
+    *lengthP = length;
+    readerP->offset += length;
+    return true;
+}
+
+// Reserves the header of a record, to be completed by prv_endRecord()
+static int prv_startRecord(utils_buffer_t * bufferP,
+                           uint8_t type)
+{
+    uint8_t header[PRV_HEADER_SIZE];
+
+    memset(header, 0, PRV_HEADER_SIZE);
+    header[0] = type;
+    return utils_bufferAppend(bufferP, header, PRV_HEADER_SIZE);
+}
+
+static int prv_endRecord(utils_buffer_t * bufferP,
+                         size_t start)
+{
+    size_t length;
+
+    length = bufferP->length - start - PRV_HEADER_SIZE;
+    prv_setU32(bufferP->data + start + 1, (uint32_t)length);
+
+    return prv_appendU32(bufferP, utils_hash(bufferP->data + start, PRV_HEADER_SIZE + length));
+}
+
+static int prv_writeClient(lwm2m_context_t * contextP,
+                           lwm2m_client_t * clientP,
+                           utils_buffer_t * bufferP)
+{
+    uint8_t session[PRV_MAX_SESSION_SIZE];
+    size_t sessionLength;
+    size_t start;
+    uint8_t header[12];
+    uint8_t flags;
+    size_t i;
+
+    start = bufferP->length;
+    if (prv_startRecord(bufferP, PRV_RECORD_CLIENT) != 0) return -1;
+
+    flags = 0;
+    if (clientP->supportJSON) flags |= PRV_FLAG_JSON;
+    if (clientP->supportSenMLCBOR) flags |= PRV_FLAG_SENML_CBOR;
+    if (clientP->msisdn != NULL) flags |= PRV_FLAG_MSISDN;
+    if (clientP->type != NULL) flags |= PRV_FLAG_TYPE;
+    if (clientP->altPath != NULL) flags |= PRV_FLAG_ALT_PATH;
+
+    prv_setU16(header, clientP->internalID);
+    prv_setU32(header + 2, clientP->lifetime);
+    prv_setU32(header + 6, clientP->objectListHash);
+    header[10] = (uint8_t)clientP->binding;
+    header[11] = flags;
+    if (utils_bufferAppend(bufferP, header, sizeof(header)) != 0) return -1;
+
+    if (prv_appendU32(bufferP, (uint32_t)clientP->objectCount) != 0) return -1;
+    if (utils_bufferReserve(bufferP, clientP->objectCount * 4) != 0) return -1;
+    for (i = 0 ; i < clientP->objectCount ; i++)
+    {
+        prv_setU16(bufferP->data + bufferP->length, clientP->objects[i].objectId);
+        prv_setU16(bufferP->data + bufferP->length + 2, clientP->objects[i].instanceId);
+        bufferP->length += 4;
+    }
+
+    if (prv_appendString(bufferP, (uint8_t *)clientP->name, strlen(clientP->name)) != 0) return -1;
+    if (clientP->msisdn != NULL
+     && prv_appendString(bufferP, (uint8_t *)clientP->msisdn, strlen(clientP->msisdn)) != 0) return -1;
+    if (clientP->type != NULL
+     && prv_appendString(bufferP, (uint8_t *)clientP->type, strlen(clientP->type)) != 0) return -1;
+    if (clientP->altPath != NULL
+     && prv_appendString(bufferP, (uint8_t *)clientP->altPath, strlen(clientP->altPath)) != 0) return -1;
+
+    // a client without saved address is restored, waiting for its next registration update
+    sessionLength = 0;
+    if (clientP->sessionH != NULL)
+    {
+        sessionLength = lwm2m_session_save(clientP->sessionH, session, PRV_MAX_SESSION_SIZE, contextP->userData);
+    }
+    if (prv_appendString(bufferP, session, sessionLength) != 0) return -1;
+
+    return prv_endRecord(bufferP, start);
+}
+
+static int prv_writeDelete(uint16_t internalID,
+                           utils_buffer_t * bufferP)
+{
+    size_t start;
+
+    start = bufferP->length;
+    if (prv_startRecord(bufferP, PRV_RECORD_DELETE) != 0) return -1;
+    if (prv_appendU16(bufferP, internalID) != 0) return -1;
+
+    return prv_endRecord(bufferP, start);
+}
+
+// Returns 1 when the platform does not keep the observation
+static int prv_writeObservation(lwm2m_context_t * contextP,
+                                lwm2m_observation_t * observationP,
+                                utils_buffer_t * bufferP)
+{
+    uint8_t identity[PRV_MAX_IDENTITY_SIZE];
+    int identityLength;
+    uint8_t header[11];
+    size_t start;
+
+    identityLength = lwm2m_observation_save(observationP->callback, observationP->userData, identity, PRV_MAX_IDENTITY_SIZE, contextP->userData);
+    if (identityLength < 0) return 1;
+
+    start = bufferP->length;
+    if (prv_startRecord(bufferP, PRV_RECORD_OBSERVATION) != 0) return -1;
+
+    prv_setU16(header, observationP->clientP->internalID);
+    prv_setU16(header + 2, observationP->id);
+    header[4] = observationP->uri.flag;
+    prv_setU16(header + 5, observationP->uri.objectId);
+    prv_setU16(header + 7, observationP->uri.instanceId);
+    prv_setU16(header + 9, observationP->uri.resourceId);
+    if (utils_bufferAppend(bufferP, header, sizeof(header)) != 0) return -1;
+    if (prv_appendString(bufferP, identity, (size_t)identityLength) != 0) return -1;
+
+    return prv_endRecord(bufferP, start);
+}
+
+static int prv_writeObservationDelete(lwm2m_observation_t * observationP,
+                                      utils_buffer_t * bufferP)
+{
+    size_t start;
+
+    start = bufferP->length;
+    if (prv_startRecord(bufferP, PRV_RECORD_OBSERVATION_DELETE) != 0) return -1;
+    if (prv_appendU16(bufferP, observationP->clientP->internalID) != 0) return -1;
+    if (prv_appendU16(bufferP, observationP->id) != 0) return -1;
+
+    return prv_endRecord(bufferP, start);
+}
+
+// objectsP is a scratch array reused from one record to the next
+static int prv_readClient(lwm2m_context_t * contextP,
+                          _reader_t * readerP,
+                          time_t currentTime,
+                          lwm2m_client_object_t ** objectsP,
+                          size_t * capacityP)
+{
+    lwm2m_client_t * clientP;
+    uint16_t internalID;
+    uint32_t lifetime;
+    uint32_t objectListHash;
+    uint8_t binding;
+    uint8_t flags;
+    uint32_t count;
+    uint8_t * name;
+    size_t nameLength;
+    uint8_t * msisdn = NULL;
+    size_t msisdnLength = 0;
+    uint8_t * type = NULL;
+    size_t typeLength = 0;
+    uint8_t * altPath = NULL;
+    size_t altPathLength = 0;
+    uint8_t * session;
+    size_t sessionLength;
+    uint32_t i;
+
+    if (!prv_readU16(readerP, &internalID)
+     || !prv_readU32(readerP, &lifetime)
+     || !prv_readU32(readerP, &objectListHash)
+     || !prv_readU8(readerP, &binding)
+     || !prv_readU8(readerP, &flags)
+     || !prv_readU32(readerP, &count)
+     || count == 0
+     || (readerP->length - readerP->offset) / 4 < count)
+    {
+        return -1;
+    }
+
+    if (*capacityP < count)
+    {
+        lwm2m_free(*objectsP);
+        *objectsP = (lwm2m_client_object_t *)lwm2m_malloc(count * sizeof(lwm2m_client_object_t));
+        if (*objectsP == NULL)
+        {
+            *capacityP = 0;
+            return -1;
+        }
+        *capacityP = count;
+    }
+    for (i = 0 ; i < count ; i++)
+    {
+        prv_readU16(readerP, &(*objectsP)[i].objectId);
+        prv_readU16(readerP, &(*objectsP)[i].instanceId);
+    }
+
+    if (!prv_readString(readerP, &name, &nameLength)
+     || ((flags & PRV_FLAG_MSISDN) != 0 && !prv_readString(readerP, &msisdn, &msisdnLength))
+     || ((flags & PRV_FLAG_TYPE) != 0 && !prv_readString(readerP, &type, &typeLength))
+     || ((flags & PRV_FLAG_ALT_PATH) != 0 && !prv_readString(readerP, &altPath, &altPathLength))
+     || !prv_readString(readerP, &session, &sessionLength))
+    {
+        return -1;
+    }
+
+    clientP = registration_restoreClient(contextP, internalID, *objectsP, count, name, nameLength, msisdn, msisdnLength, type, typeLength, altPath, altPathLength);
+    if (clientP == NULL) return -1;
+
+    clientP->binding = (lwm2m_binding_t)binding;
+    clientP->supportJSON = (flags & PRV_FLAG_JSON) != 0;
+    clientP->supportSenMLCBOR = (flags & PRV_FLAG_SENML_CBOR) != 0;
+    clientP->lifetime = lifetime;
+    clientP->objectListHash = objectListHash;
+    // the downtime is unknown: the client gets a whole lifetime to send its next update
+    clientP->endOfLife = currentTime + lifetime;
+    if (sessionLength != 0)
+    {
+        clientP->sessionH = lwm2m_session_restore(session, sessionLength, contextP->userData);
+    }
+
+    return 0;
+}
+
+static int prv_readObservation(lwm2m_context_t * contextP,
+                               _reader_t * readerP)
+{
+    lwm2m_client_t * clientP;
+    lwm2m_result_callback_t callback;
+    void * callbackData;
+    uint16_t clientID;
+    uint16_t id;
+    lwm2m_uri_t uri;
+    uint8_t * identity;
+    size_t identityLength;
+
+    memset(&uri, 0, sizeof(lwm2m_uri_t));
+    if (!prv_readU16(readerP, &clientID)
+     || !prv_readU16(readerP, &id)
+     || !prv_readU8(readerP, &uri.flag)
+     || !prv_readU16(readerP, &uri.objectId)
+     || !prv_readU16(readerP, &uri.instanceId)
+     || !prv_readU16(readerP, &uri.resourceId)
+     || !prv_readString(readerP, &identity, &identityLength))
+    {
+        return -1;
+    }
+
+    clientP = contextP->clientStore->findClientFunc(clientID, contextP->clientStore);
+    if (clientP == NULL) return 0;
+
+    if (!lwm2m_observation_restore(clientID, &uri, identity, identityLength, &callback, &callbackData, contextP->userData))
+    {
+        lwm2m_observation_t * observationP;
+
+        // an earlier record may have restored it
+        observationP = (lwm2m_observation_t *)lwm2m_list_find((lwm2m_list_t *)clientP->observationList, id);
+        if (observationP != NULL)
+        {
+            observe_remove(observationP);
+        }
+        return 0;
+    }
+
+    return observe_restore(contextP, clientP, id, &uri, callback, callbackData);
+}
+
+// Writes the current registrations in place of the log
+static void prv_compact(_file_store_t * fileP)
+{
+    utils_buffer_t buffer;
+    lwm2m_client_t * clientP;
+    size_t count;
+
+    LOG_ARG("%d records, %d at the last rewrite", (int)fileP->recordCount, (int)fileP->liveCount);
+    utils_bufferInit(&buffer, NULL, 0);
+    count = 0;
+    for (clientP = fileP->innerP->nextClientFunc(NULL, fileP->innerP) ; clientP != NULL ; clientP = fileP->innerP->nextClientFunc(clientP, fileP->innerP))
+    {
+        lwm2m_observation_t * observationP;
+        int result;
+
+        result = prv_writeClient(fileP->contextP, clientP, &buffer);
+        count++;
+        for (observationP = clientP->observationList ; observationP != NULL && result == 0 ; observationP = observationP->next)
+        {
+            // the pending observations were confirmed before: they are being observed again
+            if (observationP->status == STATE_DEREG_PENDING) continue;
+            result = prv_writeObservation(fileP->contextP, observationP, &buffer);
+            if (result == 0) count++;
+            if (result == 1) result = 0;
+        }
+        if (result != 0)
+        {
+            utils_bufferFree(&buffer);
+            fileP->outdated = true;
+            return;
+        }
+    }
+
+    if (lwm2m_store_replace(buffer.data, buffer.length, fileP->contextP->userData) == 0)
+    {
+        fileP->recordCount = count;
+        fileP->liveCount = count;
+        fileP->outdated = false;
+    }
+    else
+    {
+        fileP->outdated = true;
+    }
+    utils_bufferFree(&buffer);
+}
+
+static void prv_append(_file_store_t * fileP,
+                       utils_buffer_t * bufferP,
+                       int result)
+{
+    // after a failed write, the log misses a change: it is rewritten as a whole
+    if (result != 0
+     || fileP->outdated
+     || lwm2m_store_append(bufferP->data, bufferP->length, fileP->contextP->userData) != 0)
+    {
+        fileP->outdated = true;
+    }
+    else
+    {
+        fileP->recordCount++;
+        fileP->outdated = false;
+    }
+
+    if (fileP->outdated
+     || (!fileP->incomplete && fileP->recordCount > 2 * fileP->liveCount + LWM2M_STORE_COMPACTION_MIN))
+    {
+        prv_compact(fileP);
+    }
+}
+
+static void prv_saveClient(_file_store_t * fileP,
+                           lwm2m_client_t * clientP)
+{
+    utils_buffer_t buffer;
+    uint8_t data[256];
+    int result;
+
+    LOG_ARG("Client %d", clientP->internalID);
+    utils_bufferInit(&buffer, data, sizeof(data));
+    result = prv_writeClient(fileP->contextP, clientP, &buffer);
+    if (result != 0)
+    {
+        // larger than the stack buffer
+        utils_bufferInit(&buffer, NULL, 0);
+        result = prv_writeClient(fileP->contextP, clientP, &buffer);
+    }
+    prv_append(fileP, &buffer, result);
+    utils_bufferFree(&buffer);
+}
+
+static int prv_addClient(lwm2m_client_t * clientP,
+                         lwm2m_client_store_t * storeP)
+{
+    _file_store_t * fileP = (_file_store_t *)storeP->userData;
+
+    if (fileP->innerP->addClientFunc(clientP, fileP->innerP) != 0) return -1;
+    prv_saveClient(fileP, clientP);
+
+    return 0;
+}
+
+static void prv_updateClient(lwm2m_client_t * clientP,
+                             lwm2m_client_store_t * storeP)
+{
+    _file_store_t * fileP = (_file_store_t *)storeP->userData;
+
+    fileP->innerP->updateClientFunc(clientP, fileP->innerP);
+    prv_saveClient(fileP, clientP);
+}
+
+static lwm2m_client_t * prv_findClient(uint16_t internalID,
+                                       lwm2m_client_store_t * storeP)
+{
+    _file_store_t * fileP = (_file_store_t *)storeP->userData;
+
+    return fileP->innerP->findClientFunc(internalID, fileP->innerP);
+}
+
+static lwm2m_client_t * prv_findName(const char * name,
+                                     size_t nameLength,
+                                     lwm2m_client_store_t * storeP)
+{
+    _file_store_t * fileP = (_file_store_t *)storeP->userData;
+
+    return fileP->innerP->findNameFunc(name, nameLength, fileP->innerP);
+}
+
+static lwm2m_client_t * prv_removeClient(uint16_t internalID,
+                                         lwm2m_client_store_t * storeP)
+{
+    _file_store_t * fileP = (_file_store_t *)storeP->userData;
+    lwm2m_client_t * clientP;
+    utils_buffer_t buffer;
+    uint8_t data[PRV_HEADER_SIZE + 2 + PRV_HASH_SIZE];
+    int result;
+
+    clientP = fileP->innerP->removeClientFunc(internalID, fileP->innerP);
+    if (clientP != NULL)
+    {
+        LOG_ARG("Client %d", internalID);
+        utils_bufferInit(&buffer, data, sizeof(data));
+        result = prv_writeDelete(internalID, &buffer);
+        prv_append(fileP, &buffer, result);
+    }
+
+    return clientP;
+}
+
+static lwm2m_client_t * prv_nextClient(lwm2m_client_t * clientP,
+                                       lwm2m_client_store_t * storeP)
+{
+    _file_store_t * fileP = (_file_store_t *)storeP->userData;
+
+    return fileP->innerP->nextClientFunc(clientP, fileP->innerP);
+}
+
+static uint16_t prv_newId(lwm2m_client_store_t * storeP)
+{
+    _file_store_t * fileP = (_file_store_t *)storeP->userData;
+
+    return fileP->innerP->newIdFunc(fileP->innerP);
+}
+
+static int prv_addObservation(lwm2m_observation_t * observationP,
+                              lwm2m_client_store_t * storeP)
+{
+    _file_store_t * fileP = (_file_store_t *)storeP->userData;
+    utils_buffer_t buffer;
+    uint8_t data[128];
+    int result;
+
+    if (fileP->innerP->addObservationFunc(observationP, fileP->innerP) != 0) return -1;
+
+    LOG_ARG("Client %d, observation %d", observationP->clientP->internalID, observationP->id);
+    utils_bufferInit(&buffer, data, sizeof(data));
+    result = prv_writeObservation(fileP->contextP, observationP, &buffer);
+    if (result == 1)
+    {
+        // an observation of the same ID with another subscriber may be in the log
+        result = prv_writeObservationDelete(observationP, &buffer);
+    }
+    prv_append(fileP, &buffer, result);
+
+    return 0;
+}
+
+static lwm2m_observation_t * prv_findObservation(lwm2m_client_t * clientP,
+                                                 uint16_t id,
+                                                 lwm2m_client_store_t * storeP)
+{
+    _file_store_t * fileP = (_file_store_t *)storeP->userData;
+
+    return fileP->innerP->findObservationFunc(clientP, id, fileP->innerP);
+}
+
+static void prv_removeObservation(lwm2m_observation_t * observationP,
+                                  lwm2m_client_store_t * storeP)
+{
+    _file_store_t * fileP = (_file_store_t *)storeP->userData;
+    utils_buffer_t buffer;
+    uint8_t data[PRV_HEADER_SIZE + 4 + PRV_HASH_SIZE];
+    int result;
+
+    fileP->innerP->removeObservationFunc(observationP, fileP->innerP);
+
+    LOG_ARG("Client %d, observation %d", observationP->clientP->internalID, observationP->id);
+    utils_bufferInit(&buffer, data, sizeof(data));
+    result = prv_writeObservationDelete(observationP, &buffer);
+    prv_append(fileP, &buffer, result);
+}
+
+static void prv_close(lwm2m_client_store_t * storeP)
+{
+    _file_store_t * fileP = (_file_store_t *)storeP->userData;
+
+    fileP->innerP->closeFunc(fileP->innerP);
+    lwm2m_free(fileP);
+}
+
+// Replays the log in the store of the context
+static int prv_load(_file_store_t * fileP)
+{
+    lwm2m_context_t * contextP = fileP->contextP;
+    lwm2m_client_store_t * storeP = fileP->innerP;
+    uint8_t * buffer;
+    size_t length;
+    size_t offset;
+    lwm2m_client_object_t * objects;
+    size_t capacity;
+    time_t currentTime;
+    lwm2m_client_t * clientP;
+    int result;
+
+    currentTime = lwm2m_gettime();
+    if (currentTime < 0) return -1;
+    buffer = NULL;
+    length = 0;
+    if (lwm2m_store_open(&buffer, &length, contextP->userData) != 0) return -1;
+
+    objects = NULL;
+    capacity = 0;
+    offset = 0;
+    while (length - offset >= PRV_HEADER_SIZE + PRV_HASH_SIZE)
+    {
+        _reader_t reader;
+        uint32_t payloadLength;
+
+        payloadLength = prv_getU32(buffer + offset + 1);
+        if (payloadLength > length - offset - PRV_HEADER_SIZE - PRV_HASH_SIZE
+         || utils_hash(buffer + offset, PRV_HEADER_SIZE + payloadLength) != prv_getU32(buffer + offset + PRV_HEADER_SIZE + payloadLength))
+        {
+            LOG_ARG("Invalid record at offset %d", (int)offset);
+            break;
+        }
+
+        reader.data = buffer + offset + PRV_HEADER_SIZE;
+        reader.length = payloadLength;
+        reader.offset = 0;
+        result = 0;
+        switch (buffer[offset])
+        {
+        case PRV_RECORD_CLIENT:
+            result = prv_readClient(contextP, &reader, currentTime, &objects, &capacity);
+            break;
+
+        case PRV_RECORD_DELETE:
+        {
+            uint16_t internalID;
+
+            if (!prv_readU16(&reader, &internalID))
+            {
+                result = -1;
+                break;
+            }
+            clientP = storeP->removeClientFunc(internalID, storeP);
+            if (clientP != NULL)
+            {
+                registration_freeClient(contextP, clientP);
+            }
+        }
+        break;
+
+        case PRV_RECORD_OBSERVATION:
+            result = prv_readObservation(contextP, &reader);
+            break;
+
+        case PRV_RECORD_OBSERVATION_DELETE:
+        {
+            uint16_t clientID;
+            uint16_t id;
+            lwm2m_observation_t * observationP;
+
+            if (!prv_readU16(&reader, &clientID)
+             || !prv_readU16(&reader, &id))
+            {
+                result = -1;
+                break;
+            }
+            clientP = storeP->findClientFunc(clientID, storeP);
+            if (clientP == NULL) break;
+            observationP = storeP->findObservationFunc(clientP, id, storeP);
+            if (observationP != NULL)
+            {
+                observe_remove(observationP);
+            }
+        }
+        break;
+
+        default:
+            // unknown records are skipped
+            break;
+        }
+        if (result != 0)
+        {
+            // a rewrite of the log would drop it
+            LOG_ARG("Failed to restore the record at offset %d", (int)offset);
+            fileP->incomplete = true;
+        }
+
+        offset += PRV_HEADER_SIZE + payloadLength + PRV_HASH_SIZE;
+        fileP->recordCount++;
+    }
+    lwm2m_free(objects);
+
+    // cut an invalid end of log, like a record partially written when the server stopped
+    if (offset != length
+     && lwm2m_store_replace(buffer, offset, contextP->userData) != 0)
+    {
+        fileP->outdated = true;
+    }
+    lwm2m_store_close(buffer, length, contextP->userData);
+
+    fileP->liveCount = 0;
+    for (clientP = storeP->nextClientFunc(NULL, storeP) ; clientP != NULL ; clientP = storeP->nextClientFunc(clientP, storeP))
+    {
+        lwm2m_observation_t * observationP;
+
+        fileP->liveCount++;
+        for (observationP = clientP->observationList ; observationP != NULL ; observationP = observationP->next)
+        {
+            fileP->liveCount++;
+        }
+    }
+    LOG_ARG("%d current records out of %d", (int)fileP->liveCount, (int)fileP->recordCount);
+
+    return 0;
+}
+
+// Wraps the store of the context, in which the log is replayed
+lwm2m_client_store_t * store_open(lwm2m_context_t * contextP)
+{
+    _file_store_t * fileP;
+
+    fileP = (_file_store_t *)lwm2m_malloc(sizeof(_file_store_t));
+    if (fileP == NULL) return NULL;
+    memset(fileP, 0, sizeof(_file_store_t));
+    fileP->innerP = contextP->clientStore;
+    fileP->contextP = contextP;
+
+    if (prv_load(fileP) != 0)
+    {
+        lwm2m_free(fileP);
+        return NULL;
+    }
+
+    fileP->store.addClientFunc = prv_addClient;
+    fileP->store.updateClientFunc = prv_updateClient;
+    fileP->store.findClientFunc = prv_findClient;
+    fileP->store.findNameFunc = prv_findName;
+    fileP->store.removeClientFunc = prv_removeClient;
+    fileP->store.nextClientFunc = prv_nextClient;
+    fileP->store.newIdFunc = prv_newId;
+    fileP->store.addObservationFunc = prv_addObservation;
+    fileP->store.findObservationFunc = prv_findObservation;
+    fileP->store.removeObservationFunc = prv_removeObservation;
+    fileP->store.closeFunc = prv_close;
+    fileP->store.userData = fileP;
+
+    return &fileP->store;
+}
+
+#endif
@@ -301,171 +301,111 @@ int lwm2m_decode_TLV(const uint8_t * buffer,
 }
 
 
+// Count the records at this level without decoding their content.
+static int prv_countRecords(const uint8_t * buffer,
+                            size_t bufferLen)
+{
+    lwm2m_data_type_t type;
+    uint16_t id;
+    size_t dataIndex;
+    size_t dataLen;
+    size_t index = 0;
+    int result;
+    int count = 0;
+
+    while (0 != (result = lwm2m_decode_TLV(buffer + index, bufferLen - index, &type, &id, &dataIndex, &dataLen)))
+    {
+        count++;
+        index += result;
+    }
+
+    return count;
+}
+
+// The records are counted first so that the array is allocated once for each level.
 int tlv_parse(uint8_t * buffer,
               size_t bufferLen,
+              bool isBorrowed,
               lwm2m_data_t ** dataP)
 {
     lwm2m_data_type_t type;
     uint16_t id;
     size_t dataIndex;
     size_t dataLen;
-    int index = 0;
-    int result;
-    int size = 0;
+    size_t index = 0;
+    int size;
+    int i;
 
-    LOG_ARG("bufferLen: %d", bufferLen);
+    LOG_ARG("bufferLen: %d, isBorrowed: %s", bufferLen, isBorrowed?"true":"false");
 
     *dataP = NULL;
 
-    while (0 != (result = lwm2m_decode_TLV((uint8_t*)buffer + index, bufferLen - index, &type, &id, &dataIndex, &dataLen)))
+    size = prv_countRecords(buffer, bufferLen);
+    if (size == 0) return 0;
+
+    *dataP = lwm2m_data_new(size);
+    if (*dataP == NULL) return 0;
+
+    for (i = 0 ; i < size ; i++)
     {
-        lwm2m_data_t * newTlvP;
+        lwm2m_data_t * recordP = (*dataP) + i;
+        int result;
 
-        newTlvP = lwm2m_data_new(size + 1);
-        if (size >= 1)
-        {
-            if (newTlvP == NULL)
-            {
-                lwm2m_data_free(size, *dataP);
-                return 0;
-            }
-            else
-            {
-                memcpy(newTlvP, *dataP, size * sizeof(lwm2m_data_t));
-                lwm2m_free(*dataP);
-            }
-        }
-        *dataP = newTlvP;
+        result = lwm2m_decode_TLV(buffer + index, bufferLen - index, &type, &id, &dataIndex, &dataLen);
 
-        (*dataP)[size].type = type;
-        (*dataP)[size].id = id;
+        recordP->type = type;
+        recordP->id = id;
         if (type == LWM2M_TYPE_OBJECT_INSTANCE || type == LWM2M_TYPE_MULTIPLE_RESOURCE)
         {
-            (*dataP)[size].value.asChildren.count = tlv_parse(buffer + index + dataIndex,
-                                                          dataLen,
-                                                          &((*dataP)[size].value.asChildren.array));
-            if ((*dataP)[size].value.asChildren.count == 0)
+            recordP->value.asChildren.count = tlv_parse(buffer + index + dataIndex,
+                                                        dataLen,
+                                                        isBorrowed,
+                                                        &(recordP->value.asChildren.array));
+            if (recordP->value.asChildren.count == 0)
             {
-                lwm2m_data_free(size + 1, *dataP);
+                lwm2m_data_free(i + 1, *dataP);
+                *dataP = NULL;
                 return 0;
             }
         }
-        else
+        else if (isBorrowed)
         {
-            lwm2m_data_encode_opaque(buffer + index + dataIndex, dataLen, (*dataP) + size);
+            recordP->type = LWM2M_TYPE_OPAQUE;
+            recordP->flags = LWM2M_DATA_FLAG_BORROWED;
+            recordP->value.asBuffer.length = dataLen;
+            recordP->value.asBuffer.buffer = (dataLen == 0) ? NULL : buffer + index + dataIndex;
         }
-        size++;
-        index += result;
-    }
-
-    return size;
-}
-
-
-static int prv_getLength(int size,
-                         lwm2m_data_t * dataP)
-{
-    int length;
-    int i;
-
-    length = 0;
-
-    for (i = 0 ; i < size && length != -1 ; i++)
-    {
-        switch (dataP[i].type)
+        else
         {
-        case LWM2M_TYPE_OBJECT_INSTANCE:
-        case LWM2M_TYPE_MULTIPLE_RESOURCE:
+            recordP->type = LWM2M_TYPE_OPAQUE;
+            if (0 == data_copyBuffer(recordP, buffer + index + dataIndex, dataLen))
             {
-                int subLength;
-
-                subLength = prv_getLength(dataP[i].value.asChildren.count, dataP[i].value.asChildren.array);
-                if (subLength == -1)
-                {
-                    length = -1;
-                }
-                else
-                {
-                    length += prv_getHeaderLength(dataP[i].id, subLength) + subLength;
-                }
-            }
-            break;
-
-        case LWM2M_TYPE_STRING:
-        case LWM2M_TYPE_OPAQUE:
-            length += prv_getHeaderLength(dataP[i].id, dataP[i].value.asBuffer.length) + dataP[i].value.asBuffer.length;
-            break;
-
-        case LWM2M_TYPE_INTEGER:
-            {
-                size_t data_len;
-                uint8_t unused_buffer[_PRV_64BIT_BUFFER_SIZE];
-
-                data_len = prv_encodeInt(dataP[i].value.asInteger, unused_buffer);
-                length += prv_getHeaderLength(dataP[i].id, data_len) + data_len;
-            }
-            break;
-
-        case LWM2M_TYPE_FLOAT:
-            {
-                size_t data_len;
-
-                if ((dataP[i].value.asFloat < 0.0 - (double)FLT_MAX)
-                    || (dataP[i].value.asFloat >(double)FLT_MAX))
-                {
-                    data_len = 8;
-                }
-                else
-                {
-                    data_len = 4;
-                }
-
-                length += prv_getHeaderLength(dataP[i].id, data_len) + data_len;
+                lwm2m_data_free(i + 1, *dataP);
+                *dataP = NULL;
+                return 0;
             }
-            break;
-
-        case LWM2M_TYPE_BOOLEAN:
-            // Booleans are always encoded on one byte
-            length += prv_getHeaderLength(dataP[i].id, 1) + 1;
-            break;
-
-        case LWM2M_TYPE_OBJECT_LINK:
-            // Object Link are always encoded on four bytes
-            length += prv_getHeaderLength(dataP[i].id, 4) + 4;
-            break;
-
-        default:
-            length = -1;
-            break;
         }
+        index += result;
     }
 
-    return length;
+    return size;
 }
 
 
-int tlv_serialize(bool isResourceInstance, 
-                  int size,
-                  lwm2m_data_t * dataP,
-                  uint8_t ** bufferP)
+// Append the TLV records of the data to the buffer in a single pass. The header of an object instance
+// or multiple resource is reserved before its content is written, then patched with the actual length.
+static int prv_writeData(utils_buffer_t * bufferP,
+                         bool isResourceInstance,
+                         int size,
+                         lwm2m_data_t * dataP)
 {
-    int length;
-    int index;
     int i;
 
-    LOG_ARG("isResourceInstance: %s, size: %d", isResourceInstance?"true":"false", size);
-
-    *bufferP = NULL;
-    length = prv_getLength(size, dataP);
-    if (length <= 0) return length;
-
-    *bufferP = (uint8_t *)lwm2m_malloc(length);
-    if (*bufferP == NULL) return 0;
-
-    index = 0;
-    for (i = 0 ; i < size && length != 0 ; i++)
+    for (i = 0 ; i < size ; i++)
     {
-        int headerLen;
+        uint8_t data_buffer[_PRV_64BIT_BUFFER_SIZE];
+        uint8_t * valueP;
+        size_t data_len;
         bool isInstance;
 
         isInstance = isResourceInstance;
@@ -476,105 +416,135 @@ int tlv_serialize(bool isResourceInstance,
             // fall through
         case LWM2M_TYPE_OBJECT_INSTANCE:
             {
-                uint8_t * tmpBuffer;
-                int res;
-
-                res = tlv_serialize(isInstance, dataP[i].value.asChildren.count, dataP[i].value.asChildren.array, &tmpBuffer);
-                if (res < 0)
+                size_t start;
+                size_t headerLen;
+                size_t realHeaderLen;
+                size_t childLen;
+
+                // guess a one-byte length, unless the buffer cannot grow: then any byte reserved
+                // in excess could make a payload which fits exactly fail
+                headerLen = prv_getHeaderLength(dataP[i].id, bufferP->isStatic ? 0 : 0xFF);
+                if (utils_bufferReserve(bufferP, headerLen) != 0) return -1;
+                start = bufferP->length;
+                bufferP->length += headerLen;
+
+                if (prv_writeData(bufferP, isInstance, dataP[i].value.asChildren.count, dataP[i].value.asChildren.array) < 0) return -1;
+
+                childLen = bufferP->length - start - headerLen;
+                realHeaderLen = prv_getHeaderLength(dataP[i].id, childLen);
+                if (realHeaderLen != headerLen)
                 {
-                    length = -1;
-                }
-                else
-                {
-                    size_t tmpLength;
-
-                    tmpLength = (size_t)res;
-                    headerLen = prv_createHeader(*bufferP + index, false, dataP[i].type, dataP[i].id, tmpLength);
-                    index += headerLen;
-                    if (tmpLength > 0)
+                    if (realHeaderLen > headerLen
+                     && utils_bufferReserve(bufferP, realHeaderLen - headerLen) != 0)
                     {
-                        memcpy(*bufferP + index, tmpBuffer, tmpLength);
-                        index += tmpLength;
-                        lwm2m_free(tmpBuffer);
+                        return -1;
                     }
+                    memmove(bufferP->data + start + realHeaderLen, bufferP->data + start + headerLen, childLen);
+                    bufferP->length = start + realHeaderLen + childLen;
                 }
+                prv_createHeader(bufferP->data + start, false, dataP[i].type, dataP[i].id, childLen);
             }
-            break;
+            continue;
 
         case LWM2M_TYPE_OBJECT_LINK:
             {
                 int k;
-                uint8_t buf[4];
                 uint32_t v = dataP[i].value.asObjLink.objectId;
                 v <<= 16;
                 v |= dataP[i].value.asObjLink.objectInstanceId;
                 for (k = 3; k >= 0; --k) {
-                    buf[k] = (uint8_t)(v & 0xFF);
+                    data_buffer[k] = (uint8_t)(v & 0xFF);
                     v >>= 8;
                 }
                 // keep encoding as buffer
-                headerLen = prv_createHeader(*bufferP + index, isInstance, dataP[i].type, dataP[i].id, 4);
-                index += headerLen;
-                memcpy(*bufferP + index, buf, 4);
-                index += 4;
+                valueP = data_buffer;
+                data_len = 4;
             }
             break;
 
         case LWM2M_TYPE_STRING:
         case LWM2M_TYPE_OPAQUE:
-            headerLen = prv_createHeader(*bufferP + index, isInstance, dataP[i].type, dataP[i].id, dataP[i].value.asBuffer.length);
-            index += headerLen;
-            memcpy(*bufferP + index, dataP[i].value.asBuffer.buffer, dataP[i].value.asBuffer.length);
-            index += dataP[i].value.asBuffer.length;
+            valueP = lwm2m_data_get_buffer(dataP + i, &data_len);
             break;
 
         case LWM2M_TYPE_INTEGER:
-            {
-                size_t data_len;
-                uint8_t data_buffer[_PRV_64BIT_BUFFER_SIZE];
-
-                data_len = prv_encodeInt(dataP[i].value.asInteger, data_buffer);
-                headerLen = prv_createHeader(*bufferP + index, isInstance, dataP[i].type, dataP[i].id, data_len);
-                index += headerLen;
-                memcpy(*bufferP + index, data_buffer, data_len);
-                index += data_len;
-            }
+            valueP = data_buffer;
+            data_len = prv_encodeInt(dataP[i].value.asInteger, data_buffer);
             break;
 
         case LWM2M_TYPE_FLOAT:
-            {
-                size_t data_len;
-                uint8_t data_buffer[_PRV_64BIT_BUFFER_SIZE];
-
-                data_len = prv_encodeFloat(dataP[i].value.asFloat, data_buffer);
-                headerLen = prv_createHeader(*bufferP + index, isInstance, dataP[i].type, dataP[i].id, data_len);
-                index += headerLen;
-                memcpy(*bufferP + index, data_buffer, data_len);
-                index += data_len;
-            }
+            valueP = data_buffer;
+            data_len = prv_encodeFloat(dataP[i].value.asFloat, data_buffer);
             break;
 
         case LWM2M_TYPE_BOOLEAN:
-            headerLen = prv_createHeader(*bufferP + index, isInstance, dataP[i].type, dataP[i].id, 1);
-            index += headerLen;
-            (*bufferP)[index] = dataP[i].value.asBoolean ? 1 : 0;
-            index += 1;
+            data_buffer[0] = dataP[i].value.asBoolean ? 1 : 0;
+            valueP = data_buffer;
+            data_len = 1;
             break;
 
         default:
-            length = -1;
-            break;
+            return -1;
+        }
+
+        if (bufferP->capacity - bufferP->length < _PRV_TLV_HEADER_MAX_LENGTH + data_len
+         && utils_bufferReserve(bufferP, prv_getHeaderLength(dataP[i].id, data_len) + data_len) != 0)
+        {
+            return -1;
         }
+        bufferP->length += prv_createHeader(bufferP->data + bufferP->length, isInstance, dataP[i].type, dataP[i].id, data_len);
+        if (data_len > 0)
+        {
+            memcpy(bufferP->data + bufferP->length, valueP, data_len);
+            bufferP->length += data_len;
+        }
+    }
+
+    return 0;
+}
+
+// Append the serialized data to bufferP. Returns the number of bytes written or -1 on error.
+int tlv_serializeBuffer(bool isResourceInstance,
+                        int size,
+                        lwm2m_data_t * dataP,
+                        utils_buffer_t * bufferP)
+{
+    size_t start;
+
+    LOG_ARG("isResourceInstance: %s, size: %d", isResourceInstance?"true":"false", size);
+
+    start = bufferP->length;
+    if (prv_writeData(bufferP, isResourceInstance, size, dataP) < 0)
+    {
+        bufferP->length = start;
+        return -1;
     }
 
-    if (length < 0)
+    return (int)(bufferP->length - start);
+}
+
+int tlv_serialize(bool isResourceInstance, 
+                  int size,
+                  lwm2m_data_t * dataP,
+                  uint8_t ** bufferP)
+{
+    utils_buffer_t buffer;
+    int length;
+
+    *bufferP = NULL;
+
+    utils_bufferInit(&buffer, NULL, 0);
+    length = tlv_serializeBuffer(isResourceInstance, size, dataP, &buffer);
+    if (length <= 0)
     {
-        lwm2m_free(*bufferP);
-        *bufferP = NULL;
+        utils_bufferFree(&buffer);
+        return length;
     }
 
+    // the buffer becomes the payload as is
+    *bufferP = buffer.data;
+
     LOG_ARG("returning %u", length);
 
     return length;
 }
-
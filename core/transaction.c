@@ -121,7 +121,7 @@ static int prv_checkFinished(lwm2m_transaction_t * transacP,
     const uint8_t* token;
     coap_packet_t * transactionMessage = transacP->message;
 
-    if (COAP_DELETE < transactionMessage->code)
+    if (COAP_IPATCH < transactionMessage->code)
     {
         // response
         return transacP->ack_received ? 1 : 0;
@@ -250,6 +250,14 @@ error:
 void transaction_free(lwm2m_transaction_t * transacP)
 {
     LOG("Entering");
+    while (transacP->coalesced != NULL)
+    {
+        lwm2m_transaction_t * coalescedP = transacP->coalesced;
+
+        transacP->coalesced = coalescedP->next;
+        transaction_free(coalescedP);
+    }
+
     if (transacP->message)
     {
        coap_free_header(transacP->message);
@@ -289,6 +297,24 @@ void transaction_remove_all(lwm2m_context_t * contextP,
     }
 }
 
+// Call the callback of the transaction and of the duplicates coalesced with it.
+// message is NULL if the transaction failed.
+void transaction_complete(lwm2m_transaction_t * transacP,
+                          void * message)
+{
+    lwm2m_transaction_t * coalescedP;
+
+    if (transacP->callback != NULL)
+    {
+        transacP->callback(transacP, message);
+    }
+
+    for (coalescedP = transacP->coalesced ; coalescedP != NULL ; coalescedP = coalescedP->next)
+    {
+        transaction_complete(coalescedP, message);
+    }
+}
+
 bool transaction_handleResponse(lwm2m_context_t * contextP,
                                  void * fromSessionH,
                                  coap_packet_t * message,
@@ -338,10 +364,7 @@ bool transaction_handleResponse(lwm2m_context_t * contextP,
                 	    return true;
                 	}
 				}       
-                if (transacP->callback != NULL)
-                {
-                    transacP->callback(transacP, message);
-                }
+                transaction_complete(transacP, message);
                 transaction_remove(contextP, transacP);
                 return true;
             }
@@ -370,36 +393,39 @@ bool transaction_handleResponse(lwm2m_context_t * contextP,
     return false;
 }
 
+// Serializes the message in the transaction buffer. Once done, the memory holding the message payload
+// can be released even if the transaction is sent later.
+int transaction_serialize(lwm2m_transaction_t * transacP)
+{
+    if (transacP->buffer != NULL) return 0;
+
+    transacP->buffer_len = coap_serialize_get_size(transacP->message);
+    if (transacP->buffer_len == 0) return -1;
+
+    transacP->buffer = (uint8_t*)lwm2m_malloc(transacP->buffer_len);
+    if (transacP->buffer == NULL) return -1;
+
+    transacP->buffer_len = coap_serialize_message(transacP->message, transacP->buffer);
+    if (transacP->buffer_len == 0)
+    {
+        lwm2m_free(transacP->buffer);
+        transacP->buffer = NULL;
+        return -1;
+    }
+
+    return 0;
+}
+
 int transaction_send(lwm2m_context_t * contextP,
                      lwm2m_transaction_t * transacP)
 {
     bool maxRetriesReached = false;
 
     LOG("Entering");
-    if (transacP->buffer == NULL)
+    if (transaction_serialize(transacP) != 0)
     {
-        transacP->buffer_len = coap_serialize_get_size(transacP->message);
-        if (transacP->buffer_len == 0)
-        {
-           transaction_remove(contextP, transacP);
-           return COAP_500_INTERNAL_SERVER_ERROR;
-        }
-
-        transacP->buffer = (uint8_t*)lwm2m_malloc(transacP->buffer_len);
-        if (transacP->buffer == NULL)
-        {
-           transaction_remove(contextP, transacP);
-           return COAP_500_INTERNAL_SERVER_ERROR;
-        }
-
-        transacP->buffer_len = coap_serialize_message(transacP->message, transacP->buffer);
-        if (transacP->buffer_len == 0)
-        {
-            lwm2m_free(transacP->buffer);
-            transacP->buffer = NULL;
-            transaction_remove(contextP, transacP);
-            return COAP_500_INTERNAL_SERVER_ERROR;
-        }
+        transaction_remove(contextP, transacP);
+        return COAP_500_INTERNAL_SERVER_ERROR;
     }
 
     if (!transacP->ack_received)
@@ -440,10 +466,7 @@ int transaction_send(lwm2m_context_t * contextP,
 
     if (maxRetriesReached)
     {
-        if (transacP->callback)
-        {
-            transacP->callback(transacP, NULL);
-        }
+        transaction_complete(transacP, NULL);
         transaction_remove(contextP, transacP);
         return -1;
     }
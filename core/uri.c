@@ -115,6 +115,15 @@ lwm2m_uri_t * uri_decode(char * altPath,
         uriPath = uriPath->next;
         if (uriPath == NULL) return uriP;
     }
+    else if (NULL != uriPath
+     && URI_SEND_SEGMENT_LEN == uriPath->len
+     && 0 == strncmp(URI_SEND_SEGMENT, (char *)uriPath->data, uriPath->len))
+    {
+        uriP->flag |= LWM2M_URI_FLAG_SEND;
+        uriPath = uriPath->next;
+        if (uriPath != NULL) goto error;
+        return uriP;
+    }
     else if (NULL != uriPath
      && URI_BOOTSTRAP_SEGMENT_LEN == uriPath->len
      && 0 == strncmp(URI_BOOTSTRAP_SEGMENT, (char *)uriPath->data, uriPath->len))
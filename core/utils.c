@@ -50,7 +50,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
-#include <float.h>
 
 
 int utils_textToInt(uint8_t * buffer,
@@ -98,67 +97,656 @@ int utils_textToInt(uint8_t * buffer,
     return 1;
 }
 
-int utils_textToFloat(uint8_t * buffer,
-                      int length,
-                      double * dataP)
+/*
+ * Floating point conversions
+ *
+ * utils_textToFloat() returns the correctly rounded double. Short values are
+ * converted exactly with a single floating point operation. Other values are
+ * scaled by one 64-bit multiplication with a cached power of ten, like in the
+ * Eisel-Lemire algorithm, and the rare results too close to a rounding
+ * boundary are decided with a small big integer comparison.
+ *
+ * utils_floatToText() writes the shortest decimal string reading back to the
+ * same double using the Grisu2 algorithm (F. Loitsch, "Printing Floating-Point
+ * Numbers Quickly and Accurately with Integers", PLDI 2010).
+ *
+ * The big integer comparison uses the first 128 significant digits of the
+ * text, which is exact for any text up to that length.
+ */
+
+#define PRV_DP_SIGNIFICAND_SIZE     52
+#define PRV_DP_EXPONENT_BIAS        (0x3FF + PRV_DP_SIGNIFICAND_SIZE)
+#define PRV_DP_DENORMAL_EXPONENT    (1 - PRV_DP_EXPONENT_BIAS)
+#define PRV_DP_MAX_BIASED_EXPONENT  0x7FF
+#define PRV_DP_SIGN_MASK            0x8000000000000000ULL
+#define PRV_DP_EXPONENT_MASK        0x7FF0000000000000ULL
+#define PRV_DP_SIGNIFICAND_MASK     0x000FFFFFFFFFFFFFULL
+#define PRV_DP_HIDDEN_BIT           0x0010000000000000ULL
+
+#define PRV_DECIMAL_MAX_DIGITS      19      // always fit in an uint64_t
+#define PRV_EXACT_MAX_SIGNIFICAND   (PRV_DP_HIDDEN_BIT << 1)
+#define PRV_EXACT_MAX_EXPONENT      22
+#define PRV_DECIMAL_MAX_EXPONENT    309     // DBL_MAX is 1.8e308
+#define PRV_DECIMAL_MIN_EXPONENT    (-324)  // smallest denormal is 4.9e-324
+#define PRV_CACHED_POWER_MIN_EXP    (-348)
+#define PRV_CACHED_POWER_STEP       8
+#define PRV_GRISU_MARGIN            4       // twice the bound of the scaling errors, in units
+#define PRV_ULP_SHIFT               3
+#define PRV_ULP                     (1 << PRV_ULP_SHIFT)
+#define PRV_BIG_INT_WORDS           40
+#define PRV_BIG_MAX_DIGITS          128     // fits in PRV_BIG_INT_WORDS once scaled
+
+// f * 2^e
+typedef struct
+{
+    uint64_t f;
+    int e;
+} _fp_t;
+
+typedef struct
+{
+    uint32_t word[PRV_BIG_INT_WORDS];
+    int count;
+} _big_int_t;
+
+// The value is the digitCount significant digits times 10^exponent, of
+// which significand holds the first 19 ones.
+typedef struct
+{
+    uint64_t significand;
+    int digitCount;
+    int nextDigit;
+    int exponent;
+} _decimal_t;
+
+// Normalized 64-bit significands and binary exponents of 10^-348, 10^-340, ..., 10^340
+static const uint64_t cachedPowersF[] =
+{
+    0xfa8fd5a0081c0288, 0xbaaee17fa23ebf76, 0x8b16fb203055ac76,
+    0xcf42894a5dce35ea, 0x9a6bb0aa55653b2d, 0xe61acf033d1a45df,
+    0xab70fe17c79ac6ca, 0xff77b1fcbebcdc4f, 0xbe5691ef416bd60c,
+    0x8dd01fad907ffc3c, 0xd3515c2831559a83, 0x9d71ac8fada6c9b5,
+    0xea9c227723ee8bcb, 0xaecc49914078536d, 0x823c12795db6ce57,
+    0xc21094364dfb5637, 0x9096ea6f3848984f, 0xd77485cb25823ac7,
+    0xa086cfcd97bf97f4, 0xef340a98172aace5, 0xb23867fb2a35b28e,
+    0x84c8d4dfd2c63f3b, 0xc5dd44271ad3cdba, 0x936b9fcebb25c996,
+    0xdbac6c247d62a584, 0xa3ab66580d5fdaf6, 0xf3e2f893dec3f126,
+    0xb5b5ada8aaff80b8, 0x87625f056c7c4a8b, 0xc9bcff6034c13053,
+    0x964e858c91ba2655, 0xdff9772470297ebd, 0xa6dfbd9fb8e5b88f,
+    0xf8a95fcf88747d94, 0xb94470938fa89bcf, 0x8a08f0f8bf0f156b,
+    0xcdb02555653131b6, 0x993fe2c6d07b7fac, 0xe45c10c42a2b3b06,
+    0xaa242499697392d3, 0xfd87b5f28300ca0e, 0xbce5086492111aeb,
+    0x8cbccc096f5088cc, 0xd1b71758e219652c, 0x9c40000000000000,
+    0xe8d4a51000000000, 0xad78ebc5ac620000, 0x813f3978f8940984,
+    0xc097ce7bc90715b3, 0x8f7e32ce7bea5c70, 0xd5d238a4abe98068,
+    0x9f4f2726179a2245, 0xed63a231d4c4fb27, 0xb0de65388cc8ada8,
+    0x83c7088e1aab65db, 0xc45d1df942711d9a, 0x924d692ca61be758,
+    0xda01ee641a708dea, 0xa26da3999aef774a, 0xf209787bb47d6b85,
+    0xb454e4a179dd1877, 0x865b86925b9bc5c2, 0xc83553c5c8965d3d,
+    0x952ab45cfa97a0b3, 0xde469fbd99a05fe3, 0xa59bc234db398c25,
+    0xf6c69a72a3989f5c, 0xb7dcbf5354e9bece, 0x88fcf317f22241e2,
+    0xcc20ce9bd35c78a5, 0x98165af37b2153df, 0xe2a0b5dc971f303a,
+    0xa8d9d1535ce3b396, 0xfb9b7cd9a4a7443c, 0xbb764c4ca7a44410,
+    0x8bab8eefb6409c1a, 0xd01fef10a657842c, 0x9b10a4e5e9913129,
+    0xe7109bfba19c0c9d, 0xac2820d9623bf429, 0x80444b5e7aa7cf85,
+    0xbf21e44003acdd2d, 0x8e679c2f5e44ff8f, 0xd433179d9c8cb841,
+    0x9e19db92b4e31ba9, 0xeb96bf6ebadf77d9, 0xaf87023b9bf0ee6b
+};
+
+static const int16_t cachedPowersE[] =
+{
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066
+};
+
+static const uint64_t pow10Int[] =
+{
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+
+static const double pow10Exact[PRV_EXACT_MAX_EXPONENT + 1] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static uint64_t prv_doubleToBits(double value)
+{
+    uint64_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static double prv_bitsToDouble(uint64_t bits)
+{
+    double value;
+
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void prv_fpNormalize(_fp_t * fpP)
+{
+    int shift;
+
+    if (fpP->f == 0) return;
+
+    for (shift = 32 ; shift > 0 ; shift >>= 1)
+    {
+        if (0 == (fpP->f >> (64 - shift)))
+        {
+            fpP->f <<= shift;
+            fpP->e -= shift;
+        }
+    }
+}
+
+// Keeps the rounded upper half of the 128-bit product.
+static void prv_fpMultiply(const _fp_t * aP,
+                           const _fp_t * bP,
+                           _fp_t * resultP)
+{
+    uint64_t aHigh = aP->f >> 32;
+    uint64_t aLow = aP->f & 0xFFFFFFFF;
+    uint64_t bHigh = bP->f >> 32;
+    uint64_t bLow = bP->f & 0xFFFFFFFF;
+    uint64_t hh = aHigh * bHigh;
+    uint64_t hl = aHigh * bLow;
+    uint64_t lh = aLow * bHigh;
+    uint64_t ll = aLow * bLow;
+    uint64_t middle;
+
+    middle = (ll >> 32) + (hl & 0xFFFFFFFF) + (lh & 0xFFFFFFFF);
+    middle += (uint64_t)1 << 31;
+
+    resultP->f = hh + (hl >> 32) + (lh >> 32) + (middle >> 32);
+    resultP->e = aP->e + bP->e + 64;
+}
+
+static void prv_cachedPower(int index,
+                            _fp_t * powerP)
 {
-    double result;
-    int sign;
+    powerP->f = cachedPowersF[index];
+    powerP->e = cachedPowersE[index];
+}
+
+static void prv_bigSet(_big_int_t * bigP,
+                       uint64_t value)
+{
+    bigP->count = 0;
+    while (value != 0)
+    {
+        bigP->word[bigP->count++] = (uint32_t)value;
+        value >>= 32;
+    }
+}
+
+static bool prv_bigMultiply(_big_int_t * bigP,
+                            uint32_t factor,
+                            uint32_t addend)
+{
+    uint64_t carry;
     int i;
 
-    if (0 == length) return 0;
+    carry = addend;
+    for (i = 0 ; i < bigP->count ; i++)
+    {
+        uint64_t product;
 
-    if (buffer[0] == '-')
+        product = (uint64_t)bigP->word[i] * factor + carry;
+        bigP->word[i] = (uint32_t)product;
+        carry = product >> 32;
+    }
+    if (carry != 0)
     {
-        sign = -1;
-        i = 1;
+        if (bigP->count == PRV_BIG_INT_WORDS) return false;
+        bigP->word[bigP->count++] = (uint32_t)carry;
+    }
+
+    return true;
+}
+
+static bool prv_bigMultiplyPow5(_big_int_t * bigP,
+                                int exponent)
+{
+    // 5^13 is the largest power of five fitting in 32 bits
+    while (exponent >= 13)
+    {
+        if (!prv_bigMultiply(bigP, 1220703125, 0)) return false;
+        exponent -= 13;
+    }
+    if (exponent == 0) return true;
+
+    return prv_bigMultiply(bigP, (uint32_t)(pow10Int[exponent] >> exponent), 0);
+}
+
+static bool prv_bigShiftLeft(_big_int_t * bigP,
+                             int shift)
+{
+    int words = shift / 32;
+    int bits = shift % 32;
+    int i;
+
+    if (bigP->count == 0) return true;
+    if (bigP->count + words + 1 > PRV_BIG_INT_WORDS) return false;
+
+    if (bits == 0)
+    {
+        for (i = bigP->count - 1 ; i >= 0 ; i--)
+        {
+            bigP->word[i + words] = bigP->word[i];
+        }
     }
     else
     {
-        sign = 1;
-        i = 0;
+        bigP->word[bigP->count + words] = bigP->word[bigP->count - 1] >> (32 - bits);
+        for (i = bigP->count - 1 ; i > 0 ; i--)
+        {
+            bigP->word[i + words] = (bigP->word[i] << bits) | (bigP->word[i - 1] >> (32 - bits));
+        }
+        bigP->word[words] = bigP->word[0] << bits;
+    }
+    for (i = 0 ; i < words ; i++)
+    {
+        bigP->word[i] = 0;
     }
+    bigP->count += words;
+    if (bits != 0 && bigP->word[bigP->count] != 0) bigP->count++;
+
+    return true;
+}
 
-    result = 0;
-    while (i < length && buffer[i] != '.')
+static int prv_bigCompare(const _big_int_t * aP,
+                          const _big_int_t * bP)
+{
+    int i;
+
+    if (aP->count != bP->count) return aP->count < bP->count ? -1 : 1;
+
+    for (i = aP->count - 1 ; i >= 0 ; i--)
     {
-        if ('0' <= buffer[i] && buffer[i] <= '9')
+        if (aP->word[i] != bP->word[i]) return aP->word[i] < bP->word[i] ? -1 : 1;
+    }
+
+    return 0;
+}
+
+// Scales significand * 10^exponent to the nearest double. The error is
+// tracked in 1/PRV_ULP units and false is returned if it may change the
+// rounding, in which case *bitsP holds the lower candidate.
+static bool prv_fpScale(uint64_t significand,
+                        int exponent,
+                        int digitCount,
+                        bool inexact,
+                        uint64_t * bitsP)
+{
+    _fp_t v;
+    _fp_t power;
+    int64_t error;
+    int index;
+    int adjustment;
+    int oldExp;
+    int order;
+    int precisionSize;
+    uint64_t precisionBits;
+    uint64_t halfWay;
+    uint64_t biasedExp;
+
+    error = inexact ? PRV_ULP / 2 : 0;
+    v.f = significand;
+    v.e = 0;
+    prv_fpNormalize(&v);
+    error <<= -v.e;
+
+    index = (exponent - PRV_CACHED_POWER_MIN_EXP) / PRV_CACHED_POWER_STEP;
+    adjustment = exponent - (PRV_CACHED_POWER_MIN_EXP + index * PRV_CACHED_POWER_STEP);
+    if (adjustment != 0)
+    {
+        // powers of ten below 10^8 are exact
+        power.f = pow10Int[adjustment];
+        power.e = 0;
+        prv_fpNormalize(&power);
+        prv_fpMultiply(&v, &power, &v);
+        if (digitCount + adjustment > PRV_DECIMAL_MAX_DIGITS) error += PRV_ULP / 2;
+    }
+    prv_cachedPower(index, &power);
+    prv_fpMultiply(&v, &power, &v);
+    error += PRV_ULP + (error == 0 ? 0 : 1);
+
+    oldExp = v.e;
+    prv_fpNormalize(&v);
+    error <<= oldExp - v.e;
+
+    order = 64 + v.e;
+    if (order < PRV_DP_DENORMAL_EXPONENT - 1)
+    {
+        // below half the smallest denormal
+        *bitsP = 0;
+        return true;
+    }
+    if (order == PRV_DP_DENORMAL_EXPONENT - 1)
+    {
+        // zero or the smallest denormal
+        *bitsP = 0;
+        return false;
+    }
+
+    if (order > PRV_DP_DENORMAL_EXPONENT + PRV_DP_SIGNIFICAND_SIZE)
+    {
+        precisionSize = 64 - (PRV_DP_SIGNIFICAND_SIZE + 1);
+    }
+    else
+    {
+        precisionSize = 64 - (order - PRV_DP_DENORMAL_EXPONENT);
+    }
+    if (precisionSize + PRV_ULP_SHIFT >= 64)
+    {
+        int scaleExp = (precisionSize + PRV_ULP_SHIFT) - 63;
+
+        v.f >>= scaleExp;
+        v.e += scaleExp;
+        error = (error >> scaleExp) + 1 + PRV_ULP;
+        precisionSize -= scaleExp;
+    }
+
+    precisionBits = (v.f & (((uint64_t)1 << precisionSize) - 1)) * PRV_ULP;
+    halfWay = ((uint64_t)1 << (precisionSize - 1)) * PRV_ULP;
+    v.f >>= precisionSize;
+    v.e += precisionSize;
+    if (precisionBits >= halfWay + (uint64_t)error)
+    {
+        v.f++;
+        if (0 != (v.f & (PRV_DP_HIDDEN_BIT << 1)))
         {
-            if (result > (DBL_MAX / 10)) return 0;
-            result *= 10;
-            result += (buffer[i] - '0');
+            v.f >>= 1;
+            v.e++;
         }
-        else
+    }
+
+    if (v.e == PRV_DP_DENORMAL_EXPONENT && 0 == (v.f & PRV_DP_HIDDEN_BIT))
+    {
+        biasedExp = 0;
+    }
+    else
+    {
+        biasedExp = (uint64_t)(v.e + PRV_DP_EXPONENT_BIAS);
+        if (biasedExp >= PRV_DP_MAX_BIASED_EXPONENT)
         {
-            return 0;
+            *bitsP = PRV_DP_EXPONENT_MASK;
+            return true;
         }
-        i++;
     }
-    if (buffer[i] == '.')
+    *bitsP = (v.f & PRV_DP_SIGNIFICAND_MASK) | (biasedExp << PRV_DP_SIGNIFICAND_SIZE);
+
+    return halfWay - (uint64_t)error >= precisionBits || precisionBits >= halfWay + (uint64_t)error;
+}
+
+// Rounds decimalP * 10^exponent exactly, knowing it lies between the double
+// *bitsP and the next one, by comparing it with their midpoint.
+static bool prv_bigRound(_big_int_t * decimalP,
+                         int exponent,
+                         uint64_t * bitsP)
+{
+    _big_int_t halfway;
+    uint64_t significand;
+    int binaryExp;
+    int shift;
+    int cmp;
+
+    if (0 != (*bitsP & PRV_DP_EXPONENT_MASK))
     {
-        double dec;
+        significand = (*bitsP & PRV_DP_SIGNIFICAND_MASK) | PRV_DP_HIDDEN_BIT;
+        binaryExp = (int)((*bitsP & PRV_DP_EXPONENT_MASK) >> PRV_DP_SIGNIFICAND_SIZE) - PRV_DP_EXPONENT_BIAS;
+    }
+    else
+    {
+        significand = *bitsP & PRV_DP_SIGNIFICAND_MASK;
+        binaryExp = PRV_DP_DENORMAL_EXPONENT;
+    }
 
+    // halfway is (2 * significand + 1) * 2^(binaryExp - 1)
+    prv_bigSet(&halfway, 2 * significand + 1);
+    if (exponent >= 0)
+    {
+        if (!prv_bigMultiplyPow5(decimalP, exponent)) return false;
+    }
+    else
+    {
+        if (!prv_bigMultiplyPow5(&halfway, -exponent)) return false;
+    }
+    shift = exponent - (binaryExp - 1);
+    if (shift >= 0)
+    {
+        if (!prv_bigShiftLeft(decimalP, shift)) return false;
+    }
+    else
+    {
+        if (!prv_bigShiftLeft(&halfway, -shift)) return false;
+    }
+
+    cmp = prv_bigCompare(decimalP, &halfway);
+    if (cmp > 0 || (cmp == 0 && 0 != (significand & 1)))
+    {
+        *bitsP += 1;
+    }
+
+    return true;
+}
+
+// Accumulates the digits starting at buffer[*indexP]. The ones of the
+// fractional part also lower the exponent.
+static void prv_decimalRead(_decimal_t * decimalP,
+                            const uint8_t * buffer,
+                            int length,
+                            int * indexP,
+                            bool isFraction)
+{
+    uint64_t significand = decimalP->significand;
+    int digitCount = decimalP->digitCount;
+    int exponent = decimalP->exponent;
+    int i = *indexP;
+
+    if (digitCount == 0)
+    {
+        while (i < length && buffer[i] == '0')
+        {
+            if (isFraction) exponent--;
+            i++;
+        }
+    }
+    while (i < length && '0' <= buffer[i] && buffer[i] <= '9')
+    {
+        if (digitCount < PRV_DECIMAL_MAX_DIGITS)
+        {
+            significand = significand * 10 + (buffer[i] - '0');
+        }
+        else if (digitCount == PRV_DECIMAL_MAX_DIGITS)
+        {
+            decimalP->nextDigit = buffer[i] - '0';
+        }
+        digitCount++;
+        if (isFraction) exponent--;
         i++;
-        if (i == length) return 0;
+    }
+
+    decimalP->significand = significand;
+    decimalP->digitCount = digitCount;
+    decimalP->exponent = exponent;
+    *indexP = i;
+}
+
+// Reads up to PRV_BIG_MAX_DIGITS significant digits of an already validated
+// number, followed by a one if any of the remaining digits is not zero.
+// Returns the decimal exponent of the last digit read.
+static int prv_bigSetDecimal(_big_int_t * bigP,
+                             const uint8_t * buffer,
+                             int length,
+                             const _decimal_t * decimalP)
+{
+    int count;
+    bool sticky;
+    int i;
+
+    bigP->count = 0;
+    count = 0;
+    sticky = false;
+    for (i = 0 ; i < length && buffer[i] != 'e' && buffer[i] != 'E' ; i++)
+    {
+        if (buffer[i] < '0' || buffer[i] > '9') continue;
+        if (count == 0 && buffer[i] == '0') continue;
+
+        if (count < PRV_BIG_MAX_DIGITS)
+        {
+            prv_bigMultiply(bigP, 10, buffer[i] - '0');
+            count++;
+        }
+        else if (buffer[i] != '0')
+        {
+            sticky = true;
+            break;
+        }
+    }
+    if (sticky)
+    {
+        prv_bigMultiply(bigP, 10, 1);
+        count++;
+    }
 
-        dec = 0.1;
-        while (i < length)
+    return decimalP->exponent + decimalP->digitCount - count;
+}
+
+// Converts an already validated number. buffer is only used when the
+// decimal has more than 19 significant digits.
+static bool prv_decimalToBits(const _decimal_t * decimalP,
+                              const uint8_t * buffer,
+                              int length,
+                              uint64_t * bitsP)
+{
+    bool inexact;
+    int keptCount;
+    int exponent;
+
+    if (decimalP->significand == 0
+     || decimalP->digitCount + decimalP->exponent < PRV_DECIMAL_MIN_EXPONENT)
+    {
+        *bitsP = 0;
+        return true;
+    }
+    if (decimalP->digitCount + decimalP->exponent > PRV_DECIMAL_MAX_EXPONENT) return false;
+
+    inexact = (decimalP->digitCount > PRV_DECIMAL_MAX_DIGITS);
+    keptCount = inexact ? PRV_DECIMAL_MAX_DIGITS : decimalP->digitCount;
+    exponent = decimalP->exponent + decimalP->digitCount - keptCount;
+
+    if (!inexact
+     && decimalP->significand <= PRV_EXACT_MAX_SIGNIFICAND
+     && exponent >= -PRV_EXACT_MAX_EXPONENT
+     && exponent <= PRV_EXACT_MAX_EXPONENT)
+    {
+        double result;
+
+        // both operands are exact so the result is correctly rounded
+        result = (double)decimalP->significand;
+        if (exponent < 0)
+        {
+            result /= pow10Exact[-exponent];
+        }
+        else
         {
-            if ('0' <= buffer[i] && buffer[i] <= '9')
+            result *= pow10Exact[exponent];
+        }
+        *bitsP = prv_doubleToBits(result);
+    }
+    else
+    {
+        uint64_t significand;
+
+        significand = decimalP->significand;
+        if (inexact && decimalP->nextDigit >= 5) significand++;
+
+        if (!prv_fpScale(significand, exponent, keptCount, inexact, bitsP))
+        {
+            _big_int_t big;
+
+            if (inexact)
             {
-                if (result > (DBL_MAX - 1)) return 0;
-                result += (buffer[i] - '0') * dec;
-                dec /= 10;
+                exponent = prv_bigSetDecimal(&big, buffer, length, decimalP);
             }
             else
             {
-                return 0;
+                prv_bigSet(&big, decimalP->significand);
             }
+            if (!prv_bigRound(&big, exponent, bitsP)) return false;
+        }
+        if ((*bitsP & PRV_DP_EXPONENT_MASK) == PRV_DP_EXPONENT_MASK) return false;
+    }
+
+    return true;
+}
+
+int utils_textToFloat(uint8_t * buffer,
+                      int length,
+                      double * dataP)
+{
+    _decimal_t decimal;
+    uint64_t bits;
+    int start;
+    int i;
+
+    if (length <= 0) return 0;
+
+    i = 0;
+    if (buffer[0] == '-') i = 1;
+
+    memset(&decimal, 0, sizeof(_decimal_t));
+    start = i;
+    prv_decimalRead(&decimal, buffer, length, &i, false);
+    if (i < length && buffer[i] == '.')
+    {
+        i++;
+        start = i;
+        prv_decimalRead(&decimal, buffer, length, &i, true);
+        if (i == start) return 0;
+    }
+    else if (i == start) return 0;
+    if (i < length && (buffer[i] == 'e' || buffer[i] == 'E'))
+    {
+        bool negativeExp = false;
+        int value = 0;
+
+        i++;
+        if (i < length && (buffer[i] == '+' || buffer[i] == '-'))
+        {
+            negativeExp = (buffer[i] == '-');
+            i++;
+        }
+        start = i;
+        while (i < length && '0' <= buffer[i] && buffer[i] <= '9')
+        {
+            // larger exponents overflow or underflow anyway
+            if (value < 100000) value = value * 10 + (buffer[i] - '0');
             i++;
         }
+        if (i == start) return 0;
+        decimal.exponent += negativeExp ? -value : value;
     }
+    if (i != length) return 0;
 
-    *dataP = result * sign;
+    if (!prv_decimalToBits(&decimal, buffer, length, &bits)) return 0;
+    if (buffer[0] == '-') bits |= PRV_DP_SIGN_MASK;
+
+    *dataP = prv_bitsToDouble(bits);
     return 1;
 }
 
@@ -210,68 +798,366 @@ size_t utils_intToText(int64_t data,
     return result;
 }
 
-size_t utils_floatToText(double data,
-                         uint8_t * string,
-                         size_t length)
+static int prv_countDigits(uint32_t value)
 {
-    size_t intLength;
-    size_t decLength;
-    int64_t intPart;
-    double decPart;
+    int count;
 
-    if (data <= (double)INT64_MIN || data >= (double)INT64_MAX) return 0;
+    count = 1;
+    while (count < 10 && value >= pow10Int[count])
+    {
+        count++;
+    }
 
-    intPart = (int64_t)data;
-    decPart = data - intPart;
-    if (decPart < 0)
+    return count;
+}
+
+// Moves the last digit closer to the exact value while staying in the
+// rounding interval.
+static void prv_grisuRound(uint8_t * digits,
+                           int count,
+                           uint64_t delta,
+                           uint64_t rest,
+                           uint64_t tenKappa,
+                           uint64_t distance)
+{
+    while (rest < distance
+        && delta - rest >= tenKappa
+        && (rest + tenKappa < distance || distance - rest > rest + tenKappa - distance))
     {
-        decPart = 1 - decPart;
+        digits[count - 1]--;
+        rest += tenKappa;
     }
-    else
+}
+
+// Generates the digits of upperP until the remainder is below delta.
+// *uncertainP is set when the previous digit position was so close to the
+// rounding interval that a shorter output may have been missed.
+static int prv_grisuDigits(const _fp_t * wP,
+                           const _fp_t * upperP,
+                           uint64_t delta,
+                           uint8_t * digits,
+                           int * kP,
+                           bool * uncertainP)
+{
+    int shift = -upperP->e;
+    uint64_t one = (uint64_t)1 << shift;
+    uint64_t distance = upperP->f - wP->f;
+    uint32_t integral = (uint32_t)(upperP->f >> shift);
+    uint64_t fractional = upperP->f & (one - 1);
+    uint64_t unit;
+    int kappa;
+    int count;
+
+    count = 0;
+    unit = 1;
+    kappa = prv_countDigits(integral);
+    // rounding up to the next power of ten
+    *uncertainP = (integral + 1 == pow10Int[kappa]);
+    while (kappa > 0)
     {
-        decPart = 1 + decPart;
+        uint32_t digit;
+        uint64_t rest;
+        uint64_t tenKappa;
+
+        // constant divisors are cheaper than a lookup in pow10Int
+        switch (kappa)
+        {
+        case 10: digit = integral / 1000000000; integral %= 1000000000; break;
+        case 9: digit = integral / 100000000; integral %= 100000000; break;
+        case 8: digit = integral / 10000000; integral %= 10000000; break;
+        case 7: digit = integral / 1000000; integral %= 1000000; break;
+        case 6: digit = integral / 100000; integral %= 100000; break;
+        case 5: digit = integral / 10000; integral %= 10000; break;
+        case 4: digit = integral / 1000; integral %= 1000; break;
+        case 3: digit = integral / 100; integral %= 100; break;
+        case 2: digit = integral / 10; integral %= 10; break;
+        default: digit = integral; integral = 0; break;
+        }
+        if (digit != 0 || count != 0) digits[count++] = (uint8_t)('0' + digit);
+        kappa--;
+
+        rest = ((uint64_t)integral << shift) + fractional;
+        tenKappa = pow10Int[kappa] << shift;
+        if (rest <= delta)
+        {
+            *kP += kappa;
+            prv_grisuRound(digits, count, delta, rest, tenKappa, distance);
+            return count;
+        }
+        *uncertainP = (rest <= delta + PRV_GRISU_MARGIN * unit || rest + PRV_GRISU_MARGIN * unit >= tenKappa);
     }
 
-    if (decPart <= 1 + FLT_EPSILON)
+    while (1)
     {
-        decPart = 0;
+        uint8_t digit;
+
+        fractional *= 10;
+        delta *= 10;
+        unit *= 10;
+        digit = (uint8_t)(fractional >> shift);
+        if (digit != 0 || count != 0) digits[count++] = (uint8_t)('0' + digit);
+        fractional &= one - 1;
+        kappa--;
+
+        if (fractional < delta)
+        {
+            *kP += kappa;
+            prv_grisuRound(digits, count, delta, fractional, one, -kappa < 20 ? distance * pow10Int[-kappa] : 0);
+            return count;
+        }
+        *uncertainP = (fractional <= delta + PRV_GRISU_MARGIN * unit || fractional + PRV_GRISU_MARGIN * unit >= one);
     }
+}
+
+// Writes the shortest digits of a positive finite double. The value is
+// digits * 10^(*kP).
+static int prv_grisu2(uint64_t bits,
+                      uint8_t * digits,
+                      int * kP,
+                      bool * uncertainP)
+{
+    _fp_t v;
+    _fp_t w;
+    _fp_t upper;
+    _fp_t lower;
+    _fp_t power;
+    double dk;
+    int k;
+    int index;
 
-    if (intPart == 0 && data < 0)
+    if (0 != (bits & PRV_DP_EXPONENT_MASK))
     {
-        // deal with numbers between -1 and 0
-        if (length < 4) return 0;   // "-0.n"
-        string[0] = '-';
-        string[1] = '0';
-        intLength = 2;
+        v.f = (bits & PRV_DP_SIGNIFICAND_MASK) | PRV_DP_HIDDEN_BIT;
+        v.e = (int)((bits & PRV_DP_EXPONENT_MASK) >> PRV_DP_SIGNIFICAND_SIZE) - PRV_DP_EXPONENT_BIAS;
     }
     else
     {
-        intLength = utils_intToText(intPart, string, length);
-        if (intLength == 0) return 0;
+        v.f = bits & PRV_DP_SIGNIFICAND_MASK;
+        v.e = PRV_DP_DENORMAL_EXPONENT;
     }
-    decLength = 0;
-    if (decPart >= FLT_EPSILON)
+
+    // boundaries of the rounding interval, the lower one being closer for
+    // powers of two
+    upper.f = (v.f << 1) + 1;
+    upper.e = v.e - 1;
+    prv_fpNormalize(&upper);
+    if (v.f == PRV_DP_HIDDEN_BIT)
     {
-        double noiseFloor;
+        lower.f = (v.f << 2) - 1;
+        lower.e = v.e - 2;
+    }
+    else
+    {
+        lower.f = (v.f << 1) - 1;
+        lower.e = v.e - 1;
+    }
+    lower.f <<= lower.e - upper.e;
+    lower.e = upper.e;
+
+    w = v;
+    prv_fpNormalize(&w);
+
+    // cached power bringing the binary exponent in [-60, -32]
+    dk = (-61 - upper.e) * 0.30102999566398114 + 347;
+    k = (int)dk;
+    if (dk - k > 0.0) k++;
+    index = (k >> 3) + 1;
+    *kP = -(PRV_CACHED_POWER_MIN_EXP + index * PRV_CACHED_POWER_STEP);
+    prv_cachedPower(index, &power);
+
+    prv_fpMultiply(&w, &power, &w);
+    prv_fpMultiply(&upper, &power, &upper);
+    prv_fpMultiply(&lower, &power, &lower);
+    upper.f--;
+    lower.f++;
+
+    return prv_grisuDigits(&w, &upper, upper.f - lower.f, digits, kP, uncertainP);
+}
 
-        if (intLength >= length - 1) return 0;
+static bool prv_isSameDouble(uint64_t bits,
+                             uint64_t significand,
+                             int digitCount,
+                             int exponent)
+{
+    _decimal_t decimal;
+    uint64_t result;
+
+    memset(&decimal, 0, sizeof(_decimal_t));
+    decimal.significand = significand;
+    decimal.digitCount = digitCount;
+    decimal.exponent = exponent;
+
+    return prv_decimalToBits(&decimal, NULL, 0, &result) && result == bits;
+}
 
-        noiseFloor = FLT_EPSILON;
-        do
+// Grisu2 misses the shortest digits when they lie at the very edge of the
+// rounding interval. Drops the last digit as long as a rounding of the rest
+// reads back as the same double.
+static int prv_grisuShorten(uint64_t bits,
+                            uint8_t * digits,
+                            int count,
+                            int * kP)
+{
+    while (count > 1)
+    {
+        uint64_t down;
+        uint64_t up;
+        uint64_t candidate;
+        int digitCount;
+        int i;
+
+        down = 0;
+        for (i = 0 ; i < count - 1 ; i++)
         {
-            decPart *= 10;
-            noiseFloor *= 10;
-        } while (decPart - (int64_t)decPart > noiseFloor);
+            down = down * 10 + (digits[i] - '0');
+        }
+        up = down + 1;
+        digitCount = (up == pow10Int[count - 1]) ? count : count - 1;
 
-        decLength = utils_intToText(decPart, string + intLength, length - intLength);
-        if (decLength <= 1) return 0;
+        // nearest candidate first
+        if (digits[count - 1] >= '5' && prv_isSameDouble(bits, up, digitCount, *kP + 1))
+        {
+            candidate = up;
+        }
+        else if (prv_isSameDouble(bits, down, count - 1, *kP + 1))
+        {
+            candidate = down;
+        }
+        else if (digits[count - 1] < '5' && prv_isSameDouble(bits, up, digitCount, *kP + 1))
+        {
+            candidate = up;
+        }
+        else
+        {
+            break;
+        }
+
+        *kP += 1;
+        while (candidate % 10 == 0)
+        {
+            candidate /= 10;
+            *kP += 1;
+        }
+        count = 0;
+        while (candidate >= pow10Int[count])
+        {
+            count++;
+        }
+        for (i = count - 1 ; i >= 0 ; i--)
+        {
+            digits[i] = (uint8_t)('0' + candidate % 10);
+            candidate /= 10;
+        }
+    }
+
+    return count;
+}
+
+// Lays out digits * 10^k like ECMAScript Number.prototype.toString() does.
+static size_t prv_formatDecimal(const uint8_t * digits,
+                                int count,
+                                int k,
+                                uint8_t * string)
+{
+    int point = count + k;
+    int length;
+    int i;
+
+    length = 0;
+    if (k >= 0 && point <= 21)
+    {
+        // 1234e7 -> 12340000000
+        for (i = 0 ; i < count ; i++) string[length++] = digits[i];
+        for (i = 0 ; i < k ; i++) string[length++] = '0';
+        return length;
+    }
+    if (point > 0 && point <= 21)
+    {
+        // 1234e-2 -> 12.34
+        for (i = 0 ; i < point ; i++) string[length++] = digits[i];
+        string[length++] = '.';
+        for (i = point ; i < count ; i++) string[length++] = digits[i];
+        return length;
+    }
+    if (point > -6 && point <= 0)
+    {
+        // 1234e-6 -> 0.001234
+        string[length++] = '0';
+        string[length++] = '.';
+        for (i = point ; i < 0 ; i++) string[length++] = '0';
+        for (i = 0 ; i < count ; i++) string[length++] = digits[i];
+        return length;
+    }
 
-        // replace the leading 1 with a dot
-        string[intLength] = '.';
+    // 1234e30 -> 1.234e+33
+    string[length++] = digits[0];
+    if (count > 1)
+    {
+        string[length++] = '.';
+        for (i = 1 ; i < count ; i++) string[length++] = digits[i];
     }
+    string[length++] = 'e';
+    point--;
+    if (point < 0)
+    {
+        string[length++] = '-';
+        point = -point;
+    }
+    else
+    {
+        string[length++] = '+';
+    }
+    if (point >= 100) string[length++] = (uint8_t)('0' + point / 100);
+    if (point >= 10) string[length++] = (uint8_t)('0' + (point / 10) % 10);
+    string[length++] = (uint8_t)('0' + point % 10);
 
-    return intLength + decLength;
+    return length;
+}
+
+size_t utils_floatToText(double data,
+                         uint8_t * string,
+                         size_t length)
+{
+    uint8_t digits[PRV_DECIMAL_MAX_DIGITS + 1];
+    uint8_t text[FLOAT_MAX_STRING_LEN];
+    uint8_t * outputP;
+    uint64_t bits;
+    size_t res;
+
+    bits = prv_doubleToBits(data);
+    // infinity and NaN have no textual representation
+    if ((bits & PRV_DP_EXPONENT_MASK) == PRV_DP_EXPONENT_MASK) return 0;
+
+    outputP = (length >= FLOAT_MAX_STRING_LEN) ? string : text;
+    res = 0;
+    if (0 != (bits & PRV_DP_SIGN_MASK))
+    {
+        outputP[res++] = '-';
+        bits &= ~PRV_DP_SIGN_MASK;
+    }
+    if (bits == 0)
+    {
+        outputP[res++] = '0';
+    }
+    else
+    {
+        bool uncertain;
+        int count;
+        int k;
+
+        k = 0;
+        count = prv_grisu2(bits, digits, &k, &uncertain);
+        if (uncertain) count = prv_grisuShorten(bits, digits, count, &k);
+        res += prv_formatDecimal(digits, count, k, outputP + res);
+    }
+
+    if (outputP == text)
+    {
+        if (res > length) return 0;
+        memcpy(string, text, res);
+    }
+
+    return res;
 }
 
 lwm2m_binding_t utils_stringToBinding(uint8_t * buffer,
@@ -348,6 +1234,12 @@ lwm2m_media_type_t utils_convertMediaType(coap_content_type_t type)
         return LWM2M_CONTENT_JSON_OLD;
     case LWM2M_CONTENT_JSON:
         return LWM2M_CONTENT_JSON;
+#ifdef LWM2M_SUPPORT_CBOR
+    case LWM2M_CONTENT_CBOR:
+        return LWM2M_CONTENT_CBOR;
+    case LWM2M_CONTENT_SENML_CBOR:
+        return LWM2M_CONTENT_SENML_CBOR;
+#endif
     case APPLICATION_LINK_FORMAT:
         return LWM2M_CONTENT_LINK;
 
@@ -552,3 +1444,92 @@ lwm2m_data_type_t utils_depthToDatatype(uri_depth_t depth)
 
     return LWM2M_TYPE_UNDEFINED;
 }
+
+// 32-bit FNV-1a hash. Its values are stored by the server store, the object journal and the compiled
+// bootstrap server databases: do not change it.
+uint32_t utils_hash(const uint8_t * buffer,
+                    size_t length)
+{
+    uint32_t hash;
+    size_t i;
+
+    hash = 0x811C9DC5;
+    for (i = 0 ; i < length ; i++)
+    {
+        hash ^= buffer[i];
+        hash *= 0x01000193;
+    }
+
+    return hash;
+}
+
+#define PRV_BUFFER_MIN_CAPACITY 64
+
+// Use data to write into a caller provided memory area, or NULL to allocate it as needed.
+void utils_bufferInit(utils_buffer_t * bufferP,
+                      uint8_t * data,
+                      size_t capacity)
+{
+    bufferP->data = data;
+    bufferP->length = 0;
+    if (data != NULL)
+    {
+        bufferP->capacity = capacity;
+        bufferP->isStatic = true;
+    }
+    else
+    {
+        bufferP->capacity = 0;
+        bufferP->isStatic = false;
+    }
+}
+
+// Make room for length more bytes. Returns 0 on success, -1 otherwise.
+int utils_bufferReserve(utils_buffer_t * bufferP,
+                        size_t length)
+{
+    uint8_t * newData;
+    size_t newCapacity;
+
+    if (bufferP->capacity - bufferP->length >= length) return 0;
+    if (bufferP->isStatic) return -1;
+
+    newCapacity = bufferP->capacity * 2;
+    if (newCapacity < PRV_BUFFER_MIN_CAPACITY) newCapacity = PRV_BUFFER_MIN_CAPACITY;
+    if (newCapacity - bufferP->length < length) newCapacity = bufferP->length + length;
+
+    newData = (uint8_t *)lwm2m_malloc(newCapacity);
+    if (newData == NULL) return -1;
+    if (bufferP->data != NULL)
+    {
+        memcpy(newData, bufferP->data, bufferP->length);
+        lwm2m_free(bufferP->data);
+    }
+    bufferP->data = newData;
+    bufferP->capacity = newCapacity;
+
+    return 0;
+}
+
+int utils_bufferAppend(utils_buffer_t * bufferP,
+                       const void * data,
+                       size_t length)
+{
+    if (utils_bufferReserve(bufferP, length) != 0) return -1;
+
+    memcpy(bufferP->data + bufferP->length, data, length);
+    bufferP->length += length;
+
+    return 0;
+}
+
+void utils_bufferFree(utils_buffer_t * bufferP)
+{
+    if (bufferP->isStatic == false && bufferP->data != NULL)
+    {
+        lwm2m_free(bufferP->data);
+    }
+    bufferP->data = NULL;
+    bufferP->length = 0;
+    bufferP->capacity = 0;
+}
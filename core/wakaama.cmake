@@ -22,12 +22,22 @@ set(WAKAAMA_SOURCES
     ${WAKAAMA_SOURCES_DIR}/list.c
     ${WAKAAMA_SOURCES_DIR}/packet.c
     ${WAKAAMA_SOURCES_DIR}/transaction.c
+    ${WAKAAMA_SOURCES_DIR}/queue.c
     ${WAKAAMA_SOURCES_DIR}/registration.c
     ${WAKAAMA_SOURCES_DIR}/bootstrap.c
     ${WAKAAMA_SOURCES_DIR}/management.c
     ${WAKAAMA_SOURCES_DIR}/observe.c
+    ${WAKAAMA_SOURCES_DIR}/send.c
     ${WAKAAMA_SOURCES_DIR}/json.c
+    ${WAKAAMA_SOURCES_DIR}/cbor.c
+    ${WAKAAMA_SOURCES_DIR}/senml.c
     ${WAKAAMA_SOURCES_DIR}/discover.c
+    ${WAKAAMA_SOURCES_DIR}/link.c
+    ${WAKAAMA_SOURCES_DIR}/attributes.c
+    ${WAKAAMA_SOURCES_DIR}/acl.c
+    ${WAKAAMA_SOURCES_DIR}/journal.c
+    ${WAKAAMA_SOURCES_DIR}/clientstore.c
+    ${WAKAAMA_SOURCES_DIR}/store.c
     ${WAKAAMA_SOURCES_DIR}/block1.c
     ${WAKAAMA_SOURCES_DIR}/internals.h
 	${CORE_HEADERS}
@@ -0,0 +1,657 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "internals.h"
+#include "bootstrap_db.h"
+
+#define PRV_MAGIC           "LWBS"
+#define PRV_HEADER_SIZE     32
+#define PRV_SERVER_SIZE     20
+#define PRV_BUCKET_SIZE     8
+#define PRV_ENDPOINT_SIZE   8
+#define PRV_COMMAND_SIZE    8
+
+typedef struct
+{
+    uint8_t *   data;
+    size_t      length;
+    size_t      size;
+} _image_t;
+
+// command lists already in the image
+typedef struct
+{
+    uint32_t    hash;
+    uint32_t    offset;
+    uint16_t    count;
+} _command_list_t;
+
+static uint16_t prv_get16(const uint8_t * buffer)
+{
+    return (uint16_t)((buffer[0] << 8) | buffer[1]);
+}
+
+static uint32_t prv_get32(const uint8_t * buffer)
+{
+    return ((uint32_t)buffer[0] << 24)
+         | ((uint32_t)buffer[1] << 16)
+         | ((uint32_t)buffer[2] << 8)
+         | (uint32_t)buffer[3];
+}
+
+static void prv_set16(uint8_t * buffer,
+                      uint16_t value)
+{
+    buffer[0] = (uint8_t)(value >> 8);
+    buffer[1] = (uint8_t)value;
+}
+
+static void prv_set32(uint8_t * buffer,
+                      uint32_t value)
+{
+    buffer[0] = (uint8_t)(value >> 24);
+    buffer[1] = (uint8_t)(value >> 16);
+    buffer[2] = (uint8_t)(value >> 8);
+    buffer[3] = (uint8_t)value;
+}
+
+// Returns the offset of length zeroed bytes added at the end of the image, or 0 on error.
+static uint32_t prv_image_reserve(_image_t * imageP,
+                                  size_t length)
+{
+    size_t offset;
+
+    offset = imageP->length;
+    if (length > UINT32_MAX - offset) return 0;
+
+    if (offset + length > imageP->size)
+    {
+        uint8_t * dataP;
+        size_t size;
+
+        size = imageP->size == 0 ? 1024 : imageP->size;
+        while (size < offset + length) size *= 2;
+
+        dataP = (uint8_t *)lwm2m_malloc(size);
+        if (dataP == NULL) return 0;
+        if (imageP->data != NULL)
+        {
+            memcpy(dataP, imageP->data, offset);
+            lwm2m_free(imageP->data);
+        }
+        imageP->data = dataP;
+        imageP->size = size;
+    }
+
+    memset(imageP->data + offset, 0, length);
+    imageP->length += length;
+
+    return (uint32_t)offset;
+}
+
+static uint32_t prv_image_append(_image_t * imageP,
+                                 const uint8_t * buffer,
+                                 size_t length)
+{
+    uint32_t offset;
+
+    offset = prv_image_reserve(imageP, length);
+    if (offset != 0) memcpy(imageP->data + offset, buffer, length);
+
+    return offset;
+}
+
+// Adds the commands of endptP, sharing the list of a previous endpoint when identical.
+static int prv_add_commands(_image_t * imageP,
+                            _command_list_t * listTable,
+                            uint32_t mask,
+                            bs_endpoint_info_t * endptP,
+                            uint32_t * offsetP,
+                            uint16_t * countP)
+{
+    bs_command_t * cmdP;
+    uint8_t * commandP;
+    uint32_t offset;
+    uint32_t hash;
+    uint32_t index;
+    size_t count;
+    size_t length;
+
+    count = 0;
+    for (cmdP = endptP->commandList; cmdP != NULL; cmdP = cmdP->next) count++;
+    if (count > 0xFFFF) return -1;
+
+    *offsetP = 0;
+    *countP = (uint16_t)count;
+    if (count == 0) return 0;
+
+    length = count * PRV_COMMAND_SIZE;
+    offset = prv_image_reserve(imageP, length);
+    if (offset == 0) return -1;
+
+    commandP = imageP->data + offset;
+    for (cmdP = endptP->commandList; cmdP != NULL; cmdP = cmdP->next)
+    {
+        commandP[0] = (uint8_t)cmdP->operation;
+        switch (cmdP->operation)
+        {
+        case BS_DELETE:
+            if (cmdP->uri != NULL)
+            {
+                commandP[1] = cmdP->uri->flag;
+                prv_set16(commandP + 2, cmdP->uri->objectId);
+                prv_set16(commandP + 4, cmdP->uri->instanceId);
+                prv_set16(commandP + 6, cmdP->uri->resourceId);
+            }
+            break;
+
+        case BS_WRITE_SECURITY:
+        case BS_WRITE_SERVER:
+            prv_set16(commandP + 2, cmdP->serverId);
+            break;
+
+        default:
+            break;
+        }
+        commandP += PRV_COMMAND_SIZE;
+    }
+
+    hash = utils_hash(imageP->data + offset, length);
+    index = hash & mask;
+    while (listTable[index].offset != 0)
+    {
+        if (listTable[index].hash == hash
+         && listTable[index].count == count
+         && memcmp(imageP->data + listTable[index].offset, imageP->data + offset, length) == 0)
+        {
+            // drop the copy
+            imageP->length = offset;
+            *offsetP = listTable[index].offset;
+            return 0;
+        }
+        index = (index + 1) & mask;
+    }
+
+    listTable[index].hash = hash;
+    listTable[index].offset = offset;
+    listTable[index].count = (uint16_t)count;
+    *offsetP = offset;
+
+    return 0;
+}
+
+// Adds the record of endptP and indexes it. Returns -1 on error or if the name is already indexed.
+static int prv_add_endpoint(_image_t * imageP,
+                            bs_endpoint_info_t * endptP,
+                            uint32_t commandOffset,
+                            uint16_t commandCount,
+                            uint32_t bucketOffset,
+                            uint32_t mask)
+{
+    uint8_t * recordP;
+    uint32_t offset;
+    uint32_t hash;
+    uint32_t index;
+    size_t nameLen;
+
+    nameLen = endptP->name == NULL ? 0 : strlen(endptP->name);
+    if (nameLen > 0xFFFF) return -1;
+
+    offset = prv_image_reserve(imageP, PRV_ENDPOINT_SIZE + nameLen);
+    if (offset == 0) return -1;
+    recordP = imageP->data + offset;
+    prv_set32(recordP, commandOffset);
+    prv_set16(recordP + 4, commandCount);
+    prv_set16(recordP + 6, (uint16_t)nameLen);
+
+    if (endptP->name == NULL)
+    {
+        uint8_t * headerP = imageP->data;
+
+        if (prv_get32(headerP + 24) != 0) return -1;
+        prv_set32(headerP + 24, offset);
+        return 0;
+    }
+    memcpy(recordP + PRV_ENDPOINT_SIZE, endptP->name, nameLen);
+
+    hash = utils_hash(recordP + PRV_ENDPOINT_SIZE, nameLen);
+    index = hash & mask;
+    while (1)
+    {
+        uint8_t * bucketP = imageP->data + bucketOffset + index * PRV_BUCKET_SIZE;
+        uint32_t otherOffset;
+
+        otherOffset = prv_get32(bucketP + 4);
+        if (otherOffset == 0)
+        {
+            prv_set32(bucketP, hash);
+            prv_set32(bucketP + 4, offset);
+            return 0;
+        }
+        if (prv_get32(bucketP) == hash
+         && prv_get16(imageP->data + otherOffset + 6) == nameLen
+         && memcmp(imageP->data + otherOffset + PRV_ENDPOINT_SIZE, recordP + PRV_ENDPOINT_SIZE, nameLen) == 0)
+        {
+            return -1;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+uint8_t * bs_db_compile(bs_info_t * infoP,
+                        size_t * lengthP)
+{
+    _image_t image;
+    _command_list_t * listTable;
+    bs_server_tlv_t * serverP;
+    bs_endpoint_info_t * endptP;
+    size_t serverCount;
+    size_t endpointCount;
+    size_t bucketCount;
+    uint32_t serverOffset;
+    uint32_t bucketOffset;
+    size_t i;
+
+    memset(&image, 0, sizeof(_image_t));
+    listTable = NULL;
+
+    serverCount = 0;
+    for (serverP = infoP->serverList; serverP != NULL; serverP = serverP->next) serverCount++;
+    endpointCount = 0;
+    for (endptP = infoP->endpointList; endptP != NULL; endptP = endptP->next) endpointCount++;
+    if (serverCount > 0xFFFF || endpointCount == 0 || endpointCount > 0x7FFFFFFF) return NULL;
+
+    // keep the load factor under one half
+    bucketCount = 1;
+    while (bucketCount < 2 * endpointCount) bucketCount *= 2;
+
+    serverOffset = PRV_HEADER_SIZE;
+    bucketOffset = serverOffset + serverCount * PRV_SERVER_SIZE;
+    prv_image_reserve(&image, PRV_HEADER_SIZE + serverCount * PRV_SERVER_SIZE + bucketCount * PRV_BUCKET_SIZE);
+    if (image.data == NULL) goto error;
+
+    // the server list is sorted by ID
+    i = 0;
+    for (serverP = infoP->serverList; serverP != NULL; serverP = serverP->next)
+    {
+        uint32_t securityOffset;
+        uint32_t dataOffset;
+        uint8_t * entryP;
+
+        if (serverP->next != NULL && serverP->next->id <= serverP->id) goto error;
+        if (serverP->securityData == NULL) goto error;
+
+        securityOffset = prv_image_append(&image, serverP->securityData, serverP->securityLen);
+        if (securityOffset == 0) goto error;
+        dataOffset = 0;
+        if (serverP->serverData != NULL)
+        {
+            dataOffset = prv_image_append(&image, serverP->serverData, serverP->serverLen);
+            if (dataOffset == 0) goto error;
+        }
+
+        entryP = image.data + serverOffset + i * PRV_SERVER_SIZE;
+        prv_set16(entryP, serverP->id);
+        prv_set32(entryP + 4, securityOffset);
+        prv_set32(entryP + 8, (uint32_t)serverP->securityLen);
+        prv_set32(entryP + 12, dataOffset);
+        prv_set32(entryP + 16, (uint32_t)(dataOffset == 0 ? 0 : serverP->serverLen));
+        i++;
+    }
+
+    listTable = (_command_list_t *)lwm2m_malloc(bucketCount * sizeof(_command_list_t));
+    if (listTable == NULL) goto error;
+    memset(listTable, 0, bucketCount * sizeof(_command_list_t));
+
+    for (endptP = infoP->endpointList; endptP != NULL; endptP = endptP->next)
+    {
+        uint32_t commandOffset;
+        uint16_t commandCount;
+
+        if (prv_add_commands(&image, listTable, bucketCount - 1, endptP, &commandOffset, &commandCount) != 0) goto error;
+        if (prv_add_endpoint(&image, endptP, commandOffset, commandCount, bucketOffset, bucketCount - 1) != 0) goto error;
+    }
+    lwm2m_free(listTable);
+
+    memcpy(image.data, PRV_MAGIC, 4);
+    prv_set16(image.data + 4, BS_DB_VERSION);
+    prv_set16(image.data + 6, (uint16_t)serverCount);
+    prv_set32(image.data + 8, (uint32_t)endpointCount);
+    prv_set32(image.data + 12, (uint32_t)bucketCount);
+    prv_set32(image.data + 16, serverOffset);
+    prv_set32(image.data + 20, bucketOffset);
+    prv_set32(image.data + 28, (uint32_t)image.length);
+
+    *lengthP = image.length;
+    return image.data;
+
+error:
+    if (listTable != NULL) lwm2m_free(listTable);
+    if (image.data != NULL) lwm2m_free(image.data);
+    return NULL;
+}
+
+static bool prv_in_image(bs_db_t * dbP,
+                         size_t offset,
+                         size_t length)
+{
+    return offset <= dbP->length && length <= dbP->length - offset;
+}
+
+static bool prv_read_endpoint(bs_db_t * dbP,
+                              uint32_t offset,
+                              const uint8_t ** nameP,
+                              uint16_t * nameLenP,
+                              bs_db_endpoint_t * endpointP)
+{
+    const uint8_t * recordP;
+    uint16_t nameLen;
+
+    if (offset < PRV_HEADER_SIZE || !prv_in_image(dbP, offset, PRV_ENDPOINT_SIZE)) return false;
+    recordP = dbP->data + offset;
+    nameLen = prv_get16(recordP + 6);
+    if (!prv_in_image(dbP, offset + PRV_ENDPOINT_SIZE, nameLen)) return false;
+
+    endpointP->commandOffset = prv_get32(recordP);
+    endpointP->commandCount = prv_get16(recordP + 4);
+    if (!prv_in_image(dbP, endpointP->commandOffset, (size_t)endpointP->commandCount * PRV_COMMAND_SIZE)) return false;
+
+    if (nameP != NULL) *nameP = recordP + PRV_ENDPOINT_SIZE;
+    if (nameLenP != NULL) *nameLenP = nameLen;
+
+    return true;
+}
+
+static bs_db_t * prv_db_new(const uint8_t * data,
+                            size_t length,
+                            bool isMapped)
+{
+    bs_db_t * dbP;
+    uint32_t bucketCount;
+
+    if (length < PRV_HEADER_SIZE
+     || memcmp(data, PRV_MAGIC, 4) != 0
+     || prv_get16(data + 4) != BS_DB_VERSION
+     || prv_get32(data + 28) != length)
+    {
+        return NULL;
+    }
+
+    dbP = (bs_db_t *)lwm2m_malloc(sizeof(bs_db_t));
+    if (dbP == NULL) return NULL;
+
+    dbP->data = data;
+    dbP->length = length;
+    dbP->isMapped = isMapped;
+    dbP->serverCount = prv_get16(data + 6);
+    dbP->endpointCount = prv_get32(data + 8);
+    bucketCount = prv_get32(data + 12);
+    dbP->bucketMask = bucketCount - 1;
+    dbP->serverOffset = prv_get32(data + 16);
+    dbP->bucketOffset = prv_get32(data + 20);
+    dbP->defaultOffset = prv_get32(data + 24);
+
+    if (bucketCount == 0
+     || (bucketCount & dbP->bucketMask) != 0
+     || !prv_in_image(dbP, dbP->serverOffset, (size_t)dbP->serverCount * PRV_SERVER_SIZE)
+     || !prv_in_image(dbP, dbP->bucketOffset, (size_t)bucketCount * PRV_BUCKET_SIZE))
+    {
+        lwm2m_free(dbP);
+        return NULL;
+    }
+
+    return dbP;
+}
+
+static bs_db_t * prv_db_map(const char * filename)
+{
+    bs_db_t * dbP;
+    struct stat fileStat;
+    void * mapP;
+    int fd;
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+    if (fstat(fd, &fileStat) != 0
+     || fileStat.st_size < PRV_HEADER_SIZE)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    mapP = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapP == MAP_FAILED) return NULL;
+
+    dbP = prv_db_new((const uint8_t *)mapP, fileStat.st_size, true);
+    if (dbP == NULL) munmap(mapP, fileStat.st_size);
+
+    return dbP;
+}
+
+bs_db_t * bs_db_open(const char * filename)
+{
+    FILE * fd;
+    char magic[4];
+    bs_info_t * infoP;
+    uint8_t * data;
+    size_t length;
+    bs_db_t * dbP;
+
+    fd = fopen(filename, "r");
+    if (fd == NULL) return NULL;
+
+    if (fread(magic, 1, sizeof(magic), fd) == sizeof(magic)
+     && memcmp(magic, PRV_MAGIC, sizeof(magic)) == 0)
+    {
+        fclose(fd);
+        return prv_db_map(filename);
+    }
+
+    rewind(fd);
+    infoP = bs_get_info(fd);
+    fclose(fd);
+    if (infoP == NULL) return NULL;
+
+    data = bs_db_compile(infoP, &length);
+    bs_free_info(infoP);
+    if (data == NULL) return NULL;
+
+    dbP = prv_db_new(data, length, false);
+    if (dbP == NULL) lwm2m_free(data);
+
+    return dbP;
+}
+
+void bs_db_close(bs_db_t * dbP)
+{
+    if (dbP == NULL) return;
+
+    if (dbP->isMapped)
+    {
+        munmap((void *)dbP->data, dbP->length);
+    }
+    else
+    {
+        lwm2m_free((void *)dbP->data);
+    }
+    lwm2m_free(dbP);
+}
+
+// The image is written to a temporary file renamed over filename
+int bs_db_save(bs_db_t * dbP,
+               const char * filename)
+{
+    char path[256];
+    int fd;
+
+    if (snprintf(path, sizeof(path), "%s.tmp", filename) >= (int)sizeof(path)) return -1;
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return -1;
+    if (write(fd, dbP->data, dbP->length) != (ssize_t)dbP->length
+     || fsync(fd) != 0)
+    {
+        close(fd);
+        unlink(path);
+        return -1;
+    }
+    close(fd);
+    if (rename(path, filename) != 0)
+    {
+        unlink(path);
+        return -1;
+    }
+
+    return 0;
+}
+
+bool bs_db_find_endpoint(bs_db_t * dbP,
+                         const char * name,
+                         bs_db_endpoint_t * endpointP)
+{
+    if (name != NULL)
+    {
+        size_t nameLen;
+        uint32_t hash;
+        uint32_t index;
+        uint32_t i;
+
+        nameLen = strlen(name);
+        hash = utils_hash((const uint8_t *)name, nameLen);
+        index = hash & dbP->bucketMask;
+        i = 0;
+        do
+        {
+            const uint8_t * bucketP = dbP->data + dbP->bucketOffset + (size_t)index * PRV_BUCKET_SIZE;
+            const uint8_t * recordNameP;
+            uint16_t recordNameLen;
+            uint32_t offset;
+
+            offset = prv_get32(bucketP + 4);
+            if (offset == 0) break;
+            if (prv_get32(bucketP) == hash
+             && prv_read_endpoint(dbP, offset, &recordNameP, &recordNameLen, endpointP)
+             && recordNameLen == nameLen
+             && memcmp(recordNameP, name, nameLen) == 0)
+            {
+                return true;
+            }
+            index = (index + 1) & dbP->bucketMask;
+            i++;
+        } while (i <= dbP->bucketMask);
+    }
+
+    if (dbP->defaultOffset == 0) return false;
+
+    return prv_read_endpoint(dbP, dbP->defaultOffset, NULL, NULL, endpointP);
+}
+
+bool bs_db_get_command(bs_db_t * dbP,
+                       bs_db_endpoint_t * endpointP,
+                       uint16_t index,
+                       bs_db_command_t * commandP)
+{
+    const uint8_t * bufferP;
+
+    if (index >= endpointP->commandCount) return false;
+    bufferP = dbP->data + endpointP->commandOffset + (size_t)index * PRV_COMMAND_SIZE;
+
+    memset(commandP, 0, sizeof(bs_db_command_t));
+    switch (bufferP[0])
+    {
+    case BS_DELETE:
+        commandP->uri.flag = bufferP[1] & (LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID | LWM2M_URI_FLAG_RESOURCE_ID);
+        commandP->uri.objectId = prv_get16(bufferP + 2);
+        commandP->uri.instanceId = prv_get16(bufferP + 4);
+        commandP->uri.resourceId = prv_get16(bufferP + 6);
+        break;
+
+    case BS_WRITE_SECURITY:
+    case BS_WRITE_SERVER:
+        commandP->serverId = prv_get16(bufferP + 2);
+        break;
+
+    case BS_FINISH:
+        break;
+
+    default:
+        return false;
+    }
+    commandP->operation = (bs_operation_t)bufferP[0];
+
+    return true;
+}
+
+bool bs_db_get_server(bs_db_t * dbP,
+                      uint16_t id,
+                      bool security,
+                      const uint8_t ** dataP,
+                      size_t * lengthP)
+{
+    size_t low;
+    size_t high;
+
+    low = 0;
+    high = dbP->serverCount;
+    while (low < high)
+    {
+        size_t middle = (low + high) / 2;
+        const uint8_t * entryP = dbP->data + dbP->serverOffset + middle * PRV_SERVER_SIZE;
+        uint16_t entryId;
+
+        entryId = prv_get16(entryP);
+        if (entryId < id)
+        {
+            low = middle + 1;
+        }
+        else if (entryId > id)
+        {
+            high = middle;
+        }
+        else
+        {
+            uint32_t offset;
+            uint32_t length;
+
+            if (security)
+            {
+                offset = prv_get32(entryP + 4);
+                length = prv_get32(entryP + 8);
+            }
+            else
+            {
+                offset = prv_get32(entryP + 12);
+                length = prv_get32(entryP + 16);
+            }
+            if (offset == 0 || !prv_in_image(dbP, offset, length)) return false;
+
+            *dataP = dbP->data + offset;
+            *lengthP = length;
+            return true;
+        }
+    }
+
+    return false;
+}
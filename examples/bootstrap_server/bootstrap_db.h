@@ -0,0 +1,84 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "bootstrap_info.h"
+
+/*
+ * Compiled Bootstrap Information.
+ *
+ * The .INI file is compiled into a read-only image which is mapped in memory
+ * as is. Server accounts are stored once and shared by all endpoints, as are
+ * identical command lists. Endpoints are found through a hash index on their
+ * name. All integers are big-endian.
+ *
+ * Header (32 bytes):
+ *   magic "LWBS" | version (2) | server count (2) | endpoint count (4)
+ *   | bucket count (4) | server table offset (4) | bucket table offset (4)
+ *   | default endpoint offset (4) | image length (4)
+ * Server table, sorted by ID, 20 bytes per server:
+ *   id (2) | unused (2) | security offset (4) | security length (4)
+ *   | server offset (4) | server length (4)
+ * Bucket table, a power of two of 8 bytes buckets, linear probing:
+ *   name hash (4) | endpoint offset (4), 0 for an empty bucket
+ * Endpoint record:
+ *   command list offset (4) | command count (2) | name length (2) | name
+ * Command, 8 bytes:
+ *   operation (1) | URI flag (1) | object ID or server ID (2)
+ *   | instance ID (2) | resource ID (2)
+ */
+
+#define BS_DB_VERSION 1
+
+typedef struct
+{
+    const uint8_t * data;
+    size_t          length;
+    bool            isMapped;
+    uint16_t        serverCount;
+    uint32_t        endpointCount;
+    uint32_t        bucketMask;
+    uint32_t        serverOffset;
+    uint32_t        bucketOffset;
+    uint32_t        defaultOffset;
+} bs_db_t;
+
+typedef struct
+{
+    uint32_t    commandOffset;
+    uint16_t    commandCount;
+} bs_db_endpoint_t;
+
+typedef struct
+{
+    bs_operation_t  operation;
+    lwm2m_uri_t     uri;        // BS_DELETE only. flag is 0 for "/"
+    uint16_t        serverId;   // BS_WRITE_SECURITY and BS_WRITE_SERVER only
+} bs_db_command_t;
+
+// Reads either a compiled image, which is mapped, or a .INI file, which is compiled in memory.
+bs_db_t * bs_db_open(const char * filename);
+void bs_db_close(bs_db_t * dbP);
+// Writes the image to filename. Returns 0 on success.
+int bs_db_save(bs_db_t * dbP, const char * filename);
+// Returns the image of infoP to free with lwm2m_free(), or NULL if infoP is not valid.
+uint8_t * bs_db_compile(bs_info_t * infoP, size_t * lengthP);
+
+// Falls back to the default endpoint if name is unknown. Returns false if none applies.
+bool bs_db_find_endpoint(bs_db_t * dbP, const char * name, bs_db_endpoint_t * endpointP);
+bool bs_db_get_command(bs_db_t * dbP, bs_db_endpoint_t * endpointP, uint16_t index, bs_db_command_t * commandP);
+// Returns false if the server is unknown or has no such instance (Server Object of a Bootstrap Server).
+bool bs_db_get_server(bs_db_t * dbP, uint16_t id, bool security, const uint8_t ** dataP, size_t * lengthP);
@@ -70,6 +70,7 @@ static int prv_find_next_section(FILE * fd,
         line = NULL;
         length = 0;
     }
+    if (line != NULL) lwm2m_free(line);
 
     return found;
 }
@@ -113,7 +114,12 @@ static int prv_read_key_value(FILE * fd,
         if (fgetpos(fd, &prevPos) != 0) return -1;
     }
 
-    if (res == -1) return -1;
+    if (res == -1)
+    {
+        // getline() allocates the buffer even at the end of the file
+        if (line != NULL) lwm2m_free(line);
+        return -1;
+    }
 
     // end of section
     if (line[start] == '[')
@@ -227,6 +233,15 @@ error:
     return 0;
 }
 
+static void prv_free_read_server(read_server_t * readSrvP)
+{
+    if (readSrvP->uri != NULL) lwm2m_free(readSrvP->uri);
+    if (readSrvP->publicKey != NULL) lwm2m_free(readSrvP->publicKey);
+    if (readSrvP->secretKey != NULL) lwm2m_free(readSrvP->secretKey);
+    if (readSrvP->serverKey != NULL) lwm2m_free(readSrvP->serverKey);
+    lwm2m_free(readSrvP);
+}
+
 static read_server_t * prv_read_next_server(FILE * fd)
 {
     char * key;
@@ -339,14 +354,7 @@ static read_server_t * prv_read_next_server(FILE * fd)
     return readSrvP;
 
 error:
-    if (readSrvP != NULL)
-    {
-        if (readSrvP->uri != NULL) lwm2m_free(readSrvP->uri);
-        if (readSrvP->publicKey != NULL) lwm2m_free(readSrvP->publicKey);
-        if (readSrvP->secretKey != NULL) lwm2m_free(readSrvP->secretKey);
-        if (readSrvP->serverKey != NULL) lwm2m_free(readSrvP->serverKey);
-        lwm2m_free(readSrvP);
-    }
+    if (readSrvP != NULL) prv_free_read_server(readSrvP);
     if (key != NULL) lwm2m_free(key);
     if (value != NULL) lwm2m_free(value);
 
@@ -629,7 +637,12 @@ bs_info_t *  bs_get_info(FILE * fd)
         readSrvP = prv_read_next_server(fd);
         if (readSrvP != NULL)
         {
-            if (prv_add_server(infoP, readSrvP) != 0) goto error;
+            int result;
+
+            // the server is encoded in TLV by prv_add_server()
+            result = prv_add_server(infoP, readSrvP);
+            prv_free_read_server(readSrvP);
+            if (result != 0) goto error;
         }
     } while (readSrvP != NULL);
 
@@ -650,28 +663,10 @@ bs_info_t *  bs_get_info(FILE * fd)
     cltInfoP = infoP->endpointList;
     while (cltInfoP != NULL)
     {
-        bs_endpoint_info_t * otherP;
         bs_command_t * cmdP;
         bs_command_t * parentP;
 
-        // check names are unique
-        otherP = cltInfoP->next;
-        while (otherP != NULL)
-        {
-            if (cltInfoP->name == NULL)
-            {
-                if (otherP->name == NULL) goto error;
-            }
-            else
-            {
-                if (otherP->name != NULL
-                 && strcmp(cltInfoP->name, otherP->name) == 0)
-                {
-                    goto error;
-                }
-            }
-            otherP = otherP->next;
-        }
+        // names are checked to be unique by bs_db_compile()
 
         // check servers exist
         cmdP = cltInfoP->commandList;
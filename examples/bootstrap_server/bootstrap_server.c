@@ -37,19 +37,25 @@
 
 #include "commandline.h"
 #include "connection.h"
-#include "bootstrap_info.h"
+#include "bootstrap_db.h"
 
 #define CMD_STATUS_NEW  0
 #define CMD_STATUS_SENT 1
-#define CMD_STATUS_OK   2
-#define CMD_STATUS_FAIL 3
+#define CMD_STATUS_FAIL 2
+
+#define ENDPOINT_TABLE_MIN_SIZE 64
 
 typedef struct _endpoint_
 {
     struct _endpoint_ * next;
+    struct _endpoint_ * nextInTable;    // endpoints with the same session hash
     char *          name;
     void *          handle;
-    bs_command_t *  cmdList;
+    bs_db_endpoint_t info;
+    uint16_t        cmdIndex;           // next command to send
+    uint16_t        pending;            // commands sent and not answered yet
+    uint16_t        answerIndex;        // command of the next answer
+    uint16_t        stale;              // answers still due to a previous Bootstrap Request
     uint8_t         status;
 } endpoint_t;
 
@@ -58,8 +64,11 @@ typedef struct
     int               sock;
     connection_t *    connList;
     lwm2m_context_t * lwm2mH;
-    bs_info_t *       bsInfo;
+    bs_db_t *         bsDb;
     endpoint_t *      endpointList;
+    endpoint_t **     endpointTable;    // endpoints indexed by session
+    size_t            tableSize;
+    size_t            endpointCount;
     int               addressFamily;
 } internal_data_t;
 
@@ -88,7 +97,8 @@ void print_usage(char * filename,
     fprintf(stdout, "Usage: bootstap_server [OPTION]\r\n");
     fprintf(stderr, "Launch a LWM2M Bootstrap Server.\r\n\n");
     fprintf(stdout, "Options:\r\n");
-    fprintf(stdout, "  -f FILE\tSpecify BootStrap Information file. Default: ./%s\r\n", filename);
+    fprintf(stdout, "  -f FILE\tSpecify BootStrap Information file or compiled database. Default: ./%s\r\n", filename);
+    fprintf(stdout, "  -c FILE\tCompile the BootStrap Information file in the database FILE and exit.\r\n");
     fprintf(stdout, "  -l PORT\tSet the local UDP port of the Client. Default: %s\r\n", port);
     fprintf(stdout, "  -4\t\tUse IPv4 connection. Default: IPv6 connection\r\n");
     fprintf(stdout, "\r\n");
@@ -118,22 +128,84 @@ static void prv_endpoint_free(endpoint_t * endP)
     }
 }
 
+static size_t prv_session_hash(internal_data_t * dataP,
+                               void * sessionH)
+{
+    uintptr_t key = (uintptr_t)sessionH;
+
+    // sessions are heap pointers: ignore the alignment bits
+    return (size_t)((key >> 4) ^ (key >> 12)) & (dataP->tableSize - 1);
+}
+
 static endpoint_t * prv_endpoint_find(internal_data_t * dataP,
                                       void * sessionH)
 {
     endpoint_t * endP;
 
-    endP = dataP->endpointList;
+    if (dataP->endpointTable == NULL) return NULL;
 
+    endP = dataP->endpointTable[prv_session_hash(dataP, sessionH)];
     while (endP != NULL
         && endP->handle != sessionH)
     {
-        endP = endP->next;
+        endP = endP->nextInTable;
     }
 
     return endP;
 }
 
+static int prv_endpoint_index(internal_data_t * dataP,
+                              endpoint_t * endP)
+{
+    size_t index;
+
+    if (dataP->endpointCount >= dataP->tableSize)
+    {
+        endpoint_t ** tableP;
+        endpoint_t * targetP;
+        size_t size;
+
+        size = dataP->tableSize == 0 ? ENDPOINT_TABLE_MIN_SIZE : dataP->tableSize * 2;
+        tableP = (endpoint_t **)calloc(size, sizeof(endpoint_t *));
+        if (tableP == NULL) return -1;
+
+        free(dataP->endpointTable);
+        dataP->endpointTable = tableP;
+        dataP->tableSize = size;
+        for (targetP = dataP->endpointList; targetP != NULL; targetP = targetP->next)
+        {
+            index = prv_session_hash(dataP, targetP->handle);
+            targetP->nextInTable = tableP[index];
+            tableP[index] = targetP;
+        }
+    }
+
+    index = prv_session_hash(dataP, endP->handle);
+    endP->nextInTable = dataP->endpointTable[index];
+    dataP->endpointTable[index] = endP;
+    dataP->endpointCount++;
+
+    return 0;
+}
+
+static void prv_endpoint_unindex(internal_data_t * dataP,
+                                 endpoint_t * endP)
+{
+    endpoint_t ** targetP;
+
+    targetP = &(dataP->endpointTable[prv_session_hash(dataP, endP->handle)]);
+    while (*targetP != NULL
+        && *targetP != endP)
+    {
+        targetP = &((*targetP)->nextInTable);
+    }
+    if (*targetP != NULL)
+    {
+        *targetP = endP->nextInTable;
+        dataP->endpointCount--;
+    }
+}
+
 static endpoint_t * prv_endpoint_new(internal_data_t * dataP,
                                      void * sessionH)
 {
@@ -142,40 +214,45 @@ static endpoint_t * prv_endpoint_new(internal_data_t * dataP,
     endP = prv_endpoint_find(dataP, sessionH);
     if (endP != NULL)
     {
-        // delete previous state for the endpoint
-        endpoint_t * parentP;
-
-        parentP = dataP->endpointList;
-        while (parentP != NULL
-            && parentP->next != endP)
-        {
-            parentP = parentP->next;
-        }
-        if (parentP != NULL)
-        {
-            parentP->next = endP->next;
-        }
-        else
-        {
-            dataP->endpointList = endP->next;
-        }
-        prv_endpoint_free(endP);
+        // reset previous state for the endpoint
+        if (endP->name != NULL) free(endP->name);
+        endP->name = NULL;
+        return endP;
     }
 
     endP = (endpoint_t *)malloc(sizeof(endpoint_t));
+    if (endP == NULL) return NULL;
+    memset(endP, 0, sizeof(endpoint_t));
+    endP->handle = sessionH;
+
+    if (prv_endpoint_index(dataP, endP) != 0)
+    {
+        free(endP);
+        return NULL;
+    }
+    endP->next = dataP->endpointList;
+    dataP->endpointList = endP;
+
     return endP;
 }
 
+static bool prv_endpoint_done(endpoint_t * endP)
+{
+    return endP->pending == 0
+        && endP->stale == 0
+        && (endP->cmdIndex >= endP->info.commandCount || endP->status == CMD_STATUS_FAIL);
+}
+
 static void prv_endpoint_clean(internal_data_t * dataP)
 {
     endpoint_t * endP;
     endpoint_t * parentP;
 
     while (dataP->endpointList != NULL
-        && (dataP->endpointList->cmdList == NULL
-         || dataP->endpointList->status == CMD_STATUS_FAIL))
+        && prv_endpoint_done(dataP->endpointList))
     {
         endP = dataP->endpointList->next;
+        prv_endpoint_unindex(dataP, dataP->endpointList);
         prv_endpoint_free(dataP->endpointList);
         dataP->endpointList = endP;
     }
@@ -189,9 +266,9 @@ static void prv_endpoint_clean(internal_data_t * dataP)
             endpoint_t * nextP;
 
             nextP = endP->next;
-            if (endP->cmdList == NULL
-            || endP->status == CMD_STATUS_FAIL)
+            if (prv_endpoint_done(endP))
             {
+                prv_endpoint_unindex(dataP, endP);
                 prv_endpoint_free(endP);
                 parentP->next = nextP;
             }
@@ -208,65 +285,52 @@ static void prv_send_command(internal_data_t * dataP,
                              endpoint_t * endP)
 {
     int res;
+    bs_db_command_t command;
 
-    if (endP->cmdList == NULL) return;
+    if (endP->cmdIndex >= endP->info.commandCount) return;
+    if (!bs_db_get_command(dataP->bsDb, &endP->info, endP->cmdIndex, &command))
+    {
+        endP->status = CMD_STATUS_FAIL;
+        return;
+    }
 
-    switch (endP->cmdList->operation)
+    switch (command.operation)
     {
     case BS_DELETE:
-        fprintf(stdout, "Sending DELETE ");
-        prv_print_uri(stdout, endP->cmdList->uri);
-        fprintf(stdout, " to \"%s\"", endP->name);
-        res = lwm2m_bootstrap_delete(dataP->lwm2mH, endP->handle, endP->cmdList->uri);
-        break;
-
-    case BS_WRITE_SECURITY:
     {
-        lwm2m_uri_t uri;
-        bs_server_tlv_t * serverP;
+        lwm2m_uri_t * uriP;
 
-        serverP = (bs_server_tlv_t *)LWM2M_LIST_FIND(dataP->bsInfo->serverList, endP->cmdList->serverId);
-        if (serverP == NULL
-         || serverP->securityData == NULL)
-        {
-            endP->status = CMD_STATUS_FAIL;
-            return;
-        }
+        uriP = command.uri.flag == 0 ? NULL : &command.uri;
 
-        uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
-        uri.objectId = LWM2M_SECURITY_OBJECT_ID;
-        uri.instanceId = endP->cmdList->serverId;
-
-        fprintf(stdout, "Sending WRITE ");
-        prv_print_uri(stdout, &uri);
+        fprintf(stdout, "Sending DELETE ");
+        prv_print_uri(stdout, uriP);
         fprintf(stdout, " to \"%s\"", endP->name);
-
-        res = lwm2m_bootstrap_write(dataP->lwm2mH, endP->handle, &uri, LWM2M_CONTENT_TLV, serverP->securityData, serverP->securityLen);
+        res = lwm2m_bootstrap_delete(dataP->lwm2mH, endP->handle, uriP);
     }
         break;
 
+    case BS_WRITE_SECURITY:
     case BS_WRITE_SERVER:
     {
         lwm2m_uri_t uri;
-        bs_server_tlv_t * serverP;
+        const uint8_t * data;
+        size_t length;
 
-        serverP = (bs_server_tlv_t *)LWM2M_LIST_FIND(dataP->bsInfo->serverList, endP->cmdList->serverId);
-        if (serverP == NULL
-         || serverP->serverData == NULL)
+        if (!bs_db_get_server(dataP->bsDb, command.serverId, command.operation == BS_WRITE_SECURITY, &data, &length))
         {
             endP->status = CMD_STATUS_FAIL;
             return;
         }
 
         uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
-        uri.objectId = LWM2M_SERVER_OBJECT_ID;
-        uri.instanceId = endP->cmdList->serverId;
+        uri.objectId = command.operation == BS_WRITE_SECURITY ? LWM2M_SECURITY_OBJECT_ID : LWM2M_SERVER_OBJECT_ID;
+        uri.instanceId = command.serverId;
 
         fprintf(stdout, "Sending WRITE ");
         prv_print_uri(stdout, &uri);
         fprintf(stdout, " to \"%s\"", endP->name);
 
-        res = lwm2m_bootstrap_write(dataP->lwm2mH, endP->handle, &uri, LWM2M_CONTENT_TLV, serverP->serverData, serverP->serverLen);
+        res = lwm2m_bootstrap_write(dataP->lwm2mH, endP->handle, &uri, LWM2M_CONTENT_TLV, (uint8_t *)data, length);
     }
         break;
 
@@ -285,7 +349,7 @@ static void prv_send_command(internal_data_t * dataP,
     {
         fprintf(stdout, " OK.\r\n");
 
-        endP->status = CMD_STATUS_SENT;
+        endP->pending++;
     }
     else
     {
@@ -295,6 +359,45 @@ static void prv_send_command(internal_data_t * dataP,
     }
 }
 
+// The commands are handed over at once: the core sends them in order within the client's window.
+static void prv_send_commands(internal_data_t * dataP,
+                              endpoint_t * endP)
+{
+    while (endP->status != CMD_STATUS_FAIL
+        && endP->cmdIndex < endP->info.commandCount)
+    {
+        prv_send_command(dataP, endP);
+        endP->cmdIndex++;
+    }
+
+    if (endP->status != CMD_STATUS_FAIL)
+    {
+        endP->status = CMD_STATUS_SENT;
+    }
+}
+
+// The core sends a command only when the commands of another kind are answered: the n-th
+// answer is for a command of the same operation as the n-th command.
+static uint8_t prv_expected_status(internal_data_t * dataP,
+                                   endpoint_t * endP)
+{
+    bs_db_command_t command;
+
+    if (!bs_db_get_command(dataP->bsDb, &endP->info, endP->answerIndex, &command)) return COAP_NO_ERROR;
+
+    switch (command.operation)
+    {
+    case BS_DELETE:
+        return COAP_202_DELETED;
+    case BS_WRITE_SECURITY:
+    case BS_WRITE_SERVER:
+    case BS_FINISH:
+        return COAP_204_CHANGED;
+    default:
+        return COAP_NO_ERROR;
+    }
+}
+
 static int prv_bootstrap_callback(void * sessionH,
                                   uint8_t status,
                                   lwm2m_uri_t * uriP,
@@ -309,41 +412,26 @@ static int prv_bootstrap_callback(void * sessionH,
     {
     case COAP_NO_ERROR:
     {
-        bs_endpoint_info_t * endInfoP;
+        bs_db_endpoint_t info;
 
         // Display
         fprintf(stdout, "\r\nBootstrap request from \"%s\"\r\n", name);
 
-        // find Bootstrap Info for this endpoint
-        endInfoP = dataP->bsInfo->endpointList;
-        while (endInfoP != NULL
-            && endInfoP->name != NULL
-            && strcmp(name, endInfoP->name) != 0)
-        {
-            endInfoP = endInfoP->next;
-        }
-        if (endInfoP == NULL)
-        {
-            // find default Bootstrap Info
-            endInfoP = dataP->bsInfo->endpointList;
-            while (endInfoP != NULL
-                && endInfoP->name != NULL)
-            {
-                endInfoP = endInfoP->next;
-            }
-        }
-        // Nothing found, discard the request
-        if (endInfoP == NULL)return COAP_IGNORE;
+        // find Bootstrap Info for this endpoint or the default one
+        // if nothing is found, discard the request
+        if (!bs_db_find_endpoint(dataP->bsDb, name, &info)) return COAP_IGNORE;
 
         endP = prv_endpoint_new(dataP, sessionH);
         if (endP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
 
-        endP->cmdList = endInfoP->commandList;
-        endP->handle = sessionH;
+        endP->info = info;
+        endP->cmdIndex = 0;
+        // the commands in flight are still answered. Waiting commands were cancelled by the core.
+        endP->stale += endP->pending;
+        endP->pending = 0;
+        endP->answerIndex = 0;
         endP->name = strdup(name);
         endP->status = CMD_STATUS_NEW;
-        endP->next = dataP->endpointList;
-        dataP->endpointList = endP;
 
         return COAP_204_CHANGED;
     }
@@ -363,39 +451,22 @@ static int prv_bootstrap_callback(void * sessionH,
         }
         fprintf(stdout, " from endpoint %s.\r\n", endP->name);
 
-        // should not happen
-        if (endP->cmdList == NULL) return COAP_NO_ERROR;
-        if (endP->status != CMD_STATUS_SENT) return COAP_NO_ERROR;
-
-        switch (endP->cmdList->operation)
+        if (endP->stale > 0)
         {
-        case BS_DELETE:
-            if (status == COAP_202_DELETED)
-            {
-                endP->status = CMD_STATUS_OK;
-            }
-            else
-            {
-                endP->status = CMD_STATUS_FAIL;
-            }
-            break;
-
-        case BS_WRITE_SECURITY:
-        case BS_WRITE_SERVER:
-            if (status == COAP_204_CHANGED)
-            {
-                endP->status = CMD_STATUS_OK;
-            }
-            else
-            {
-                endP->status = CMD_STATUS_FAIL;
-            }
+            // the new commands are sent once all these answers are received
+            endP->stale--;
             break;
+        }
+        // should not happen
+        if (endP->pending == 0) return COAP_NO_ERROR;
 
-        default:
+        endP->pending--;
+        if (endP->status == CMD_STATUS_SENT
+         && status != prv_expected_status(dataP, endP))
+        {
             endP->status = CMD_STATUS_FAIL;
-            break;
         }
+        endP->answerIndex++;
         break;
     }
 
@@ -481,8 +552,8 @@ int main(int argc, char *argv[])
     char * port = "5685";
     internal_data_t data;
     char * filename = "bootstrap_server.ini";
+    char * dbFilename = NULL;
     int opt;
-    FILE * fd;
     command_desc_t commands[] =
     {
         {"boot", "Bootstrap a client (Server Initiated).", " boot URI [NAME]\r\n"
@@ -519,6 +590,15 @@ int main(int argc, char *argv[])
             }
             filename = argv[opt];
             break;
+        case 'c':
+            opt++;
+            if (opt >= argc)
+            {
+                print_usage(filename, port);
+                return 0;
+            }
+            dbFilename = argv[opt];
+            break;
         case 'l':
             opt++;
             if (opt >= argc)
@@ -538,6 +618,26 @@ int main(int argc, char *argv[])
         opt += 1;
     }
 
+    data.bsDb = bs_db_open(filename);
+    if (data.bsDb == NULL)
+    {
+        fprintf(stderr, "Reading Bootstrap Info from file %s failed.\r\n", filename);
+        return -1;
+    }
+
+    if (dbFilename != NULL)
+    {
+        if (bs_db_save(data.bsDb, dbFilename) != 0)
+        {
+            fprintf(stderr, "Writing Bootstrap database %s failed.\r\n", dbFilename);
+            bs_db_close(data.bsDb);
+            return -1;
+        }
+        fprintf(stdout, "Compiled %" PRIu32 " endpoints in %s.\r\n", data.bsDb->endpointCount, dbFilename);
+        bs_db_close(data.bsDb);
+        return 0;
+    }
+
     data.sock = create_socket(port, data.addressFamily);
     if (data.sock < 0)
     {
@@ -554,21 +654,6 @@ int main(int argc, char *argv[])
 
     signal(SIGINT, handle_sigint);
 
-    fd = fopen(filename, "r");
-    if (fd == NULL)
-    {
-        fprintf(stderr, "Opening file %s failed.\r\n", filename);
-        return -1;
-    }
-
-    data.bsInfo = bs_get_info(fd);
-    fclose(fd);
-    if (data.bsInfo == NULL)
-    {
-        fprintf(stderr, "Reading Bootstrap Info from file %s failed.\r\n", filename);
-        return -1;
-    }
-
     lwm2m_set_bootstrap_callback(data.lwm2mH, prv_bootstrap_callback, (void *)&data);
 
     fprintf(stdout, "LWM2M Bootstrap Server now listening on port %s.\r\n\n", port);
@@ -686,12 +771,8 @@ int main(int argc, char *argv[])
             {
                 switch(endP->status)
                 {
-                case CMD_STATUS_OK:
-                    endP->cmdList = endP->cmdList->next;
-                    endP->status = CMD_STATUS_NEW;
-                    // fall through
                 case CMD_STATUS_NEW:
-                    prv_send_command(&data, endP);
+                    if (endP->stale == 0) prv_send_commands(&data, endP);
                     break;
                 default:
                     break;
@@ -703,7 +784,7 @@ int main(int argc, char *argv[])
     }
 
     lwm2m_close(data.lwm2mH);
-    bs_free_info(data.bsInfo);
+    bs_db_close(data.bsDb);
     while (data.endpointList != NULL)
     {
         endpoint_t * endP;
@@ -713,6 +794,7 @@ int main(int argc, char *argv[])
 
         prv_endpoint_free(endP);
     }
+    free(data.endpointTable);
     close(data.sock);
     connection_free(data.connList);
 
@@ -64,6 +64,7 @@
 #else
 #include "connection.h"
 #endif
+#include "filejournal.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -90,9 +91,14 @@ static int g_quit = 0;
 #define OBJ_COUNT 9
 lwm2m_object_t * objArray[OBJ_COUNT];
 
+#ifdef LWM2M_OBJECT_JOURNAL
+// security and server objects saved across reboots and restored after a failed bootstrap
+static const uint16_t g_journaledObjects[] = {LWM2M_SECURITY_OBJECT_ID, LWM2M_SERVER_OBJECT_ID};
+#else
 // only backup security and server objects
 # define BACKUP_OBJECT_COUNT 2
 lwm2m_object_t * backupObjectArray[BACKUP_OBJECT_COUNT];
+#endif
 
 typedef struct
 {
@@ -106,6 +112,9 @@ typedef struct
     connection_t * connList;
 #endif
     int addressFamily;
+#ifdef LWM2M_OBJECT_JOURNAL
+    file_journal_t journal;
+#endif
 } client_data_t;
 
 static void prv_quit(char * buffer,
@@ -529,6 +538,47 @@ syntax_error:
     fprintf(stdout, "Syntax error !\n");
 }
 
+#ifdef LWM2M_SUPPORT_CBOR
+#define MAX_SEND_URIS 8
+
+static void prv_send(char * buffer,
+                     void * user_data)
+{
+    lwm2m_context_t * lwm2mH = (lwm2m_context_t *)user_data;
+    lwm2m_uri_t uris[MAX_SEND_URIS];
+    uint16_t serverId;
+    int count;
+    char * end = NULL;
+    int res;
+
+    if (buffer[0] == 0) goto syntax_error;
+    serverId = (uint16_t) atoi(buffer);
+
+    count = 0;
+    buffer = get_next_arg(buffer, &end);
+    while (buffer[0] != 0)
+    {
+        if (count == MAX_SEND_URIS) goto syntax_error;
+        if (lwm2m_stringToUri(buffer, end - buffer, uris + count) == 0) goto syntax_error;
+        count++;
+        buffer = get_next_arg(end, &end);
+    }
+    if (count == 0) goto syntax_error;
+
+    res = lwm2m_send(lwm2mH, serverId, uris, count);
+    if (res != 0)
+    {
+        fprintf(stdout, "Send error: ");
+        print_status(stdout, res);
+        fprintf(stdout, "\r\n");
+    }
+    return;
+
+syntax_error:
+    fprintf(stdout, "Syntax error !\n");
+}
+#endif
+
 static void update_battery_level(lwm2m_context_t * context)
 {
     static time_t next_change_time = 0;
@@ -661,6 +711,7 @@ static void prv_display_objects(char * buffer,
     }
 }
 
+#ifndef LWM2M_OBJECT_JOURNAL
 static void prv_display_backup(char * buffer,
         void * user_data)
 {
@@ -779,6 +830,37 @@ static void close_backup_object()
     }
 }
 #endif
+#endif
+
+#ifdef LWM2M_OBJECT_JOURNAL
+int lwm2m_journal_open(uint8_t ** bufferP,
+                       size_t * lengthP,
+                       void * userData)
+{
+    return file_journal_open(&((client_data_t *)userData)->journal, bufferP, lengthP);
+}
+
+void lwm2m_journal_close(uint8_t * buffer,
+                         size_t length,
+                         void * userData)
+{
+    file_journal_close(&((client_data_t *)userData)->journal, buffer, length);
+}
+
+int lwm2m_journal_append(uint8_t * buffer,
+                         size_t length,
+                         void * userData)
+{
+    return file_journal_append(&((client_data_t *)userData)->journal, buffer, length);
+}
+
+int lwm2m_journal_replace(uint8_t * buffer,
+                          size_t length,
+                          void * userData)
+{
+    return file_journal_replace(&((client_data_t *)userData)->journal, buffer, length);
+}
+#endif
 
 void print_usage(void)
 {
@@ -793,6 +875,9 @@ void print_usage(void)
     fprintf(stdout, "  -t TIME\tSet the lifetime of the Client. Default: 300\r\n");
     fprintf(stdout, "  -b\t\tBootstrap requested.\r\n");
     fprintf(stdout, "  -c\t\tChange battery level over time.\r\n");
+#ifdef LWM2M_OBJECT_JOURNAL
+    fprintf(stdout, "  -j FILE\tKeep the security and server objects in FILE across reboots.\r\n");
+#endif
 #ifdef WITH_TINYDTLS
     fprintf(stdout, "  -i STRING\tSet the device management or bootstrap server PSK identity. If not set use none secure mode\r\n");
     fprintf(stdout, "  -s HEXSTRING\tSet the device management or bootstrap server Pre-Shared-Key. If not set use none secure mode\r\n");
@@ -841,10 +926,17 @@ int main(int argc, char *argv[])
                                                         "   DATA: (optional) new value\r\n", prv_change, NULL},
             {"update", "Trigger a registration update", " update SERVER\r\n"
                                                         "   SERVER: short server id such as 123\r\n", prv_update, NULL},
+#ifdef LWM2M_SUPPORT_CBOR
+            {"send", "Push values to a server", " send SERVER URI [URI...]\r\n"
+                                                        "   SERVER: short server id such as 123, 0 for all\r\n"
+                                                        "   URI: up to 8 uris such as /3/0/9 /3/0/13\r\n", prv_send, NULL},
+#endif
 #ifdef LWM2M_BOOTSTRAP
             {"bootstrap", "Initiate a DI bootstrap process", NULL, prv_initiate_bootstrap, NULL},
+#ifndef LWM2M_OBJECT_JOURNAL
             {"dispb", "Display current backup of objects/instances/resources\r\n"
                     "\t(only security and server objects are backupped)", NULL, prv_display_backup, NULL},
+#endif
 #endif
             {"ls", "List Objects and Instances", NULL, prv_object_list, NULL},
             {"disp", "Display current objects/instances/resources", NULL, prv_display_objects, NULL},
@@ -860,6 +952,9 @@ int main(int argc, char *argv[])
 
     memset(&data, 0, sizeof(client_data_t));
     data.addressFamily = AF_INET6;
+#ifdef LWM2M_OBJECT_JOURNAL
+    file_journal_init(&data.journal, NULL);
+#endif
 
     opt = 1;
     while (opt < argc)
@@ -953,6 +1048,17 @@ int main(int argc, char *argv[])
         case '4':
             data.addressFamily = AF_INET;
             break;
+#ifdef LWM2M_OBJECT_JOURNAL
+        case 'j':
+            opt++;
+            if (opt >= argc)
+            {
+                print_usage();
+                return 0;
+            }
+            data.journal.path = argv[opt];
+            break;
+#endif
         default:
             print_usage();
             return 0;
@@ -1128,6 +1234,18 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+#ifdef LWM2M_OBJECT_JOURNAL
+    /*
+     * The security and server objects are replaced by the ones saved before the last reboot, if any
+     */
+    result = lwm2m_restore_objects(lwm2mH, sizeof(g_journaledObjects) / sizeof(uint16_t), g_journaledObjects);
+    if (result != 0)
+    {
+        fprintf(stderr, "lwm2m_restore_objects() failed: 0x%X\r\n", result);
+        return -1;
+    }
+#endif
+
     signal(SIGINT, handle_sigint);
 
     /**
@@ -1228,16 +1346,26 @@ int main(int argc, char *argv[])
             fprintf(stderr, "lwm2m_step() failed: 0x%X\r\n", result);
             if(previousState == STATE_BOOTSTRAPPING)
             {
+#ifdef LWM2M_OBJECT_JOURNAL
+#ifdef WITH_LOGS
+                fprintf(stdout, "[BOOTSTRAP] security and server objects restored\r\n");
+#endif
+#else
 #ifdef WITH_LOGS
                 fprintf(stdout, "[BOOTSTRAP] restore security and server objects\r\n");
 #endif
                 prv_restore_objects(lwm2mH);
+#endif
                 lwm2mH->state = STATE_INITIAL;
             }
             else return -1;
         }
 #ifdef LWM2M_BOOTSTRAP
+#ifdef LWM2M_OBJECT_JOURNAL
+        previousState = lwm2mH->state;
+#else
         update_bootstrap_info(&previousState, lwm2mH);
+#endif
 #endif
         /*
          * This part will set up an interruption until an event happen on SDTIN or the socket until "tv" timed out (set
@@ -1366,12 +1494,15 @@ int main(int argc, char *argv[])
         free(pskBuffer);
 #endif
 
-#ifdef LWM2M_BOOTSTRAP
+#if defined(LWM2M_BOOTSTRAP) && !defined(LWM2M_OBJECT_JOURNAL)
         close_backup_object();
 #endif
         lwm2m_close(lwm2mH);
     }
     close(data.sock);
+#ifdef LWM2M_OBJECT_JOURNAL
+    file_journal_free(&data.journal);
+#endif
     connection_free(data.connList);
 
     clean_security_object(objArray[0]);
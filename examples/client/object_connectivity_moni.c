@@ -305,6 +305,8 @@ uint8_t connectivity_moni_change(lwm2m_data_t * dataArray,
     int64_t value;
     uint8_t result;
     conn_m_data_t * data;
+    uint8_t * buffer;
+    size_t length;
 
     data = (conn_m_data_t*) (objectP->userData);
 
@@ -335,29 +337,31 @@ uint8_t connectivity_moni_change(lwm2m_data_t * dataArray,
         break;
 
     case RES_M_IP_ADDRESSES:
-        if (sizeof(data->ipAddresses[0]) <= dataArray->value.asBuffer.length)
+        buffer = lwm2m_data_get_buffer(dataArray, &length);
+        if (sizeof(data->ipAddresses[0]) <= length)
         {
             result = COAP_400_BAD_REQUEST;
         }
         else
         {
             memset(data->ipAddresses[0], 0, sizeof(data->ipAddresses[0]));
-            memcpy(data->ipAddresses[0], dataArray->value.asBuffer.buffer, dataArray->value.asBuffer.length);
-            data->ipAddresses[0][dataArray->value.asBuffer.length] = 0;
+            memcpy(data->ipAddresses[0], buffer, length);
+            data->ipAddresses[0][length] = 0;
             result = COAP_204_CHANGED;
         }
         break;
 
     case RES_O_ROUTER_IP_ADDRESS:
-        if (sizeof(data->routerIpAddresses[0]) <= dataArray->value.asBuffer.length)
+        buffer = lwm2m_data_get_buffer(dataArray, &length);
+        if (sizeof(data->routerIpAddresses[0]) <= length)
         {
             result = COAP_400_BAD_REQUEST;
         }
         else
         {
             memset(data->routerIpAddresses[0], 0, sizeof(data->routerIpAddresses[0]));
-            memcpy(data->routerIpAddresses[0], dataArray->value.asBuffer.buffer, dataArray->value.asBuffer.length);
-            data->routerIpAddresses[0][dataArray->value.asBuffer.length] = 0;
+            memcpy(data->routerIpAddresses[0], buffer, length);
+            data->routerIpAddresses[0][length] = 0;
             result = COAP_204_CHANGED;
         }
         break;
@@ -168,19 +168,19 @@ static uint8_t prv_set_value(lwm2m_data_t * dataP,
     switch (dataP->id)
     {
     case RES_O_MANUFACTURER:
-        lwm2m_data_encode_string(PRV_MANUFACTURER, dataP);
+        lwm2m_data_encode_string_borrowed(PRV_MANUFACTURER, dataP);
         return COAP_205_CONTENT;
 
     case RES_O_MODEL_NUMBER:
-        lwm2m_data_encode_string(PRV_MODEL_NUMBER, dataP);
+        lwm2m_data_encode_string_borrowed(PRV_MODEL_NUMBER, dataP);
         return COAP_205_CONTENT;
 
     case RES_O_SERIAL_NUMBER:
-        lwm2m_data_encode_string(PRV_SERIAL_NUMBER, dataP);
+        lwm2m_data_encode_string_borrowed(PRV_SERIAL_NUMBER, dataP);
         return COAP_205_CONTENT;
 
     case RES_O_FIRMWARE_VERSION:
-        lwm2m_data_encode_string(PRV_FIRMWARE_VERSION, dataP);
+        lwm2m_data_encode_string_borrowed(PRV_FIRMWARE_VERSION, dataP);
         return COAP_205_CONTENT;
 
     case RES_M_REBOOT:
@@ -191,48 +191,42 @@ static uint8_t prv_set_value(lwm2m_data_t * dataP,
 
     case RES_O_AVL_POWER_SOURCES: 
     {
-        lwm2m_data_t * subTlvP;
+        static lwm2m_data_t subTlv[2];
 
-        subTlvP = lwm2m_data_new(2);
+        subTlv[0].id = 0;
+        lwm2m_data_encode_int(PRV_POWER_SOURCE_1, subTlv);
+        subTlv[1].id = 1;
+        lwm2m_data_encode_int(PRV_POWER_SOURCE_2, subTlv + 1);
 
-        subTlvP[0].id = 0;
-        lwm2m_data_encode_int(PRV_POWER_SOURCE_1, subTlvP);
-        subTlvP[1].id = 1;
-        lwm2m_data_encode_int(PRV_POWER_SOURCE_2, subTlvP + 1);
-
-        lwm2m_data_encode_instances(subTlvP, 2, dataP);
+        lwm2m_data_encode_instances_borrowed(subTlv, 2, dataP);
 
         return COAP_205_CONTENT;
     }
 
     case RES_O_POWER_SOURCE_VOLTAGE:
     {
-        lwm2m_data_t * subTlvP;
-
-        subTlvP = lwm2m_data_new(2);
+        static lwm2m_data_t subTlv[2];
 
-        subTlvP[0].id = 0;
-        lwm2m_data_encode_int(PRV_POWER_VOLTAGE_1, subTlvP);
-        subTlvP[1].id = 1;
-        lwm2m_data_encode_int(PRV_POWER_VOLTAGE_2, subTlvP + 1);
+        subTlv[0].id = 0;
+        lwm2m_data_encode_int(PRV_POWER_VOLTAGE_1, subTlv);
+        subTlv[1].id = 1;
+        lwm2m_data_encode_int(PRV_POWER_VOLTAGE_2, subTlv + 1);
 
-        lwm2m_data_encode_instances(subTlvP, 2, dataP);
+        lwm2m_data_encode_instances_borrowed(subTlv, 2, dataP);
 
         return COAP_205_CONTENT;
     }
 
     case RES_O_POWER_SOURCE_CURRENT:
     {
-        lwm2m_data_t * subTlvP;
+        static lwm2m_data_t subTlv[2];
 
-        subTlvP = lwm2m_data_new(2);
-
-        subTlvP[0].id = 0;
-        lwm2m_data_encode_int(PRV_POWER_CURRENT_1, &subTlvP[0]);
-        subTlvP[1].id = 1;
-        lwm2m_data_encode_int(PRV_POWER_CURRENT_2, &subTlvP[1]);
+        subTlv[0].id = 0;
+        lwm2m_data_encode_int(PRV_POWER_CURRENT_1, &subTlv[0]);
+        subTlv[1].id = 1;
+        lwm2m_data_encode_int(PRV_POWER_CURRENT_2, &subTlv[1]);
  
-        lwm2m_data_encode_instances(subTlvP, 2, dataP);
+        lwm2m_data_encode_instances_borrowed(subTlv, 2, dataP);
 
         return COAP_205_CONTENT;
     }
@@ -247,14 +241,12 @@ static uint8_t prv_set_value(lwm2m_data_t * dataP,
 
     case RES_M_ERROR_CODE:
     {
-        lwm2m_data_t * subTlvP;
-
-        subTlvP = lwm2m_data_new(1);
+        static lwm2m_data_t subTlv[1];
 
-        subTlvP[0].id = 0;
-        lwm2m_data_encode_int(devDataP->error, subTlvP);
+        subTlv[0].id = 0;
+        lwm2m_data_encode_int(devDataP->error, subTlv);
 
-        lwm2m_data_encode_instances(subTlvP, 1, dataP);
+        lwm2m_data_encode_instances_borrowed(subTlv, 1, dataP);
 
         return COAP_205_CONTENT;
     }        
@@ -266,15 +258,15 @@ static uint8_t prv_set_value(lwm2m_data_t * dataP,
         return COAP_205_CONTENT;
 
     case RES_O_UTC_OFFSET:
-        lwm2m_data_encode_string(devDataP->time_offset, dataP);
+        lwm2m_data_encode_string_borrowed(devDataP->time_offset, dataP);
         return COAP_205_CONTENT;
 
     case RES_O_TIMEZONE:
-        lwm2m_data_encode_string(PRV_TIME_ZONE, dataP);
+        lwm2m_data_encode_string_borrowed(PRV_TIME_ZONE, dataP);
         return COAP_205_CONTENT;
       
     case RES_M_BINDING_MODES:
-        lwm2m_data_encode_string(PRV_BINDING_MODE, dataP);
+        lwm2m_data_encode_string_borrowed(PRV_BINDING_MODE, dataP);
         return COAP_205_CONTENT;
 
     default:
@@ -427,6 +419,8 @@ static uint8_t prv_device_write(uint16_t instanceId,
 {
     int i;
     uint8_t result;
+    uint8_t * buffer;
+    size_t length;
 
     // this is a single instance object
     if (instanceId != 0)
@@ -453,10 +447,11 @@ static uint8_t prv_device_write(uint16_t instanceId,
             break;
 
         case RES_O_UTC_OFFSET:
-            if (1 == prv_check_time_offset((char*)dataArray[i].value.asBuffer.buffer, dataArray[i].value.asBuffer.length))
+            buffer = lwm2m_data_get_buffer(dataArray + i, &length);
+            if (1 == prv_check_time_offset((char*)buffer, length))
             {
-                strncpy(((device_data_t*)(objectP->userData))->time_offset, (char*)dataArray[i].value.asBuffer.buffer, dataArray[i].value.asBuffer.length);
-                ((device_data_t*)(objectP->userData))->time_offset[dataArray[i].value.asBuffer.length] = 0;
+                strncpy(((device_data_t*)(objectP->userData))->time_offset, (char*)buffer, length);
+                ((device_data_t*)(objectP->userData))->time_offset[length] = 0;
                 result = COAP_204_CHANGED;
             }
             else
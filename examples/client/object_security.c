@@ -192,6 +192,8 @@ static uint8_t prv_security_write(uint16_t instanceId,
     security_instance_t * targetP;
     int i;
     uint8_t result = COAP_204_CHANGED;
+    uint8_t * buffer;
+    size_t length;
 
     targetP = (security_instance_t *)lwm2m_list_find(objectP->instanceList, instanceId);
     if (NULL == targetP)
@@ -204,12 +206,13 @@ static uint8_t prv_security_write(uint16_t instanceId,
         switch (dataArray[i].id)
         {
         case LWM2M_SECURITY_URI_ID:
+            buffer = lwm2m_data_get_buffer(dataArray + i, &length);
             if (targetP->uri != NULL) lwm2m_free(targetP->uri);
-            targetP->uri = (char *)lwm2m_malloc(dataArray[i].value.asBuffer.length + 1);
-            memset(targetP->uri, 0, dataArray[i].value.asBuffer.length + 1);
+            targetP->uri = (char *)lwm2m_malloc(length + 1);
+            memset(targetP->uri, 0, length + 1);
             if (targetP->uri != NULL)
             {
-                strncpy(targetP->uri, (char*)dataArray[i].value.asBuffer.buffer, dataArray[i].value.asBuffer.length);
+                strncpy(targetP->uri, (char*)buffer, length);
                 result = COAP_204_CHANGED;
             }
             else
@@ -252,13 +255,14 @@ static uint8_t prv_security_write(uint16_t instanceId,
         }
         break;
         case LWM2M_SECURITY_PUBLIC_KEY_ID:
+            buffer = lwm2m_data_get_buffer(dataArray + i, &length);
             if (targetP->publicIdentity != NULL) lwm2m_free(targetP->publicIdentity);
-            targetP->publicIdentity = (char *)lwm2m_malloc(dataArray[i].value.asBuffer.length +1);
-            memset(targetP->publicIdentity, 0, dataArray[i].value.asBuffer.length + 1);
+            targetP->publicIdentity = (char *)lwm2m_malloc(length +1);
+            memset(targetP->publicIdentity, 0, length + 1);
             if (targetP->publicIdentity != NULL)
             {
-                memcpy(targetP->publicIdentity, (char*)dataArray[i].value.asBuffer.buffer, dataArray[i].value.asBuffer.length);
-                targetP->publicIdLen = dataArray[i].value.asBuffer.length;
+                memcpy(targetP->publicIdentity, (char*)buffer, length);
+                targetP->publicIdLen = length;
                 result = COAP_204_CHANGED;
             }
             else
@@ -268,13 +272,14 @@ static uint8_t prv_security_write(uint16_t instanceId,
             break;
 
         case LWM2M_SECURITY_SERVER_PUBLIC_KEY_ID:
+            buffer = lwm2m_data_get_buffer(dataArray + i, &length);
             if (targetP->serverPublicKey != NULL) lwm2m_free(targetP->serverPublicKey);
-            targetP->serverPublicKey = (char *)lwm2m_malloc(dataArray[i].value.asBuffer.length +1);
-            memset(targetP->serverPublicKey, 0, dataArray[i].value.asBuffer.length + 1);
+            targetP->serverPublicKey = (char *)lwm2m_malloc(length +1);
+            memset(targetP->serverPublicKey, 0, length + 1);
             if (targetP->serverPublicKey != NULL)
             {
-                memcpy(targetP->serverPublicKey, (char*)dataArray[i].value.asBuffer.buffer, dataArray[i].value.asBuffer.length);
-                targetP->serverPublicKeyLen = dataArray[i].value.asBuffer.length;
+                memcpy(targetP->serverPublicKey, (char*)buffer, length);
+                targetP->serverPublicKeyLen = length;
                 result = COAP_204_CHANGED;
             }
             else
@@ -284,13 +289,14 @@ static uint8_t prv_security_write(uint16_t instanceId,
             break;
 
         case LWM2M_SECURITY_SECRET_KEY_ID:
+            buffer = lwm2m_data_get_buffer(dataArray + i, &length);
             if (targetP->secretKey != NULL) lwm2m_free(targetP->secretKey);
-            targetP->secretKey = (char *)lwm2m_malloc(dataArray[i].value.asBuffer.length +1);
-            memset(targetP->secretKey, 0, dataArray[i].value.asBuffer.length + 1);
+            targetP->secretKey = (char *)lwm2m_malloc(length +1);
+            memset(targetP->secretKey, 0, length + 1);
             if (targetP->secretKey != NULL)
             {
-                memcpy(targetP->secretKey, (char*)dataArray[i].value.asBuffer.buffer, dataArray[i].value.asBuffer.length);
-                targetP->secretKeyLen = dataArray[i].value.asBuffer.length;
+                memcpy(targetP->secretKey, (char*)buffer, length);
+                targetP->secretKeyLen = length;
                 result = COAP_204_CHANGED;
             }
             else
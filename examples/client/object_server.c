@@ -232,6 +232,8 @@ static uint8_t prv_server_write(uint16_t instanceId,
     server_instance_t * targetP;
     int i;
     uint8_t result;
+    uint8_t * buffer;
+    size_t length;
 
     targetP = (server_instance_t *)lwm2m_list_find(objectP->instanceList, instanceId);
     if (NULL == targetP)
@@ -299,16 +301,17 @@ static uint8_t prv_server_write(uint16_t instanceId,
         break;
 
         case LWM2M_SERVER_BINDING_ID:
+            buffer = lwm2m_data_get_buffer(dataArray + i, &length);
             if ((dataArray[i].type == LWM2M_TYPE_STRING || dataArray[i].type == LWM2M_TYPE_OPAQUE)
-             && dataArray[i].value.asBuffer.length > 0 && dataArray[i].value.asBuffer.length <= 3
-             && (strncmp((char*)dataArray[i].value.asBuffer.buffer, "U", dataArray[i].value.asBuffer.length) == 0
-              || strncmp((char*)dataArray[i].value.asBuffer.buffer, "UQ", dataArray[i].value.asBuffer.length) == 0
-              || strncmp((char*)dataArray[i].value.asBuffer.buffer, "S", dataArray[i].value.asBuffer.length) == 0
-              || strncmp((char*)dataArray[i].value.asBuffer.buffer, "SQ", dataArray[i].value.asBuffer.length) == 0
-              || strncmp((char*)dataArray[i].value.asBuffer.buffer, "US", dataArray[i].value.asBuffer.length) == 0
-              || strncmp((char*)dataArray[i].value.asBuffer.buffer, "UQS", dataArray[i].value.asBuffer.length) == 0))
+             && length > 0 && length <= 3
+             && (strncmp((char*)buffer, "U", length) == 0
+              || strncmp((char*)buffer, "UQ", length) == 0
+              || strncmp((char*)buffer, "S", length) == 0
+              || strncmp((char*)buffer, "SQ", length) == 0
+              || strncmp((char*)buffer, "US", length) == 0
+              || strncmp((char*)buffer, "UQS", length) == 0))
             {
-                strncpy(targetP->binding, (char*)dataArray[i].value.asBuffer.buffer, dataArray[i].value.asBuffer.length);
+                strncpy(targetP->binding, (char*)buffer, length);
                 result = COAP_204_CHANGED;
             }
             else
@@ -139,7 +139,7 @@ static uint8_t prv_read(uint16_t instanceId,
     prv_instance_t * targetP;
     int i;
 
-    targetP = (prv_instance_t *)lwm2m_list_find(objectP->instanceList, instanceId);
+    targetP = (prv_instance_t *)LWM2M_INDEX_FIND(objectP->instanceIndex, instanceId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
 
     if (*numDataP == 0)
@@ -215,7 +215,7 @@ static uint8_t prv_write(uint16_t instanceId,
     prv_instance_t * targetP;
     int i;
 
-    targetP = (prv_instance_t *)lwm2m_list_find(objectP->instanceList, instanceId);
+    targetP = (prv_instance_t *)LWM2M_INDEX_FIND(objectP->instanceIndex, instanceId);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
 
     for (i = 0 ; i < numData ; i++)
@@ -254,7 +254,7 @@ static uint8_t prv_delete(uint16_t id,
 {
     prv_instance_t * targetP;
 
-    objectP->instanceList = lwm2m_list_remove(objectP->instanceList, id, (lwm2m_list_t **)&targetP);
+    targetP = (prv_instance_t *)LWM2M_INDEX_RM(objectP->instanceIndex, objectP->instanceList, id);
     if (NULL == targetP) return COAP_404_NOT_FOUND;
 
     lwm2m_free(targetP);
@@ -276,7 +276,11 @@ static uint8_t prv_create(uint16_t instanceId,
     memset(targetP, 0, sizeof(prv_instance_t));
 
     targetP->shortID = instanceId;
-    objectP->instanceList = LWM2M_LIST_ADD(objectP->instanceList, targetP);
+    if (0 != LWM2M_INDEX_ADD(objectP->instanceIndex, objectP->instanceList, targetP))
+    {
+        lwm2m_free(targetP);
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
 
     result = prv_write(instanceId, numData, dataArray, objectP);
 
@@ -299,7 +303,7 @@ static uint8_t prv_exec(uint16_t instanceId,
                         lwm2m_object_t * objectP)
 {
 
-    if (NULL == lwm2m_list_find(objectP->instanceList, instanceId)) return COAP_404_NOT_FOUND;
+    if (NULL == LWM2M_INDEX_FIND(objectP->instanceIndex, instanceId)) return COAP_404_NOT_FOUND;
 
     switch (resourceId)
     {
@@ -349,6 +353,14 @@ lwm2m_object_t * get_test_object(void)
         memset(testObj, 0, sizeof(lwm2m_object_t));
 
         testObj->objID = TEST_OBJECT_ID;
+        // the instances are indexed, the core uses the index for its lookups
+        testObj->instanceIndex = (lwm2m_list_index_t *)lwm2m_malloc(sizeof(lwm2m_list_index_t));
+        if (NULL == testObj->instanceIndex)
+        {
+            lwm2m_free(testObj);
+            return NULL;
+        }
+        memset(testObj->instanceIndex, 0, sizeof(lwm2m_list_index_t));
         for (i=0 ; i < 3 ; i++)
         {
             targetP = (prv_instance_t *)lwm2m_malloc(sizeof(prv_instance_t));
@@ -357,7 +369,7 @@ lwm2m_object_t * get_test_object(void)
             targetP->shortID = 10 + i;
             targetP->test    = 20 + i;
             targetP->dec     = -30 + i + (double)i/100.0;
-            testObj->instanceList = LWM2M_LIST_ADD(testObj->instanceList, targetP);
+            LWM2M_INDEX_ADD(testObj->instanceIndex, testObj->instanceList, targetP);
         }
         /*
          * From a single instance object, two more functions are available.
@@ -380,6 +392,8 @@ lwm2m_object_t * get_test_object(void)
 void free_test_object(lwm2m_object_t * object)
 {
     LWM2M_LIST_FREE(object->instanceList);
+    lwm2m_index_clear(object->instanceIndex);
+    lwm2m_free(object->instanceIndex);
     if (object->userData != NULL)
     {
         lwm2m_free(object->userData);
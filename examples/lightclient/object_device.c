@@ -101,18 +101,18 @@ static uint8_t prv_set_value(lwm2m_data_t * dataP)
     switch (dataP->id)
     {
     case RES_O_MANUFACTURER:
-        lwm2m_data_encode_string(PRV_MANUFACTURER, dataP);
+        lwm2m_data_encode_string_borrowed(PRV_MANUFACTURER, dataP);
         return COAP_205_CONTENT;
 
     case RES_O_MODEL_NUMBER:
-        lwm2m_data_encode_string(PRV_MODEL_NUMBER, dataP);
+        lwm2m_data_encode_string_borrowed(PRV_MODEL_NUMBER, dataP);
         return COAP_205_CONTENT;
 
     case RES_M_REBOOT:
         return COAP_405_METHOD_NOT_ALLOWED;
       
     case RES_M_BINDING_MODES:
-        lwm2m_data_encode_string(PRV_BINDING_MODE, dataP);
+        lwm2m_data_encode_string_borrowed(PRV_BINDING_MODE, dataP);
         return COAP_205_CONTENT;
 
 
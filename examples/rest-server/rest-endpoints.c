@@ -61,52 +61,39 @@ static json_t *endpoint_to_json(lwm2m_client_t *client)
 static json_t *endpoint_resources_to_json(lwm2m_client_t *client)
 {
     lwm2m_client_object_t *obj;
-    lwm2m_list_t *ins;
+    size_t i;
     char buf[20]; // 13 bytes should be enough (i.e. max string "/65535/65535\0")
 
     json_t *jobjects = json_array();
-    for (obj = client->objectList; obj != NULL; obj = obj->next)
+    for (i = 0; i < client->objectCount; i++)
     {
-        if (obj->instanceList == NULL)
+        json_t *jobject;
+
+        obj = client->objects + i;
+        if (obj->instanceId == LWM2M_MAX_ID)
         {
-            snprintf(buf, sizeof(buf), "/%d", obj->id);
-            json_t *jobject = json_object();
-            json_object_set_new(jobject, "uri", json_string(buf));
-            json_array_append_new(jobjects, jobject);
+            snprintf(buf, sizeof(buf), "/%d", obj->objectId);
         }
         else
         {
-            for (ins = obj->instanceList; ins != NULL; ins = ins->next)
-            {
-                snprintf(buf, sizeof(buf), "/%d/%d", obj->id, ins->id);
-                json_t *jobject = json_object();
-                json_object_set_new(jobject, "uri", json_string(buf));
-                json_array_append_new(jobjects, jobject);
-            }
+            snprintf(buf, sizeof(buf), "/%d/%d", obj->objectId, obj->instanceId);
         }
+        jobject = json_object();
+        json_object_set_new(jobject, "uri", json_string(buf));
+        json_array_append_new(jobjects, jobject);
     }
 
     return jobjects;
 }
 
-lwm2m_client_t *rest_endpoints_find_client(lwm2m_client_t *list, const char *name)
+lwm2m_client_t *rest_endpoints_find_client(lwm2m_client_store_t *store, const char *name)
 {
-    lwm2m_client_t *client;
-
     if (name == NULL)
     {
         return NULL;
     }
 
-    for (client = list; client != NULL; client = client->next)
-    {
-        if (strcmp(client->name, name) == 0)
-        {
-            return client;
-        }
-    }
-
-    return NULL;
+    return store->findNameFunc(name, strlen(name), store);
 }
 
 int rest_endpoints_cb(const ulfius_req_t *req, ulfius_resp_t *resp, void *context)
@@ -117,7 +104,9 @@ int rest_endpoints_cb(const ulfius_req_t *req, ulfius_resp_t *resp, void *contex
     rest_lock(rest);
 
     json_t *jclients = json_array();
-    for (client = rest->lwm2m->clientList; client != NULL; client = client->next)
+    for (client = rest->lwm2m->clientStore->nextClientFunc(NULL, rest->lwm2m->clientStore);
+         client != NULL;
+         client = rest->lwm2m->clientStore->nextClientFunc(client, rest->lwm2m->clientStore))
     {
         json_array_append_new(jclients, endpoint_to_json(client));
     }
@@ -139,7 +128,7 @@ int rest_endpoints_name_cb(const ulfius_req_t *req, ulfius_resp_t *resp, void *c
 
     rest_lock(rest);
 
-    client = rest_endpoints_find_client(rest->lwm2m->clientList, name);
+    client = rest_endpoints_find_client(rest->lwm2m->clientStore, name);
 
     if (client == NULL)
     {
@@ -56,6 +56,16 @@ static int http_to_coap_format(const char *type)
         return LWM2M_CONTENT_JSON;
     }
 
+    if (strcmp(type, "application/senml+cbor") == 0)
+    {
+        return LWM2M_CONTENT_SENML_CBOR;
+    }
+
+    if (strcmp(type, "application/cbor") == 0)
+    {
+        return LWM2M_CONTENT_CBOR;
+    }
+
     if (strcmp(type, "application/octet-stream") == 0)
     {
         return LWM2M_CONTENT_OPAQUE;
@@ -172,7 +182,7 @@ static int rest_resources_rwe_cb_unsafe(rest_context_t *rest,
 
     /* Find requested client */
     name = u_map_get(req->map_url, "name");
-    client = rest_endpoints_find_client(rest->lwm2m->clientList, name);
+    client = rest_endpoints_find_client(rest->lwm2m->clientStore, name);
     if (client == NULL)
     {
         ulfius_set_empty_body_response(resp, 410);
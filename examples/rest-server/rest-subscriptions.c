@@ -98,7 +98,7 @@ static int rest_subscriptions_put_cb_unsafe(rest_context_t *rest,
 
     /* Find requested client */
     name = u_map_get(req->map_url, "name");
-    client = rest_endpoints_find_client(rest->lwm2m->clientList, name);
+    client = rest_endpoints_find_client(rest->lwm2m->clientStore, name);
     if (client == NULL)
     {
         ulfius_set_empty_body_response(resp, 404);
@@ -236,7 +236,7 @@ static int rest_subscriptions_delete_cb_unsafe(rest_context_t *rest,
 
     /* Find requested client */
     name = u_map_get(req->map_url, "name");
-    client = rest_endpoints_find_client(rest->lwm2m->clientList, name);
+    client = rest_endpoints_find_client(rest->lwm2m->clientStore, name);
     if (client == NULL)
     {
         ulfius_set_empty_body_response(resp, 404);
@@ -132,10 +132,9 @@ void client_monitor_cb(uint16_t clientID, lwm2m_uri_t *uriP, int status,
     rest_context_t *rest = (rest_context_t *)userData;
     lwm2m_context_t *lwm2m = rest->lwm2m;
     lwm2m_client_t *client;
-    lwm2m_client_object_t *obj;
-    lwm2m_list_t *ins;
+    size_t i;
 
-    client = (lwm2m_client_t *)lwm2m_list_find((lwm2m_list_t *)lwm2m->clientList, clientID);
+    client = lwm2m->clientStore->findClientFunc(clientID, lwm2m->clientStore);
 
     switch (status)
     {
@@ -178,18 +177,15 @@ void client_monitor_cb(uint16_t clientID, lwm2m_uri_t *uriP, int status,
         log_message(LOG_LEVEL_DEBUG, "\tbind: '%s'\n", binding_to_string(client->binding));
         log_message(LOG_LEVEL_DEBUG, "\tlifetime: %d\n", client->lifetime);
         log_message(LOG_LEVEL_DEBUG, "\tobjects: ");
-        for (obj = client->objectList; obj != NULL; obj = obj->next)
+        for (i = 0; i < client->objectCount; i++)
         {
-            if (obj->instanceList == NULL)
+            if (client->objects[i].instanceId == LWM2M_MAX_ID)
             {
-                log_message(LOG_LEVEL_DEBUG, "/%d, ", obj->id);
+                log_message(LOG_LEVEL_DEBUG, "/%d, ", client->objects[i].objectId);
             }
             else
             {
-                for (ins = obj->instanceList; ins != NULL; ins = ins->next)
-                {
-                    log_message(LOG_LEVEL_DEBUG, "/%d/%d, ", obj->id, ins->id);
-                }
+                log_message(LOG_LEVEL_DEBUG, "/%d/%d, ", client->objects[i].objectId, client->objects[i].instanceId);
             }
         }
         log_message(LOG_LEVEL_DEBUG, "\n");
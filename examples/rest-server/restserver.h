@@ -59,7 +59,7 @@ typedef struct
     rest_list_t *observeList;
 } rest_context_t;
 
-lwm2m_client_t *rest_endpoints_find_client(lwm2m_client_t *list, const char *name);
+lwm2m_client_t *rest_endpoints_find_client(lwm2m_client_store_t *store, const char *name);
 
 int rest_endpoints_cb(const ulfius_req_t *req, ulfius_resp_t *resp, void *context);
 
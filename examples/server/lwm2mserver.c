@@ -69,6 +69,8 @@
 #include <errno.h>
 #include <signal.h>
 #include <inttypes.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 
 #include "commandline.h"
 #include "connection.h"
@@ -77,6 +79,15 @@
 
 static int g_quit = 0;
 
+// Given to lwm2m_init(): the connections of the clients are restored from the registration store
+typedef struct
+{
+    int            sock;
+    connection_t * connList;
+    const char *   storePath;
+    int            storeFd;
+} server_data_t;
+
 static void prv_print_error(uint8_t status)
 {
     fprintf(stdout, "Error: ");
@@ -109,7 +120,7 @@ static char * prv_dump_binding(lwm2m_binding_t binding)
 
 static void prv_dump_client(lwm2m_client_t * targetP)
 {
-    lwm2m_client_object_t * objectP;
+    size_t i;
 
     fprintf(stdout, "Client #%d:\r\n", targetP->internalID);
     fprintf(stdout, "\tname: \"%s\"\r\n", targetP->name);
@@ -118,20 +129,15 @@ static void prv_dump_client(lwm2m_client_t * targetP)
     if (targetP->altPath) fprintf(stdout, "\talternative path: \"%s\"\r\n", targetP->altPath);
     fprintf(stdout, "\tlifetime: %d sec\r\n", targetP->lifetime);
     fprintf(stdout, "\tobjects: ");
-    for (objectP = targetP->objectList; objectP != NULL ; objectP = objectP->next)
+    for (i = 0 ; i < targetP->objectCount ; i++)
     {
-        if (objectP->instanceList == NULL)
+        if (targetP->objects[i].instanceId == LWM2M_MAX_ID)
         {
-            fprintf(stdout, "/%d, ", objectP->id);
+            fprintf(stdout, "/%d, ", targetP->objects[i].objectId);
         }
         else
         {
-            lwm2m_list_t * instanceP;
-
-            for (instanceP = objectP->instanceList; instanceP != NULL ; instanceP = instanceP->next)
-            {
-                fprintf(stdout, "/%d/%d, ", objectP->id, instanceP->id);
-            }
+            fprintf(stdout, "/%d/%d, ", targetP->objects[i].objectId, targetP->objects[i].instanceId);
         }
     }
     fprintf(stdout, "\r\n");
@@ -141,9 +147,10 @@ static void prv_output_clients(char * buffer,
                                void * user_data)
 {
     lwm2m_context_t * lwm2mH = (lwm2m_context_t *) user_data;
+    lwm2m_client_store_t * storeP = lwm2mH->clientStore;
     lwm2m_client_t * targetP;
 
-    targetP = lwm2mH->clientList;
+    targetP = storeP->nextClientFunc(NULL, storeP);
 
     if (targetP == NULL)
     {
@@ -151,7 +158,7 @@ static void prv_output_clients(char * buffer,
         return;
     }
 
-    for (targetP = lwm2mH->clientList ; targetP != NULL ; targetP = targetP->next)
+    for ( ; targetP != NULL ; targetP = storeP->nextClientFunc(targetP, storeP))
     {
         prv_dump_client(targetP);
     }
@@ -188,13 +195,21 @@ static void prv_result_callback(uint16_t clientID,
                                 int dataLength,
                                 void * userData)
 {
-    fprintf(stdout, "\r\nClient #%d /%d", clientID, uriP->objectId);
-    if (LWM2M_URI_IS_SET_INSTANCE(uriP))
-        fprintf(stdout, "/%d", uriP->instanceId);
-    else if (LWM2M_URI_IS_SET_RESOURCE(uriP))
-        fprintf(stdout, "/");
-    if (LWM2M_URI_IS_SET_RESOURCE(uriP))
-            fprintf(stdout, "/%d", uriP->resourceId);
+    if (uriP == NULL)
+    {
+        // composite operation
+        fprintf(stdout, "\r\nClient #%d /", clientID);
+    }
+    else
+    {
+        fprintf(stdout, "\r\nClient #%d /%d", clientID, uriP->objectId);
+        if (LWM2M_URI_IS_SET_INSTANCE(uriP))
+            fprintf(stdout, "/%d", uriP->instanceId);
+        else if (LWM2M_URI_IS_SET_RESOURCE(uriP))
+            fprintf(stdout, "/");
+        if (LWM2M_URI_IS_SET_RESOURCE(uriP))
+                fprintf(stdout, "/%d", uriP->resourceId);
+    }
     fprintf(stdout, " : ");
     print_status(stdout, status);
     fprintf(stdout, "\r\n");
@@ -228,6 +243,26 @@ static void prv_notify_callback(uint16_t clientID,
     fflush(stdout);
 }
 
+static void prv_data_push_callback(uint16_t clientID,
+                                   lwm2m_uri_t * uriP,
+                                   int status,
+                                   lwm2m_media_type_t format,
+                                   uint8_t * data,
+                                   int dataLength,
+                                   void * userData)
+{
+    (void)uriP;
+    (void)status;
+    (void)userData;
+
+    fprintf(stdout, "\r\nData pushed by client #%d\r\n", clientID);
+
+    output_data(stdout, format, data, dataLength, 1);
+
+    fprintf(stdout, "\r\n> ");
+    fflush(stdout);
+}
+
 static void prv_read_client(char * buffer,
                             void * user_data)
 {
@@ -264,6 +299,53 @@ syntax_error:
     fprintf(stdout, "Syntax error !");
 }
 
+#ifdef LWM2M_SUPPORT_CBOR
+#define MAX_COMPOSITE_URIS 8
+
+static void prv_read_composite_client(char * buffer,
+                                      void * user_data)
+{
+    lwm2m_context_t * lwm2mH = (lwm2m_context_t *) user_data;
+    uint16_t clientId;
+    lwm2m_uri_t uris[MAX_COMPOSITE_URIS];
+    int count;
+    char* end = NULL;
+    int result;
+
+    result = prv_read_id(buffer, &clientId);
+    if (result != 1) goto syntax_error;
+
+    count = 0;
+    buffer = get_next_arg(buffer, &end);
+    while (buffer[0] != 0)
+    {
+        if (count == MAX_COMPOSITE_URIS) goto syntax_error;
+
+        result = lwm2m_stringToUri(buffer, end - buffer, uris + count);
+        if (result == 0) goto syntax_error;
+        count++;
+
+        buffer = get_next_arg(end, &end);
+    }
+    if (count == 0) goto syntax_error;
+
+    result = lwm2m_dm_read_composite(lwm2mH, clientId, uris, count, prv_result_callback, NULL);
+
+    if (result == 0)
+    {
+        fprintf(stdout, "OK");
+    }
+    else
+    {
+        prv_print_error(result);
+    }
+    return;
+
+syntax_error:
+    fprintf(stdout, "Syntax error !");
+}
+#endif
+
 static void prv_discover_client(char * buffer,
                                 void * user_data)
 {
@@ -753,7 +835,7 @@ static void prv_monitor_callback(uint16_t clientID,
     case COAP_201_CREATED:
         fprintf(stdout, "\r\nNew client #%d registered.\r\n", clientID);
 
-        targetP = (lwm2m_client_t *)lwm2m_list_find((lwm2m_list_t *)lwm2mH->clientList, clientID);
+        targetP = lwm2mH->clientStore->findClientFunc(clientID, lwm2mH->clientStore);
 
         prv_dump_client(targetP);
         break;
@@ -765,7 +847,7 @@ static void prv_monitor_callback(uint16_t clientID,
     case COAP_204_CHANGED:
         fprintf(stdout, "\r\nClient #%d updated.\r\n", clientID);
 
-        targetP = (lwm2m_client_t *)lwm2m_list_find((lwm2m_list_t *)lwm2mH->clientList, clientID);
+        targetP = lwm2mH->clientStore->findClientFunc(clientID, lwm2mH->clientStore);
 
         prv_dump_client(targetP);
         break;
@@ -786,6 +868,167 @@ static void prv_quit(char * buffer,
     g_quit = 1;
 }
 
+#ifdef LWM2M_REGISTRATION_STORE
+int lwm2m_store_open(uint8_t ** bufferP,
+                     size_t * lengthP,
+                     void * userData)
+{
+    server_data_t * dataP = (server_data_t *)userData;
+    struct stat fileStat;
+    void * mapP;
+
+    *bufferP = NULL;
+    *lengthP = 0;
+    if (dataP->storePath == NULL) return 0;
+
+    dataP->storeFd = open(dataP->storePath, O_RDWR | O_CREAT | O_APPEND, 0600);
+    if (dataP->storeFd < 0) return -1;
+    if (fstat(dataP->storeFd, &fileStat) != 0) return -1;
+    if (fileStat.st_size == 0) return 0;
+
+    mapP = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, dataP->storeFd, 0);
+    if (mapP == MAP_FAILED) return -1;
+    *bufferP = (uint8_t *)mapP;
+    *lengthP = fileStat.st_size;
+
+    return 0;
+}
+
+void lwm2m_store_close(uint8_t * buffer,
+                       size_t length,
+                       void * userData)
+{
+    (void)userData;
+
+    if (buffer != NULL)
+    {
+        munmap(buffer, length);
+    }
+}
+
+int lwm2m_store_append(uint8_t * buffer,
+                       size_t length,
+                       void * userData)
+{
+    server_data_t * dataP = (server_data_t *)userData;
+
+    if (dataP->storeFd < 0) return 0;
+
+    return write(dataP->storeFd, buffer, length) == (ssize_t)length ? 0 : -1;
+}
+
+// The new content is written to a temporary file renamed over the log
+int lwm2m_store_replace(uint8_t * buffer,
+                        size_t length,
+                        void * userData)
+{
+    server_data_t * dataP = (server_data_t *)userData;
+    char path[256];
+    int fd;
+
+    if (dataP->storeFd < 0) return 0;
+    if (snprintf(path, sizeof(path), "%s.tmp", dataP->storePath) >= (int)sizeof(path)) return -1;
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) return -1;
+    if (write(fd, buffer, length) != (ssize_t)length
+     || fsync(fd) != 0)
+    {
+        close(fd);
+        unlink(path);
+        return -1;
+    }
+    close(fd);
+    if (rename(path, dataP->storePath) != 0)
+    {
+        unlink(path);
+        return -1;
+    }
+
+    close(dataP->storeFd);
+    dataP->storeFd = open(dataP->storePath, O_WRONLY | O_APPEND);
+    if (dataP->storeFd < 0) return -1;
+
+    return 0;
+}
+
+size_t lwm2m_session_save(void * sessionH,
+                          uint8_t * buffer,
+                          size_t length,
+                          void * userData)
+{
+    connection_t * connP = (connection_t *)sessionH;
+
+    (void)userData;
+
+    if (connP->addrLen > length) return 0;
+    memcpy(buffer, &connP->addr, connP->addrLen);
+
+    return connP->addrLen;
+}
+
+void * lwm2m_session_restore(uint8_t * buffer,
+                             size_t length,
+                             void * userData)
+{
+    server_data_t * dataP = (server_data_t *)userData;
+    struct sockaddr_storage addr;
+    connection_t * connP;
+
+    if (length > sizeof(addr)) return NULL;
+    memcpy(&addr, buffer, length);
+
+    connP = connection_find(dataP->connList, &addr, length);
+    if (connP == NULL)
+    {
+        connP = connection_new_incoming(dataP->connList, dataP->sock, (struct sockaddr *)&addr, length);
+        if (connP != NULL)
+        {
+            dataP->connList = connP;
+        }
+    }
+
+    return connP;
+}
+
+// Only the observations made from the command line are kept: they all print the notifications
+int lwm2m_observation_save(lwm2m_result_callback_t callback,
+                           void * callbackData,
+                           uint8_t * buffer,
+                           size_t length,
+                           void * userData)
+{
+    (void)callbackData;
+    (void)buffer;
+    (void)length;
+    (void)userData;
+
+    if (callback != prv_notify_callback) return -1;
+
+    return 0;
+}
+
+bool lwm2m_observation_restore(uint16_t clientID,
+                               lwm2m_uri_t * uriP,
+                               uint8_t * buffer,
+                               size_t length,
+                               lwm2m_result_callback_t * callbackP,
+                               void ** callbackDataP,
+                               void * userData)
+{
+    (void)clientID;
+    (void)uriP;
+    (void)buffer;
+    (void)length;
+    (void)userData;
+
+    *callbackP = prv_notify_callback;
+    *callbackDataP = NULL;
+
+    return true;
+}
+#endif
+
 void handle_sigint(int signum)
 {
     g_quit = 2;
@@ -798,6 +1041,9 @@ void print_usage(void)
     fprintf(stdout, "Options:\r\n");
     fprintf(stdout, "  -4\t\tUse IPv4 connection. Default: IPv6 connection\r\n");
     fprintf(stdout, "  -l PORT\tSet the local UDP port of the Server. Default: "LWM2M_STANDARD_PORT_STR"\r\n");
+#ifdef LWM2M_REGISTRATION_STORE
+    fprintf(stdout, "  -s FILE\tKeep the registrations of the clients in FILE across restarts.\r\n");
+#endif
     fprintf(stdout, "\r\n");
 }
 
@@ -810,11 +1056,14 @@ int main(int argc, char *argv[])
     int result;
     lwm2m_context_t * lwm2mH = NULL;
     int i;
-    connection_t * connList = NULL;
+    server_data_t data;
     int addressFamily = AF_INET6;
     int opt;
     const char * localPort = LWM2M_STANDARD_PORT_STR;
 
+    memset(&data, 0, sizeof(server_data_t));
+    data.storeFd = -1;
+
     command_desc_t commands[] =
     {
             {"list", "List registered clients.", NULL, prv_output_clients, NULL},
@@ -822,6 +1071,12 @@ int main(int argc, char *argv[])
                                             "   CLIENT#: client number as returned by command 'list'\r\n"
                                             "   URI: uri to read such as /3, /3/0/2, /1024/11, /1024/0/1\r\n"
                                             "Result will be displayed asynchronously.", prv_read_client, NULL},
+#ifdef LWM2M_SUPPORT_CBOR
+            {"readc", "Read several URIs from a client in a single request.", " readc CLIENT# URI [URI...]\r\n"
+                                            "   CLIENT#: client number as returned by command 'list'\r\n"
+                                            "   URI: up to 8 uris to read such as /3/0/0 /1024/11 /4\r\n"
+                                            "Result will be displayed asynchronously.", prv_read_composite_client, NULL},
+#endif
             {"disc", "Discover resources of a client.", " disc CLIENT# URI\r\n"
                                             "   CLIENT#: client number as returned by command 'list'\r\n"
                                             "   URI: uri to discover such as /3, /3/0/2, /1024/11, /1024/0/1\r\n"
@@ -899,6 +1154,17 @@ int main(int argc, char *argv[])
             }
             localPort = argv[opt];
             break;
+#ifdef LWM2M_REGISTRATION_STORE
+        case 's':
+            opt++;
+            if (opt >= argc)
+            {
+                print_usage();
+                return 0;
+            }
+            data.storePath = argv[opt];
+            break;
+#endif
         default:
             print_usage();
             return 0;
@@ -912,8 +1178,9 @@ int main(int argc, char *argv[])
         fprintf(stderr, "Error opening socket: %d\r\n", errno);
         return -1;
     }
+    data.sock = sock;
 
-    lwm2mH = lwm2m_init(NULL);
+    lwm2mH = lwm2m_init(&data);
     if (NULL == lwm2mH)
     {
         fprintf(stderr, "lwm2m_init() failed\r\n");
@@ -929,6 +1196,7 @@ int main(int argc, char *argv[])
     fprintf(stdout, "> "); fflush(stdout);
 
     lwm2m_set_monitoring_callback(lwm2mH, prv_monitor_callback, lwm2mH);
+    lwm2m_set_data_push_callback(lwm2mH, prv_data_push_callback, NULL);
 
     while (0 == g_quit)
     {
@@ -995,13 +1263,13 @@ int main(int argc, char *argv[])
                     fprintf(stderr, "%d bytes received from [%s]:%hu\r\n", numBytes, s, ntohs(port));
                     output_buffer(stderr, buffer, numBytes, 0);
 
-                    connP = connection_find(connList, &addr, addrLen);
+                    connP = connection_find(data.connList, &addr, addrLen);
                     if (connP == NULL)
                     {
-                        connP = connection_new_incoming(connList, sock, (struct sockaddr *)&addr, addrLen);
+                        connP = connection_new_incoming(data.connList, sock, (struct sockaddr *)&addr, addrLen);
                         if (connP != NULL)
                         {
-                            connList = connP;
+                            data.connList = connP;
                         }
                     }
                     if (connP != NULL)
@@ -1035,7 +1303,11 @@ int main(int argc, char *argv[])
 
     lwm2m_close(lwm2mH);
     close(sock);
-    connection_free(connList);
+    connection_free(data.connList);
+    if (data.storeFd >= 0)
+    {
+        close(data.storeFd);
+    }
 
 #ifdef MEMORY_TRACE
     if (g_quit == 1)
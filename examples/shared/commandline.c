@@ -331,6 +331,30 @@ void output_data(FILE * stream,
         fprintf(stream, "\n");
         break;
 
+    case LWM2M_CONTENT_CBOR:
+        fprintf(stream, "application/cbor:\r\n");
+        output_buffer(stream, data, dataLength, indent);
+        break;
+
+    case LWM2M_CONTENT_SENML_CBOR:
+    {
+        lwm2m_data_t * dataP;
+        int size;
+
+        fprintf(stream, "application/senml+cbor:\r\n");
+        size = lwm2m_data_parse(NULL, data, dataLength, format, &dataP);
+        if (size > 0)
+        {
+            dump_tlv(stream, size, dataP, indent);
+            lwm2m_data_free(size, dataP);
+        }
+        else
+        {
+            output_buffer(stream, data, dataLength, indent);
+        }
+        break;
+    }
+
     case LWM2M_CONTENT_LINK:
         fprintf(stream, "application/link-format:\r\n");
         print_indent(stream, indent);
@@ -354,6 +378,8 @@ void dump_tlv(FILE * stream,
               int indent)
 {
     int i;
+    uint8_t * buffer;
+    size_t length;
 
     for(i= 0 ; i < size ; i++)
     {
@@ -384,11 +410,13 @@ void dump_tlv(FILE * stream,
         case LWM2M_TYPE_STRING:
             fprintf(stream, "LWM2M_TYPE_STRING\r\n");
             print_indent(stream, indent + 1);
-            fprintf(stream, "\"%.*s\"\r\n", (int)dataP[i].value.asBuffer.length, dataP[i].value.asBuffer.buffer);
+            buffer = lwm2m_data_get_buffer(dataP + i, &length);
+            fprintf(stream, "\"%.*s\"\r\n", (int)length, buffer);
             break;
         case LWM2M_TYPE_OPAQUE:
             fprintf(stream, "LWM2M_TYPE_OPAQUE\r\n");
-            output_buffer(stream, dataP[i].value.asBuffer.buffer, dataP[i].value.asBuffer.length, indent + 1);
+            buffer = lwm2m_data_get_buffer(dataP + i, &length);
+            output_buffer(stream, buffer, (int)length, indent + 1);
             break;
         case LWM2M_TYPE_INTEGER:
             fprintf(stream, "LWM2M_TYPE_INTEGER: ");
@@ -36,12 +36,14 @@ char * security_get_uri(lwm2m_object_t * obj, int instanceId, char * uriBuffer,
 
     obj->readFunc(instanceId, &size, &dataP, obj);
     if (dataP != NULL &&
-            dataP->type == LWM2M_TYPE_STRING &&
-            dataP->value.asBuffer.length > 0)
+            dataP->type == LWM2M_TYPE_STRING)
     {
-        if (bufferSize > dataP->value.asBuffer.length){
-            memset(uriBuffer,0,dataP->value.asBuffer.length+1);
-            strncpy(uriBuffer,dataP->value.asBuffer.buffer,dataP->value.asBuffer.length);
+        size_t length;
+        uint8_t * buffer = lwm2m_data_get_buffer(dataP, &length);
+
+        if (length > 0 && bufferSize > length){
+            memset(uriBuffer,0,length+1);
+            strncpy(uriBuffer,(char *)buffer,length);
             lwm2m_data_free(size, dataP);
             return uriBuffer;
         }
@@ -78,12 +80,14 @@ char * security_get_public_id(lwm2m_object_t * obj, int instanceId, int * length
         dataP->type == LWM2M_TYPE_OPAQUE)
     {
         char * buff;
+        size_t valueLength;
+        uint8_t * value = lwm2m_data_get_buffer(dataP, &valueLength);
 
-        buff = (char*)lwm2m_malloc(dataP->value.asBuffer.length);
+        buff = (char*)lwm2m_malloc(valueLength);
         if (buff != 0)
         {
-            memcpy(buff, dataP->value.asBuffer.buffer, dataP->value.asBuffer.length);
-            *length = dataP->value.asBuffer.length;
+            memcpy(buff, value, valueLength);
+            *length = valueLength;
         }
         lwm2m_data_free(size, dataP);
 
@@ -104,12 +108,14 @@ char * security_get_secret_key(lwm2m_object_t * obj, int instanceId, int * lengt
         dataP->type == LWM2M_TYPE_OPAQUE)
     {
         char * buff;
+        size_t valueLength;
+        uint8_t * value = lwm2m_data_get_buffer(dataP, &valueLength);
 
-        buff = (char*)lwm2m_malloc(dataP->value.asBuffer.length);
+        buff = (char*)lwm2m_malloc(valueLength);
         if (buff != 0)
         {
-            memcpy(buff, dataP->value.asBuffer.buffer, dataP->value.asBuffer.length);
-            *length = dataP->value.asBuffer.length;
+            memcpy(buff, value, valueLength);
+            *length = valueLength;
         }
         lwm2m_data_free(size, dataP);
 
@@ -0,0 +1,153 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "filejournal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+void file_journal_init(file_journal_t * journalP,
+                       const char * path)
+{
+    memset(journalP, 0, sizeof(file_journal_t));
+    journalP->path = path;
+    journalP->fd = -1;
+}
+
+void file_journal_free(file_journal_t * journalP)
+{
+    if (journalP->fd >= 0)
+    {
+        close(journalP->fd);
+        journalP->fd = -1;
+    }
+    free(journalP->data);
+    journalP->data = NULL;
+    journalP->length = 0;
+}
+
+int file_journal_open(file_journal_t * journalP,
+                      uint8_t ** bufferP,
+                      size_t * lengthP)
+{
+    struct stat fileStat;
+    void * mapP;
+
+    *bufferP = journalP->data;
+    *lengthP = journalP->length;
+    if (journalP->path == NULL) return 0;
+
+    *bufferP = NULL;
+    *lengthP = 0;
+    if (journalP->fd < 0)
+    {
+        journalP->fd = open(journalP->path, O_RDWR | O_CREAT | O_APPEND, 0600);
+        if (journalP->fd < 0) return -1;
+    }
+    if (fstat(journalP->fd, &fileStat) != 0) return -1;
+    if (fileStat.st_size == 0) return 0;
+
+    mapP = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, journalP->fd, 0);
+    if (mapP == MAP_FAILED) return -1;
+    *bufferP = (uint8_t *)mapP;
+    *lengthP = fileStat.st_size;
+
+    return 0;
+}
+
+void file_journal_close(file_journal_t * journalP,
+                        uint8_t * buffer,
+                        size_t length)
+{
+    if (journalP->path != NULL && buffer != NULL)
+    {
+        munmap(buffer, length);
+    }
+}
+
+// Each record is made durable before the change is acknowledged to the server
+int file_journal_append(file_journal_t * journalP,
+                        uint8_t * buffer,
+                        size_t length)
+{
+    if (journalP->path == NULL)
+    {
+        uint8_t * data;
+
+        data = (uint8_t *)realloc(journalP->data, journalP->length + length);
+        if (data == NULL) return -1;
+        memcpy(data + journalP->length, buffer, length);
+        journalP->data = data;
+        journalP->length += length;
+        return 0;
+    }
+    if (journalP->fd < 0) return -1;
+    if (write(journalP->fd, buffer, length) != (ssize_t)length) return -1;
+
+    return fdatasync(journalP->fd) == 0 ? 0 : -1;
+}
+
+// The new content is written to a temporary file renamed over the journal
+int file_journal_replace(file_journal_t * journalP,
+                         uint8_t * buffer,
+                         size_t length)
+{
+    char path[256];
+    int fd;
+
+    if (journalP->path == NULL)
+    {
+        uint8_t * data;
+
+        data = (uint8_t *)malloc(length > 0 ? length : 1);
+        if (data == NULL) return -1;
+        memcpy(data, buffer, length);
+        free(journalP->data);
+        journalP->data = data;
+        journalP->length = length;
+        return 0;
+    }
+    if (snprintf(path, sizeof(path), "%s.tmp", journalP->path) >= (int)sizeof(path)) return -1;
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) return -1;
+    if (write(fd, buffer, length) != (ssize_t)length
+     || fsync(fd) != 0)
+    {
+        close(fd);
+        unlink(path);
+        return -1;
+    }
+    close(fd);
+    if (rename(path, journalP->path) != 0)
+    {
+        unlink(path);
+        return -1;
+    }
+
+    // reopened for reading too: the next file_journal_open() maps it
+    if (journalP->fd >= 0) close(journalP->fd);
+    journalP->fd = open(journalP->path, O_RDWR | O_APPEND);
+    if (journalP->fd < 0) return -1;
+
+    return 0;
+}
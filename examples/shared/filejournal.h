@@ -0,0 +1,45 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#ifndef FILEJOURNAL_H_
+#define FILEJOURNAL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Storage of the objects journal for the lwm2m_journal_*() platform functions:
+ * a file, mapped to be read and synced on each append, or a memory buffer.
+ */
+
+typedef struct
+{
+    const char * path;      // NULL to keep the journal in memory
+    int          fd;
+    uint8_t *    data;      // in memory journal
+    size_t       length;
+} file_journal_t;
+
+void file_journal_init(file_journal_t * journalP, const char * path);
+void file_journal_free(file_journal_t * journalP);
+
+int file_journal_open(file_journal_t * journalP, uint8_t ** bufferP, size_t * lengthP);
+void file_journal_close(file_journal_t * journalP, uint8_t * buffer, size_t length);
+int file_journal_append(file_journal_t * journalP, uint8_t * buffer, size_t length);
+int file_journal_replace(file_journal_t * journalP, uint8_t * buffer, size_t length);
+
+#endif
@@ -0,0 +1,353 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "tests.h"
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "liblwm2m.h"
+#include "memtest.h"
+
+#define ACL_INSTANCE_COUNT  3
+// room for an instance created by prv_aclCreate()
+#define ACL_INSTANCE_MAX    (ACL_INSTANCE_COUNT + 1)
+
+typedef struct
+{
+    uint16_t objectId;
+    uint16_t instanceId;
+    uint16_t owner;
+    uint16_t serverId;  // of the single ACL entry
+    uint8_t  rights;
+} acl_instance_t;
+
+static acl_instance_t aclInstances[ACL_INSTANCE_MAX];
+static lwm2m_list_t aclCreated;
+
+// Access Control Object reading the instances from aclInstances
+static uint8_t prv_aclRead(uint16_t instanceId,
+                           int * numDataP,
+                           lwm2m_data_t ** dataArrayP,
+                           lwm2m_object_t * objectP)
+{
+    acl_instance_t * instanceP;
+    lwm2m_data_t * subP;
+
+    if (NULL == lwm2m_list_find(objectP->instanceList, instanceId)) return COAP_404_NOT_FOUND;
+    instanceP = aclInstances + instanceId;
+
+    *dataArrayP = lwm2m_data_new(4);
+    if (*dataArrayP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+    *numDataP = 4;
+    (*dataArrayP)[0].id = 0;
+    lwm2m_data_encode_int(instanceP->objectId, *dataArrayP);
+    (*dataArrayP)[1].id = 1;
+    lwm2m_data_encode_int(instanceP->instanceId, *dataArrayP + 1);
+    subP = lwm2m_data_new(1);
+    if (subP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+    subP->id = instanceP->serverId;
+    lwm2m_data_encode_int(instanceP->rights, subP);
+    (*dataArrayP)[2].id = 2;
+    lwm2m_data_encode_instances(subP, 1, *dataArrayP + 2);
+    (*dataArrayP)[3].id = 3;
+    lwm2m_data_encode_int(instanceP->owner, *dataArrayP + 3);
+
+    return COAP_205_CONTENT;
+}
+
+static uint8_t prv_aclCreate(uint16_t instanceId,
+                             int numData,
+                             lwm2m_data_t * dataArray,
+                             lwm2m_object_t * objectP)
+{
+    acl_instance_t * instanceP;
+    int64_t value;
+    int i;
+
+    if (instanceId != ACL_INSTANCE_COUNT) return COAP_500_INTERNAL_SERVER_ERROR;
+    instanceP = aclInstances + instanceId;
+    memset(instanceP, 0, sizeof(acl_instance_t));
+    for (i = 0 ; i < numData ; i++)
+    {
+        if (1 != lwm2m_data_decode_int(dataArray + i, &value)) return COAP_400_BAD_REQUEST;
+        switch (dataArray[i].id)
+        {
+        case 0:
+            instanceP->objectId = (uint16_t)value;
+            break;
+        case 1:
+            instanceP->instanceId = (uint16_t)value;
+            break;
+        case 3:
+            instanceP->owner = (uint16_t)value;
+            break;
+        default:
+            return COAP_400_BAD_REQUEST;
+        }
+    }
+    aclCreated.id = instanceId;
+    aclCreated.next = NULL;
+    objectP->instanceList = LWM2M_LIST_ADD(objectP->instanceList, &aclCreated);
+
+    return COAP_201_CREATED;
+}
+
+static int writeCount;
+
+static uint8_t prv_write(uint16_t instanceId,
+                         int numData,
+                         lwm2m_data_t * dataArray,
+                         lwm2m_object_t * objectP)
+{
+    (void)instanceId;
+    (void)numData;
+    (void)dataArray;
+    (void)objectP;
+
+    writeCount++;
+
+    return COAP_204_CHANGED;
+}
+
+static void prv_setUri(lwm2m_uri_t * uriP,
+                       int objectId,
+                       int instanceId)
+{
+    memset(uriP, 0, sizeof(lwm2m_uri_t));
+    uriP->objectId = (uint16_t)objectId;
+    uriP->flag = LWM2M_URI_FLAG_OBJECT_ID;
+    if (instanceId >= 0)
+    {
+        uriP->instanceId = (uint16_t)instanceId;
+        uriP->flag |= LWM2M_URI_FLAG_INSTANCE_ID;
+    }
+}
+
+// Two servers with short IDs 1 and 2, an Access Control Object and an object 1024 with two instances
+typedef struct
+{
+    lwm2m_context_t context;
+    lwm2m_server_t  servers[2];
+    lwm2m_object_t  objects[2];
+    lwm2m_list_t    aclList[ACL_INSTANCE_COUNT];
+    lwm2m_list_t    instances[2];
+} acl_setup_t;
+
+static void prv_setup(acl_setup_t * setupP)
+{
+    int i;
+
+    memset(setupP, 0, sizeof(acl_setup_t));
+    setupP->servers[0].shortID = 1;
+    setupP->servers[0].next = setupP->servers + 1;
+    setupP->servers[1].shortID = 2;
+    setupP->context.serverList = setupP->servers;
+
+    for (i = 0 ; i < ACL_INSTANCE_COUNT ; i++)
+    {
+        setupP->aclList[i].id = (uint16_t)i;
+        setupP->aclList[i].next = (i + 1 < ACL_INSTANCE_COUNT) ? setupP->aclList + i + 1 : NULL;
+    }
+    setupP->instances[0].id = 0;
+    setupP->instances[0].next = setupP->instances + 1;
+    setupP->instances[1].id = 1;
+
+    setupP->objects[0].objID = LWM2M_ACL_OBJECT_ID;
+    setupP->objects[0].instanceList = setupP->aclList;
+    setupP->objects[0].readFunc = prv_aclRead;
+    setupP->objects[0].next = setupP->objects + 1;
+    setupP->objects[1].objID = 1024;
+    setupP->objects[1].instanceList = setupP->instances;
+    setupP->context.objectList = setupP->objects;
+    lwm2m_index_build(&setupP->context.objectIndex, (lwm2m_list_t *)setupP->context.objectList);
+
+    // /1024/0 owned by server 1, readable by server 2
+    aclInstances[0].objectId = 1024;
+    aclInstances[0].instanceId = 0;
+    aclInstances[0].owner = 1;
+    aclInstances[0].serverId = 2;
+    aclInstances[0].rights = ACL_RIGHT_READ;
+    // /1024/1 owned by server 2, readable and writable by default
+    aclInstances[1].objectId = 1024;
+    aclInstances[1].instanceId = 1;
+    aclInstances[1].owner = 2;
+    aclInstances[1].serverId = 0;
+    aclInstances[1].rights = ACL_RIGHT_READ | ACL_RIGHT_WRITE;
+    // instances of 1024 created only by server 1
+    aclInstances[2].objectId = 1024;
+    aclInstances[2].instanceId = LWM2M_MAX_ID;
+    aclInstances[2].owner = 1;
+    aclInstances[2].serverId = 1;
+    aclInstances[2].rights = ACL_RIGHT_CREATE;
+}
+
+static void prv_cleanup(acl_setup_t * setupP)
+{
+    acl_invalidate(&setupP->context);
+    lwm2m_index_clear(&setupP->context.objectIndex);
+}
+
+static void test_acl_rights(void)
+{
+    MEMORY_TRACE_BEFORE;
+    acl_setup_t setup;
+    lwm2m_server_t * server1;
+    lwm2m_server_t * server2;
+    lwm2m_uri_t uri;
+
+    prv_setup(&setup);
+    server1 = setup.servers;
+    server2 = setup.servers + 1;
+
+    // the explicit entry of the server comes before the owner rights
+    prv_setUri(&uri, 1024, 0);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server1, &uri, ACL_RIGHT_WRITE | ACL_RIGHT_DELETE), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server2, &uri, ACL_RIGHT_READ), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server2, &uri, ACL_RIGHT_WRITE), COAP_401_UNAUTHORIZED);
+
+    // the default entry applies to the servers other than the owner
+    prv_setUri(&uri, 1024, 1);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server1, &uri, ACL_RIGHT_WRITE), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server1, &uri, ACL_RIGHT_EXECUTE), COAP_401_UNAUTHORIZED);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server2, &uri, ACL_RIGHT_EXECUTE), COAP_NO_ERROR);
+
+    // the instances without Access Control Object instance are not accessible
+    prv_setUri(&uri, 1024, 2);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server1, &uri, ACL_RIGHT_READ), COAP_401_UNAUTHORIZED);
+
+    prv_setUri(&uri, 1024, -1);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server1, &uri, ACL_RIGHT_CREATE), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server2, &uri, ACL_RIGHT_CREATE), COAP_401_UNAUTHORIZED);
+    // an operation on the object needs the rights on all the instances
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server2, &uri, ACL_RIGHT_READ), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server2, &uri, ACL_RIGHT_WRITE), COAP_401_UNAUTHORIZED);
+
+    // only the owner modifies an instance of the Access Control Object
+    prv_setUri(&uri, LWM2M_ACL_OBJECT_ID, 0);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server1, &uri, ACL_RIGHT_WRITE), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server2, &uri, ACL_RIGHT_READ), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server2, &uri, ACL_RIGHT_WRITE), COAP_401_UNAUTHORIZED);
+
+    // no access control with a single server
+    setup.context.serverList = server2;
+    prv_setUri(&uri, 1024, 0);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, server2, &uri, ACL_RIGHT_WRITE), COAP_NO_ERROR);
+    setup.context.serverList = server1;
+
+    prv_cleanup(&setup);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_acl_invalidate(void)
+{
+    MEMORY_TRACE_BEFORE;
+    acl_setup_t setup;
+    lwm2m_uri_t uri;
+
+    prv_setup(&setup);
+
+    prv_setUri(&uri, 1024, 0);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, setup.servers + 1, &uri, ACL_RIGHT_WRITE), COAP_401_UNAUTHORIZED);
+    CU_ASSERT_PTR_NOT_NULL(setup.servers[1].acl);
+
+    // the rights are compiled again after a change of the Access Control Object
+    aclInstances[0].rights = ACL_RIGHT_READ | ACL_RIGHT_WRITE;
+    prv_setUri(&uri, LWM2M_ACL_OBJECT_ID, 0);
+    lwm2m_resource_value_changed(&setup.context, &uri);
+    CU_ASSERT_PTR_NULL(setup.servers[1].acl);
+    prv_setUri(&uri, 1024, 0);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, setup.servers + 1, &uri, ACL_RIGHT_WRITE), COAP_NO_ERROR);
+
+    // a change in another object keeps the compiled rights
+    prv_setUri(&uri, 1024, 0);
+    lwm2m_resource_value_changed(&setup.context, &uri);
+    CU_ASSERT_PTR_NOT_NULL(setup.servers[1].acl);
+
+    prv_cleanup(&setup);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_acl_create(void)
+{
+    MEMORY_TRACE_BEFORE;
+    acl_setup_t setup;
+    lwm2m_uri_t uri;
+
+    prv_setup(&setup);
+    setup.objects[0].createFunc = prv_aclCreate;
+
+    // an instance created by a server is owned by this server
+    prv_setUri(&uri, 1024, 2);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, setup.servers, &uri, ACL_RIGHT_READ), COAP_401_UNAUTHORIZED);
+    CU_ASSERT_EQUAL(acl_createInstance(&setup.context, setup.servers, &uri), COAP_NO_ERROR);
+    CU_ASSERT_PTR_NOT_NULL(lwm2m_list_find(setup.objects[0].instanceList, ACL_INSTANCE_COUNT));
+    CU_ASSERT_EQUAL(aclInstances[ACL_INSTANCE_COUNT].owner, 1);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, setup.servers, &uri, ACL_RIGHT_READ | ACL_RIGHT_WRITE | ACL_RIGHT_DELETE), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(acl_checkAccess(&setup.context, setup.servers + 1, &uri, ACL_RIGHT_READ), COAP_401_UNAUTHORIZED);
+    prv_cleanup(&setup);
+
+    // none is needed with a single server
+    prv_setup(&setup);
+    setup.objects[0].createFunc = prv_aclCreate;
+    setup.servers[0].next = NULL;
+    CU_ASSERT_EQUAL(acl_createInstance(&setup.context, setup.servers, &uri), COAP_NO_ERROR);
+    CU_ASSERT_PTR_NULL(lwm2m_list_find(setup.objects[0].instanceList, ACL_INSTANCE_COUNT));
+    prv_cleanup(&setup);
+
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_acl_write_composite(void)
+{
+    MEMORY_TRACE_BEFORE;
+    acl_setup_t setup;
+    // SenML CBOR writing /1024/1/0 then /1024/0/0
+    uint8_t buffer[] = {0x82,
+                        0xA2, 0x00, 0x69, '/', '1', '0', '2', '4', '/', '1', '/', '0', 0x02, 0x01,
+                        0xA2, 0x00, 0x69, '/', '1', '0', '2', '4', '/', '0', '/', '0', 0x02, 0x02};
+
+    prv_setup(&setup);
+    setup.objects[1].writeFunc = prv_write;
+    writeCount = 0;
+
+    // server 2 may not write /1024/0: nothing is written
+    CU_ASSERT_EQUAL(object_writeComposite(&setup.context, setup.servers + 1, LWM2M_CONTENT_SENML_CBOR, buffer, sizeof(buffer)), COAP_401_UNAUTHORIZED);
+    CU_ASSERT_EQUAL(writeCount, 0);
+
+    CU_ASSERT_EQUAL(object_writeComposite(&setup.context, setup.servers, LWM2M_CONTENT_SENML_CBOR, buffer, sizeof(buffer)), COAP_204_CHANGED);
+    CU_ASSERT_EQUAL(writeCount, 2);
+
+    prv_cleanup(&setup);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static struct TestTable table[] = {
+        { "test of the access rights", test_acl_rights },
+        { "test of the access rights update", test_acl_invalidate },
+        { "test of the access control of a created instance", test_acl_create },
+        { "test of the access rights of a Write-Composite", test_acl_write_composite },
+        { NULL, NULL },
+};
+
+CU_ErrorCode create_acl_suit() {
+    CU_pSuite pSuite = NULL;
+    pSuite = CU_add_suite("Suite_acl", NULL, NULL);
+
+    if (NULL == pSuite) {
+        return CU_get_error();
+    }
+    return add_tests(pSuite, table);
+}
@@ -0,0 +1,167 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "tests.h"
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "liblwm2m.h"
+#include "memtest.h"
+
+
+static void prv_setUri(lwm2m_uri_t * uriP,
+                       int objectId,
+                       int instanceId,
+                       int resourceId)
+{
+    memset(uriP, 0, sizeof(lwm2m_uri_t));
+    uriP->objectId = (uint16_t)objectId;
+    uriP->flag = LWM2M_URI_FLAG_OBJECT_ID;
+    if (instanceId >= 0)
+    {
+        uriP->instanceId = (uint16_t)instanceId;
+        uriP->flag |= LWM2M_URI_FLAG_INSTANCE_ID;
+    }
+    if (resourceId >= 0)
+    {
+        uriP->resourceId = (uint16_t)resourceId;
+        uriP->flag |= LWM2M_URI_FLAG_RESOURCE_ID;
+    }
+}
+
+static void test_attributes_inheritance(void)
+{
+    MEMORY_TRACE_BEFORE;
+    lwm2m_server_t server;
+    lwm2m_uri_t uri;
+    lwm2m_attributes_t attr;
+    lwm2m_attributes_t result;
+
+    memset(&server, 0, sizeof(server));
+
+    memset(&attr, 0, sizeof(attr));
+    attr.toSet = LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD;
+    attr.minPeriod = 10;
+    attr.maxPeriod = 60;
+    prv_setUri(&uri, 3, -1, -1);
+    CU_ASSERT_EQUAL(attributes_set(&server, &uri, &attr), COAP_204_CHANGED);
+
+    memset(&attr, 0, sizeof(attr));
+    attr.toSet = LWM2M_ATTR_FLAG_MAX_PERIOD;
+    attr.maxPeriod = 30;
+    prv_setUri(&uri, 3, 0, -1);
+    CU_ASSERT_EQUAL(attributes_set(&server, &uri, &attr), COAP_204_CHANGED);
+
+    memset(&attr, 0, sizeof(attr));
+    attr.toSet = LWM2M_ATTR_FLAG_STEP;
+    attr.step = 2;
+    prv_setUri(&uri, 3, 0, 9);
+    CU_ASSERT_EQUAL(attributes_set(&server, &uri, &attr), COAP_204_CHANGED);
+
+    // the resource inherits the periods from the instance, then from the object
+    CU_ASSERT_TRUE(attributes_resolve(&server, &uri, &result));
+    CU_ASSERT_EQUAL(result.toSet, LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD | LWM2M_ATTR_FLAG_STEP);
+    CU_ASSERT_EQUAL(result.minPeriod, 10);
+    CU_ASSERT_EQUAL(result.maxPeriod, 30);
+
+    // another instance only inherits from the object
+    prv_setUri(&uri, 3, 1, 9);
+    CU_ASSERT_TRUE(attributes_resolve(&server, &uri, &result));
+    CU_ASSERT_EQUAL(result.toSet, LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD);
+    CU_ASSERT_EQUAL(result.maxPeriod, 60);
+    CU_ASSERT_PTR_NULL(attributes_find(&server, &uri));
+
+    prv_setUri(&uri, 4, 0, 9);
+    CU_ASSERT_FALSE(attributes_resolve(&server, &uri, &result));
+
+    attributes_free(&server);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_attributes_update(void)
+{
+    MEMORY_TRACE_BEFORE;
+    lwm2m_context_t context;
+    lwm2m_server_t server;
+    lwm2m_uri_t uri;
+    lwm2m_attributes_t attr;
+    lwm2m_attributes_t * paramP;
+    int i;
+
+    memset(&context, 0, sizeof(context));
+    memset(&server, 0, sizeof(server));
+    context.serverList = &server;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.toSet = LWM2M_ATTR_FLAG_GREATER_THAN | LWM2M_ATTR_FLAG_LESS_THAN;
+    attr.greaterThan = 10;
+    attr.lessThan = 2;
+    prv_setUri(&uri, 3, 0, 7);
+    CU_ASSERT_EQUAL(attributes_set(&server, &uri, &attr), COAP_204_CHANGED);
+
+    // lt + 2 * st must stay below gt
+    memset(&attr, 0, sizeof(attr));
+    attr.toSet = LWM2M_ATTR_FLAG_STEP;
+    attr.step = 4;
+    CU_ASSERT_EQUAL(attributes_set(&server, &uri, &attr), COAP_400_BAD_REQUEST);
+    attr.step = 3;
+    CU_ASSERT_EQUAL(attributes_set(&server, &uri, &attr), COAP_204_CHANGED);
+    paramP = attributes_find(&server, &uri);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(paramP);
+    CU_ASSERT_EQUAL(paramP->toSet, ATTR_FLAG_NUMERIC);
+
+    // clearing all the attributes removes the entry
+    memset(&attr, 0, sizeof(attr));
+    attr.toClear = ATTR_FLAG_NUMERIC;
+    CU_ASSERT_EQUAL(attributes_set(&server, &uri, &attr), COAP_204_CHANGED);
+    CU_ASSERT_PTR_NULL(attributes_find(&server, &uri));
+
+    // deleting an instance removes its attributes and the ones of its resources
+    memset(&attr, 0, sizeof(attr));
+    attr.toSet = LWM2M_ATTR_FLAG_MIN_PERIOD;
+    attr.minPeriod = 5;
+    for (i = 0 ; i < 50 ; i++)
+    {
+        prv_setUri(&uri, 1024, i % 2, i);
+        CU_ASSERT_EQUAL(attributes_set(&server, &uri, &attr), COAP_204_CHANGED);
+    }
+    prv_setUri(&uri, 1024, 0, -1);
+    attributes_remove(&context, &uri);
+    CU_ASSERT_EQUAL(server.attributes->count, 25);
+    prv_setUri(&uri, 1024, 1, 1);
+    CU_ASSERT_PTR_NOT_NULL(attributes_find(&server, &uri));
+    prv_setUri(&uri, 1024, 0, 0);
+    CU_ASSERT_PTR_NULL(attributes_find(&server, &uri));
+
+    attributes_free(&server);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static struct TestTable table[] = {
+        { "test of attributes inheritance", test_attributes_inheritance },
+        { "test of attributes update", test_attributes_update },
+        { NULL, NULL },
+};
+
+CU_ErrorCode create_attributes_suit() {
+    CU_pSuite pSuite = NULL;
+    pSuite = CU_add_suite("Suite_attributes", NULL, NULL);
+
+    if (NULL == pSuite) {
+        return CU_get_error();
+    }
+    return add_tests(pSuite, table);
+}
@@ -0,0 +1,186 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "internals.h"
+#include "benchmark.h"
+
+// Checks the rights of a server on all the instances of an object, each instance having its
+// Access Control Object instance. The compiled rights are compared with a search of the Access
+// Control Object for each check.
+
+#define TARGET_OBJECT_ID    1024
+
+typedef struct
+{
+    int count;
+    lwm2m_context_t context;
+    lwm2m_server_t servers[2];
+    lwm2m_object_t objects[2];
+    lwm2m_list_t * aclList;
+    lwm2m_list_t * instances;
+} acl_benchmark_t;
+
+// Instance i of the Access Control Object gives server 2 the right to read /1024/i
+static uint8_t prv_aclRead(uint16_t instanceId,
+                           int * numDataP,
+                           lwm2m_data_t ** dataArrayP,
+                           lwm2m_object_t * objectP)
+{
+    lwm2m_data_t * subP;
+
+    (void)objectP;
+    *dataArrayP = lwm2m_data_new(4);
+    if (*dataArrayP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+    *numDataP = 4;
+    (*dataArrayP)[0].id = 0;
+    lwm2m_data_encode_int(TARGET_OBJECT_ID, *dataArrayP);
+    (*dataArrayP)[1].id = 1;
+    lwm2m_data_encode_int(instanceId, *dataArrayP + 1);
+    subP = lwm2m_data_new(1);
+    if (subP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+    subP->id = 2;
+    lwm2m_data_encode_int(ACL_RIGHT_READ, subP);
+    (*dataArrayP)[2].id = 2;
+    lwm2m_data_encode_instances(subP, 1, *dataArrayP + 2);
+    (*dataArrayP)[3].id = 3;
+    lwm2m_data_encode_int(1, *dataArrayP + 3);
+
+    return COAP_205_CONTENT;
+}
+
+static int prv_check(void * userData)
+{
+    acl_benchmark_t * benchP = (acl_benchmark_t *)userData;
+    lwm2m_uri_t uri;
+    int result;
+    int i;
+
+    memset(&uri, 0, sizeof(lwm2m_uri_t));
+    uri.objectId = TARGET_OBJECT_ID;
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+    result = 0;
+    for (i = 0 ; i < benchP->count ; i++)
+    {
+        uri.instanceId = (uint16_t)i;
+        if (acl_checkAccess(&benchP->context, benchP->servers + 1, &uri, ACL_RIGHT_READ) == COAP_NO_ERROR) result++;
+    }
+
+    return result;
+}
+
+static int prv_compile(void * userData)
+{
+    acl_benchmark_t * benchP = (acl_benchmark_t *)userData;
+    lwm2m_uri_t uri;
+
+    acl_invalidate(&benchP->context);
+    memset(&uri, 0, sizeof(lwm2m_uri_t));
+    uri.objectId = TARGET_OBJECT_ID;
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+
+    return acl_checkAccess(&benchP->context, benchP->servers + 1, &uri, ACL_RIGHT_READ);
+}
+
+// Read the Access Control Object instances until the one of the target instance
+static int prv_search(void * userData)
+{
+    acl_benchmark_t * benchP = (acl_benchmark_t *)userData;
+    lwm2m_object_t * aclObjectP = benchP->objects;
+    int result;
+    int i;
+
+    result = 0;
+    for (i = 0 ; i < benchP->count ; i++)
+    {
+        lwm2m_list_t * instanceP;
+        bool found = false;
+
+        for (instanceP = aclObjectP->instanceList ; instanceP != NULL && !found ; instanceP = instanceP->next)
+        {
+            lwm2m_data_t * dataP = NULL;
+            int size = 0;
+            int64_t value;
+
+            if (COAP_205_CONTENT == aclObjectP->readFunc(instanceP->id, &size, &dataP, aclObjectP)
+             && 1 == lwm2m_data_decode_int(dataP, &value) && value == TARGET_OBJECT_ID
+             && 1 == lwm2m_data_decode_int(dataP + 1, &value) && value == i
+             && 1 == lwm2m_data_decode_int(dataP[2].value.asChildren.array, &value) && (value & ACL_RIGHT_READ) != 0)
+            {
+                found = true;
+                result++;
+            }
+            lwm2m_data_free(size, dataP);
+        }
+    }
+
+    return result;
+}
+
+static void prv_run(int count,
+                    int iterations)
+{
+    acl_benchmark_t bench;
+    char name[80];
+    int i;
+
+    memset(&bench, 0, sizeof(bench));
+    bench.count = count;
+    bench.aclList = (lwm2m_list_t *)lwm2m_malloc(count * sizeof(lwm2m_list_t));
+    bench.instances = (lwm2m_list_t *)lwm2m_malloc(count * sizeof(lwm2m_list_t));
+    if (bench.aclList == NULL || bench.instances == NULL) return;
+    for (i = 0 ; i < count ; i++)
+    {
+        bench.aclList[i].id = (uint16_t)i;
+        bench.aclList[i].next = (i + 1 < count) ? bench.aclList + i + 1 : NULL;
+        bench.instances[i].id = (uint16_t)i;
+        bench.instances[i].next = (i + 1 < count) ? bench.instances + i + 1 : NULL;
+    }
+
+    bench.servers[0].shortID = 1;
+    bench.servers[0].next = bench.servers + 1;
+    bench.servers[1].shortID = 2;
+    bench.context.serverList = bench.servers;
+    bench.objects[0].objID = LWM2M_ACL_OBJECT_ID;
+    bench.objects[0].instanceList = bench.aclList;
+    bench.objects[0].readFunc = prv_aclRead;
+    bench.objects[0].next = bench.objects + 1;
+    bench.objects[1].objID = TARGET_OBJECT_ID;
+    bench.objects[1].instanceList = bench.instances;
+    bench.context.objectList = bench.objects;
+    lwm2m_index_build(&bench.context.objectIndex, (lwm2m_list_t *)bench.context.objectList);
+
+    snprintf(name, sizeof(name), "acl: search the rights on %d instances", count);
+    benchmark_run(name, count > 100 ? 1 : iterations, prv_search, &bench);
+    snprintf(name, sizeof(name), "acl: compile the rights on %d instances", count);
+    benchmark_run(name, iterations, prv_compile, &bench);
+    snprintf(name, sizeof(name), "acl: check the rights on %d instances", count);
+    benchmark_run(name, iterations, prv_check, &bench);
+
+    acl_invalidate(&bench.context);
+    lwm2m_index_clear(&bench.context.objectIndex);
+    lwm2m_free(bench.instances);
+    lwm2m_free(bench.aclList);
+}
+
+void run_acl_benchmarks(void)
+{
+    prv_run(10, 10000);
+    prv_run(1000, 100);
+}
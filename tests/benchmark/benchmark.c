@@ -0,0 +1,163 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+/*
+ * Micro benchmarks of the core encoders and decoders.
+ *
+ * Usage: lwm2mbenchmark [name]
+ * Runs all the benchmarks or only the ones whose name is given.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "benchmark.h"
+
+#define RESOURCE_COUNT  12
+#define MULTIPLE_COUNT  4
+
+static struct BenchmarkTable table[] =
+{
+    { "tlv", run_tlv_benchmarks },
+    { "json", run_json_benchmarks },
+    { "cbor", run_cbor_benchmarks },
+    { "float", run_float_benchmarks },
+    { "data", run_data_benchmarks },
+    { "list", run_list_benchmarks },
+    { "link", run_link_benchmarks },
+    { "acl", run_acl_benchmarks },
+    { NULL, NULL }
+};
+
+// stub function
+void * lwm2m_connect_server(uint16_t secObjInstID,
+                            void * userData)
+{
+    (void)userData;
+
+    return (void *)(uintptr_t)secObjInstID;
+}
+
+void lwm2m_close_connection(void * sessionH,
+                            void * userData)
+{
+    (void)sessionH;
+    (void)userData;
+}
+
+static double prv_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+void benchmark_run(const char * name,
+                   int iterations,
+                   int (*function)(void * userData),
+                   void * userData)
+{
+    volatile int sink;
+    double start;
+    double duration;
+    int i;
+
+    // warm up
+    sink = function(userData);
+
+    start = prv_now();
+    for (i = 0 ; i < iterations ; i++)
+    {
+        sink += function(userData);
+    }
+    duration = prv_now() - start;
+
+    printf("%-48s %10d iterations %12.1f ns/op\n", name, iterations, duration / iterations);
+    (void)sink;
+}
+
+// An object similar to the Device object: strings, integers, a float, a boolean and a multiple resource per instance
+lwm2m_data_t * benchmark_createObject(int instanceCount)
+{
+    lwm2m_data_t * dataP;
+    int i;
+
+    dataP = lwm2m_data_new(instanceCount);
+    for (i = 0 ; i < instanceCount ; i++)
+    {
+        lwm2m_data_t * resP;
+        lwm2m_data_t * subP;
+        int j;
+
+        resP = lwm2m_data_new(RESOURCE_COUNT);
+        for (j = 0 ; j < RESOURCE_COUNT ; j++)
+        {
+            resP[j].id = j;
+            switch (j % 6)
+            {
+            case 0:
+                lwm2m_data_encode_string("Open Mobile Alliance", resP + j);
+                break;
+            case 1:
+                lwm2m_data_encode_int(j * 1000, resP + j);
+                break;
+            case 2:
+                lwm2m_data_encode_float(3.14159 * j, resP + j);
+                break;
+            case 3:
+                lwm2m_data_encode_bool(true, resP + j);
+                break;
+            case 4:
+                lwm2m_data_encode_int(-5, resP + j);
+                break;
+            default:
+                subP = lwm2m_data_new(MULTIPLE_COUNT);
+                for (int k = 0 ; k < MULTIPLE_COUNT ; k++)
+                {
+                    subP[k].id = k;
+                    lwm2m_data_encode_int(k * 100000, subP + k);
+                }
+                lwm2m_data_encode_instances(subP, MULTIPLE_COUNT, resP + j);
+                break;
+            }
+        }
+        dataP[i].type = LWM2M_TYPE_OBJECT_INSTANCE;
+        dataP[i].id = i;
+        dataP[i].value.asChildren.count = RESOURCE_COUNT;
+        dataP[i].value.asChildren.array = resP;
+    }
+
+    return dataP;
+}
+
+int main(int argc, char *argv[])
+{
+    int i;
+
+    for (i = 0 ; table[i].name != NULL ; i++)
+    {
+        if (argc < 2 || strcmp(argv[1], table[i].name) == 0)
+        {
+            table[i].function();
+        }
+    }
+
+    return 0;
+}
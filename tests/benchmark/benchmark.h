@@ -0,0 +1,47 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include "liblwm2m.h"
+
+typedef void (*benchmark_function_t)(void);
+
+struct BenchmarkTable
+{
+    const char * name;
+    benchmark_function_t function;
+};
+
+// Time the function over the number of iterations and print the mean duration of one iteration.
+// The function returns a value which is accumulated so that the work cannot be optimized out.
+void benchmark_run(const char * name, int iterations, int (*function)(void * userData), void * userData);
+
+// Returns instanceCount object instances similar to the Device object
+lwm2m_data_t * benchmark_createObject(int instanceCount);
+
+void run_tlv_benchmarks(void);
+void run_json_benchmarks(void);
+void run_cbor_benchmarks(void);
+void run_float_benchmarks(void);
+void run_data_benchmarks(void);
+void run_list_benchmarks(void);
+void run_link_benchmarks(void);
+void run_acl_benchmarks(void);
+
+#endif
@@ -0,0 +1,124 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "benchmark.h"
+
+// Compares SenML CBOR with the TLV and JSON formats on the same data.
+
+typedef struct
+{
+    lwm2m_uri_t uri;
+    int size;
+    lwm2m_data_t * dataP;
+    lwm2m_media_type_t format;
+    uint8_t * buffer;
+    int length;
+} cbor_benchmark_t;
+
+static const struct
+{
+    const char * name;
+    lwm2m_media_type_t format;
+} formats[] =
+{
+    { "tlv", LWM2M_CONTENT_TLV },
+    { "json", LWM2M_CONTENT_JSON },
+    { "senml-cbor", LWM2M_CONTENT_SENML_CBOR },
+};
+
+static int prv_serialize(void * userData)
+{
+    cbor_benchmark_t * benchP = (cbor_benchmark_t *)userData;
+    lwm2m_media_type_t format = benchP->format;
+    uint8_t * buffer;
+    int length;
+
+    length = lwm2m_data_serialize(&benchP->uri, benchP->size, benchP->dataP, &format, &buffer);
+    lwm2m_free(buffer);
+
+    return length;
+}
+
+static int prv_parse(void * userData)
+{
+    cbor_benchmark_t * benchP = (cbor_benchmark_t *)userData;
+    lwm2m_data_t * dataP;
+    int size;
+
+    size = lwm2m_data_parse(&benchP->uri, benchP->buffer, benchP->length, benchP->format, &dataP);
+    lwm2m_data_free(size, dataP);
+
+    return size;
+}
+
+static int prv_parseBorrowed(void * userData)
+{
+    cbor_benchmark_t * benchP = (cbor_benchmark_t *)userData;
+    lwm2m_data_t * dataP;
+    int size;
+
+    size = lwm2m_data_parse_borrowed(&benchP->uri, benchP->buffer, benchP->length, benchP->format, &dataP);
+    lwm2m_data_free(size, dataP);
+
+    return size;
+}
+
+static void prv_run(int instanceCount,
+                    int iterations)
+{
+    cbor_benchmark_t bench;
+    char name[80];
+    size_t i;
+
+    memset(&bench.uri, 0, sizeof(bench.uri));
+    bench.uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    bench.uri.objectId = 3;
+    bench.size = instanceCount;
+    bench.dataP = benchmark_createObject(instanceCount);
+
+    for (i = 0 ; i < sizeof(formats) / sizeof(formats[0]) ; i++)
+    {
+        bench.format = formats[i].format;
+        bench.length = lwm2m_data_serialize(&bench.uri, bench.size, bench.dataP, &bench.format, &bench.buffer);
+        printf("%s: %d instances object payload is %d bytes\n", formats[i].name, instanceCount, bench.length);
+        if (bench.length <= 0) continue;
+
+        snprintf(name, sizeof(name), "%s: serialize %d instances", formats[i].name, instanceCount);
+        benchmark_run(name, iterations, prv_serialize, &bench);
+        snprintf(name, sizeof(name), "%s: parse %d instances", formats[i].name, instanceCount);
+        benchmark_run(name, iterations, prv_parse, &bench);
+        if (bench.format != LWM2M_CONTENT_JSON)
+        {
+            snprintf(name, sizeof(name), "%s: parse %d instances borrowing values", formats[i].name, instanceCount);
+            benchmark_run(name, iterations, prv_parseBorrowed, &bench);
+        }
+
+        lwm2m_free(bench.buffer);
+    }
+
+    lwm2m_data_free(bench.size, bench.dataP);
+}
+
+void run_cbor_benchmarks(void)
+{
+    prv_run(1, 100000);
+    prv_run(8, 10000);
+    prv_run(64, 1000);
+}
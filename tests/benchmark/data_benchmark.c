@@ -0,0 +1,188 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "benchmark.h"
+
+// Builds the values of a read of the whole Device object, like prv_device_read() in the example client,
+// with copied or borrowed strings and multiple resources.
+
+#define DEVICE_RESOURCE_COUNT   16
+
+static const char * deviceStrings[] =
+{
+    "Open Mobile Alliance",
+    "Lightweight M2M Client",
+    "345000123",
+    "1.0",
+    "+01:00",
+    "Europe/Berlin",
+    "U"
+};
+
+// the static arrays of the borrowed multiple resources
+static lwm2m_data_t deviceInstances[4][2];
+
+static void prv_encodeMultiple(int64_t first,
+                               int64_t second,
+                               lwm2m_data_t * borrowedP,
+                               lwm2m_data_t * dataP)
+{
+    lwm2m_data_t * subP;
+
+    subP = (borrowedP != NULL) ? borrowedP : lwm2m_data_new(2);
+    subP[0].id = 0;
+    lwm2m_data_encode_int(first, subP);
+    subP[1].id = 1;
+    lwm2m_data_encode_int(second, subP + 1);
+    if (borrowedP != NULL)
+    {
+        lwm2m_data_encode_instances_borrowed(subP, 2, dataP);
+    }
+    else
+    {
+        lwm2m_data_encode_instances(subP, 2, dataP);
+    }
+}
+
+static lwm2m_data_t * prv_readDevice(bool isBorrowed)
+{
+    lwm2m_data_t * dataP;
+    int i;
+    int s;
+
+    dataP = lwm2m_data_new(DEVICE_RESOURCE_COUNT);
+    s = 0;
+    for (i = 0 ; i < DEVICE_RESOURCE_COUNT ; i++)
+    {
+        dataP[i].id = i;
+        switch (i)
+        {
+        case 0:
+        case 1:
+        case 2:
+        case 3:
+        case 13:
+        case 14:
+        case 15:
+            if (isBorrowed)
+            {
+                lwm2m_data_encode_string_borrowed(deviceStrings[s], dataP + i);
+            }
+            else
+            {
+                lwm2m_data_encode_string(deviceStrings[s], dataP + i);
+            }
+            s++;
+            break;
+        case 6:
+            prv_encodeMultiple(1, 5, isBorrowed ? deviceInstances[0] : NULL, dataP + i);
+            break;
+        case 7:
+            prv_encodeMultiple(3800, 5000, isBorrowed ? deviceInstances[1] : NULL, dataP + i);
+            break;
+        case 8:
+            prv_encodeMultiple(125, 900, isBorrowed ? deviceInstances[2] : NULL, dataP + i);
+            break;
+        case 11:
+            prv_encodeMultiple(0, 0, isBorrowed ? deviceInstances[3] : NULL, dataP + i);
+            break;
+        default:
+            lwm2m_data_encode_int(i * 100, dataP + i);
+            break;
+        }
+    }
+
+    return dataP;
+}
+
+// Number of lwm2m_malloc() calls needed to build the values
+static int prv_countAllocations(size_t count,
+                                lwm2m_data_t * dataP)
+{
+    int result;
+    size_t i;
+
+    result = 1;
+    for (i = 0 ; i < count ; i++)
+    {
+        switch (dataP[i].type)
+        {
+        case LWM2M_TYPE_MULTIPLE_RESOURCE:
+        case LWM2M_TYPE_OBJECT_INSTANCE:
+        case LWM2M_TYPE_OBJECT:
+            if ((dataP[i].flags & LWM2M_DATA_FLAG_BORROWED) == 0)
+            {
+                result += prv_countAllocations(dataP[i].value.asChildren.count, dataP[i].value.asChildren.array);
+            }
+            break;
+
+        case LWM2M_TYPE_STRING:
+        case LWM2M_TYPE_OPAQUE:
+            if ((dataP[i].flags & (LWM2M_DATA_FLAG_BORROWED | LWM2M_DATA_FLAG_INLINE)) == 0
+             && dataP[i].value.asBuffer.buffer != NULL)
+            {
+                result++;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return result;
+}
+
+static int prv_readCopied(void * userData)
+{
+    (void)userData;
+
+    lwm2m_data_free(DEVICE_RESOURCE_COUNT, prv_readDevice(false));
+
+    return DEVICE_RESOURCE_COUNT;
+}
+
+static int prv_readBorrowed(void * userData)
+{
+    (void)userData;
+
+    lwm2m_data_free(DEVICE_RESOURCE_COUNT, prv_readDevice(true));
+
+    return DEVICE_RESOURCE_COUNT;
+}
+
+static void prv_reportAllocations(const char * name,
+                                  bool isBorrowed)
+{
+    lwm2m_data_t * dataP;
+
+    dataP = prv_readDevice(isBorrowed);
+    printf("device read %s: %d allocations\n", name, prv_countAllocations(DEVICE_RESOURCE_COUNT, dataP));
+    lwm2m_data_free(DEVICE_RESOURCE_COUNT, dataP);
+}
+
+void run_data_benchmarks(void)
+{
+    printf("lwm2m_data_t is %d bytes, values up to %d bytes are inline\n", (int)sizeof(lwm2m_data_t), (int)LWM2M_DATA_INLINE_SIZE);
+    prv_reportAllocations("with copied values", false);
+    prv_reportAllocations("with borrowed values", true);
+    benchmark_run("device read with copied values", 100000, prv_readCopied, NULL);
+    benchmark_run("device read with borrowed values", 100000, prv_readBorrowed, NULL);
+}
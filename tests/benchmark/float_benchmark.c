@@ -0,0 +1,238 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "internals.h"
+#include "benchmark.h"
+
+// Throughput of the float to text conversions, on their own and in float
+// only JSON payloads like the Location object ones.
+
+#define VALUE_COUNT     1024
+#define LOCATION_COUNT  6
+
+typedef struct
+{
+    double values[VALUE_COUNT];
+    uint8_t texts[VALUE_COUNT][FLOAT_MAX_STRING_LEN];
+    size_t lengths[VALUE_COUNT];
+} float_benchmark_t;
+
+typedef struct
+{
+    lwm2m_uri_t uri;
+    int size;
+    lwm2m_data_t * dataP;
+    uint8_t * buffer;
+    int length;
+} location_benchmark_t;
+
+static uint64_t prv_random(uint64_t * seedP)
+{
+    *seedP ^= *seedP << 13;
+    *seedP ^= *seedP >> 7;
+    *seedP ^= *seedP << 17;
+
+    return *seedP;
+}
+
+// sensor readings with a few decimals
+static double prv_sensorValue(int i,
+                              uint64_t * seedP)
+{
+    (void)i;
+
+    return (double)((int64_t)(prv_random(seedP) % 200000) - 100000) / 100;
+}
+
+// results of computations needing all 17 digits
+static double prv_computedValue(int i,
+                                uint64_t * seedP)
+{
+    (void)i;
+
+    return (double)(prv_random(seedP) % 100000) / 7.0;
+}
+
+// any finite double
+static double prv_anyValue(int i,
+                           uint64_t * seedP)
+{
+    uint64_t bits;
+    double value;
+
+    (void)i;
+    do
+    {
+        bits = prv_random(seedP);
+    } while ((bits & 0x7FF0000000000000ULL) == 0x7FF0000000000000ULL);
+    memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+static int prv_format(void * userData)
+{
+    float_benchmark_t * benchP = (float_benchmark_t *)userData;
+    uint8_t text[FLOAT_MAX_STRING_LEN];
+    int total;
+    int i;
+
+    total = 0;
+    for (i = 0 ; i < VALUE_COUNT ; i++)
+    {
+        total += (int)utils_floatToText(benchP->values[i], text, sizeof(text));
+    }
+
+    return total;
+}
+
+static int prv_parse(void * userData)
+{
+    float_benchmark_t * benchP = (float_benchmark_t *)userData;
+    double value;
+    int total;
+    int i;
+
+    total = 0;
+    for (i = 0 ; i < VALUE_COUNT ; i++)
+    {
+        total += utils_textToFloat(benchP->texts[i], (int)benchP->lengths[i], &value);
+    }
+
+    return total;
+}
+
+static void prv_runValues(const char * name,
+                          double (*generator)(int i, uint64_t * seedP))
+{
+    float_benchmark_t bench;
+    uint64_t seed;
+    char title[80];
+    int failures;
+    int i;
+
+    seed = 88172645463325252ULL;
+    failures = 0;
+    for (i = 0 ; i < VALUE_COUNT ; i++)
+    {
+        double value;
+
+        bench.values[i] = generator(i, &seed);
+        bench.lengths[i] = utils_floatToText(bench.values[i], bench.texts[i], FLOAT_MAX_STRING_LEN);
+        if (bench.lengths[i] == 0
+         || utils_textToFloat(bench.texts[i], (int)bench.lengths[i], &value) != 1
+         || 0 != memcmp(&value, bench.values + i, sizeof(value)))
+        {
+            failures++;
+        }
+    }
+    printf("%s: %d of %d values do not survive a round trip\n", name, failures, VALUE_COUNT);
+
+    snprintf(title, sizeof(title), "%s: format %d values", name, VALUE_COUNT);
+    benchmark_run(title, 1000, prv_format, &bench);
+    snprintf(title, sizeof(title), "%s: parse %d values", name, VALUE_COUNT);
+    benchmark_run(title, 1000, prv_parse, &bench);
+}
+
+static int prv_serializeLocation(void * userData)
+{
+    location_benchmark_t * benchP = (location_benchmark_t *)userData;
+    lwm2m_media_type_t format = LWM2M_CONTENT_JSON;
+    uint8_t * buffer;
+    int length;
+
+    length = lwm2m_data_serialize(&benchP->uri, benchP->size, benchP->dataP, &format, &buffer);
+    lwm2m_free(buffer);
+
+    return length;
+}
+
+static int prv_parseLocation(void * userData)
+{
+    location_benchmark_t * benchP = (location_benchmark_t *)userData;
+    lwm2m_data_t * dataP;
+    int size;
+
+    size = lwm2m_data_parse(&benchP->uri, benchP->buffer, benchP->length, LWM2M_CONTENT_JSON, &dataP);
+    lwm2m_data_free(size, dataP);
+
+    return size;
+}
+
+// Location object instances holding latitude, longitude, altitude, radius and speeds
+static void prv_runLocation(int instanceCount,
+                            int iterations)
+{
+    location_benchmark_t bench;
+    lwm2m_media_type_t format = LWM2M_CONTENT_JSON;
+    uint64_t seed;
+    char name[80];
+    int i;
+
+    memset(&bench.uri, 0, sizeof(bench.uri));
+    bench.uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    bench.uri.objectId = 6;
+    bench.size = instanceCount;
+    bench.dataP = lwm2m_data_new(instanceCount);
+    seed = 88172645463325252ULL;
+    for (i = 0 ; i < instanceCount ; i++)
+    {
+        lwm2m_data_t * resP;
+        int j;
+
+        resP = lwm2m_data_new(LOCATION_COUNT);
+        for (j = 0 ; j < LOCATION_COUNT ; j++)
+        {
+            resP[j].id = j;
+        }
+        lwm2m_data_encode_float(48.858222 + (double)(prv_random(&seed) % 1000000) / 1e6, resP + 0);
+        lwm2m_data_encode_float(2.2945 + (double)(prv_random(&seed) % 1000000) / 1e6, resP + 1);
+        lwm2m_data_encode_float((double)(prv_random(&seed) % 10000) / 10, resP + 2);
+        lwm2m_data_encode_float(prv_computedValue(i, &seed), resP + 3);
+        lwm2m_data_encode_float((double)(prv_random(&seed) % 1000) / 100, resP + 4);
+        lwm2m_data_encode_float(prv_computedValue(i, &seed) / 3, resP + 5);
+        bench.dataP[i].type = LWM2M_TYPE_OBJECT_INSTANCE;
+        bench.dataP[i].id = i;
+        bench.dataP[i].value.asChildren.count = LOCATION_COUNT;
+        bench.dataP[i].value.asChildren.array = resP;
+    }
+
+    bench.length = lwm2m_data_serialize(&bench.uri, bench.size, bench.dataP, &format, &bench.buffer);
+    printf("location: %d instances JSON payload is %d bytes\n", instanceCount, bench.length);
+    if (bench.length > 0)
+    {
+        snprintf(name, sizeof(name), "location: serialize %d instances", instanceCount);
+        benchmark_run(name, iterations, prv_serializeLocation, &bench);
+        snprintf(name, sizeof(name), "location: parse %d instances", instanceCount);
+        benchmark_run(name, iterations, prv_parseLocation, &bench);
+        lwm2m_free(bench.buffer);
+    }
+
+    lwm2m_data_free(bench.size, bench.dataP);
+}
+
+void run_float_benchmarks(void)
+{
+    prv_runValues("sensor", prv_sensorValue);
+    prv_runValues("computed", prv_computedValue);
+    prv_runValues("any", prv_anyValue);
+    prv_runLocation(1, 100000);
+    prv_runLocation(64, 1000);
+}
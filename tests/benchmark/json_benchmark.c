@@ -0,0 +1,152 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "benchmark.h"
+
+#define BLOCK_SIZE  512
+
+typedef struct
+{
+    lwm2m_uri_t uri;
+    int size;
+    lwm2m_data_t * dataP;
+    uint8_t * buffer;
+    int length;
+} json_benchmark_t;
+
+static int prv_serialize(void * userData)
+{
+    json_benchmark_t * benchP = (json_benchmark_t *)userData;
+    lwm2m_media_type_t format = LWM2M_CONTENT_JSON;
+    uint8_t * buffer;
+    int length;
+
+    length = lwm2m_data_serialize(&benchP->uri, benchP->size, benchP->dataP, &format, &buffer);
+    lwm2m_free(buffer);
+
+    return length;
+}
+
+// All the Block2 chunks, each one serialized on its own
+static int prv_serializeBlocks(void * userData)
+{
+    json_benchmark_t * benchP = (json_benchmark_t *)userData;
+    lwm2m_media_type_t format = LWM2M_CONTENT_JSON;
+    uint8_t chunk[BLOCK_SIZE];
+    size_t offset;
+    size_t length;
+    int res;
+
+    offset = 0;
+    do
+    {
+        res = lwm2m_data_serialize_block(&benchP->uri, benchP->size, benchP->dataP, &format, offset, chunk, BLOCK_SIZE, &length);
+        if (res <= 0) return -1;
+        offset += res;
+    } while (offset < length);
+
+    return (int)offset;
+}
+
+static int prv_parse(void * userData)
+{
+    json_benchmark_t * benchP = (json_benchmark_t *)userData;
+    lwm2m_data_t * dataP;
+    int size;
+
+    size = lwm2m_data_parse(&benchP->uri, benchP->buffer, benchP->length, LWM2M_CONTENT_JSON, &dataP);
+    lwm2m_data_free(size, dataP);
+
+    return size;
+}
+
+static void prv_run(int instanceCount,
+                    int iterations)
+{
+    json_benchmark_t bench;
+    lwm2m_media_type_t format = LWM2M_CONTENT_JSON;
+    char name[64];
+
+    memset(&bench.uri, 0, sizeof(bench.uri));
+    bench.uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    bench.uri.objectId = 3;
+    bench.size = instanceCount;
+    bench.dataP = benchmark_createObject(instanceCount);
+
+    bench.length = lwm2m_data_serialize(&bench.uri, bench.size, bench.dataP, &format, &bench.buffer);
+    printf("json: %d instances object payload is %d bytes\n", instanceCount, bench.length);
+    if (bench.length <= 0) return;
+
+    snprintf(name, sizeof(name), "json: serialize %d instances", instanceCount);
+    benchmark_run(name, iterations, prv_serialize, &bench);
+    snprintf(name, sizeof(name), "json: serialize %d instances in %d bytes blocks", instanceCount, BLOCK_SIZE);
+    benchmark_run(name, iterations, prv_serializeBlocks, &bench);
+    snprintf(name, sizeof(name), "json: parse %d instances", instanceCount);
+    benchmark_run(name, iterations, prv_parse, &bench);
+
+    lwm2m_free(bench.buffer);
+    lwm2m_data_free(bench.size, bench.dataP);
+}
+
+// Parses a payload of about payloadSize bytes
+static void prv_runParse(int payloadSize,
+                         int iterations)
+{
+    json_benchmark_t bench;
+    lwm2m_media_type_t format = LWM2M_CONTENT_JSON;
+    char name[64];
+    lwm2m_data_t * dataP;
+    uint8_t * buffer;
+    int length;
+
+    memset(&bench.uri, 0, sizeof(bench.uri));
+    bench.uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    bench.uri.objectId = 3;
+
+    // size of one instance
+    dataP = benchmark_createObject(1);
+    length = lwm2m_data_serialize(&bench.uri, 1, dataP, &format, &buffer);
+    lwm2m_data_free(1, dataP);
+    if (length <= 0) return;
+    lwm2m_free(buffer);
+
+    bench.size = payloadSize / length;
+    if (bench.size == 0) bench.size = 1;
+    bench.dataP = benchmark_createObject(bench.size);
+    bench.length = lwm2m_data_serialize(&bench.uri, bench.size, bench.dataP, &format, &bench.buffer);
+    if (bench.length <= 0) return;
+
+    snprintf(name, sizeof(name), "json: parse %d bytes (%d instances)", bench.length, bench.size);
+    benchmark_run(name, iterations, prv_parse, &bench);
+
+    lwm2m_free(bench.buffer);
+    lwm2m_data_free(bench.size, bench.dataP);
+}
+
+void run_json_benchmarks(void)
+{
+    prv_run(1, 100000);
+    prv_run(8, 10000);
+    prv_run(64, 100);
+
+    prv_runParse(1024, 20000);
+    prv_runParse(16 * 1024, 1000);
+    prv_runParse(256 * 1024, 50);
+}
@@ -0,0 +1,153 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "internals.h"
+#include "benchmark.h"
+
+// Builds the two link format payloads: the Discover response of an object, with attributes set
+// by the server, and the registration payload of a client.
+
+#define OBJECT_COUNT    8
+
+typedef struct
+{
+    int size;
+    lwm2m_data_t * dataP;
+    lwm2m_server_t server;
+} discover_benchmark_t;
+
+typedef struct
+{
+    lwm2m_context_t context;
+    lwm2m_object_t objects[OBJECT_COUNT];
+    lwm2m_list_t * instances;
+} register_benchmark_t;
+
+static int prv_discover(void * userData)
+{
+    discover_benchmark_t * benchP = (discover_benchmark_t *)userData;
+    lwm2m_uri_t uri;
+    uint8_t * buffer;
+    int length;
+
+    memset(&uri, 0, sizeof(lwm2m_uri_t));
+    uri.objectId = 3;
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    length = discover_serialize(&uri, &benchP->server, benchP->size, benchP->dataP, &buffer);
+    if (length > 0) lwm2m_free(buffer);
+
+    return length;
+}
+
+static int prv_register(void * userData)
+{
+    register_benchmark_t * benchP = (register_benchmark_t *)userData;
+    uint8_t * buffer;
+
+    object_invalidateRegisterPayload(&benchP->context);
+
+    return object_getRegisterPayloadCache(&benchP->context, &buffer);
+}
+
+static void prv_runDiscover(int instanceCount,
+                            int iterations)
+{
+    discover_benchmark_t bench;
+    lwm2m_attributes_t attr;
+    lwm2m_uri_t uri;
+    char name[80];
+    int i;
+
+    memset(&bench, 0, sizeof(bench));
+    bench.size = instanceCount;
+    bench.dataP = benchmark_createObject(instanceCount);
+
+    // periods on the object, a step on the second resource of each instance
+    memset(&uri, 0, sizeof(lwm2m_uri_t));
+    uri.objectId = 3;
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    memset(&attr, 0, sizeof(attr));
+    attr.toSet = LWM2M_ATTR_FLAG_MIN_PERIOD | LWM2M_ATTR_FLAG_MAX_PERIOD;
+    attr.minPeriod = 10;
+    attr.maxPeriod = 60;
+    attributes_set(&bench.server, &uri, &attr);
+    memset(&attr, 0, sizeof(attr));
+    attr.toSet = LWM2M_ATTR_FLAG_STEP;
+    attr.step = 0.5;
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID | LWM2M_URI_FLAG_RESOURCE_ID;
+    uri.resourceId = 1;
+    for (i = 0 ; i < instanceCount ; i++)
+    {
+        uri.instanceId = (uint16_t)i;
+        attributes_set(&bench.server, &uri, &attr);
+    }
+
+    printf("discover: %d instances payload is %d bytes\n", instanceCount, prv_discover(&bench));
+    snprintf(name, sizeof(name), "discover: %d instances", instanceCount);
+    benchmark_run(name, iterations, prv_discover, &bench);
+
+    attributes_free(&bench.server);
+    lwm2m_data_free(instanceCount, bench.dataP);
+}
+
+static void prv_runRegister(int instanceCount,
+                            int iterations)
+{
+    register_benchmark_t bench;
+    char name[80];
+    int i;
+    int j;
+
+    memset(&bench, 0, sizeof(bench));
+    bench.instances = (lwm2m_list_t *)lwm2m_malloc(OBJECT_COUNT * instanceCount * sizeof(lwm2m_list_t));
+    if (bench.instances == NULL) return;
+
+    for (i = 0 ; i < OBJECT_COUNT ; i++)
+    {
+        lwm2m_list_t * instanceP = bench.instances + i * instanceCount;
+
+        bench.objects[i].objID = (uint16_t)(i == 0 ? LWM2M_SECURITY_OBJECT_ID : 3000 + i);
+        bench.objects[i].next = (i + 1 < OBJECT_COUNT) ? bench.objects + i + 1 : NULL;
+        bench.objects[i].instanceList = instanceP;
+        for (j = 0 ; j < instanceCount ; j++)
+        {
+            instanceP[j].id = (uint16_t)j;
+            instanceP[j].next = (j + 1 < instanceCount) ? instanceP + j + 1 : NULL;
+        }
+    }
+    bench.context.objectList = bench.objects;
+
+    printf("register: %d objects of %d instances payload is %d bytes\n", OBJECT_COUNT, instanceCount, prv_register(&bench));
+    snprintf(name, sizeof(name), "register: %d objects of %d instances", OBJECT_COUNT, instanceCount);
+    benchmark_run(name, iterations, prv_register, &bench);
+
+    object_invalidateRegisterPayload(&bench.context);
+    lwm2m_free(bench.instances);
+}
+
+void run_link_benchmarks(void)
+{
+    prv_runDiscover(1, 100000);
+    prv_runDiscover(10, 10000);
+    prv_runDiscover(1000, 100);
+    prv_runRegister(1, 100000);
+    prv_runRegister(10, 10000);
+    prv_runRegister(1000, 100);
+}
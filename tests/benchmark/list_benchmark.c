@@ -0,0 +1,219 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "benchmark.h"
+
+// Compares the sorted linked list with the list index. Each iteration is a pass over all the IDs,
+// in a shuffled order for insertions, lookups and removals.
+
+typedef struct
+{
+    int count;
+    lwm2m_list_t * nodes;
+    uint16_t * order;
+    lwm2m_list_t * head;
+    lwm2m_list_index_t index;
+} list_benchmark_t;
+
+// Link the nodes in order of ID, as a freshly built list
+static void prv_link(list_benchmark_t * benchP)
+{
+    int i;
+
+    for (i = 0 ; i < benchP->count ; i++)
+    {
+        benchP->nodes[i].id = (uint16_t)i;
+        benchP->nodes[i].next = (i + 1 < benchP->count) ? benchP->nodes + i + 1 : NULL;
+    }
+    benchP->head = benchP->nodes;
+}
+
+static int prv_listInsert(void * userData)
+{
+    list_benchmark_t * benchP = (list_benchmark_t *)userData;
+    int i;
+
+    benchP->head = NULL;
+    for (i = 0 ; i < benchP->count ; i++)
+    {
+        lwm2m_list_t * nodeP = benchP->nodes + benchP->order[i];
+
+        nodeP->next = NULL;
+        benchP->head = lwm2m_list_add(benchP->head, nodeP);
+    }
+
+    return benchP->count;
+}
+
+static int prv_indexInsert(void * userData)
+{
+    list_benchmark_t * benchP = (list_benchmark_t *)userData;
+    int i;
+
+    lwm2m_index_clear(&benchP->index);
+    benchP->head = NULL;
+    for (i = 0 ; i < benchP->count ; i++)
+    {
+        lwm2m_index_add(&benchP->index, &benchP->head, benchP->nodes + benchP->order[i]);
+    }
+
+    return benchP->count;
+}
+
+static int prv_listFind(void * userData)
+{
+    list_benchmark_t * benchP = (list_benchmark_t *)userData;
+    int result;
+    int i;
+
+    result = 0;
+    for (i = 0 ; i < benchP->count ; i++)
+    {
+        if (lwm2m_list_find(benchP->head, benchP->order[i]) != NULL) result++;
+    }
+
+    return result;
+}
+
+static int prv_indexFind(void * userData)
+{
+    list_benchmark_t * benchP = (list_benchmark_t *)userData;
+    int result;
+    int i;
+
+    result = 0;
+    for (i = 0 ; i < benchP->count ; i++)
+    {
+        if (lwm2m_index_find(&benchP->index, benchP->order[i]) != NULL) result++;
+    }
+
+    return result;
+}
+
+static int prv_listNewId(void * userData)
+{
+    list_benchmark_t * benchP = (list_benchmark_t *)userData;
+
+    return lwm2m_list_newId(benchP->head);
+}
+
+static int prv_indexNewId(void * userData)
+{
+    list_benchmark_t * benchP = (list_benchmark_t *)userData;
+
+    return lwm2m_index_newId(&benchP->index);
+}
+
+static int prv_listDelete(void * userData)
+{
+    list_benchmark_t * benchP = (list_benchmark_t *)userData;
+    lwm2m_list_t * nodeP;
+    int i;
+
+    prv_link(benchP);
+    for (i = 0 ; i < benchP->count ; i++)
+    {
+        benchP->head = lwm2m_list_remove(benchP->head, benchP->order[i], &nodeP);
+    }
+
+    return benchP->count;
+}
+
+static int prv_indexDelete(void * userData)
+{
+    list_benchmark_t * benchP = (list_benchmark_t *)userData;
+    int i;
+
+    prv_link(benchP);
+    lwm2m_index_clear(&benchP->index);
+    lwm2m_index_build(&benchP->index, benchP->head);
+    for (i = 0 ; i < benchP->count ; i++)
+    {
+        lwm2m_index_remove(&benchP->index, &benchP->head, benchP->order[i]);
+    }
+
+    return benchP->count;
+}
+
+static void prv_run(int count,
+                    int iterations)
+{
+    list_benchmark_t bench;
+    char name[80];
+    uint32_t seed;
+    int i;
+
+    memset(&bench, 0, sizeof(bench));
+    bench.count = count;
+    bench.nodes = (lwm2m_list_t *)lwm2m_malloc(count * sizeof(lwm2m_list_t));
+    bench.order = (uint16_t *)lwm2m_malloc(count * sizeof(uint16_t));
+    if (bench.nodes == NULL || bench.order == NULL) return;
+
+    prv_link(&bench);
+    // reproducible shuffle of the IDs
+    seed = 12345;
+    for (i = 0 ; i < count ; i++) bench.order[i] = (uint16_t)i;
+    for (i = count - 1 ; i > 0 ; i--)
+    {
+        uint16_t swap;
+        int j;
+
+        seed = seed * 1103515245 + 12345;
+        j = (int)((seed >> 8) % (uint32_t)(i + 1));
+        swap = bench.order[i];
+        bench.order[i] = bench.order[j];
+        bench.order[j] = swap;
+    }
+
+    snprintf(name, sizeof(name), "list: insert %d IDs", count);
+    benchmark_run(name, iterations, prv_listInsert, &bench);
+    snprintf(name, sizeof(name), "list: find %d IDs", count);
+    benchmark_run(name, iterations, prv_listFind, &bench);
+    snprintf(name, sizeof(name), "list: newId among %d IDs", count);
+    benchmark_run(name, iterations * 10, prv_listNewId, &bench);
+    snprintf(name, sizeof(name), "list: delete %d IDs", count);
+    benchmark_run(name, iterations, prv_listDelete, &bench);
+
+    snprintf(name, sizeof(name), "index: insert %d IDs", count);
+    benchmark_run(name, iterations, prv_indexInsert, &bench);
+    snprintf(name, sizeof(name), "index: find %d IDs", count);
+    benchmark_run(name, iterations, prv_indexFind, &bench);
+    snprintf(name, sizeof(name), "index: newId among %d IDs", count);
+    benchmark_run(name, iterations * 10, prv_indexNewId, &bench);
+    snprintf(name, sizeof(name), "index: delete %d IDs", count);
+    benchmark_run(name, iterations, prv_indexDelete, &bench);
+
+    lwm2m_index_clear(&bench.index);
+    lwm2m_free(bench.order);
+    lwm2m_free(bench.nodes);
+}
+
+void run_list_benchmarks(void)
+{
+#ifdef LWM2M_INDEX_DIRECT_MAP
+    printf("index: direct map\n");
+#else
+    printf("index: sorted array\n");
+#endif
+    prv_run(10, 100000);
+    prv_run(1000, 100);
+    // the IDs are 16-bit: 65535 is the largest possible list
+    prv_run(65535, 1);
+}
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "benchmark.h"
+
+typedef struct
+{
+    lwm2m_uri_t uri;
+    int size;
+    lwm2m_data_t * dataP;
+    uint8_t * buffer;
+    size_t bufferLen;
+    int length;
+} tlv_benchmark_t;
+
+static int prv_serialize(void * userData)
+{
+    tlv_benchmark_t * benchP = (tlv_benchmark_t *)userData;
+    lwm2m_media_type_t format = LWM2M_CONTENT_TLV;
+    uint8_t * buffer;
+    int length;
+
+    length = lwm2m_data_serialize(&benchP->uri, benchP->size, benchP->dataP, &format, &buffer);
+    lwm2m_free(buffer);
+
+    return length;
+}
+
+static int prv_serializeInto(void * userData)
+{
+    tlv_benchmark_t * benchP = (tlv_benchmark_t *)userData;
+    lwm2m_media_type_t format = LWM2M_CONTENT_TLV;
+
+    return lwm2m_data_serialize_into(&benchP->uri, benchP->size, benchP->dataP, &format, benchP->buffer, benchP->bufferLen);
+}
+
+static int prv_parse(void * userData)
+{
+    tlv_benchmark_t * benchP = (tlv_benchmark_t *)userData;
+    lwm2m_data_t * dataP;
+    int size;
+
+    size = lwm2m_data_parse(&benchP->uri, benchP->buffer, benchP->length, LWM2M_CONTENT_TLV, &dataP);
+    lwm2m_data_free(size, dataP);
+
+    return size;
+}
+
+static int prv_parseBorrowed(void * userData)
+{
+    tlv_benchmark_t * benchP = (tlv_benchmark_t *)userData;
+    lwm2m_data_t * dataP;
+    int size;
+
+    size = lwm2m_data_parse_borrowed(&benchP->uri, benchP->buffer, benchP->length, LWM2M_CONTENT_TLV, &dataP);
+    lwm2m_data_free(size, dataP);
+
+    return size;
+}
+
+static void prv_run(int instanceCount,
+                    int iterations)
+{
+    tlv_benchmark_t bench;
+    lwm2m_media_type_t format = LWM2M_CONTENT_TLV;
+    char name[64];
+
+    memset(&bench.uri, 0, sizeof(bench.uri));
+    bench.uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    bench.uri.objectId = 3;
+    bench.size = instanceCount;
+    bench.dataP = benchmark_createObject(instanceCount);
+    bench.bufferLen = 256 * instanceCount;
+    bench.buffer = (uint8_t *)lwm2m_malloc(bench.bufferLen);
+
+    bench.length = lwm2m_data_serialize_into(&bench.uri, bench.size, bench.dataP, &format, bench.buffer, bench.bufferLen);
+    printf("tlv: %d instances object payload is %d bytes\n", instanceCount, bench.length);
+
+    snprintf(name, sizeof(name), "tlv: serialize %d instances", instanceCount);
+    benchmark_run(name, iterations, prv_serialize, &bench);
+    snprintf(name, sizeof(name), "tlv: serialize %d instances into payload", instanceCount);
+    benchmark_run(name, iterations, prv_serializeInto, &bench);
+    snprintf(name, sizeof(name), "tlv: parse %d instances", instanceCount);
+    benchmark_run(name, iterations, prv_parse, &bench);
+    snprintf(name, sizeof(name), "tlv: parse %d instances borrowed", instanceCount);
+    benchmark_run(name, iterations, prv_parseBorrowed, &bench);
+
+    lwm2m_free(bench.buffer);
+    lwm2m_data_free(bench.size, bench.dataP);
+}
+
+void run_tlv_benchmarks(void)
+{
+    prv_run(8, 100000);
+    prv_run(512, 200);
+}
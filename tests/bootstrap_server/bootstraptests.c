@@ -0,0 +1,471 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "harness.h"
+#include "bootstrap_db.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#define RTT             500
+#define MAX_RESULTS     32
+
+// Results given by the library to the bootstrap callback
+typedef struct
+{
+    int     requestCount;
+    int     resultCount;
+    uint8_t status[MAX_RESULTS];
+    char    uri[MAX_RESULTS][32];
+} bs_log_t;
+
+static uint8_t g_payload[] = {0xC1, 0x00, 0x01};
+
+static int prv_callback(void * sessionH,
+                        uint8_t status,
+                        lwm2m_uri_t * uriP,
+                        char * name,
+                        void * userData)
+{
+    bs_log_t * logP = (bs_log_t *)userData;
+
+    (void)sessionH;
+    if (status == COAP_NO_ERROR && name != NULL)
+    {
+        logP->requestCount++;
+        return COAP_204_CHANGED;
+    }
+    if (logP->resultCount == MAX_RESULTS) return COAP_NO_ERROR;
+
+    logP->status[logP->resultCount] = status;
+    logP->uri[logP->resultCount][0] = 0;
+    if (uriP != NULL)
+    {
+        if (LWM2M_URI_IS_SET_INSTANCE(uriP))
+        {
+            snprintf(logP->uri[logP->resultCount], 32, "/%d/%d", uriP->objectId, uriP->instanceId);
+        }
+        else
+        {
+            snprintf(logP->uri[logP->resultCount], 32, "/%d", uriP->objectId);
+        }
+    }
+    logP->resultCount++;
+
+    return COAP_NO_ERROR;
+}
+
+static lwm2m_context_t * prv_open(bs_log_t * logP)
+{
+    lwm2m_context_t * contextP;
+
+    harness_init();
+    memset(logP, 0, sizeof(bs_log_t));
+    contextP = lwm2m_init(NULL);
+    if (contextP != NULL) lwm2m_set_bootstrap_callback(contextP, prv_callback, logP);
+
+    return contextP;
+}
+
+// Deletes the Security and Server Objects, writes writeCount instances to them and finishes
+static void prv_configure(lwm2m_context_t * contextP,
+                          harness_client_t * clientP,
+                          int writeCount)
+{
+    lwm2m_uri_t uri;
+    int i;
+
+    memset(&uri, 0, sizeof(lwm2m_uri_t));
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    uri.objectId = LWM2M_SECURITY_OBJECT_ID;
+    CU_ASSERT_EQUAL(lwm2m_bootstrap_delete(contextP, clientP, &uri), COAP_NO_ERROR);
+    uri.objectId = LWM2M_SERVER_OBJECT_ID;
+    CU_ASSERT_EQUAL(lwm2m_bootstrap_delete(contextP, clientP, &uri), COAP_NO_ERROR);
+
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+    for (i = 0 ; i < writeCount ; i++)
+    {
+        uri.objectId = (i % 2 == 0) ? LWM2M_SECURITY_OBJECT_ID : LWM2M_SERVER_OBJECT_ID;
+        uri.instanceId = (uint16_t)(1 + i / 2);
+        CU_ASSERT_EQUAL(lwm2m_bootstrap_write(contextP, clientP, &uri, LWM2M_CONTENT_TLV, g_payload, sizeof(g_payload)), COAP_NO_ERROR);
+    }
+
+    CU_ASSERT_EQUAL(lwm2m_bootstrap_finish(contextP, clientP), COAP_NO_ERROR);
+}
+
+// Number of round trips to send count commands
+static int prv_trips(int count)
+{
+    return (count + LWM2M_BOOTSTRAP_WINDOW - 1) / LWM2M_BOOTSTRAP_WINDOW;
+}
+
+static int prv_min(int a,
+                   int b)
+{
+    return a < b ? a : b;
+}
+
+static int prv_count(bs_log_t * logP,
+                     uint8_t status)
+{
+    int count;
+    int i;
+
+    count = 0;
+    for (i = 0 ; i < logP->resultCount ; i++)
+    {
+        if (logP->status[i] == status) count++;
+    }
+
+    return count;
+}
+
+static void test_bootstrap_order(void)
+{
+    lwm2m_context_t * contextP;
+    harness_client_t client;
+    harness_request_t * finishP;
+    bs_log_t log;
+    uint32_t start;
+    int i;
+
+    contextP = prv_open(&log);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    harness_client_init(&client, RTT);
+    start = harness_now();
+    harness_bootstrap_request(contextP, &client, "client");
+    CU_ASSERT_EQUAL(client.bootstrapAnswer, COAP_204_CHANGED);
+    CU_ASSERT_EQUAL(log.requestCount, 1);
+    prv_configure(contextP, &client, 4);
+    harness_run(contextP, 0);
+
+    // the commands are sent and completed in the order they were given
+    CU_ASSERT_EQUAL_FATAL(client.requestCount, 7);
+    CU_ASSERT_STRING_EQUAL(client.requests[0].uri, "/0");
+    CU_ASSERT_STRING_EQUAL(client.requests[1].uri, "/1");
+    CU_ASSERT_STRING_EQUAL(client.requests[2].uri, "/0/1");
+    CU_ASSERT_STRING_EQUAL(client.requests[3].uri, "/1/1");
+    CU_ASSERT_STRING_EQUAL(client.requests[4].uri, "/0/2");
+    CU_ASSERT_STRING_EQUAL(client.requests[5].uri, "/1/2");
+    CU_ASSERT_STRING_EQUAL(client.requests[6].uri, "/bs");
+    CU_ASSERT_EQUAL(log.resultCount, 7);
+    CU_ASSERT_EQUAL(prv_count(&log, COAP_202_DELETED), 2);
+    CU_ASSERT_EQUAL(prv_count(&log, COAP_204_CHANGED), 5);
+    CU_ASSERT_STRING_EQUAL(log.uri[2], "/0/1");
+    CU_ASSERT_STRING_EQUAL(log.uri[6], "");
+
+    // the writes are sent once all the deletes completed
+    for (i = 2 ; i < 6 ; i++)
+    {
+        CU_ASSERT_EQUAL(client.requests[i].code, COAP_PUT);
+        CU_ASSERT(client.requests[i].sentAt >= client.requests[0].answerAt);
+        CU_ASSERT(client.requests[i].sentAt >= client.requests[1].answerAt);
+    }
+
+    // the Bootstrap-Finish is sent alone, after all the others completed
+    finishP = client.requests + 6;
+    CU_ASSERT_EQUAL(finishP->code, COAP_POST);
+    for (i = 0 ; i < 6 ; i++)
+    {
+        CU_ASSERT(finishP->sentAt >= client.requests[i].answerAt);
+    }
+
+    // each group of commands takes as many round trips as windows it fills
+    CU_ASSERT_EQUAL(client.maxInFlight, prv_min(LWM2M_BOOTSTRAP_WINDOW, 4));
+    CU_ASSERT_EQUAL(finishP->answerAt - start, (uint32_t)(RTT * (prv_trips(2) + prv_trips(4) + 1)));
+
+    lwm2m_close(contextP);
+}
+
+#if LWM2M_BOOTSTRAP_WINDOW == 1
+static void test_bootstrap_sequential(void)
+{
+    lwm2m_context_t * contextP;
+    harness_client_t client;
+    bs_log_t log;
+    uint32_t start;
+    int i;
+
+    contextP = prv_open(&log);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    harness_client_init(&client, RTT);
+    start = harness_now();
+    harness_bootstrap_request(contextP, &client, "client");
+    prv_configure(contextP, &client, 4);
+    harness_run(contextP, 0);
+
+    // with a window of one, each command waits for the previous one
+    CU_ASSERT_EQUAL_FATAL(client.requestCount, 7);
+    CU_ASSERT_EQUAL(client.maxInFlight, 1);
+    for (i = 1 ; i < client.requestCount ; i++)
+    {
+        CU_ASSERT_EQUAL(client.requests[i].sentAt, client.requests[i - 1].answerAt);
+    }
+    CU_ASSERT_EQUAL(client.requests[6].answerAt - start, 7 * RTT);
+    CU_ASSERT_EQUAL(prv_count(&log, COAP_202_DELETED) + prv_count(&log, COAP_204_CHANGED), 7);
+
+    lwm2m_close(contextP);
+}
+#endif
+
+static void test_bootstrap_failure(void)
+{
+    lwm2m_context_t * contextP;
+    harness_client_t client;
+    bs_log_t log;
+    int writeCount;
+    int sentWrites;
+
+    contextP = prv_open(&log);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    harness_client_init(&client, RTT);
+    // the first write fails, with at least two writes waiting for the window
+    client.failAt = 2;
+    writeCount = LWM2M_BOOTSTRAP_WINDOW + 2;
+    sentWrites = prv_min(LWM2M_BOOTSTRAP_WINDOW, writeCount);
+    harness_bootstrap_request(contextP, &client, "client");
+    prv_configure(contextP, &client, writeCount);
+    harness_run(contextP, 0);
+
+    // the waiting commands are cancelled, the ones in flight complete
+    CU_ASSERT_EQUAL(client.requestCount, 2 + sentWrites);
+    CU_ASSERT_EQUAL(log.resultCount, 2 + writeCount + 1);
+    CU_ASSERT_EQUAL(prv_count(&log, COAP_202_DELETED), 2);
+    CU_ASSERT_EQUAL(prv_count(&log, COAP_400_BAD_REQUEST), 1);
+    CU_ASSERT_EQUAL(prv_count(&log, COAP_204_CHANGED), sentWrites - 1);
+    CU_ASSERT_EQUAL(prv_count(&log, COAP_503_SERVICE_UNAVAILABLE), writeCount - sentWrites + 1);
+    CU_ASSERT_EQUAL(log.status[2], COAP_400_BAD_REQUEST);
+    CU_ASSERT_EQUAL(log.status[3], COAP_503_SERVICE_UNAVAILABLE);
+    CU_ASSERT_STRING_EQUAL(log.uri[2], "/0/1");
+
+    lwm2m_close(contextP);
+}
+
+static void test_bootstrap_restart(void)
+{
+    lwm2m_context_t * contextP;
+    harness_client_t client;
+    bs_log_t log;
+    int writeCount;
+    int sentDeletes;
+
+    contextP = prv_open(&log);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    harness_client_init(&client, RTT);
+    writeCount = LWM2M_BOOTSTRAP_WINDOW + 2;
+    sentDeletes = prv_min(LWM2M_BOOTSTRAP_WINDOW, 2);
+    harness_bootstrap_request(contextP, &client, "client");
+    prv_configure(contextP, &client, writeCount);
+
+    // the client starts over while the first deletes are in flight
+    harness_run(contextP, harness_now() + RTT / 2);
+    CU_ASSERT_EQUAL(harness_in_flight(&client), sentDeletes);
+    harness_bootstrap_request(contextP, &client, "client");
+    CU_ASSERT_EQUAL(client.bootstrapAnswer, COAP_204_CHANGED);
+    CU_ASSERT_EQUAL(log.requestCount, 2);
+    CU_ASSERT_EQUAL(log.resultCount, 2 - sentDeletes + writeCount + 1);
+    CU_ASSERT_EQUAL(prv_count(&log, COAP_503_SERVICE_UNAVAILABLE), log.resultCount);
+
+    // the deletes in flight still complete, nothing else is sent
+    harness_run(contextP, 0);
+    CU_ASSERT_EQUAL(client.requestCount, sentDeletes);
+    CU_ASSERT_EQUAL(prv_count(&log, COAP_202_DELETED), sentDeletes);
+
+    // the new attempt goes through
+    prv_configure(contextP, &client, writeCount);
+    harness_run(contextP, 0);
+    CU_ASSERT_EQUAL(client.requestCount, sentDeletes + 2 + writeCount + 1);
+    CU_ASSERT_EQUAL(prv_count(&log, COAP_202_DELETED), sentDeletes + 2);
+    CU_ASSERT_EQUAL(prv_count(&log, COAP_204_CHANGED), writeCount + 1);
+
+    lwm2m_close(contextP);
+}
+
+static void test_bootstrap_clients(void)
+{
+    lwm2m_context_t * contextP;
+    harness_client_t client1;
+    harness_client_t client2;
+    bs_log_t log;
+    uint32_t start;
+
+    contextP = prv_open(&log);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    harness_client_init(&client1, RTT);
+    harness_client_init(&client2, 2 * RTT);
+    start = harness_now();
+    harness_bootstrap_request(contextP, &client1, "client1");
+    harness_bootstrap_request(contextP, &client2, "client2");
+    prv_configure(contextP, &client1, 4);
+    prv_configure(contextP, &client2, 4);
+    harness_run(contextP, 0);
+
+    // each client has its own window
+    CU_ASSERT_EQUAL(client1.requestCount, 7);
+    CU_ASSERT_EQUAL(client2.requestCount, 7);
+    CU_ASSERT_EQUAL(client1.maxInFlight, prv_min(LWM2M_BOOTSTRAP_WINDOW, 4));
+    CU_ASSERT_EQUAL(client2.maxInFlight, prv_min(LWM2M_BOOTSTRAP_WINDOW, 4));
+    CU_ASSERT_EQUAL(client1.requests[6].answerAt - start, (uint32_t)(RTT * (prv_trips(2) + prv_trips(4) + 1)));
+    CU_ASSERT_EQUAL(client2.requests[6].answerAt - start, (uint32_t)(2 * RTT * (prv_trips(2) + prv_trips(4) + 1)));
+    CU_ASSERT_EQUAL(prv_count(&log, COAP_202_DELETED) + prv_count(&log, COAP_204_CHANGED), 14);
+
+    lwm2m_close(contextP);
+}
+
+#define DB_INI_FILE     "bootstraptests.ini"
+#define DB_IMAGE_FILE   "bootstraptests.db"
+
+#define DB_SERVER_SECTION   "[Server]\nid=1\nuri=coap://localhost:5683\nbootstrap=no\nlifetime=300\nsecurity=NoSec\n\n"
+#define DB_DEFAULT_SECTION  "[Endpoint]\nDelete=/0\n\n"
+#define DB_CLIENT_SECTION   "[Endpoint]\nName=client1\nDelete=/\nServer=1\n\n"
+
+// Compiles the .INI content and returns the saved image, mapped
+static bs_db_t * prv_db_open(const char * ini)
+{
+    FILE * fd;
+    bs_db_t * dbP;
+    int result;
+
+    fd = fopen(DB_INI_FILE, "w");
+    if (fd == NULL) return NULL;
+    fputs(ini, fd);
+    fclose(fd);
+
+    dbP = bs_db_open(DB_INI_FILE);
+    unlink(DB_INI_FILE);
+    if (dbP == NULL) return NULL;
+    CU_ASSERT_FALSE(dbP->isMapped);
+    result = bs_db_save(dbP, DB_IMAGE_FILE);
+    bs_db_close(dbP);
+    if (result != 0) return NULL;
+
+    dbP = bs_db_open(DB_IMAGE_FILE);
+    unlink(DB_IMAGE_FILE);
+    if (dbP != NULL) CU_ASSERT_TRUE(dbP->isMapped);
+
+    return dbP;
+}
+
+static void prv_check_client1(bs_db_t * dbP,
+                              bs_db_endpoint_t * endpointP)
+{
+    bs_db_command_t command;
+
+    CU_ASSERT_EQUAL_FATAL(endpointP->commandCount, 4);
+    CU_ASSERT_TRUE_FATAL(bs_db_get_command(dbP, endpointP, 0, &command));
+    CU_ASSERT_EQUAL(command.operation, BS_DELETE);
+    CU_ASSERT_EQUAL(command.uri.flag, 0);
+    CU_ASSERT_TRUE_FATAL(bs_db_get_command(dbP, endpointP, 1, &command));
+    CU_ASSERT_EQUAL(command.operation, BS_WRITE_SECURITY);
+    CU_ASSERT_EQUAL(command.serverId, 1);
+    CU_ASSERT_TRUE_FATAL(bs_db_get_command(dbP, endpointP, 2, &command));
+    CU_ASSERT_EQUAL(command.operation, BS_WRITE_SERVER);
+    CU_ASSERT_EQUAL(command.serverId, 1);
+    CU_ASSERT_TRUE_FATAL(bs_db_get_command(dbP, endpointP, 3, &command));
+    CU_ASSERT_EQUAL(command.operation, BS_FINISH);
+    CU_ASSERT_FALSE(bs_db_get_command(dbP, endpointP, 4, &command));
+}
+
+static void prv_check_default(bs_db_t * dbP,
+                              bs_db_endpoint_t * endpointP)
+{
+    bs_db_command_t command;
+
+    CU_ASSERT_EQUAL_FATAL(endpointP->commandCount, 2);
+    CU_ASSERT_TRUE_FATAL(bs_db_get_command(dbP, endpointP, 0, &command));
+    CU_ASSERT_EQUAL(command.operation, BS_DELETE);
+    CU_ASSERT_EQUAL(command.uri.flag, LWM2M_URI_FLAG_OBJECT_ID);
+    CU_ASSERT_EQUAL(command.uri.objectId, 0);
+    CU_ASSERT_TRUE_FATAL(bs_db_get_command(dbP, endpointP, 1, &command));
+    CU_ASSERT_EQUAL(command.operation, BS_FINISH);
+}
+
+static void test_bootstrap_db_lookup(void)
+{
+    bs_db_t * dbP;
+    bs_db_endpoint_t endpoint;
+
+    dbP = prv_db_open(DB_SERVER_SECTION DB_DEFAULT_SECTION DB_CLIENT_SECTION);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dbP);
+    CU_ASSERT_EQUAL(dbP->endpointCount, 2);
+
+    CU_ASSERT_TRUE(bs_db_find_endpoint(dbP, "client1", &endpoint));
+    prv_check_client1(dbP, &endpoint);
+
+    // unknown and missing names fall back to the default endpoint
+    CU_ASSERT_TRUE(bs_db_find_endpoint(dbP, "client2", &endpoint));
+    prv_check_default(dbP, &endpoint);
+    CU_ASSERT_TRUE(bs_db_find_endpoint(dbP, "client", &endpoint));
+    prv_check_default(dbP, &endpoint);
+    CU_ASSERT_TRUE(bs_db_find_endpoint(dbP, NULL, &endpoint));
+    prv_check_default(dbP, &endpoint);
+
+    bs_db_close(dbP);
+}
+
+static void test_bootstrap_db_no_default(void)
+{
+    bs_db_t * dbP;
+    bs_db_endpoint_t endpoint;
+
+    dbP = prv_db_open(DB_SERVER_SECTION DB_CLIENT_SECTION);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dbP);
+
+    CU_ASSERT_TRUE(bs_db_find_endpoint(dbP, "client1", &endpoint));
+    prv_check_client1(dbP, &endpoint);
+    CU_ASSERT_FALSE(bs_db_find_endpoint(dbP, "client2", &endpoint));
+    CU_ASSERT_FALSE(bs_db_find_endpoint(dbP, NULL, &endpoint));
+
+    bs_db_close(dbP);
+}
+
+int main()
+{
+    CU_pSuite pSuite = NULL;
+
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    pSuite = CU_add_suite("Suite_bootstrap_window", NULL, NULL);
+    if (NULL == pSuite
+     || NULL == CU_add_test(pSuite, "test of the command order", test_bootstrap_order)
+#if LWM2M_BOOTSTRAP_WINDOW == 1
+     || NULL == CU_add_test(pSuite, "test of the window of one command", test_bootstrap_sequential)
+#endif
+     || NULL == CU_add_test(pSuite, "test of a failed command", test_bootstrap_failure)
+     || NULL == CU_add_test(pSuite, "test of a new bootstrap request", test_bootstrap_restart)
+     || NULL == CU_add_test(pSuite, "test of the windows of several clients", test_bootstrap_clients))
+    {
+        goto exit;
+    }
+
+    pSuite = CU_add_suite("Suite_bootstrap_db", NULL, NULL);
+    if (NULL == pSuite
+     || NULL == CU_add_test(pSuite, "test of the endpoint lookups", test_bootstrap_db_lookup)
+     || NULL == CU_add_test(pSuite, "test of the lookups without default endpoint", test_bootstrap_db_no_default))
+    {
+        goto exit;
+    }
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+exit:
+    CU_cleanup_registry();
+    return CU_get_error();
+}
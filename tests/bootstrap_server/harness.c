@@ -0,0 +1,250 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "harness.h"
+#include "er-coap-13/er-coap-13.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#define HARNESS_MAX_CLIENTS     4
+
+static uint32_t g_now;
+static harness_client_t * g_clients[HARNESS_MAX_CLIENTS];
+static int g_clientCount;
+static uint16_t g_nextMID;
+
+void * lwm2m_malloc(size_t s)
+{
+    return malloc(s);
+}
+
+void lwm2m_free(void * p)
+{
+    free(p);
+}
+
+char * lwm2m_strdup(const char * str)
+{
+    return strdup(str);
+}
+
+int lwm2m_strncmp(const char * s1,
+                  const char * s2,
+                  size_t n)
+{
+    return strncmp(s1, s2, n);
+}
+
+time_t lwm2m_gettime(void)
+{
+    return (time_t)(g_now / 1000);
+}
+
+void lwm2m_printf(const char * format, ...)
+{
+    va_list ap;
+
+    va_start(ap, format);
+    vfprintf(stderr, format, ap);
+    va_end(ap);
+}
+
+bool lwm2m_session_is_equal(void * session1,
+                            void * session2,
+                            void * userData)
+{
+    (void)userData;
+
+    return (session1 == session2);
+}
+
+uint8_t lwm2m_buffer_send(void * sessionH,
+                          uint8_t * buffer,
+                          size_t length,
+                          void * userData)
+{
+    harness_client_t * clientP = (harness_client_t *)sessionH;
+    harness_request_t * requestP;
+    coap_packet_t message;
+    multi_option_t * optionP;
+    size_t uriLength;
+    int inFlight;
+
+    (void)userData;
+    if (coap_parse_message(&message, buffer, (uint16_t)length) != NO_ERROR) return COAP_500_INTERNAL_SERVER_ERROR;
+
+    if (message.type == COAP_TYPE_ACK)
+    {
+        // answer to the Bootstrap Request
+        clientP->bootstrapAnswer = message.code;
+        coap_free_header(&message);
+        return COAP_NO_ERROR;
+    }
+    if (clientP->requestCount == HARNESS_MAX_REQUESTS)
+    {
+        coap_free_header(&message);
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    requestP = clientP->requests + clientP->requestCount;
+    memset(requestP, 0, sizeof(harness_request_t));
+    requestP->mID = message.mid;
+    requestP->tokenLen = message.token_len;
+    memcpy(requestP->token, message.token, message.token_len);
+    requestP->code = message.code;
+    uriLength = 0;
+    for (optionP = message.uri_path ; optionP != NULL ; optionP = optionP->next)
+    {
+        if (uriLength + 1 + optionP->len >= sizeof(requestP->uri)) break;
+        requestP->uri[uriLength++] = '/';
+        memcpy(requestP->uri + uriLength, optionP->data, optionP->len);
+        uriLength += optionP->len;
+    }
+    requestP->uri[uriLength] = 0;
+    requestP->sentAt = g_now;
+    requestP->answerAt = g_now + clientP->rtt;
+    if (clientP->failAt == clientP->requestCount)
+    {
+        requestP->answer = COAP_400_BAD_REQUEST;
+    }
+    else
+    {
+        requestP->answer = (message.code == COAP_DELETE) ? COAP_202_DELETED : COAP_204_CHANGED;
+    }
+    clientP->requestCount++;
+    coap_free_header(&message);
+
+    inFlight = harness_in_flight(clientP);
+    if (inFlight > clientP->maxInFlight) clientP->maxInFlight = inFlight;
+
+    return COAP_NO_ERROR;
+}
+
+void harness_init(void)
+{
+    g_now = 1000000;
+    g_clientCount = 0;
+    g_nextMID = 1;
+}
+
+uint32_t harness_now(void)
+{
+    return g_now;
+}
+
+void harness_client_init(harness_client_t * clientP,
+                         uint32_t rtt)
+{
+    memset(clientP, 0, sizeof(harness_client_t));
+    clientP->rtt = rtt;
+    clientP->failAt = -1;
+    if (g_clientCount < HARNESS_MAX_CLIENTS)
+    {
+        g_clients[g_clientCount++] = clientP;
+    }
+}
+
+int harness_in_flight(harness_client_t * clientP)
+{
+    int count;
+    int i;
+
+    count = 0;
+    for (i = 0 ; i < clientP->requestCount ; i++)
+    {
+        if (!clientP->requests[i].answered) count++;
+    }
+
+    return count;
+}
+
+static void prv_send(lwm2m_context_t * contextP,
+                     harness_client_t * clientP,
+                     coap_packet_t * messageP)
+{
+    uint8_t * buffer;
+    size_t length;
+
+    length = coap_serialize_get_size(messageP);
+    buffer = (uint8_t *)malloc(length);
+    if (buffer == NULL) return;
+    length = coap_serialize_message(messageP, buffer);
+    lwm2m_handle_packet(contextP, buffer, (int)length, clientP);
+    free(buffer);
+}
+
+void harness_bootstrap_request(lwm2m_context_t * contextP,
+                               harness_client_t * clientP,
+                               const char * name)
+{
+    coap_packet_t message;
+    char query[64];
+
+    snprintf(query, sizeof(query), "ep=%s", name);
+    coap_init_message(&message, COAP_TYPE_CON, COAP_POST, g_nextMID++);
+    coap_set_header_uri_path(&message, "/bs");
+    coap_set_header_uri_query(&message, query);
+    clientP->bootstrapAnswer = 0;
+    prv_send(contextP, clientP, &message);
+    coap_free_header(&message);
+}
+
+void harness_run(lwm2m_context_t * contextP,
+                 uint32_t time)
+{
+    while (true)
+    {
+        harness_client_t * clientP = NULL;
+        harness_request_t * requestP = NULL;
+        coap_packet_t message;
+        time_t timeout;
+        int i;
+        int j;
+
+        // the earliest answer, in sending order for a same time
+        for (i = 0 ; i < g_clientCount ; i++)
+        {
+            for (j = 0 ; j < g_clients[i]->requestCount ; j++)
+            {
+                harness_request_t * targetP = g_clients[i]->requests + j;
+
+                if (targetP->answered) continue;
+                if (requestP == NULL || targetP->answerAt < requestP->answerAt)
+                {
+                    clientP = g_clients[i];
+                    requestP = targetP;
+                }
+            }
+        }
+        if (requestP == NULL || (time != 0 && requestP->answerAt > time)) break;
+
+        g_now = requestP->answerAt;
+        requestP->answered = true;
+        coap_init_message(&message, COAP_TYPE_ACK, requestP->answer, requestP->mID);
+        coap_set_header_token(&message, requestP->token, requestP->tokenLen);
+        prv_send(contextP, clientP, &message);
+        coap_free_header(&message);
+
+        timeout = 60;
+        lwm2m_step(contextP, &timeout);
+    }
+
+    if (time != 0 && time > g_now) g_now = time;
+}
@@ -0,0 +1,66 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#ifndef HARNESS_H_
+#define HARNESS_H_
+
+#include "liblwm2m.h"
+
+/*
+ * Simulated clients of a bootstrap server, on a network with a given round trip time.
+ *
+ * The platform functions of the library run on a virtual clock. Each request sent by the server
+ * to a client is answered after the round trip time of the client by lwm2m_handle_packet(),
+ * the clock moving to the time of the answer.
+ */
+
+#define HARNESS_MAX_REQUESTS    32
+
+typedef struct
+{
+    uint16_t    mID;
+    uint8_t     token[8];
+    size_t      tokenLen;
+    uint8_t     code;           // of the request
+    char        uri[32];        // path of the request, "" for none
+    uint32_t    sentAt;         // virtual time in ms
+    uint32_t    answerAt;
+    uint8_t     answer;         // code of the answer
+    bool        answered;
+} harness_request_t;
+
+// A client, and its session handle
+typedef struct
+{
+    uint32_t            rtt;            // round trip time in ms
+    int                 failAt;         // index of the request answered with 4.00, -1 for none
+    harness_request_t   requests[HARNESS_MAX_REQUESTS];
+    int                 requestCount;
+    int                 maxInFlight;    // highest number of requests waiting for their answer
+    uint8_t             bootstrapAnswer;
+} harness_client_t;
+
+void harness_init(void);
+uint32_t harness_now(void);
+void harness_client_init(harness_client_t * clientP, uint32_t rtt);
+// Sends a Bootstrap Request from the client at the current time
+void harness_bootstrap_request(lwm2m_context_t * contextP, harness_client_t * clientP, const char * name);
+// Delivers the answers due until the time, or all of them if time is 0
+void harness_run(lwm2m_context_t * contextP, uint32_t time);
+int harness_in_flight(harness_client_t * clientP);
+
+#endif
@@ -0,0 +1,437 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "tests.h"
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "liblwm2m.h"
+
+
+static lwm2m_data_t * prv_findChild(lwm2m_data_t * dataP,
+                                    int size,
+                                    uint16_t id)
+{
+    int i;
+
+    for (i = 0 ; i < size ; i++)
+    {
+        if (dataP[i].id == id) return dataP + i;
+    }
+
+    return NULL;
+}
+
+static void test_cbor_single_value(void)
+{
+    lwm2m_uri_t uri;
+    lwm2m_data_t data;
+    lwm2m_data_t * dataP;
+    lwm2m_media_type_t format;
+    uint8_t * buffer;
+    int length;
+    int64_t intValue;
+    double floatValue;
+    uint8_t intPayload[] = { 0x39, 0x01, 0xF3 };
+    uint8_t halfPayload[] = { 0xF9, 0x3E, 0x00 };
+    uint8_t textPayload[] = { 0xC0, 0x63, 'a', 'b', 'c' };
+
+    memset(&uri, 0, sizeof(uri));
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID | LWM2M_URI_FLAG_RESOURCE_ID;
+    uri.objectId = 3;
+    uri.instanceId = 0;
+    uri.resourceId = 9;
+
+    memset(&data, 0, sizeof(data));
+    data.id = 9;
+    lwm2m_data_encode_int(-500, &data);
+    format = LWM2M_CONTENT_CBOR;
+    length = lwm2m_data_serialize(&uri, 1, &data, &format, &buffer);
+    CU_ASSERT_EQUAL(format, LWM2M_CONTENT_CBOR);
+    CU_ASSERT_EQUAL(length, sizeof(intPayload));
+    if (length == sizeof(intPayload))
+    {
+        CU_ASSERT_EQUAL(memcmp(buffer, intPayload, length), 0);
+    }
+    lwm2m_free(buffer);
+
+    length = lwm2m_data_parse(&uri, intPayload, sizeof(intPayload), LWM2M_CONTENT_CBOR, &dataP);
+    CU_ASSERT_EQUAL(length, 1);
+    if (length == 1)
+    {
+        CU_ASSERT_EQUAL(dataP->id, 9);
+        CU_ASSERT_EQUAL(lwm2m_data_decode_int(dataP, &intValue), 1);
+        CU_ASSERT_EQUAL(intValue, -500);
+        lwm2m_data_free(length, dataP);
+    }
+
+    // half precision float
+    length = lwm2m_data_parse(&uri, halfPayload, sizeof(halfPayload), LWM2M_CONTENT_CBOR, &dataP);
+    CU_ASSERT_EQUAL(length, 1);
+    if (length == 1)
+    {
+        CU_ASSERT_EQUAL(lwm2m_data_decode_float(dataP, &floatValue), 1);
+        CU_ASSERT_DOUBLE_EQUAL(floatValue, 1.5, 0);
+        lwm2m_data_free(length, dataP);
+    }
+
+    // tagged text string, borrowed from the payload
+    length = lwm2m_data_parse_borrowed(&uri, textPayload, sizeof(textPayload), LWM2M_CONTENT_CBOR, &dataP);
+    CU_ASSERT_EQUAL(length, 1);
+    if (length == 1)
+    {
+        CU_ASSERT_EQUAL(dataP->type, LWM2M_TYPE_STRING);
+        CU_ASSERT_PTR_EQUAL(dataP->value.asBuffer.buffer, textPayload + 2);
+        CU_ASSERT_EQUAL(dataP->value.asBuffer.length, 3);
+        lwm2m_data_free(length, dataP);
+    }
+
+    // trailing byte
+    length = lwm2m_data_parse(&uri, intPayload, sizeof(intPayload) - 1, LWM2M_CONTENT_CBOR, &dataP);
+    CU_ASSERT_EQUAL(length, 0);
+}
+
+static void test_senml_cbor_encoding(void)
+{
+    lwm2m_uri_t uri;
+    lwm2m_data_t * dataP;
+    lwm2m_media_type_t format;
+    uint8_t * buffer;
+    int length;
+    // [{-2: "/3/0/", 0: "1", 3: "ab"}, {0: "2", 2: 1.5}]
+    uint8_t expected[] = { 0x82,
+                           0xA3, 0x21, 0x65, '/', '3', '/', '0', '/', 0x00, 0x61, '1', 0x03, 0x62, 'a', 'b',
+                           0xA2, 0x00, 0x61, '2', 0x02, 0xFA, 0x3F, 0xC0, 0x00, 0x00 };
+
+    memset(&uri, 0, sizeof(uri));
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+    uri.objectId = 3;
+    uri.instanceId = 0;
+
+    dataP = lwm2m_data_new(2);
+    dataP[0].id = 1;
+    lwm2m_data_encode_string("ab", dataP);
+    dataP[1].id = 2;
+    lwm2m_data_encode_float(1.5, dataP + 1);
+
+    format = LWM2M_CONTENT_SENML_CBOR;
+    length = lwm2m_data_serialize(&uri, 2, dataP, &format, &buffer);
+    CU_ASSERT_EQUAL(length, sizeof(expected));
+    if (length == sizeof(expected))
+    {
+        CU_ASSERT_EQUAL(memcmp(buffer, expected, length), 0);
+    }
+    lwm2m_free(buffer);
+    lwm2m_data_free(2, dataP);
+
+    // single value CBOR falls back to SenML CBOR for an instance
+    dataP = lwm2m_data_new(1);
+    dataP[0].id = 1;
+    lwm2m_data_encode_int(5, dataP);
+    format = LWM2M_CONTENT_CBOR;
+    length = lwm2m_data_serialize(&uri, 1, dataP, &format, &buffer);
+    CU_ASSERT_EQUAL(format, LWM2M_CONTENT_SENML_CBOR);
+    CU_ASSERT_TRUE(length > 0);
+    lwm2m_free(buffer);
+    lwm2m_data_free(1, dataP);
+}
+
+static void test_senml_cbor_round_trip(void)
+{
+    lwm2m_uri_t uri;
+    lwm2m_data_t * instanceP;
+    lwm2m_data_t * resourcesP;
+    lwm2m_data_t * dataP;
+    lwm2m_data_t * childP;
+    lwm2m_media_type_t format;
+    uint8_t opaque[] = { 0x00, 0xFF, 0x22, 0x5C };
+    uint8_t * buffer;
+    int length;
+    int size;
+    int64_t intValue;
+    double floatValue;
+    bool boolValue;
+
+    memset(&uri, 0, sizeof(uri));
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    uri.objectId = 1024;
+
+    resourcesP = lwm2m_data_new(7);
+    resourcesP[0].id = 0;
+    lwm2m_data_encode_int(-3000000000LL, resourcesP);
+    resourcesP[1].id = 1;
+    lwm2m_data_encode_float(0.1, resourcesP + 1);
+    resourcesP[2].id = 2;
+    lwm2m_data_encode_string("quote \" and \\", resourcesP + 2);
+    resourcesP[3].id = 3;
+    lwm2m_data_encode_bool(true, resourcesP + 3);
+    resourcesP[4].id = 4;
+    lwm2m_data_encode_opaque(opaque, sizeof(opaque), resourcesP + 4);
+    resourcesP[5].id = 5;
+    lwm2m_data_encode_objlink(3, 65535, resourcesP + 5);
+    resourcesP[6].id = 6;
+    childP = lwm2m_data_new(2);
+    childP[0].id = 0;
+    lwm2m_data_encode_int(10, childP);
+    childP[1].id = 7;
+    lwm2m_data_encode_int(20, childP + 1);
+    lwm2m_data_encode_instances(childP, 2, resourcesP + 6);
+    instanceP = lwm2m_data_new(2);
+    instanceP[0].id = 0;
+    lwm2m_data_encode_instances(resourcesP, 7, instanceP);
+    instanceP[0].type = LWM2M_TYPE_OBJECT_INSTANCE;
+    instanceP[1].id = 1;
+    childP = lwm2m_data_new(1);
+    childP[0].id = 0;
+    lwm2m_data_encode_int(1, childP);
+    lwm2m_data_encode_instances(childP, 1, instanceP + 1);
+    instanceP[1].type = LWM2M_TYPE_OBJECT_INSTANCE;
+
+    format = LWM2M_CONTENT_SENML_CBOR;
+    length = lwm2m_data_serialize(&uri, 2, instanceP, &format, &buffer);
+    lwm2m_data_free(2, instanceP);
+    CU_ASSERT_TRUE_FATAL(length > 0);
+
+    size = lwm2m_data_parse(&uri, buffer, length, LWM2M_CONTENT_SENML_CBOR, &dataP);
+    lwm2m_free(buffer);
+    CU_ASSERT_EQUAL_FATAL(size, 2);
+    CU_ASSERT_EQUAL(dataP[0].type, LWM2M_TYPE_OBJECT_INSTANCE);
+    CU_ASSERT_EQUAL(dataP[0].value.asChildren.count, 7);
+    CU_ASSERT_EQUAL(dataP[1].value.asChildren.count, 1);
+    resourcesP = dataP[0].value.asChildren.array;
+
+    childP = prv_findChild(resourcesP, 7, 0);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(childP);
+    CU_ASSERT_EQUAL(lwm2m_data_decode_int(childP, &intValue), 1);
+    CU_ASSERT_EQUAL(intValue, -3000000000LL);
+
+    childP = prv_findChild(resourcesP, 7, 1);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(childP);
+    CU_ASSERT_EQUAL(lwm2m_data_decode_float(childP, &floatValue), 1);
+    CU_ASSERT_DOUBLE_EQUAL(floatValue, 0.1, 0);
+
+    childP = prv_findChild(resourcesP, 7, 2);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(childP);
+    CU_ASSERT_EQUAL(childP->type, LWM2M_TYPE_STRING);
+    CU_ASSERT_EQUAL(childP->value.asBuffer.length, 13);
+    CU_ASSERT_NSTRING_EQUAL(childP->value.asBuffer.buffer, "quote \" and \\", 13);
+
+    childP = prv_findChild(resourcesP, 7, 3);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(childP);
+    CU_ASSERT_EQUAL(lwm2m_data_decode_bool(childP, &boolValue), 1);
+    CU_ASSERT_TRUE(boolValue);
+
+    childP = prv_findChild(resourcesP, 7, 4);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(childP);
+    CU_ASSERT_EQUAL(childP->type, LWM2M_TYPE_OPAQUE);
+    CU_ASSERT_EQUAL(childP->value.asBuffer.length, sizeof(opaque));
+    CU_ASSERT_EQUAL(memcmp(childP->value.asBuffer.buffer, opaque, sizeof(opaque)), 0);
+
+    childP = prv_findChild(resourcesP, 7, 5);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(childP);
+    CU_ASSERT_EQUAL(childP->type, LWM2M_TYPE_OBJECT_LINK);
+    CU_ASSERT_EQUAL(childP->value.asObjLink.objectId, 3);
+    CU_ASSERT_EQUAL(childP->value.asObjLink.objectInstanceId, 65535);
+
+    childP = prv_findChild(resourcesP, 7, 6);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(childP);
+    CU_ASSERT_EQUAL(childP->type, LWM2M_TYPE_MULTIPLE_RESOURCE);
+    CU_ASSERT_EQUAL(childP->value.asChildren.count, 2);
+    childP = prv_findChild(childP->value.asChildren.array, 2, 7);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(childP);
+    CU_ASSERT_EQUAL(lwm2m_data_decode_int(childP, &intValue), 1);
+    CU_ASSERT_EQUAL(intValue, 20);
+
+    lwm2m_data_free(size, dataP);
+}
+
+static void test_senml_cbor_parse(void)
+{
+    lwm2m_uri_t uri;
+    lwm2m_data_t * dataP;
+    int size;
+    // indefinite length array and map, names relative to the request URI
+    uint8_t relative[] = { 0x9F,
+                           0xBF, 0x00, 0x61, '1', 0x02, 0x01, 0xFF,
+                           0xA2, 0x00, 0x63, '2', '/', '3', 0x04, 0xF5,
+                           0xFF };
+    // unknown labels are skipped, base name set in the second record
+    uint8_t absolute[] = { 0x82,
+                           0xA3, 0x00, 0x66, '/', '3', '/', '0', '/', '1', 0x01, 0x61, 'V', 0x02, 0x01,
+                           0xA4, 0x21, 0x64, '/', '3', '/', '0', 0x00, 0x62, '/', '2', 0x06, 0x00, 0x03, 0x60 };
+    uint8_t duplicate[] = { 0x82,
+                            0xA2, 0x00, 0x61, '1', 0x02, 0x01,
+                            0xA2, 0x00, 0x61, '1', 0x02, 0x02 };
+    uint8_t mustUnderstand[] = { 0x81, 0xA3, 0x00, 0x61, '1', 0x02, 0x01, 0x62, 'x', '_', 0x00 };
+    uint8_t baseValue[] = { 0x81, 0xA3, 0x00, 0x61, '1', 0x02, 0x01, 0x24, 0x01 };
+    uint8_t truncated[] = { 0x81, 0xA2, 0x00, 0x61, '1', 0x03, 0x65, 'a', 'b' };
+    uint8_t wrongType[] = { 0x81, 0xA2, 0x00, 0x61, '1', 0x03, 0x01 };
+    // the base time and the time add up to 0: the values are current
+    uint8_t now[] = { 0x82,
+                      0xA4, 0x22, 0x0A, 0x00, 0x61, '1', 0x06, 0x29, 0x02, 0x01,
+                      0xA3, 0x00, 0x61, '2', 0x06, 0x29, 0x02, 0x02 };
+    uint8_t past[] = { 0x81, 0xA3, 0x00, 0x61, '1', 0x06, 0x29, 0x02, 0x01 };
+    uint8_t wrongTime[] = { 0x81, 0xA3, 0x00, 0x61, '1', 0x06, 0x61, '0', 0x02, 0x01 };
+
+    memset(&uri, 0, sizeof(uri));
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+    uri.objectId = 3;
+    uri.instanceId = 0;
+
+    size = lwm2m_data_parse(&uri, relative, sizeof(relative), LWM2M_CONTENT_SENML_CBOR, &dataP);
+    CU_ASSERT_EQUAL(size, 2);
+    if (size == 2)
+    {
+        CU_ASSERT_EQUAL(dataP[0].id, 1);
+        CU_ASSERT_EQUAL(dataP[0].type, LWM2M_TYPE_INTEGER);
+        CU_ASSERT_EQUAL(dataP[1].id, 2);
+        CU_ASSERT_EQUAL(dataP[1].type, LWM2M_TYPE_MULTIPLE_RESOURCE);
+        lwm2m_data_free(size, dataP);
+    }
+
+    size = lwm2m_data_parse(&uri, absolute, sizeof(absolute), LWM2M_CONTENT_SENML_CBOR, &dataP);
+    CU_ASSERT_EQUAL(size, 2);
+    if (size == 2)
+    {
+        CU_ASSERT_EQUAL(dataP[1].id, 2);
+        CU_ASSERT_EQUAL(dataP[1].type, LWM2M_TYPE_STRING);
+        CU_ASSERT_EQUAL(dataP[1].value.asBuffer.length, 0);
+        lwm2m_data_free(size, dataP);
+    }
+
+    size = lwm2m_data_parse(&uri, duplicate, sizeof(duplicate), LWM2M_CONTENT_SENML_CBOR, &dataP);
+    CU_ASSERT_EQUAL(size, -1);
+    size = lwm2m_data_parse(&uri, mustUnderstand, sizeof(mustUnderstand), LWM2M_CONTENT_SENML_CBOR, &dataP);
+    CU_ASSERT_EQUAL(size, -1);
+    size = lwm2m_data_parse(&uri, baseValue, sizeof(baseValue), LWM2M_CONTENT_SENML_CBOR, &dataP);
+    CU_ASSERT_EQUAL(size, -1);
+    size = lwm2m_data_parse(&uri, truncated, sizeof(truncated), LWM2M_CONTENT_SENML_CBOR, &dataP);
+    CU_ASSERT_EQUAL(size, -1);
+    size = lwm2m_data_parse(&uri, wrongType, sizeof(wrongType), LWM2M_CONTENT_SENML_CBOR, &dataP);
+    CU_ASSERT_EQUAL(size, -1);
+
+    size = lwm2m_data_parse(&uri, now, sizeof(now), LWM2M_CONTENT_SENML_CBOR, &dataP);
+    CU_ASSERT_EQUAL(size, 2);
+    if (size > 0) lwm2m_data_free(size, dataP);
+    size = lwm2m_data_parse(&uri, past, sizeof(past), LWM2M_CONTENT_SENML_CBOR, &dataP);
+    CU_ASSERT_EQUAL(size, -1);
+    size = lwm2m_data_parse(&uri, wrongTime, sizeof(wrongTime), LWM2M_CONTENT_SENML_CBOR, &dataP);
+    CU_ASSERT_EQUAL(size, -1);
+}
+
+static void test_senml_cbor_composite(void)
+{
+    lwm2m_uri_t uris[3];
+    lwm2m_uri_t * urisP;
+    senml_part_t parts[2];
+    lwm2m_data_t * dataP;
+    lwm2m_data_t * childP;
+    utils_buffer_t payload;
+    int count;
+    int size;
+    int64_t intValue;
+    uint8_t withValue[] = { 0x81, 0xA2, 0x00, 0x64, '/', '3', '/', '0', 0x02, 0x01 };
+    uint8_t root[] = { 0x81, 0xA1, 0x00, 0x61, '/' };
+
+    memset(uris, 0, sizeof(uris));
+    uris[0].flag = LWM2M_URI_FLAG_OBJECT_ID;
+    uris[0].objectId = 1;
+    uris[1].flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID | LWM2M_URI_FLAG_RESOURCE_ID;
+    uris[1].objectId = 3;
+    uris[1].instanceId = 0;
+    uris[1].resourceId = 13;
+    uris[2].flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+    uris[2].objectId = 1024;
+    uris[2].instanceId = 11;
+
+    utils_bufferInit(&payload, NULL, 0);
+    CU_ASSERT_TRUE_FATAL(senml_cbor_serializeUris(3, uris, &payload) > 0);
+    count = senml_cbor_parseUris(payload.data, payload.length, &urisP);
+    utils_bufferFree(&payload);
+    CU_ASSERT_EQUAL_FATAL(count, 3);
+    CU_ASSERT_EQUAL(memcmp(urisP, uris, sizeof(uris)), 0);
+    lwm2m_free(urisP);
+
+    CU_ASSERT_EQUAL(senml_cbor_parseUris(withValue, sizeof(withValue), &urisP), -1);
+    CU_ASSERT_PTR_NULL(urisP);
+    CU_ASSERT_EQUAL(senml_cbor_parseUris(root, sizeof(root), &urisP), -1);
+
+    // the values read at /3/0/13 and /1024/11 in a single pack
+    parts[0].uriP = uris + 1;
+    parts[0].size = 1;
+    parts[0].dataP = lwm2m_data_new(1);
+    parts[0].dataP->id = 13;
+    lwm2m_data_encode_int(1500000000, parts[0].dataP);
+    parts[1].uriP = uris + 2;
+    parts[1].size = 2;
+    parts[1].dataP = lwm2m_data_new(2);
+    parts[1].dataP[0].id = 0;
+    lwm2m_data_encode_int(7, parts[1].dataP);
+    parts[1].dataP[1].id = 1;
+    lwm2m_data_encode_string("seven", parts[1].dataP + 1);
+
+    utils_bufferInit(&payload, NULL, 0);
+    CU_ASSERT_TRUE(senml_cbor_serializeParts(2, parts, &payload) > 0);
+    lwm2m_data_free(parts[0].size, parts[0].dataP);
+    lwm2m_data_free(parts[1].size, parts[1].dataP);
+
+    size = lwm2m_data_parse(NULL, payload.data, payload.length, LWM2M_CONTENT_SENML_CBOR, &dataP);
+    utils_bufferFree(&payload);
+    CU_ASSERT_EQUAL_FATAL(size, 2);
+
+    childP = prv_findChild(dataP, size, 3);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(childP);
+    CU_ASSERT_EQUAL_FATAL(childP->value.asChildren.count, 1);
+    childP = childP->value.asChildren.array;
+    CU_ASSERT_EQUAL(childP->id, 0);
+    CU_ASSERT_EQUAL_FATAL(childP->value.asChildren.count, 1);
+    childP = childP->value.asChildren.array;
+    CU_ASSERT_EQUAL(childP->id, 13);
+    CU_ASSERT_EQUAL(lwm2m_data_decode_int(childP, &intValue), 1);
+    CU_ASSERT_EQUAL(intValue, 1500000000);
+
+    childP = prv_findChild(dataP, size, 1024);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(childP);
+    CU_ASSERT_EQUAL_FATAL(childP->value.asChildren.count, 1);
+    childP = childP->value.asChildren.array;
+    CU_ASSERT_EQUAL(childP->id, 11);
+    CU_ASSERT_EQUAL(childP->value.asChildren.count, 2);
+    childP = prv_findChild(childP->value.asChildren.array, 2, 1);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(childP);
+    CU_ASSERT_EQUAL(childP->type, LWM2M_TYPE_STRING);
+    CU_ASSERT_NSTRING_EQUAL(childP->value.asBuffer.buffer, "seven", 5);
+
+    lwm2m_data_free(size, dataP);
+}
+
+static struct TestTable table[] = {
+        { "test of single value CBOR", test_cbor_single_value },
+        { "test of SenML CBOR encoding", test_senml_cbor_encoding },
+        { "test of SenML CBOR round trip", test_senml_cbor_round_trip },
+        { "test of SenML CBOR parsing", test_senml_cbor_parse },
+        { "test of SenML CBOR composite payloads", test_senml_cbor_composite },
+        { NULL, NULL },
+};
+
+CU_ErrorCode create_cbor_suit() {
+    CU_pSuite pSuite = NULL;
+    pSuite = CU_add_suite("Suite_CBOR", NULL, NULL);
+
+    if (NULL == pSuite) {
+        return CU_get_error();
+    }
+    return add_tests(pSuite, table);
+}
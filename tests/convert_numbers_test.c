@@ -25,10 +25,11 @@
 #include <unistd.h>
 #include <stdio.h>
 #include <inttypes.h>
+#include <math.h>
 
 const char * tests[]={"1", "-114" , "2", "0", "-2", "919293949596979899", "-98979969594939291", "999999999999999999999999999999", "1.2" , "0.134" , "432f.43" , "0.01", "1.00000000000002", NULL};
 int64_t tests_expected_int[]={1,-114,2,0,-2,919293949596979899,-98979969594939291,-1,-1,-1,-1,-1,-1};
-double tests_expected_float[]={1,-114,2,0,-2,9.1929394959698e+17,-9.897996959493928e+16,1e+30,1.2,0.134,-1,0.01,1.00000000000002};
+double tests_expected_float[]={1,-114,2,0,-2,919293949596979899.0,-98979969594939291.0,1e+30,1.2,0.134,-1,0.01,1.00000000000002};
 
 int64_t ints[]={12, -114 , 1 , 134 , 43243 , 0, -215025};
 const char* ints_expected[] = {"12","-114","1", "134", "43243","0","-215025"};
@@ -101,11 +102,221 @@ static void test_utils_floatToText(void)
     }
 }
 
+static const struct
+{
+    double value;
+    const char * text;
+} shortest_floats[] =
+{
+    { 0.1, "0.1" },
+    { 0.30000000000000004, "0.30000000000000004" },
+    { -0.0, "-0" },
+    { 123.456, "123.456" },
+    { 1e-6, "0.000001" },
+    { 1e-7, "1e-7" },
+    { 1e20, "100000000000000000000" },
+    { 1e21, "1e+21" },
+    { 4e38, "4e+38" },
+    { -4e38, "-4e+38" },
+    { 9007199254740993.0, "9007199254740992" },
+    { 5e-324, "5e-324" },
+    { 2.2250738585072014e-308, "2.2250738585072014e-308" },
+    { 1.7976931348623157e308, "1.7976931348623157e+308" },
+};
+
+static const struct
+{
+    const char * text;
+    double value;
+} exact_floats[] =
+{
+    { "0.1", 0.1 },
+    { "1e23", 1e23 },
+    { ".5", 0.5 },
+    { "-0", -0.0 },
+    { "1.5E+3", 1500 },
+    { "2.5e-3", 0.0025 },
+    { "9007199254740993", 9007199254740992.0 },
+    { "9007199254740993.0000000000000000000001", 9007199254740994.0 },
+    { "123456789012345678901234567890", 1.2345678901234568e29 },
+    { "2.2250738585072011e-308", 2.2250738585072011e-308 },
+    { "4.9e-324", 4.9e-324 },
+    { "2.4703282292062328e-324", 4.9e-324 },
+    { "2.4703282292062327e-324", 0.0 },
+    { "1e-400", 0.0 },
+    { "1.7976931348623157e308", 1.7976931348623157e308 },
+};
+
+static const char * invalid_floats[] = { "", "-", "1.", "e5", "1e", "1e+", "1.5.3", "0x10", "inf", "nan", "1e400", "-1.8e308", NULL };
+
+static bool prv_sameDouble(double a,
+                           double b)
+{
+    return 0 == memcmp(&a, &b, sizeof(double));
+}
+
+static int prv_significantDigits(const uint8_t * text,
+                                 size_t length)
+{
+    size_t i;
+    int count;
+    int zeros;
+
+    count = 0;
+    zeros = 0;
+    for (i = 0 ; i < length && text[i] != 'e' ; i++)
+    {
+        if (text[i] < '0' || text[i] > '9') continue;
+        if (text[i] == '0')
+        {
+            if (count != 0) zeros++;
+        }
+        else
+        {
+            count += zeros + 1;
+            zeros = 0;
+        }
+    }
+
+    return count;
+}
+
+// Formats and parses back, returning false if the value changed.
+static bool prv_roundTrip(double value,
+                          uint8_t * text,
+                          size_t * lengthP)
+{
+    double result;
+
+    *lengthP = utils_floatToText(value, text, FLOAT_MAX_STRING_LEN);
+    if (*lengthP == 0) return false;
+    if (utils_textToFloat(text, *lengthP, &result) != 1) return false;
+
+    return prv_sameDouble(value, result);
+}
+
+static void test_utils_floatToText_shortest(void)
+{
+    uint8_t res[FLOAT_MAX_STRING_LEN];
+    size_t i;
+    size_t len;
+
+    for (i = 0 ; i < sizeof(shortest_floats) / sizeof(shortest_floats[0]) ; i++)
+    {
+        len = utils_floatToText(shortest_floats[i].value, res, sizeof(res));
+
+        CU_ASSERT_EQUAL(len, strlen(shortest_floats[i].text));
+        CU_ASSERT_NSTRING_EQUAL(res, shortest_floats[i].text, len);
+    }
+
+    CU_ASSERT_EQUAL(utils_floatToText(0.30000000000000004, res, 10), 0);
+    CU_ASSERT_EQUAL(utils_floatToText(HUGE_VAL, res, sizeof(res)), 0);
+    CU_ASSERT_EQUAL(utils_floatToText(-HUGE_VAL, res, sizeof(res)), 0);
+}
+
+static void test_utils_textToFloat_exact(void)
+{
+    size_t i;
+    double res;
+
+    for (i = 0 ; i < sizeof(exact_floats) / sizeof(exact_floats[0]) ; i++)
+    {
+        CU_ASSERT_EQUAL(utils_textToFloat((uint8_t *)exact_floats[i].text, strlen(exact_floats[i].text), &res), 1);
+        CU_ASSERT(prv_sameDouble(res, exact_floats[i].value));
+    }
+
+    for (i = 0 ; invalid_floats[i] != NULL ; i++)
+    {
+        CU_ASSERT_EQUAL(utils_textToFloat((uint8_t *)invalid_floats[i], strlen(invalid_floats[i]), &res), 0);
+    }
+}
+
+static void test_utils_float_roundtrip(void)
+{
+    uint8_t text[FLOAT_MAX_STRING_LEN];
+    size_t len;
+    uint64_t seed;
+    uint64_t bits;
+    double value;
+    int failures;
+    int i;
+
+    failures = 0;
+
+    // every binary exponent with the smallest, next and largest significands
+    for (i = 0 ; i < 2 * 0x7FF ; i++)
+    {
+        static const uint64_t significands[] = { 0, 1, 0x000FFFFFFFFFFFFFULL };
+        size_t j;
+
+        for (j = 0 ; j < sizeof(significands) / sizeof(significands[0]) ; j++)
+        {
+            bits = ((uint64_t)(i % 0x7FF) << 52) | significands[j];
+            if (i >= 0x7FF) bits |= 0x8000000000000000ULL;
+            memcpy(&value, &bits, sizeof(value));
+            if (!prv_roundTrip(value, text, &len)) failures++;
+        }
+    }
+
+    // random bit patterns
+    seed = 88172645463325252ULL;
+    for (i = 0 ; i < 100000 ; i++)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        bits = seed;
+        if ((bits & 0x7FF0000000000000ULL) == 0x7FF0000000000000ULL) continue;
+        memcpy(&value, &bits, sizeof(value));
+        if (!prv_roundTrip(value, text, &len)) failures++;
+    }
+
+    CU_ASSERT_EQUAL(failures, 0);
+}
+
+static void test_utils_float_decimals(void)
+{
+    uint8_t text[FLOAT_MAX_STRING_LEN];
+    char input[32];
+    size_t len;
+    double value;
+    int failures;
+    int exponent;
+    int n;
+
+    // every decimal with up to 4 significant digits over a wide range must
+    // parse like strtod() and be written back with no more digits
+    failures = 0;
+    for (exponent = -30 ; exponent <= 30 ; exponent++)
+    {
+        for (n = 1 ; n <= 9999 ; n++)
+        {
+            int inputLen;
+
+            if (n % 10 == 0) continue;
+            inputLen = snprintf(input, sizeof(input), "%de%d", n, exponent);
+            if (utils_textToFloat((uint8_t *)input, inputLen, &value) != 1
+             || !prv_sameDouble(value, strtod(input, NULL))
+             || !prv_roundTrip(value, text, &len)
+             || prv_significantDigits(text, len) > prv_significantDigits((uint8_t *)input, inputLen))
+            {
+                failures++;
+            }
+        }
+    }
+
+    CU_ASSERT_EQUAL(failures, 0);
+}
+
 static struct TestTable table[] = {
         { "test of utils_textToInt()", test_utils_textToInt },
         { "test of utils_textToFloat()", test_utils_textToFloat },
         { "test of utils_intToText()", test_utils_intToText },
         { "test of utils_floatToText()", test_utils_floatToText },
+        { "test of utils_floatToText() shortest output", test_utils_floatToText_shortest },
+        { "test of utils_textToFloat() rounding", test_utils_textToFloat_exact },
+        { "test of float text round trips", test_utils_float_roundtrip },
+        { "test of decimal float texts", test_utils_float_decimals },
         { NULL, NULL },
 };
 
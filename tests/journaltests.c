@@ -0,0 +1,504 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "tests.h"
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "liblwm2m.h"
+#include "memtest.h"
+#include "filejournal.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#define TEST_OBJECT_ID  1024
+
+// Log of the journal, given as user data of the context
+typedef struct
+{
+    uint8_t * data;
+    size_t    length;
+    int       appendCount;
+    int       replaceCount;
+    file_journal_t * fileP;     // the journal file of the client example, NULL for data
+} journal_log_t;
+
+int lwm2m_journal_open(uint8_t ** bufferP,
+                       size_t * lengthP,
+                       void * userData)
+{
+    journal_log_t * logP = (journal_log_t *)userData;
+
+    if (logP->fileP != NULL) return file_journal_open(logP->fileP, bufferP, lengthP);
+    *bufferP = logP->data;
+    *lengthP = logP->length;
+    return 0;
+}
+
+void lwm2m_journal_close(uint8_t * buffer,
+                         size_t length,
+                         void * userData)
+{
+    journal_log_t * logP = (journal_log_t *)userData;
+
+    if (logP->fileP != NULL) file_journal_close(logP->fileP, buffer, length);
+}
+
+int lwm2m_journal_append(uint8_t * buffer,
+                         size_t length,
+                         void * userData)
+{
+    journal_log_t * logP = (journal_log_t *)userData;
+    uint8_t * data;
+
+    logP->appendCount++;
+    if (logP->fileP != NULL) return file_journal_append(logP->fileP, buffer, length);
+    data = (uint8_t *)lwm2m_malloc(logP->length + length);
+    if (data == NULL) return -1;
+    if (logP->data != NULL)
+    {
+        memcpy(data, logP->data, logP->length);
+        lwm2m_free(logP->data);
+    }
+    memcpy(data + logP->length, buffer, length);
+    logP->data = data;
+    logP->length += length;
+    return 0;
+}
+
+int lwm2m_journal_replace(uint8_t * buffer,
+                          size_t length,
+                          void * userData)
+{
+    journal_log_t * logP = (journal_log_t *)userData;
+
+    logP->replaceCount++;
+    if (logP->fileP != NULL) return file_journal_replace(logP->fileP, buffer, length);
+    if (logP->data != NULL) lwm2m_free(logP->data);
+    logP->data = NULL;
+    logP->length = 0;
+    if (length == 0) return 0;
+    logP->data = (uint8_t *)lwm2m_malloc(length);
+    if (logP->data == NULL) return -1;
+    memcpy(logP->data, buffer, length);
+    logP->length = length;
+    return 0;
+}
+
+// Object 1024 whose instances hold an integer resource 0
+typedef struct _test_instance_
+{
+    struct _test_instance_ * next;
+    uint16_t id;
+    int64_t  value;
+} test_instance_t;
+
+static uint8_t prv_read(uint16_t instanceId,
+                        int * numDataP,
+                        lwm2m_data_t ** dataArrayP,
+                        lwm2m_object_t * objectP)
+{
+    test_instance_t * instanceP;
+
+    instanceP = (test_instance_t *)lwm2m_list_find(objectP->instanceList, instanceId);
+    if (instanceP == NULL) return COAP_404_NOT_FOUND;
+
+    *dataArrayP = lwm2m_data_new(1);
+    if (*dataArrayP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+    *numDataP = 1;
+    (*dataArrayP)->id = 0;
+    lwm2m_data_encode_int(instanceP->value, *dataArrayP);
+
+    return COAP_205_CONTENT;
+}
+
+static uint8_t prv_write(uint16_t instanceId,
+                         int numData,
+                         lwm2m_data_t * dataArray,
+                         lwm2m_object_t * objectP)
+{
+    test_instance_t * instanceP;
+
+    instanceP = (test_instance_t *)lwm2m_list_find(objectP->instanceList, instanceId);
+    if (instanceP == NULL) return COAP_404_NOT_FOUND;
+    if (numData != 1 || dataArray->id != 0) return COAP_400_BAD_REQUEST;
+    if (lwm2m_data_decode_int(dataArray, &instanceP->value) != 1) return COAP_400_BAD_REQUEST;
+
+    return COAP_204_CHANGED;
+}
+
+static uint8_t prv_delete(uint16_t instanceId,
+                          lwm2m_object_t * objectP)
+{
+    test_instance_t * instanceP;
+
+    objectP->instanceList = lwm2m_list_remove(objectP->instanceList, instanceId, (lwm2m_list_t **)&instanceP);
+    if (instanceP == NULL) return COAP_404_NOT_FOUND;
+    lwm2m_free(instanceP);
+
+    return COAP_202_DELETED;
+}
+
+// when set, the create which brings it to 0 fails
+static int g_createCountdown = 0;
+
+static uint8_t prv_create(uint16_t instanceId,
+                          int numData,
+                          lwm2m_data_t * dataArray,
+                          lwm2m_object_t * objectP)
+{
+    test_instance_t * instanceP;
+    uint8_t result;
+
+    if (g_createCountdown > 0 && --g_createCountdown == 0) return COAP_500_INTERNAL_SERVER_ERROR;
+    instanceP = (test_instance_t *)lwm2m_malloc(sizeof(test_instance_t));
+    if (instanceP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+    memset(instanceP, 0, sizeof(test_instance_t));
+    instanceP->id = instanceId;
+    objectP->instanceList = LWM2M_LIST_ADD(objectP->instanceList, instanceP);
+
+    result = prv_write(instanceId, numData, dataArray, objectP);
+    if (result != COAP_204_CHANGED)
+    {
+        prv_delete(instanceId, objectP);
+        return result;
+    }
+
+    return COAP_201_CREATED;
+}
+
+typedef struct
+{
+    lwm2m_context_t context;
+    lwm2m_object_t  object;
+} journal_setup_t;
+
+// The object starts with the instance 0 of value 5
+static void prv_setup(journal_setup_t * setupP,
+                      journal_log_t * logP)
+{
+    lwm2m_data_t data;
+
+    memset(setupP, 0, sizeof(journal_setup_t));
+    setupP->context.state = STATE_READY;
+    setupP->context.userData = logP;
+    setupP->object.objID = TEST_OBJECT_ID;
+    setupP->object.readFunc = prv_read;
+    setupP->object.writeFunc = prv_write;
+    setupP->object.createFunc = prv_create;
+    setupP->object.deleteFunc = prv_delete;
+    setupP->context.objectList = &setupP->object;
+    lwm2m_index_build(&setupP->context.objectIndex, (lwm2m_list_t *)setupP->context.objectList);
+
+    memset(&data, 0, sizeof(lwm2m_data_t));
+    lwm2m_data_encode_int(5, &data);
+    prv_create(0, 1, &data, &setupP->object);
+}
+
+static void prv_cleanup(journal_setup_t * setupP)
+{
+    while (setupP->object.instanceList != NULL)
+    {
+        prv_delete(setupP->object.instanceList->id, &setupP->object);
+    }
+    journal_free(&setupP->context);
+    lwm2m_index_clear(&setupP->context.objectIndex);
+}
+
+static int64_t prv_value(journal_setup_t * setupP,
+                         uint16_t instanceId)
+{
+    test_instance_t * instanceP;
+
+    instanceP = (test_instance_t *)lwm2m_list_find(setupP->object.instanceList, instanceId);
+    if (instanceP == NULL) return -1;
+    return instanceP->value;
+}
+
+// Writes value to an instance the way a Bootstrap Write or a Create does
+static uint8_t prv_writeInstance(journal_setup_t * setupP,
+                                 uint16_t instanceId,
+                                 int64_t value,
+                                 bool create)
+{
+    lwm2m_data_t * instanceP;
+    lwm2m_data_t * resourceP;
+    lwm2m_uri_t uri;
+    uint8_t result;
+
+    memset(&uri, 0, sizeof(lwm2m_uri_t));
+    uri.objectId = TEST_OBJECT_ID;
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    instanceP = lwm2m_data_new(1);
+    resourceP = lwm2m_data_new(1);
+    resourceP->id = 0;
+    lwm2m_data_encode_int(value, resourceP);
+    instanceP->id = instanceId;
+    lwm2m_data_include(resourceP, 1, instanceP);
+    if (create)
+    {
+        result = object_createInstance(&setupP->context, &uri, instanceP);
+    }
+    else
+    {
+        result = object_writeInstance(&setupP->context, &uri, instanceP);
+    }
+    lwm2m_data_free(1, instanceP);
+
+    return result;
+}
+
+static void test_journal_restore(void)
+{
+    MEMORY_TRACE_BEFORE;
+    journal_log_t log;
+    journal_setup_t setup;
+    lwm2m_uri_t uri;
+    uint16_t objectId = TEST_OBJECT_ID;
+
+    memset(&log, 0, sizeof(journal_log_t));
+
+    // the first start saves the current instances
+    prv_setup(&setup, &log);
+    CU_ASSERT_EQUAL(lwm2m_restore_objects(&setup.context, 1, &objectId), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(log.replaceCount, 1);
+    CU_ASSERT_NOT_EQUAL(log.length, 0);
+
+    // each change appends a record
+    CU_ASSERT_EQUAL(prv_writeInstance(&setup, 0, 7, false), COAP_204_CHANGED);
+    CU_ASSERT_EQUAL(prv_writeInstance(&setup, 0, 9, true), COAP_201_CREATED);
+    CU_ASSERT_EQUAL(log.appendCount, 2);
+    memset(&uri, 0, sizeof(lwm2m_uri_t));
+    uri.objectId = TEST_OBJECT_ID;
+    uri.instanceId = 0;
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+    CU_ASSERT_EQUAL(object_delete(&setup.context, &uri), COAP_202_DELETED);
+    CU_ASSERT_EQUAL(log.appendCount, 3);
+    // a local change notified to the library too
+    ((test_instance_t *)lwm2m_list_find(setup.object.instanceList, 1))->value = 11;
+    uri.instanceId = 1;
+    lwm2m_resource_value_changed(&setup.context, &uri);
+    CU_ASSERT_EQUAL(log.appendCount, 4);
+    prv_cleanup(&setup);
+
+    // after a reboot, the instances are the ones of the log
+    prv_setup(&setup, &log);
+    CU_ASSERT_EQUAL(lwm2m_restore_objects(&setup.context, 1, &objectId), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_value(&setup, 0), -1);
+    CU_ASSERT_EQUAL(prv_value(&setup, 1), 11);
+    CU_ASSERT_EQUAL(log.replaceCount, 1);
+    prv_cleanup(&setup);
+
+    // a record partially written is dropped
+    log.length -= 3;
+    prv_setup(&setup, &log);
+    CU_ASSERT_EQUAL(lwm2m_restore_objects(&setup.context, 1, &objectId), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_value(&setup, 1), 9);
+    CU_ASSERT_EQUAL(log.replaceCount, 2);
+    prv_cleanup(&setup);
+
+    lwm2m_free(log.data);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_journal_compaction(void)
+{
+    MEMORY_TRACE_BEFORE;
+    journal_log_t log;
+    journal_setup_t setup;
+    uint16_t objectId = TEST_OBJECT_ID;
+    size_t length;
+    int i;
+
+    memset(&log, 0, sizeof(journal_log_t));
+    prv_setup(&setup, &log);
+    CU_ASSERT_EQUAL(lwm2m_restore_objects(&setup.context, 1, &objectId), COAP_NO_ERROR);
+    length = log.length;
+
+    // the log is rewritten with the single current instance once it grew enough
+    for (i = 0 ; i < 10 * LWM2M_JOURNAL_COMPACTION_MIN ; i++)
+    {
+        CU_ASSERT_EQUAL(prv_writeInstance(&setup, 0, 100 + i, false), COAP_204_CHANGED);
+    }
+    CU_ASSERT(log.replaceCount > 1);
+    CU_ASSERT(log.length <= (LWM2M_JOURNAL_COMPACTION_MIN + 3) * length);
+    prv_cleanup(&setup);
+
+    prv_setup(&setup, &log);
+    CU_ASSERT_EQUAL(lwm2m_restore_objects(&setup.context, 1, &objectId), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_value(&setup, 0), 100 + i - 1);
+    prv_cleanup(&setup);
+
+    lwm2m_free(log.data);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_journal_bootstrap(void)
+{
+    MEMORY_TRACE_BEFORE;
+    journal_log_t log;
+    journal_setup_t setup;
+    uint16_t objectId = TEST_OBJECT_ID;
+
+    memset(&log, 0, sizeof(journal_log_t));
+    prv_setup(&setup, &log);
+    CU_ASSERT_EQUAL(lwm2m_restore_objects(&setup.context, 1, &objectId), COAP_NO_ERROR);
+
+    // the changes of a failed bootstrap are undone from the log
+    setup.context.state = STATE_BOOTSTRAPPING;
+    CU_ASSERT_EQUAL(prv_writeInstance(&setup, 0, 8, false), COAP_204_CHANGED);
+    CU_ASSERT_EQUAL(prv_writeInstance(&setup, 0, 3, true), COAP_201_CREATED);
+    CU_ASSERT_EQUAL(log.appendCount, 0);
+    journal_rollback(&setup.context);
+    CU_ASSERT_EQUAL(prv_value(&setup, 0), 5);
+    CU_ASSERT_EQUAL(prv_value(&setup, 1), -1);
+
+    // the ones of a finished bootstrap are written at once
+    CU_ASSERT_EQUAL(prv_writeInstance(&setup, 0, 8, false), COAP_204_CHANGED);
+    journal_commit(&setup.context);
+    CU_ASSERT_EQUAL(log.appendCount, 0);
+    CU_ASSERT_EQUAL(log.replaceCount, 2);
+    setup.context.state = STATE_READY;
+    prv_cleanup(&setup);
+
+    prv_setup(&setup, &log);
+    CU_ASSERT_EQUAL(lwm2m_restore_objects(&setup.context, 1, &objectId), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_value(&setup, 0), 8);
+    prv_cleanup(&setup);
+
+    lwm2m_free(log.data);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_journal_invalid(void)
+{
+    MEMORY_TRACE_BEFORE;
+    journal_log_t log;
+    journal_setup_t setup;
+    uint16_t objectId = TEST_OBJECT_ID;
+    uint8_t record[] = {1, 0, 0, 0, 7, TEST_OBJECT_ID >> 8, TEST_OBJECT_ID & 0xFF, 0, 2, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0};
+    uint8_t * data;
+    uint32_t hash;
+
+    memset(&log, 0, sizeof(journal_log_t));
+    prv_setup(&setup, &log);
+    CU_ASSERT_EQUAL(lwm2m_restore_objects(&setup.context, 1, &objectId), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_writeInstance(&setup, 1, 9, true), COAP_201_CREATED);
+
+    // the instances are left unchanged when an object fails to recreate one
+    setup.context.state = STATE_BOOTSTRAPPING;
+    CU_ASSERT_EQUAL(prv_writeInstance(&setup, 0, 8, false), COAP_204_CHANGED);
+    g_createCountdown = 2;
+    journal_rollback(&setup.context);
+    g_createCountdown = 0;
+    CU_ASSERT_EQUAL(prv_value(&setup, 0), 8);
+    CU_ASSERT_EQUAL(prv_value(&setup, 1), 9);
+    setup.context.state = STATE_READY;
+    prv_cleanup(&setup);
+
+    // a record which cannot be parsed ends the log like a corrupted one
+    hash = utils_hash(record, sizeof(record) - 4);
+    record[sizeof(record) - 4] = (uint8_t)(hash >> 24);
+    record[sizeof(record) - 3] = (uint8_t)(hash >> 16);
+    record[sizeof(record) - 2] = (uint8_t)(hash >> 8);
+    record[sizeof(record) - 1] = (uint8_t)hash;
+    data = (uint8_t *)lwm2m_malloc(log.length + sizeof(record));
+    memcpy(data, log.data, log.length);
+    memcpy(data + log.length, record, sizeof(record));
+    lwm2m_free(log.data);
+    log.data = data;
+    log.length += sizeof(record);
+    prv_setup(&setup, &log);
+    CU_ASSERT_EQUAL(lwm2m_restore_objects(&setup.context, 1, &objectId), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_value(&setup, 0), 5);
+    CU_ASSERT_EQUAL(prv_value(&setup, 1), 9);
+    CU_ASSERT_EQUAL(prv_value(&setup, 2), -1);
+    CU_ASSERT_EQUAL(log.replaceCount, 2);
+    prv_cleanup(&setup);
+
+    lwm2m_free(log.data);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_journal_file(void)
+{
+    MEMORY_TRACE_BEFORE;
+    char path[] = "/tmp/lwm2mjournalXXXXXX";
+    file_journal_t file;
+    journal_log_t log;
+    journal_setup_t setup;
+    uint16_t objectId = TEST_OBJECT_ID;
+    int fd;
+    int i;
+
+    fd = mkstemp(path);
+    CU_ASSERT_FATAL(fd >= 0);
+    close(fd);
+    memset(&log, 0, sizeof(journal_log_t));
+    file_journal_init(&file, path);
+    log.fileP = &file;
+    prv_setup(&setup, &log);
+    CU_ASSERT_EQUAL(lwm2m_restore_objects(&setup.context, 1, &objectId), COAP_NO_ERROR);
+    for (i = 0 ; i < 10 * LWM2M_JOURNAL_COMPACTION_MIN ; i++)
+    {
+        CU_ASSERT_EQUAL(prv_writeInstance(&setup, 0, 100 + i, false), COAP_204_CHANGED);
+    }
+    CU_ASSERT(log.replaceCount > 1);
+
+    // the file replaced by the compaction is read back by the rollback
+    setup.context.state = STATE_BOOTSTRAPPING;
+    CU_ASSERT_EQUAL(prv_writeInstance(&setup, 0, 8, false), COAP_204_CHANGED);
+    CU_ASSERT_EQUAL(prv_writeInstance(&setup, 0, 3, true), COAP_201_CREATED);
+    journal_rollback(&setup.context);
+    CU_ASSERT_EQUAL(prv_value(&setup, 0), 100 + i - 1);
+    CU_ASSERT_EQUAL(prv_value(&setup, 1), -1);
+    setup.context.state = STATE_READY;
+
+    // and still appended to
+    CU_ASSERT_EQUAL(prv_writeInstance(&setup, 0, 7, false), COAP_204_CHANGED);
+    prv_cleanup(&setup);
+    file_journal_free(&file);
+
+    file_journal_init(&file, path);
+    prv_setup(&setup, &log);
+    CU_ASSERT_EQUAL(lwm2m_restore_objects(&setup.context, 1, &objectId), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_value(&setup, 0), 7);
+    prv_cleanup(&setup);
+    file_journal_free(&file);
+
+    unlink(path);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static struct TestTable table[] = {
+        { "test of the journal restore", test_journal_restore },
+        { "test of the journal compaction", test_journal_compaction },
+        { "test of the journal during a bootstrap", test_journal_bootstrap },
+        { "test of an invalid journal", test_journal_invalid },
+        { "test of the journal in a file", test_journal_file },
+        { NULL, NULL },
+};
+
+CU_ErrorCode create_journal_suit() {
+    CU_pSuite pSuite = NULL;
+    pSuite = CU_add_suite("Suite_journal", NULL, NULL);
+
+    if (NULL == pSuite) {
+        return CU_get_error();
+    }
+    return add_tests(pSuite, table);
+}
@@ -0,0 +1,212 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "tests.h"
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "liblwm2m.h"
+#include "memtest.h"
+
+#define INSTANCE_COUNT 100
+
+static void prv_setUri(lwm2m_uri_t * uriP,
+                       int objectId,
+                       int instanceId,
+                       int resourceId)
+{
+    memset(uriP, 0, sizeof(lwm2m_uri_t));
+    uriP->objectId = (uint16_t)objectId;
+    uriP->flag = LWM2M_URI_FLAG_OBJECT_ID;
+    if (instanceId >= 0)
+    {
+        uriP->instanceId = (uint16_t)instanceId;
+        uriP->flag |= LWM2M_URI_FLAG_INSTANCE_ID;
+    }
+    if (resourceId >= 0)
+    {
+        uriP->resourceId = (uint16_t)resourceId;
+        uriP->flag |= LWM2M_URI_FLAG_RESOURCE_ID;
+    }
+}
+
+// Instances with a single resource and a multiple resource of two instances
+static lwm2m_data_t * prv_createObject(int count)
+{
+    lwm2m_data_t * dataP;
+    int i;
+
+    dataP = lwm2m_data_new(count);
+    for (i = 0 ; i < count ; i++)
+    {
+        lwm2m_data_t * resP;
+        lwm2m_data_t * subP;
+
+        resP = lwm2m_data_new(2);
+        resP[0].id = 1;
+        lwm2m_data_encode_int(i, resP);
+        subP = lwm2m_data_new(2);
+        subP[0].id = 0;
+        lwm2m_data_encode_int(0, subP);
+        subP[1].id = 1;
+        lwm2m_data_encode_int(1, subP + 1);
+        resP[1].id = 7;
+        lwm2m_data_encode_instances(subP, 2, resP + 1);
+
+        dataP[i].type = LWM2M_TYPE_OBJECT_INSTANCE;
+        dataP[i].id = (uint16_t)i;
+        dataP[i].value.asChildren.count = 2;
+        dataP[i].value.asChildren.array = resP;
+    }
+
+    return dataP;
+}
+
+static void test_link_discover_attributes(void)
+{
+    MEMORY_TRACE_BEFORE;
+    lwm2m_server_t server;
+    lwm2m_attributes_t attr;
+    lwm2m_data_t * dataP;
+    lwm2m_uri_t uri;
+    uint8_t * buffer;
+    int length;
+    const char * expected = "</3>;pmin=10,</3/0>;pmax=60,</3/0/1>;st=0.5,</3/0/7>;dim=2,"
+                            "</3/1/1>,</3/1/7>;dim=2";
+
+    memset(&server, 0, sizeof(server));
+    memset(&attr, 0, sizeof(attr));
+    attr.toSet = LWM2M_ATTR_FLAG_MIN_PERIOD;
+    attr.minPeriod = 10;
+    prv_setUri(&uri, 3, -1, -1);
+    attributes_set(&server, &uri, &attr);
+    memset(&attr, 0, sizeof(attr));
+    attr.toSet = LWM2M_ATTR_FLAG_MAX_PERIOD;
+    attr.maxPeriod = 60;
+    prv_setUri(&uri, 3, 0, -1);
+    attributes_set(&server, &uri, &attr);
+    memset(&attr, 0, sizeof(attr));
+    attr.toSet = LWM2M_ATTR_FLAG_STEP;
+    attr.step = 0.5;
+    prv_setUri(&uri, 3, 0, 1);
+    attributes_set(&server, &uri, &attr);
+
+    dataP = prv_createObject(2);
+    prv_setUri(&uri, 3, -1, -1);
+    length = discover_serialize(&uri, &server, 2, dataP, &buffer);
+    CU_ASSERT_EQUAL_FATAL(length, (int)strlen(expected));
+    CU_ASSERT_NSTRING_EQUAL(buffer, expected, length);
+    lwm2m_free(buffer);
+
+    // a resource is listed with the periods inherited from its object and object instance
+    prv_setUri(&uri, 3, 0, 1);
+    length = discover_serialize(&uri, &server, 1, dataP[0].value.asChildren.array, &buffer);
+    CU_ASSERT_EQUAL_FATAL(length, strlen("</3/0/1>;pmin=10;pmax=60;st=0.5"));
+    CU_ASSERT_NSTRING_EQUAL(buffer, "</3/0/1>;pmin=10;pmax=60;st=0.5", length);
+    lwm2m_free(buffer);
+
+    lwm2m_data_free(2, dataP);
+    attributes_free(&server);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_link_discover_large(void)
+{
+    MEMORY_TRACE_BEFORE;
+    lwm2m_media_type_t format;
+    lwm2m_data_t * dataP;
+    lwm2m_uri_t uri;
+    uint8_t * buffer;
+    uint8_t small[64];
+    int length;
+
+    // far above the size of a CoAP block
+    dataP = prv_createObject(INSTANCE_COUNT);
+    prv_setUri(&uri, 1024, -1, -1);
+    format = LWM2M_CONTENT_LINK;
+    length = lwm2m_data_serialize(&uri, INSTANCE_COUNT, dataP, &format, &buffer);
+    CU_ASSERT_FATAL(length > 4096);
+    CU_ASSERT_NSTRING_EQUAL(buffer, "</1024>,</1024/0>,</1024/0/1>,</1024/0/7>;dim=2,</1024/1>,", 58);
+    CU_ASSERT_NSTRING_EQUAL(buffer + length - 31, "</1024/99/1>,</1024/99/7>;dim=2", 31);
+    CU_ASSERT_EQUAL(buffer[length], 0);
+    lwm2m_free(buffer);
+
+    // in place, the caller's buffer does not grow
+    length = lwm2m_data_serialize_into(&uri, 1, dataP, &format, small, sizeof(small));
+    CU_ASSERT_EQUAL(length, strlen("</1024>,</1024/0>,</1024/0/1>,</1024/0/7>;dim=2"));
+    CU_ASSERT_EQUAL(lwm2m_data_serialize_into(&uri, 2, dataP, &format, small, sizeof(small)), -1);
+
+    lwm2m_data_free(INSTANCE_COUNT, dataP);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_link_register_payload(void)
+{
+    MEMORY_TRACE_BEFORE;
+    lwm2m_context_t context;
+    lwm2m_object_t objects[3];
+    lwm2m_list_t instances[INSTANCE_COUNT];
+    char altPath[] = "/lwm2m";
+    uint8_t * buffer;
+    int length;
+    int i;
+
+    memset(&context, 0, sizeof(context));
+    memset(objects, 0, sizeof(objects));
+    for (i = 0 ; i < INSTANCE_COUNT ; i++)
+    {
+        instances[i].id = (uint16_t)(i * 2);
+        instances[i].next = (i + 1 < INSTANCE_COUNT) ? instances + i + 1 : NULL;
+    }
+    objects[0].objID = LWM2M_SECURITY_OBJECT_ID;
+    objects[0].instanceList = instances;
+    objects[0].next = objects + 1;
+    objects[1].objID = 3;
+    objects[1].next = objects + 2;
+    objects[2].objID = 1024;
+    objects[2].instanceList = instances;
+    context.objectList = objects;
+    context.altPath = altPath;
+
+    length = object_getRegisterPayload(&context, &buffer);
+    CU_ASSERT_FATAL(length > 1024);
+    CU_ASSERT_EQUAL(length, (int)strlen((char *)buffer));
+    CU_ASSERT_NSTRING_EQUAL(buffer, "</lwm2m>;rt=\"oma.lwm2m\"", 23);
+    // the security object is not listed
+    CU_ASSERT_PTR_NULL(strstr((char *)buffer, "</0/"));
+    CU_ASSERT_PTR_NOT_NULL(strstr((char *)buffer, ",</3>,</1024/0>,</1024/2>,"));
+    CU_ASSERT_NSTRING_EQUAL(buffer + length - 11, "</1024/198>", 11);
+    lwm2m_free(buffer);
+
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static struct TestTable table[] = {
+        { "test of a Discover with attributes", test_link_discover_attributes },
+        { "test of a Discover of a large object", test_link_discover_large },
+        { "test of the registration payload", test_link_register_payload },
+        { NULL, NULL },
+};
+
+CU_ErrorCode create_link_suit() {
+    CU_pSuite pSuite = NULL;
+    pSuite = CU_add_suite("Suite_link", NULL, NULL);
+
+    if (NULL == pSuite) {
+        return CU_get_error();
+    }
+    return add_tests(pSuite, table);
+}
@@ -0,0 +1,196 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "tests.h"
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "liblwm2m.h"
+#include "memtest.h"
+
+#define NODE_COUNT 100
+
+// Check the list is sorted and holds the same nodes as the index
+static void prv_checkConsistency(lwm2m_list_index_t * indexP,
+                                 lwm2m_list_t * head)
+{
+    size_t count;
+
+    count = 0;
+    while (head != NULL)
+    {
+        CU_ASSERT_PTR_EQUAL(lwm2m_index_find(indexP, head->id), head);
+        if (head->next != NULL) CU_ASSERT(head->id < head->next->id);
+        head = head->next;
+        count++;
+    }
+    CU_ASSERT_EQUAL(count, indexP->count);
+}
+
+static void test_index_add_find(void)
+{
+    MEMORY_TRACE_BEFORE;
+    lwm2m_list_index_t index;
+    lwm2m_list_t nodes[NODE_COUNT];
+    lwm2m_list_t duplicate;
+    lwm2m_list_t * head = NULL;
+    int i;
+
+    memset(&index, 0, sizeof(index));
+    // insert in a scrambled order
+    for (i = 0 ; i < NODE_COUNT ; i++)
+    {
+        nodes[i].id = (uint16_t)((i * 37) % NODE_COUNT) * 2;
+        CU_ASSERT_EQUAL(lwm2m_index_add(&index, &head, nodes + i), 0);
+    }
+    CU_ASSERT_EQUAL(index.count, NODE_COUNT);
+    prv_checkConsistency(&index, head);
+
+    duplicate.id = 20;
+    CU_ASSERT_EQUAL(lwm2m_index_add(&index, &head, &duplicate), -1);
+    CU_ASSERT_EQUAL(index.count, NODE_COUNT);
+
+    for (i = 0 ; i < NODE_COUNT ; i++)
+    {
+        CU_ASSERT_PTR_EQUAL(lwm2m_index_find(&index, nodes[i].id), nodes + i);
+        CU_ASSERT_PTR_EQUAL(lwm2m_list_find(head, nodes[i].id), nodes + i);
+        CU_ASSERT_PTR_NULL(lwm2m_index_find(&index, nodes[i].id + 1));
+    }
+
+    lwm2m_index_clear(&index);
+    CU_ASSERT_EQUAL(index.count, 0);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_index_remove(void)
+{
+    MEMORY_TRACE_BEFORE;
+    lwm2m_list_index_t index;
+    lwm2m_list_t nodes[NODE_COUNT];
+    lwm2m_list_t * head = NULL;
+    int i;
+
+    memset(&index, 0, sizeof(index));
+    for (i = 0 ; i < NODE_COUNT ; i++)
+    {
+        nodes[i].id = (uint16_t)i;
+        nodes[i].next = (i + 1 < NODE_COUNT) ? nodes + i + 1 : NULL;
+    }
+    head = nodes;
+    CU_ASSERT_EQUAL_FATAL(lwm2m_index_build(&index, head), 0);
+    CU_ASSERT_EQUAL(index.count, NODE_COUNT);
+
+    CU_ASSERT_PTR_EQUAL(lwm2m_index_remove(&index, &head, 0), nodes);
+    CU_ASSERT_PTR_EQUAL(head, nodes + 1);
+    CU_ASSERT_PTR_EQUAL(lwm2m_index_remove(&index, &head, NODE_COUNT - 1), nodes + NODE_COUNT - 1);
+    CU_ASSERT_PTR_EQUAL(lwm2m_index_remove(&index, &head, 50), nodes + 50);
+    CU_ASSERT_PTR_NULL(lwm2m_index_remove(&index, &head, 50));
+    CU_ASSERT_PTR_NULL(lwm2m_index_remove(&index, &head, NODE_COUNT));
+    CU_ASSERT_EQUAL(index.count, NODE_COUNT - 3);
+    prv_checkConsistency(&index, head);
+
+    for (i = 1 ; i < NODE_COUNT ; i++)
+    {
+        lwm2m_index_remove(&index, &head, (uint16_t)i);
+    }
+    CU_ASSERT_EQUAL(index.count, 0);
+    CU_ASSERT_PTR_NULL(head);
+
+    lwm2m_index_clear(&index);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_index_newId(void)
+{
+    MEMORY_TRACE_BEFORE;
+    lwm2m_list_index_t index;
+    lwm2m_list_t nodes[NODE_COUNT];
+    lwm2m_list_t * head = NULL;
+    int i;
+
+    memset(&index, 0, sizeof(index));
+    CU_ASSERT_EQUAL(lwm2m_index_newId(&index), 0);
+
+    for (i = 0 ; i < NODE_COUNT ; i++)
+    {
+        nodes[i].id = (uint16_t)i;
+        lwm2m_index_add(&index, &head, nodes + i);
+    }
+    CU_ASSERT_EQUAL(lwm2m_index_newId(&index), NODE_COUNT);
+
+    lwm2m_index_remove(&index, &head, 63);
+    CU_ASSERT_EQUAL(lwm2m_index_newId(&index), 63);
+    CU_ASSERT_EQUAL(lwm2m_index_newId(&index), lwm2m_list_newId(head));
+    lwm2m_index_remove(&index, &head, 7);
+    CU_ASSERT_EQUAL(lwm2m_index_newId(&index), 7);
+    lwm2m_index_remove(&index, &head, 0);
+    CU_ASSERT_EQUAL(lwm2m_index_newId(&index), 0);
+    CU_ASSERT_EQUAL(lwm2m_index_newId(&index), lwm2m_list_newId(head));
+
+    lwm2m_index_clear(&index);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_index_sparse(void)
+{
+    MEMORY_TRACE_BEFORE;
+    lwm2m_list_index_t index;
+    lwm2m_list_t nodes[NODE_COUNT];
+    lwm2m_list_t * head = NULL;
+    int i;
+
+    memset(&index, 0, sizeof(index));
+    // IDs spread over the whole range, inserted from both ends
+    for (i = 0 ; i < NODE_COUNT ; i++)
+    {
+        int position = (i % 2 == 0) ? i / 2 : NODE_COUNT - 1 - i / 2;
+
+        nodes[position].id = (uint16_t)(1 + position * 655);
+        CU_ASSERT_EQUAL(lwm2m_index_add(&index, &head, nodes + position), 0);
+    }
+    prv_checkConsistency(&index, head);
+    CU_ASSERT_PTR_EQUAL(head, nodes);
+    CU_ASSERT_EQUAL(lwm2m_index_newId(&index), 0);
+    CU_ASSERT_PTR_NULL(lwm2m_index_find(&index, 0));
+    CU_ASSERT_PTR_NULL(lwm2m_index_find(&index, 0xFFFF));
+
+    for (i = 0 ; i < NODE_COUNT ; i += 3)
+    {
+        CU_ASSERT_PTR_EQUAL(lwm2m_index_remove(&index, &head, nodes[i].id), nodes + i);
+    }
+    prv_checkConsistency(&index, head);
+
+    lwm2m_index_clear(&index);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static struct TestTable table[] = {
+        { "test of lwm2m_index_add() and lwm2m_index_find()", test_index_add_find },
+        { "test of lwm2m_index_remove()", test_index_remove },
+        { "test of lwm2m_index_newId()", test_index_newId },
+        { "test of an index of sparse IDs", test_index_sparse },
+        { NULL, NULL },
+};
+
+CU_ErrorCode create_list_suit() {
+    CU_pSuite pSuite = NULL;
+    pSuite = CU_add_suite("Suite_list", NULL, NULL);
+
+    if (NULL == pSuite) {
+        return CU_get_error();
+    }
+    return add_tests(pSuite, table);
+}
@@ -0,0 +1,277 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "tests.h"
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "liblwm2m.h"
+#include "memtest.h"
+#include "connection.h"
+
+#define TEST_OBJECT_ID  1024
+
+static int64_t g_value;
+static int g_readFailures;  // number of the next reads to fail
+
+// Object 1024 with a single instance holding g_value in its resource 0
+static uint8_t prv_read(uint16_t instanceId,
+                        int * numDataP,
+                        lwm2m_data_t ** dataArrayP,
+                        lwm2m_object_t * objectP)
+{
+    int i;
+
+    (void)objectP;
+
+    if (instanceId != 0) return COAP_404_NOT_FOUND;
+    if (g_readFailures > 0)
+    {
+        g_readFailures--;
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    if (*numDataP == 0)
+    {
+        *dataArrayP = lwm2m_data_new(1);
+        if (*dataArrayP == NULL) return COAP_500_INTERNAL_SERVER_ERROR;
+        *numDataP = 1;
+        (*dataArrayP)->id = 0;
+    }
+    for (i = 0 ; i < *numDataP ; i++)
+    {
+        if ((*dataArrayP)[i].id != 0) return COAP_404_NOT_FOUND;
+        lwm2m_data_encode_int(g_value, *dataArrayP + i);
+    }
+
+    return COAP_205_CONTENT;
+}
+
+// A server bound in queue mode observing /1024/0/0, its notifications sent to the receiver socket
+typedef struct
+{
+    lwm2m_context_t  context;
+    lwm2m_server_t   server;
+    lwm2m_object_t   object;
+    lwm2m_list_t     instance;
+    lwm2m_observed_t observed;
+    lwm2m_watcher_t  watcher;
+    connection_t     connection;
+    int              receiver;
+} observe_setup_t;
+
+static void prv_setup(observe_setup_t * setupP)
+{
+    struct sockaddr_in addr;
+    socklen_t addrLen;
+
+    memset(setupP, 0, sizeof(observe_setup_t));
+    g_value = 0;
+    g_readFailures = 0;
+
+    setupP->receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addrLen = sizeof(addr);
+    CU_ASSERT_EQUAL(bind(setupP->receiver, (struct sockaddr *)&addr, addrLen), 0);
+    CU_ASSERT_EQUAL(getsockname(setupP->receiver, (struct sockaddr *)&addr, &addrLen), 0);
+    setupP->connection.sock = socket(AF_INET, SOCK_DGRAM, 0);
+    memcpy(&setupP->connection.addr, &addr, addrLen);
+    setupP->connection.addrLen = addrLen;
+
+    setupP->server.shortID = 1;
+    setupP->server.binding = BINDING_UQ;
+    setupP->server.sessionH = &setupP->connection;
+    setupP->context.serverList = &setupP->server;
+    setupP->context.state = STATE_READY;
+
+    setupP->object.objID = TEST_OBJECT_ID;
+    setupP->object.instanceList = &setupP->instance;
+    setupP->object.readFunc = prv_read;
+    setupP->context.objectList = &setupP->object;
+    lwm2m_index_build(&setupP->context.objectIndex, (lwm2m_list_t *)setupP->context.objectList);
+
+    setupP->observed.uri.objectId = TEST_OBJECT_ID;
+    setupP->observed.uri.instanceId = 0;
+    setupP->observed.uri.resourceId = 0;
+    setupP->observed.uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID | LWM2M_URI_FLAG_RESOURCE_ID;
+    setupP->observed.watcherList = &setupP->watcher;
+    setupP->context.observedList = &setupP->observed;
+
+    setupP->watcher.active = true;
+    setupP->watcher.server = &setupP->server;
+    setupP->watcher.format = LWM2M_CONTENT_TEXT;
+    setupP->watcher.token[0] = 0x42;
+    setupP->watcher.tokenLen = 1;
+}
+
+static void prv_cleanup(observe_setup_t * setupP)
+{
+    lwm2m_index_clear(&setupP->context.objectIndex);
+    close(setupP->connection.sock);
+    close(setupP->receiver);
+}
+
+// Changes the value and runs observe_step() while the server is sleeping
+static void prv_changeWhileSleeping(observe_setup_t * setupP,
+                                    int64_t value,
+                                    time_t now)
+{
+    time_t timeout = 60;
+
+    g_value = value;
+    lwm2m_resource_value_changed(&setupP->context, &setupP->observed.uri);
+    observe_step(&setupP->context, now, &timeout);
+}
+
+// Returns the number of notifications received since the last call.
+// Each of them must carry the text value expected.
+static int prv_receive(observe_setup_t * setupP,
+                       const char * expected)
+{
+    uint8_t buffer[256];
+    ssize_t length;
+    int count;
+
+    count = 0;
+    while ((length = recv(setupP->receiver, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0)
+    {
+        coap_packet_t message[1];
+
+        CU_ASSERT_EQUAL(coap_parse_message(message, buffer, (uint16_t)length), NO_ERROR);
+        CU_ASSERT_EQUAL(message->type, COAP_TYPE_NON);
+        CU_ASSERT_EQUAL(message->code, COAP_205_CONTENT);
+        CU_ASSERT_EQUAL(message->token_len, 1);
+        CU_ASSERT_EQUAL(message->token[0], 0x42);
+        CU_ASSERT_EQUAL(message->payload_len, strlen(expected));
+        CU_ASSERT(0 == memcmp(message->payload, expected, strlen(expected)));
+        coap_free_header(message);
+        count++;
+    }
+
+    return count;
+}
+
+static void test_observe_pending(void)
+{
+    MEMORY_TRACE_BEFORE;
+    observe_setup_t setup;
+    time_t timeout = 60;
+
+    prv_setup(&setup);
+    CU_ASSERT_EQUAL(lwm2m_set_sleeping(&setup.context, 1, true), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(lwm2m_set_sleeping(&setup.context, 2, true), COAP_404_NOT_FOUND);
+
+    // the changes are held back while the server is sleeping
+    prv_changeWhileSleeping(&setup, 12, 100);
+    CU_ASSERT_EQUAL(prv_receive(&setup, ""), 0);
+    CU_ASSERT(setup.watcher.pending);
+    prv_changeWhileSleeping(&setup, 13, 101);
+    CU_ASSERT_EQUAL(prv_receive(&setup, ""), 0);
+    CU_ASSERT(setup.watcher.pending);
+
+    // a single notification with the current value is sent on wake up
+    CU_ASSERT_EQUAL(lwm2m_set_sleeping(&setup.context, 1, false), COAP_NO_ERROR);
+    observe_step(&setup.context, 102, &timeout);
+    CU_ASSERT_EQUAL(prv_receive(&setup, "13"), 1);
+    CU_ASSERT_FALSE(setup.watcher.pending);
+    CU_ASSERT_EQUAL(setup.watcher.counter, 1);
+
+    observe_step(&setup.context, 103, &timeout);
+    CU_ASSERT_EQUAL(prv_receive(&setup, ""), 0);
+
+    // a server bound in UDP mode is never considered sleeping
+    setup.server.binding = BINDING_U;
+    CU_ASSERT_EQUAL(lwm2m_set_sleeping(&setup.context, 0, true), COAP_NO_ERROR);
+    prv_changeWhileSleeping(&setup, 14, 104);
+    CU_ASSERT_EQUAL(prv_receive(&setup, "14"), 1);
+    CU_ASSERT_FALSE(setup.watcher.pending);
+
+    prv_cleanup(&setup);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_observe_pending_read_failure(void)
+{
+    MEMORY_TRACE_BEFORE;
+    observe_setup_t setup;
+    time_t timeout = 60;
+
+    prv_setup(&setup);
+    lwm2m_set_sleeping(&setup.context, 1, true);
+    prv_changeWhileSleeping(&setup, 7, 100);
+    CU_ASSERT(setup.watcher.pending);
+
+    // the notification stays pending when the value cannot be read on wake up
+    lwm2m_set_sleeping(&setup.context, 1, false);
+    g_readFailures = 1;
+    observe_step(&setup.context, 101, &timeout);
+    CU_ASSERT_EQUAL(prv_receive(&setup, ""), 0);
+    CU_ASSERT(setup.watcher.pending);
+
+    observe_step(&setup.context, 102, &timeout);
+    CU_ASSERT_EQUAL(prv_receive(&setup, "7"), 1);
+    CU_ASSERT_FALSE(setup.watcher.pending);
+
+    prv_cleanup(&setup);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_observe_pending_send_failure(void)
+{
+    MEMORY_TRACE_BEFORE;
+    observe_setup_t setup;
+    time_t timeout = 60;
+    int sock;
+
+    prv_setup(&setup);
+    lwm2m_set_sleeping(&setup.context, 1, true);
+    prv_changeWhileSleeping(&setup, 8, 100);
+    CU_ASSERT(setup.watcher.pending);
+
+    // the notification stays pending when it cannot be sent on wake up
+    lwm2m_set_sleeping(&setup.context, 1, false);
+    sock = setup.connection.sock;
+    setup.connection.sock = -1;
+    observe_step(&setup.context, 101, &timeout);
+    CU_ASSERT(setup.watcher.pending);
+
+    setup.connection.sock = sock;
+    observe_step(&setup.context, 102, &timeout);
+    CU_ASSERT_EQUAL(prv_receive(&setup, "8"), 1);
+    CU_ASSERT_FALSE(setup.watcher.pending);
+
+    prv_cleanup(&setup);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static struct TestTable table[] = {
+        { "test of the pending notifications", test_observe_pending },
+        { "test of a pending notification failing to read", test_observe_pending_read_failure },
+        { "test of a pending notification failing to send", test_observe_pending_send_failure },
+        { NULL, NULL },
+};
+
+CU_ErrorCode create_observe_suit() {
+    CU_pSuite pSuite = NULL;
+    pSuite = CU_add_suite("Suite_observe", NULL, NULL);
+
+    if (NULL == pSuite) {
+        return CU_get_error();
+    }
+    return add_tests(pSuite, table);
+}
@@ -0,0 +1,285 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "tests.h"
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "liblwm2m.h"
+#include "memtest.h"
+#include "connection.h"
+
+#define TEST_OBJECT_ID      1024
+#define TEST_INSTANCE_MAX   3
+
+static lwm2m_list_t instances[TEST_INSTANCE_MAX];
+
+// Object 1024 creating and deleting its instances, all of them in instances[]
+static uint8_t prv_create(uint16_t instanceId,
+                          int numData,
+                          lwm2m_data_t * dataArray,
+                          lwm2m_object_t * objectP)
+{
+    (void)numData;
+    (void)dataArray;
+
+    if (instanceId >= TEST_INSTANCE_MAX) return COAP_500_INTERNAL_SERVER_ERROR;
+    instances[instanceId].id = instanceId;
+    instances[instanceId].next = NULL;
+    objectP->instanceList = LWM2M_LIST_ADD(objectP->instanceList, instances + instanceId);
+
+    return COAP_201_CREATED;
+}
+
+static uint8_t prv_delete(uint16_t instanceId,
+                          lwm2m_object_t * objectP)
+{
+    lwm2m_list_t * instanceP;
+
+    objectP->instanceList = LWM2M_LIST_RM(objectP->instanceList, instanceId, &instanceP);
+    if (instanceP == NULL) return COAP_404_NOT_FOUND;
+
+    return COAP_202_DELETED;
+}
+
+// A client registered to the server 1 with the instance 0 of the object 1024.
+// The requests to the server are sent to the receiver socket.
+typedef struct
+{
+    lwm2m_context_t context;
+    lwm2m_server_t  server;
+    lwm2m_object_t  object;
+    char            location[8];
+    connection_t    connection;
+    int             receiver;
+} registration_setup_t;
+
+static void prv_setup(registration_setup_t * setupP)
+{
+    struct sockaddr_in addr;
+    socklen_t addrLen;
+
+    memset(setupP, 0, sizeof(registration_setup_t));
+
+    setupP->receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addrLen = sizeof(addr);
+    CU_ASSERT_EQUAL(bind(setupP->receiver, (struct sockaddr *)&addr, addrLen), 0);
+    CU_ASSERT_EQUAL(getsockname(setupP->receiver, (struct sockaddr *)&addr, &addrLen), 0);
+    setupP->connection.sock = socket(AF_INET, SOCK_DGRAM, 0);
+    memcpy(&setupP->connection.addr, &addr, addrLen);
+    setupP->connection.addrLen = addrLen;
+
+    strcpy(setupP->location, "/rd/1");
+    setupP->server.shortID = 1;
+    setupP->server.binding = BINDING_U;
+    setupP->server.lifetime = 300;
+    setupP->server.status = STATE_REGISTERED;
+    setupP->server.location = setupP->location;
+    setupP->server.sessionH = &setupP->connection;
+    setupP->context.serverList = &setupP->server;
+    setupP->context.state = STATE_READY;
+
+    setupP->object.objID = TEST_OBJECT_ID;
+    setupP->object.createFunc = prv_create;
+    setupP->object.deleteFunc = prv_delete;
+    setupP->context.objectList = &setupP->object;
+    lwm2m_index_build(&setupP->context.objectIndex, (lwm2m_list_t *)setupP->context.objectList);
+    prv_create(0, 0, NULL, &setupP->object);
+}
+
+static void prv_cleanup(registration_setup_t * setupP)
+{
+    while (setupP->context.transactionList != NULL)
+    {
+        transaction_remove(&setupP->context, setupP->context.transactionList);
+    }
+    object_freeRegisterPayload(&setupP->context);
+    lwm2m_index_clear(&setupP->context.objectIndex);
+    close(setupP->connection.sock);
+    close(setupP->receiver);
+}
+
+static uint8_t prv_createInstance(registration_setup_t * setupP,
+                                  uint16_t instanceId)
+{
+    // TLV of an instance with the integer resource 0
+    uint8_t payload[] = { 0x03, 0x00, 0xC1, 0x00, 0x05 };
+    lwm2m_uri_t uri;
+
+    memset(&uri, 0, sizeof(lwm2m_uri_t));
+    uri.objectId = TEST_OBJECT_ID;
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID;
+    payload[1] = (uint8_t)instanceId;
+
+    return object_create(&setupP->context, &uri, LWM2M_CONTENT_TLV, payload, sizeof(payload));
+}
+
+static uint8_t prv_deleteInstance(registration_setup_t * setupP,
+                                  uint16_t instanceId)
+{
+    lwm2m_uri_t uri;
+
+    memset(&uri, 0, sizeof(lwm2m_uri_t));
+    uri.objectId = TEST_OBJECT_ID;
+    uri.instanceId = instanceId;
+    uri.flag = LWM2M_URI_FLAG_OBJECT_ID | LWM2M_URI_FLAG_INSTANCE_ID;
+
+    return object_delete(&setupP->context, &uri);
+}
+
+// Sends the registration update of the server and answers it with code.
+// Returns the length of the object list sent in the update, or -1 if no update was sent.
+static int prv_update(registration_setup_t * setupP,
+                      uint8_t code)
+{
+    uint8_t buffer[256];
+    ssize_t length;
+    coap_packet_t message[1];
+    coap_packet_t answer[1];
+    size_t payloadLength;
+    time_t timeout = 60;
+
+    if (COAP_NO_ERROR != lwm2m_update_registration(&setupP->context, 1, false)) return -1;
+    registration_step(&setupP->context, 100, &timeout);
+
+    length = recv(setupP->receiver, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (length <= 0) return -1;
+    if (NO_ERROR != coap_parse_message(message, buffer, (uint16_t)length)) return -1;
+    payloadLength = message->payload_len;
+    CU_ASSERT_EQUAL(message->code, COAP_POST);
+
+    coap_init_message(answer, COAP_TYPE_ACK, code, message->mid);
+    coap_set_header_token(answer, message->token, message->token_len);
+    coap_free_header(message);
+    length = (ssize_t)coap_serialize_message(answer, buffer);
+    if (length <= 0) return -1;
+    lwm2m_handle_packet(&setupP->context, buffer, (int)length, &setupP->connection);
+
+    return (int)payloadLength;
+}
+
+static void test_registration_payload_cache(void)
+{
+    MEMORY_TRACE_BEFORE;
+    registration_setup_t setup;
+    uint8_t * payload;
+    uint8_t * previous;
+    uint8_t initial[64];
+    int length;
+    int initialLength;
+    uint32_t version;
+
+    prv_setup(&setup);
+
+    initialLength = object_getRegisterPayloadCache(&setup.context, &payload);
+    CU_ASSERT_FATAL(initialLength > 0 && initialLength <= (int)sizeof(initial));
+    memcpy(initial, payload, initialLength);
+    version = setup.context.registrationPayloadVersion;
+    CU_ASSERT_NOT_EQUAL(version, 0);
+
+    // the payload is built once
+    previous = payload;
+    CU_ASSERT_EQUAL(object_getRegisterPayloadCache(&setup.context, &payload), initialLength);
+    CU_ASSERT_PTR_EQUAL(payload, previous);
+
+    // a created instance changes the payload and its version
+    CU_ASSERT_EQUAL(prv_createInstance(&setup, 1), COAP_201_CREATED);
+    CU_ASSERT(setup.context.registrationPayloadOutdated);
+    length = object_getRegisterPayloadCache(&setup.context, &payload);
+    CU_ASSERT(length > initialLength);
+    CU_ASSERT_NOT_EQUAL(setup.context.registrationPayloadVersion, version);
+    version = setup.context.registrationPayloadVersion;
+
+    // so does a deleted instance
+    CU_ASSERT_EQUAL(prv_deleteInstance(&setup, 1), COAP_202_DELETED);
+    CU_ASSERT(setup.context.registrationPayloadOutdated);
+    length = object_getRegisterPayloadCache(&setup.context, &payload);
+    CU_ASSERT_EQUAL(length, initialLength);
+    CU_ASSERT(0 == memcmp(payload, initial, initialLength));
+    CU_ASSERT_NOT_EQUAL(setup.context.registrationPayloadVersion, version);
+    version = setup.context.registrationPayloadVersion;
+
+    // a failed creation keeps the cache
+    CU_ASSERT_EQUAL(prv_createInstance(&setup, TEST_INSTANCE_MAX), COAP_500_INTERNAL_SERVER_ERROR);
+    CU_ASSERT_FALSE(setup.context.registrationPayloadOutdated);
+
+    // a payload rebuilt with the same content keeps its version
+    previous = payload;
+    CU_ASSERT_EQUAL(lwm2m_update_registration(&setup.context, 1, true), COAP_NO_ERROR);
+    CU_ASSERT(setup.context.registrationPayloadOutdated);
+    CU_ASSERT_EQUAL(object_getRegisterPayloadCache(&setup.context, &payload), initialLength);
+    CU_ASSERT_PTR_EQUAL(payload, previous);
+    CU_ASSERT_EQUAL(setup.context.registrationPayloadVersion, version);
+
+    prv_cleanup(&setup);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_registration_update_payload(void)
+{
+    MEMORY_TRACE_BEFORE;
+    registration_setup_t setup;
+    int length;
+
+    prv_setup(&setup);
+
+    // the first update carries the object list
+    length = prv_update(&setup, COAP_204_CHANGED);
+    CU_ASSERT(length > 0);
+    CU_ASSERT_EQUAL(setup.server.status, STATE_REGISTERED);
+    CU_ASSERT_EQUAL(setup.server.payloadVersion, setup.context.registrationPayloadVersion);
+
+    // and the next ones only when it changed
+    CU_ASSERT_EQUAL(prv_update(&setup, COAP_204_CHANGED), 0);
+    CU_ASSERT_EQUAL(prv_createInstance(&setup, 1), COAP_201_CREATED);
+
+    // the new list is recorded only once the server accepted it
+    CU_ASSERT(prv_update(&setup, COAP_400_BAD_REQUEST) > length);
+    CU_ASSERT_EQUAL(setup.server.status, STATE_REG_FAILED);
+    CU_ASSERT_NOT_EQUAL(setup.server.payloadVersion, setup.context.registrationPayloadVersion);
+
+    setup.server.status = STATE_REGISTERED;
+    CU_ASSERT(prv_update(&setup, COAP_204_CHANGED) > length);
+    CU_ASSERT_EQUAL(setup.server.payloadVersion, setup.context.registrationPayloadVersion);
+    CU_ASSERT_EQUAL(prv_update(&setup, COAP_204_CHANGED), 0);
+
+    // the list is sent again when it returns to a former content
+    CU_ASSERT_EQUAL(prv_deleteInstance(&setup, 1), COAP_202_DELETED);
+    CU_ASSERT_EQUAL(prv_update(&setup, COAP_204_CHANGED), length);
+    CU_ASSERT_EQUAL(prv_update(&setup, COAP_204_CHANGED), 0);
+
+    prv_cleanup(&setup);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static struct TestTable table[] = {
+        { "test of the registration payload cache", test_registration_payload_cache },
+        { "test of the object list in the registration updates", test_registration_update_payload },
+        { NULL, NULL },
+};
+
+CU_ErrorCode create_registration_suit() {
+    CU_pSuite pSuite = NULL;
+    pSuite = CU_add_suite("Suite_registration", NULL, NULL);
+
+    if (NULL == pSuite) {
+        return CU_get_error();
+    }
+    return add_tests(pSuite, table);
+}
@@ -0,0 +1,138 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "tests.h"
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "harness.h"
+
+#include <stdio.h>
+
+#define CLIENT_COUNT    200
+
+static void test_clientstore_lookup(void)
+{
+    static lwm2m_client_t clients[CLIENT_COUNT];
+    static char names[CLIENT_COUNT][16];
+    lwm2m_client_store_t * storeP;
+    lwm2m_client_t * clientP;
+    uint16_t previousID;
+    int count;
+    int i;
+
+    harness_init();
+    storeP = clientstore_new();
+    CU_ASSERT_PTR_NOT_NULL_FATAL(storeP);
+    CU_ASSERT_PTR_NULL(storeP->findNameFunc("client0", 7, storeP));
+
+    memset(clients, 0, sizeof(clients));
+    for (i = 0 ; i < CLIENT_COUNT ; i++)
+    {
+        snprintf(names[i], sizeof(names[i]), "client%d", i);
+        clients[i].name = names[i];
+        clients[i].internalID = storeP->newIdFunc(storeP);
+        CU_ASSERT_PTR_NULL(storeP->findClientFunc(clients[i].internalID, storeP));
+        CU_ASSERT_EQUAL(storeP->addClientFunc(clients + i, storeP), 0);
+    }
+
+    for (i = 0 ; i < CLIENT_COUNT ; i++)
+    {
+        CU_ASSERT_PTR_EQUAL(storeP->findClientFunc(clients[i].internalID, storeP), clients + i);
+        CU_ASSERT_PTR_EQUAL(storeP->findNameFunc(names[i], strlen(names[i]), storeP), clients + i);
+    }
+    // the names are compared as a whole
+    CU_ASSERT_PTR_EQUAL(storeP->findNameFunc("client10", 7, storeP), clients + 1);
+    CU_ASSERT_PTR_NULL(storeP->findNameFunc("client", 6, storeP));
+    CU_ASSERT_PTR_NULL(storeP->findNameFunc("client2000", 10, storeP));
+
+    // the other clients are still found once some are removed from their clusters
+    for (i = 0 ; i < CLIENT_COUNT ; i += 3)
+    {
+        CU_ASSERT_PTR_EQUAL(storeP->removeClientFunc(clients[i].internalID, storeP), clients + i);
+    }
+    CU_ASSERT_PTR_NULL(storeP->removeClientFunc(clients[0].internalID, storeP));
+    for (i = 0 ; i < CLIENT_COUNT ; i++)
+    {
+        lwm2m_client_t * expectedP = (i % 3 == 0) ? NULL : clients + i;
+
+        CU_ASSERT_PTR_EQUAL(storeP->findClientFunc(clients[i].internalID, storeP), expectedP);
+        CU_ASSERT_PTR_EQUAL(storeP->findNameFunc(names[i], strlen(names[i]), storeP), expectedP);
+    }
+
+    // the clients are listed by internal ID
+    count = 0;
+    previousID = 0;
+    for (clientP = storeP->nextClientFunc(NULL, storeP) ; clientP != NULL ; clientP = storeP->nextClientFunc(clientP, storeP))
+    {
+        if (count > 0) CU_ASSERT(clientP->internalID > previousID);
+        previousID = clientP->internalID;
+        count++;
+    }
+    CU_ASSERT_EQUAL(count, CLIENT_COUNT - (CLIENT_COUNT + 2) / 3);
+
+    storeP->closeFunc(storeP);
+}
+
+static void test_clientstore_registration(void)
+{
+    harness_client_t client1;
+    harness_client_t client2;
+    lwm2m_context_t * contextP;
+    lwm2m_client_store_t * storeP;
+    int id1;
+    int id2;
+
+    harness_init();
+    harness_client_init(&client1);
+    harness_client_init(&client2);
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+
+    // a new registration of an endpoint replaces the previous one, even from another address
+    id1 = harness_register(contextP, &client1, "endpoint", "U", "</1/0>,</3/0>");
+    id2 = harness_register(contextP, &client2, "endpoint", "U", "</1/0>,</3/0>");
+    CU_ASSERT(id1 >= 0);
+    CU_ASSERT_EQUAL(id1, id2);
+    CU_ASSERT_PTR_EQUAL(contextP->clientStore->findNameFunc("endpoint", 8, contextP->clientStore)->sessionH, &client2);
+
+    // the store is only replaced without any registered client
+    storeP = clientstore_new();
+    CU_ASSERT_PTR_NOT_NULL_FATAL(storeP);
+    CU_ASSERT_EQUAL(lwm2m_set_client_store(contextP, storeP), COAP_412_PRECONDITION_FAILED);
+    CU_ASSERT_EQUAL(harness_deregister(contextP, &client2), COAP_202_DELETED);
+    CU_ASSERT_EQUAL(lwm2m_set_client_store(contextP, storeP), COAP_NO_ERROR);
+    CU_ASSERT(harness_register(contextP, &client1, "endpoint", "U", "</1/0>,</3/0>") >= 0);
+    CU_ASSERT_PTR_NOT_NULL(storeP->findNameFunc("endpoint", 8, storeP));
+
+    lwm2m_close(contextP);
+}
+
+static struct TestTable table[] = {
+        { "test of the client store lookups", test_clientstore_lookup },
+        { "test of the client store on registrations", test_clientstore_registration },
+        { NULL, NULL },
+};
+
+CU_ErrorCode create_clientstore_suit() {
+    CU_pSuite pSuite = NULL;
+    pSuite = CU_add_suite("Suite_clientstore", NULL, NULL);
+
+    if (NULL == pSuite) {
+        return CU_get_error();
+    }
+    return add_tests(pSuite, table);
+}
@@ -0,0 +1,470 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "harness.h"
+#include "er-coap-13/er-coap-13.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#define HARNESS_MAX_CLIENTS     4
+
+static time_t g_now;
+static harness_client_t * g_clients[HARNESS_MAX_CLIENTS];
+static int g_clientCount;
+static uint16_t g_nextMID;
+static harness_store_t g_store;
+static int g_mallocCount;
+static int g_allocationCount;
+static lwm2m_result_callback_t g_observeCallback;
+
+void * lwm2m_malloc(size_t s)
+{
+    if (g_mallocCount == 0) return NULL;
+    if (g_mallocCount > 0) g_mallocCount--;
+    g_allocationCount++;
+    return malloc(s);
+}
+
+void lwm2m_free(void * p)
+{
+    free(p);
+}
+
+char * lwm2m_strdup(const char * str)
+{
+    return strdup(str);
+}
+
+int lwm2m_strncmp(const char * s1,
+                  const char * s2,
+                  size_t n)
+{
+    return strncmp(s1, s2, n);
+}
+
+time_t lwm2m_gettime(void)
+{
+    return g_now;
+}
+
+void lwm2m_printf(const char * format, ...)
+{
+    va_list ap;
+
+    va_start(ap, format);
+    vfprintf(stderr, format, ap);
+    va_end(ap);
+}
+
+bool lwm2m_session_is_equal(void * session1,
+                            void * session2,
+                            void * userData)
+{
+    (void)userData;
+
+    return (session1 == session2);
+}
+
+uint8_t lwm2m_buffer_send(void * sessionH,
+                          uint8_t * buffer,
+                          size_t length,
+                          void * userData)
+{
+    harness_client_t * clientP = (harness_client_t *)sessionH;
+    harness_request_t * requestP;
+    coap_packet_t message;
+    multi_option_t * optionP;
+    size_t uriLength;
+
+    (void)userData;
+    if (coap_parse_message(&message, buffer, (uint16_t)length) != NO_ERROR) return COAP_500_INTERNAL_SERVER_ERROR;
+
+    if (message.type == COAP_TYPE_RST)
+    {
+        clientP->resetCount++;
+        coap_free_header(&message);
+        return COAP_NO_ERROR;
+    }
+    if (message.type == COAP_TYPE_ACK)
+    {
+        // answer to a registration message
+        clientP->answer = message.code;
+        if (message.location_path != NULL)
+        {
+            uriLength = 0;
+            for (optionP = message.location_path ; optionP != NULL ; optionP = optionP->next)
+            {
+                if (uriLength + 1 + optionP->len >= sizeof(clientP->location)) break;
+                clientP->location[uriLength++] = '/';
+                memcpy(clientP->location + uriLength, optionP->data, optionP->len);
+                uriLength += optionP->len;
+            }
+            clientP->location[uriLength] = 0;
+        }
+        coap_free_header(&message);
+        return COAP_NO_ERROR;
+    }
+    if (clientP->requestCount == HARNESS_MAX_REQUESTS)
+    {
+        coap_free_header(&message);
+        return COAP_500_INTERNAL_SERVER_ERROR;
+    }
+
+    requestP = clientP->requests + clientP->requestCount;
+    memset(requestP, 0, sizeof(harness_request_t));
+    requestP->mID = message.mid;
+    requestP->tokenLen = message.token_len;
+    memcpy(requestP->token, message.token, message.token_len);
+    requestP->code = message.code;
+    uriLength = 0;
+    for (optionP = message.uri_path ; optionP != NULL ; optionP = optionP->next)
+    {
+        if (uriLength + 1 + optionP->len >= sizeof(requestP->uri)) break;
+        requestP->uri[uriLength++] = '/';
+        memcpy(requestP->uri + uriLength, optionP->data, optionP->len);
+        uriLength += optionP->len;
+    }
+    requestP->uri[uriLength] = 0;
+    requestP->observe = IS_OPTION(&message, COAP_OPTION_OBSERVE);
+    requestP->block = IS_OPTION(&message, COAP_OPTION_BLOCK1) || IS_OPTION(&message, COAP_OPTION_BLOCK2);
+    if (message.payload_len <= HARNESS_MAX_PAYLOAD)
+    {
+        memcpy(requestP->payload, message.payload, message.payload_len);
+        requestP->payloadLength = message.payload_len;
+    }
+    clientP->requestCount++;
+    coap_free_header(&message);
+
+    return COAP_NO_ERROR;
+}
+
+int lwm2m_store_open(uint8_t ** bufferP,
+                     size_t * lengthP,
+                     void * userData)
+{
+    (void)userData;
+
+    *bufferP = g_store.data;
+    *lengthP = g_store.length;
+    return 0;
+}
+
+void lwm2m_store_close(uint8_t * buffer,
+                       size_t length,
+                       void * userData)
+{
+    (void)buffer;
+    (void)length;
+    (void)userData;
+}
+
+int lwm2m_store_append(uint8_t * buffer,
+                       size_t length,
+                       void * userData)
+{
+    uint8_t * data;
+
+    (void)userData;
+    g_store.appendCount++;
+    if (g_store.failWrites) return -1;
+    data = (uint8_t *)realloc(g_store.data, g_store.length + length);
+    if (data == NULL) return -1;
+    memcpy(data + g_store.length, buffer, length);
+    g_store.data = data;
+    g_store.length += length;
+    return 0;
+}
+
+int lwm2m_store_replace(uint8_t * buffer,
+                        size_t length,
+                        void * userData)
+{
+    uint8_t * data;
+
+    (void)userData;
+    g_store.replaceCount++;
+    if (g_store.failWrites) return -1;
+    data = NULL;
+    if (length != 0)
+    {
+        data = (uint8_t *)malloc(length);
+        if (data == NULL) return -1;
+        memcpy(data, buffer, length);
+    }
+    free(g_store.data);
+    g_store.data = data;
+    g_store.length = length;
+    return 0;
+}
+
+// The address of a client is its index
+size_t lwm2m_session_save(void * sessionH,
+                          uint8_t * buffer,
+                          size_t length,
+                          void * userData)
+{
+    int i;
+
+    (void)userData;
+    if (length < 1) return 0;
+    for (i = 0 ; i < g_clientCount ; i++)
+    {
+        if (g_clients[i] == sessionH)
+        {
+            buffer[0] = (uint8_t)i;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+void * lwm2m_session_restore(uint8_t * buffer,
+                             size_t length,
+                             void * userData)
+{
+    (void)userData;
+    if (length != 1 || buffer[0] >= g_clientCount) return NULL;
+
+    return g_clients[buffer[0]];
+}
+
+// The identity of a subscriber is its userData
+int lwm2m_observation_save(lwm2m_result_callback_t callback,
+                           void * callbackData,
+                           uint8_t * buffer,
+                           size_t length,
+                           void * userData)
+{
+    (void)callback;
+    (void)userData;
+    if (length < sizeof(void *)) return -1;
+    memcpy(buffer, &callbackData, sizeof(void *));
+
+    return (int)sizeof(void *);
+}
+
+bool lwm2m_observation_restore(uint16_t clientID,
+                               lwm2m_uri_t * uriP,
+                               uint8_t * buffer,
+                               size_t length,
+                               lwm2m_result_callback_t * callbackP,
+                               void ** callbackDataP,
+                               void * userData)
+{
+    (void)clientID;
+    (void)uriP;
+    (void)userData;
+    if (length != sizeof(void *) || g_observeCallback == NULL) return false;
+    *callbackP = g_observeCallback;
+    memcpy(callbackDataP, buffer, sizeof(void *));
+
+    return true;
+}
+
+void harness_init(void)
+{
+    g_now = 1000;
+    g_clientCount = 0;
+    g_nextMID = 1;
+    g_mallocCount = -1;
+    g_allocationCount = 0;
+    g_observeCallback = NULL;
+    free(g_store.data);
+    memset(&g_store, 0, sizeof(harness_store_t));
+}
+
+time_t harness_now(void)
+{
+    return g_now;
+}
+
+void harness_advance(time_t seconds)
+{
+    g_now += seconds;
+}
+
+harness_store_t * harness_store(void)
+{
+    return &g_store;
+}
+
+void harness_fail_malloc(int count)
+{
+    g_mallocCount = count;
+}
+
+int harness_allocations(void)
+{
+    return g_allocationCount;
+}
+
+void harness_set_observe_callback(lwm2m_result_callback_t callback)
+{
+    g_observeCallback = callback;
+}
+
+void harness_client_init(harness_client_t * clientP)
+{
+    memset(clientP, 0, sizeof(harness_client_t));
+    if (g_clientCount < HARNESS_MAX_CLIENTS)
+    {
+        g_clients[g_clientCount++] = clientP;
+    }
+}
+
+int harness_in_flight(harness_client_t * clientP)
+{
+    int count;
+    int i;
+
+    count = 0;
+    for (i = 0 ; i < clientP->requestCount ; i++)
+    {
+        if (!clientP->requests[i].answered) count++;
+    }
+
+    return count;
+}
+
+static void prv_send(lwm2m_context_t * contextP,
+                     harness_client_t * clientP,
+                     coap_packet_t * messageP)
+{
+    uint8_t * buffer;
+    size_t length;
+
+    length = coap_serialize_get_size(messageP);
+    buffer = (uint8_t *)malloc(length);
+    if (buffer == NULL) return;
+    length = coap_serialize_message(messageP, buffer);
+    lwm2m_handle_packet(contextP, buffer, (int)length, clientP);
+    free(buffer);
+}
+
+static void prv_sendRegistration(lwm2m_context_t * contextP,
+                                 harness_client_t * clientP,
+                                 const char * path,
+                                 const char * query,
+                                 const char * links)
+{
+    coap_packet_t message;
+
+    coap_init_message(&message, COAP_TYPE_CON, COAP_POST, g_nextMID++);
+    coap_set_header_uri_path(&message, path);
+    if (query != NULL) coap_set_header_uri_query(&message, query);
+    coap_set_header_content_type(&message, LWM2M_CONTENT_LINK);
+    if (links != NULL) coap_set_payload(&message, links, strlen(links));
+    clientP->answer = 0;
+    prv_send(contextP, clientP, &message);
+    coap_free_header(&message);
+}
+
+int harness_register(lwm2m_context_t * contextP,
+                          harness_client_t * clientP,
+                          const char * name,
+                          const char * binding,
+                          const char * links)
+{
+    char query[64];
+
+    snprintf(query, sizeof(query), "lwm2m=1.0&ep=%s&b=%s&lt=300", name, binding);
+    prv_sendRegistration(contextP, clientP, "/rd", query, links);
+    if (clientP->answer != COAP_201_CREATED) return -1;
+
+    return atoi(clientP->location + 4);
+}
+
+uint8_t harness_update(lwm2m_context_t * contextP,
+                       harness_client_t * clientP,
+                       const char * links)
+{
+    prv_sendRegistration(contextP, clientP, clientP->location, NULL, links);
+
+    return clientP->answer;
+}
+
+uint8_t harness_deregister(lwm2m_context_t * contextP,
+                           harness_client_t * clientP)
+{
+    coap_packet_t message;
+
+    coap_init_message(&message, COAP_TYPE_CON, COAP_DELETE, g_nextMID++);
+    coap_set_header_uri_path(&message, clientP->location);
+    clientP->answer = 0;
+    prv_send(contextP, clientP, &message);
+    coap_free_header(&message);
+
+    return clientP->answer;
+}
+
+void harness_answer(lwm2m_context_t * contextP,
+                    harness_client_t * clientP,
+                    int index,
+                    uint8_t code,
+                    const uint8_t * payload,
+                    size_t length)
+{
+    harness_request_t * requestP = clientP->requests + index;
+    coap_packet_t message;
+    time_t timeout;
+
+    requestP->answered = true;
+    coap_init_message(&message, COAP_TYPE_ACK, code, requestP->mID);
+    coap_set_header_token(&message, requestP->token, requestP->tokenLen);
+    if (payload != NULL)
+    {
+        coap_set_header_content_type(&message, LWM2M_CONTENT_TEXT);
+        coap_set_payload(&message, payload, length);
+    }
+    prv_send(contextP, clientP, &message);
+    coap_free_header(&message);
+
+    // the queued requests are sent by lwm2m_step()
+    timeout = 60;
+    lwm2m_step(contextP, &timeout);
+}
+
+void harness_notify(lwm2m_context_t * contextP,
+                    harness_client_t * clientP,
+                    int index,
+                    uint32_t count,
+                    const uint8_t * payload,
+                    size_t length)
+{
+    harness_request_t * requestP = clientP->requests + index;
+    coap_packet_t message;
+
+    if (requestP->answered)
+    {
+        coap_init_message(&message, COAP_TYPE_NON, COAP_205_CONTENT, g_nextMID++);
+    }
+    else
+    {
+        requestP->answered = true;
+        coap_init_message(&message, COAP_TYPE_ACK, COAP_205_CONTENT, requestP->mID);
+    }
+    coap_set_header_token(&message, requestP->token, requestP->tokenLen);
+    coap_set_header_observe(&message, count);
+    coap_set_header_content_type(&message, LWM2M_CONTENT_TEXT);
+    coap_set_payload(&message, payload, length);
+    prv_send(contextP, clientP, &message);
+    coap_free_header(&message);
+}
@@ -0,0 +1,92 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#ifndef HARNESS_H_
+#define HARNESS_H_
+
+#include "liblwm2m.h"
+
+/*
+ * Simulated clients of a server, and an in-memory registration store.
+ *
+ * The platform functions of the library run on a virtual clock. The requests sent by the server
+ * to a client are recorded, to be answered by the test with harness_answer(). The registration
+ * store is a buffer kept from one context to the next, so that lwm2m_init() replays it.
+ */
+
+#define HARNESS_MAX_REQUESTS    32
+#define HARNESS_MAX_PAYLOAD     64
+
+typedef struct
+{
+    uint16_t    mID;
+    uint8_t     token[8];
+    size_t      tokenLen;
+    uint8_t     code;
+    char        uri[32];        // path of the request, "" for none
+    bool        observe;
+    bool        block;          // carries a Block1 or Block2 option
+    uint8_t     payload[HARNESS_MAX_PAYLOAD];
+    size_t      payloadLength;
+    bool        answered;
+} harness_request_t;
+
+// A client, and its session handle
+typedef struct
+{
+    harness_request_t   requests[HARNESS_MAX_REQUESTS];
+    int                 requestCount;
+    uint8_t             answer;         // code of the answer to the last registration message
+    int                 resetCount;     // number of reset messages received
+    char                location[16];   // registration location given by the server
+} harness_client_t;
+
+// The registration store
+typedef struct
+{
+    uint8_t *   data;
+    size_t      length;
+    int         appendCount;
+    int         replaceCount;
+    bool        failWrites;     // lwm2m_store_append() and lwm2m_store_replace() fail
+} harness_store_t;
+
+// Resets the clock and the clients. The store is emptied.
+void harness_init(void);
+time_t harness_now(void);
+void harness_advance(time_t seconds);
+harness_store_t * harness_store(void);
+// The next lwm2m_malloc() calls fail after count successful ones, -1 to stop failing
+void harness_fail_malloc(int count);
+// Number of successful lwm2m_malloc() calls since harness_init()
+int harness_allocations(void);
+void harness_client_init(harness_client_t * clientP);
+// Registers the client, with the binding and the object links given. Returns the internal ID of the client or -1.
+int harness_register(lwm2m_context_t * contextP, harness_client_t * clientP, const char * name, const char * binding, const char * links);
+// Sends a registration update, with the object links given or none
+uint8_t harness_update(lwm2m_context_t * contextP, harness_client_t * clientP, const char * links);
+// Sends a deregistration
+uint8_t harness_deregister(lwm2m_context_t * contextP, harness_client_t * clientP);
+// Answers the request of the client at index, then runs lwm2m_step()
+void harness_answer(lwm2m_context_t * contextP, harness_client_t * clientP, int index, uint8_t code, const uint8_t * payload, size_t length);
+// Sends a notification of the observe request at index: the answer to the request if not answered yet
+void harness_notify(lwm2m_context_t * contextP, harness_client_t * clientP, int index, uint32_t count, const uint8_t * payload, size_t length);
+int harness_in_flight(harness_client_t * clientP);
+// Callback given to the observations restored from the store, with the userData they were saved with
+void harness_set_observe_callback(lwm2m_result_callback_t callback);
+
+#endif
@@ -0,0 +1,341 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "tests.h"
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "harness.h"
+
+#define MAX_RESULTS     32
+
+// Results given by the library to the callbacks of the requests
+typedef struct
+{
+    int     count;
+    int     status[MAX_RESULTS];
+    char    data[MAX_RESULTS][8];
+} result_log_t;
+
+static void prv_callback(uint16_t clientID,
+                         lwm2m_uri_t * uriP,
+                         int status,
+                         lwm2m_media_type_t format,
+                         uint8_t * data,
+                         int dataLength,
+                         void * userData)
+{
+    result_log_t * logP = (result_log_t *)userData;
+
+    (void)clientID;
+    (void)uriP;
+    (void)format;
+    if (logP->count == MAX_RESULTS) return;
+
+    logP->status[logP->count] = status;
+    logP->data[logP->count][0] = 0;
+    if (data != NULL && dataLength < 8)
+    {
+        memcpy(logP->data[logP->count], data, dataLength);
+        logP->data[logP->count][dataLength] = 0;
+    }
+    logP->count++;
+}
+
+static lwm2m_uri_t * prv_uri(const char * path,
+                             lwm2m_uri_t * uriP)
+{
+    lwm2m_stringToUri(path, strlen(path), uriP);
+    return uriP;
+}
+
+static int prv_read(lwm2m_context_t * contextP,
+                    uint16_t clientID,
+                    const char * path,
+                    result_log_t * logP)
+{
+    lwm2m_uri_t uri;
+
+    return lwm2m_dm_read(contextP, clientID, prv_uri(path, &uri), prv_callback, logP);
+}
+
+static int prv_write(lwm2m_context_t * contextP,
+                     uint16_t clientID,
+                     const char * path,
+                     const char * value,
+                     result_log_t * logP)
+{
+    lwm2m_uri_t uri;
+
+    return lwm2m_dm_write(contextP, clientID, prv_uri(path, &uri), LWM2M_CONTENT_TEXT, (uint8_t *)value, (int)strlen(value), prv_callback, logP);
+}
+
+// Registers a client in queue mode
+static lwm2m_context_t * prv_setup(harness_client_t * clientP,
+                                   uint16_t * clientIdP)
+{
+    lwm2m_context_t * contextP;
+    int id;
+
+    harness_init();
+    harness_client_init(clientP);
+    contextP = lwm2m_init(NULL);
+    if (contextP == NULL) return NULL;
+    id = harness_register(contextP, clientP, "queue", "UQ", "</1/0>,</3/0>");
+    if (id < 0)
+    {
+        lwm2m_close(contextP);
+        return NULL;
+    }
+    *clientIdP = (uint16_t)id;
+
+    return contextP;
+}
+
+// Wakes the client up and answers its requests one by one
+static void prv_drain(lwm2m_context_t * contextP,
+                      harness_client_t * clientP,
+                      uint8_t readAnswer)
+{
+    int i;
+
+    CU_ASSERT_EQUAL(harness_update(contextP, clientP, NULL), COAP_204_CHANGED);
+    for (i = 0 ; i < clientP->requestCount ; i++)
+    {
+        if (clientP->requests[i].code == COAP_GET)
+        {
+            harness_answer(contextP, clientP, i, readAnswer, (uint8_t *)"v", 1);
+        }
+        else
+        {
+            harness_answer(contextP, clientP, i, COAP_204_CHANGED, NULL, 0);
+        }
+    }
+}
+
+static void test_queue_bound(void)
+{
+    harness_client_t client;
+    lwm2m_context_t * contextP;
+    result_log_t log;
+    uint16_t clientID;
+    char path[16];
+    int i;
+
+    contextP = prv_setup(&client, &clientID);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    memset(&log, 0, sizeof(log));
+
+    for (i = 0 ; i < LWM2M_QUEUE_MAX_SIZE ; i++)
+    {
+        snprintf(path, sizeof(path), "/3/0/%d", i);
+        CU_ASSERT_EQUAL(prv_read(contextP, clientID, path, &log), COAP_NO_ERROR);
+    }
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/1/0/1", &log), COAP_503_SERVICE_UNAVAILABLE);
+    // a duplicate takes no room
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/0", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(client.requestCount, 0);
+    CU_ASSERT_EQUAL(log.count, 0);
+
+    prv_drain(contextP, &client, COAP_205_CONTENT);
+    CU_ASSERT_EQUAL(client.requestCount, LWM2M_QUEUE_MAX_SIZE);
+    CU_ASSERT_EQUAL(log.count, LWM2M_QUEUE_MAX_SIZE + 1);
+
+    lwm2m_close(contextP);
+}
+
+static void test_queue_ttl(void)
+{
+    harness_client_t client;
+    lwm2m_context_t * contextP;
+    result_log_t log;
+    uint16_t clientID;
+    time_t timeout;
+
+    contextP = prv_setup(&client, &clientID);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    memset(&log, 0, sizeof(log));
+
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/1", &log), COAP_NO_ERROR);
+    harness_advance(LWM2M_QUEUE_TTL / 2);
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/2", &log), COAP_NO_ERROR);
+
+    harness_advance(LWM2M_QUEUE_TTL / 2);
+    timeout = LWM2M_QUEUE_TTL;
+    // only the first request expires
+    CU_ASSERT_EQUAL(lwm2m_step(contextP, &timeout), 0);
+    CU_ASSERT_EQUAL(log.count, 1);
+    CU_ASSERT_EQUAL(log.status[0], COAP_503_SERVICE_UNAVAILABLE);
+    CU_ASSERT(timeout <= LWM2M_QUEUE_TTL / 2);
+
+    prv_drain(contextP, &client, COAP_205_CONTENT);
+    CU_ASSERT_EQUAL(client.requestCount, 1);
+    CU_ASSERT_STRING_EQUAL(client.requests[0].uri, "/3/0/2");
+    CU_ASSERT_EQUAL(log.count, 2);
+    CU_ASSERT_EQUAL(log.status[1], COAP_205_CONTENT);
+
+    lwm2m_close(contextP);
+}
+
+static void test_queue_read_merge(void)
+{
+    harness_client_t client;
+    lwm2m_context_t * contextP;
+    result_log_t log;
+    uint16_t clientID;
+
+    contextP = prv_setup(&client, &clientID);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    memset(&log, 0, sizeof(log));
+
+    // identical reads are sent once
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/1", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/2", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/1", &log), COAP_NO_ERROR);
+    prv_drain(contextP, &client, COAP_205_CONTENT);
+    CU_ASSERT_EQUAL(client.requestCount, 2);
+    CU_ASSERT_STRING_EQUAL(client.requests[0].uri, "/3/0/1");
+    CU_ASSERT_STRING_EQUAL(client.requests[1].uri, "/3/0/2");
+    CU_ASSERT_EQUAL(log.count, 3);
+    CU_ASSERT_STRING_EQUAL(log.data[0], "v");
+    CU_ASSERT_STRING_EQUAL(log.data[1], "v");
+
+    // a read following a write on its path is not answered by a read preceding the write
+    client.requestCount = 0;
+    memset(&log, 0, sizeof(log));
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/1", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_write(contextP, clientID, "/3/0/1", "A", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/1", &log), COAP_NO_ERROR);
+    // nor one following a write on the instance
+    CU_ASSERT_EQUAL(prv_write(contextP, clientID, "/3/0", "B", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/1", &log), COAP_NO_ERROR);
+    prv_drain(contextP, &client, COAP_205_CONTENT);
+    CU_ASSERT_EQUAL(client.requestCount, 5);
+    CU_ASSERT_EQUAL(client.requests[0].code, COAP_GET);
+    CU_ASSERT_EQUAL(client.requests[1].code, COAP_PUT);
+    CU_ASSERT_EQUAL(client.requests[2].code, COAP_GET);
+    CU_ASSERT_EQUAL(client.requests[3].code, COAP_POST);
+    CU_ASSERT_EQUAL(client.requests[4].code, COAP_GET);
+    CU_ASSERT_EQUAL(log.count, 5);
+
+    lwm2m_close(contextP);
+}
+
+static void test_queue_write_supersede(void)
+{
+    harness_client_t client;
+    lwm2m_context_t * contextP;
+    result_log_t log;
+    uint16_t clientID;
+
+    contextP = prv_setup(&client, &clientID);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    memset(&log, 0, sizeof(log));
+
+    // the last write wins, in the place of the first one
+    CU_ASSERT_EQUAL(prv_write(contextP, clientID, "/1/0/1", "A", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/1", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_write(contextP, clientID, "/1/0/1", "B", &log), COAP_NO_ERROR);
+    prv_drain(contextP, &client, COAP_205_CONTENT);
+    CU_ASSERT_EQUAL(client.requestCount, 2);
+    CU_ASSERT_EQUAL(client.requests[0].code, COAP_PUT);
+    CU_ASSERT_EQUAL(client.requests[0].payloadLength, 1);
+    CU_ASSERT_EQUAL(client.requests[0].payload[0], 'B');
+    CU_ASSERT_STRING_EQUAL(client.requests[1].uri, "/3/0/1");
+    CU_ASSERT_EQUAL(log.count, 3);
+
+    // a write following a read on its path does not overtake it
+    client.requestCount = 0;
+    memset(&log, 0, sizeof(log));
+    CU_ASSERT_EQUAL(prv_write(contextP, clientID, "/1/0/1", "A", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/1/0/1", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_write(contextP, clientID, "/1/0/1", "B", &log), COAP_NO_ERROR);
+    prv_drain(contextP, &client, COAP_205_CONTENT);
+    CU_ASSERT_EQUAL(client.requestCount, 3);
+    CU_ASSERT_EQUAL(client.requests[0].payload[0], 'A');
+    CU_ASSERT_EQUAL(client.requests[1].code, COAP_GET);
+    CU_ASSERT_EQUAL(client.requests[2].payload[0], 'B');
+    CU_ASSERT_EQUAL(log.count, 3);
+
+    // writes on other resources are all sent
+    client.requestCount = 0;
+    memset(&log, 0, sizeof(log));
+    CU_ASSERT_EQUAL(prv_write(contextP, clientID, "/1/0/1", "A", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_write(contextP, clientID, "/1/0/2", "B", &log), COAP_NO_ERROR);
+    prv_drain(contextP, &client, COAP_205_CONTENT);
+    CU_ASSERT_EQUAL(client.requestCount, 2);
+    CU_ASSERT_STRING_EQUAL(client.requests[0].uri, "/1/0/1");
+    CU_ASSERT_STRING_EQUAL(client.requests[1].uri, "/1/0/2");
+    CU_ASSERT_EQUAL(log.count, 2);
+
+    lwm2m_close(contextP);
+}
+
+static void test_queue_drain(void)
+{
+    harness_client_t client;
+    lwm2m_context_t * contextP;
+    result_log_t log;
+    uint16_t clientID;
+    int i;
+
+    contextP = prv_setup(&client, &clientID);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    memset(&log, 0, sizeof(log));
+
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/1", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_write(contextP, clientID, "/1/0/1", "A", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/2", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(client.requestCount, 0);
+
+    // sent in issuing order, LWM2M_QUEUE_NSTART at a time
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, NULL), COAP_204_CHANGED);
+    for (i = 0 ; i < 3 ; i++)
+    {
+        CU_ASSERT_EQUAL(harness_in_flight(&client), 1);
+        harness_answer(contextP, &client, i, COAP_205_CONTENT, NULL, 0);
+    }
+    CU_ASSERT_EQUAL(client.requestCount, 3);
+    CU_ASSERT_STRING_EQUAL(client.requests[0].uri, "/3/0/1");
+    CU_ASSERT_STRING_EQUAL(client.requests[1].uri, "/1/0/1");
+    CU_ASSERT_STRING_EQUAL(client.requests[2].uri, "/3/0/2");
+    CU_ASSERT_EQUAL(log.count, 3);
+
+    // once the queue is empty, the requests wait for the next registration update
+    CU_ASSERT_EQUAL(prv_read(contextP, clientID, "/3/0/3", &log), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(client.requestCount, 3);
+
+    lwm2m_close(contextP);
+}
+
+static struct TestTable table[] = {
+        { "test of the queue size", test_queue_bound },
+        { "test of the queued requests expiration", test_queue_ttl },
+        { "test of the queued reads merging", test_queue_read_merge },
+        { "test of the queued writes superseding", test_queue_write_supersede },
+        { "test of the queue draining", test_queue_drain },
+        { NULL, NULL },
+};
+
+CU_ErrorCode create_queue_suit() {
+    CU_pSuite pSuite = NULL;
+    pSuite = CU_add_suite("Suite_queue", NULL, NULL);
+
+    if (NULL == pSuite) {
+        return CU_get_error();
+    }
+    return add_tests(pSuite, table);
+}
@@ -0,0 +1,354 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "tests.h"
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "harness.h"
+
+static lwm2m_client_t * prv_find(lwm2m_context_t * contextP,
+                                 const char * name)
+{
+    return contextP->clientStore->findNameFunc(name, strlen(name), contextP->clientStore);
+}
+
+// Returns true if the client lists exactly the (objectId, instanceId) pairs given
+static bool prv_hasObjects(lwm2m_client_t * clientP,
+                           const uint16_t (* expected)[2],
+                           size_t count)
+{
+    size_t i;
+
+    if (clientP->objectCount != count) return false;
+    for (i = 0 ; i < count ; i++)
+    {
+        if (clientP->objects[i].objectId != expected[i][0]
+         || clientP->objects[i].instanceId != expected[i][1])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void prv_observeCallback(uint16_t clientID,
+                                lwm2m_uri_t * uriP,
+                                int status,
+                                lwm2m_media_type_t format,
+                                uint8_t * data,
+                                int dataLength,
+                                void * userData)
+{
+    (void)clientID;
+    (void)uriP;
+    (void)format;
+    (void)data;
+    (void)dataLength;
+    *(int *)userData = status;
+}
+
+static void test_registration_objects(void)
+{
+    static const uint16_t expected[][2] = {
+        { 1, 0 }, { 1, 1 }, { 3, 0 }, { 5, 0 }, { 6, LWM2M_MAX_ID }
+    };
+    static const uint16_t updated[][2] = { { 1, 0 }, { 3, 0 } };
+    harness_client_t client;
+    lwm2m_context_t * contextP;
+    lwm2m_client_t * clientP;
+
+    harness_init();
+    harness_client_init(&client);
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+
+    // the list is sorted, without duplicates nor the objects also listed with instances
+    CU_ASSERT(harness_register(contextP, &client, "endpoint", "U", "</3/0>,</1/1>,</5>,</1/0>,</3/0>,</6>,</5/0>") >= 0);
+    clientP = prv_find(contextP, "endpoint");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP);
+    CU_ASSERT(prv_hasObjects(clientP, expected, sizeof(expected) / sizeof(expected[0])));
+    CU_ASSERT_STRING_EQUAL(clientP->name, "endpoint");
+    CU_ASSERT_PTR_NULL(clientP->msisdn);
+
+    // the record does not move when it still fits
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, "</1/0>,</3/0>"), COAP_204_CHANGED);
+    CU_ASSERT(prv_hasObjects(clientP, updated, 2));
+    CU_ASSERT_PTR_EQUAL(clientP->objects, (lwm2m_client_object_t *)(clientP + 1));
+    CU_ASSERT_STRING_EQUAL(clientP->name, "endpoint");
+
+    lwm2m_close(contextP);
+}
+
+static void test_registration_shared_strings(void)
+{
+    harness_client_t client1;
+    harness_client_t client2;
+    harness_client_t client3;
+    lwm2m_context_t * contextP;
+    lwm2m_client_t * client1P;
+    lwm2m_client_t * client3P;
+
+    harness_init();
+    harness_client_init(&client1);
+    harness_client_init(&client2);
+    harness_client_init(&client3);
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+
+    CU_ASSERT(harness_register(contextP, &client1, "client1", "U", "</lwm2m>;rt=\"oma.lwm2m\",</1/0>") >= 0);
+    CU_ASSERT(harness_register(contextP, &client2, "client2", "U", "</lwm2m>;rt=\"oma.lwm2m\",</1/0>") >= 0);
+    CU_ASSERT(harness_register(contextP, &client3, "client3", "U", "</other>;rt=\"oma.lwm2m\",</1/0>") >= 0);
+    client1P = prv_find(contextP, "client1");
+    client3P = prv_find(contextP, "client3");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(client1P);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(client3P);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(client1P->altPath);
+    CU_ASSERT_STRING_EQUAL(client1P->altPath, "lwm2m");
+    CU_ASSERT_STRING_EQUAL(client3P->altPath, "other");
+
+    // the same string is interned once
+    CU_ASSERT_PTR_EQUAL(prv_find(contextP, "client2")->altPath, client1P->altPath);
+    CU_ASSERT_PTR_NOT_EQUAL(client3P->altPath, client1P->altPath);
+
+    // and kept until its last client leaves
+    CU_ASSERT_EQUAL(harness_deregister(contextP, &client1), COAP_202_DELETED);
+    CU_ASSERT_STRING_EQUAL(prv_find(contextP, "client2")->altPath, "lwm2m");
+    CU_ASSERT(harness_register(contextP, &client1, "client1", "U", "</lwm2m>;rt=\"oma.lwm2m\",</1/0>") >= 0);
+    CU_ASSERT_PTR_EQUAL(prv_find(contextP, "client1")->altPath, prv_find(contextP, "client2")->altPath);
+    CU_ASSERT_EQUAL(harness_deregister(contextP, &client1), COAP_202_DELETED);
+    CU_ASSERT_EQUAL(harness_deregister(contextP, &client2), COAP_202_DELETED);
+    CU_ASSERT_EQUAL(harness_deregister(contextP, &client3), COAP_202_DELETED);
+    CU_ASSERT_PTR_NULL(contextP->sharedStrings);
+
+    lwm2m_close(contextP);
+}
+
+static void test_registration_observations(void)
+{
+    harness_client_t client;
+    lwm2m_context_t * contextP;
+    lwm2m_client_t * clientP;
+    lwm2m_observation_t * observationP;
+    const char * paths[] = { "/1/0/1", "/3/0/1", "/5", "/6/0" };
+    int status[4];
+    int clientID;
+    int count;
+    int i;
+
+    harness_init();
+    harness_client_init(&client);
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    clientID = harness_register(contextP, &client, "endpoint", "U", "</1/0>,</3/0>,</5>,</6/0>");
+    CU_ASSERT_FATAL(clientID >= 0);
+
+    for (i = 0 ; i < 4 ; i++)
+    {
+        lwm2m_uri_t uri;
+
+        status[i] = -1;
+        lwm2m_stringToUri(paths[i], strlen(paths[i]), &uri);
+        CU_ASSERT_EQUAL(lwm2m_observe(contextP, (uint16_t)clientID, &uri, prv_observeCallback, status + i), COAP_NO_ERROR);
+        harness_notify(contextP, &client, client.requestCount - 1, 1, (uint8_t *)"1", 1);
+        CU_ASSERT_EQUAL(status[i], 1);
+    }
+
+    // the observations of the objects and instances no longer listed are removed
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, "</1/0>,</5>,</6/1>"), COAP_204_CHANGED);
+    CU_ASSERT_EQUAL(status[0], 1);
+    CU_ASSERT_EQUAL(status[1], COAP_202_DELETED);
+    CU_ASSERT_EQUAL(status[2], 1);
+    CU_ASSERT_EQUAL(status[3], COAP_202_DELETED);
+    clientP = prv_find(contextP, "endpoint");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP);
+    count = 0;
+    for (observationP = clientP->observationList ; observationP != NULL ; observationP = observationP->next)
+    {
+        count++;
+    }
+    CU_ASSERT_EQUAL(count, 2);
+
+    lwm2m_close(contextP);
+}
+
+static void test_registration_update(void)
+{
+    static const uint16_t removed[][2] = { { 1, 0 }, { 5, 0 } };
+    static const uint16_t added[][2] = { { 1, 0 }, { 3, 0 }, { 5, 0 } };
+    static const uint16_t grown[][2] = { { 1, 0 }, { 2, 0 }, { 3, 0 }, { 4, 0 }, { 5, 0 }, { 6, 0 } };
+    static const uint16_t unsorted[][2] = { { 1, 0 }, { 3, 0 } };
+    harness_client_t client;
+    lwm2m_context_t * contextP;
+    lwm2m_client_t * clientP;
+    lwm2m_uri_t uri;
+    int status;
+    int clientID;
+    int allocations;
+    int count;
+
+    harness_init();
+    harness_client_init(&client);
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    clientID = harness_register(contextP, &client, "endpoint", "U", "</1/0>,</3/0>,</5/0>,</5/1>");
+    CU_ASSERT_FATAL(clientID >= 0);
+    clientP = prv_find(contextP, "endpoint");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP);
+    status = -1;
+    lwm2m_stringToUri("/5/0", 4, &uri);
+    CU_ASSERT_EQUAL(lwm2m_observe(contextP, (uint16_t)clientID, &uri, prv_observeCallback, &status), COAP_NO_ERROR);
+    harness_notify(contextP, &client, client.requestCount - 1, 1, (uint8_t *)"1", 1);
+    CU_ASSERT_EQUAL(status, 1);
+
+    // the list is updated in place while it fits, the objects still listed keep their observations
+    allocations = harness_allocations();
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, NULL), COAP_204_CHANGED);
+    allocations = harness_allocations() - allocations;
+    count = harness_allocations();
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, "</1/0>,</5/0>"), COAP_204_CHANGED);
+    CU_ASSERT_EQUAL(harness_allocations() - count, allocations);
+    CU_ASSERT(prv_hasObjects(clientP, removed, 2));
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, "</1/0>,</3/0>,</5/0>, </5>"), COAP_204_CHANGED);
+    CU_ASSERT(prv_hasObjects(clientP, added, 3));
+    CU_ASSERT_PTR_EQUAL(clientP->objects, (lwm2m_client_object_t *)(clientP + 1));
+    CU_ASSERT_STRING_EQUAL(clientP->name, "endpoint");
+    CU_ASSERT_EQUAL(status, 1);
+
+    // or moved to a larger record
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, "</1/0>,</2/0>,</3/0>,</4/0>,</5/0>,</6/0>"), COAP_204_CHANGED);
+    CU_ASSERT(prv_hasObjects(clientP, grown, 6));
+    CU_ASSERT_PTR_NOT_EQUAL(clientP->objects, (lwm2m_client_object_t *)(clientP + 1));
+    CU_ASSERT_STRING_EQUAL(clientP->name, "endpoint");
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, "</1/0>,</5/0>"), COAP_204_CHANGED);
+    CU_ASSERT(prv_hasObjects(clientP, removed, 2));
+    CU_ASSERT_STRING_EQUAL(clientP->name, "endpoint");
+
+    // a failed allocation leaves the list unchanged
+    count = 0;
+    do
+    {
+        harness_fail_malloc(count);
+        harness_update(contextP, &client, "</1/0>,</2/0>,</3/0>,</4/0>,</5/0>,</6/0>,</7/0>");
+        harness_fail_malloc(-1);
+        if (client.answer == COAP_500_INTERNAL_SERVER_ERROR)
+        {
+            CU_ASSERT(prv_hasObjects(clientP, removed, 2));
+        }
+        count++;
+    } while (client.answer != COAP_204_CHANGED && count < 100);
+    CU_ASSERT_EQUAL(clientP->objectCount, 7);
+
+    // an unsorted list is decoded as a whole, an invalid one rejected
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, "</3/0>,</1/0>"), COAP_204_CHANGED);
+    CU_ASSERT(prv_hasObjects(clientP, unsorted, 2));
+    CU_ASSERT_EQUAL(status, COAP_202_DELETED);
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, "</1/0>,</3/0>,</5/0>,<garbage"), COAP_400_BAD_REQUEST);
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, "</lwm2m>;rt=\"oma.lwm2m\",</1/0>,</lwm2m>;rt=\"oma.lwm2m\""), COAP_400_BAD_REQUEST);
+    CU_ASSERT(prv_hasObjects(clientP, unsorted, 2));
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, "</lwm2m>;rt=\"oma.lwm2m\",</1/0>"), COAP_204_CHANGED);
+    CU_ASSERT(prv_hasObjects(clientP, unsorted, 1));
+
+    lwm2m_close(contextP);
+}
+
+static void test_registration_failure(void)
+{
+    static const uint16_t expected[][2] = { { 1, 0 }, { 3, 0 } };
+    static const uint16_t replaced[][2] = { { 1, 0 }, { 4, 0 }, { 5, 0 } };
+    lwm2m_client_object_t objects[3];
+    harness_client_t client;
+    lwm2m_context_t * contextP;
+    lwm2m_client_t * clientP;
+    char * altPath;
+    int clientID;
+    int count;
+    int i;
+
+    harness_init();
+    harness_client_init(&client);
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    clientID = harness_register(contextP, &client, "endpoint", "U", "</lwm2m>;rt=\"oma.lwm2m\",</1/0>,</3/0>");
+    CU_ASSERT_FATAL(clientID >= 0);
+    clientP = prv_find(contextP, "endpoint");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP);
+    altPath = clientP->altPath;
+
+    // a failed restore keeps the client as it was
+    for (i = 0 ; i < 3 ; i++)
+    {
+        objects[i].objectId = replaced[i][0];
+        objects[i].instanceId = replaced[i][1];
+    }
+    harness_fail_malloc(0);
+    CU_ASSERT_PTR_NULL(registration_restoreClient(contextP, (uint16_t)clientID, objects, 3, (uint8_t *)"endpoint", 8, NULL, 0, NULL, 0, (uint8_t *)"other", 5));
+    CU_ASSERT_PTR_NULL(registration_restoreClient(contextP, (uint16_t)(clientID + 1), objects, 3, (uint8_t *)"new", 3, NULL, 0, NULL, 0, NULL, 0));
+    harness_fail_malloc(-1);
+    CU_ASSERT_PTR_EQUAL(prv_find(contextP, "endpoint"), clientP);
+    CU_ASSERT_PTR_NULL(prv_find(contextP, "new"));
+    CU_ASSERT(prv_hasObjects(clientP, expected, 2));
+    CU_ASSERT_PTR_EQUAL(clientP->altPath, altPath);
+    CU_ASSERT_STRING_EQUAL(clientP->altPath, "lwm2m");
+
+    // so does a registration failing at any allocation
+    count = 0;
+    do
+    {
+        harness_fail_malloc(count);
+        clientID = harness_register(contextP, &client, "endpoint", "U", "</other>;rt=\"oma.lwm2m\",</1/0>,</4/0>,</5/0>");
+        harness_fail_malloc(-1);
+        CU_ASSERT_PTR_EQUAL_FATAL(prv_find(contextP, "endpoint"), clientP);
+        // without any answer, the registration may have been done and only its answer lost
+        if (client.answer == COAP_500_INTERNAL_SERVER_ERROR)
+        {
+            CU_ASSERT(prv_hasObjects(clientP, expected, 2));
+            CU_ASSERT_STRING_EQUAL(clientP->name, "endpoint");
+            CU_ASSERT_STRING_EQUAL(clientP->altPath, "lwm2m");
+        }
+        count++;
+    } while (clientID < 0 && count < 100);
+    CU_ASSERT(clientID >= 0);
+    CU_ASSERT(prv_hasObjects(clientP, replaced, 3));
+    CU_ASSERT_STRING_EQUAL(clientP->altPath, "other");
+
+    // the restore succeeds once the allocations do
+    CU_ASSERT_PTR_EQUAL(registration_restoreClient(contextP, (uint16_t)clientID, objects, 2, (uint8_t *)"endpoint", 8, NULL, 0, NULL, 0, (uint8_t *)"lwm2m", 5), clientP);
+    CU_ASSERT(prv_hasObjects(clientP, replaced, 2));
+    CU_ASSERT_STRING_EQUAL(clientP->altPath, "lwm2m");
+
+    lwm2m_close(contextP);
+}
+
+static struct TestTable table[] = {
+        { "test of the sorted object list of a client", test_registration_objects },
+        { "test of the strings shared by the clients", test_registration_shared_strings },
+        { "test of the observations removed by an update", test_registration_observations },
+        { "test of the object list merged by an update", test_registration_update },
+        { "test of the registrations failing to allocate", test_registration_failure },
+        { NULL, NULL },
+};
+
+CU_ErrorCode create_registration_suit() {
+    CU_pSuite pSuite = NULL;
+    pSuite = CU_add_suite("Suite_registration", NULL, NULL);
+
+    if (NULL == pSuite) {
+        return CU_get_error();
+    }
+    return add_tests(pSuite, table);
+}
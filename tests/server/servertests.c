@@ -0,0 +1,62 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include <stdio.h>
+
+#include "CUnit/Basic.h"
+
+#include "tests.h"
+
+CU_ErrorCode add_tests(CU_pSuite pSuite, struct TestTable* testTable)
+{
+    int index;
+    for (index = 0; NULL != testTable && NULL != testTable[index].name; ++index) {
+        if (NULL == CU_add_test(pSuite, testTable[index].name, testTable[index].function)) {
+            fprintf(stderr, "Failed to add test %s\n", testTable[index].name);
+            return CU_get_error();
+         }
+    }
+    return CUE_SUCCESS;
+}
+
+int main()
+{
+   if (CUE_SUCCESS != CU_initialize_registry())
+      return CU_get_error();
+
+    if (CUE_SUCCESS != create_queue_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_store_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_clientstore_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_registration_suit()) {
+       goto exit;
+   }
+
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+exit:
+   CU_cleanup_registry();
+   return CU_get_error();
+}
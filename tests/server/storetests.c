@@ -0,0 +1,470 @@
+/*******************************************************************************
+ *
+ * Copyright (c) 2026 Wakaama contributors.
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the Eclipse Public License v1.0
+ * and Eclipse Distribution License v1.0 which accompany this distribution.
+ *
+ * The Eclipse Public License is available at
+ *    http://www.eclipse.org/legal/epl-v10.html
+ * The Eclipse Distribution License is available at
+ *    http://www.eclipse.org/org/documents/edl-v10.php.
+ *
+ * Contributors:
+ *    Wakaama contributors - Please refer to git log
+ *
+ *******************************************************************************/
+
+#include "tests.h"
+#include "CUnit/Basic.h"
+#include "internals.h"
+#include "harness.h"
+
+#define RECORD_HEADER_SIZE      5
+#define RECORD_HASH_SIZE        4
+#define RECORD_CLIENT           1
+#define RECORD_DELETE           2
+
+static lwm2m_client_t * prv_find(lwm2m_context_t * contextP,
+                                 const char * name)
+{
+    return contextP->clientStore->findNameFunc(name, strlen(name), contextP->clientStore);
+}
+
+static int prv_count(lwm2m_context_t * contextP)
+{
+    lwm2m_client_t * clientP;
+    int count;
+
+    count = 0;
+    for (clientP = contextP->clientStore->nextClientFunc(NULL, contextP->clientStore) ; clientP != NULL ; clientP = contextP->clientStore->nextClientFunc(clientP, contextP->clientStore))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+static uint32_t prv_getU32(uint8_t * buffer)
+{
+    return ((uint32_t)buffer[0] << 24) | ((uint32_t)buffer[1] << 16) | ((uint32_t)buffer[2] << 8) | buffer[3];
+}
+
+static size_t prv_recordSize(uint8_t * record)
+{
+    return RECORD_HEADER_SIZE + prv_getU32(record + 1) + RECORD_HASH_SIZE;
+}
+
+static void prv_setHash(uint8_t * record)
+{
+    size_t length;
+    uint32_t hash;
+
+    length = RECORD_HEADER_SIZE + prv_getU32(record + 1);
+    hash = utils_hash(record, length);
+    record[length] = (uint8_t)(hash >> 24);
+    record[length + 1] = (uint8_t)(hash >> 16);
+    record[length + 2] = (uint8_t)(hash >> 8);
+    record[length + 3] = (uint8_t)hash;
+}
+
+// Notifications received by an observer
+typedef struct
+{
+    int     count;
+    int     status;
+    char    value[8];
+} observer_t;
+
+static void prv_observeCallback(uint16_t clientID,
+                                lwm2m_uri_t * uriP,
+                                int status,
+                                lwm2m_media_type_t format,
+                                uint8_t * data,
+                                int dataLength,
+                                void * userData)
+{
+    observer_t * observerP = (observer_t *)userData;
+
+    (void)clientID;
+    (void)uriP;
+    (void)format;
+    observerP->count++;
+    observerP->status = status;
+    observerP->value[0] = 0;
+    if (data != NULL && dataLength < 8)
+    {
+        memcpy(observerP->value, data, dataLength);
+        observerP->value[dataLength] = 0;
+    }
+}
+
+// Observes the path and confirms it as the client, returns the index of the observe request
+static int prv_observe(lwm2m_context_t * contextP,
+                       harness_client_t * clientP,
+                       uint16_t clientID,
+                       const char * path,
+                       observer_t * observerP)
+{
+    lwm2m_uri_t uri;
+    int index;
+
+    lwm2m_stringToUri(path, strlen(path), &uri);
+    if (lwm2m_observe(contextP, clientID, &uri, prv_observeCallback, observerP) != COAP_NO_ERROR) return -1;
+    index = clientP->requestCount - 1;
+    harness_notify(contextP, clientP, index, 1, (uint8_t *)"1", 1);
+
+    return index;
+}
+
+// Replays the store in a new context
+static lwm2m_context_t * prv_restart(lwm2m_context_t * contextP)
+{
+    if (contextP != NULL) lwm2m_close(contextP);
+
+    return lwm2m_init(NULL);
+}
+
+static void test_store_record(void)
+{
+    harness_client_t client;
+    lwm2m_context_t * contextP;
+    harness_store_t * storeP;
+    int id;
+
+    harness_init();
+    harness_client_init(&client);
+    storeP = harness_store();
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    id = harness_register(contextP, &client, "first", "U", "</1/0>,</3/0>,</5>");
+    CU_ASSERT(id >= 0);
+
+    // type, payload length, payload starting with the internal ID, hash
+    CU_ASSERT_EQUAL(storeP->appendCount, 1);
+    CU_ASSERT_FATAL(storeP->length > RECORD_HEADER_SIZE + 2 + RECORD_HASH_SIZE);
+    CU_ASSERT_EQUAL(storeP->data[0], RECORD_CLIENT);
+    CU_ASSERT_EQUAL(prv_recordSize(storeP->data), storeP->length);
+    CU_ASSERT_EQUAL((storeP->data[5] << 8) | storeP->data[6], id);
+    CU_ASSERT_EQUAL(prv_getU32(storeP->data + storeP->length - RECORD_HASH_SIZE), utils_hash(storeP->data, storeP->length - RECORD_HASH_SIZE));
+
+    // a registration update only extending the lifetime is not written
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, NULL), COAP_204_CHANGED);
+    CU_ASSERT_EQUAL(storeP->appendCount, 1);
+
+    CU_ASSERT_EQUAL(harness_deregister(contextP, &client), COAP_202_DELETED);
+    CU_ASSERT_EQUAL(storeP->appendCount, 2);
+    CU_ASSERT_EQUAL(storeP->data[storeP->length - RECORD_HASH_SIZE - 2 - RECORD_HEADER_SIZE], RECORD_DELETE);
+
+    lwm2m_close(contextP);
+}
+
+static void test_store_replay(void)
+{
+    harness_client_t client1;
+    harness_client_t client2;
+    lwm2m_context_t * contextP;
+    lwm2m_client_t * clientP;
+    int id1;
+    int id2;
+
+    harness_init();
+    harness_client_init(&client1);
+    harness_client_init(&client2);
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    id1 = harness_register(contextP, &client1, "first", "U", "</1/0>,</3/0>,</5>");
+    id2 = harness_register(contextP, &client2, "second", "UQ", "</1/0>,</3/0>");
+    CU_ASSERT(id1 >= 0 && id2 >= 0);
+
+    contextP = prv_restart(contextP);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    CU_ASSERT_EQUAL(prv_count(contextP), 2);
+    clientP = prv_find(contextP, "first");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP);
+    CU_ASSERT_EQUAL(clientP->internalID, id1);
+    CU_ASSERT_EQUAL(clientP->binding, BINDING_U);
+    CU_ASSERT_EQUAL(clientP->lifetime, 300);
+    CU_ASSERT_EQUAL(clientP->objectCount, 3);
+    CU_ASSERT_PTR_EQUAL(clientP->sessionH, &client1);
+    clientP = prv_find(contextP, "second");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP);
+    CU_ASSERT_EQUAL(clientP->internalID, id2);
+    CU_ASSERT_EQUAL(clientP->binding, BINDING_UQ);
+
+    // the restored clients are known by the location of their registration
+    CU_ASSERT_EQUAL(harness_update(contextP, &client1, "</1/0>,</3/0>"), COAP_204_CHANGED);
+    CU_ASSERT_EQUAL(harness_deregister(contextP, &client2), COAP_202_DELETED);
+
+    contextP = prv_restart(contextP);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    CU_ASSERT_EQUAL(prv_count(contextP), 1);
+    clientP = prv_find(contextP, "first");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP);
+    CU_ASSERT_EQUAL(clientP->objectCount, 2);
+
+    lwm2m_close(contextP);
+}
+
+static void test_store_invalid_tail(void)
+{
+    harness_client_t client1;
+    harness_client_t client2;
+    lwm2m_context_t * contextP;
+    harness_store_t * storeP;
+    size_t firstSize;
+
+    harness_init();
+    harness_client_init(&client1);
+    harness_client_init(&client2);
+    storeP = harness_store();
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    CU_ASSERT(harness_register(contextP, &client1, "first", "U", "</1/0>,</3/0>") >= 0);
+    firstSize = storeP->length;
+    CU_ASSERT(harness_register(contextP, &client2, "second", "U", "</1/0>,</3/0>") >= 0);
+    lwm2m_close(contextP);
+
+    // record partially written
+    storeP->length -= 3;
+    contextP = prv_restart(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    CU_ASSERT_EQUAL(prv_count(contextP), 1);
+    CU_ASSERT_PTR_NOT_NULL(prv_find(contextP, "first"));
+    CU_ASSERT_EQUAL(storeP->replaceCount, 1);
+    CU_ASSERT_EQUAL(storeP->length, firstSize);
+
+    // corrupted record, and the ones following it
+    CU_ASSERT(harness_register(contextP, &client2, "second", "U", "</1/0>,</3/0>") >= 0);
+    CU_ASSERT_EQUAL(harness_deregister(contextP, &client2), COAP_202_DELETED);
+    lwm2m_close(contextP);
+    storeP->data[firstSize + RECORD_HEADER_SIZE + 1] ^= 0x01;
+    contextP = prv_restart(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    CU_ASSERT_EQUAL(prv_count(contextP), 1);
+    CU_ASSERT_EQUAL(storeP->replaceCount, 2);
+    CU_ASSERT_EQUAL(storeP->length, firstSize);
+
+    lwm2m_close(contextP);
+}
+
+static void test_store_restore_failure(void)
+{
+    harness_client_t client1;
+    harness_client_t client2;
+    harness_client_t client3;
+    lwm2m_context_t * contextP;
+    harness_store_t * storeP;
+    size_t firstSize;
+    size_t length;
+    uint8_t count;
+    int i;
+
+    harness_init();
+    harness_client_init(&client1);
+    harness_client_init(&client2);
+    harness_client_init(&client3);
+    storeP = harness_store();
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    CU_ASSERT(harness_register(contextP, &client1, "first", "U", "</1/0>,</3/0>") >= 0);
+    firstSize = storeP->length;
+    CU_ASSERT(harness_register(contextP, &client2, "second", "U", "</1/0>,</3/0>") >= 0);
+    CU_ASSERT(harness_register(contextP, &client3, "third", "U", "</1/0>,</3/0>") >= 0);
+    lwm2m_close(contextP);
+
+    // a valid record which cannot be restored: its object count is 0
+    count = storeP->data[firstSize + RECORD_HEADER_SIZE + 15];
+    storeP->data[firstSize + RECORD_HEADER_SIZE + 15] = 0;
+    prv_setHash(storeP->data + firstSize);
+    length = storeP->length;
+    contextP = prv_restart(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    CU_ASSERT_EQUAL(prv_count(contextP), 2);
+    CU_ASSERT_PTR_NOT_NULL(prv_find(contextP, "third"));
+    CU_ASSERT_EQUAL(storeP->replaceCount, 0);
+    CU_ASSERT_EQUAL(storeP->length, length);
+
+    // the log is not rewritten, however large it grows
+    for (i = 0 ; i < LWM2M_STORE_COMPACTION_MIN + 8 ; i++)
+    {
+        CU_ASSERT_EQUAL(harness_update(contextP, &client1, (i % 2) ? "</1/0>,</3/0>" : "</1/0>,</3/0>,</5/0>"), COAP_204_CHANGED);
+    }
+    CU_ASSERT_EQUAL(storeP->replaceCount, 0);
+    lwm2m_close(contextP);
+
+    // the record is restored once it can be
+    storeP->data[firstSize + RECORD_HEADER_SIZE + 15] = count;
+    prv_setHash(storeP->data + firstSize);
+    contextP = prv_restart(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    CU_ASSERT_EQUAL(prv_count(contextP), 3);
+    CU_ASSERT_PTR_NOT_NULL(prv_find(contextP, "second"));
+
+    lwm2m_close(contextP);
+}
+
+static void test_store_compaction(void)
+{
+    harness_client_t client1;
+    harness_client_t client2;
+    lwm2m_context_t * contextP;
+    lwm2m_client_t * clientP;
+    harness_store_t * storeP;
+    int i;
+
+    harness_init();
+    harness_client_init(&client1);
+    harness_client_init(&client2);
+    storeP = harness_store();
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    CU_ASSERT(harness_register(contextP, &client1, "first", "U", "</1/0>,</3/0>") >= 0);
+    CU_ASSERT(harness_register(contextP, &client2, "second", "U", "</1/0>,</3/0>") >= 0);
+
+    // the log is rewritten with the current records once it grew enough
+    for (i = 0 ; i < 2 * 2 + LWM2M_STORE_COMPACTION_MIN ; i++)
+    {
+        CU_ASSERT_EQUAL(harness_update(contextP, &client1, (i % 2) ? "</1/0>,</3/0>" : "</1/0>,</3/0>,</5/0>"), COAP_204_CHANGED);
+    }
+    CU_ASSERT_EQUAL(storeP->replaceCount, 1);
+    CU_ASSERT_EQUAL(storeP->data[0], RECORD_CLIENT);
+    CU_ASSERT_EQUAL(storeP->data[prv_recordSize(storeP->data)], RECORD_CLIENT);
+
+    // after a failed write, the log is rewritten by the next one
+    storeP->failWrites = true;
+    CU_ASSERT_EQUAL(harness_deregister(contextP, &client2), COAP_202_DELETED);
+    storeP->failWrites = false;
+    CU_ASSERT_EQUAL(harness_update(contextP, &client1, "</1/0>,</3/0>,</4/0>"), COAP_204_CHANGED);
+    CU_ASSERT_EQUAL(storeP->replaceCount, 3);
+    CU_ASSERT_EQUAL(prv_recordSize(storeP->data), storeP->length);
+
+    contextP = prv_restart(contextP);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    CU_ASSERT_EQUAL(prv_count(contextP), 1);
+    clientP = prv_find(contextP, "first");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP);
+    CU_ASSERT_EQUAL(clientP->objectCount, 3);
+    CU_ASSERT_EQUAL(clientP->objects[2].objectId, 4);
+
+    lwm2m_close(contextP);
+}
+
+static void test_store_observation(void)
+{
+    harness_client_t client;
+    lwm2m_context_t * contextP;
+    lwm2m_client_t * clientP;
+    harness_store_t * storeP;
+    observer_t observer1;
+    observer_t observer2;
+    lwm2m_uri_t uri;
+    uint16_t clientID;
+    int index1;
+    int index2;
+    int id;
+
+    harness_init();
+    harness_client_init(&client);
+    harness_set_observe_callback(prv_observeCallback);
+    storeP = harness_store();
+    memset(&observer1, 0, sizeof(observer1));
+    memset(&observer2, 0, sizeof(observer2));
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    id = harness_register(contextP, &client, "first", "U", "</1/0>,</3/0>,</5/0>");
+    CU_ASSERT_FATAL(id >= 0);
+    clientID = (uint16_t)id;
+
+    // an observation is written once confirmed by the client
+    index1 = prv_observe(contextP, &client, clientID, "/3/0/1", &observer1);
+    CU_ASSERT_FATAL(index1 >= 0);
+    CU_ASSERT_EQUAL(observer1.count, 1);
+    CU_ASSERT_EQUAL(storeP->appendCount, 2);
+    index2 = prv_observe(contextP, &client, clientID, "/5/0", &observer2);
+    CU_ASSERT_FATAL(index2 >= 0);
+    CU_ASSERT_EQUAL(storeP->appendCount, 3);
+
+    // the restored observations get the notifications sent with the tokens of the former server
+    contextP = prv_restart(contextP);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    clientP = prv_find(contextP, "first");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP->observationList);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP->observationList->next);
+    CU_ASSERT_PTR_NULL(clientP->observationList->next->next);
+    harness_notify(contextP, &client, index1, 2, (uint8_t *)"2", 1);
+    CU_ASSERT_EQUAL(observer1.count, 2);
+    CU_ASSERT_EQUAL(observer1.status, 2);
+    CU_ASSERT_STRING_EQUAL(observer1.value, "2");
+    CU_ASSERT_EQUAL(client.resetCount, 0);
+
+    // a canceled observation is removed from the store
+    lwm2m_stringToUri("/3/0/1", 6, &uri);
+    CU_ASSERT_EQUAL(lwm2m_observe_cancel(contextP, clientID, &uri, prv_observeCallback, &observer1), COAP_NO_ERROR);
+    CU_ASSERT_EQUAL(observer1.status, COAP_503_SERVICE_UNAVAILABLE);
+    // an observation of an object no longer listed by the client is removed from the store
+    CU_ASSERT_EQUAL(harness_update(contextP, &client, "</1/0>,</3/0>"), COAP_204_CHANGED);
+    CU_ASSERT_EQUAL(observer2.status, COAP_202_DELETED);
+    CU_ASSERT_PTR_NULL(clientP->observationList);
+
+    contextP = prv_restart(contextP);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    clientP = prv_find(contextP, "first");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP);
+    CU_ASSERT_PTR_NULL(clientP->observationList);
+    harness_notify(contextP, &client, index1, 3, (uint8_t *)"3", 1);
+    CU_ASSERT_EQUAL(client.resetCount, 1);
+    CU_ASSERT_EQUAL(observer1.status, COAP_503_SERVICE_UNAVAILABLE);
+
+    lwm2m_close(contextP);
+}
+
+static void test_store_observation_dropped(void)
+{
+    harness_client_t client;
+    lwm2m_context_t * contextP;
+    lwm2m_client_t * clientP;
+    observer_t observer;
+    int id;
+
+    harness_init();
+    harness_client_init(&client);
+    memset(&observer, 0, sizeof(observer));
+    contextP = lwm2m_init(NULL);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    id = harness_register(contextP, &client, "first", "U", "</1/0>,</3/0>");
+    CU_ASSERT_FATAL(id >= 0);
+    CU_ASSERT(prv_observe(contextP, &client, (uint16_t)id, "/3/0/1", &observer) >= 0);
+
+    // the platform does not restore the observation: it is dropped along with its records
+    contextP = prv_restart(contextP);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(contextP);
+    clientP = prv_find(contextP, "first");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(clientP);
+    CU_ASSERT_PTR_NULL(clientP->observationList);
+    CU_ASSERT_EQUAL(clientP->internalID, id);
+
+    lwm2m_close(contextP);
+}
+
+static struct TestTable table[] = {
+        { "test of the store records", test_store_record },
+        { "test of the store replay", test_store_replay },
+        { "test of an invalid end of store", test_store_invalid_tail },
+        { "test of a store record which cannot be restored", test_store_restore_failure },
+        { "test of the store compaction", test_store_compaction },
+        { "test of the observations in the store", test_store_observation },
+        { "test of an observation not restored", test_store_observation_dropped },
+        { NULL, NULL },
+};
+
+CU_ErrorCode create_store_suit() {
+    CU_pSuite pSuite = NULL;
+    pSuite = CU_add_suite("Suite_store", NULL, NULL);
+
+    if (NULL == pSuite) {
+        return CU_get_error();
+    }
+    return add_tests(pSuite, table);
+}
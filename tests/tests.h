@@ -32,5 +32,13 @@ CU_ErrorCode create_object_read_suit();
 CU_ErrorCode create_convert_numbers_suit();
 CU_ErrorCode create_tlv_json_suit();
 CU_ErrorCode create_block1_suit();
+CU_ErrorCode create_cbor_suit();
+CU_ErrorCode create_list_suit();
+CU_ErrorCode create_attributes_suit();
+CU_ErrorCode create_link_suit();
+CU_ErrorCode create_acl_suit();
+CU_ErrorCode create_journal_suit();
+CU_ErrorCode create_observe_suit();
+CU_ErrorCode create_registration_suit();
 
 #endif /* TESTS_H_ */
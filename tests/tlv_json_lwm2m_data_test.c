@@ -384,6 +384,96 @@ static void test_10(void)
     test_data("/12/0", LWM2M_CONTENT_JSON, data1, 17, "10b");
 }
 
+static void test_11(void)
+{
+    // larger than the 1024 bytes the JSON serializer used to be limited to
+    lwm2m_data_t * data1 = lwm2m_data_new(64);
+    lwm2m_data_t * parsedP;
+    lwm2m_media_type_t format = LWM2M_CONTENT_JSON;
+    lwm2m_uri_t uri;
+    uint8_t * buffer;
+    uint8_t chunk[64];
+    size_t offset;
+    size_t total;
+    int length;
+    int size;
+    int i;
+
+    for (i = 0; i < 64; i++)
+    {
+        data1[i].id = i;
+        lwm2m_data_encode_string("0123456789abcdef0123456789abcdef", data1 + i);
+    }
+    lwm2m_stringToUri("/12/0", 5, &uri);
+
+    length = lwm2m_data_serialize(&uri, 64, data1, &format, &buffer);
+    CU_ASSERT_TRUE_FATAL(length > 1024);
+    CU_ASSERT_EQUAL(format, LWM2M_CONTENT_JSON);
+
+    size = lwm2m_data_parse(&uri, buffer, length, LWM2M_CONTENT_JSON, &parsedP);
+    CU_ASSERT_EQUAL(size, 64);
+    lwm2m_data_free(size, parsedP);
+
+    // the chunks put together give the same document
+    offset = 0;
+    while (offset < (size_t)length)
+    {
+        int res;
+
+        res = lwm2m_data_serialize_block(&uri, 64, data1, &format, offset, chunk, sizeof(chunk), &total);
+        CU_ASSERT_TRUE_FATAL(res > 0);
+        CU_ASSERT_EQUAL(total, (size_t)length);
+        CU_ASSERT(0 == memcmp(chunk, buffer + offset, res));
+        offset += res;
+    }
+
+    lwm2m_free(buffer);
+    lwm2m_data_free(64, data1);
+}
+
+static void test_12(void)
+{
+    // escape sequences, white spaces and the base name after the records
+    const char * buffer = "\r\n{ \"e\" : [ { \"sv\" : \"a \\\"b\\\"\\\\\\/\\n\\u00e9\\ud83d\\ude00\" ,\"n\":\"0\" } ,\t\
+                                       {\"n\":\"1\",\"sv\":\"{[,]}\"} ] ,\
+                           \"bn\":\"/12/0/\" }\r\n";
+    const uint8_t expected[] = "a \"b\"\\/\n\xC3\xA9\xF0\x9F\x98\x80";
+    lwm2m_data_t * parsedP;
+    lwm2m_data_t * reparsedP;
+    lwm2m_media_type_t format = LWM2M_CONTENT_JSON;
+    lwm2m_uri_t uri;
+    uint8_t * output;
+    int length;
+    int size;
+
+    lwm2m_stringToUri("/12/0", 5, &uri);
+    size = lwm2m_data_parse(&uri, (uint8_t *)buffer, strlen(buffer), LWM2M_CONTENT_JSON, &parsedP);
+    CU_ASSERT_EQUAL_FATAL(size, 2);
+    CU_ASSERT_EQUAL(parsedP[0].type, LWM2M_TYPE_STRING);
+    CU_ASSERT_EQUAL(parsedP[0].value.asBuffer.length, sizeof(expected) - 1);
+    CU_ASSERT(0 == memcmp(parsedP[0].value.asBuffer.buffer, expected, sizeof(expected) - 1));
+    CU_ASSERT_EQUAL(parsedP[1].value.asBuffer.length, 5);
+
+    // the serializer escapes the string back
+    length = lwm2m_data_serialize(&uri, size, parsedP, &format, &output);
+    CU_ASSERT_TRUE_FATAL(length > 0);
+    size = lwm2m_data_parse(&uri, output, length, LWM2M_CONTENT_JSON, &reparsedP);
+    CU_ASSERT_EQUAL_FATAL(size, 2);
+    CU_ASSERT_EQUAL(reparsedP[0].value.asBuffer.length, sizeof(expected) - 1);
+    CU_ASSERT(0 == memcmp(reparsedP[0].value.asBuffer.buffer, expected, sizeof(expected) - 1));
+    lwm2m_data_free(size, reparsedP);
+    lwm2m_free(output);
+    lwm2m_data_free(2, parsedP);
+
+    // invalid escape sequence, lone surrogate and duplicated resource
+    buffer = "{\"bn\":\"/12/0/\",\"e\":[{\"n\":\"0\",\"sv\":\"\\x\"}]}";
+    CU_ASSERT_EQUAL(lwm2m_data_parse(&uri, (uint8_t *)buffer, strlen(buffer), LWM2M_CONTENT_JSON, &parsedP), -1);
+    buffer = "{\"bn\":\"/12/0/\",\"e\":[{\"n\":\"0\",\"sv\":\"\\udc00\"}]}";
+    CU_ASSERT_EQUAL(lwm2m_data_parse(&uri, (uint8_t *)buffer, strlen(buffer), LWM2M_CONTENT_JSON, &parsedP), -1);
+    buffer = "{\"bn\":\"/12/0/\",\"e\":[{\"n\":\"0\",\"v\":1},{\"n\":\"0\",\"v\":2}]}";
+    CU_ASSERT_EQUAL(lwm2m_data_parse(&uri, (uint8_t *)buffer, strlen(buffer), LWM2M_CONTENT_JSON, &parsedP), -1);
+}
+
 static struct TestTable table[] = {
         { "test of test_1()", test_1 },
         { "test of test_2()", test_2 },
@@ -395,6 +485,8 @@ static struct TestTable table[] = {
         { "test of test_8()", test_8 },
         { "test of test_9()", test_9 },
         { "test of test_10()", test_10 },
+        { "test of test_11()", test_11 },
+        { "test of test_12()", test_12 },
         { NULL, NULL },
 };
 
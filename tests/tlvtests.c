@@ -156,6 +156,118 @@ static void test_tlv_parse()
     MEMORY_TRACE_AFTER_EQ;
 }
 
+static void test_tlv_parse_borrowed()
+{
+    MEMORY_TRACE_BEFORE;
+    // Instance 0x203 {Resource 55 {1, 2, 3}, Resource 66 {4, 5, 6, 7, 8, 9, 10, 11, 12 } }
+    uint8_t data[] = {0x28, 2, 3, 17, 0xC3, 55, 1, 2, 3, 0xC8, 66, 9, 4, 5, 6, 7, 8, 9, 10, 11, 12, };
+    // Resource 1 {1}, truncated Resource 2
+    uint8_t truncated[] = {0xC1, 1, 1, 0xC3, 2, 1};
+    int result;
+    lwm2m_data_t *dataP;
+    lwm2m_data_t *tlvSubP;
+
+    result = lwm2m_data_parse_borrowed(NULL, data, sizeof(data), LWM2M_CONTENT_TLV, &dataP);
+    CU_ASSERT_EQUAL(result, 1);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dataP);
+    CU_ASSERT_EQUAL(dataP->type, LWM2M_TYPE_OBJECT_INSTANCE);
+    CU_ASSERT_EQUAL(dataP->value.asChildren.count, 2);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dataP->value.asChildren.array);
+    tlvSubP = dataP->value.asChildren.array;
+
+    CU_ASSERT_EQUAL(tlvSubP[0].type, LWM2M_TYPE_OPAQUE);
+    CU_ASSERT_EQUAL(tlvSubP[0].id, 55);
+    CU_ASSERT_EQUAL(tlvSubP[0].flags, LWM2M_DATA_FLAG_BORROWED);
+    CU_ASSERT_EQUAL(tlvSubP[0].value.asBuffer.length, 3);
+    CU_ASSERT_PTR_EQUAL(tlvSubP[0].value.asBuffer.buffer, &data[6]);
+
+    CU_ASSERT_EQUAL(tlvSubP[1].id, 66);
+    CU_ASSERT_EQUAL(tlvSubP[1].value.asBuffer.length, 9);
+    CU_ASSERT_PTR_EQUAL(tlvSubP[1].value.asBuffer.buffer, &data[12]);
+
+    // an encoded value replaces the borrowed one and is owned by the data
+    lwm2m_data_encode_string("owned", tlvSubP + 1);
+    CU_ASSERT_EQUAL(tlvSubP[1].flags & LWM2M_DATA_FLAG_BORROWED, 0);
+    lwm2m_data_free(result, dataP);
+
+    // parsing stops at the first incomplete record
+    result = lwm2m_data_parse_borrowed(NULL, truncated, sizeof(truncated), LWM2M_CONTENT_TLV, &dataP);
+    CU_ASSERT_EQUAL(result, 1);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dataP);
+    CU_ASSERT_EQUAL(dataP->id, 1);
+    lwm2m_data_free(result, dataP);
+
+    MEMORY_TRACE_AFTER_EQ;
+}
+
+static void test_data_inline_and_borrowed()
+{
+    MEMORY_TRACE_BEFORE;
+    const char * longString = "a string longer than the inline storage of a lwm2m_data_t";
+    uint8_t opaque[] = { 0x01, 0x02, 0x03 };
+    uint8_t * buffer;
+    size_t length;
+    lwm2m_data_t copy;
+    lwm2m_data_t * dataP = lwm2m_data_new(4);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dataP);
+
+    // the inline storage does not make the value union larger
+    CU_ASSERT_EQUAL(sizeof(dataP->value), sizeof(dataP->value.asBuffer));
+
+    lwm2m_data_encode_string("short", dataP);
+    CU_ASSERT_EQUAL(dataP[0].type, LWM2M_TYPE_STRING);
+    buffer = lwm2m_data_get_buffer(dataP, &length);
+    CU_ASSERT_EQUAL(length, 5);
+    CU_ASSERT(0 == memcmp(buffer, "short", 5));
+#ifndef LWM2M_DATA_NO_INLINE
+    CU_ASSERT_EQUAL(dataP[0].flags, LWM2M_DATA_FLAG_INLINE);
+    CU_ASSERT_PTR_EQUAL(buffer, dataP[0].value.asInline.buffer);
+#endif
+
+    lwm2m_data_encode_string(longString, dataP + 1);
+    CU_ASSERT_EQUAL(dataP[1].type, LWM2M_TYPE_STRING);
+    CU_ASSERT_EQUAL(dataP[1].flags, 0);
+    buffer = lwm2m_data_get_buffer(dataP + 1, &length);
+    CU_ASSERT_EQUAL(length, strlen(longString));
+    CU_ASSERT_PTR_EQUAL(buffer, dataP[1].value.asBuffer.buffer);
+    CU_ASSERT(0 == memcmp(buffer, longString, strlen(longString)));
+
+    lwm2m_data_encode_string_borrowed(longString, dataP + 2);
+    CU_ASSERT_EQUAL(dataP[2].type, LWM2M_TYPE_STRING);
+    CU_ASSERT_EQUAL(dataP[2].flags, LWM2M_DATA_FLAG_BORROWED);
+    CU_ASSERT_EQUAL(dataP[2].value.asBuffer.length, strlen(longString));
+    CU_ASSERT_PTR_EQUAL(dataP[2].value.asBuffer.buffer, longString);
+
+    lwm2m_data_encode_opaque_borrowed(opaque, sizeof(opaque), dataP + 3);
+    CU_ASSERT_EQUAL(dataP[3].type, LWM2M_TYPE_OPAQUE);
+    CU_ASSERT_EQUAL(dataP[3].flags, LWM2M_DATA_FLAG_BORROWED);
+    buffer = lwm2m_data_get_buffer(dataP + 3, &length);
+    CU_ASSERT_EQUAL(length, sizeof(opaque));
+    CU_ASSERT_PTR_EQUAL(buffer, opaque);
+
+    // an inline value stays valid when the lwm2m_data_t is copied
+    copy = dataP[0];
+    memcpy(dataP + 3, dataP, sizeof(lwm2m_data_t));
+    memset(dataP, 0, sizeof(lwm2m_data_t));
+    buffer = lwm2m_data_get_buffer(&copy, &length);
+    CU_ASSERT_EQUAL(length, 5);
+    CU_ASSERT(0 == memcmp(buffer, "short", 5));
+    CU_ASSERT_EQUAL(dataP[3].type, LWM2M_TYPE_STRING);
+    buffer = lwm2m_data_get_buffer(dataP + 3, &length);
+    CU_ASSERT_EQUAL(length, 5);
+    CU_ASSERT(0 == memcmp(buffer, "short", 5));
+
+    // a value re-encoded in a longer one is moved out of the inline storage
+    lwm2m_data_encode_string(longString, dataP + 3);
+    CU_ASSERT_EQUAL(dataP[3].flags, 0);
+    buffer = lwm2m_data_get_buffer(dataP + 3, &length);
+    CU_ASSERT_EQUAL(length, strlen(longString));
+    CU_ASSERT(0 == memcmp(buffer, longString, strlen(longString)));
+
+    lwm2m_data_free(4, dataP);
+    MEMORY_TRACE_AFTER_EQ;
+}
+
 static void test_tlv_serialize()
 {
     MEMORY_TRACE_BEFORE;
@@ -167,6 +279,8 @@ static void test_tlv_serialize()
     uint8_t data1[] = {1, 2, 3, 4};
     uint8_t data2[170] = {5, 6, 7, 8};
     uint8_t* buffer;
+    uint8_t * valueP;
+    size_t valueLength;
 
 
 
@@ -176,8 +290,9 @@ static void test_tlv_serialize()
     tlvSubP[0].id = 66;
     lwm2m_data_encode_opaque(data1, sizeof(data1), tlvSubP);
     CU_ASSERT_EQUAL(tlvSubP[0].type, LWM2M_TYPE_OPAQUE);
-    CU_ASSERT_EQUAL(tlvSubP[0].value.asBuffer.length, sizeof(data1));
-    CU_ASSERT_PTR_NOT_NULL_FATAL(tlvSubP[0].value.asBuffer.buffer);
+    valueP = lwm2m_data_get_buffer(tlvSubP, &valueLength);
+    CU_ASSERT_EQUAL(valueLength, sizeof(data1));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(valueP);
 
     tlvSubP[1].type = LWM2M_TYPE_MULTIPLE_RESOURCE;
     tlvSubP[1].id = 77;
@@ -189,8 +304,9 @@ static void test_tlv_serialize()
     tlvRscInstP[0].id = 0;
     lwm2m_data_encode_opaque(data2, sizeof(data2), tlvRscInstP);
     CU_ASSERT_EQUAL(tlvRscInstP[0].type, LWM2M_TYPE_OPAQUE);
-    CU_ASSERT_EQUAL(tlvRscInstP[0].value.asBuffer.length, sizeof(data2));
-    CU_ASSERT_PTR_NOT_NULL_FATAL(tlvRscInstP[0].value.asBuffer.buffer);
+    valueP = lwm2m_data_get_buffer(tlvRscInstP, &valueLength);
+    CU_ASSERT_EQUAL(valueLength, sizeof(data2));
+    CU_ASSERT_PTR_NOT_NULL_FATAL(valueP);
 
     dataP = lwm2m_data_new(1);
     CU_ASSERT_PTR_NOT_NULL_FATAL(dataP);
@@ -232,6 +348,8 @@ static void test_tlv_int(void)
    MEMORY_TRACE_BEFORE;
    int64_t value;
    int result;
+   uint8_t * valueP;
+   size_t valueLength;
    lwm2m_data_t *dataP =  lwm2m_data_new(1);
    CU_ASSERT_PTR_NOT_NULL(dataP);
 
@@ -247,16 +365,18 @@ static void test_tlv_int(void)
 
    lwm2m_data_encode_string("18", dataP);
    CU_ASSERT_EQUAL(dataP->type, LWM2M_TYPE_STRING);
-   CU_ASSERT_EQUAL(dataP->value.asBuffer.length, 2);
-   CU_ASSERT(0 == memcmp(dataP->value.asBuffer.buffer, "18", 2));
+   valueP = lwm2m_data_get_buffer(dataP, &valueLength);
+   CU_ASSERT_EQUAL(valueLength, 2);
+   CU_ASSERT(0 == memcmp(valueP, "18", 2));
    result = lwm2m_data_decode_int(dataP, &value);
    CU_ASSERT_EQUAL(result, 1);
    CU_ASSERT_EQUAL(value, 18);
 
    lwm2m_data_encode_string("-14678", dataP);
    CU_ASSERT_EQUAL(dataP->type, LWM2M_TYPE_STRING);
-   CU_ASSERT_EQUAL(dataP->value.asBuffer.length, 6);
-   CU_ASSERT(0 == memcmp(dataP->value.asBuffer.buffer, "-14678", 6));
+   valueP = lwm2m_data_get_buffer(dataP, &valueLength);
+   CU_ASSERT_EQUAL(valueLength, 6);
+   CU_ASSERT(0 == memcmp(valueP, "-14678", 6));
    result = lwm2m_data_decode_int(dataP, &value);
    CU_ASSERT_EQUAL(result, 1);
    CU_ASSERT_EQUAL(value, -14678);
@@ -264,20 +384,21 @@ static void test_tlv_int(void)
    uint8_t data1[] = { 0xed, 0xcc };
    lwm2m_data_encode_opaque(data1, sizeof(data1), dataP);
    CU_ASSERT_EQUAL(dataP->type, LWM2M_TYPE_OPAQUE);
-   CU_ASSERT_EQUAL(dataP->value.asBuffer.length, sizeof(data1));
-   CU_ASSERT_PTR_NOT_NULL_FATAL(dataP->value.asBuffer.buffer);
-   CU_ASSERT(0 == memcmp(dataP->value.asBuffer.buffer, data1, sizeof(data1)));
+   valueP = lwm2m_data_get_buffer(dataP, &valueLength);
+   CU_ASSERT_EQUAL(valueLength, sizeof(data1));
+   CU_ASSERT_PTR_NOT_NULL_FATAL(valueP);
+   CU_ASSERT(0 == memcmp(valueP, data1, sizeof(data1)));
    result = lwm2m_data_decode_int(dataP, &value);
    CU_ASSERT_EQUAL(result, 1);
    CU_ASSERT_EQUAL(value, -0x1234);
-   lwm2m_free(dataP->value.asBuffer.buffer);
 
    uint8_t data2[] = { 0x7f, 0x34, 0x56, 0x78, 0x91, 0x22, 0x33, 0x44 };
    lwm2m_data_encode_opaque(data2, sizeof(data2), dataP);
    CU_ASSERT_EQUAL(dataP->type, LWM2M_TYPE_OPAQUE);
-   CU_ASSERT_EQUAL(dataP->value.asBuffer.length, sizeof(data2));
-   CU_ASSERT_PTR_NOT_NULL_FATAL(dataP->value.asBuffer.buffer);
-   CU_ASSERT(0 == memcmp(dataP->value.asBuffer.buffer, data2, sizeof(data2)));
+   valueP = lwm2m_data_get_buffer(dataP, &valueLength);
+   CU_ASSERT_EQUAL(valueLength, sizeof(data2));
+   CU_ASSERT_PTR_NOT_NULL_FATAL(valueP);
+   CU_ASSERT(0 == memcmp(valueP, data2, sizeof(data2)));
    result = lwm2m_data_decode_int(dataP, &value);
    CU_ASSERT_EQUAL(result, 1);
    CU_ASSERT_EQUAL(value, 0x7f34567891223344);
@@ -291,6 +412,8 @@ static void test_tlv_bool(void)
    MEMORY_TRACE_BEFORE;
    bool value;
    int result;
+   uint8_t * valueP;
+   size_t valueLength;
    lwm2m_data_t *dataP =  lwm2m_data_new(1);
    CU_ASSERT_PTR_NOT_NULL(dataP);
 
@@ -313,16 +436,18 @@ static void test_tlv_bool(void)
 
    lwm2m_data_encode_string("1", dataP);
    CU_ASSERT_EQUAL(dataP->type, LWM2M_TYPE_STRING);
-   CU_ASSERT_EQUAL(dataP->value.asBuffer.length, 1);
-   CU_ASSERT(0 == memcmp(dataP->value.asBuffer.buffer, "1", 1));
+   valueP = lwm2m_data_get_buffer(dataP, &valueLength);
+   CU_ASSERT_EQUAL(valueLength, 1);
+   CU_ASSERT(0 == memcmp(valueP, "1", 1));
    result = lwm2m_data_decode_bool(dataP, &value);
    CU_ASSERT_EQUAL(result, 1);
    CU_ASSERT_EQUAL(value, true);
 
    lwm2m_data_encode_string("0", dataP);
    CU_ASSERT_EQUAL(dataP->type, LWM2M_TYPE_STRING);
-   CU_ASSERT_EQUAL(dataP->value.asBuffer.length, 1);
-   CU_ASSERT(0 == memcmp(dataP->value.asBuffer.buffer, "0", 1));
+   valueP = lwm2m_data_get_buffer(dataP, &valueLength);
+   CU_ASSERT_EQUAL(valueLength, 1);
+   CU_ASSERT(0 == memcmp(valueP, "0", 1));
    result = lwm2m_data_decode_bool(dataP, &value);
    CU_ASSERT_EQUAL(result, 1);
    CU_ASSERT_EQUAL(value, false);
@@ -330,20 +455,21 @@ static void test_tlv_bool(void)
    uint8_t data1[] = { 0x00 };
    lwm2m_data_encode_opaque(data1, sizeof(data1), dataP);
    CU_ASSERT_EQUAL(dataP->type, LWM2M_TYPE_OPAQUE);
-   CU_ASSERT_EQUAL(dataP->value.asBuffer.length, sizeof(data1));
-   CU_ASSERT_PTR_NOT_NULL_FATAL(dataP->value.asBuffer.buffer);
-   CU_ASSERT(0 == memcmp(dataP->value.asBuffer.buffer, data1, sizeof(data1)));
+   valueP = lwm2m_data_get_buffer(dataP, &valueLength);
+   CU_ASSERT_EQUAL(valueLength, sizeof(data1));
+   CU_ASSERT_PTR_NOT_NULL_FATAL(valueP);
+   CU_ASSERT(0 == memcmp(valueP, data1, sizeof(data1)));
    result = lwm2m_data_decode_bool(dataP, &value);
    CU_ASSERT_EQUAL(result, 1);
    CU_ASSERT_EQUAL(value, false);
-   lwm2m_free(dataP->value.asBuffer.buffer);
 
    uint8_t data2[] = { 0x01 };
    lwm2m_data_encode_opaque(data2, sizeof(data2), dataP);
    CU_ASSERT_EQUAL(dataP->type, LWM2M_TYPE_OPAQUE);
-   CU_ASSERT_EQUAL(dataP->value.asBuffer.length, sizeof(data2));
-   CU_ASSERT_PTR_NOT_NULL_FATAL(dataP->value.asBuffer.buffer);
-   CU_ASSERT(0 == memcmp(dataP->value.asBuffer.buffer, data2, sizeof(data2)));
+   valueP = lwm2m_data_get_buffer(dataP, &valueLength);
+   CU_ASSERT_EQUAL(valueLength, sizeof(data2));
+   CU_ASSERT_PTR_NOT_NULL_FATAL(valueP);
+   CU_ASSERT(0 == memcmp(valueP, data2, sizeof(data2)));
    result = lwm2m_data_decode_bool(dataP, &value);
    CU_ASSERT_EQUAL(result, 1);
    CU_ASSERT_EQUAL(value, true);
@@ -357,6 +483,8 @@ static void test_tlv_float(void)
     MEMORY_TRACE_BEFORE;
     double value;
     int result;
+    uint8_t * valueP;
+    size_t valueLength;
     lwm2m_data_t *dataP = lwm2m_data_new(1);
     CU_ASSERT_PTR_NOT_NULL(dataP);
 
@@ -372,16 +500,18 @@ static void test_tlv_float(void)
 
     lwm2m_data_encode_string("1234.56", dataP);
     CU_ASSERT_EQUAL(dataP->type, LWM2M_TYPE_STRING);
-    CU_ASSERT_EQUAL(dataP->value.asBuffer.length, 7);
-    CU_ASSERT(0 == memcmp(dataP->value.asBuffer.buffer, "1234.56", 7));
+    valueP = lwm2m_data_get_buffer(dataP, &valueLength);
+    CU_ASSERT_EQUAL(valueLength, 7);
+    CU_ASSERT(0 == memcmp(valueP, "1234.56", 7));
     result = lwm2m_data_decode_float(dataP, &value);
     CU_ASSERT_EQUAL(result, 1);
     CU_ASSERT_EQUAL(value, 1234.56);
 
     lwm2m_data_encode_string("-123456789.987", dataP);
     CU_ASSERT_EQUAL(dataP->type, LWM2M_TYPE_STRING);
-    CU_ASSERT_EQUAL(dataP->value.asBuffer.length, 14);
-    CU_ASSERT(0 == memcmp(dataP->value.asBuffer.buffer, "-123456789.987", 14));
+    valueP = lwm2m_data_get_buffer(dataP, &valueLength);
+    CU_ASSERT_EQUAL(valueLength, 14);
+    CU_ASSERT(0 == memcmp(valueP, "-123456789.987", 14));
     result = lwm2m_data_decode_float(dataP, &value);
     CU_ASSERT_EQUAL(result, 1);
     CU_ASSERT_EQUAL(value, -123456789.987);
@@ -395,6 +525,8 @@ static struct TestTable table[] = {
         { "test of lwm2m_data_free()", test_tlv_free },
         { "test of lwm2m_decodeTLV()", test_decodeTLV },
         { "test of lwm2m_data_parse()", test_tlv_parse },
+        { "test of lwm2m_data_parse_borrowed()", test_tlv_parse_borrowed },
+        { "test of inline and borrowed values", test_data_inline_and_borrowed },
         { "test of lwm2m_data_serialize()", test_tlv_serialize },
         { "test of lwm2m_data_encode_int() and lwm2m_data_decode_int()", test_tlv_int },
         { "test of lwm2m_data_encode_bool()and lwm2m_data_decode_bool()", test_tlv_bool },
@@ -54,10 +54,58 @@ int main()
    if (CUE_SUCCESS != CU_initialize_registry())
       return CU_get_error();
 
+    if (CUE_SUCCESS != create_uri_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_tlv_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_convert_numbers_suit()) {
+       goto exit;
+   }
+
     if (CUE_SUCCESS != create_tlv_json_suit()) {
        goto exit;
    }
 
+    if (CUE_SUCCESS != create_block1_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_cbor_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_list_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_attributes_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_link_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_acl_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_journal_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_observe_suit()) {
+       goto exit;
+   }
+
+    if (CUE_SUCCESS != create_registration_suit()) {
+       goto exit;
+   }
+
    CU_basic_set_mode(CU_BRM_VERBOSE);
    CU_basic_run_tests();
 exit:
@@ -32,6 +32,7 @@ static void test_uri_decode(void)
     multi_option_t locationDecimal = { .next = NULL, .is_static = 1, .len = 4, .data = (uint8_t *) "5312" };
     multi_option_t reg = { .next = NULL, .is_static = 1, .len = 2, .data = (uint8_t *) "rd" };
     multi_option_t boot = { .next = NULL, .is_static = 1, .len = 2, .data = (uint8_t *) "bs" };
+    multi_option_t send = { .next = NULL, .is_static = 1, .len = 2, .data = (uint8_t *) "dp" };
 
     MEMORY_TRACE_BEFORE;
 
@@ -68,6 +69,18 @@ static void test_uri_decode(void)
     CU_ASSERT_PTR_NULL(uri);
     lwm2m_free(uri);
 
+    /* "/dp" */
+    uri = uri_decode(NULL, &send);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(uri);
+    CU_ASSERT_EQUAL(uri->flag, LWM2M_URI_FLAG_SEND);
+    lwm2m_free(uri);
+
+    /* "/dp/5a3f" */
+    send.next = &location;
+    uri = uri_decode(NULL, &send);
+    CU_ASSERT_PTR_NULL(uri);
+    lwm2m_free(uri);
+
     /* "/9050/11/0" */
     uri = uri_decode(NULL, &oID);
     CU_ASSERT_PTR_NOT_NULL_FATAL(uri);